@@ -0,0 +1,86 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file baseline_tracker.c
+ * @brief The baseline_tracker.c file implements the fixed-point baseline tracker.
+ */
+
+#include <stddef.h>
+#include "baseline_tracker.h"
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+void Baseline_Init(baselinetracker_t *pTracker, uint8_t shift, uint8_t gate)
+{
+    pTracker->mean = 0;
+    pTracker->variance = 0U;
+    pTracker->shift = shift;
+    pTracker->gate = gate;
+    pTracker->seeded = false;
+}
+
+void Baseline_Seed(baselinetracker_t *pTracker, int32_t value)
+{
+    pTracker->mean = value * (int32_t)(1 << BASELINE_FRAC_BITS);
+    pTracker->variance = 0U;
+    pTracker->seeded = true;
+}
+
+void Baseline_Update(baselinetracker_t *pTracker, int32_t sample)
+{
+    int32_t delta;
+    int64_t square;
+    int64_t variance;
+
+    if (!pTracker->seeded)
+    {
+        Baseline_Seed(pTracker, sample);
+        return;
+    }
+
+    /*! mean += (sample - mean) / 2^shift, the fractional bits carry the remainder. */
+    delta = sample * (int32_t)(1 << BASELINE_FRAC_BITS) - pTracker->mean;
+    pTracker->mean += delta >> pTracker->shift;
+
+    /*! variance += (delta^2 - variance) / 2^shift, delta^2 brought back to BASELINE_FRAC_BITS. */
+    square = ((int64_t)delta * delta) >> BASELINE_FRAC_BITS;
+    variance = (int64_t)pTracker->variance;
+    variance += (square - variance) >> pTracker->shift;
+    pTracker->variance = (variance > (int64_t)UINT32_MAX) ? UINT32_MAX : (uint32_t)variance;
+}
+
+int32_t Baseline_Mean(const baselinetracker_t *pTracker)
+{
+    return (pTracker->mean + (int32_t)(1 << (BASELINE_FRAC_BITS - 1U))) >> BASELINE_FRAC_BITS;
+}
+
+bool Baseline_IsEvent(const baselinetracker_t *pTracker, int32_t sample, uint32_t threshold)
+{
+    int64_t delta;
+    uint64_t square;
+
+    if (!pTracker->seeded)
+    {
+        return false;
+    }
+
+    delta = (int64_t)sample * (1 << BASELINE_FRAC_BITS) - pTracker->mean;
+    if (delta < 0)
+    {
+        delta = -delta;
+    }
+    if ((uint64_t)delta <= ((uint64_t)threshold << BASELINE_FRAC_BITS))
+    {
+        return false;
+    }
+
+    /*! |delta| > gate * sigma  <=>  delta^2 > gate^2 * variance */
+    square = ((uint64_t)delta * (uint64_t)delta) >> BASELINE_FRAC_BITS;
+
+    return square > (uint64_t)pTracker->gate * pTracker->gate * pTracker->variance;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file baseline_tracker.h
+ * @brief The baseline_tracker.h file declares a fixed-point baseline tracker which follows slow sensor drift
+ *        with an exponential moving average and a running variance, one constant-cost update per sample.
+ */
+
+#ifndef BASELINE_TRACKER_H_
+#define BASELINE_TRACKER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/*! @brief Fractional bits of the tracked mean and variance. */
+#define BASELINE_FRAC_BITS (8U)
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief This structure holds the state of one baseline tracker. */
+typedef struct
+{
+    int32_t mean;      /*!< Moving average of the samples, BASELINE_FRAC_BITS fractional bits. */
+    uint32_t variance; /*!< Moving average of the squared deviation, BASELINE_FRAC_BITS fractional bits. */
+    uint8_t shift;     /*!< Smoothing factor, each sample weighs 2^-shift. */
+    uint8_t gate;      /*!< Deviations beyond gate standard deviations are events. */
+    bool seeded;       /*!< A first value has been loaded. */
+} baselinetracker_t;
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+/*! @brief       Initializes a baseline tracker.
+ *  @details     The tracker stays empty until the first sample or Baseline_Seed().
+ *  @param[in]   pTracker  tracker to initialize.
+ *  @param[in]   shift     smoothing factor, the time constant is 2^shift samples.
+ *  @param[in]   gate      event gate in standard deviations, 0 only applies the fixed threshold.
+ */
+void Baseline_Init(baselinetracker_t *pTracker, uint8_t shift, uint8_t gate);
+
+/*! @brief       Loads a known baseline, e.g. an average taken at start up, and clears the variance.
+ *  @param[in]   pTracker  tracker to seed.
+ *  @param[in]   value     baseline in sample units.
+ */
+void Baseline_Seed(baselinetracker_t *pTracker, int32_t value);
+
+/*! @brief       Folds one sample into the mean and variance.
+ *  @details     Constant time, no loops. The first sample of an empty tracker seeds it.
+ *               Samples reported as events should not be fed, so a lasting disturbance is not learnt.
+ *  @param[in]   pTracker  tracker to update.
+ *  @param[in]   sample    new sample in sample units.
+ */
+void Baseline_Update(baselinetracker_t *pTracker, int32_t sample);
+
+/*! @brief       Returns the tracked baseline rounded to sample units.
+ *  @param[in]   pTracker  tracker to query.
+ *  @return      the baseline, 0 for an empty tracker.
+ */
+int32_t Baseline_Mean(const baselinetracker_t *pTracker);
+
+/*! @brief       Tests a sample against the baseline.
+ *  @details     The sample is an event when it is more than threshold away from the baseline and, with a non zero
+ *               gate, also more than gate standard deviations away. The comparison is done on squares, no root.
+ *  @param[in]   pTracker   tracker to test against.
+ *  @param[in]   sample     sample in sample units.
+ *  @param[in]   threshold  smallest deviation which can be an event, in sample units.
+ *  @return      true if the sample is an event, false otherwise or for an empty tracker.
+ */
+bool Baseline_IsEvent(const baselinetracker_t *pTracker, int32_t sample, uint32_t threshold);
+
+#endif /* BASELINE_TRACKER_H_ */
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file capture_ring.c
+ * @brief The capture_ring.c file implements the single producer, single consumer capture ring.
+ */
+
+#include <stddef.h>
+#include "fsl_device_registers.h"
+#include "capture_ring.h"
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+bool CaptureRing_Init(capturering_t *pRing, capturesample_t *pStorage, uint32_t capacity)
+{
+    if ((pStorage == NULL) || (capacity == 0U) || ((capacity & (capacity - 1U)) != 0U))
+    {
+        return false;
+    }
+
+    pRing->pStorage = pStorage;
+    pRing->capacity = capacity;
+    pRing->head = 0U;
+    pRing->start = 0U;
+    pRing->end = 0U;
+    pRing->pre = 0U;
+    pRing->post = 0U;
+    pRing->request = 0U;
+    pRing->armed = 0U;
+    pRing->triggered = false;
+    pRing->dropped = 0U;
+
+    return true;
+}
+
+bool CaptureRing_Push(capturering_t *pRing, const capturesample_t *pSample)
+{
+    uint32_t head = pRing->head;
+    uint32_t request;
+    uint32_t pre;
+
+    if (pRing->triggered)
+    {
+        CAPTURE_RING_BARRIER();
+        request = pRing->request;
+        /*! Freeze the window here, the only place head cannot move under it. */
+        if (request != pRing->armed)
+        {
+            pre = (pRing->pre > head) ? head : pRing->pre;
+            pRing->start = head - pre;
+            pRing->end = head + pRing->post;
+            CAPTURE_RING_BARRIER();
+            pRing->armed = request;
+        }
+
+        /*! The snapshot is complete, keep it until the consumer is done with it. */
+        if ((int32_t)(head - pRing->end) >= 0)
+        {
+            pRing->dropped++;
+            return false;
+        }
+    }
+
+    pRing->pStorage[head & (pRing->capacity - 1U)] = *pSample;
+    CAPTURE_RING_BARRIER();
+    pRing->head = head + 1U;
+
+    return true;
+}
+
+bool CaptureRing_Trigger(capturering_t *pRing, uint32_t pre, uint32_t post)
+{
+    if (pRing->triggered || (post > pRing->capacity) || (pre > (pRing->capacity - post)))
+    {
+        return false;
+    }
+
+    pRing->pre = pre;
+    pRing->post = post;
+    pRing->request++;
+    CAPTURE_RING_BARRIER();
+    pRing->triggered = true;
+
+    return true;
+}
+
+uint32_t CaptureRing_Read(capturering_t *pRing, capturesample_t *pSamples, uint32_t maxSamples)
+{
+    uint32_t head;
+    uint32_t start;
+    uint32_t limit;
+    uint32_t count;
+    uint32_t i;
+
+    if (!pRing->triggered || (pRing->armed != pRing->request))
+    {
+        return 0U;
+    }
+
+    /*! The producer writes at head and stops at end, it never touches [start, head) of a frozen window. */
+    CAPTURE_RING_BARRIER();
+    head = pRing->head;
+    CAPTURE_RING_BARRIER();
+
+    limit = ((int32_t)(head - pRing->end) < 0) ? head : pRing->end;
+    start = pRing->start;
+    if ((int32_t)(limit - start) <= 0)
+    {
+        return 0U;
+    }
+
+    count = limit - start;
+    if (count > maxSamples)
+    {
+        count = maxSamples;
+    }
+    for (i = 0U; i < count; i++)
+    {
+        pSamples[i] = pRing->pStorage[(start + i) & (pRing->capacity - 1U)];
+    }
+    pRing->start = start + count;
+
+    return count;
+}
+
+bool CaptureRing_IsDone(const capturering_t *pRing)
+{
+    return pRing->triggered && (pRing->armed == pRing->request) && ((int32_t)(pRing->start - pRing->end) >= 0);
+}
+
+void CaptureRing_Release(capturering_t *pRing)
+{
+    CAPTURE_RING_BARRIER();
+    pRing->triggered = false;
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file capture_ring.h
+ * @brief The capture_ring.h file declares a single producer, single consumer ring of time stamped sensor samples.
+ *        The producer records continuously, a trigger freezes a pre and post trigger window which the consumer
+ *        reads out at its own pace. No locks, the producer never waits.
+ */
+
+#ifndef CAPTURE_RING_H_
+#define CAPTURE_RING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/*! @brief Values of a sample: accel X/Y/Z, or pressure and temperature, or the magnetic field. */
+#define CAPTURE_RING_CHANNELS (3U)
+
+/*! @brief Memory budget of a ring of n samples, in bytes. */
+#define CAPTURE_RING_BUDGET(n) ((uint32_t)(n) * (uint32_t)sizeof(capturesample_t))
+
+/*! @brief Orders the index update after the sample copy, and the index read before the sample copy. */
+#ifndef CAPTURE_RING_BARRIER
+#define CAPTURE_RING_BARRIER() __DMB()
+#endif
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief One time stamped sample, 16 bytes. */
+typedef struct
+{
+    uint32_t timestamp;                      /*!< Time the sample was taken, us. */
+    int32_t value[CAPTURE_RING_CHANNELS];    /*!< Sensor values, unused channels 0. */
+} capturesample_t;
+
+/*! @brief This structure holds the state of one capture ring.
+ *         The consumer requests a snapshot, the producer freezes its window on the next sample and acknowledges:
+ *         head, armed and the window bounds as frozen are only written by the producer, pre, post, request and
+ *         triggered only by the consumer, which then owns start until the release. */
+typedef struct
+{
+    capturesample_t *pStorage; /*!< Sample storage, capacity entries. */
+    uint32_t capacity;         /*!< Number of samples, a power of two. */
+    volatile uint32_t head;    /*!< Samples written so far, the next one goes to head % capacity. */
+    volatile uint32_t start;   /*!< Next snapshot sample to read. */
+    volatile uint32_t end;     /*!< One past the last snapshot sample. */
+    uint32_t pre;              /*!< Requested samples before the trigger. */
+    uint32_t post;             /*!< Requested samples after the trigger. */
+    volatile uint32_t request; /*!< Snapshots requested so far. */
+    volatile uint32_t armed;   /*!< Last request whose window the producer froze. */
+    volatile bool triggered;   /*!< A snapshot is being taken or read. */
+    volatile uint32_t dropped; /*!< Samples dropped while a full snapshot waited to be read. */
+} capturering_t;
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+/*! @brief       Initializes a capture ring on caller provided storage.
+ *  @param[in]   pRing     ring to initialize.
+ *  @param[in]   pStorage  storage of CAPTURE_RING_BUDGET(capacity) bytes, kept for the life of the ring.
+ *  @param[in]   capacity  number of samples, a power of two.
+ *  @return      true on success, false if the storage is missing or the capacity is not a power of two.
+ */
+bool CaptureRing_Init(capturering_t *pRing, capturesample_t *pStorage, uint32_t capacity);
+
+/*! @brief       Records one sample, producer side.
+ *  @details     Constant time, never waits. While a snapshot holds its last post trigger sample and has not been
+ *               released, new samples are dropped instead of overwriting it.
+ *  @param[in]   pRing    ring to write.
+ *  @param[in]   pSample  sample to record.
+ *  @return      true if recorded, false if dropped.
+ */
+bool CaptureRing_Push(capturering_t *pRing, const capturesample_t *pSample);
+
+/*! @brief       Requests a snapshot around the newest sample, consumer side.
+ *  @details     The next CaptureRing_Push freezes the window: up to pre samples already recorded and post samples
+ *               from that one on. pre + post must fit the capacity, pre is cut to what has been recorded so far.
+ *               Until then CaptureRing_Read returns nothing.
+ *  @param[in]   pRing  ring to trigger.
+ *  @param[in]   pre    samples before the trigger.
+ *  @param[in]   post   samples after the trigger.
+ *  @return      true if triggered, false while a previous snapshot is not released or if the window does not fit.
+ */
+bool CaptureRing_Trigger(capturering_t *pRing, uint32_t pre, uint32_t post);
+
+/*! @brief       Reads the snapshot samples available so far, consumer side.
+ *  @param[in]   pRing        triggered ring.
+ *  @param[out]  pSamples     destination of the samples, oldest first.
+ *  @param[in]   maxSamples   size of pSamples.
+ *  @return      number of samples copied, 0 when none is available yet.
+ */
+uint32_t CaptureRing_Read(capturering_t *pRing, capturesample_t *pSamples, uint32_t maxSamples);
+
+/*! @brief       Tells whether the whole snapshot has been recorded and read.
+ *  @param[in]   pRing  ring to query.
+ *  @return      true once the snapshot is complete and read, false otherwise or without a trigger.
+ */
+bool CaptureRing_IsDone(const capturering_t *pRing);
+
+/*! @brief       Drops the snapshot and lets the producer overwrite it again, consumer side.
+ *  @param[in]   pRing  ring to release.
+ */
+void CaptureRing_Release(capturering_t *pRing);
+
+#endif /* CAPTURE_RING_H_ */
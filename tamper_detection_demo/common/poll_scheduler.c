@@ -0,0 +1,64 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file poll_scheduler.c
+ * @brief The poll_scheduler.c file implements the activity-adaptive poll interval.
+ */
+
+#include <stddef.h>
+#include "poll_scheduler.h"
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+void PollSched_Init(pollsched_t *pSched, const pollschedconfig_t *pConfig)
+{
+    pSched->pConfig = pConfig;
+    pSched->intervalMs = pConfig->minIntervalMs;
+    pSched->quietCount = 0U;
+}
+
+uint32_t PollSched_Update(pollsched_t *pSched, bool active)
+{
+    const pollschedconfig_t *pConfig = pSched->pConfig;
+    uint32_t step;
+
+    if (active)
+    {
+        pSched->intervalMs = pConfig->minIntervalMs;
+        pSched->quietCount = 0U;
+        return pSched->intervalMs;
+    }
+
+    if (pSched->quietCount < pConfig->quietPolls)
+    {
+        pSched->quietCount++;
+        return pSched->intervalMs;
+    }
+
+    /*! Grow by at least 1ms so a short interval with a large shift still backs off. */
+    step = pSched->intervalMs >> pConfig->growShift;
+    if (step == 0U)
+    {
+        step = 1U;
+    }
+    if (pSched->intervalMs >= pConfig->maxIntervalMs - step)
+    {
+        pSched->intervalMs = pConfig->maxIntervalMs;
+    }
+    else
+    {
+        pSched->intervalMs += step;
+    }
+
+    return pSched->intervalMs;
+}
+
+uint32_t PollSched_Interval(const pollsched_t *pSched)
+{
+    return pSched->intervalMs;
+}
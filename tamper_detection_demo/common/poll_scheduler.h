@@ -0,0 +1,63 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file poll_scheduler.h
+ * @brief The poll_scheduler.h file declares an activity-adaptive poll interval, stretched geometrically while
+ *        the readings stay quiet and snapped back to the fastest rate on any activity.
+ */
+
+#ifndef POLL_SCHEDULER_H_
+#define POLL_SCHEDULER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief This structure holds the back-off policy of one sensor. */
+typedef struct
+{
+    uint32_t minIntervalMs; /*!< Interval while active, also the starting interval. */
+    uint32_t maxIntervalMs; /*!< Longest interval reached while quiet. */
+    uint8_t growShift;      /*!< Each stretch adds interval/2^growShift, 0 doubles the interval. */
+    uint8_t quietPolls;     /*!< Quiet polls at the fast rate before the interval starts to stretch. */
+} pollschedconfig_t;
+
+/*! @brief This structure holds the state of one poll scheduler. */
+typedef struct
+{
+    const pollschedconfig_t *pConfig; /*!< Back-off policy. */
+    uint32_t intervalMs;              /*!< Interval to arm the next poll with. */
+    uint8_t quietCount;               /*!< Quiet polls seen at the fast rate. */
+} pollsched_t;
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+/*! @brief       Initializes a poll scheduler at the fast rate.
+ *  @param[in]   pSched   scheduler to initialize.
+ *  @param[in]   pConfig  back-off policy, must stay valid while the scheduler is used.
+ */
+void PollSched_Init(pollsched_t *pSched, const pollschedconfig_t *pConfig);
+
+/*! @brief       Accounts for the outcome of one poll.
+ *  @details     Activity restores the fast rate at once. Once quietPolls quiet polls have been seen, each quiet
+ *               poll stretches the interval by 1/2^growShift, up to maxIntervalMs.
+ *  @param[in]   pSched   scheduler to update.
+ *  @param[in]   active   true on a threshold crossing, a wake event or any reading worth a closer look.
+ *  @return      the interval to arm the next poll with, in ms.
+ */
+uint32_t PollSched_Update(pollsched_t *pSched, bool active);
+
+/*! @brief       Returns the interval to arm the next poll with.
+ *  @param[in]   pSched   scheduler to query.
+ *  @return      the interval in ms.
+ */
+uint32_t PollSched_Interval(const pollsched_t *pSched);
+
+#endif /* POLL_SCHEDULER_H_ */
@@ -0,0 +1,187 @@
+/*
+ * Copyright 2025 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file sensor_engine.c
+ * @brief The sensor_engine.c file implements the probing and the batched polling of the sensors
+ *  sharing one I2C bus.
+ */
+
+#include "issdk_hal.h"
+#include "sensor_drv.h"
+#include "sensor_engine.h"
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/*! Accounts for one finished poll and reports the end of the round. */
+static void SensorEngine_PollComplete(sensorengine_t *pEngine)
+{
+    uint32_t primask;
+    uint8_t pending;
+
+    primask = DisableGlobalIRQ();
+    pending = --pEngine->pollsPending;
+    EnableGlobalIRQ(primask);
+
+    if ((pending == 0) && (pEngine->pollDone != NULL))
+    {
+        pEngine->pollDone(pEngine->pollDoneParam);
+    }
+}
+
+/*! Completion of one poll transfer, runs in the I2C interrupt. */
+static void SensorEngine_PollEvent(int32_t status, void *userParam)
+{
+    sensorengineslot_t *pSlot = (sensorengineslot_t *)userParam;
+
+    pSlot->status = status;
+    SensorEngine_PollComplete(pSlot->pEngine);
+}
+
+void SensorEngine_Init(
+    sensorengine_t *pEngine, ARM_DRIVER_I2C *pBus, uint8_t index, sensorengineslot_t *pSlots, uint8_t numSlots)
+{
+    uint8_t i;
+
+    pEngine->pBus = pBus;
+    pEngine->deviceInstance = index;
+    pEngine->pSlots = pSlots;
+    pEngine->numSlots = numSlots;
+    pEngine->pollsPending = 0;
+    pEngine->pollDone = NULL;
+    pEngine->pollDoneParam = NULL;
+
+    for (i = 0; i < numSlots; i++)
+    {
+        pSlots[i].pEngine = pEngine;
+        pSlots[i].pDevInfo = NULL;
+        pSlots[i].status = SENSOR_ENGINE_NOT_PRESENT;
+        pSlots[i].whoAmI = 0;
+        pSlots[i].present = false;
+    }
+}
+
+uint8_t SensorEngine_Probe(sensorengine_t *pEngine)
+{
+    int32_t status;
+    uint8_t found = 0;
+    uint8_t i, n;
+    registerDeviceInfo_t probeInfo;
+    sensorengineslot_t *pSlot;
+    const sensorengineops_t *pOps;
+
+    /*! A bare device info, the driver handles are only set up for the sensors which answer. */
+    probeInfo.idleFunction = NULL;
+    probeInfo.functionParam = NULL;
+    probeInfo.deviceInstance = pEngine->deviceInstance;
+    probeInfo.pCache = NULL;
+
+    for (i = 0; i < pEngine->numSlots; i++)
+    {
+        pSlot = &pEngine->pSlots[i];
+        pOps = pSlot->pOps;
+        pSlot->present = false;
+        pSlot->status = SENSOR_ENGINE_NOT_PRESENT;
+
+        /*! An absent address is NAKed, the read then fails and the candidate is skipped. */
+        status = Register_I2C_Read(pEngine->pBus, &probeInfo, pOps->slaveAddress, pOps->whoAmIReg, 1, &pSlot->whoAmI);
+        if (ARM_DRIVER_OK != status)
+        {
+            continue;
+        }
+        for (n = 0; n < pOps->numWhoAmIValues; n++)
+        {
+            if (pOps->pWhoAmIValues[n] == pSlot->whoAmI)
+            {
+                break;
+            }
+        }
+        if (n == pOps->numWhoAmIValues)
+        {
+            continue;
+        }
+
+        pSlot->status = pOps->init(pSlot);
+        if ((SENSOR_ERROR_NONE == pSlot->status) && (pOps->configure != NULL))
+        {
+            pSlot->status = pOps->configure(pSlot);
+        }
+        if (SENSOR_ERROR_NONE == pSlot->status)
+        {
+            pSlot->present = true;
+            found++;
+        }
+    }
+
+    return found;
+}
+
+int32_t SensorEngine_Poll(sensorengine_t *pEngine, sensorenginedone_t done, void *userParam)
+{
+    int32_t status;
+    uint8_t i, count = 0;
+    sensorengineslot_t *pSlot;
+
+    if (pEngine->pollsPending != 0)
+    {
+        return ARM_DRIVER_ERROR_BUSY;
+    }
+
+    for (i = 0; i < pEngine->numSlots; i++)
+    {
+        pSlot = &pEngine->pSlots[i];
+        if (pSlot->present && (pSlot->pOps->pPollList != NULL))
+        {
+            count++;
+        }
+    }
+    if (count == 0)
+    {
+        return ARM_DRIVER_OK;
+    }
+
+    /*! Account for the whole round first, the first reads may complete while the others are queued. */
+    pEngine->pollDone = done;
+    pEngine->pollDoneParam = userParam;
+    pEngine->pollsPending = count;
+
+    for (i = 0; i < pEngine->numSlots; i++)
+    {
+        pSlot = &pEngine->pSlots[i];
+        if (!pSlot->present || (pSlot->pOps->pPollList == NULL))
+        {
+            continue;
+        }
+
+        pSlot->status = ARM_DRIVER_ERROR_BUSY;
+        status = Register_I2C_ReadAsync(pEngine->pBus, pSlot->pDevInfo, pSlot->pOps->slaveAddress, &pSlot->xfer,
+                                        pSlot->pOps->pPollList, pSlot->pollData, SensorEngine_PollEvent, pSlot);
+        if (ARM_DRIVER_OK != status)
+        {
+            pSlot->status = status;
+            SensorEngine_PollComplete(pEngine);
+        }
+    }
+
+    return ARM_DRIVER_OK;
+}
+
+void SensorEngine_Decode(sensorengine_t *pEngine)
+{
+    uint8_t i;
+    sensorengineslot_t *pSlot;
+
+    for (i = 0; i < pEngine->numSlots; i++)
+    {
+        pSlot = &pEngine->pSlots[i];
+        if (pSlot->present && (pSlot->pOps->pPollList != NULL) && (pSlot->pOps->decode != NULL))
+        {
+            pSlot->pOps->decode(pSlot);
+        }
+    }
+}
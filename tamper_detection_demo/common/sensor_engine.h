@@ -0,0 +1,130 @@
+/*
+ * Copyright 2025 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file sensor_engine.h
+ * @brief The sensor_engine.h file declares the sensor driver interface and the engine which probes the
+ *  sensors present on one I2C bus and services them together.
+ */
+
+#ifndef __SENSOR_ENGINE_H__
+#define __SENSOR_ENGINE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "Driver_I2C.h"
+#include "register_io_i2c.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief The largest block of registers a sensor can read on every poll. */
+#define SENSOR_ENGINE_MAX_POLL_SIZE 8
+
+/*! @brief The status of a sensor which has not answered the WHO_AM_I probe. */
+#define SENSOR_ENGINE_NOT_PRESENT (ARM_DRIVER_ERROR_SPECIFIC - 1)
+
+typedef struct _sensor_engine sensorengine_t;
+typedef struct _sensor_engine_slot sensorengineslot_t;
+
+/*!
+ * @brief This is the poll completion callback type.
+ *        It is called from the I2C interrupt once every poll of a round has completed.
+ */
+typedef void (*sensorenginedone_t)(void *userParam);
+
+/*!
+ * @brief This structure defines the sensor driver interface serviced by the engine.
+ *        One constant instance exists per sensor type.
+ */
+typedef struct
+{
+    uint16_t slaveAddress;        /* I2C slave address probed at boot. */
+    uint8_t whoAmIReg;            /* Offset of the WHO_AM_I register. */
+    const uint8_t *pWhoAmIValues; /* WHO_AM_I values accepted for this driver. */
+    uint8_t numWhoAmIValues;      /* Number of entries in pWhoAmIValues. */
+    int32_t (*init)(sensorengineslot_t *pSlot);      /* Initializes the driver handle of a detected sensor. */
+    int32_t (*configure)(sensorengineslot_t *pSlot); /* Applies the detection configuration, may be NULL. */
+    const registerreadlist_t *pPollList;             /* Registers read on every poll, NULL if interrupt driven. */
+    void (*decode)(sensorengineslot_t *pSlot);       /* Consumes pollData, run by SensorEngine_Decode(). */
+} sensorengineops_t;
+
+/*!
+ * @brief This structure holds the engine state of one sensor.
+ */
+struct _sensor_engine_slot
+{
+    const sensorengineops_t *pOps;   /* The driver interface of the sensor. */
+    sensorengine_t *pEngine;         /* The engine owning the slot. */
+    void *pHandle;                   /* The driver handle, e.g. a fxls8974_i2c_sensorhandle_t. */
+    registerDeviceInfo_t *pDevInfo;  /* The device info inside pHandle, valid once init has run. */
+    registerasyncxfer_t xfer;        /* Engine private: poll transfer. */
+    int32_t status;                  /* Outcome of the probe, then of the last poll. */
+    uint8_t whoAmI;                  /* WHO_AM_I value read by the probe. */
+    bool present;                    /* The sensor answered the probe and was initialized. */
+    uint8_t pollData[SENSOR_ENGINE_MAX_POLL_SIZE]; /* Registers read by the last poll. */
+};
+
+/*!
+ * @brief This structure defines the sensor engine of one I2C bus.
+ */
+struct _sensor_engine
+{
+    ARM_DRIVER_I2C *pBus;            /* The I2C driver shared by the sensors. */
+    uint8_t deviceInstance;          /* The I2C device number. */
+    sensorengineslot_t *pSlots;      /* The candidate sensors. */
+    uint8_t numSlots;                /* Number of entries in pSlots. */
+    volatile uint8_t pollsPending;   /* Engine private: polls of the current round still on the bus. */
+    sensorenginedone_t pollDone;     /* Engine private: completion callback of the current round. */
+    void *pollDoneParam;             /* Engine private: parameter of pollDone. */
+};
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+/*! @brief       Initialize a sensor engine
+
+ *  @param[in]   pEngine       the engine to initialize
+ *  @param[in]   pBus          pointer to the I2C ARM driver shared by the sensors
+ *  @param[in]   index         the I2C device number
+ *  @param[in]   pSlots        the candidate sensors, pOps and pHandle set by the caller
+ *  @param[in]   numSlots      number of entries in pSlots
+ */
+void SensorEngine_Init(
+    sensorengine_t *pEngine, ARM_DRIVER_I2C *pBus, uint8_t index, sensorengineslot_t *pSlots, uint8_t numSlots);
+
+/*! @brief       Probe, initialize and configure the sensors present on the bus
+
+ *  Reads the WHO_AM_I register at the address of every candidate. Sensors answering with an accepted value
+ *  are initialized and configured through their driver interface, the others are skipped.
+ *
+ *  @param[in]   pEngine       the engine to probe
+ *
+ *  @return      returns the number of sensors found and ready
+ */
+uint8_t SensorEngine_Probe(sensorengine_t *pEngine);
+
+/*! @brief       Poll every present sensor in one burst on the bus
+
+ *  The reads of all polled sensors are queued back to back, so the bus wakes up once per round.
+ *  The data is handed to the drivers by SensorEngine_Decode() once done has been called.
+ *
+ *  @param[in]   pEngine       the engine to poll
+ *  @param[in]   done          called from the I2C interrupt when the round has completed, may be NULL
+ *  @param[in]   userParam     parameter passed to done
+ *
+ *  @return      ARM_DRIVER_OK if queued, ARM_DRIVER_ERROR_BUSY while the previous round is on the bus
+ */
+int32_t SensorEngine_Poll(sensorengine_t *pEngine, sensorenginedone_t done, void *userParam);
+
+/*! @brief       Run the decode function of every sensor polled in the last round
+
+ *  @param[in]   pEngine       the engine which completed a round
+ */
+void SensorEngine_Decode(sensorengine_t *pEngine);
+
+#endif /* __SENSOR_ENGINE_H__ */
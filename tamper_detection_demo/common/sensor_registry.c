@@ -0,0 +1,51 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file sensor_registry.c
+ * @brief The sensor_registry.c file implements the lookup of the sensor variants and their device descriptor.
+ */
+
+#include <stddef.h>
+#include "sensor_registry.h"
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+const sensorvariant_t *SensorRegistry_Find(const sensorvariant_t *pTable, uint32_t count, uint8_t whoAmI)
+{
+    uint32_t i;
+    uint8_t j;
+
+    for (i = 0U; i < count; i++)
+    {
+        for (j = 0U; j < pTable[i].numWhoAmIValues; j++)
+        {
+            if (pTable[i].pWhoAmIValues[j] == whoAmI)
+            {
+                return &pTable[i];
+            }
+        }
+    }
+
+    return NULL;
+}
+
+uint32_t SensorRegistry_Describe(const sensorvariant_t *pVariant, uint8_t whoAmI, uint8_t *pBuffer)
+{
+    pBuffer[0] = SENSOR_DESCRIPTOR_TAG;
+    pBuffer[1] = whoAmI;
+    pBuffer[2] = pVariant->family;
+    pBuffer[3] = (uint8_t)pVariant->partNumber;
+    pBuffer[4] = (uint8_t)(pVariant->partNumber >> 8);
+    pBuffer[5] = pVariant->caps;
+    pBuffer[6] = pVariant->bufDepth;
+    pBuffer[7] = pVariant->ranges;
+    pBuffer[8] = (uint8_t)pVariant->maxOdr;
+    pBuffer[9] = (uint8_t)(pVariant->maxOdr >> 8);
+
+    return SENSOR_DESCRIPTOR_SIZE;
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file sensor_registry.h
+ * @brief The sensor_registry.h file declares a const registry of the sensor variants served by one driver, keyed by
+ *        WHO_AM_I. An entry holds the part name, its capabilities and the register settings for the part, a family
+ *        of parts that only differ by WHO_AM_I shares one entry. The init does one lookup and reports the part to the
+ *        peers as a compact binary descriptor.
+ */
+
+#ifndef SENSOR_REGISTRY_H_
+#define SENSOR_REGISTRY_H_
+
+#include <stdint.h>
+#include "sensor_drv.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/*! @brief Sensor families. */
+#define SENSOR_FAMILY_ACCEL     (1U) /*!< 3-axis accelerometer. */
+#define SENSOR_FAMILY_PRESSURE  (2U) /*!< Pressure and altitude sensor. */
+#define SENSOR_FAMILY_MAG       (3U) /*!< Magnetic switch. */
+
+/*! @brief Capabilities of a variant. */
+#define SENSOR_CAP_BUFFER       (0x01U) /*!< On-chip sample buffer, bufDepth samples. */
+#define SENSOR_CAP_SDCD         (0x02U) /*!< Sensor data change detection. */
+#define SENSOR_CAP_ORIENT       (0x04U) /*!< Orientation detection. */
+#define SENSOR_CAP_TEMP         (0x08U) /*!< Temperature output. */
+#define SENSOR_CAP_ALTIMETER    (0x10U) /*!< Altitude output. */
+#define SENSOR_CAP_WINDOW       (0x20U) /*!< Threshold window comparator. */
+
+/*! @brief Full scale ranges of an accelerometer, bit mask. */
+#define SENSOR_RANGE_2G         (0x01U)
+#define SENSOR_RANGE_4G         (0x02U)
+#define SENSOR_RANGE_8G         (0x04U)
+#define SENSOR_RANGE_16G        (0x08U)
+
+/*! @brief First byte of a device descriptor, tells it from the text messages on the same stream. */
+#define SENSOR_DESCRIPTOR_TAG   (0xD5U)
+
+/*! @brief Size of a device descriptor, in bytes. */
+#define SENSOR_DESCRIPTOR_SIZE  (10U)
+
+/*! @brief Number of entries of a registry table. */
+#define SENSOR_REGISTRY_COUNT(table) ((uint32_t)(sizeof(table) / sizeof((table)[0])))
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief This structure describes one sensor variant. */
+typedef struct
+{
+    const uint8_t *pWhoAmIValues;        /*!< WHO_AM_I values of the parts served by the entry, the registry keys. */
+    uint8_t numWhoAmIValues;             /*!< Entries of pWhoAmIValues. */
+    uint8_t family;                      /*!< SENSOR_FAMILY_xxx. */
+    uint16_t partNumber;                 /*!< Part number, 8974 for the FXLS8974CF and the family it stands for. */
+    uint8_t caps;                        /*!< SENSOR_CAP_xxx mask. */
+    uint8_t bufDepth;                    /*!< Samples of the on-chip buffer, 0 without one. */
+    uint8_t ranges;                      /*!< SENSOR_RANGE_xxx mask, 0 for a fixed range. */
+    uint16_t maxOdr;                     /*!< Highest output data rate, Hz, 0 when not set in Hz. */
+    const char *pName;                   /*!< Part name. */
+    const registerwritelist_t *pConfig;  /*!< Register settings for the variant. */
+} sensorvariant_t;
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+/*! @brief       Finds the entry serving a WHO_AM_I value.
+ *  @param[in]   pTable   registry table.
+ *  @param[in]   count    entries of pTable.
+ *  @param[in]   whoAmI   WHO_AM_I value read from the part.
+ *  @return      the variant, NULL for an unknown part.
+ */
+const sensorvariant_t *SensorRegistry_Find(const sensorvariant_t *pTable, uint32_t count, uint8_t whoAmI);
+
+/*! @brief       Builds the binary device descriptor of a variant.
+ *  @details     Tag, WHO_AM_I, family, part number (LE16), capabilities, buffer depth, ranges and the highest output
+ *               data rate (LE16).
+ *  @param[in]   pVariant  variant to describe.
+ *  @param[in]   whoAmI    WHO_AM_I value read from the part, tells the parts of a family entry apart.
+ *  @param[out]  pBuffer   destination, SENSOR_DESCRIPTOR_SIZE bytes.
+ *  @return      size of the descriptor.
+ */
+uint32_t SensorRegistry_Describe(const sensorvariant_t *pVariant, uint8_t whoAmI, uint8_t *pBuffer);
+
+#endif /* SENSOR_REGISTRY_H_ */
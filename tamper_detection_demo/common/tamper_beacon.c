@@ -0,0 +1,93 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file tamper_beacon.c
+ * @brief The tamper_beacon.c file implements the encoder and the decoder of the tamper beacon.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "tamper_beacon.h"
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+uint32_t TamperBeacon_Encode(uint8_t *pBuffer, uint32_t counter, const uint8_t *pRecord, uint32_t recordLength)
+{
+    if (NULL == pRecord)
+    {
+        recordLength = 0U;
+    }
+    else if (recordLength > TAMPER_EVENT_MAX_SIZE)
+    {
+        return 0U;
+    }
+    else
+    {
+        ; /* The record fits */
+    }
+
+    pBuffer[0] = (uint8_t)TAMPER_BEACON_COMPANY_ID;
+    pBuffer[1] = (uint8_t)(TAMPER_BEACON_COMPANY_ID >> 8);
+    pBuffer[2] = (uint8_t)(TAMPER_BEACON_MAGIC | TAMPER_BEACON_VERSION);
+    pBuffer[3] = (uint8_t)counter;
+    pBuffer[4] = (uint8_t)(counter >> 8);
+    pBuffer[5] = (uint8_t)(counter >> 16);
+    pBuffer[6] = (uint8_t)(counter >> 24);
+    if (0U != recordLength)
+    {
+        memcpy(&pBuffer[TAMPER_BEACON_HEADER_SIZE], pRecord, recordLength);
+    }
+
+    return TAMPER_BEACON_HEADER_SIZE + recordLength;
+}
+
+uint32_t TamperBeacon_Seal(uint8_t *pBuffer, uint32_t length, const uint8_t *pMac)
+{
+    memcpy(&pBuffer[length], pMac, TAMPER_BEACON_MIC_SIZE);
+
+    return length + TAMPER_BEACON_MIC_SIZE;
+}
+
+uint32_t TamperBeacon_Decode(const uint8_t *pBuffer, uint32_t length, uint32_t *pCounter, tamperevent_t *pEvent,
+                             bool *pHasEvent)
+{
+    uint32_t recordLength;
+
+    if ((length < (TAMPER_BEACON_HEADER_SIZE + TAMPER_BEACON_MIC_SIZE)) ||
+        (pBuffer[0] != (uint8_t)TAMPER_BEACON_COMPANY_ID) || (pBuffer[1] != (uint8_t)(TAMPER_BEACON_COMPANY_ID >> 8)) ||
+        ((pBuffer[2] & 0xF0U) != TAMPER_BEACON_MAGIC) || ((pBuffer[2] & 0x0FU) == 0U))
+    {
+        return 0U;
+    }
+    /*! A record, if any, must fill the beacon up to the MIC. */
+    recordLength = length - TAMPER_BEACON_HEADER_SIZE - TAMPER_BEACON_MIC_SIZE;
+    *pHasEvent = (0U != recordLength);
+    if (*pHasEvent &&
+        (TamperEvent_Decode(&pBuffer[TAMPER_BEACON_HEADER_SIZE], recordLength, pEvent) != recordLength))
+    {
+        return 0U;
+    }
+
+    *pCounter = (uint32_t)pBuffer[3] | ((uint32_t)pBuffer[4] << 8) | ((uint32_t)pBuffer[5] << 16) |
+                ((uint32_t)pBuffer[6] << 24);
+
+    return TAMPER_BEACON_HEADER_SIZE + recordLength;
+}
+
+bool TamperBeacon_Verify(const uint8_t *pMic, const uint8_t *pMac)
+{
+    uint8_t diff = 0U;
+    uint8_t i;
+
+    for (i = 0U; i < TAMPER_BEACON_MIC_SIZE; i++)
+    {
+        diff |= (uint8_t)(pMic[i] ^ pMac[i]);
+    }
+
+    return (0U == diff);
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file tamper_beacon.h
+ * @brief The tamper_beacon.h file declares the tamper beacon, the latest tamper event record sent as the
+ *        manufacturer specific data of a non-connectable advertising set. A gateway scanning many nodes gets the
+ *        alerts without connecting. The beacon carries a rolling counter and a MIC, the caller computes the MIC,
+ *        AES-CMAC with a key shared with the gateways, truncated to TAMPER_BEACON_MIC_SIZE bytes. The encoder and
+ *        the decoder only use the C library, the same files build on the gateway.
+ *
+ *        Manufacturer specific data, little endian:
+ *        | 0..1       | 2          | 3..6    | 7..          | last 4 |
+ *        | company ID | 0xB0 | ver | counter | event record | MIC    |
+ *
+ *        The MIC covers all the bytes before it. The record is a tamper_event.h record, it may be missing, the
+ *        beacon then only tells the node is alive. The counter goes up with every new content and never repeats,
+ *        the node reserves windows of it in NVM and starts past the last window after a reset. A gateway keeps the
+ *        last counter of each node and only takes a beacon which raises it.
+ */
+
+#ifndef TAMPER_BEACON_H_
+#define TAMPER_BEACON_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tamper_event.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/*! @brief Version of the beacon format. */
+#define TAMPER_BEACON_VERSION       (1U)
+
+/*! @brief Upper nibble of the format byte, tells a tamper beacon from other data of the same company. */
+#define TAMPER_BEACON_MAGIC         (0xB0U)
+
+/*! @brief Bluetooth SIG company identifier of NXP. */
+#define TAMPER_BEACON_COMPANY_ID    (0x0025U)
+
+/*! @brief Size of the beacon without record and MIC, in bytes. */
+#define TAMPER_BEACON_HEADER_SIZE   (7U)
+
+/*! @brief Size of the MIC, in bytes. */
+#define TAMPER_BEACON_MIC_SIZE      (4U)
+
+/*! @brief Largest beacon, in bytes. */
+#define TAMPER_BEACON_MAX_SIZE      (TAMPER_BEACON_HEADER_SIZE + TAMPER_EVENT_MAX_SIZE + TAMPER_BEACON_MIC_SIZE)
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+/*! @brief       Encodes the part of a beacon covered by the MIC.
+ *  @param[out]  pBuffer       destination, TAMPER_BEACON_MAX_SIZE bytes.
+ *  @param[in]   counter       rolling counter of the beacon content.
+ *  @param[in]   pRecord       encoded event record, NULL for none.
+ *  @param[in]   recordLength  size of the record.
+ *  @return      size of the part covered by the MIC, 0 if the record is too large.
+ */
+uint32_t TamperBeacon_Encode(uint8_t *pBuffer, uint32_t counter, const uint8_t *pRecord, uint32_t recordLength);
+
+/*! @brief       Appends the MIC to an encoded beacon.
+ *  @param[in]   pBuffer  beacon to update.
+ *  @param[in]   length   size of the part covered by the MIC.
+ *  @param[in]   pMac     MAC of that part, its first TAMPER_BEACON_MIC_SIZE bytes are used.
+ *  @return      size of the beacon.
+ */
+uint32_t TamperBeacon_Seal(uint8_t *pBuffer, uint32_t length, const uint8_t *pMac);
+
+/*! @brief       Decodes a beacon, the MIC is not checked.
+ *  @param[in]   pBuffer        received manufacturer specific data.
+ *  @param[in]   length         number of received bytes.
+ *  @param[out]  pCounter       rolling counter.
+ *  @param[out]  pEvent         decoded event, its type is left alone without a record.
+ *  @param[out]  pHasEvent      true if the beacon holds a record.
+ *  @return      size of the part covered by the MIC, the MIC follows it, 0 if pBuffer is not a valid beacon.
+ */
+uint32_t TamperBeacon_Decode(const uint8_t *pBuffer, uint32_t length, uint32_t *pCounter, tamperevent_t *pEvent,
+                             bool *pHasEvent);
+
+/*! @brief       Compares a received MIC with the MAC computed over the beacon, in constant time.
+ *  @param[in]   pMic   received MIC.
+ *  @param[in]   pMac   computed MAC, its first TAMPER_BEACON_MIC_SIZE bytes are used.
+ *  @return      true if they match.
+ */
+bool TamperBeacon_Verify(const uint8_t *pMic, const uint8_t *pMac);
+
+#endif /* TAMPER_BEACON_H_ */
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file tamper_event.c
+ * @brief The tamper_event.c file implements the encoder and the decoder of the binary tamper event record.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "tamper_event.h"
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+void TamperEvent_Init(tamperevent_t *pEvent, uint8_t type, uint8_t severity, uint8_t sensorId, uint8_t sequence,
+                      uint32_t timestamp)
+{
+    pEvent->version = TAMPER_EVENT_VERSION;
+    pEvent->type = type;
+    pEvent->severity = severity;
+    pEvent->sensorId = sensorId;
+    pEvent->sequence = sequence;
+    pEvent->timestamp = timestamp;
+    pEvent->payloadLength = 0U;
+}
+
+bool TamperEvent_AddItem(tamperevent_t *pEvent, uint8_t tag, const uint8_t *pData)
+{
+    uint8_t length = TAMPER_ITEM_LENGTH(tag);
+
+    if ((1U + length) > (TAMPER_EVENT_MAX_PAYLOAD - pEvent->payloadLength))
+    {
+        return false;
+    }
+
+    pEvent->payload[pEvent->payloadLength] = tag;
+    memcpy(&pEvent->payload[pEvent->payloadLength + 1U], pData, length);
+    pEvent->payloadLength += 1U + length;
+
+    return true;
+}
+
+uint32_t TamperEvent_Encode(const tamperevent_t *pEvent, uint8_t *pBuffer, uint32_t size)
+{
+    uint32_t length = TAMPER_EVENT_HEADER_SIZE + pEvent->payloadLength;
+
+    if ((pEvent->payloadLength > TAMPER_EVENT_MAX_PAYLOAD) || (length > size))
+    {
+        return 0U;
+    }
+
+    pBuffer[0] = (uint8_t)(TAMPER_EVENT_MAGIC | TAMPER_EVENT_VERSION);
+    pBuffer[1] = (uint8_t)((pEvent->severity << 5) | (pEvent->type & 0x1FU));
+    pBuffer[2] = pEvent->sensorId;
+    pBuffer[3] = pEvent->sequence;
+    pBuffer[4] = (uint8_t)pEvent->timestamp;
+    pBuffer[5] = (uint8_t)(pEvent->timestamp >> 8);
+    pBuffer[6] = (uint8_t)(pEvent->timestamp >> 16);
+    pBuffer[7] = (uint8_t)(pEvent->timestamp >> 24);
+    pBuffer[8] = pEvent->payloadLength;
+    memcpy(&pBuffer[TAMPER_EVENT_HEADER_SIZE], pEvent->payload, pEvent->payloadLength);
+
+    return length;
+}
+
+uint32_t TamperEvent_Decode(const uint8_t *pBuffer, uint32_t length, tamperevent_t *pEvent)
+{
+    uint8_t payloadLength;
+    uint8_t i;
+
+    if ((length < TAMPER_EVENT_HEADER_SIZE) || ((pBuffer[0] & 0xF0U) != TAMPER_EVENT_MAGIC) ||
+        ((pBuffer[0] & 0x0FU) == 0U))
+    {
+        return 0U;
+    }
+    payloadLength = pBuffer[8];
+    if ((payloadLength > TAMPER_EVENT_MAX_PAYLOAD) || ((TAMPER_EVENT_HEADER_SIZE + payloadLength) > length))
+    {
+        return 0U;
+    }
+    /*! The items must tile the payload, a truncated item means a corrupted record. */
+    i = 0U;
+    while (i < payloadLength)
+    {
+        i += 1U + TAMPER_ITEM_LENGTH(pBuffer[TAMPER_EVENT_HEADER_SIZE + i]);
+    }
+    if (i != payloadLength)
+    {
+        return 0U;
+    }
+
+    pEvent->version = pBuffer[0] & 0x0FU;
+    pEvent->type = pBuffer[1] & 0x1FU;
+    pEvent->severity = pBuffer[1] >> 5;
+    pEvent->sensorId = pBuffer[2];
+    pEvent->sequence = pBuffer[3];
+    pEvent->timestamp = (uint32_t)pBuffer[4] | ((uint32_t)pBuffer[5] << 8) | ((uint32_t)pBuffer[6] << 16) |
+                        ((uint32_t)pBuffer[7] << 24);
+    pEvent->payloadLength = payloadLength;
+    memcpy(pEvent->payload, &pBuffer[TAMPER_EVENT_HEADER_SIZE], payloadLength);
+
+    return TAMPER_EVENT_HEADER_SIZE + payloadLength;
+}
+
+const uint8_t *TamperEvent_FindItem(const tamperevent_t *pEvent, uint8_t tag)
+{
+    uint8_t i;
+
+    for (i = 0U; i < pEvent->payloadLength; i += 1U + TAMPER_ITEM_LENGTH(pEvent->payload[i]))
+    {
+        if (pEvent->payload[i] == tag)
+        {
+            return &pEvent->payload[i + 1U];
+        }
+    }
+
+    return NULL;
+}
+
+void TamperEvent_BatchReset(tamperbatch_t *pBatch)
+{
+    pBatch->length = 0U;
+}
+
+bool TamperEvent_BatchAppend(tamperbatch_t *pBatch, const uint8_t *pRecord, uint32_t length, uint32_t limit)
+{
+    if (limit > TAMPER_BATCH_MAX_SIZE)
+    {
+        limit = TAMPER_BATCH_MAX_SIZE;
+    }
+    if ((0U == length) || (length > limit) || ((limit - length) < pBatch->length))
+    {
+        return false;
+    }
+
+    memcpy(&pBatch->buffer[pBatch->length], pRecord, length);
+    pBatch->length += (uint16_t)length;
+
+    return true;
+}
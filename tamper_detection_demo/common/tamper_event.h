@@ -0,0 +1,158 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file tamper_event.h
+ * @brief The tamper_event.h file declares the binary tamper event record sent to the peers in place of the text
+ *        alert banners, a few bytes per alert in one write. The encoder and the decoder only use the C library,
+ *        the same files build on the gateway to decode the records.
+ *
+ *        Record, little endian:
+ *        | 0          | 1               | 2         | 3        | 4..7         | 8      | 9..          |
+ *        | 0xE0 | ver | severity | type | sensor ID | sequence | timestamp ms | length | payload items |
+ *
+ *        A payload item is a tag byte, item ID in the upper nibble and data length in the lower one, then the data.
+ *        Records may go back to back in one write, the decoder returns the size of each.
+ */
+
+#ifndef TAMPER_EVENT_H_
+#define TAMPER_EVENT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/*! @brief Version of the record format. */
+#define TAMPER_EVENT_VERSION        (1U)
+
+/*! @brief Upper nibble of the first byte, tells a record from the text and the device descriptor on the stream. */
+#define TAMPER_EVENT_MAGIC          (0xE0U)
+
+/*! @brief Size of a record without payload, in bytes. */
+#define TAMPER_EVENT_HEADER_SIZE    (9U)
+
+/*! @brief Largest payload, in bytes, so that any record fits one write at the default ATT MTU of 23. */
+#define TAMPER_EVENT_MAX_PAYLOAD    (11U)
+
+/*! @brief Largest record, in bytes. */
+#define TAMPER_EVENT_MAX_SIZE       (TAMPER_EVENT_HEADER_SIZE + TAMPER_EVENT_MAX_PAYLOAD)
+
+/*! @brief Largest batch of records, in bytes, one write at the largest ATT MTU of 247. */
+#define TAMPER_BATCH_MAX_SIZE       (244U)
+
+/*! @brief Payload items, data length in the lower nibble of the tag. */
+#define TAMPER_ITEM_CLASS           (0x11U) /*!< tamperClass_t of the motion. */
+#define TAMPER_ITEM_ORIENT          (0x22U) /*!< FXLS89xx ORIENT_STATUS and SDCD_INT_SRC1. */
+#define TAMPER_ITEM_PRESSURE        (0x38U) /*!< Pressure and reference, Pa, 2 x uint32. */
+
+/*! @brief Data length of an item tag. */
+#define TAMPER_ITEM_LENGTH(tag)     ((uint8_t)((tag) & 0x0FU))
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief Event types. */
+typedef enum tamperEventType_tag
+{
+    mTamperEvent_Safe_c = 0,     /*!< Back at rest, the asset is safe. */
+    mTamperEvent_Motion_c,       /*!< The asset was moved. */
+    mTamperEvent_Tilt_c,         /*!< The orientation of the asset changed. */
+    mTamperEvent_Pressure_c,     /*!< The pressure left its band, e.g. the enclosure was opened. */
+    mTamperEvent_Magnetic_c,     /*!< The magnet moved away, e.g. a door or lid was opened. */
+} tamperEventType_t;
+
+/*! @brief Event severities. */
+typedef enum tamperSeverity_tag
+{
+    mTamperSeverity_Info_c = 0,
+    mTamperSeverity_Warning_c,
+    mTamperSeverity_Alert_c,
+} tamperSeverity_t;
+
+/*! @brief This structure holds one event, decoded. */
+typedef struct
+{
+    uint8_t version;                            /*!< Record format version. */
+    uint8_t type;                               /*!< tamperEventType_t. */
+    uint8_t severity;                           /*!< tamperSeverity_t. */
+    uint8_t sensorId;                           /*!< WHO_AM_I of the sensor which raised the event. */
+    uint8_t sequence;                           /*!< Event counter, wraps, a gap tells a lost event. */
+    uint32_t timestamp;                         /*!< Time of the event, ms. */
+    uint8_t payloadLength;                      /*!< Bytes used in payload. */
+    uint8_t payload[TAMPER_EVENT_MAX_PAYLOAD];  /*!< Payload items. */
+} tamperevent_t;
+
+/*! @brief This structure holds encoded records waiting to go out in one write. */
+typedef struct
+{
+    uint16_t length;                            /*!< Bytes used in buffer. */
+    uint8_t buffer[TAMPER_BATCH_MAX_SIZE];      /*!< Records, back to back. */
+} tamperbatch_t;
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+/*! @brief       Starts an event without payload.
+ *  @param[out]  pEvent     event to fill.
+ *  @param[in]   type       tamperEventType_t.
+ *  @param[in]   severity   tamperSeverity_t.
+ *  @param[in]   sensorId   WHO_AM_I of the sensor.
+ *  @param[in]   sequence   event counter.
+ *  @param[in]   timestamp  time of the event, ms.
+ */
+void TamperEvent_Init(tamperevent_t *pEvent, uint8_t type, uint8_t severity, uint8_t sensorId, uint8_t sequence,
+                      uint32_t timestamp);
+
+/*! @brief       Appends a payload item.
+ *  @param[in]   pEvent  event to update.
+ *  @param[in]   tag     TAMPER_ITEM_xxx.
+ *  @param[in]   pData   TAMPER_ITEM_LENGTH(tag) bytes of data.
+ *  @return      true on success, false if the payload is full.
+ */
+bool TamperEvent_AddItem(tamperevent_t *pEvent, uint8_t tag, const uint8_t *pData);
+
+/*! @brief       Encodes an event.
+ *  @param[in]   pEvent   event to encode.
+ *  @param[out]  pBuffer  destination of the record.
+ *  @param[in]   size     size of pBuffer, TAMPER_EVENT_MAX_SIZE always fits.
+ *  @return      size of the record, 0 if it does not fit.
+ */
+uint32_t TamperEvent_Encode(const tamperevent_t *pEvent, uint8_t *pBuffer, uint32_t size);
+
+/*! @brief       Decodes a record.
+ *  @details     Records of a later version are decoded as far as this version knows them, the payload items are
+ *               checked to fill the payload exactly.
+ *  @param[in]   pBuffer  received bytes.
+ *  @param[in]   length   number of received bytes.
+ *  @param[out]  pEvent   decoded event.
+ *  @return      size of the record, 0 if pBuffer does not start with a whole valid record.
+ */
+uint32_t TamperEvent_Decode(const uint8_t *pBuffer, uint32_t length, tamperevent_t *pEvent);
+
+/*! @brief       Finds a payload item.
+ *  @param[in]   pEvent  decoded event.
+ *  @param[in]   tag     TAMPER_ITEM_xxx.
+ *  @return      the item data, NULL if the event does not hold it.
+ */
+const uint8_t *TamperEvent_FindItem(const tamperevent_t *pEvent, uint8_t tag);
+
+/*! @brief       Empties a batch.
+ *  @param[out]  pBatch  batch to empty.
+ */
+void TamperEvent_BatchReset(tamperbatch_t *pBatch);
+
+/*! @brief       Appends an encoded record to a batch.
+ *  @param[in]   pBatch   batch to update.
+ *  @param[in]   pRecord  encoded record.
+ *  @param[in]   length   size of the record.
+ *  @param[in]   limit    largest batch the link takes in one write, bytes.
+ *  @return      true on success, false if the record does not fit, the batch is left as it was.
+ */
+bool TamperEvent_BatchAppend(tamperbatch_t *pBatch, const uint8_t *pRecord, uint32_t length, uint32_t limit);
+
+#endif /* TAMPER_EVENT_H_ */
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file temp_comp.c
+ * @brief The temp_comp.c file implements the per-unit linear temperature correction.
+ */
+
+#include <stddef.h>
+#include "temp_comp.h"
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+bool TempComp_Init(tempcomp_t *pComp, const tempcompcoeffs_t *pCoeffs, int32_t hysteresis)
+{
+    bool calibrated = (pCoeffs != NULL) && (pCoeffs->magic == TEMP_COMP_MAGIC);
+
+    *pComp = (tempcomp_t){0};
+    if (calibrated)
+    {
+        pComp->coeffs = *pCoeffs;
+    }
+    pComp->hysteresis = (hysteresis >= 0) ? hysteresis : -hysteresis;
+
+    return calibrated;
+}
+
+int32_t TempComp_Correction(const tempcomp_t *pComp, int32_t temperature)
+{
+    /*! slope is in 1/256 units per degree and the temperature in 1/256 degree, 2^16 per unit. */
+    int64_t scaled = (int64_t)pComp->coeffs.slope * ((int64_t)temperature - pComp->coeffs.refTemp);
+
+    scaled = (scaled >= 0) ? (scaled + 32768) / 65536 : -((32768 - scaled) / 65536);
+
+    return pComp->coeffs.offset + (int32_t)scaled;
+}
+
+bool TempComp_Update(tempcomp_t *pComp, int32_t temperature)
+{
+    int32_t correction = TempComp_Correction(pComp, temperature);
+    int32_t delta = correction - pComp->applied;
+
+    if (pComp->programmed && (delta <= pComp->hysteresis) && (delta >= -pComp->hysteresis))
+    {
+        return false;
+    }
+
+    pComp->applied = correction;
+    pComp->programmed = true;
+
+    return true;
+}
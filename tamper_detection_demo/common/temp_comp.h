@@ -0,0 +1,76 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file temp_comp.h
+ * @brief The temp_comp.h file declares a per-unit linear temperature correction of a sensor value, and tells when
+ *        the hardware thresholds derived from it are worth re-programming.
+ */
+
+#ifndef TEMP_COMP_H_
+#define TEMP_COMP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/*! @brief Marks calibrated coefficients, "TCO1". */
+#define TEMP_COMP_MAGIC (0x54434F31UL)
+
+/*! @brief Temperatures are in 1/256 degree Celsius. */
+#define TEMP_COMP_Q8(degC) ((int32_t)(degC) * 256)
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief Calibration of one unit, 16 bytes, kept in NVM. */
+typedef struct
+{
+    uint32_t magic;  /*!< TEMP_COMP_MAGIC once the unit is calibrated. */
+    int32_t refTemp; /*!< Temperature of the calibration, 1/256 degree C. */
+    int32_t offset;  /*!< Error of the value at refTemp, value units. */
+    int32_t slope;   /*!< Change of the error per degree C, 1/256 value units. */
+} tempcompcoeffs_t;
+
+/*! @brief This structure holds the state of one temperature correction. */
+typedef struct
+{
+    tempcompcoeffs_t coeffs; /*!< Coefficients in use, all 0 for an uncalibrated unit. */
+    int32_t hysteresis;      /*!< Change of the correction which re-programs the thresholds, value units. */
+    int32_t applied;         /*!< Correction the thresholds were last programmed with. */
+    bool programmed;         /*!< The thresholds have been programmed once. */
+} tempcomp_t;
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+/*! @brief       Initializes a temperature correction.
+ *  @param[in]   pComp       correction to initialize.
+ *  @param[in]   pCoeffs     calibration of the unit, NULL or without TEMP_COMP_MAGIC for no correction.
+ *  @param[in]   hysteresis  change of the correction which re-programs the thresholds, value units.
+ *  @return      true if the unit is calibrated.
+ */
+bool TempComp_Init(tempcomp_t *pComp, const tempcompcoeffs_t *pCoeffs, int32_t hysteresis);
+
+/*! @brief       Returns the error of the value at a temperature.
+ *  @param[in]   pComp        correction to evaluate.
+ *  @param[in]   temperature  1/256 degree C.
+ *  @return      offset + slope * (temperature - refTemp), value units, rounded to nearest.
+ */
+int32_t TempComp_Correction(const tempcomp_t *pComp, int32_t temperature);
+
+/*! @brief       Accounts for a new temperature.
+ *  @details     The first call, and any call whose correction moved more than the hysteresis away from the one last
+ *               applied, updates pComp->applied and asks for the thresholds to be re-programmed.
+ *  @param[in]   pComp        correction to update.
+ *  @param[in]   temperature  1/256 degree C.
+ *  @return      true if the thresholds must be re-programmed with pComp->applied.
+ */
+bool TempComp_Update(tempcomp_t *pComp, int32_t temperature);
+
+#endif /* TEMP_COMP_H_ */
@@ -0,0 +1,166 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file tx_queue.c
+ * @brief The tx_queue.c file implements the bounded, prioritized transmit queue.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "tx_queue.h"
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void TxQueue_Remove(txqueue_t *pQueue, uint8_t index)
+{
+    memmove(&pQueue->entries[index], &pQueue->entries[index + 1U],
+            (size_t)(pQueue->count - index - 1U) * sizeof(txentry_t));
+    pQueue->count--;
+}
+
+void TxQueue_Init(txqueue_t *pQueue)
+{
+    memset(pQueue, 0, sizeof(txqueue_t));
+}
+
+void TxQueue_Reset(txqueue_t *pQueue)
+{
+    uint8_t i;
+
+    for (i = 0U; i < pQueue->count; i++)
+    {
+        pQueue->drops[pQueue->entries[i].cls]++;
+    }
+    pQueue->count = 0U;
+    pQueue->busy = false;
+    pQueue->held = false;
+}
+
+bool TxQueue_Push(txqueue_t *pQueue, uint8_t cls, const uint8_t *pData, uint32_t length)
+{
+    uint8_t first = pQueue->busy ? 1U : 0U;
+    uint8_t index;
+
+    if ((cls >= (uint8_t)mTxClass_Count_c) || (0U == length) || (length > TX_QUEUE_ENTRY_SIZE))
+    {
+        return false;
+    }
+
+    if (TX_QUEUE_DEPTH == pQueue->count)
+    {
+        /*! The newest entry of the lowest class makes room, unless it is in flight or not lower than the new one. */
+        index = pQueue->count - 1U;
+        if ((index < first) || (pQueue->entries[index].cls <= cls))
+        {
+            pQueue->drops[cls]++;
+            return false;
+        }
+        pQueue->drops[pQueue->entries[index].cls]++;
+        pQueue->count--;
+    }
+
+    /*! Behind all entries of the same or a higher class, the head in flight stays in place. */
+    index = pQueue->count;
+    while ((index > first) && (pQueue->entries[index - 1U].cls > cls))
+    {
+        index--;
+    }
+    memmove(&pQueue->entries[index + 1U], &pQueue->entries[index],
+            (size_t)(pQueue->count - index) * sizeof(txentry_t));
+    pQueue->entries[index].cls = cls;
+    pQueue->entries[index].retries = 0U;
+    pQueue->entries[index].length = (uint8_t)length;
+    memcpy(pQueue->entries[index].data, pData, length);
+    pQueue->count++;
+
+    return true;
+}
+
+bool TxQueue_PushMessage(txqueue_t *pQueue, uint8_t cls, const uint8_t *pData, uint32_t length)
+{
+    uint32_t queued;
+    uint32_t chunk;
+
+    if ((cls >= (uint8_t)mTxClass_Count_c) || (0U == length))
+    {
+        return false;
+    }
+
+    if (((length + TX_QUEUE_ENTRY_SIZE - 1U) / TX_QUEUE_ENTRY_SIZE) > (uint32_t)TxQueue_Room(pQueue, cls))
+    {
+        pQueue->drops[cls]++;
+        return false;
+    }
+
+    for (queued = 0U; queued < length; queued += chunk)
+    {
+        chunk = ((length - queued) < TX_QUEUE_ENTRY_SIZE) ? (length - queued) : TX_QUEUE_ENTRY_SIZE;
+        (void)TxQueue_Push(pQueue, cls, &pData[queued], chunk);
+    }
+
+    return true;
+}
+
+uint8_t TxQueue_Room(const txqueue_t *pQueue, uint8_t cls)
+{
+    uint8_t first = pQueue->busy ? 1U : 0U;
+    uint8_t room = TX_QUEUE_DEPTH - pQueue->count;
+    uint8_t index = pQueue->count;
+
+    /*! A push drops the newest entries of a lower class first, down to the head in flight. */
+    while ((index > first) && (pQueue->entries[index - 1U].cls > cls))
+    {
+        index--;
+        room++;
+    }
+
+    return room;
+}
+
+const txentry_t *TxQueue_Head(const txqueue_t *pQueue)
+{
+    return (0U != pQueue->count) ? &pQueue->entries[0] : NULL;
+}
+
+void TxQueue_Wait(txqueue_t *pQueue)
+{
+    pQueue->busy = (0U != pQueue->count);
+}
+
+void TxQueue_Done(txqueue_t *pQueue)
+{
+    pQueue->busy = false;
+    if (0U != pQueue->count)
+    {
+        TxQueue_Remove(pQueue, 0U);
+    }
+}
+
+bool TxQueue_Fail(txqueue_t *pQueue)
+{
+    txentry_t *pHead = &pQueue->entries[0];
+
+    pQueue->busy = false;
+    if (0U == pQueue->count)
+    {
+        return false;
+    }
+
+    if ((((uint8_t)mTxClass_Alert_c == pHead->cls) || ((uint8_t)mTxClass_Snapshot_c == pHead->cls)) &&
+        (pHead->retries < TX_QUEUE_MAX_RETRIES))
+    {
+        pHead->retries++;
+        pQueue->retries++;
+        return true;
+    }
+
+    pQueue->drops[pHead->cls]++;
+    TxQueue_Remove(pQueue, 0U);
+
+    return false;
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file tx_queue.h
+ * @brief The tx_queue.h file declares a bounded transmit queue of one peer, in fixed memory. Each entry has a
+ *        priority class, the queue sends the tamper alerts first and keeps them until the peer confirms them, the
+ *        status and debug entries give way when the queue or the link is full. Drops and retries are counted.
+ */
+
+#ifndef TX_QUEUE_H_
+#define TX_QUEUE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/*! @brief Entries of a queue. */
+#ifndef TX_QUEUE_DEPTH
+#define TX_QUEUE_DEPTH          (6U)
+#endif
+
+/*! @brief Largest entry, in bytes, a 70 byte text banner fits. Longer data takes several entries. */
+#ifndef TX_QUEUE_ENTRY_SIZE
+#define TX_QUEUE_ENTRY_SIZE     (72U)
+#endif
+
+/*! @brief Failed attempts after which an alert is given up. */
+#ifndef TX_QUEUE_MAX_RETRIES
+#define TX_QUEUE_MAX_RETRIES    (10U)
+#endif
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief Priority classes, highest first. */
+typedef enum txClass_tag
+{
+    mTxClass_Alert_c = 0,   /*!< Tamper event records, confirmed by the peer, retried. */
+    mTxClass_Status_c,      /*!< Status messages, dropped under load. */
+    mTxClass_Snapshot_c,    /*!< Snapshot samples, retried, queued only while there is room, see TxQueue_Room. */
+    mTxClass_Debug_c,       /*!< Debug text, dropped first. */
+    mTxClass_Count_c
+} txClass_t;
+
+/*! @brief This structure holds one queued entry. */
+typedef struct
+{
+    uint8_t cls;                            /*!< txClass_t. */
+    uint8_t retries;                        /*!< Failed attempts so far. */
+    uint8_t length;                         /*!< Bytes used in data. */
+    uint8_t data[TX_QUEUE_ENTRY_SIZE];      /*!< Entry data. */
+} txentry_t;
+
+/*! @brief This structure holds the queue of one peer. */
+typedef struct
+{
+    txentry_t entries[TX_QUEUE_DEPTH];      /*!< Entries by class, then by age, the head first. */
+    uint8_t count;                          /*!< Entries used. */
+    bool busy;                              /*!< The head is sent, waiting for the peer to confirm it. */
+    bool held;                              /*!< The host stack refused the head, nothing is sent until the retry. */
+    uint32_t drops[mTxClass_Count_c];       /*!< Entries dropped, per class. */
+    uint32_t retries;                       /*!< Failed attempts which were retried. */
+} txqueue_t;
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+/*! @brief       Initializes an empty queue and clears its counters.
+ *  @param[out]  pQueue  queue to initialize.
+ */
+void TxQueue_Init(txqueue_t *pQueue);
+
+/*! @brief       Drops all entries and the hold, e.g. when the peer disconnects, the counters are kept.
+ *  @param[in]   pQueue  queue to empty.
+ */
+void TxQueue_Reset(txqueue_t *pQueue);
+
+/*! @brief       Adds an entry behind the entries of the same or a higher class.
+ *  @details     A full queue drops its newest entry of a lower class to make room, or else the new entry.
+ *  @param[in]   pQueue  queue to update.
+ *  @param[in]   cls     txClass_t.
+ *  @param[in]   pData   entry data.
+ *  @param[in]   length  size of the data, at most TX_QUEUE_ENTRY_SIZE.
+ *  @return      true if queued, false if the entry was dropped.
+ */
+bool TxQueue_Push(txqueue_t *pQueue, uint8_t cls, const uint8_t *pData, uint32_t length);
+
+/*! @brief       Adds data of any length, cut into entries, all of them or none.
+ *  @details     A message is never sent in part: without room for all its entries none is queued and one drop of
+ *               the class is counted.
+ *  @param[in]   pQueue  queue to update.
+ *  @param[in]   cls     txClass_t.
+ *  @param[in]   pData   message data.
+ *  @param[in]   length  size of the data, at most TX_QUEUE_DEPTH entries.
+ *  @return      true if queued, false if the message was dropped.
+ */
+bool TxQueue_PushMessage(txqueue_t *pQueue, uint8_t cls, const uint8_t *pData, uint32_t length);
+
+/*! @brief       Tells how many entries of a class can be added without dropping one of the same or a higher class.
+ *  @details     The free entries, and the entries of a lower class a push would drop, the head in flight aside.
+ *  @param[in]   pQueue  queue to read.
+ *  @param[in]   cls     txClass_t.
+ *  @return      entries the class can take.
+ */
+uint8_t TxQueue_Room(const txqueue_t *pQueue, uint8_t cls);
+
+/*! @brief       Gets the entry to send next.
+ *  @param[in]   pQueue  queue to read.
+ *  @return      the head, NULL if the queue is empty.
+ */
+const txentry_t *TxQueue_Head(const txqueue_t *pQueue);
+
+/*! @brief       Marks the head as sent, waiting for the peer to confirm it.
+ *  @param[in]   pQueue  queue to update.
+ */
+void TxQueue_Wait(txqueue_t *pQueue);
+
+/*! @brief       Removes the head once sent, or confirmed.
+ *  @param[in]   pQueue  queue to update.
+ */
+void TxQueue_Done(txqueue_t *pQueue);
+
+/*! @brief       Reports that the head could not be sent, or was not confirmed.
+ *  @details     An alert or a snapshot entry is kept and sent again up to TX_QUEUE_MAX_RETRIES times, other entries
+ *               are dropped.
+ *  @param[in]   pQueue  queue to update.
+ *  @return      true if the head is kept to be sent again.
+ */
+bool TxQueue_Fail(txqueue_t *pQueue);
+
+#endif /* TX_QUEUE_H_ */
@@ -21,12 +21,18 @@ extern void LPUART1_DeinitPins();
 /* User needs to provide the implementation of LPI2CX_GetFreq/LPI2CX_InitPins/LPI2CX_DeinitPins for the enabled LPI2C
  * instance. */
 #define RTE_I2C1        1
+/* Set to 1 (e.g. -DRTE_I2C1_DMA_EN=1) to move sensor transfers on I2C_S_DRIVER from interrupt-per-byte to eDMA. */
+#ifndef RTE_I2C1_DMA_EN
 #define RTE_I2C1_DMA_EN 0
+#endif
 
 /* User needs to provide the implementation of LPSPIX_GetFreq/LPSPIX_InitPins/LPSPIX_DeinitPins for the enabled LPSPI
  * instance. */
 #define RTE_SPI1        1
+/* Set to 1 (e.g. -DRTE_SPI1_DMA_EN=1) to move sensor transfers on SPI_S_DRIVER from interrupt-per-frame to eDMA. */
+#ifndef RTE_SPI1_DMA_EN
 #define RTE_SPI1_DMA_EN 0
+#endif
 
 /* User needs to provide the implementation of LPUARTX_GetFreq/LPUARTX_InitPins/LPUARTX_DeinitPins for the enabled
  * LPUART instance. */
@@ -53,11 +59,12 @@ extern void LPUART1_DeinitPins();
 #define RTE_SPI1_SLAVE_PCS_PIN_SEL      (kLPSPI_SlavePcs0)
 #define RTE_SPI1_PIN_INIT               LPSPI1_InitPins
 #define RTE_SPI1_PIN_DEINIT             LPSPI1_DeinitPins
-#define RTE_SPI1_DMA_TX_CH              0
+/* Channels 0 and 1 are taken by LPI2C1. */
+#define RTE_SPI1_DMA_TX_CH              2
 #define RTE_SPI1_DMA_TX_PERI_SEL        (uint8_t) kDmaRequestLPSPI1Tx
 #define RTE_SPI1_DMA_TX_DMAMUX_BASE     DMAMUX
 #define RTE_SPI1_DMA_TX_DMA_BASE        DMA0
-#define RTE_SPI1_DMA_RX_CH              1
+#define RTE_SPI1_DMA_RX_CH              3
 #define RTE_SPI1_DMA_RX_PERI_SEL        (uint8_t) kDmaRequestLPSPI1Rx
 #define RTE_SPI1_DMA_RX_DMAMUX_BASE     DMAMUX
 #define RTE_SPI1_DMA_RX_DMA_BASE        DMA0
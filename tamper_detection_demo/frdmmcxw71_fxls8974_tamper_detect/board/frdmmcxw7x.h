@@ -26,6 +26,16 @@ extern gpioHandleKSDK_t D10;
 #define I2C_S2_DEVICE_INDEX I2C1_INDEX
 #define I2C_S2_SIGNAL_EVENT I2C1_SignalEvent_t
 
+// FXLS8974 INT1: on-board accelerometer interrupt line, routed to a WUU capable GPIO
+#define FXLS8974_INT1_PORT      PORTC
+#define FXLS8974_INT1_PORT_NUM  PORTC_NUM
+#define FXLS8974_INT1_PIN       4U
+
+// FXLS8974 INT2: sample buffer watermark interrupt line
+#define FXLS8974_INT2_PORT      PORTC
+#define FXLS8974_INT2_PORT_NUM  PORTC_NUM
+#define FXLS8974_INT2_PIN       5U
+
 // SPI: Driver information default SPI brought to shield
 #define SPI_S_DRIVER       Driver_SPI1
 #define SPI_S_BAUDRATE     500000U ///< Transfer baudrate - 500k
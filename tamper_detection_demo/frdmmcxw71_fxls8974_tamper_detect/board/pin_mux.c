@@ -96,6 +96,86 @@ void LPI2C1_InitPins(void)
     /* PORTB5 (pin 3) is configured as LPI2C1_SCL */
     PORT_SetPinConfig(LPI2C1_INITPINS_LPI2C1_SCL_PORT, LPI2C1_INITPINS_LPI2C1_SCL_PIN, &LPI2C1_SCL);
 }
+
+/* The chip select is driven as a GPIO by the sensor driver (D10), only the clock and data lines are routed here. */
+void LPSPI1_InitPins(void)
+{
+    /* Clock Configuration: Peripheral clocks are enabled; module does not stall low power mode entry */
+    CLOCK_EnableClock(kCLOCK_PortB);
+
+    const port_pin_config_t LPSPI1_SCK = {/* Internal pull-up/down resistor is disabled */
+                                          (uint16_t)kPORT_PullDisable,
+                                          /* Low internal pull resistor value is selected. */
+                                          (uint16_t)kPORT_LowPullResistor,
+                                          /* Fast slew rate is configured */
+                                          (uint16_t)kPORT_FastSlewRate,
+                                          /* Passive input filter is disabled */
+                                          (uint16_t)kPORT_PassiveFilterDisable,
+                                          /* Open drain output is disabled */
+                                          (uint16_t)kPORT_OpenDrainDisable,
+                                          /* High drive strength is configured */
+                                          (uint16_t)kPORT_HighDriveStrength,
+                                          /* Normal drive strength is configured */
+                                          (uint16_t)kPORT_NormalDriveStrength,
+                                          /* Pin is configured as LPSPI1_SCK */
+                                          (uint16_t)kPORT_MuxAlt2,
+                                          /* Pin Control Register fields [15:0] are not locked */
+                                          (uint16_t)kPORT_UnlockRegister};
+    /* PORTB2 (pin 48) is configured as LPSPI1_SCK */
+    PORT_SetPinConfig(LPSPI1_INITPINS_LPSPI1_SCK_PORT, LPSPI1_INITPINS_LPSPI1_SCK_PIN, &LPSPI1_SCK);
+
+    const port_pin_config_t LPSPI1_SIN = {/* Internal pull-up/down resistor is disabled */
+                                          (uint16_t)kPORT_PullDisable,
+                                          /* Low internal pull resistor value is selected. */
+                                          (uint16_t)kPORT_LowPullResistor,
+                                          /* Fast slew rate is configured */
+                                          (uint16_t)kPORT_FastSlewRate,
+                                          /* Passive input filter is disabled */
+                                          (uint16_t)kPORT_PassiveFilterDisable,
+                                          /* Open drain output is disabled */
+                                          (uint16_t)kPORT_OpenDrainDisable,
+                                          /* High drive strength is configured */
+                                          (uint16_t)kPORT_HighDriveStrength,
+                                          /* Normal drive strength is configured */
+                                          (uint16_t)kPORT_NormalDriveStrength,
+                                          /* Pin is configured as LPSPI1_SIN */
+                                          (uint16_t)kPORT_MuxAlt2,
+                                          /* Pin Control Register fields [15:0] are not locked */
+                                          (uint16_t)kPORT_UnlockRegister};
+    /* PORTB1 (pin 47) is configured as LPSPI1_SIN */
+    PORT_SetPinConfig(LPSPI1_INITPINS_LPSPI1_IN_PORT, LPSPI1_INITPINS_LPSPI1_IN_PIN, &LPSPI1_SIN);
+
+    const port_pin_config_t LPSPI1_SOUT = {/* Internal pull-up/down resistor is disabled */
+                                           (uint16_t)kPORT_PullDisable,
+                                           /* Low internal pull resistor value is selected. */
+                                           (uint16_t)kPORT_LowPullResistor,
+                                           /* Fast slew rate is configured */
+                                           (uint16_t)kPORT_FastSlewRate,
+                                           /* Passive input filter is disabled */
+                                           (uint16_t)kPORT_PassiveFilterDisable,
+                                           /* Open drain output is disabled */
+                                           (uint16_t)kPORT_OpenDrainDisable,
+                                           /* High drive strength is configured */
+                                           (uint16_t)kPORT_HighDriveStrength,
+                                           /* Normal drive strength is configured */
+                                           (uint16_t)kPORT_NormalDriveStrength,
+                                           /* Pin is configured as LPSPI1_SOUT */
+                                           (uint16_t)kPORT_MuxAlt2,
+                                           /* Pin Control Register fields [15:0] are not locked */
+                                           (uint16_t)kPORT_UnlockRegister};
+    /* PORTB3 (pin 1) is configured as LPSPI1_SOUT */
+    PORT_SetPinConfig(LPSPI1_INITPINS_LPSPI1_OUT_PORT, LPSPI1_INITPINS_LPSPI1_OUT_PIN, &LPSPI1_SOUT);
+}
+
+void LPSPI1_DeinitPins(void)
+{
+    /* PORTB2 (pin 48) is disabled */
+    PORT_SetPinMux(LPSPI1_DEINITPINS_LPSPI1_SCK_PORT, LPSPI1_DEINITPINS_LPSPI1_SCK_PIN, kPORT_PinDisabledOrAnalog);
+    /* PORTB1 (pin 47) is disabled */
+    PORT_SetPinMux(LPSPI1_DEINITPINS_LPSPI1_IN_PORT, LPSPI1_DEINITPINS_LPSPI1_IN_PIN, kPORT_PinDisabledOrAnalog);
+    /* PORTB3 (pin 1) is disabled */
+    PORT_SetPinMux(LPSPI1_DEINITPINS_LPSPI1_OUT_PORT, LPSPI1_DEINITPINS_LPSPI1_OUT_PIN, kPORT_PinDisabledOrAnalog);
+}
 void BOARD_InitPins_ACCE(void)
 {
     /* Clock Configuration: Peripheral clocks are enabled; module does not stall low power mode entry */
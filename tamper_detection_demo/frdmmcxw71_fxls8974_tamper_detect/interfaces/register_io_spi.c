@@ -149,6 +149,22 @@ void SPI8_SignalEvent_t(uint32_t event)
 #endif
 #endif
 
+/*! The register idle function which sleeps until the SPI transfer completes. */
+void Register_SPI_WaitForInterrupt(void *pDevInfo)
+{
+    registerDeviceInfo_t *devInfo = (registerDeviceInfo_t *)pDevInfo;
+    uint32_t primask;
+
+    /*! A pending interrupt still ends the WFI while masked, it is taken once PRIMASK is restored.*/
+    primask = DisableGlobalIRQ();
+    if (!b_SPI_CompletionFlag[devInfo->deviceInstance])
+    {
+        __DSB();
+        __WFI();
+    }
+    EnableGlobalIRQ(primask);
+}
+
 /* Control Slave Select based on inactive/active and active low/high. */
 void register_spi_control(spiControlParams_t *ssControl)
 {
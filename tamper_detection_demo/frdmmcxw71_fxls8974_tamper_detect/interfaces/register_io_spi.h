@@ -236,4 +236,14 @@ int32_t Register_SPI_Read(ARM_DRIVER_SPI *pCommDrv,
                           uint8_t length,
                           uint8_t *pOutBuffer);
 
+/*!
+ * @brief The register idle function which puts the CPU in WFI until the SPI transfer completes.
+ *
+ * Pass it with the device info as parameter to the sensor SetIdleTask() API, same as
+ * Register_I2C_WaitForInterrupt().
+ *
+ * @param void *pDevInfo - The registerDeviceInfo_t of the device waiting on the bus.
+ */
+void Register_SPI_WaitForInterrupt(void *pDevInfo);
+
 #endif // __REGISTER_IO_SPI_H__
@@ -27,6 +27,25 @@ uint8_t fxls8974_spiWrite_CmdDataBuffer[FXLS8974_SPI_MAX_MSG_SIZE] = {0};
 //-----------------------------------------------------------------------
 // Functions
 //-----------------------------------------------------------------------
+/* Unpack the little-endian samples of a buffer drain, the newest one is stamped with timestamp. */
+static void FXLS8974_UnpackBuffer(const uint8_t *pRaw,
+                                  fxls8974_acceldata_t *pSamples,
+                                  uint8_t count,
+                                  uint32_t timestamp,
+                                  uint32_t samplePeriod)
+{
+    uint8_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        pSamples[i].timestamp = timestamp - (uint32_t)(count - 1 - i) * samplePeriod;
+        pSamples[i].accel[0] = (int16_t)((uint16_t)pRaw[1] << 8 | pRaw[0]);
+        pSamples[i].accel[1] = (int16_t)((uint16_t)pRaw[3] << 8 | pRaw[2]);
+        pSamples[i].accel[2] = (int16_t)((uint16_t)pRaw[5] << 8 | pRaw[4]);
+        pRaw += FXLS8974_BUF_SAMPLE_SIZE;
+    }
+}
+
 void FXLS8974_SPI_ReadPreprocess(void *pCmdOut, uint32_t offset, uint32_t size)
 {
     spiCmdParams_t *pSlaveCmd = pCmdOut;
@@ -88,6 +107,7 @@ int32_t FXLS8974_SPI_Initialize(
     pSensorHandle->deviceInfo.deviceInstance = index;
     pSensorHandle->deviceInfo.functionParam = NULL;
     pSensorHandle->deviceInfo.idleFunction = NULL;
+    pSensorHandle->deviceInfo.pCache = NULL;
 
     /* Initialize the Slave Select Pin. */
     pGPIODriver->pin_init(pSlaveSelect, GPIO_DIRECTION_OUT, NULL, NULL, NULL);
@@ -201,6 +221,70 @@ int32_t FXLS8974_SPI_ReadData(fxls8974_spi_sensorhandle_t *pSensorHandle,
     return SENSOR_ERROR_NONE;
 }
 
+int32_t FXLS8974_SPI_ReadBuffer(fxls8974_spi_sensorhandle_t *pSensorHandle,
+                                fxls8974_acceldata_t *pSamples,
+                                uint8_t maxSamples,
+                                uint32_t timestamp,
+                                uint32_t samplePeriod,
+                                uint8_t *pNumSamples,
+                                uint8_t *pBufStatus)
+{
+    int32_t status;
+    uint8_t bufStatus;
+    uint8_t count;
+    static uint8_t rawBuffer[FXLS8974_BUF_MAX_SAMPLES * FXLS8974_BUF_SAMPLE_SIZE];
+
+    /*! Validate for the correct handle and output buffers.*/
+    if ((pSensorHandle == NULL) || (pSamples == NULL) || (pNumSamples == NULL) || (maxSamples == 0) ||
+        (maxSamples > FXLS8974_BUF_MAX_SAMPLES))
+    {
+        return SENSOR_ERROR_INVALID_PARAM;
+    }
+
+    /*! Check whether sensor handle is initialized before reading sensor data.*/
+    if (pSensorHandle->isInitialized != true)
+    {
+        return SENSOR_ERROR_INIT;
+    }
+
+    *pNumSamples = 0;
+
+    /*! Read the number of queued samples and the overflow/watermark flags.*/
+    status = Register_SPI_Read(pSensorHandle->pCommDrv, &pSensorHandle->deviceInfo, &pSensorHandle->slaveParams,
+                               FXLS8974_BUF_STATUS, 1, &bufStatus);
+    if (ARM_DRIVER_OK != status)
+    {
+        return SENSOR_ERROR_READ;
+    }
+    if (pBufStatus != NULL)
+    {
+        *pBufStatus = bufStatus;
+    }
+
+    count = (bufStatus & FXLS8974_BUF_STATUS_BUF_CNT_MASK) >> FXLS8974_BUF_STATUS_BUF_CNT_SHIFT;
+    if (count > maxSamples)
+    {
+        count = maxSamples;
+    }
+    if (count == 0)
+    {
+        return SENSOR_ERROR_NONE;
+    }
+
+    /*! Drain all samples in one burst, the register pointer wraps as on I2C. */
+    status = Register_SPI_Read(pSensorHandle->pCommDrv, &pSensorHandle->deviceInfo, &pSensorHandle->slaveParams,
+                               FXLS8974_BUF_X_LSB, count * FXLS8974_BUF_SAMPLE_SIZE, rawBuffer);
+    if (ARM_DRIVER_OK != status)
+    {
+        return SENSOR_ERROR_READ;
+    }
+
+    FXLS8974_UnpackBuffer(rawBuffer, pSamples, count, timestamp, samplePeriod);
+    *pNumSamples = count;
+
+    return SENSOR_ERROR_NONE;
+}
+
 int32_t FXLS8974_SPI_Deinit(fxls8974_spi_sensorhandle_t *pSensorHandle)
 {
     int32_t status;
@@ -251,6 +335,7 @@ int32_t FXLS8974_I2C_Initialize(
     pSensorHandle->deviceInfo.deviceInstance = index;
     pSensorHandle->deviceInfo.functionParam = NULL;
     pSensorHandle->deviceInfo.idleFunction = NULL;
+    pSensorHandle->deviceInfo.pCache = NULL;
 
     /*!  Read and store the device's WHO_AM_I.*/
     status = Register_I2C_Read(pBus, &pSensorHandle->deviceInfo, sAddress, FXLS8974_WHO_AM_I, 1, &reg);
@@ -356,6 +441,103 @@ int32_t FXLS8974_I2C_ReadData(fxls8974_i2c_sensorhandle_t *pSensorHandle,
     return SENSOR_ERROR_NONE;
 }
 
+int32_t FXLS8974_I2C_ReadBuffer(fxls8974_i2c_sensorhandle_t *pSensorHandle,
+                                fxls8974_acceldata_t *pSamples,
+                                uint8_t maxSamples,
+                                uint32_t timestamp,
+                                uint32_t samplePeriod,
+                                uint8_t *pNumSamples,
+                                uint8_t *pBufStatus)
+{
+    int32_t status;
+    uint8_t bufStatus;
+    uint8_t count;
+    static uint8_t rawBuffer[FXLS8974_BUF_MAX_SAMPLES * FXLS8974_BUF_SAMPLE_SIZE];
+
+    /*! Validate for the correct handle and output buffers.*/
+    if ((pSensorHandle == NULL) || (pSamples == NULL) || (pNumSamples == NULL) || (maxSamples == 0) ||
+        (maxSamples > FXLS8974_BUF_MAX_SAMPLES))
+    {
+        return SENSOR_ERROR_INVALID_PARAM;
+    }
+
+    /*! Check whether sensor handle is initialized before reading sensor data.*/
+    if (pSensorHandle->isInitialized != true)
+    {
+        return SENSOR_ERROR_INIT;
+    }
+
+    *pNumSamples = 0;
+
+    /*! Read the number of queued samples and the overflow/watermark flags.*/
+    status = Register_I2C_Read(pSensorHandle->pCommDrv, &pSensorHandle->deviceInfo, pSensorHandle->slaveAddress,
+                               FXLS8974_BUF_STATUS, 1, &bufStatus);
+    if (ARM_DRIVER_OK != status)
+    {
+        return SENSOR_ERROR_READ;
+    }
+    if (pBufStatus != NULL)
+    {
+        *pBufStatus = bufStatus;
+    }
+
+    count = (bufStatus & FXLS8974_BUF_STATUS_BUF_CNT_MASK) >> FXLS8974_BUF_STATUS_BUF_CNT_SHIFT;
+    if (count > maxSamples)
+    {
+        count = maxSamples;
+    }
+    if (count == 0)
+    {
+        return SENSOR_ERROR_NONE;
+    }
+
+    /*! Drain all samples in one burst, the register pointer wraps from BUF_Z_MSB back to BUF_X_LSB
+     *  and every wrap pops the next sample out of the buffer. */
+    status = Register_I2C_Read(pSensorHandle->pCommDrv, &pSensorHandle->deviceInfo, pSensorHandle->slaveAddress,
+                               FXLS8974_BUF_X_LSB, count * FXLS8974_BUF_SAMPLE_SIZE, rawBuffer);
+    if (ARM_DRIVER_OK != status)
+    {
+        return SENSOR_ERROR_READ;
+    }
+
+    FXLS8974_UnpackBuffer(rawBuffer, pSamples, count, timestamp, samplePeriod);
+    *pNumSamples = count;
+
+    return SENSOR_ERROR_NONE;
+}
+
+int32_t FXLS8974_I2C_ReadDataAsync(fxls8974_i2c_sensorhandle_t *pSensorHandle,
+                                   registerasyncxfer_t *pXfer,
+                                   const registerreadlist_t *pReadList,
+                                   uint8_t *pBuffer,
+                                   registerasynccallback_t callback,
+                                   void *userParam)
+{
+    int32_t status;
+
+    /*! Validate for the correct handle and register read list.*/
+    if ((pSensorHandle == NULL) || (pXfer == NULL) || (pReadList == NULL) || (pBuffer == NULL))
+    {
+        return SENSOR_ERROR_INVALID_PARAM;
+    }
+
+    /*! Check whether sensor handle is initialized before reading sensor data.*/
+    if (pSensorHandle->isInitialized != true)
+    {
+        return SENSOR_ERROR_INIT;
+    }
+
+    /*! Queue the read list, the callback reports the outcome. */
+    status = Register_I2C_ReadAsync(pSensorHandle->pCommDrv, &pSensorHandle->deviceInfo, pSensorHandle->slaveAddress,
+                                    pXfer, pReadList, pBuffer, callback, userParam);
+    if (ARM_DRIVER_OK != status)
+    {
+        return SENSOR_ERROR_READ;
+    }
+
+    return SENSOR_ERROR_NONE;
+}
+
 int32_t FXLS8974_I2C_DeInit(fxls8974_i2c_sensorhandle_t *pSensorHandle)
 {
     int32_t status;
@@ -381,8 +563,9 @@ int32_t FXLS8974_I2C_DeInit(fxls8974_i2c_sensorhandle_t *pSensorHandle)
     }
     else
     {
-        /*! De-initialize sensor handle. */
+        /*! De-initialize sensor handle, the reset returned every register to its default. */
         pSensorHandle->isInitialized = false;
+        Register_I2C_InvalidateCache(&pSensorHandle->deviceInfo, 0, SENSOR_MAX_REGISTER_COUNT);
     }
 
     /* Wait for MAX of TBOOT ms after soft reset command,
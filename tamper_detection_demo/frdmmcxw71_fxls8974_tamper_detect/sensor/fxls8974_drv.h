@@ -56,8 +56,8 @@ typedef struct
 } fxls8974_acceldata_t;
 
 /*! @def    fxls8974_SPI_MAX_MSG_SIZE
- *  @brief  The MAX size of SPI message. */
-#define FXLS8974_SPI_MAX_MSG_SIZE (64)
+ *  @brief  The MAX size of SPI message, a full sample buffer drain and its header. */
+#define FXLS8974_SPI_MAX_MSG_SIZE (FXLS8974_BUF_MAX_SAMPLES * FXLS8974_BUF_SAMPLE_SIZE + FXLS8974_SPI_CMD_LEN)
 
 /*! @def    FXLS8974_SPI_CMD_LEN
  *  @brief  The size of the Sensor specific SPI Header. */
@@ -67,6 +67,14 @@ typedef struct
  *  @brief  Is the Slave Select Pin Active Low or High. */
 #define FXLS8974_SS_ACTIVE_VALUE SPI_SS_ACTIVE_LOW
 
+/*! @def    FXLS8974_BUF_MAX_SAMPLES
+ *  @brief  The depth of the on-chip sample buffer. */
+#define FXLS8974_BUF_MAX_SAMPLES (32)
+
+/*! @def    FXLS8974_BUF_SAMPLE_SIZE
+ *  @brief  The size of one X/Y/Z sample in the sample buffer. */
+#define FXLS8974_BUF_SAMPLE_SIZE (6)
+
 /*******************************************************************************
  * APIs
  ******************************************************************************/
@@ -124,6 +132,52 @@ int32_t FXLS8974_I2C_ReadData(fxls8974_i2c_sensorhandle_t *pSensorHandle,
                               const registerreadlist_t *pReadList,
                               uint8_t *pBuffer);
 
+/*! @brief       The interface function to read the sensor data without blocking.
+ *  @details     This function queues the reads of the register list on the I2C bus and returns immediately.
+ *               The callback runs from the I2C interrupt once pBuffer holds the data or the read failed.
+ *  @param[in]   pSensorHandle  handle to the sensor.
+ *  @param[in]   pXfer          transfer descriptor, owned by the caller until the callback has run.
+ *  @param[in]   pReadList      pointer to the list of device registers and values to read.
+ *  @param[out]  pBuffer        buffer which holds raw sensor data.
+ *  @param[in]   callback       completion callback, receives ARM_DRIVER_OK or an ARM_DRIVER_ERROR code.
+ *  @param[in]   userParam      parameter passed to the callback.
+ *  @constraints This can be called only after FXLS8974_I2C_Initialize().
+ *               The blocking APIs must not be used while the transfer is pending.
+ *  @reeentrant  Yes
+ *  @return      ::FXLS8974_I2C_ReadDataAsync() returns the status .
+ */
+int32_t FXLS8974_I2C_ReadDataAsync(fxls8974_i2c_sensorhandle_t *pSensorHandle,
+                                   registerasyncxfer_t *pXfer,
+                                   const registerreadlist_t *pReadList,
+                                   uint8_t *pBuffer,
+                                   registerasynccallback_t callback,
+                                   void *userParam);
+
+/*! @brief       The interface function to drain the sensor sample buffer.
+ *  @details     This function reads BUF_STATUS and then empties every queued sample in one auto-increment burst
+ *               starting at BUF_X_LSB. Samples are returned oldest first and time stamped backwards from
+ *               timestamp, which is taken as the time of the newest sample.
+ *  @param[in]   pSensorHandle handle to the sensor.
+ *  @param[out]  pSamples      array of at least maxSamples entries which receives the samples.
+ *  @param[in]   maxSamples    size of pSamples, at most FXLS8974_BUF_MAX_SAMPLES.
+ *  @param[in]   timestamp     time of the newest sample.
+ *  @param[in]   samplePeriod  time between two samples at the current ODR, in the same unit as timestamp.
+ *  @param[out]  pNumSamples   number of samples written to pSamples.
+ *  @param[out]  pBufStatus    optional, the BUF_STATUS value read before the drain (BUF_OVF, BUF_WMRK).
+ *  @constraints This can be called any number of times only after FXLS8974_I2C_Initialize().
+ *               The sample buffer must be configured in FIFO mode through BUF_CONFIG1.
+ *               Application has to ensure that previous instances of these APIs have exited before invocation.
+ *  @reeentrant  No
+ *  @return      ::FXLS8974_I2C_ReadBuffer() returns the status .
+ */
+int32_t FXLS8974_I2C_ReadBuffer(fxls8974_i2c_sensorhandle_t *pSensorHandle,
+                                fxls8974_acceldata_t *pSamples,
+                                uint8_t maxSamples,
+                                uint32_t timestamp,
+                                uint32_t samplePeriod,
+                                uint8_t *pNumSamples,
+                                uint8_t *pBufStatus);
+
 /*! @brief       The interface function to De Initialize sensor..
  *  @details     This function made sensor in a power safe state and de initialize its handle.
  *  @param[in]   pSensorHandle handle to the sensor.
@@ -191,6 +245,29 @@ int32_t FXLS8974_SPI_ReadData(fxls8974_spi_sensorhandle_t *pSensorHandle,
                               const registerreadlist_t *pReadList,
                               uint8_t *pBuffer);
 
+/*! @brief       The interface function to drain the sensor sample buffer.
+ *  @details     Same as FXLS8974_I2C_ReadBuffer(), the whole burst fits one SPI message.
+ *  @param[in]   pSensorHandle handle to the sensor.
+ *  @param[out]  pSamples      array of at least maxSamples entries which receives the samples.
+ *  @param[in]   maxSamples    size of pSamples, at most FXLS8974_BUF_MAX_SAMPLES.
+ *  @param[in]   timestamp     time of the newest sample.
+ *  @param[in]   samplePeriod  time between two samples at the current ODR, in the same unit as timestamp.
+ *  @param[out]  pNumSamples   number of samples written to pSamples.
+ *  @param[out]  pBufStatus    optional, the BUF_STATUS value read before the drain (BUF_OVF, BUF_WMRK).
+ *  @constraints This can be called any number of times only after FXLS8974_SPI_Initialize().
+ *               The sample buffer must be configured in FIFO mode through BUF_CONFIG1.
+ *               Application has to ensure that previous instances of these APIs have exited before invocation.
+ *  @reeentrant  No
+ *  @return      ::FXLS8974_SPI_ReadBuffer() returns the status .
+ */
+int32_t FXLS8974_SPI_ReadBuffer(fxls8974_spi_sensorhandle_t *pSensorHandle,
+                                fxls8974_acceldata_t *pSamples,
+                                uint8_t maxSamples,
+                                uint32_t timestamp,
+                                uint32_t samplePeriod,
+                                uint8_t *pNumSamples,
+                                uint8_t *pBufStatus);
+
 /*! @brief       The interface function to De Initialize sensor..
  *  @details     This function made sensor in a power safe state and de initialize its handle.
  *  @param[in]   pSensorHandle      handle to the sensor.
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file bus_bench.c
+ * @brief The bus_bench.c file implements the cycle counter benchmark of the sample drains.
+ */
+
+#include <stddef.h>
+#include "fsl_device_registers.h"
+#include "bus_bench.h"
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/* Append a text, returns the new length. */
+static uint32_t BusBench_Append(char *pBuffer, uint32_t size, uint32_t length, const char *pText)
+{
+    for (; (*pText != '\0') && (length + 1U < size); pText++)
+    {
+        pBuffer[length++] = *pText;
+    }
+    pBuffer[length] = '\0';
+
+    return length;
+}
+
+/* Append a label and the decimal text of a number, returns the new length. */
+static uint32_t BusBench_Print(char *pBuffer, uint32_t size, uint32_t length, const char *pLabel, uint64_t value)
+{
+    char digits[20];
+    uint8_t count = 0U;
+
+    length = BusBench_Append(pBuffer, size, length, pLabel);
+    do
+    {
+        digits[count++] = (char)('0' + (value % 10U));
+        value /= 10U;
+    } while (value != 0U);
+    while ((count != 0U) && (length + 1U < size))
+    {
+        pBuffer[length++] = digits[--count];
+    }
+    pBuffer[length] = '\0';
+
+    return length;
+}
+
+void BusBench_Reset(busbench_t *pBench)
+{
+#if (BUS_BENCH_DWT == 1)
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    *pBench = (busbench_t){0};
+}
+
+void BusBench_Begin(busbench_t *pBench)
+{
+    pBench->active = true;
+    pBench->startTime = BUS_BENCH_NOW();
+}
+
+void BusBench_End(busbench_t *pBench, uint32_t samples)
+{
+    if (!pBench->active)
+    {
+        return;
+    }
+
+    pBench->busCycles += BUS_BENCH_NOW() - pBench->startTime;
+    pBench->active = false;
+    pBench->drains++;
+    pBench->samples += samples;
+}
+
+void BusBench_AddSleep(busbench_t *pBench, uint32_t cycles)
+{
+    if (pBench->active)
+    {
+        pBench->sleepCycles += cycles;
+    }
+}
+
+uint32_t BusBench_Format(const busbench_t *pBench, const char *pName, uint32_t clockHz, char *pBuffer, uint32_t size)
+{
+    uint32_t length = 0U;
+    uint64_t busPerSample = 0U;
+    uint64_t cpuPerSample = 0U;
+    uint32_t cyclesPerUs = clockHz / 1000000U;
+
+    if ((pBuffer == NULL) || (size == 0U))
+    {
+        return 0U;
+    }
+
+    if (pBench->samples != 0U)
+    {
+        busPerSample = pBench->busCycles / pBench->samples;
+        cpuPerSample = (pBench->busCycles - pBench->sleepCycles) / pBench->samples;
+    }
+    if (cyclesPerUs == 0U)
+    {
+        cyclesPerUs = 1U;
+    }
+
+    length = BusBench_Append(pBuffer, size, length, "\r\n");
+    length = BusBench_Append(pBuffer, size, length, pName);
+    length = BusBench_Print(pBuffer, size, length, " drains ", pBench->drains);
+    length = BusBench_Print(pBuffer, size, length, " n ", pBench->samples);
+    length = BusBench_Print(pBuffer, size, length, "\r\n bus cyc/n ", busPerSample);
+    length = BusBench_Print(pBuffer, size, length, " ns/n ", (busPerSample * 1000U) / cyclesPerUs);
+    length = BusBench_Print(pBuffer, size, length, "\r\n cpu cyc/n ", cpuPerSample);
+    length = BusBench_Print(pBuffer, size, length, " ns/n ", (cpuPerSample * 1000U) / cyclesPerUs);
+
+    return length;
+}
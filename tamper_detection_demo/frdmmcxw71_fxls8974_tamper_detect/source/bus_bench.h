@@ -0,0 +1,79 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file bus_bench.h
+ * @brief The bus_bench.h file declares a cycle counter benchmark of the sample drains, the bus time and the CPU time
+ *        spent per sample, so that the I2C and SPI transports can be compared on the same motion.
+ */
+
+#ifndef BUS_BENCH_H_
+#define BUS_BENCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/*! @brief The free running clock read around every drain, the DWT cycle counter by default. */
+#ifndef BUS_BENCH_NOW
+#define BUS_BENCH_NOW() (DWT->CYCCNT)
+#define BUS_BENCH_DWT   1
+#endif
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief This structure holds the cost of the drains timed so far. */
+typedef struct
+{
+    uint32_t drains;      /*!< Timed drains. */
+    uint32_t samples;     /*!< Samples moved by the timed drains. */
+    uint64_t busCycles;   /*!< Cycles from the start to the end of the drains, the time the transport held the app. */
+    uint64_t sleepCycles; /*!< Part of busCycles spent asleep in the idle task, free for other work. */
+    uint32_t startTime;   /*!< Clock when the current drain started. */
+    bool active;          /*!< A drain is being timed. */
+} busbench_t;
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+/*! @brief       Clears the counters and starts the clock.
+ *  @param[in]   pBench  benchmark to clear.
+ */
+void BusBench_Reset(busbench_t *pBench);
+
+/*! @brief       Starts timing a drain.
+ *  @param[in]   pBench  benchmark to update.
+ */
+void BusBench_Begin(busbench_t *pBench);
+
+/*! @brief       Ends timing a drain.
+ *  @param[in]   pBench   benchmark to update.
+ *  @param[in]   samples  samples the drain moved.
+ */
+void BusBench_End(busbench_t *pBench, uint32_t samples);
+
+/*! @brief       Accounts time spent asleep while a transfer was on the bus, called from the idle task.
+ *  @details     Only counted while a drain is timed. The interrupt which ends the transfer runs before the idle task
+ *               returns and is counted as asleep, one per transfer with eDMA, so the CPU time is a lower bound.
+ *  @param[in]   pBench  benchmark to update.
+ *  @param[in]   cycles  time asleep, BUS_BENCH_NOW() units.
+ */
+void BusBench_AddSleep(busbench_t *pBench, uint32_t cycles);
+
+/*! @brief       Formats the bus and CPU cost per sample as text.
+ *  @param[in]   pBench     benchmark to print.
+ *  @param[in]   pName      name of the transport.
+ *  @param[in]   clockHz    frequency of BUS_BENCH_NOW(), for the nanoseconds.
+ *  @param[out]  pBuffer    destination of the NUL terminated text.
+ *  @param[in]   size       size of pBuffer, the text is cut to fit.
+ *  @return      length of the text.
+ */
+uint32_t BusBench_Format(const busbench_t *pBench, const char *pName, uint32_t clockHz, char *pBuffer, uint32_t size);
+
+#endif /* BUS_BENCH_H_ */
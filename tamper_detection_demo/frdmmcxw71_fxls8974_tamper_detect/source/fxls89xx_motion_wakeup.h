@@ -20,12 +20,25 @@
 #include "issdk_hal.h"
 #include "gpio_driver.h"
 #include "fxls8974_drv.h"
+#include "sensor_engine.h"
+#include "multi_sensor.h"
+#include "poll_scheduler.h"
+#include "motion_features.h"
+#include "tamper_classifier.h"
+#include "capture_ring.h"
+#include "temp_comp.h"
+#include "bus_bench.h"
+#include "sensor_registry.h"
+#include "tamper_event.h"
+#include "tx_queue.h"
+#include "tamper_beacon.h"
 #include "systick_utils.h"
 
 //-----------------------------------------------------------------------
 // CMSIS Includes
 //-----------------------------------------------------------------------
 #include "Driver_I2C.h"
+#include "Driver_SPI.h"
 #include "fxls89xx_motion_wakeup.h"
 
 //-----------------------------------------------------------------------
@@ -36,6 +49,280 @@
 #define FXLS8974_ACTIVE_MODE    1
 #define BOARD_LED_GPIO          GPIOA
 #define BOARD_LED_GPIO_PIN      20U
+
+/*! @brief Wake the MCU from the WAKE_OUT interrupt on INT1 instead of polling SYS_MODE.
+ *         When enabled, the periodic timer only runs as a slow watchdog poll. */
+#ifndef FXLS8974_WAKE_IRQ_MODE
+#define FXLS8974_WAKE_IRQ_MODE  1
+#endif
+
+/*! @brief Stream the on-chip sample buffer while the sensor is in WAKE mode, draining it in one burst
+ *         every time the watermark interrupt on INT2 fires. */
+#ifndef FXLS8974_FIFO_CAPTURE_MODE
+#define FXLS8974_FIFO_CAPTURE_MODE  0
+#endif
+
+/*! @brief Number of queued samples which raise the buffer watermark interrupt (1..32). */
+#ifndef FXLS8974_FIFO_WATERMARK
+#define FXLS8974_FIFO_WATERMARK     16U
+#endif
+
+/*! @brief Wake ODR set by cFxls8974AwsConfig, the variant found at init must reach it. */
+#define FXLS8974_WAKE_ODR_HZ            400U
+/*! @brief Sample period at the 400Hz Wake ODR, used to time stamp drained samples. */
+#define FXLS8974_WAKE_SAMPLE_PERIOD_US  2500U
+/*! @brief Sample period at the 6.25Hz Sleep ODR, time stamps the samples buffered before the wake. */
+#define FXLS8974_SLEEP_SAMPLE_PERIOD_US 160000U
+
+/*! @brief Keep a ring of the latest acceleration samples and send the samples around each alert to the peers.
+ *         The ring takes CAPTURE_RING_BUDGET(FXLS8974_SNAPSHOT_SAMPLES) bytes of static RAM, reserved at build time.
+ *         The samples buffered at the Sleep ODR before the wake are the pre trigger history. */
+#ifndef FXLS8974_SNAPSHOT_MODE
+#define FXLS8974_SNAPSHOT_MODE     0
+#endif
+
+/*! @brief Ring size in samples (a power of two), and the samples sent before and after the alert. */
+#ifndef FXLS8974_SNAPSHOT_SAMPLES
+#define FXLS8974_SNAPSHOT_SAMPLES  128U
+#endif
+#if (FXLS8974_SNAPSHOT_SAMPLES == 0U) || ((FXLS8974_SNAPSHOT_SAMPLES & (FXLS8974_SNAPSHOT_SAMPLES - 1U)) != 0U)
+#error "FXLS8974_SNAPSHOT_SAMPLES must be a power of two"
+#endif
+#ifndef FXLS8974_SNAPSHOT_PRE
+#define FXLS8974_SNAPSHOT_PRE      32U
+#endif
+#ifndef FXLS8974_SNAPSHOT_POST
+#define FXLS8974_SNAPSHOT_POST     64U
+#endif
+
+#if (FXLS8974_SNAPSHOT_MODE == 1) && (FXLS8974_FIFO_CAPTURE_MODE != 1)
+#error "FXLS8974_SNAPSHOT_MODE records the drained samples, enable FXLS8974_FIFO_CAPTURE_MODE"
+#endif
+
+/*! @brief Hold the motion alert until the first samples of the motion are classified, and only raise it for the
+ *         classes of FXLS8974_CLASSIFY_ALERT_MASK. Works on the drained samples of the FIFO capture. */
+#ifndef FXLS8974_CLASSIFY_MODE
+#define FXLS8974_CLASSIFY_MODE      0
+#endif
+
+#if (FXLS8974_CLASSIFY_MODE == 1) && (FXLS8974_FIFO_CAPTURE_MODE != 1)
+#error "FXLS8974_CLASSIFY_MODE classifies the captured samples, enable FXLS8974_FIFO_CAPTURE_MODE"
+#endif
+
+/*! @brief Samples classified after the wake, 128 samples are 320ms at the 400Hz Wake ODR. */
+#ifndef FXLS8974_CLASSIFY_WINDOW
+#define FXLS8974_CLASSIFY_WINDOW    128U
+#endif
+
+/*! @brief Classes which raise the motion alert, vibration alone is dropped. An unknown class always alerts. */
+#ifndef FXLS8974_CLASSIFY_ALERT_MASK
+#define FXLS8974_CLASSIFY_ALERT_MASK                                                                \
+    (TAMPER_CLASS_MASK(mTamperClass_Unknown_c) | TAMPER_CLASS_MASK(mTamperClass_Tilt_c) |         \
+     TAMPER_CLASS_MASK(mTamperClass_Impact_c) | TAMPER_CLASS_MASK(mTamperClass_Handling_c))
+#endif
+
+/*! @brief Run the orientation engine next to SDCD and let a change of orientation wake the sensor too, so a tilt is
+ *         caught by the sensor alone. The alert tells which source fired. */
+#ifndef FXLS8974_ORIENT_MODE
+#define FXLS8974_ORIENT_MODE        0
+#endif
+
+/*! @brief Samples a new orientation must be held before it is reported, 2 samples are 320ms at the 6.25Hz Sleep ODR. */
+#ifndef FXLS8974_ORIENT_DEBOUNCE
+#define FXLS8974_ORIENT_DEBOUNCE    2U
+#endif
+
+/*! @brief ORIENT_STATUS up to SDCD_INT_SRC2, read in one burst. */
+#define FXLS8974_EVENT_SRC_SIZE     (FXLS8974_SDCD_INT_SRC2 - FXLS8974_ORIENT_STATUS + 1)
+
+/*! @brief Counts of 1g at the 4G full scale, 12-bit data. */
+#define FXLS8974_ONE_G_COUNTS       512
+
+/*! @brief Half width of the SDCD band, counts, +/-100mg. */
+#define FXLS8974_SDCD_THS           0x34
+
+/*! @brief Compare the samples with a fixed reference of 0 instead of the previous sample. The default relative mode
+ *         only sees change, so the offset cancels. The absolute band sees the offset, pick the enabled axes and
+ *         FXLS8974_SDCD_THS so the resting value sits inside it. */
+#ifndef FXLS8974_SDCD_ABSOLUTE_MODE
+#define FXLS8974_SDCD_ABSOLUTE_MODE 0
+#endif
+
+/*! @brief Shift the absolute SDCD band by the per-unit offset error at the TEMP_OUT temperature, read in the same
+ *         burst as INT_STATUS. The coefficients are kept in NVM, the thresholds are only re-programmed once the
+ *         correction has changed by more than FXLS8974_TEMP_COMP_HYS, and only while the sensor sleeps. */
+#ifndef FXLS8974_TEMP_COMP_MODE
+#define FXLS8974_TEMP_COMP_MODE     0
+#endif
+
+#if (FXLS8974_TEMP_COMP_MODE == 1) && (FXLS8974_SDCD_ABSOLUTE_MODE != 1)
+#error "FXLS8974_TEMP_COMP_MODE shifts an absolute band, a shifted relative band is only less sensitive one way, enable FXLS8974_SDCD_ABSOLUTE_MODE"
+#endif
+
+/*! @brief Change of the correction which re-programs the SDCD thresholds, counts. */
+#ifndef FXLS8974_TEMP_COMP_HYS
+#define FXLS8974_TEMP_COMP_HYS      4
+#endif
+
+/*! @brief TEMP_OUT reads 0 at 25 degrees C, 1 degree C per count. */
+#define FXLS8974_TEMP_OUT_OFFSET_C  25
+
+/*! @brief NVM data set of the coefficients, programmed per unit at production (e.g. with the FSCI NV commands). */
+#define FXLS8974_TEMP_COMP_NVM_ID   0x4030
+
+/*! @brief Run the FXLS8974 over LPSPI instead of LPI2C, for a part wired to the SPI of the shield header, the
+ *         on-board one is on I2C. Same register traffic and detection, only the transport changes: the SYS_MODE poll
+ *         is read synchronously and there is no register cache. Set RTE_SPI1_DMA_EN to 1 to move the bursts through
+ *         eDMA. */
+#ifndef FXLS8974_SPI_MODE
+#define FXLS8974_SPI_MODE           0
+#endif
+
+/*! @brief SPI clock of the FXLS8974, Hz. */
+#ifndef FXLS8974_SPI_BAUDRATE
+#define FXLS8974_SPI_BAUDRATE       4000000U
+#endif
+
+/*! @brief GPIO driven as the FXLS8974 SPI chip select. */
+#ifndef FXLS8974_SPI_CS
+#define FXLS8974_SPI_CS             D10
+#endif
+
+/*! @brief Serve the pressure and magnet nodes of the shield header on the FXLS8974 I2C bus as well, an MPL3115 and
+ *         an NMH1000, see multi_sensor.h. The boot probe registers every part which answers its WHO_AM_I with the
+ *         sensor engine, and each poll reads SYS_MODE, the pressure and the field back to back in one bus wakeup.
+ *         The FXLS8974 is on the board and stays required, the others are served when found. */
+#ifndef FXLS8974_MULTI_SENSOR_MODE
+#define FXLS8974_MULTI_SENSOR_MODE  0
+#endif
+
+#if (FXLS8974_MULTI_SENSOR_MODE == 1) && (FXLS8974_SPI_MODE == 1)
+#error "FXLS8974_MULTI_SENSOR_MODE shares the I2C bus with the other sensors, disable FXLS8974_SPI_MODE"
+#endif
+
+#if (FXLS8974_MULTI_SENSOR_MODE == 1) && (FXLS8974_WAKE_IRQ_MODE == 1)
+#error "FXLS8974_MULTI_SENSOR_MODE polls SYS_MODE with the other sensors, disable FXLS8974_WAKE_IRQ_MODE"
+#endif
+
+/*! @brief Slots of the sensor engine, the FXLS8974 is the first. */
+#if (FXLS8974_MULTI_SENSOR_MODE == 1)
+#define FXLS8974_ENGINE_SLOTS       MULTI_SENSOR_SLOTS
+#else
+#define FXLS8974_ENGINE_SLOTS       1U
+#endif
+
+/*! @brief Time every sample buffer drain and report the bus and CPU time per sample on "?bus", to compare the
+ *         transports. */
+#ifndef FXLS8974_BUS_BENCH_MODE
+#define FXLS8974_BUS_BENCH_MODE     0
+#endif
+
+#if (FXLS8974_BUS_BENCH_MODE == 1) && (FXLS8974_FIFO_CAPTURE_MODE != 1)
+#error "FXLS8974_BUS_BENCH_MODE times the sample buffer drains, enable FXLS8974_FIFO_CAPTURE_MODE"
+#endif
+
+/*! @brief Send the alerts as the text banners of a terminal instead of the binary event records, for debugging.
+ *         A text alert takes three 70 byte writes, a binary record one write of 9 to 20 bytes. */
+#ifndef FXLS8974_ASCII_ALERT_MODE
+#define FXLS8974_ASCII_ALERT_MODE   0
+#endif
+
+/*! @brief Batch window of the event records, ms. The records raised within the window go out back to back in one
+ *         write, an alert flushes the batch at once. 0 sends every record on its own. */
+#ifndef FXLS8974_EVENT_BATCH_MS
+#define FXLS8974_EVENT_BATCH_MS      20U
+#endif
+
+/*! @brief Broadcast the latest event record as a tamper beacon, in a non-connectable extended advertising set next
+ *         to the connectable one, so a gateway gets the alerts without connecting. The sensor starts with the
+ *         beacon instead of waiting for a peer. */
+#ifndef FXLS8974_BROADCAST_MODE
+#define FXLS8974_BROADCAST_MODE      0
+#endif
+
+/*! @brief Advertising interval of the beacon during the burst after an event, ms, 20 at least. */
+#ifndef FXLS8974_BROADCAST_FAST_MS
+#define FXLS8974_BROADCAST_FAST_MS   20U
+#endif
+
+/*! @brief Length of the burst after an event, ms. */
+#ifndef FXLS8974_BROADCAST_BURST_MS
+#define FXLS8974_BROADCAST_BURST_MS  3000U
+#endif
+
+/*! @brief Advertising interval of the beacon between the bursts, ms. */
+#ifndef FXLS8974_BROADCAST_SLOW_MS
+#define FXLS8974_BROADCAST_SLOW_MS   2000U
+#endif
+
+/*! @brief AES-128 key of the beacon MIC, shared with the gateways. There is no default, each deployment sets its
+ *         own, e.g. -DFXLS8974_BROADCAST_KEY="{0x..U, ...}" with 16 bytes. */
+#if (FXLS8974_BROADCAST_MODE == 1) && !defined(FXLS8974_BROADCAST_KEY)
+#error "FXLS8974_BROADCAST_MODE needs the key shared with the gateways, define FXLS8974_BROADCAST_KEY"
+#endif
+
+/*! @brief Beacon counter values reserved in NVM at a time. After a reset the counter goes on from the end of the
+ *         reserved values, so a gateway never sees one twice, for one NVM write per window. */
+#ifndef FXLS8974_BROADCAST_COUNTER_WINDOW
+#define FXLS8974_BROADCAST_COUNTER_WINDOW 1024U
+#endif
+
+/*! @brief NVM data set of the beacon counter. */
+#define FXLS8974_BROADCAST_NVM_ID    0x4031
+
+#if (FXLS8974_BROADCAST_MODE == 1) && !(defined(gAppUseNvm_d) && (gAppUseNvm_d > 0))
+#error "FXLS8974_BROADCAST_MODE keeps the beacon counter in NVM, enable gAppUseNvm_d"
+#endif
+
+#if (FXLS8974_BROADCAST_MODE == 1) && (FXLS8974_ASCII_ALERT_MODE == 1)
+#error "FXLS8974_BROADCAST_MODE advertises the binary event records, disable FXLS8974_ASCII_ALERT_MODE"
+#endif
+
+#if (FXLS8974_MULTI_SENSOR_MODE == 1) && (FXLS8974_ASCII_ALERT_MODE == 1)
+#error "FXLS8974_MULTI_SENSOR_MODE reports the pressure and magnet events as binary records, disable FXLS8974_ASCII_ALERT_MODE"
+#endif
+
+/*! @brief Transport of the FXLS8974, the application only uses these names. */
+#if (FXLS8974_SPI_MODE == 1)
+typedef fxls8974_spi_sensorhandle_t fxls8974_sensorhandle_t;
+#define FXLS8974_TRANSPORT_NAME     "SPI"
+#define FXLS8974_BUS_DMA_EN         RTE_SPI1_DMA_EN
+#define FXLS8974_BUS_DMA_BASE       RTE_SPI1_DMA_TX_DMA_BASE
+#define FXLS8974_Configure          FXLS8974_SPI_Configure
+#define FXLS8974_ReadData           FXLS8974_SPI_ReadData
+#define FXLS8974_ReadBuffer         FXLS8974_SPI_ReadBuffer
+#define FXLS8974_SetIdleTask        FXLS8974_SPI_SetIdleTask
+#define FXLS8974_WaitForInterrupt   Register_SPI_WaitForInterrupt
+#define FXLS8974_IsAsyncBusy(p)     (false)
+#else
+typedef fxls8974_i2c_sensorhandle_t fxls8974_sensorhandle_t;
+#define FXLS8974_TRANSPORT_NAME     "I2C"
+#define FXLS8974_BUS_DMA_EN         RTE_I2C1_DMA_EN
+#define FXLS8974_BUS_DMA_BASE       RTE_I2C1_DMA_TX_DMA_BASE
+#define FXLS8974_Configure          FXLS8974_I2C_Configure
+#define FXLS8974_ReadData           FXLS8974_I2C_ReadData
+#define FXLS8974_ReadBuffer         FXLS8974_I2C_ReadBuffer
+#define FXLS8974_SetIdleTask        FXLS8974_I2C_SetIdleTask
+#define FXLS8974_WaitForInterrupt   Register_I2C_WaitForInterrupt
+#define FXLS8974_IsAsyncBusy(p)     Register_I2C_IsAsyncBusy(p)
+#endif
+
+/*! @brief SYS_MODE poll interval bounds and back-off without the INT1 interrupt, see poll_scheduler.h. The interval
+ *         stretches by 1/2^GROW_SHIFT per quiet poll once QUIET_POLLS quiet polls have been seen, and drops back to
+ *         MIN_MS on any activity. */
+#ifndef FXLS8974_POLL_MIN_MS
+#define FXLS8974_POLL_MIN_MS       100U
+#endif
+#ifndef FXLS8974_POLL_MAX_MS
+#define FXLS8974_POLL_MAX_MS       2000U
+#endif
+#ifndef FXLS8974_POLL_GROW_SHIFT
+#define FXLS8974_POLL_GROW_SHIFT   1U
+#endif
+#ifndef FXLS8974_POLL_QUIET_POLLS
+#define FXLS8974_POLL_QUIET_POLLS  50U
+#endif
+
 //-----------------------------------------------------------------------
 // Constants
 //-----------------------------------------------------------------------
@@ -48,15 +335,20 @@ const registerwritelist_t cFxls8974AwsConfig[] = {
     /* Enable SDCD OT for all 3 axes X, Y & Z and within-thresholds event latch disabled. */
     {FXLS8974_SDCD_CONFIG1, FXLS8974_SDCD_CONFIG1_X_OT_EN_EN | FXLS8974_SDCD_CONFIG1_Y_OT_EN_EN | FXLS8974_SDCD_CONFIG1_Z_OT_EN_EN | FXLS8974_SDCD_CONFIG1_OT_ELE_DIS,
     		FXLS8974_SDCD_CONFIG1_X_OT_EN_MASK | FXLS8974_SDCD_CONFIG1_Y_OT_EN_MASK | FXLS8974_SDCD_CONFIG1_Z_OT_EN_MASK | FXLS8974_SDCD_CONFIG1_OT_ELE_MASK},
+#if (FXLS8974_SDCD_ABSOLUTE_MODE == 1)
+    /* Enabling SDCD against a fixed reference of 0, the band is absolute */
+    {FXLS8974_SDCD_CONFIG2, FXLS8974_SDCD_CONFIG2_SDCD_EN_EN | FXLS8974_SDCD_CONFIG2_REF_UPDM_FIXED_VAL, FXLS8974_SDCD_CONFIG2_SDCD_EN_MASK | FXLS8974_SDCD_CONFIG2_REF_UPDM_MASK},
+#else
     /* Enabling SDCD and Relative Data (N) � Data (N-1) mode for transient detection */
     {FXLS8974_SDCD_CONFIG2, FXLS8974_SDCD_CONFIG2_SDCD_EN_EN | FXLS8974_SDCD_CONFIG2_REF_UPDM_SDCD_REF, FXLS8974_SDCD_CONFIG2_SDCD_EN_MASK | FXLS8974_SDCD_CONFIG2_REF_UPDM_MASK},
+#endif
     /* Set the SDCD_OT debounce count to 0 */
     {FXLS8974_SDCD_OT_DBCNT, 0, 0},
     /* Set the SDCD lower and upper thresholds to +/-100mg*/
-    {FXLS8974_SDCD_LTHS_LSB, 0xCC, 0},
-    {FXLS8974_SDCD_LTHS_MSB, 0xFF, 0},
-    {FXLS8974_SDCD_UTHS_LSB, 0x34, 0},
-    {FXLS8974_SDCD_UTHS_MSB, 0x00, 0},
+    {FXLS8974_SDCD_LTHS_LSB, (uint8_t)(-FXLS8974_SDCD_THS), 0},
+    {FXLS8974_SDCD_LTHS_MSB, (uint8_t)((-FXLS8974_SDCD_THS) >> 8), 0},
+    {FXLS8974_SDCD_UTHS_LSB, (uint8_t)FXLS8974_SDCD_THS, 0},
+    {FXLS8974_SDCD_UTHS_MSB, (uint8_t)(FXLS8974_SDCD_THS >> 8), 0},
     /* Enable SDCD outside of thresholds event Auto-WAKE/SLEEP transition source enable. */
     {FXLS8974_SENS_CONFIG4, FXLS8974_SENS_CONFIG4_WK_SDCD_OT_EN | FXLS8974_SENS_CONFIG4_INT_POL_ACT_HIGH, FXLS8974_SENS_CONFIG4_WK_SDCD_OT_MASK | FXLS8974_SENS_CONFIG4_INT_POL_MASK},
     /* Set the ASLP count to 5sec */
@@ -65,8 +357,37 @@ const registerwritelist_t cFxls8974AwsConfig[] = {
     /* Enable Interrupts for WAKE mode. */
     {FXLS8974_INT_EN, FXLS8974_INT_EN_WAKE_OUT_EN_EN, FXLS8974_INT_EN_WAKE_OUT_EN_MASK},
     {FXLS8974_INT_PIN_SEL, FXLS8974_INT_PIN_SEL_WK_OUT_INT2_DIS, FXLS8974_INT_PIN_SEL_WK_OUT_INT2_MASK},
+#if (FXLS8974_FIFO_CAPTURE_MODE == 1)
+    /* Sample buffer in FIFO stream mode with the watermark interrupt routed to INT2. */
+    {FXLS8974_BUF_CONFIG1, FXLS8974_BUF_CONFIG1_BUF_TYPE_FIFO | FXLS8974_BUF_CONFIG1_BUF_MODE_STREAM_MODE, FXLS8974_BUF_CONFIG1_BUF_TYPE_MASK | FXLS8974_BUF_CONFIG1_BUF_MODE_MASK},
+    {FXLS8974_BUF_CONFIG2, FXLS8974_FIFO_WATERMARK, FXLS8974_BUF_CONFIG2_BUF_WMRK_MASK},
+    {FXLS8974_INT_EN, FXLS8974_INT_EN_BUF_EN_EN, FXLS8974_INT_EN_BUF_EN_MASK},
+    {FXLS8974_INT_PIN_SEL, FXLS8974_INT_PIN_SEL_BUF_INT2_EN, FXLS8974_INT_PIN_SEL_BUF_INT2_MASK},
+#endif
     __END_WRITE_DATA__};
 
+#if (FXLS8974_ORIENT_MODE == 1)
+/*! @brief Register settings for the orientation detection, applied on top of cFxls8974AwsConfig. */
+const registerwritelist_t cFxls8974OrientConfig[] = {
+    /* Enable the orientation engine, a broken debounce restarts from 0. */
+    {FXLS8974_ORIENT_CONFIG, FXLS8974_ORIENT_CONFIG_ORIENT_ENABLE_EN | FXLS8974_ORIENT_CONFIG_ORIENT_DBCNTM_CLR,
+    		FXLS8974_ORIENT_CONFIG_ORIENT_ENABLE_MASK | FXLS8974_ORIENT_CONFIG_ORIENT_DBCNTM_MASK},
+    {FXLS8974_ORIENT_DBCOUNT, FXLS8974_ORIENT_DEBOUNCE, 0},
+    /* Back/front trip at 75/105 degrees, no landscape/portrait decision below 28.1 degrees of Z tilt. */
+    {FXLS8974_ORIENT_BF_ZCOMP, FXLS8974_ORIENT_BF_ZCOMP_ORIENT_BKFR_BF_75_285_FB_105_255 | FXLS8974_ORIENT_BF_ZCOMP_ORIENT_ZLOCK_28_1,
+    		FXLS8974_ORIENT_BF_ZCOMP_ORIENT_BKFR_MASK | FXLS8974_ORIENT_BF_ZCOMP_ORIENT_ZLOCK_MASK},
+    /* Landscape/portrait trip at 45 degrees with +/-7 degrees of hysteresis. */
+    {FXLS8974_ORIENT_THS_REG, FXLS8974_ORIENT_THS_REG_ORIENT_THS_45_0 | FXLS8974_ORIENT_THS_REG_HYS_52_38,
+    		FXLS8974_ORIENT_THS_REG_ORIENT_THS_MASK | FXLS8974_ORIENT_THS_REG_HYS_MASK},
+    /* A change of orientation is an Auto-WAKE source next to SDCD, WAKE_OUT on INT1 reports both. */
+    {FXLS8974_SENS_CONFIG4, FXLS8974_SENS_CONFIG4_WK_ORIENT_EN, FXLS8974_SENS_CONFIG4_WK_ORIENT_MASK},
+    __END_WRITE_DATA__};
+
+/*! @brief Read register list to read ORIENT_STATUS, the ORIENT settings and SDCD_INT_SRC1/2 in one burst. */
+const registerreadlist_t cFxls8974ReadEventSrc[] = {{.readFrom = FXLS8974_ORIENT_STATUS, .numBytes = FXLS8974_EVENT_SRC_SIZE},
+                                                   __END_READ_DATA__};
+#endif
+
 /*! @brief Read register list to read SysMode Register. */
 const registerreadlist_t cFxls8974ReadSysMode[] = {{.readFrom = FXLS8974_SYS_MODE, .numBytes = 1}, __END_READ_DATA__};
 
@@ -77,13 +398,89 @@ const registerreadlist_t cFxls8974ReadIntStatus[] = {{.readFrom = FXLS8974_INT_S
 const registerreadlist_t cFxls8974IntEn[] = {{.readFrom = FXLS8974_INT_STATUS, .numBytes = 1},
                                                     __END_READ_DATA__};
 
+#if (FXLS8974_TEMP_COMP_MODE == 1)
+/*! @brief FXLS8974 Interrupt Status and Temperature Registers, in one burst. */
+const registerreadlist_t cFxls8974IntEnTemp[] = {{.readFrom = FXLS8974_INT_STATUS, .numBytes = 2},
+                                                 __END_READ_DATA__};
+#endif
+
+/*! @brief WHO_AM_I values of the FXLS89xx parts served by the FXLS8974 driver, the keys of cFxls89xxVariants in the
+ *         same order. */
+const uint8_t cFxls8974WhoAmI[] = {FXLS8974_WHOAMI_VALUE, FXLS8964_WHOAMI_VALUE, FXLS8967_WHOAMI_VALUE,
+                                   FXLS8968_WHOAMI_VALUE, FXLS8971_WHOAMI_VALUE, FXLS8961_WHOAMI_VALUE,
+                                   FXLS8962_WHOAMI_VALUE};
+
+/*! @brief FXLS89xx parts served by the FXLS8974 driver, one entry per WHO_AM_I value. They share the register map and
+ *         the configuration. The FXLS8971CF and FXLS8961AF have neither the output data buffer nor the orientation
+ *         engine, the FIFO capture and orientation builds refuse them. */
+#define FXLS89XX_CAPS (SENSOR_CAP_BUFFER | SENSOR_CAP_SDCD | SENSOR_CAP_ORIENT | SENSOR_CAP_TEMP)
+#define FXLS89XX_CAPS_NO_BUFFER (SENSOR_CAP_SDCD | SENSOR_CAP_TEMP)
+#define FXLS89XX_RANGES (SENSOR_RANGE_2G | SENSOR_RANGE_4G | SENSOR_RANGE_8G | SENSOR_RANGE_16G)
+const sensorvariant_t cFxls89xxVariants[] = {
+    {&cFxls8974WhoAmI[0], 1U, SENSOR_FAMILY_ACCEL, 8974U, FXLS89XX_CAPS, FXLS8974_BUF_MAX_SAMPLES, FXLS89XX_RANGES, 3200U,
+     "FXLS8974CF", cFxls8974AwsConfig},
+    {&cFxls8974WhoAmI[1], 1U, SENSOR_FAMILY_ACCEL, 8964U, FXLS89XX_CAPS, FXLS8974_BUF_MAX_SAMPLES, FXLS89XX_RANGES, 3200U,
+     "FXLS8964AF", cFxls8974AwsConfig},
+    {&cFxls8974WhoAmI[2], 1U, SENSOR_FAMILY_ACCEL, 8967U, FXLS89XX_CAPS, FXLS8974_BUF_MAX_SAMPLES, FXLS89XX_RANGES, 3200U,
+     "FXLS8967AF", cFxls8974AwsConfig},
+    {&cFxls8974WhoAmI[3], 1U, SENSOR_FAMILY_ACCEL, 8968U, FXLS89XX_CAPS, FXLS8974_BUF_MAX_SAMPLES, FXLS89XX_RANGES, 3200U,
+     "FXLS8968CF", cFxls8974AwsConfig},
+    {&cFxls8974WhoAmI[4], 1U, SENSOR_FAMILY_ACCEL, 8971U, FXLS89XX_CAPS_NO_BUFFER, 0U, FXLS89XX_RANGES, 3200U,
+     "FXLS8971CF", cFxls8974AwsConfig},
+    {&cFxls8974WhoAmI[5], 1U, SENSOR_FAMILY_ACCEL, 8961U, FXLS89XX_CAPS_NO_BUFFER, 0U, FXLS89XX_RANGES, 3200U,
+     "FXLS8961AF", cFxls8974AwsConfig},
+    {&cFxls8974WhoAmI[6], 1U, SENSOR_FAMILY_ACCEL, 8962U, FXLS89XX_CAPS, FXLS8974_BUF_MAX_SAMPLES, FXLS89XX_RANGES, 3200U,
+     "FXLS8962AF", cFxls8974AwsConfig},
+};
+
+/*! @brief Back-off policy of the SYS_MODE poll. */
+const pollschedconfig_t cFxls8974PollConfig = {FXLS8974_POLL_MIN_MS, FXLS8974_POLL_MAX_MS, FXLS8974_POLL_GROW_SHIFT,
+                                               FXLS8974_POLL_QUIET_POLLS};
+
+/*! @brief Decision tree of the motion classifier, thresholds in counts at the 4G full scale.
+ *         A peak beyond 2g is an impact, a lasting change of the gravity vector a tilt. Without either, a motion
+ *         lasting the whole window is handling when smooth and vibration when jerky, a shorter one is vibration. */
+const tampernode_t cFxls8974TamperNodes[] = {
+    /* 0 */ {FXLS8974_ONE_G_COUNTS, mTamperFeature_Shock_c, 1, 2, 0},
+    /* 1 */ {128, mTamperFeature_Tilt_c, 3, 4, 0},
+    /* 2 */ {0, TAMPER_NODE_LEAF, mTamperClass_Impact_c, 0, 0},
+    /* 3 */ {FXLS8974_CLASSIFY_WINDOW - 1, mTamperFeature_Duration_c, 6, 5, 0},
+    /* 4 */ {0, TAMPER_NODE_LEAF, mTamperClass_Tilt_c, 0, 0},
+    /* 5 */ {400, mTamperFeature_Jerk_c, 7, 8, 0},
+    /* 6 */ {0, TAMPER_NODE_LEAF, mTamperClass_Vibration_c, 0, 0},
+    /* 7 */ {0, TAMPER_NODE_LEAF, mTamperClass_Handling_c, 0, 0},
+    /* 8 */ {0, TAMPER_NODE_LEAF, mTamperClass_Vibration_c, 0, 0},
+};
+
+/*! @brief Motion classifier model. */
+const tampermodel_t cFxls8974TamperModel = {cFxls8974TamperNodes,
+                                            sizeof(cFxls8974TamperNodes) / sizeof(cFxls8974TamperNodes[0]),
+                                            FXLS8974_ONE_G_COUNTS};
+
 
 //-----------------------------------------------------------------------
 // Global Variables
 //-----------------------------------------------------------------------
 
+#if (FXLS8974_SPI_MODE == 1)
+    ARM_DRIVER_SPI *SPIdrv = &SPI_S_DRIVER;
+#else
     ARM_DRIVER_I2C *I2Cdrv = &I2C_S_DRIVER;
-    fxls8974_i2c_sensorhandle_t fxls8974Driver;
+    /* Shadow copy of the FXLS8974 registers, saves the read-back of masked writes. */
+    registercache_t fxls8974RegCache;
+    /* Sensors of the shared I2C bus, serviced by the sensor engine. */
+    sensorengine_t fxls8974Engine;
+    sensorengineslot_t fxls8974Slots[FXLS8974_ENGINE_SLOTS];
+#if (FXLS8974_MULTI_SENSOR_MODE == 1)
+    /* Pressure and magnet nodes next to the FXLS8974. */
+    multisensor_t fxls8974Multi;
+#endif
+#endif
+    fxls8974_sensorhandle_t fxls8974Driver;
+    /* Variant found at init, NULL until a known part answered. */
+    const sensorvariant_t *pFxls89xxVariant = NULL;
+    /* WHO_AM_I of the part that answered. */
+    uint8_t fxls89xxWhoAmI = 0U;
     /* Define the init structure for the output LED pin*/
     gpio_pin_config_t led_config = {
         kGPIO_DigitalOutput,
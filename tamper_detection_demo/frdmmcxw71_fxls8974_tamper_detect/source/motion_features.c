@@ -0,0 +1,304 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file motion_features.c
+ * @brief The motion_features.c file implements the fixed-point motion feature kernels.
+ */
+
+#include <stddef.h>
+#include "motion_features.h"
+#if (MOTION_FEATURES_DSP == 1)
+#include "fsl_device_registers.h"
+#endif
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief Running sums of one window, filled by the kernels. */
+typedef struct
+{
+    int32_t sum[MOTION_FEATURES_AXES];    /*!< Sum of the samples of each axis. */
+    int64_t square[MOTION_FEATURES_AXES]; /*!< Sum of the squared samples of each axis. */
+    int16_t min[MOTION_FEATURES_AXES];    /*!< Smallest sample of each axis. */
+    int16_t max[MOTION_FEATURES_AXES];    /*!< Largest sample of each axis. */
+    uint64_t jerk;                        /*!< Sum of the squared sample to sample changes. */
+    uint32_t magnitude;                   /*!< Largest squared vector magnitude. */
+} motionaccum_t;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/* Track the smallest and largest sample of each axis. */
+static void MotionFeatures_Range(motionaccum_t *pAccum, const int16_t *pAccel)
+{
+    uint8_t axis;
+
+    for (axis = 0U; axis < MOTION_FEATURES_AXES; axis++)
+    {
+        if (pAccel[axis] < pAccum->min[axis])
+        {
+            pAccum->min[axis] = pAccel[axis];
+        }
+        if (pAccel[axis] > pAccum->max[axis])
+        {
+            pAccum->max[axis] = pAccel[axis];
+        }
+    }
+}
+
+#if (MOTION_FEATURES_DSP == 1)
+/* Two 16-bit lanes in one word, a in the low half. */
+static inline uint32_t MotionFeatures_Pack(int16_t a, int16_t b)
+{
+    return (uint32_t)(uint16_t)a | ((uint32_t)(uint16_t)b << 16);
+}
+
+/* Packed kernel: the axis sums and squares take two samples per SMLAD/SMLALD, the changes are saturated two lanes
+ * at a time by QSUB16 and squared by SMLALD, the squared magnitude is one SMUAD and one SMLAD. */
+static void MotionFeatures_Accumulate(const fxls8974_acceldata_t *pSamples, uint8_t numSamples, motionaccum_t *pAccum)
+{
+    const uint32_t ones = 0x00010001UL;
+    const int16_t *pAccel;
+    const int16_t *pPrevious = pSamples[0].accel;
+    uint32_t sum[MOTION_FEATURES_AXES] = {0U, 0U, 0U};
+    uint64_t square[MOTION_FEATURES_AXES] = {0U, 0U, 0U};
+    uint64_t jerk = 0U;
+    uint32_t xy;
+    uint32_t z;
+    uint32_t lanes;
+    uint32_t magnitude;
+    uint8_t axis;
+    uint8_t i;
+
+    for (i = 0U; i < numSamples; i++)
+    {
+        pAccel = pSamples[i].accel;
+        xy = MotionFeatures_Pack(pAccel[0], pAccel[1]);
+        z = MotionFeatures_Pack(pAccel[2], 0);
+
+        /* x^2 + y^2 + z^2 stays below 2^32, the wrap of the signed result is harmless. */
+        magnitude = __SMLAD(z, z, __SMUAD(xy, xy));
+        if (magnitude > pAccum->magnitude)
+        {
+            pAccum->magnitude = magnitude;
+        }
+
+        if (i != 0U)
+        {
+            lanes = __QSUB16(xy, MotionFeatures_Pack(pPrevious[0], pPrevious[1]));
+            jerk = __SMLALD(lanes, lanes, jerk);
+            lanes = __QSUB16(z, MotionFeatures_Pack(pPrevious[2], 0));
+            jerk = __SMLALD(lanes, lanes, jerk);
+        }
+
+        /* Every second sample pairs up with the previous one, lane 0 the older. */
+        if ((i & 1U) != 0U)
+        {
+            for (axis = 0U; axis < MOTION_FEATURES_AXES; axis++)
+            {
+                lanes = MotionFeatures_Pack(pPrevious[axis], pAccel[axis]);
+                sum[axis] = __SMLAD(lanes, ones, sum[axis]);
+                square[axis] = __SMLALD(lanes, lanes, square[axis]);
+            }
+        }
+
+        MotionFeatures_Range(pAccum, pAccel);
+        pPrevious = pAccel;
+    }
+
+    /* An odd sample out has no partner. */
+    if ((numSamples & 1U) != 0U)
+    {
+        for (axis = 0U; axis < MOTION_FEATURES_AXES; axis++)
+        {
+            lanes = MotionFeatures_Pack(pPrevious[axis], 0);
+            sum[axis] = __SMLAD(lanes, ones, sum[axis]);
+            square[axis] = __SMLALD(lanes, lanes, square[axis]);
+        }
+    }
+
+    for (axis = 0U; axis < MOTION_FEATURES_AXES; axis++)
+    {
+        pAccum->sum[axis] = (int32_t)sum[axis];
+        pAccum->square[axis] = (int64_t)square[axis];
+    }
+    pAccum->jerk = jerk;
+}
+#else
+/* Saturate to the 16-bit lane of QSUB16. */
+static int32_t MotionFeatures_Saturate(int32_t value)
+{
+    if (value > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+    return value;
+}
+
+/* Portable kernel, same integer results as the packed one. */
+static void MotionFeatures_Accumulate(const fxls8974_acceldata_t *pSamples, uint8_t numSamples, motionaccum_t *pAccum)
+{
+    const int16_t *pAccel;
+    const int16_t *pPrevious = pSamples[0].accel;
+    int32_t delta;
+    uint32_t magnitude;
+    uint8_t axis;
+    uint8_t i;
+
+    for (i = 0U; i < numSamples; i++)
+    {
+        pAccel = pSamples[i].accel;
+        magnitude = 0U;
+
+        for (axis = 0U; axis < MOTION_FEATURES_AXES; axis++)
+        {
+            pAccum->sum[axis] += pAccel[axis];
+            pAccum->square[axis] += (int32_t)pAccel[axis] * pAccel[axis];
+            magnitude += (uint32_t)((int32_t)pAccel[axis] * pAccel[axis]);
+
+            if (i != 0U)
+            {
+                delta = MotionFeatures_Saturate((int32_t)pAccel[axis] - pPrevious[axis]);
+                pAccum->jerk += (uint32_t)(delta * delta);
+            }
+        }
+
+        if (magnitude > pAccum->magnitude)
+        {
+            pAccum->magnitude = magnitude;
+        }
+
+        MotionFeatures_Range(pAccum, pAccel);
+        pPrevious = pAccel;
+    }
+}
+#endif /* MOTION_FEATURES_DSP */
+
+/* Integer square root, rounded down. */
+static uint32_t MotionFeatures_Sqrt(uint32_t value)
+{
+    uint32_t root = 0U;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0U)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return root;
+}
+
+void MotionFeatures_Compute(const fxls8974_acceldata_t *pSamples, uint8_t numSamples, motionfeatures_t *pFeatures)
+{
+    motionaccum_t accum = {0};
+    int64_t count = numSamples;
+    int32_t half = numSamples / 2;
+    uint8_t axis;
+
+    *pFeatures = (motionfeatures_t){0};
+    if ((pSamples == NULL) || (numSamples == 0U))
+    {
+        return;
+    }
+
+    for (axis = 0U; axis < MOTION_FEATURES_AXES; axis++)
+    {
+        accum.min[axis] = INT16_MAX;
+        accum.max[axis] = INT16_MIN;
+    }
+
+    MotionFeatures_Accumulate(pSamples, numSamples, &accum);
+
+    for (axis = 0U; axis < MOTION_FEATURES_AXES; axis++)
+    {
+        /*! Round half away from zero. */
+        pFeatures->mean[axis] = (int16_t)((accum.sum[axis] >= 0) ? ((accum.sum[axis] + half) / numSamples) :
+                                                                    -((half - accum.sum[axis]) / numSamples));
+        /*! var = (n * sum(x^2) - sum(x)^2) / n^2, exact in 64 bits for up to 255 samples. */
+        pFeatures->variance[axis] = (uint32_t)((count * accum.square[axis] - (int64_t)accum.sum[axis] * accum.sum[axis]) /
+                                               (count * count));
+        pFeatures->peakToPeak[axis] = (uint16_t)((int32_t)accum.max[axis] - accum.min[axis]);
+    }
+    pFeatures->jerkEnergy = accum.jerk;
+    pFeatures->magnitude = (uint16_t)MotionFeatures_Sqrt(accum.magnitude);
+    pFeatures->numSamples = numSamples;
+}
+
+/* Append a label and the decimal text of a number, returns the new length. */
+static uint32_t MotionFeatures_Print(char *pBuffer, uint32_t size, uint32_t length, const char *pLabel, int64_t value)
+{
+    char digits[20];
+    uint64_t magnitude = (value < 0) ? (uint64_t)(-value) : (uint64_t)value;
+    uint8_t count = 0U;
+
+    for (; (*pLabel != '\0') && (length + 1U < size); pLabel++)
+    {
+        pBuffer[length++] = *pLabel;
+    }
+    if ((value < 0) && (length + 1U < size))
+    {
+        pBuffer[length++] = '-';
+    }
+    do
+    {
+        digits[count++] = (char)('0' + (magnitude % 10U));
+        magnitude /= 10U;
+    } while (magnitude != 0U);
+    while ((count != 0U) && (length + 1U < size))
+    {
+        pBuffer[length++] = digits[--count];
+    }
+    pBuffer[length] = '\0';
+
+    return length;
+}
+
+uint32_t MotionFeatures_Format(const motionfeatures_t *pFeatures, char *pBuffer, uint32_t size)
+{
+    uint32_t length = 0U;
+    uint8_t axis;
+
+    if ((pBuffer == NULL) || (size == 0U))
+    {
+        return 0U;
+    }
+
+    length = MotionFeatures_Print(pBuffer, size, length, "\r\nMotion n ", pFeatures->numSamples);
+    for (axis = 0U; axis < MOTION_FEATURES_AXES; axis++)
+    {
+        length = MotionFeatures_Print(pBuffer, size, length, (axis == 0U) ? " avg " : ",", pFeatures->mean[axis]);
+    }
+    for (axis = 0U; axis < MOTION_FEATURES_AXES; axis++)
+    {
+        length = MotionFeatures_Print(pBuffer, size, length, (axis == 0U) ? " var " : ",", pFeatures->variance[axis]);
+    }
+    for (axis = 0U; axis < MOTION_FEATURES_AXES; axis++)
+    {
+        length = MotionFeatures_Print(pBuffer, size, length, (axis == 0U) ? " p2p " : ",", pFeatures->peakToPeak[axis]);
+    }
+    length = MotionFeatures_Print(pBuffer, size, length, " jerk ", (int64_t)pFeatures->jerkEnergy);
+    length = MotionFeatures_Print(pBuffer, size, length, " mag ", pFeatures->magnitude);
+
+    return length;
+}
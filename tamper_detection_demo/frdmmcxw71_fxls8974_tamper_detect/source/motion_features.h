@@ -0,0 +1,68 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file motion_features.h
+ * @brief The motion_features.h file declares fixed-point feature kernels run over a window of FXLS8974 samples:
+ *        per axis mean, variance and peak-to-peak, jerk energy and peak vector magnitude.
+ */
+
+#ifndef MOTION_FEATURES_H_
+#define MOTION_FEATURES_H_
+
+#include <stdint.h>
+#include "fxls8974_drv.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/*! @brief Use the packed 16-bit multiply-accumulate instructions of the DSP extension. The portable C kernels give
+ *         bit-identical results and are used on cores without it. */
+#ifndef MOTION_FEATURES_DSP
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define MOTION_FEATURES_DSP 1
+#else
+#define MOTION_FEATURES_DSP 0
+#endif
+#endif
+
+/*! @brief Number of axes of a sample. */
+#define MOTION_FEATURES_AXES (3U)
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief This structure holds the features of one window of samples, all in raw sensor counts. */
+typedef struct
+{
+    int16_t mean[MOTION_FEATURES_AXES];        /*!< Mean of each axis, rounded to the nearest count. */
+    uint32_t variance[MOTION_FEATURES_AXES];   /*!< Population variance of each axis, counts^2, truncated. */
+    uint16_t peakToPeak[MOTION_FEATURES_AXES]; /*!< Largest minus smallest sample of each axis. */
+    uint64_t jerkEnergy;  /*!< Sum over the window of the squared sample to sample change, all axes. */
+    uint16_t magnitude;   /*!< Largest vector magnitude of a sample, rounded down. */
+    uint8_t numSamples;   /*!< Samples the features were computed over. */
+} motionfeatures_t;
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+/*! @brief       Computes the features of a window of samples.
+ *  @details     Integer math only, one pass over the samples. Sample to sample changes saturate to 16 bits.
+ *  @param[in]   pSamples    samples, oldest first.
+ *  @param[in]   numSamples  number of samples, 0 clears the features.
+ *  @param[out]  pFeatures   features of the window.
+ */
+void MotionFeatures_Compute(const fxls8974_acceldata_t *pSamples, uint8_t numSamples, motionfeatures_t *pFeatures);
+
+/*! @brief       Formats the features as one line of text.
+ *  @param[in]   pFeatures  features to print.
+ *  @param[out]  pBuffer    text buffer, always NUL terminated.
+ *  @param[in]   size       size of pBuffer.
+ *  @return      length of the text, without the NUL.
+ */
+uint32_t MotionFeatures_Format(const motionfeatures_t *pFeatures, char *pBuffer, uint32_t size);
+
+#endif /* MOTION_FEATURES_H_ */
@@ -0,0 +1,217 @@
+/*
+ * Copyright 2025 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file multi_sensor.c
+ * @brief The multi_sensor.c file implements the MPL3115 and NMH1000 drivers of the sensor engine for the combined
+ *        application: probe, configuration, the polled output registers and the baseline comparison.
+ */
+
+#include "sensor_drv.h"
+#include "mpl3115.h"
+#include "nmh1000.h"
+#include "multi_sensor.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/*! @brief Bytes of the OUT_P pressure, the temperature is not needed. */
+#define MULTI_SENSOR_PRESSURE_SIZE (3U)
+
+/*! @brief Bytes of the OUT_M field. */
+#define MULTI_SENSOR_MAG_SIZE      (1U)
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+static int32_t MultiSensor_PressureInit(sensorengineslot_t *pSlot);
+static int32_t MultiSensor_PressureConfigure(sensorengineslot_t *pSlot);
+static void MultiSensor_PressureDecode(sensorengineslot_t *pSlot);
+static int32_t MultiSensor_MagInit(sensorengineslot_t *pSlot);
+static int32_t MultiSensor_MagConfigure(sensorengineslot_t *pSlot);
+static void MultiSensor_MagDecode(sensorengineslot_t *pSlot);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+/*! @brief MPL3115 in barometer mode, converting on its own once active, the poll reads the latest sample. */
+static const registerwritelist_t cMultiSensorPressureConfig[] = {
+    {MPL3115_CTRL_REG1, MPL3115_CTRL_REG1_OS_OSR_128 | MPL3115_CTRL_REG1_ALT_BAR,
+     MPL3115_CTRL_REG1_OS_MASK | MPL3115_CTRL_REG1_ALT_MASK},
+    __END_WRITE_DATA__};
+
+/*! @brief NMH1000 converting on its own, the poll reads the latest sample. */
+static const registerwritelist_t cMultiSensorMagConfig[] = {
+    {NMH1000_ODR, NMH1000_USER_ODR_ODR_10X_HSP, NMH1000_USER_ODR_ODR_MASK},
+    {NMH1000_CONTROL_REG1, NMH1000_CONTROL_REG1_AUTO_MODE_START, NMH1000_CONTROL_REG1_AUTO_MODE_MASK},
+    __END_WRITE_DATA__};
+
+static const registerreadlist_t cMultiSensorPressurePoll[] = {
+    {.readFrom = MPL3115_OUT_P_MSB, .numBytes = MULTI_SENSOR_PRESSURE_SIZE}, __END_READ_DATA__};
+
+static const registerreadlist_t cMultiSensorMagPoll[] = {
+    {.readFrom = NMH1000_OUT_M_REG, .numBytes = MULTI_SENSOR_MAG_SIZE}, __END_READ_DATA__};
+
+static const uint8_t cMultiSensorPressureWhoAmI[] = {MPL3115_WHOAMI_VALUE, FXPQ3115_WHOAMI_VALUE};
+static const uint8_t cMultiSensorMagWhoAmI[] = {NMH1000_WHO_AM_I_VALUE};
+
+/*! @brief Parts served next to the FXLS8974, the entries of the MPL3115 and NMH1000 applications. */
+static const sensorvariant_t cMultiSensorPressureVariants[] = {
+    {cMultiSensorPressureWhoAmI, sizeof(cMultiSensorPressureWhoAmI), SENSOR_FAMILY_PRESSURE, 3115U,
+     SENSOR_CAP_BUFFER | SENSOR_CAP_TEMP | SENSOR_CAP_ALTIMETER | SENSOR_CAP_WINDOW, MPL3115_FIFO_MAX_SAMPLES, 0U, 1U,
+     "MPL3115/FXPQ3115", cMultiSensorPressureConfig},
+};
+
+static const sensorvariant_t cMultiSensorMagVariants[] = {
+    {cMultiSensorMagWhoAmI, sizeof(cMultiSensorMagWhoAmI), SENSOR_FAMILY_MAG, 1000U, SENSOR_CAP_WINDOW, 0U, 0U, 0U,
+     "NMH1000", cMultiSensorMagConfig},
+};
+
+static const sensorengineops_t cMultiSensorPressureOps = {
+    .slaveAddress = MPL3115_I2C_ADDRESS,
+    .whoAmIReg = MPL3115_WHO_AM_I,
+    .pWhoAmIValues = cMultiSensorPressureWhoAmI,
+    .numWhoAmIValues = sizeof(cMultiSensorPressureWhoAmI),
+    .init = MultiSensor_PressureInit,
+    .configure = MultiSensor_PressureConfigure,
+    .pPollList = cMultiSensorPressurePoll,
+    .decode = MultiSensor_PressureDecode,
+};
+
+static const sensorengineops_t cMultiSensorMagOps = {
+    .slaveAddress = MULTI_SENSOR_NMH1000_ADDRESS,
+    .whoAmIReg = NMH1000_WHO_AM_I,
+    .pWhoAmIValues = cMultiSensorMagWhoAmI,
+    .numWhoAmIValues = sizeof(cMultiSensorMagWhoAmI),
+    .init = MultiSensor_MagInit,
+    .configure = MultiSensor_MagConfigure,
+    .pPollList = cMultiSensorMagPoll,
+    .decode = MultiSensor_MagDecode,
+};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/*! Compares a sample with the baseline, reports a change of side and only learns the quiet samples. */
+static void MultiSensor_Compare(const sensorengineslot_t *pSlot, int32_t sample, uint32_t threshold)
+{
+    multisensornode_t *pNode = (multisensornode_t *)pSlot->pHandle;
+    bool alert = Baseline_IsEvent(&pNode->baseline, sample, threshold);
+
+    pNode->sample = sample;
+    if (!alert)
+    {
+        Baseline_Update(&pNode->baseline, sample);
+    }
+    if ((alert != pNode->alert) && (pNode->event != NULL))
+    {
+        pNode->event(pSlot, alert, sample, Baseline_Mean(&pNode->baseline));
+    }
+    pNode->alert = alert;
+}
+
+static int32_t MultiSensor_PressureInit(sensorengineslot_t *pSlot)
+{
+    int32_t status;
+    uint8_t whoami;
+    multisensornode_t *pNode = (multisensornode_t *)pSlot->pHandle;
+
+    pNode->pVariant = SensorRegistry_Find(cMultiSensorPressureVariants,
+                                          SENSOR_REGISTRY_COUNT(cMultiSensorPressureVariants), pSlot->whoAmI);
+    status = MPL3115_I2C_Initialize(&pNode->driver.mpl3115, pSlot->pEngine->pBus, pSlot->pEngine->deviceInstance,
+                                    pSlot->pOps->slaveAddress, &whoami);
+    if (SENSOR_ERROR_NONE != status)
+    {
+        return status;
+    }
+    Register_I2C_AttachCache(&pNode->driver.mpl3115.deviceInfo, &pNode->cache);
+    pSlot->pDevInfo = &pNode->driver.mpl3115.deviceInfo;
+
+    return SENSOR_ERROR_NONE;
+}
+
+static int32_t MultiSensor_PressureConfigure(sensorengineslot_t *pSlot)
+{
+    multisensornode_t *pNode = (multisensornode_t *)pSlot->pHandle;
+
+    return MPL3115_I2C_Configure(&pNode->driver.mpl3115, pNode->pVariant->pConfig);
+}
+
+static void MultiSensor_PressureDecode(sensorengineslot_t *pSlot)
+{
+    uint32_t raw;
+
+    if (ARM_DRIVER_OK != pSlot->status)
+    {
+        return;
+    }
+
+    /*! OUT_P holds the pressure in Q18.2 Pa in its upper 20 bits. */
+    raw = ((uint32_t)pSlot->pollData[0] << 16) | ((uint32_t)pSlot->pollData[1] << 8) | pSlot->pollData[2];
+    MultiSensor_Compare(pSlot, (int32_t)(raw / MPL3115_PRESSURE_CONV_FACTOR), MULTI_SENSOR_PRESSURE_THS);
+}
+
+static int32_t MultiSensor_MagInit(sensorengineslot_t *pSlot)
+{
+    int32_t status;
+    multisensornode_t *pNode = (multisensornode_t *)pSlot->pHandle;
+
+    pNode->pVariant =
+        SensorRegistry_Find(cMultiSensorMagVariants, SENSOR_REGISTRY_COUNT(cMultiSensorMagVariants), pSlot->whoAmI);
+    status = NMH1000_I2C_Initialize(&pNode->driver.nmh1000, pSlot->pEngine->pBus, pSlot->pEngine->deviceInstance,
+                                    pSlot->pOps->slaveAddress, pSlot->whoAmI);
+    if (SENSOR_ERROR_NONE != status)
+    {
+        return status;
+    }
+    Register_I2C_AttachCache(&pNode->driver.nmh1000.deviceInfo, &pNode->cache);
+    pSlot->pDevInfo = &pNode->driver.nmh1000.deviceInfo;
+
+    return SENSOR_ERROR_NONE;
+}
+
+static int32_t MultiSensor_MagConfigure(sensorengineslot_t *pSlot)
+{
+    multisensornode_t *pNode = (multisensornode_t *)pSlot->pHandle;
+
+    return NMH1000_I2C_Configure(&pNode->driver.nmh1000, pNode->pVariant->pConfig);
+}
+
+static void MultiSensor_MagDecode(sensorengineslot_t *pSlot)
+{
+    if (ARM_DRIVER_OK != pSlot->status)
+    {
+        return;
+    }
+
+    MultiSensor_Compare(pSlot, pSlot->pollData[0], MULTI_SENSOR_MAG_THS);
+}
+
+static void MultiSensor_NodeInit(multisensornode_t *pNode, uint8_t shift, uint8_t gate, multisensorevent_t event)
+{
+    Baseline_Init(&pNode->baseline, shift, gate);
+    pNode->pVariant = NULL;
+    pNode->event = event;
+    pNode->sample = 0;
+    pNode->alert = false;
+}
+
+void MultiSensor_Init(multisensor_t *pMulti, sensorengineslot_t *pSlots, multisensorevent_t event)
+{
+    MultiSensor_NodeInit(&pMulti->pressure, MULTI_SENSOR_PRESSURE_SHIFT, MULTI_SENSOR_PRESSURE_GATE, event);
+    pSlots[MULTI_SENSOR_SLOT_PRESSURE].pOps = &cMultiSensorPressureOps;
+    pSlots[MULTI_SENSOR_SLOT_PRESSURE].pHandle = &pMulti->pressure;
+
+    MultiSensor_NodeInit(&pMulti->magnet, MULTI_SENSOR_MAG_SHIFT, MULTI_SENSOR_MAG_GATE, event);
+    pSlots[MULTI_SENSOR_SLOT_MAG].pOps = &cMultiSensorMagOps;
+    pSlots[MULTI_SENSOR_SLOT_MAG].pHandle = &pMulti->magnet;
+}
+
+const sensorvariant_t *MultiSensor_Variant(const sensorengineslot_t *pSlot)
+{
+    return pSlot->present ? ((const multisensornode_t *)pSlot->pHandle)->pVariant : NULL;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2025 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file multi_sensor.h
+ * @brief The multi_sensor.h file declares the MPL3115 and NMH1000 drivers of the sensor engine for the combined
+ *        application, FXLS8974_MULTI_SENSOR_MODE. The pressure and magnet nodes sit on the I2C bus of the on-board
+ *        FXLS8974, the boot probe registers the ones that answer and every poll of the engine reads them back to back
+ *        with the FXLS8974 SYS_MODE. Each sample is compared with a tracked baseline, crossing the threshold either
+ *        way is reported to the application.
+ */
+
+#ifndef MULTI_SENSOR_H_
+#define MULTI_SENSOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "register_io_i2c.h"
+#include "mpl3115_drv.h"
+#include "nmh1000_drv.h"
+#include "sensor_engine.h"
+#include "sensor_registry.h"
+#include "baseline_tracker.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/*! @brief Slots of the combined engine, the FXLS8974 is set up by the application. */
+#define MULTI_SENSOR_SLOT_MOTION    (0U)
+#define MULTI_SENSOR_SLOT_PRESSURE  (1U)
+#define MULTI_SENSOR_SLOT_MAG       (2U)
+#define MULTI_SENSOR_SLOTS          (3U)
+
+/*! @brief I2C address of the NMH1000. The click board answers at NMH1000_I2C_ADDR_VAL, 0x60, the address of the
+ *         MPL3115, so on the shared bus the part has to be programmed to another one through its I2C_ADDR
+ *         register first. */
+#ifndef MULTI_SENSOR_NMH1000_ADDRESS
+#define MULTI_SENSOR_NMH1000_ADDRESS (0x61U)
+#endif
+
+#if (MULTI_SENSOR_NMH1000_ADDRESS == MPL3115_I2C_ADDRESS)
+#error "The NMH1000 and the MPL3115 cannot share an address, set MULTI_SENSOR_NMH1000_ADDRESS"
+#endif
+
+/*! @brief Pressure change which raises an event, Pa, as PRESSURE_THS of the MPL3115 application. */
+#ifndef MULTI_SENSOR_PRESSURE_THS
+#define MULTI_SENSOR_PRESSURE_THS   (60U)
+#endif
+
+/*! @brief Pressure baseline time constant, 2^SHIFT polls, and gate in standard deviations. */
+#define MULTI_SENSOR_PRESSURE_SHIFT (6U)
+#define MULTI_SENSOR_PRESSURE_GATE  (4U)
+
+/*! @brief Field change which raises an event, OUT_M counts, as THRESHOLD of the NMH1000 application. */
+#ifndef MULTI_SENSOR_MAG_THS
+#define MULTI_SENSOR_MAG_THS        (50U)
+#endif
+
+/*! @brief Field baseline time constant, 2^SHIFT polls, and gate in standard deviations. */
+#define MULTI_SENSOR_MAG_SHIFT      (8U)
+#define MULTI_SENSOR_MAG_GATE       (4U)
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*!
+ * @brief This is the event callback type.
+ *        It is called from SensorEngine_Decode() when a sample leaves the baseline band or comes back into it.
+ */
+typedef void (*multisensorevent_t)(const sensorengineslot_t *pSlot, bool alert, int32_t sample, int32_t reference);
+
+/*! @brief This structure holds one pressure or magnet node, the engine slot handle points to it. */
+typedef struct
+{
+    union
+    {
+        mpl3115_i2c_sensorhandle_t mpl3115;
+        nmh1000_i2c_sensorhandle_t nmh1000;
+    } driver;                           /*!< Driver handle of the part. */
+    registercache_t cache;              /*!< Shadow copy of the registers. */
+    baselinetracker_t baseline;         /*!< Reference the samples are compared with. */
+    const sensorvariant_t *pVariant;    /*!< Variant found by the probe, NULL until the part answered. */
+    multisensorevent_t event;           /*!< Event callback of the application. */
+    int32_t sample;                     /*!< Last sample, Pa or OUT_M counts. */
+    bool alert;                         /*!< The last sample was outside the band. */
+} multisensornode_t;
+
+/*! @brief This structure holds the nodes served next to the FXLS8974. */
+typedef struct
+{
+    multisensornode_t pressure; /*!< MPL3115 or FXPQ3115. */
+    multisensornode_t magnet;   /*!< NMH1000. */
+} multisensor_t;
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+/*! @brief       Sets up the pressure and magnet slots of a combined engine.
+ *  @details     Call before SensorEngine_Init(), the MULTI_SENSOR_SLOT_MOTION slot is left to the caller.
+ *  @param[in]   pMulti   nodes to initialize.
+ *  @param[in]   pSlots   MULTI_SENSOR_SLOTS engine slots.
+ *  @param[in]   event    called on every event, may be NULL.
+ */
+void MultiSensor_Init(multisensor_t *pMulti, sensorengineslot_t *pSlots, multisensorevent_t event);
+
+/*! @brief       Returns the variant of a pressure or magnet slot.
+ *  @param[in]   pSlot   engine slot set up by MultiSensor_Init().
+ *  @return      the variant, NULL if the part did not answer the probe.
+ */
+const sensorvariant_t *MultiSensor_Variant(const sensorengineslot_t *pSlot);
+
+#endif /* MULTI_SENSOR_H_ */
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file tamper_classifier.c
+ * @brief The tamper_classifier.c file implements the decision tree tamper classifier.
+ */
+
+#include <stddef.h>
+#include "tamper_classifier.h"
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static const char *const s_className[mTamperClass_Count_c] = {"unknown", "vibration", "tilt", "impact", "handling"};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/* Clamp an unsigned quantity to the signed feature range. */
+static int32_t TamperClassifier_Clamp(uint64_t value)
+{
+    return (value > (uint64_t)INT32_MAX) ? INT32_MAX : (int32_t)value;
+}
+
+void TamperClassifier_WindowInit(tamperwindow_t *pWindow)
+{
+    *pWindow = (tamperwindow_t){0};
+}
+
+void TamperClassifier_WindowAdd(tamperwindow_t *pWindow, const motionfeatures_t *pFeatures)
+{
+    uint32_t variance = 0U;
+    uint8_t axis;
+
+    if (pFeatures->numSamples == 0U)
+    {
+        return;
+    }
+
+    for (axis = 0U; axis < MOTION_FEATURES_AXES; axis++)
+    {
+        if (pWindow->numSamples == 0U)
+        {
+            pWindow->firstMean[axis] = pFeatures->mean[axis];
+        }
+        pWindow->lastMean[axis] = pFeatures->mean[axis];
+
+        if (pFeatures->peakToPeak[axis] > pWindow->peakToPeak)
+        {
+            pWindow->peakToPeak = pFeatures->peakToPeak[axis];
+        }
+        variance = (variance > (UINT32_MAX - pFeatures->variance[axis])) ? UINT32_MAX :
+                                                                            (variance + pFeatures->variance[axis]);
+    }
+
+    if (variance > pWindow->variance)
+    {
+        pWindow->variance = variance;
+    }
+    if (pFeatures->magnitude > pWindow->magnitude)
+    {
+        pWindow->magnitude = pFeatures->magnitude;
+    }
+    pWindow->jerk += pFeatures->jerkEnergy;
+    pWindow->numSamples += pFeatures->numSamples;
+}
+
+void TamperClassifier_Features(const tampermodel_t *pModel, const tamperwindow_t *pWindow, int32_t *pVector)
+{
+    int32_t tilt = 0;
+    int32_t shock;
+    uint8_t axis;
+
+    for (axis = 0U; axis < MOTION_FEATURES_AXES; axis++)
+    {
+        tilt += (pWindow->lastMean[axis] >= pWindow->firstMean[axis]) ?
+                    (pWindow->lastMean[axis] - pWindow->firstMean[axis]) :
+                    (pWindow->firstMean[axis] - pWindow->lastMean[axis]);
+    }
+    shock = (int32_t)pWindow->magnitude - pModel->oneG;
+
+    pVector[mTamperFeature_PeakToPeak_c] = (int32_t)pWindow->peakToPeak;
+    pVector[mTamperFeature_Variance_c] = TamperClassifier_Clamp(pWindow->variance);
+    pVector[mTamperFeature_Jerk_c] =
+        TamperClassifier_Clamp((pWindow->numSamples != 0U) ? (pWindow->jerk / pWindow->numSamples) : 0U);
+    pVector[mTamperFeature_Shock_c] = (shock >= 0) ? shock : -shock;
+    pVector[mTamperFeature_Tilt_c] = tilt;
+    pVector[mTamperFeature_Duration_c] = (int32_t)pWindow->numSamples;
+}
+
+tamperClass_t TamperClassifier_Run(const tampermodel_t *pModel, const int32_t *pVector)
+{
+    const tampernode_t *pNode;
+    uint8_t index = 0U;
+    uint8_t next;
+    uint8_t depth;
+
+    if ((pModel == NULL) || (pModel->pNodes == NULL) || (pModel->numNodes == 0U))
+    {
+        return mTamperClass_Unknown_c;
+    }
+
+    for (depth = 0U; depth < TAMPER_CLASSIFIER_MAX_DEPTH; depth++)
+    {
+        pNode = &pModel->pNodes[index];
+        if (pNode->feature == TAMPER_NODE_LEAF)
+        {
+            return (pNode->left < (uint8_t)mTamperClass_Count_c) ? (tamperClass_t)pNode->left : mTamperClass_Unknown_c;
+        }
+        if (pNode->feature >= (uint8_t)mTamperFeature_Count_c)
+        {
+            break;
+        }
+
+        next = (pVector[pNode->feature] <= pNode->threshold) ? pNode->left : pNode->right;
+        /*! Children must follow their parent, which also rules out loops. */
+        if ((next <= index) || (next >= pModel->numNodes))
+        {
+            break;
+        }
+        index = next;
+    }
+
+    return mTamperClass_Unknown_c;
+}
+
+const char *TamperClassifier_Name(tamperClass_t cls)
+{
+    return ((uint32_t)cls < (uint32_t)mTamperClass_Count_c) ? s_className[cls] : s_className[mTamperClass_Unknown_c];
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file tamper_classifier.h
+ * @brief The tamper_classifier.h file declares a fixed-point decision tree which labels a motion from the features
+ *        of its first samples, so that only the classes worth an alert are reported.
+ */
+
+#ifndef TAMPER_CLASSIFIER_H_
+#define TAMPER_CLASSIFIER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "motion_features.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/*! @brief Most nodes visited by one inference, bounds the run time whatever the model. */
+#define TAMPER_CLASSIFIER_MAX_DEPTH (8U)
+
+/*! @brief Feature index of a leaf node, the class is held in the left field. */
+#define TAMPER_NODE_LEAF (0xFFU)
+
+/*! @brief Bit of a class in a class mask. */
+#define TAMPER_CLASS_MASK(cls) (1UL << (uint32_t)(cls))
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief Labels of a motion. */
+typedef enum tamperClass_tag
+{
+    mTamperClass_Unknown_c,   /*!< The model could not be evaluated. */
+    mTamperClass_Vibration_c, /*!< Shaking without a change of orientation, e.g. passing traffic. */
+    mTamperClass_Tilt_c,      /*!< The asset came to rest in another orientation. */
+    mTamperClass_Impact_c,    /*!< Short acceleration well beyond 1 g. */
+    mTamperClass_Handling_c,  /*!< Smooth movement lasting the whole window. */
+    mTamperClass_Count_c,
+} tamperClass_t;
+
+/*! @brief Inputs of the model, all integers derived from the window. */
+typedef enum tamperFeature_tag
+{
+    mTamperFeature_PeakToPeak_c, /*!< Largest peak-to-peak of an axis over the window, counts. */
+    mTamperFeature_Variance_c,   /*!< Largest sum of the axis variances of a burst, counts^2. */
+    mTamperFeature_Jerk_c,       /*!< Jerk energy per sample, counts^2. */
+    mTamperFeature_Shock_c,      /*!< Distance of the peak magnitude from 1 g, counts. */
+    mTamperFeature_Tilt_c,       /*!< Change of the mean between the first and the last burst, sum of the axes, counts. */
+    mTamperFeature_Duration_c,   /*!< Samples seen in the window. */
+    mTamperFeature_Count_c,
+} tamperFeature_t;
+
+/*! @brief One node of a decision tree, 8 bytes. */
+typedef struct
+{
+    int32_t threshold; /*!< Feature values up to the threshold go left, greater values go right. */
+    uint8_t feature;   /*!< tamperFeature_t index, TAMPER_NODE_LEAF for a leaf. */
+    uint8_t left;      /*!< Index of the left child, or the tamperClass_t of a leaf. */
+    uint8_t right;     /*!< Index of the right child. */
+    uint8_t reserved;  /*!< Keeps the node size fixed, 0. */
+} tampernode_t;
+
+/*! @brief A decision tree model, node 0 is the root. Children are always stored after their parent. */
+typedef struct
+{
+    const tampernode_t *pNodes; /*!< Nodes of the tree. */
+    uint8_t numNodes;           /*!< Number of nodes. */
+    int32_t oneG;               /*!< Counts of 1 g at the configured full scale, for the shock feature. */
+} tampermodel_t;
+
+/*! @brief This structure holds the summary of the bursts of one window. */
+typedef struct
+{
+    int32_t firstMean[MOTION_FEATURES_AXES]; /*!< Mean of the first burst. */
+    int32_t lastMean[MOTION_FEATURES_AXES];  /*!< Mean of the latest burst. */
+    uint32_t peakToPeak;                     /*!< Largest peak-to-peak of an axis. */
+    uint32_t variance;                       /*!< Largest sum of the axis variances of a burst. */
+    uint64_t jerk;                           /*!< Jerk energy of all bursts. */
+    uint16_t magnitude;                      /*!< Largest vector magnitude. */
+    uint16_t numSamples;                     /*!< Samples of all bursts. */
+} tamperwindow_t;
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+/*! @brief       Empties a window.
+ *  @param[in]   pWindow  window to clear.
+ */
+void TamperClassifier_WindowInit(tamperwindow_t *pWindow);
+
+/*! @brief       Adds the features of one burst of samples to a window.
+ *  @param[in]   pWindow    window to update.
+ *  @param[in]   pFeatures  features of the burst, bursts without samples are ignored.
+ */
+void TamperClassifier_WindowAdd(tamperwindow_t *pWindow, const motionfeatures_t *pFeatures);
+
+/*! @brief       Derives the model inputs from a window.
+ *  @param[in]   pModel     model the inputs are meant for.
+ *  @param[in]   pWindow    window to summarize.
+ *  @param[out]  pVector    mTamperFeature_Count_c values, saturated to INT32_MAX.
+ */
+void TamperClassifier_Features(const tampermodel_t *pModel, const tamperwindow_t *pWindow, int32_t *pVector);
+
+/*! @brief       Runs the decision tree on a feature vector.
+ *  @details     At most TAMPER_CLASSIFIER_MAX_DEPTH nodes are visited, no recursion, no allocation. A malformed
+ *               model yields mTamperClass_Unknown_c.
+ *  @param[in]   pModel   model to run.
+ *  @param[in]   pVector  mTamperFeature_Count_c feature values.
+ *  @return      the class of the motion.
+ */
+tamperClass_t TamperClassifier_Run(const tampermodel_t *pModel, const int32_t *pVector);
+
+/*! @brief       Returns the name of a class.
+ *  @param[in]   cls  class to name.
+ *  @return      NUL terminated name.
+ */
+const char *TamperClassifier_Name(tamperClass_t cls);
+
+#endif /* TAMPER_CLASSIFIER_H_ */
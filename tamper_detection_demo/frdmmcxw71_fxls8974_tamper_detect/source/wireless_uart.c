@@ -25,6 +25,7 @@
 #include "fsl_component_button.h"
 #include "fsl_component_led.h"
 #include "fsl_component_timer_manager.h"
+#include "fsl_adapter_gpio.h"
 #include "fsl_component_panic.h"
 #include "fsl_component_serial_manager.h"
 #include "fsl_component_mem_manager.h"
@@ -74,6 +75,15 @@
 #include "app.h"
 
 #include "fxls89xx_motion_wakeup.h"
+#if (FXLS8974_BROADCAST_MODE == 1)
+#include "SecLib.h"
+#endif
+#if ((FXLS8974_TEMP_COMP_MODE == 1) || (FXLS8974_BROADCAST_MODE == 1)) && defined(gAppUseNvm_d) && (gAppUseNvm_d > 0)
+#include "NVM_Interface.h"
+#endif
+#if (FXLS8974_BUS_DMA_EN == 1)
+#include "fsl_edma.h"
+#endif
 
 /************************************************************************************
  *************************************************************************************
@@ -85,10 +95,27 @@
 
 #define mAppUartFlushIntervalInMs_c     (7)     /* Flush Timeout in Ms */
 
-#define mfxls89xxIntervalInMs_c     (100)     /* Flush Timeout in Ms */
+#define mAppTxRetryIntervalInMs_c       (20)    /* TX queue retry interval in Ms */
+#define mAppTxAlertReserve_c            (1U)    /* TX queue entries a snapshot leaves free for an alert */
+#if (FXLS8974_BROADCAST_MODE == 1)
+#if (gWuart_PeripheralRole_c == 0)
+#error "FXLS8974_BROADCAST_MODE advertises the tamper beacon, enable gWuart_PeripheralRole_c"
+#endif
+#define mAppBeaconHandle_c              (1U)    /* Advertising set of the tamper beacon, set 0 is the connectable one */
+#define mAppAdvInterval(ms)             (((ms) * 8U) / 5U) /* ms to 0.625 ms */
+#endif
+
+#define mfxls89xxWatchdogIntervalInMs_c (10000) /* SYS_MODE poll interval when INT1 wakes the MCU */
+#define mfxls89xxDeferInt1_c            (0x01U) /* INT1 handler waits for the SYS_MODE read */
+#define mfxls89xxDeferInt2_c            (0x02U) /* INT2 handler waits for the SYS_MODE read */
+#define mfxls89xxDeferStop_c            (0x04U) /* End of capture waits for the SYS_MODE read */
 
 #define mBatteryLevelReportInterval_c   (10)    /* battery level report interval in seconds  */
 
+/* Peers can ask for the bus statistics with "?bus" */
+#define mAppBusReport_c                 (((REGISTER_I2C_PROFILE == 1) && (FXLS8974_SPI_MODE == 0)) || \
+                                         (FXLS8974_BUS_BENCH_MODE == 1))
+
 #define gAllowToBlock_d                 (TRUE)
 #define gNoBlock_d                      (FALSE)
 #define Serial_Print(a,b)               do{ \
@@ -123,7 +150,8 @@ typedef enum appEvent_tag
     mAppEvt_ServiceDiscoveryNotFound_c,
     mAppEvt_ServiceDiscoveryFailed_c,
     mAppEvt_GattProcComplete_c,
-    mAppEvt_GattProcError_c
+    mAppEvt_GattProcError_c,
+    mAppEvt_TamperNotifyEnabled_c
 } appEvent_t;
 
 typedef enum appState_tag
@@ -132,7 +160,8 @@ typedef enum appState_tag
     mAppExchangeMtu_c,
     mAppServiceDisc_c,
     mAppServiceDiscRetry_c,
-    mAppRunning_c
+    mAppRunning_c,
+    mAppTamperNotify_c
 } appState_t;
 
 typedef struct appPeerInfo_tag
@@ -173,12 +202,41 @@ static void BleApp_GattClientCallback(deviceId_t serverDeviceId, gattProcedureTy
 static void BleApp_ServiceDiscoveryCallback(deviceId_t peerDeviceId, servDiscEvent_t *pEvent);
 static void BleApp_StateMachineHandler(deviceId_t peerDeviceId, appEvent_t event);
 static void BleApp_StoreServiceHandles(deviceId_t peerDeviceId, gattService_t *pService);
+static bool_t BleApp_TamperNotifyEnabled(deviceId_t peerDeviceId);
+static void BleApp_StartTamperNotify(deviceId_t peerDeviceId);
+static bool_t BleApp_PeerTakesTx(uint8_t mPeerId, txClass_t cls);
+static bool_t BleApp_QueueTx(uint8_t *pData, uint32_t dataSize, txClass_t cls);
+#if (FXLS8974_SNAPSHOT_MODE == 1)
+static uint8_t BleApp_TxRoom(txClass_t cls);
+#endif
+static bleResult_t BleApp_TransmitTxEntry(deviceId_t peerDeviceId, const txentry_t *pEntry, bool_t *pConfirm);
+static void BleApp_ServiceTxQueue(deviceId_t peerDeviceId);
+static void BleApp_ServiceTxQueues(void *pParam);
+static void BleApp_TxConfirmed(deviceId_t peerDeviceId, bool_t success);
+static void BleApp_TxDrained(void);
+#if (FXLS8974_ASCII_ALERT_MODE == 0)
+static void BleApp_SendTamperEvent(uint8_t *pRecord, uint32_t recordSize);
+#if (FXLS8974_EVENT_BATCH_MS > 0U)
+static uint16_t BleApp_TamperBatchLimit(void);
+static void BleApp_QueueTamperEvent(uint8_t *pRecord, uint32_t recordSize, bool_t urgent);
+static void BleApp_FlushTamperBatch(void *pParam);
+static void TamperBatchTimerCallback(void *pParam);
+#endif
+#endif
+#if (FXLS8974_BROADCAST_MODE == 1)
+static void BleApp_StartBeacon(void);
+static void BleApp_UpdateBeacon(const uint8_t *pRecord, uint32_t recordSize);
+static bool_t BleApp_ReserveBeaconCounter(void);
+static void BleApp_RestartBeacon(bool_t burst);
+static void BleApp_SetupBeacon(void);
+#endif
 
 /* Timer Callbacks */
 #if gWuart_CentralRole_c == 1
 static void ScanningTimerCallback(void *pParam);
 #endif /* gWuart_CentralRole_c */
 static void UartStreamFlushTimerCallback(void *pData);
+static void TxRetryTimerCallback(void *pParam);
 static void BatteryMeasurementTimerCallback(void *pParam);
 #if (defined(gAppButtonCnt_c) && (gAppButtonCnt_c == 1))
 static void SwitchPressTimerCallback(void *pParam);
@@ -190,6 +248,9 @@ static void Uart_TxCallBack(void *pBuffer, serial_manager_callback_message_t *pM
 
 static void BleApp_FlushUartStream(void *pParam);
 static void BleApp_ReceivedUartStream(deviceId_t peerDeviceId, uint8_t *pStream, uint16_t streamLength);
+#if mAppBusReport_c
+static void BleApp_SendBusProfile(void);
+#endif
 
 #if defined(gUseControllerNotifications_c) && (gUseControllerNotifications_c)
 static void BleApp_HandleControllerNotification(bleNotificationEvent_t *pNotificationEvent);
@@ -218,6 +279,65 @@ int fxls89xx_int_BLE(void);
 int fxls89xx_event_BLE(void);
 void fxls89_xx_CallBack();
 void fxls89_xx_TimerCallback();
+static int fxls89xx_handle_mode(uint8_t sysMode);
+static void fxls89xx_SysModeReadCallback(int32_t status, void *pParam);
+static void fxls89xx_SysModeHandler(void *pParam);
+#if (FXLS8974_WAKE_IRQ_MODE == 1) || (FXLS8974_FIFO_CAPTURE_MODE == 1)
+static bool_t fxls89xx_DeferIrq(uint8_t irq);
+static void fxls89xx_ResumeIrq(bool_t fromIsr);
+#endif
+static int32_t fxls89xx_configure(fxls8974_sensorhandle_t *pDriver);
+static void fxls89xx_idle_init(fxls8974_sensorhandle_t *pDriver);
+#if (FXLS8974_SPI_MODE == 1)
+static int32_t fxls89xx_spi_init(uint8_t *pWhoAmI);
+#endif
+#if (FXLS8974_BUS_BENCH_MODE == 1) && (FXLS8974_BUS_DMA_EN == 1)
+static void fxls89xx_bench_idle(void *pDevInfo);
+#endif
+#if (FXLS8974_WAKE_IRQ_MODE == 1)
+static int fxls89xx_irq_init(void);
+static void fxls89xx_Int1Callback(void *pParam);
+static void fxls89xx_Int1Handler(void *pParam);
+#endif
+#if (FXLS8974_FIFO_CAPTURE_MODE == 1)
+static int fxls89xx_buf_init(void);
+static void fxls89xx_buf_start(void);
+static void fxls89xx_buf_stop(void);
+static void fxls89xx_BufStopHandler(void *pParam);
+static void fxls89xx_Int2Callback(void *pParam);
+static void fxls89xx_Int2Handler(void *pParam);
+static void fxls89xx_buf_drain(void);
+static void fxls89xx_SendFeatures(void);
+#endif
+#if (FXLS8974_CLASSIFY_MODE == 1)
+static void fxls89xx_Classify(void);
+#endif
+#if (FXLS8974_ORIENT_MODE == 1)
+static void fxls89xx_read_source(void);
+#if (FXLS8974_ASCII_ALERT_MODE == 1)
+static void fxls89xx_send_source(void);
+#endif
+#endif
+#if (FXLS8974_TEMP_COMP_MODE == 1)
+static void fxls89xx_temp_comp_init(void);
+static void fxls89xx_temp_comp(uint8_t tempOut);
+static void fxls89xx_temp_comp_apply(void);
+#endif
+#if (FXLS8974_ASCII_ALERT_MODE == 0)
+static void fxls89xx_send_event(uint8_t type, uint8_t severity, uint8_t cls);
+static void fxls89xx_send_record(const tamperevent_t *pEvent, uint8_t severity);
+#endif
+#if (FXLS8974_MULTI_SENSOR_MODE == 1)
+static void fxls89xx_engine_decode(sensorengineslot_t *pSlot);
+static void fxls89xx_PollDone(void *pParam);
+static void fxls89xx_multi_event(const sensorengineslot_t *pSlot, bool alert, int32_t sample, int32_t reference);
+#endif
+#if (FXLS8974_SNAPSHOT_MODE == 1)
+static void fxls89xx_snapshot_init(void);
+static void fxls89xx_snapshot_push(uint32_t timestamp, int32_t v0, int32_t v1, int32_t v2);
+static void fxls89xx_snapshot_trigger(void);
+static void fxls89xx_SnapshotSendHandler(void *pParam);
+#endif
 
 /************************************************************************************
  *************************************************************************************
@@ -237,6 +357,10 @@ static bool_t mScanningOn = FALSE;
 
 static uint16_t mCharMonitoredHandles[1] = { (uint16_t)value_uart_stream };
 
+/* Transmit queue of each peer */
+static txqueue_t maTxQueue[gAppMaxConnections_c];
+static bool_t mTxRetryPending = FALSE;
+
 /* Service Data*/
 static wusConfig_t mWuServiceConfig;
 static bool_t      mBasValidClientList[gAppMaxConnections_c] = {FALSE};
@@ -244,8 +368,86 @@ static basConfig_t mBasServiceConfig = {(uint16_t)service_battery, 0, mBasValidC
 
 static TIMER_MANAGER_HANDLE_DEFINE(mAppTimerId);
 static TIMER_MANAGER_HANDLE_DEFINE(mUartStreamFlushTimerId);
+static TIMER_MANAGER_HANDLE_DEFINE(mTxRetryTimerId);
+#if (FXLS8974_ASCII_ALERT_MODE == 0) && (FXLS8974_EVENT_BATCH_MS > 0U)
+static TIMER_MANAGER_HANDLE_DEFINE(mTamperBatchTimerId);
+#endif
 static TIMER_MANAGER_HANDLE_DEFINE(mBatteryMeasurementTimerId);
 static TIMER_MANAGER_HANDLE_DEFINE(mFxls89xxId);
+#if (FXLS8974_SPI_MODE == 0)
+/* SYS_MODE poll, read without blocking the timer task */
+static registerasyncxfer_t mFxls89xxSysModeXfer;
+#endif
+static uint8_t mFxls89xxSysMode;
+static volatile bool_t mFxls89xxSysModeBusy = FALSE;
+#if (FXLS8974_WAKE_IRQ_MODE == 1) || (FXLS8974_FIFO_CAPTURE_MODE == 1)
+/* INT handlers that found the SYS_MODE read on the bus, they run once it completes */
+static volatile uint8_t mFxls89xxIrqDeferred = 0U;
+#endif
+#if (FXLS8974_WAKE_IRQ_MODE == 0)
+/* SYS_MODE poll interval, stretched while the asset stays still */
+static pollsched_t mFxls89xxPoll;
+#endif
+#if (FXLS8974_BUS_BENCH_MODE == 1)
+/* Bus and CPU time of the sample buffer drains */
+static busbench_t mFxls89xxBench;
+#endif
+#if (FXLS8974_WAKE_IRQ_MODE == 1)
+static GPIO_HANDLE_DEFINE(mFxls89xxInt1Handle);
+static bool_t mFxls89xxIrqReady = FALSE;
+static volatile bool_t mFxls89xxIrqPending = FALSE;
+#endif
+#if (FXLS8974_FIFO_CAPTURE_MODE == 1)
+static GPIO_HANDLE_DEFINE(mFxls89xxInt2Handle);
+static bool_t mFxls89xxBufReady = FALSE;
+static volatile bool_t mFxls89xxBufPending = FALSE;
+/* Last drained burst of samples, oldest first */
+static fxls8974_acceldata_t mFxls89xxCapture[FXLS8974_BUF_MAX_SAMPLES];
+static uint8_t mFxls89xxCaptureCount = 0U;
+/* Samples of a drain, the buffer depth of the variant found at init */
+static uint8_t mFxls89xxBufDepth = FXLS8974_BUF_MAX_SAMPLES;
+static uint32_t mFxls89xxBufOverflows = 0U;
+/* Features of the most energetic burst of the current motion */
+static motionfeatures_t mFxls89xxFeatures;
+#endif
+#if (FXLS8974_CLASSIFY_MODE == 1)
+/* First samples of the motion, classified before the alert is raised */
+static tamperwindow_t mFxls89xxWindow;
+static bool_t mFxls89xxClassifying = FALSE;
+static uint32_t mFxls89xxSuppressed = 0U;
+#endif
+#if (FXLS8974_ORIENT_MODE == 1)
+/* ORIENT_STATUS up to SDCD_INT_SRC2 as read at the last wake */
+static uint8_t mFxls89xxEventSrc[FXLS8974_EVENT_SRC_SIZE];
+#endif
+#if (FXLS8974_TEMP_COMP_MODE == 1)
+/* Per-unit offset coefficients, restored from NVM */
+static tempcompcoeffs_t mFxls89xxTempCoeffs;
+static tempcomp_t mFxls89xxTempComp;
+/* The band moved at the last wake, it is written at the next sleep */
+static bool_t mFxls89xxTempCompDue = FALSE;
+/* Back from the standby of the write, the sensor runs in WAKE for ASLP_COUNT */
+static bool_t mFxls89xxTempCompRestart = FALSE;
+#if defined(gAppUseNvm_d) && (gAppUseNvm_d > 0)
+NVM_RegisterDataSet(&mFxls89xxTempCoeffs, 1, sizeof(tempcompcoeffs_t), FXLS8974_TEMP_COMP_NVM_ID, gNVM_MirroredInRam_c);
+#endif
+#endif
+#if (FXLS8974_ASCII_ALERT_MODE == 0)
+/* Counter of the event records, a gap tells the peer an event was lost */
+static uint8_t mFxls89xxEventSeq = 0U;
+#if (FXLS8974_EVENT_BATCH_MS > 0U)
+/* Event records waiting for the end of the batch window */
+static tamperbatch_t mTamperBatch;
+static bool_t mTamperBatchPending = FALSE;
+#endif
+#endif
+#if (FXLS8974_SNAPSHOT_MODE == 1)
+/* Samples around the last alert, the storage is reserved at build time so it shows in the map file */
+static capturering_t mFxls89xxSnapshot;
+static capturesample_t mFxls89xxSnapshotStorage[FXLS8974_SNAPSHOT_SAMPLES];
+static bool_t mFxls89xxSnapshotSendPending = FALSE;
+static bool_t mFxls89xxSnapshotClosing = FALSE; /* The motion ended, release the ring once it is read out */
+#endif
 
 /* If the board has only one button, multiplex the required functionalities on it using an application timer */
 #if (gAppButtonCnt_c == 1)
@@ -283,19 +485,69 @@ static appAdvertisingParams_t mAppAdvParams = {
 };
 #endif
 
+#if (FXLS8974_BROADCAST_MODE == 1)
+/* Tamper beacon, non-connectable and non-scannable */
+static gapExtAdvertisingParameters_t mBeaconAdvParams = {
+    /* SID */                       mAppBeaconHandle_c,
+    /* handle */                    mAppBeaconHandle_c,
+    /* minInterval */               mAppAdvInterval(FXLS8974_BROADCAST_SLOW_MS),
+    /* maxInterval */               mAppAdvInterval(FXLS8974_BROADCAST_SLOW_MS),
+    /* ownAddressType */            gBleAddrTypePublic_c,
+    /* ownRandomAddr */             {0, 0, 0, 0, 0, 0},
+    /* peerAddressType */           gBleAddrTypePublic_c,
+    /* peerAddress */               {0, 0, 0, 0, 0, 0},
+    /* channelMap */                (gapAdvertisingChannelMapFlags_t)gGapAdvertisingChannelMapDefault_c,
+    /* filterPolicy */              gProcessAll_c,
+    /* extAdvProperties */          0U,
+    /* txPower */                   gBleAdvTxPowerNoPreference_c,
+    /* primaryPHY */                gLePhy1M_c,
+    /* secondaryPHY */              gLePhy1M_c,
+    /* secondaryAdvMaxSkip */       0U,
+    /* enableScanReqNotification */ FALSE
+};
+
+static uint8_t maBeaconData[TAMPER_BEACON_MAX_SIZE];
+
+static gapAdStructure_t maBeaconAdStruct[1] = {
+  {
+    .length = TAMPER_BEACON_HEADER_SIZE + TAMPER_BEACON_MIC_SIZE + 1U,
+    .adType = gAdManufacturerSpecificData_c,
+    .aData = maBeaconData
+  }
+};
+
+static gapAdvertisingData_t mBeaconAdvData = {
+    NumberOfElements(maBeaconAdStruct),
+    maBeaconAdStruct
+};
+
+static appExtAdvertisingParams_t mAppBeaconParams = {
+    .pGapExtAdvParams = &mBeaconAdvParams,
+    .pGapAdvData = &mBeaconAdvData,
+    .pScanResponseData = NULL,
+    .handle = mAppBeaconHandle_c,
+    .duration = gBleExtAdvNoDuration_c,
+    .maxExtAdvEvents = gBleExtAdvNoMaxEvents_c
+};
+
+static const uint8_t mBeaconKey[AES_128_KEY_BYTE_LEN] = FXLS8974_BROADCAST_KEY;
+static uint32_t mBeaconCounter = 0U;
+/* End of the counter values reserved in NVM, a reset goes on from there */
+static uint32_t mBeaconCounterLimit = 0U;
+NVM_RegisterDataSet(&mBeaconCounterLimit, 1, sizeof(uint32_t), FXLS8974_BROADCAST_NVM_ID, gNVM_MirroredInRam_c);
+static bool_t mBeaconStarted = FALSE;   /* The beacon and the sensor run */
+static bool_t mBeaconOn = FALSE;        /* The set is advertising */
+static bool_t mBeaconBusy = FALSE;      /* A start or a stop is in progress */
+static bool_t mBeaconPending = FALSE;   /* A restart waits for the one in progress */
+static bool_t mBeaconBurst = FALSE;     /* The next start is a burst */
+#endif
+
 uint8_t vec_init[70] = 			"\r\n ISSDK FXLS89xx sensor driver example to detect motion event & AWS\r\n";
-uint8_t vec_i2c_init[70] = 		"\r\n I2C Initialization Failed\r\n";
-uint8_t vec_power_cont[70] =	"\r\n I2C Power Mode setting Failed\r\n";
-uint8_t vec_mode_cont[70] =		"\r\n I2C Control Mode setting Failed\r\n";
+uint8_t vec_i2c_init[70] = 		"\r\n " FXLS8974_TRANSPORT_NAME " Initialization Failed\r\n";
+uint8_t vec_power_cont[70] =	"\r\n " FXLS8974_TRANSPORT_NAME " Power Mode setting Failed\r\n";
+uint8_t vec_mode_cont[70] =		"\r\n " FXLS8974_TRANSPORT_NAME " Control Mode setting Failed\r\n";
 uint8_t vec_inint_sensor[70] =	"\r\n Sensor Initialization Failed\r\n";
 
-uint8_t vec_gemini[70] =		"\r\n Successfully Initialized Gemini with WHO_AM_I = 0x84\r\n";
-uint8_t vec_gemini_1[70] =		"\r\n Successfully Initialized Gemini with WHO_AM_I = 0x87\r\n";
-uint8_t vec_timandra[70] =		"\r\n Successfully Initialized Timandra with WHO_AM_I = 0x86\r\n";
-uint8_t vec_timandra_1[70] =		"\r\n Successfully Initialized Timandra with WHO_AM_I = 0x88\r\n";
-uint8_t vec_chiron[70] =        "\r\n Successfully Initialized Chiron with WHO_AM_I = 0x83 \r\n";
-uint8_t vec_chiron_1[70] =        "\r\n Successfully Initialized Chiron with WHO_AM_I = 0x81\r\n";
-uint8_t vec_newstein[70] =		"\r\n Successfully Initialized Newstein with WHO_AM_I = 0x62 \r\n";
 uint8_t vec_whoiam[70] =		"\r\n Bad WHO_AM_I = \r\n";
 
 uint8_t vec_sensor_err[70] =	"\r\n FXLS89xx Sensor Configuration Failed\r\n";
@@ -306,12 +558,14 @@ uint8_t vec_read_failed[70] =	"\r\n Read Failed. \r\n";
 //uint8_t vec_motion_dec[70] =	"\r\n Motion Detected....\r\n";
 uint8_t vec_motion_start[70] =	"\r\n =============!!ALERT!!=================";
 uint8_t vec_motion_dec[70] =	"\r\n Motion Tampering Detected on your Asset";
+uint8_t vec_tilt_dec[70] =	"\r\n Tilt Tampering Detected on your Asset";
 uint8_t vec_motion_end[70] =	"\r\n =============!!ALERT!!=================\r\n";
 uint8_t vec_MCU_wake[70] =	"\r\n MCU woke-up on sensor motion event\r\n";
 uint8_t vec_enter_sleep[70] =	"\r\n Will enter sleep mode after expiration of ASLP counter = ~5sec\r\n\r\n";
 
 //uint8_t vec_ASLP[70] =		"\r\n ASLP counter expired....\r\n";
 uint8_t vec_ASLP[70] =		"\r\n Your Asset is Safe\r\n";
+uint8_t vec_snapshot[70] =	"\r\n Snapshot: time us, 3 x int32, 16 bytes per sample\r\n";
 uint8_t vec_sleep_mode[70] =	"\r\n Going to Sleep Mode....SYSMODE = \r\n";
 uint8_t vec_MCU_low_Power[70] =	"\r\n Putting MCU in low power sleep\r\n\r\n";
 
@@ -627,6 +881,9 @@ static void BleApp_AdvertisingCallback
 #endif /* gAppLedCnt_c == 1 */
             Led1Flashing();
             Serial_Print("\n\rAdvertising...\n\r", gAllowToBlock_d);
+#if (FXLS8974_BROADCAST_MODE == 1)
+            BleApp_StartBeacon();
+#endif
             }
             else
             {
@@ -644,6 +901,43 @@ static void BleApp_AdvertisingCallback
         }
         break;
 
+#if (FXLS8974_BROADCAST_MODE == 1)
+        case gExtAdvertisingStateChanged_c:
+        {
+            if (mAppBeaconHandle_c == pAdvertisingEvent->eventData.advHandle)
+            {
+                mBeaconOn = !mBeaconOn;
+                if (mBeaconOn)
+                {
+                    mBeaconBusy = FALSE;
+                    if (mBeaconPending)
+                    {
+                        mBeaconPending = FALSE;
+                        BleApp_RestartBeacon(mBeaconBurst);
+                    }
+                }
+                else
+                {
+                    /* Stopped to change the interval, the start takes the latest content */
+                    mBeaconPending = FALSE;
+                    BleApp_SetupBeacon();
+                }
+            }
+        }
+        break;
+
+        case gAdvertisingSetTerminated_c:
+        {
+            if (mAppBeaconHandle_c == pAdvertisingEvent->eventData.advSetTerminated.handle)
+            {
+                /* The burst is over, back to slow beaconing */
+                mBeaconOn = FALSE;
+                BleApp_RestartBeacon(FALSE);
+            }
+        }
+        break;
+#endif
+
         default:
         {
             ; /* No action required */
@@ -766,6 +1060,22 @@ static void BleApp_ConnectionCallback
             Serial_PrintDec(peerDeviceId);
             Serial_Print(".\n\r", gAllowToBlock_d);
 
+            /* Pending entries are lost with the link */
+            TxQueue_Reset(&maTxQueue[peerDeviceId]);
+            BleApp_TxDrained();
+            Serial_Print("TX drops alert/status/snapshot/debug ", gAllowToBlock_d);
+            Serial_PrintDec(maTxQueue[peerDeviceId].drops[mTxClass_Alert_c]);
+            Serial_Print("/", gAllowToBlock_d);
+            Serial_PrintDec(maTxQueue[peerDeviceId].drops[mTxClass_Status_c]);
+            Serial_Print("/", gAllowToBlock_d);
+            Serial_PrintDec(maTxQueue[peerDeviceId].drops[mTxClass_Snapshot_c]);
+            Serial_Print("/", gAllowToBlock_d);
+            Serial_PrintDec(maTxQueue[peerDeviceId].drops[mTxClass_Debug_c]);
+            Serial_Print(", retries ", gAllowToBlock_d);
+            Serial_PrintDec(maTxQueue[peerDeviceId].retries);
+            Serial_Print(".\n\r", gAllowToBlock_d);
+            TxQueue_Init(&maTxQueue[peerDeviceId]);
+
             maPeerInformation[peerDeviceId].appState = mAppIdle_c;
             maPeerInformation[peerDeviceId].clientInfo.hService = gGattDbInvalidHandleIndex_d;
             maPeerInformation[peerDeviceId].clientInfo.hUartStream = gGattDbInvalidHandleIndex_d;
@@ -936,6 +1246,12 @@ static void BleApp_GattClientCallback
     bleResult_t             error
 )
 {
+    /* A confirmed write of the TX queue completed */
+    if ((gGattProcWriteCharacteristicValue_c == procedureType) && (maTxQueue[serverDeviceId].busy))
+    {
+        BleApp_TxConfirmed(serverDeviceId, (gGattProcSuccess_c == procedureResult) ? TRUE : FALSE);
+    }
+
     switch (procedureResult)
     {
         case gGattProcError_c:
@@ -1003,6 +1319,35 @@ static void BleApp_GattServerCallback
 
     switch (pServerEvent->eventType)
     {
+        case gEvtAttributeWritten_c:
+        {
+            if (pServerEvent->eventData.attributeWrittenEvent.handle == (uint16_t)value_uart_stream)
+            {
+                BleApp_ReceivedUartStream(deviceId, pServerEvent->eventData.attributeWrittenEvent.aValue,
+                                          pServerEvent->eventData.attributeWrittenEvent.cValueLength);
+                (void)GattServer_SendAttributeWrittenStatus(deviceId, (uint16_t)value_uart_stream,
+                                                            (uint8_t)gAttErrCodeNoError_c);
+            }
+
+            break;
+        }
+
+        case gEvtHandleValueConfirmation_c:
+        {
+            BleApp_TxConfirmed(deviceId, TRUE);
+            break;
+        }
+
+        case gEvtError_c:
+        {
+            if (pServerEvent->eventData.procedureError.procedureType == gSendIndication_c)
+            {
+                BleApp_TxConfirmed(deviceId, FALSE);
+            }
+
+            break;
+        }
+
         case gEvtAttributeWrittenWithoutResponse_c:
         {
             if (pServerEvent->eventData.attributeWrittenEvent.handle == (uint16_t)value_uart_stream)
@@ -1014,6 +1359,18 @@ static void BleApp_GattServerCallback
             break;
         }
 
+        case gEvtCharacteristicCccdWritten_c:
+        {
+            if ((pServerEvent->eventData.charCccdWrittenEvent.handle == (uint16_t)cccd_tamper_event) &&
+                (0U != ((uint8_t)pServerEvent->eventData.charCccdWrittenEvent.newCccd &
+                        ((uint8_t)gCccdNotification_c | (uint8_t)gCccdIndication_c))))
+            {
+                BleApp_StateMachineHandler(deviceId, mAppEvt_TamperNotifyEnabled_c);
+            }
+
+            break;
+        }
+
         case gEvtMtuChanged_c:
         {
             /* update stream length with minimum of  new MTU */
@@ -1097,7 +1454,7 @@ static bool_t BleApp_CheckScanEvent
 #endif /* gWuart_CentralRole_c == 1 */
 
 /*! *********************************************************************************
- * \brief        Send the received uart stream over GATT
+ * \brief        Send the received uart stream over GATT, as a status message.
  *
  * \param[in]    pData              Pointer to the received stream.
  * \param[in]    streamSize         The number of bytes in the stream.
@@ -1108,967 +1465,2842 @@ static void BleApp_SendUartStream
     uint32_t streamSize
 )
 {
-    gattCharacteristic_t characteristic = {(uint8_t)gGattCharPropNone_c, {0}, 0, 0};
-    uint8_t              mPeerId = 0;
+    (void)BleApp_QueueTx(pRecvStream, streamSize, mTxClass_Status_c);
+}
+
+/*! *********************************************************************************
+ * \brief        Checks if a peer takes the data of a TX class.
+ *
+ * \details      Alerts go to the peers subscribed to the Tamper service and the
+ *               running peers, the other classes to the running peers only.
+ *
+ * \param[in]    mPeerId            The peer index.
+ * \param[in]    cls                txClass_t of the data.
+ *
+ * \return       TRUE if the data is queued for the peer.
+ ********************************************************************************** */
+static bool_t BleApp_PeerTakesTx
+(
+    uint8_t mPeerId,
+    txClass_t cls
+)
+{
+    return ((gInvalidDeviceId_c != maPeerInformation[mPeerId].deviceId) &&
+            ((mAppRunning_c == maPeerInformation[mPeerId].appState) ||
+             ((mTxClass_Alert_c == cls) && (TRUE == BleApp_TamperNotifyEnabled(mPeerId))))) ? TRUE : FALSE;
+}
+
+/*! *********************************************************************************
+ * \brief        Queues data for all peers which can take it and starts sending.
+ *
+ * \details      Data longer than a queue entry takes several entries, a peer
+ *               without room for all of them gets none, see TxQueue_PushMessage.
+ *
+ * \param[in]    pData              Pointer to the data.
+ * \param[in]    dataSize           The number of bytes in the data.
+ * \param[in]    cls                txClass_t of the data.
+ *
+ * \return       FALSE if a peer dropped the data.
+ ********************************************************************************** */
+static bool_t BleApp_QueueTx
+(
+    uint8_t *pData,
+    uint32_t dataSize,
+    txClass_t cls
+)
+{
+    bool_t   queued = TRUE;
+    uint8_t  mPeerId = 0;
 
-    /* send UART stream to all peers */
     for (mPeerId = 0; mPeerId < (uint8_t)gAppMaxConnections_c; mPeerId++)
     {
-        if (gInvalidDeviceId_c != maPeerInformation[mPeerId].deviceId &&
-            mAppRunning_c == maPeerInformation[mPeerId].appState)
+        if (TRUE == BleApp_PeerTakesTx(mPeerId, cls))
         {
-            characteristic.value.handle = maPeerInformation[mPeerId].clientInfo.hUartStream;
-            (void)GattClient_WriteCharacteristicValue(mPeerId, &characteristic,
-                    streamSize, pRecvStream, TRUE,
-                    FALSE, FALSE, NULL);
+            if (!TxQueue_PushMessage(&maTxQueue[mPeerId], (uint8_t)cls, pData, dataSize))
+            {
+                queued = FALSE;
+            }
+
+            /* A queue the host stack refused waits for the retry timer, so that
+               each retry interval costs its alert one attempt only */
+            if (!maTxQueue[mPeerId].held)
+            {
+                BleApp_ServiceTxQueue(mPeerId);
+            }
         }
     }
+
+    return queued;
 }
 
+#if (FXLS8974_SNAPSHOT_MODE == 1)
 /*! *********************************************************************************
- * \brief        Handle the main application state machine
+ * \brief        Gets the entries of a TX class every peer taking it can queue.
+ *
+ * \param[in]    cls                txClass_t of the data.
+ *
+ * \return       The smallest room of the peers, TX_QUEUE_DEPTH without peers.
+ ********************************************************************************** */
+static uint8_t BleApp_TxRoom
+(
+    txClass_t cls
+)
+{
+    uint8_t  room = TX_QUEUE_DEPTH;
+    uint8_t  peerRoom;
+    uint8_t  mPeerId = 0;
+
+    for (mPeerId = 0; mPeerId < (uint8_t)gAppMaxConnections_c; mPeerId++)
+    {
+        if (TRUE == BleApp_PeerTakesTx(mPeerId, cls))
+        {
+            peerRoom = TxQueue_Room(&maTxQueue[mPeerId], (uint8_t)cls);
+            room = (peerRoom < room) ? peerRoom : room;
+        }
+    }
+
+    return room;
+}
+#endif
+
+/*! *********************************************************************************
+ * \brief        Sends one queue entry to a peer.
+ *
+ * \details      An alert goes out as an indication, or as a notification if the
+ *               peer only enabled those, to a peer subscribed to the Tamper
+ *               service, else as a write with response on its Wireless UART.
+ *               The other classes are written without response.
  *
  * \param[in]    peerDeviceId       The remote device ID.
- * \param[in]    event              The application event.
+ * \param[in]    pEntry             Pointer to the entry.
+ * \param[out]   pConfirm           TRUE if the peer will confirm the entry.
+ *
+ * \return       The result of the host stack call.
  ********************************************************************************** */
-static void BleApp_StateMachineHandler
+static bleResult_t BleApp_TransmitTxEntry
 (
     deviceId_t peerDeviceId,
-    appEvent_t event
+    const txentry_t *pEntry,
+    bool_t *pConfirm
 )
 {
-    uint16_t tempMtu = 0;
-    union
-    {
-        uint8_t     *pUuidArray;
-        bleUuid_t   *pUuidObj;
-    } temp; /* MISRA rule 11.3 */
+    gattCharacteristic_t characteristic = {(uint8_t)gGattCharPropNone_c, {0}, 0, 0};
+    bool_t               isIndActive = FALSE;
+    bleResult_t          result = gBleSuccess_c;
 
-    temp.pUuidArray = uuid_service_wireless_uart;
+    *pConfirm = FALSE;
 
-    /* invalid client information */
-    if (maPeerInformation[peerDeviceId].deviceId != gInvalidDeviceId_c)
+    if (((uint8_t)mTxClass_Alert_c == pEntry->cls) && (TRUE == BleApp_TamperNotifyEnabled(peerDeviceId)))
     {
-        switch (maPeerInformation[peerDeviceId].appState)
-        {
-        case mAppIdle_c:
+        if ((gBleSuccess_c == Gap_CheckIndicationStatus(peerDeviceId, (uint16_t)cccd_tamper_event, &isIndActive)) &&
+            (TRUE == isIndActive))
         {
-            if (event == mAppEvt_PeerConnected_c)
-            {
-                /* Let the central device initiate the Exchange MTU procedure*/
-                if (mGapRole == gGapCentral_c)
-                {
-                    /* Moving to Exchange MTU State */
-                    maPeerInformation[peerDeviceId].appState = mAppExchangeMtu_c;
-                    (void)GattClient_ExchangeMtu(peerDeviceId, gAttMaxMtu_c);
-                }
-                else
-                {
-                    /* Moving to Service Discovery State*/
-                    maPeerInformation[peerDeviceId].appState = mAppServiceDisc_c;
-
-                    /* Start Service Discovery*/
-                    (void)BleServDisc_FindService(peerDeviceId,
-                            gBleUuidType128_c,
-                            temp.pUuidObj);
-                }
-            }
+            result = GattServer_SendInstantValueIndication(peerDeviceId, (uint16_t)value_tamper_event,
+                                                           pEntry->length, pEntry->data);
+            *pConfirm = TRUE;
         }
-        break;
-
-        case mAppExchangeMtu_c:
+        else
         {
-            if (event == mAppEvt_GattProcComplete_c)
-            {
-                /* update stream length with minimum of maximum MTU's of connected devices */
-                (void)Gatt_GetMtu(peerDeviceId, &tempMtu);
-                tempMtu = gAttMaxWriteDataSize_d(tempMtu);
+            result = GattServer_SendInstantValueNotification(peerDeviceId, (uint16_t)value_tamper_event,
+                                                             pEntry->length, pEntry->data);
+        }
+    }
+    else if (mAppRunning_c == maPeerInformation[peerDeviceId].appState)
+    {
+        characteristic.value.handle = maPeerInformation[peerDeviceId].clientInfo.hUartStream;
+        *pConfirm = ((uint8_t)mTxClass_Alert_c == pEntry->cls) ? TRUE : FALSE;
+        result = GattClient_WriteCharacteristicValue(peerDeviceId, &characteristic,
+                pEntry->length, pEntry->data, (TRUE == *pConfirm) ? FALSE : TRUE,
+                FALSE, FALSE, NULL);
+    }
+    else
+    {
+        ; /* The peer cannot take it any more, the entry is consumed */
+    }
 
-                mAppUartBufferSize = mAppUartBufferSize <= tempMtu ? mAppUartBufferSize : tempMtu;
+    return result;
+}
 
-                /* Moving to Service Discovery State*/
-                maPeerInformation[peerDeviceId].appState = mAppServiceDisc_c;
+/*! *********************************************************************************
+ * \brief        Sends the queued entries of a peer, in priority order.
+ *
+ * \details      Stops at an entry waiting for a confirmation. When the host stack
+ *               refuses an entry, e.g. with gBleOverflow_c, the queue is held and
+ *               serviced again after mAppTxRetryIntervalInMs_c.
+ *
+ * \param[in]    peerDeviceId       The remote device ID.
+ ********************************************************************************** */
+static void BleApp_ServiceTxQueue
+(
+    deviceId_t peerDeviceId
+)
+{
+    txqueue_t       *pQueue = &maTxQueue[peerDeviceId];
+    const txentry_t *pEntry = NULL;
+    bool_t           confirm = FALSE;
 
-                /* Start Service Discovery*/
-                (void)BleServDisc_FindService(peerDeviceId,
-                        gBleUuidType128_c,
-                        temp.pUuidObj);
+    while ((!pQueue->busy) && (NULL != (pEntry = TxQueue_Head(pQueue))))
+    {
+        if (gBleSuccess_c == BleApp_TransmitTxEntry(peerDeviceId, pEntry, &confirm))
+        {
+            if (TRUE == confirm)
+            {
+                TxQueue_Wait(pQueue);
             }
             else
             {
-                if (event == mAppEvt_GattProcError_c)
-                {
-                    (void)Gap_Disconnect(peerDeviceId);
-                }
+                TxQueue_Done(pQueue);
             }
         }
-        break;
-
-        case mAppServiceDisc_c:
+        else
         {
-            if (event == mAppEvt_ServiceDiscoveryComplete_c)
+            (void)TxQueue_Fail(pQueue);
+            if (NULL != TxQueue_Head(pQueue))
             {
-                /* Moving to Running State*/
-                maPeerInformation[peerDeviceId].appState = mAppRunning_c;
-
+                pQueue->held = true;
+                (void)TM_InstallCallback((timer_handle_t)mTxRetryTimerId, TxRetryTimerCallback, NULL);
+                (void)TM_Start((timer_handle_t)mTxRetryTimerId,
+                            (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, mAppTxRetryIntervalInMs_c);
+            }
+            break;
+        }
+    }
+}
 
-                fxls89xx_int_BLE();
-                fxls89_xx_CallBack();
+/*! *********************************************************************************
+ * \brief        Sends the queued entries of all peers.
+ *
+ * \param[in]    pParam             Callback parameters.
+ ********************************************************************************** */
+static void BleApp_ServiceTxQueues
+(
+    void *pParam
+)
+{
+    uint8_t mPeerId = 0;
 
+    mTxRetryPending = FALSE;
 
-#if gAppUseBonding_d
-                union
-                {
-                    uint32_t u32;
-                    uint16_t u16;
-                } tempCast;
-
-                tempCast.u32 = sizeof(wucConfig_t);
-                /* Write data in NVM */
-                (void)Gap_SaveCustomPeerInformation(maPeerInformation[peerDeviceId].deviceId,
-                        (uint8_t *) &maPeerInformation[peerDeviceId].clientInfo, 0,
-                        tempCast.u16);
-#endif
-            }
-            else if (event == mAppEvt_ServiceDiscoveryNotFound_c)
-            {
-                /* Moving to Service discovery Retry State*/
-                maPeerInformation[peerDeviceId].appState = mAppServiceDiscRetry_c;
-                /* Restart Service Discovery for all services */
-                (void)BleServDisc_Start(peerDeviceId);
-            }
-            else if (event == mAppEvt_ServiceDiscoveryFailed_c)
-            {
-                (void)Gap_Disconnect(peerDeviceId);
-            }
-            else
-            {
-                /* ignore other event types */
-            }
-        }
-        break;
-
-        case mAppServiceDiscRetry_c:
+    for (mPeerId = 0; mPeerId < (uint8_t)gAppMaxConnections_c; mPeerId++)
+    {
+        if (gInvalidDeviceId_c != maPeerInformation[mPeerId].deviceId)
         {
-            if (event == mAppEvt_ServiceDiscoveryComplete_c)
-            {
-                /* Moving to Running State*/
-                maPeerInformation[peerDeviceId].appState = mAppRunning_c;
-            }
-            else if ((event == mAppEvt_ServiceDiscoveryNotFound_c) ||
-                    (event == mAppEvt_ServiceDiscoveryFailed_c))
-            {
-                (void)Gap_Disconnect(peerDeviceId);
-            }
-            else
-            {
-                /* ignore other event types */
-            }
+            maTxQueue[mPeerId].held = false;
+            BleApp_ServiceTxQueue(mPeerId);
         }
-        break;
+    }
 
-        case mAppRunning_c:
-            break;
+    BleApp_TxDrained();
+}
 
-        default:
+/*! *********************************************************************************
+ * \brief        Handles the confirmation of the entry a peer was waiting for.
+ *
+ * \param[in]    peerDeviceId       The remote device ID.
+ * \param[in]    success            FALSE if the peer answered with an error.
+ ********************************************************************************** */
+static void BleApp_TxConfirmed
+(
+    deviceId_t peerDeviceId,
+    bool_t success
+)
+{
+    if (!maTxQueue[peerDeviceId].busy)
+    {
+        return;
+    }
+
+    if (TRUE == success)
+    {
+        TxQueue_Done(&maTxQueue[peerDeviceId]);
+    }
+    else
+    {
+        (void)TxQueue_Fail(&maTxQueue[peerDeviceId]);
+    }
+
+    BleApp_ServiceTxQueue(peerDeviceId);
+    BleApp_TxDrained();
+}
+
+/*! *********************************************************************************
+ * \brief        Lets the data waiting for room in the TX queues go on.
+ *
+ * \details      Called once queue entries went out or were dropped. The snapshot
+ *               is read from its ring only as fast as the queues drain, see
+ *               fxls89xx_SnapshotSendHandler.
+ ********************************************************************************** */
+static void BleApp_TxDrained(void)
+{
+#if (FXLS8974_SNAPSHOT_MODE == 1)
+    if (mFxls89xxSnapshot.triggered && (FALSE == mFxls89xxSnapshotSendPending))
+    {
+        mFxls89xxSnapshotSendPending = TRUE;
+        if (gBleSuccess_c != App_PostCallbackMessage(fxls89xx_SnapshotSendHandler, NULL))
         {
-            ; /* No action required */
-        }
-        break;
+            mFxls89xxSnapshotSendPending = FALSE;
         }
     }
+#endif
 }
 
-#if gWuart_CentralRole_c == 1
 /*! *********************************************************************************
- * \brief        Handles scanning timer callback.
+ * \brief        Checks if a peer enabled the notifications or indications of the tamper events.
  *
- * \param[in]    pParam             Callback parameters.
+ * \param[in]    peerDeviceId       The remote device ID.
+ *
+ * \return       TRUE if the CCCD of the tamper event is set for notifications or indications.
  ********************************************************************************** */
-static void ScanningTimerCallback
+static bool_t BleApp_TamperNotifyEnabled
 (
-    void *pParam
+    deviceId_t peerDeviceId
 )
 {
-    /* Stop scanning */
-    (void)Gap_StopScanning();
+    bool_t isNotifActive = FALSE;
+    bool_t isIndActive = FALSE;
+
+    if (gBleSuccess_c != Gap_CheckNotificationStatus(peerDeviceId, (uint16_t)cccd_tamper_event, &isNotifActive))
+    {
+        isNotifActive = FALSE;
+    }
+    if (gBleSuccess_c != Gap_CheckIndicationStatus(peerDeviceId, (uint16_t)cccd_tamper_event, &isIndActive))
+    {
+        isIndActive = FALSE;
+    }
+
+    return ((TRUE == isNotifActive) || (TRUE == isIndActive)) ? TRUE : FALSE;
 }
-#endif /* gWuart_CentralRole_c == 1 */
 
-#if (defined(gAppButtonCnt_c) && (gAppButtonCnt_c == 1))
 /*! *********************************************************************************
- * \brief        Handles the switch press timer callback.
+ * \brief        Serves a peer which only subscribed to the Tamper service.
  *
- * \param[in]    pParam             Callback parameters.
+ * \details      The events go out as notifications, the discovery of a Wireless
+ *               UART on the peer is not needed and is stopped.
+ *
+ * \param[in]    peerDeviceId       The remote device ID.
  ********************************************************************************** */
-static void SwitchPressTimerCallback
+static void BleApp_StartTamperNotify
 (
-    void *pParam
+    deviceId_t peerDeviceId
 )
 {
-  if(mSwitchPressCnt >= gSwitchPressThreshold_c)
-  {
-      /* Switch the current role */
-      if (mGapRole == gGapCentral_c)
-      {
-          Serial_Print("\n\rSwitched role to GAP Peripheral.\n\r", gAllowToBlock_d);
-          mAppUartNewLine = TRUE;
-          mGapRole = gGapPeripheral_c;
-      }
-      else
-      {
-          Serial_Print("\n\rSwitched role to GAP Central.\n\r", gAllowToBlock_d);
-          mAppUartNewLine = TRUE;
-          mGapRole = gGapCentral_c;
-      }
-  }
-  else
-  {
-      /* start the application using the selected role */
-      LedStopFlashingAllLeds();
-      Led1Flashing();
-      BleApp_Start(mGapRole);
-  }
+    BleServDisc_Stop(peerDeviceId);
 
-  /* reset the switch press counter */
-  mSwitchPressCnt = 0;
+    /* Moving to Tamper Notify State*/
+    maPeerInformation[peerDeviceId].appState = mAppTamperNotify_c;
+
+    fxls89xx_int_BLE();
+    fxls89_xx_CallBack();
 }
-#endif
 
+#if (FXLS8974_ASCII_ALERT_MODE == 0)
 /*! *********************************************************************************
- * \brief        Get all bytes from the serial interface and send it over GATT.
+ * \brief        Sends tamper event records to all peers, in one write.
  *
- * \param[in]    pParam             Callback parameters.
+ * \details      Peers subscribed to the Tamper service get an indication or a
+ *               notification, the other running peers get the records on their
+ *               Wireless UART. The peers confirm the records, see BleApp_QueueTx.
+ *
+ * \param[in]    pRecord            Pointer to the encoded records.
+ * \param[in]    recordSize         The number of bytes in the records.
  ********************************************************************************** */
-static void BleApp_FlushUartStream
+static void BleApp_SendTamperEvent
 (
-    void *pParam
+    uint8_t *pRecord,
+    uint32_t recordSize
 )
 {
-    uint8_t *pMsg = NULL;
-    uint32_t bytesRead = 0;
+    (void)BleApp_QueueTx(pRecord, recordSize, mTxClass_Alert_c);
+}
+
+#if (FXLS8974_EVENT_BATCH_MS > 0U)
+/*! *********************************************************************************
+ * \brief        Gets the largest batch all peers take in one write or notification.
+ *
+ * \return       The size in bytes, from the smallest ATT MTU of the peers, at most
+ *               one TX queue entry.
+ ********************************************************************************** */
+static uint16_t BleApp_TamperBatchLimit(void)
+{
+    uint16_t limit = TX_QUEUE_ENTRY_SIZE;
+    uint16_t tempMtu = 0U;
     uint8_t  mPeerId = 0;
-    bool_t   mValidDevices = FALSE;
 
-    /* Valid devices are in Running state */
     for (mPeerId = 0; mPeerId < (uint8_t)gAppMaxConnections_c; mPeerId++)
     {
-        if ((gInvalidDeviceId_c != maPeerInformation[mPeerId].deviceId) &&
-            (mAppRunning_c == maPeerInformation[mPeerId].appState))
-        {
-            mValidDevices = TRUE;
-            break;
-        }
-    }
-
-    if (mValidDevices)
-    {
-        /* Allocate buffer for GATT Write */
-        pMsg = MEM_BufferAlloc(mAppUartBufferSize);
-
-        if (pMsg != NULL)
+        if (gInvalidDeviceId_c != maPeerInformation[mPeerId].deviceId)
         {
-            /* Collect the data from the serial manager buffer */
-            if (SerialManager_TryRead((serial_read_handle_t)s_readHandle, pMsg, mAppUartBufferSize, &bytesRead) == kStatus_SerialManager_Success)
-            {
-                if (bytesRead != 0U)
-                {
-                    /* Send data over the air */
-                    BleApp_SendUartStream(pMsg, (uint32_t)bytesRead);
-                }
-            }
+            tempMtu = gAttDefaultMtu_c;
+            (void)Gatt_GetMtu(mPeerId, &tempMtu);
+            tempMtu = gAttMaxNotifIndDataSize_d(tempMtu);
 
-
-            /* Free Buffer */
-            (void)MEM_BufferFree(pMsg);
+            limit = limit <= tempMtu ? limit : tempMtu;
         }
     }
 
-    mAppDapaPending = FALSE;
+    return limit;
 }
 
 /*! *********************************************************************************
- * \brief        Write bytes to serial.
+ * \brief        Adds one tamper event record to the batch.
  *
- * \param[in]    peerDeviceId       The remote device ID.
- * \param[in]    pStream            Pointer to the received stream.
- * \param[in]    streamLength       Number of bytes in the strem.
+ * \details      The batch goes out when the window ends, when it cannot take
+ *               another record or at once for an urgent record.
+ *
+ * \param[in]    pRecord            Pointer to the encoded record.
+ * \param[in]    recordSize         The number of bytes in the record.
+ * \param[in]    urgent             TRUE to send the batch without waiting.
  ********************************************************************************** */
-static void BleApp_ReceivedUartStream
+static void BleApp_QueueTamperEvent
 (
-    deviceId_t peerDeviceId,
-    uint8_t *pStream,
-    uint16_t streamLength
+    uint8_t *pRecord,
+    uint32_t recordSize,
+    bool_t urgent
 )
 {
-    static deviceId_t previousDeviceId = gInvalidDeviceId_c;
-
-    char additionalInfoBuff[10] = { '\r', '\n', '[', '0', '0', '-', 'C', ']', ':', ' '};
-    uint8_t *pBuffer = NULL;
-    uint32_t messageHeaderSize = 0;
+    uint16_t limit = BleApp_TamperBatchLimit();
 
-    if (mAppUartNewLine || (previousDeviceId != peerDeviceId))
+    if (!TamperEvent_BatchAppend(&mTamperBatch, pRecord, recordSize, limit))
     {
-        streamLength += (uint16_t)sizeof(additionalInfoBuff);
+        /* No room left for the record, send the batch first */
+        BleApp_FlushTamperBatch(NULL);
+        (void)TamperEvent_BatchAppend(&mTamperBatch, pRecord, recordSize, limit);
     }
 
-    /* Allocate buffer for asynchronous write */
-    pBuffer = MEM_BufferAlloc(streamLength);
-
-    if (pBuffer != NULL)
+    if ((TRUE == urgent) || ((mTamperBatch.length + TAMPER_EVENT_HEADER_SIZE) > limit))
     {
-        /* if this is a message from a previous device, print device ID */
-        if (mAppUartNewLine || (previousDeviceId != peerDeviceId))
-        {
-            messageHeaderSize = sizeof(additionalInfoBuff);
-
-            if (mAppUartNewLine)
-            {
-                mAppUartNewLine = FALSE;
-            }
-
-            additionalInfoBuff[3] = '0' + (peerDeviceId / 10U);
-            additionalInfoBuff[4] = '0' + (peerDeviceId % 10U);
-
-            if (gGapCentral_c != maPeerInformation[peerDeviceId].gapRole)
-            {
-                additionalInfoBuff[6] = 'P';
-            }
+        BleApp_FlushTamperBatch(NULL);
+    }
+    else if (mTamperBatch.length == recordSize)
+    {
+        /* First record of the batch, it waits at most one window */
+        (void)TM_InstallCallback((timer_handle_t)mTamperBatchTimerId, TamperBatchTimerCallback, NULL);
+        (void)TM_Start((timer_handle_t)mTamperBatchTimerId,
+                    (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, FXLS8974_EVENT_BATCH_MS);
+    }
+    else
+    {
+        ; /* Wait for the window to end */
+    }
+}
 
-            FLib_MemCpy(pBuffer, additionalInfoBuff, sizeof(additionalInfoBuff));
-        }
+/*! *********************************************************************************
+ * \brief        Sends the batch of tamper event records to all peers.
+ *
+ * \param[in]    pParam             Callback parameters.
+ ********************************************************************************** */
+static void BleApp_FlushTamperBatch
+(
+    void *pParam
+)
+{
+    (void)TM_Stop((timer_handle_t)mTamperBatchTimerId);
+    mTamperBatchPending = FALSE;
 
-        FLib_MemCpy(&pBuffer[messageHeaderSize], pStream, (uint32_t)streamLength - messageHeaderSize);
-#if (defined(SERIAL_MANAGER_NON_BLOCKING_MODE) && (SERIAL_MANAGER_NON_BLOCKING_MODE > 0U))
-        serial_manager_status_t status = SerialManager_InstallTxCallback((serial_write_handle_t)s_writeHandle, Uart_TxCallBack, pBuffer);
-        (void)status;
-        assert(kStatus_SerialManager_Success == status);
-        if(SerialManager_WriteNonBlocking((serial_write_handle_t)s_writeHandle, pBuffer, streamLength) != kStatus_SerialManager_Success)
-        {
-            (void)MEM_BufferFree(pBuffer);
-        }
-#else
-        (void)MEM_BufferFree(pBuffer);
-#endif /*SERIAL_MANAGER_NON_BLOCKING_MODE > 0U*/
+    if (0U != mTamperBatch.length)
+    {
+        BleApp_SendTamperEvent(mTamperBatch.buffer, mTamperBatch.length);
+        TamperEvent_BatchReset(&mTamperBatch);
     }
-
-    /* update the previous device ID */
-    previousDeviceId = peerDeviceId;
 }
 
 /*! *********************************************************************************
- * \brief        Timer handler for flushing the UART.
+ * \brief        Timer handler for the end of the batch window.
  *
- * \param[in]    pData              Pointer to the parameters.
+ * \param[in]    pParam             Callback parameters.
  ********************************************************************************** */
-static void UartStreamFlushTimerCallback
+static void TamperBatchTimerCallback
 (
-    void *pData
+    void *pParam
 )
 {
-    if (!mAppDapaPending)
+    if (!mTamperBatchPending)
     {
-        mAppDapaPending = TRUE;
-        (void)App_PostCallbackMessage(BleApp_FlushUartStream, NULL);
+        mTamperBatchPending = TRUE;
+        if (gBleSuccess_c != App_PostCallbackMessage(BleApp_FlushTamperBatch, NULL))
+        {
+            /* The queue is full, try again at the end of another window */
+            mTamperBatchPending = FALSE;
+            (void)TM_Start((timer_handle_t)mTamperBatchTimerId,
+                        (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, FXLS8974_EVENT_BATCH_MS);
+        }
     }
 }
+#endif /* FXLS8974_EVENT_BATCH_MS */
+#endif /* FXLS8974_ASCII_ALERT_MODE */
 
+#if (FXLS8974_BROADCAST_MODE == 1)
 /*! *********************************************************************************
-* \brief        Handles UART Receive callback.
-*
-* \param[in]    pData        Unused pointer to data.
-* \param[in]    pMessage     Unused pointer to message.
-* \param[in]    status       Unused status.
-********************************************************************************** */
-static void Uart_RxCallBack
-(
-    void *pData,
-    serial_manager_callback_message_t *pMessage,
-    serial_manager_status_t status
-)
+ * \brief        Starts the tamper beacon and the sensor, once the connectable
+ *               advertising runs.
+ *
+ * \details      The beacon first only tells the node is alive. The sensor
+ *               starts without waiting for a peer, the gateways get the alerts
+ *               from the beacon.
+ ********************************************************************************** */
+static void BleApp_StartBeacon(void)
 {
-    uint16_t byteCount = 0;
-
-    if (byteCount < mAppUartBufferSize)
-    {
-        /* Restart flush timer */
-        (void)TM_InstallCallback((timer_handle_t)mUartStreamFlushTimerId, UartStreamFlushTimerCallback, NULL);
-        (void)TM_Start((timer_handle_t)mUartStreamFlushTimerId,
-                    (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, mAppUartFlushIntervalInMs_c);
-    }
-    else
+    if (!mBeaconStarted)
     {
-        /* Post App Msg only one at a time */
-        if (!mAppDapaPending)
+        mBeaconStarted = TRUE;
+        if (gNVM_OK_c != NvRestoreDataSet(&mBeaconCounterLimit, FALSE))
         {
-            mAppDapaPending = TRUE;
-            (void)App_PostCallbackMessage(BleApp_FlushUartStream, NULL);
+            mBeaconCounterLimit = 0U;
         }
+        /* The values below the limit may have been sent before the reset */
+        mBeaconCounter = mBeaconCounterLimit;
+        BleApp_UpdateBeacon(NULL, 0U);
+        BleApp_RestartBeacon(FALSE);
+
+        fxls89xx_int_BLE();
+        fxls89_xx_CallBack();
     }
 }
 
 /*! *********************************************************************************
-* \brief        Handles UART Transmit callback.
-*
-* \param[in]    pBuffer      Pointer to the sent data.
-* \param[in]    pMessage     Unused pointer to message.
-* \param[in]    status       Unused status.
-********************************************************************************** */
-static void Uart_TxCallBack
+ * \brief        Puts new content in the tamper beacon, with the next counter
+ *               value and its MIC.
+ *
+ * \param[in]    pRecord            Pointer to the encoded record, NULL for none.
+ * \param[in]    recordSize         The number of bytes in the record.
+ ********************************************************************************** */
+static void BleApp_UpdateBeacon
 (
-    void *pBuffer,
-    serial_manager_callback_message_t *pMessage,
-    serial_manager_status_t status
+    const uint8_t *pRecord,
+    uint32_t recordSize
 )
 {
-    (void)MEM_BufferFree(pMessage->buffer);
-}
+    uint8_t mac[AES_128_BLOCK_SIZE];
+    uint32_t length;
 
+    if ((mBeaconCounter == mBeaconCounterLimit) && (FALSE == BleApp_ReserveBeaconCounter()))
+    {
+        /* Keep the last beacon rather than send a value a reset could repeat */
+        return;
+    }
+
+    length = TamperBeacon_Encode(maBeaconData, mBeaconCounter, pRecord, recordSize);
+    if (0U != length)
+    {
+        mBeaconCounter++;
+        AES_128_CMAC(maBeaconData, length, mBeaconKey, mac);
+        maBeaconAdStruct[0].length = (uint8_t)(TamperBeacon_Seal(maBeaconData, length, mac) + 1U);
+    }
+}
 
 /*! *********************************************************************************
-* \brief        Handles battery measurement timer callback.
-*
-* \param[in]    pParam        Callback parameters.
-********************************************************************************** */
-static void BatteryMeasurementTimerCallback
-(
-    void *pParam
-)
+ * \brief        Reserves the next FXLS8974_BROADCAST_COUNTER_WINDOW beacon counter
+ *               values in NVM.
+ *
+ * \return       TRUE once the new limit is saved, FALSE if the counter has to stay
+ *               below the old one.
+ ********************************************************************************** */
+static bool_t BleApp_ReserveBeaconCounter(void)
 {
-    mBasServiceConfig.batteryLevel = SENSORS_GetBatteryLevel();
-    (void)Bas_RecordBatteryMeasurement(&mBasServiceConfig);
+    uint32_t limit = mBeaconCounterLimit;
+
+    mBeaconCounterLimit = mBeaconCounter + FXLS8974_BROADCAST_COUNTER_WINDOW;
+    if (gNVM_OK_c != NvSyncSave(&mBeaconCounterLimit, FALSE))
+    {
+        mBeaconCounterLimit = limit;
+        return FALSE;
+    }
+
+    return TRUE;
 }
 
-#if defined(gUseControllerNotifications_c) && (gUseControllerNotifications_c)
 /*! *********************************************************************************
- * \brief        Function handling the Bluetooth Controller notification events.
+ * \brief        Restarts the tamper beacon with its latest content.
  *
- * \param[in]    pNotificationEvent Pointer to the notification event.
+ * \details      A burst advertises at the fast interval, the set terminates
+ *               after FXLS8974_BROADCAST_BURST_MS and goes on at the slow interval.
+ *               The interval only changes while the set is stopped, a running
+ *               set is stopped first and started again from
+ *               BleApp_AdvertisingCallback.
+ *
+ * \param[in]    burst              TRUE after an event, FALSE for slow beaconing.
  ********************************************************************************** */
-static void BleApp_HandleControllerNotification
+static void BleApp_RestartBeacon
 (
-    bleNotificationEvent_t *pNotificationEvent
+    bool_t burst
 )
 {
-    switch(pNotificationEvent->eventType)
+    if (mBeaconBusy)
     {
-        case (uint16_t)gNotifEventNone_c:
-        {
-            Serial_Print("Configured notification status ", gAllowToBlock_d);
-            Serial_PrintDec((uint32_t)pNotificationEvent->status);
-            Serial_Print("\n\r", gAllowToBlock_d);
-            break;
-        }
-
-        case (uint16_t)gNotifConnEventOver_c:
-        {
-            Serial_Print("CONN Event Over device ", gAllowToBlock_d);
-            Serial_PrintDec(pNotificationEvent->deviceId);
-            Serial_Print(" on channel ", gAllowToBlock_d);
-            Serial_PrintDec(pNotificationEvent->channel);
-            Serial_Print(" with RSSI ", gAllowToBlock_d);
-            Serial_PrintDec((uint8_t)pNotificationEvent->rssi);
-            Serial_Print(" and event counter ", gAllowToBlock_d);
-            Serial_PrintDec((uint16_t)pNotificationEvent->ce_counter);
-            Serial_Print("\n\r", gAllowToBlock_d);
-            break;
-        }
-
-        case (uint16_t)gNotifConnRxPdu_c:
-        {
-            Serial_Print("CONN Rx PDU from device ", gAllowToBlock_d);
-            Serial_PrintDec(pNotificationEvent->deviceId);
-            Serial_Print(" on channel ", gAllowToBlock_d);
-            Serial_PrintDec(pNotificationEvent->channel);
-            Serial_Print(" with RSSI ", gAllowToBlock_d);
-            Serial_PrintDec((uint8_t)pNotificationEvent->rssi);
-            Serial_Print(" with event counter ", gAllowToBlock_d);
-            Serial_PrintDec((uint16_t)pNotificationEvent->ce_counter);
-            Serial_Print(" and timestamp ", gAllowToBlock_d);
-            Serial_PrintDec(pNotificationEvent->timestamp);
-            Serial_Print("\n\r", gAllowToBlock_d);
-            break;
-        }
-
-        case (uint16_t)gNotifAdvEventOver_c:
-        {
-            Serial_Print("ADV Event Over.\n\r", gAllowToBlock_d);
-            break;
-        }
-
-        case (uint16_t)gNotifAdvTx_c:
-        {
-            Serial_Print("ADV Tx on channel ", gAllowToBlock_d);
-            Serial_PrintDec(pNotificationEvent->channel);
-            Serial_Print("\n\r", gAllowToBlock_d);
-            break;
-        }
-
-        case (uint16_t)gNotifAdvScanReqRx_c:
-        {
-            Serial_Print("ADV Rx Scan Req on channel ", gAllowToBlock_d);
-            Serial_PrintDec(pNotificationEvent->channel);
-            Serial_Print(" with RSSI ", gAllowToBlock_d);
-            Serial_PrintDec((uint8_t)pNotificationEvent->rssi);
-            Serial_Print("\n\r", gAllowToBlock_d);
-            break;
-        }
-
-        case (uint16_t)gNotifAdvConnReqRx_c:
-        {
-            Serial_Print("ADV Rx Conn Req on channel ", gAllowToBlock_d);
-            Serial_PrintDec(pNotificationEvent->channel);
-            Serial_Print(" with RSSI ", gAllowToBlock_d);
-            Serial_PrintDec((uint8_t)pNotificationEvent->rssi);
-            Serial_Print("\n\r", gAllowToBlock_d);
-            break;
-        }
-
-        case (uint16_t)gNotifScanEventOver_c:
+        /* A burst wins over slow beaconing */
+        mBeaconPending = TRUE;
+        mBeaconBurst = (mBeaconBurst || burst) ? TRUE : FALSE;
+    }
+    else
+    {
+        mBeaconBurst = burst;
+        mBeaconBusy = TRUE;
+        if (!mBeaconOn)
         {
-            Serial_Print("SCAN Event Over on channel ", gAllowToBlock_d);
-            Serial_PrintDec(pNotificationEvent->channel);
-            Serial_Print("\n\r", gAllowToBlock_d);
-            break;
+            BleApp_SetupBeacon();
         }
-
-        case (uint16_t)gNotifScanAdvPktRx_c:
+        else if (gBleSuccess_c != Gap_StopExtAdvertising(mAppBeaconHandle_c))
         {
-            Serial_Print("SCAN Rx Adv Pkt on channel ", gAllowToBlock_d);
-            Serial_PrintDec(pNotificationEvent->channel);
-            Serial_Print(" with RSSI ", gAllowToBlock_d);
-            Serial_PrintDec((uint8_t)pNotificationEvent->rssi);
-            Serial_Print("\n\r", gAllowToBlock_d);
-            break;
+            mBeaconBusy = FALSE;
         }
-
-        case (uint16_t)gNotifScanRspRx_c:
+        else
         {
-            Serial_Print("SCAN Rx Scan Rsp on channel ", gAllowToBlock_d);
-            Serial_PrintDec(pNotificationEvent->channel);
-            Serial_Print(" with RSSI ", gAllowToBlock_d);
-            Serial_PrintDec((uint8_t)pNotificationEvent->rssi);
-            Serial_Print("\n\r", gAllowToBlock_d);
-            break;
+            ; /* Started again when the set is off */
         }
+    }
+}
 
-        case (uint16_t)gNotifScanReqTx_c:
-        {
-            Serial_Print("SCAN Tx Scan Req on channel ", gAllowToBlock_d);
-            Serial_PrintDec(pNotificationEvent->channel);
-            Serial_Print("\n\r", gAllowToBlock_d);
-            break;
-        }
+/*! *********************************************************************************
+ * \brief        Sets the interval and the data of the tamper beacon and starts it.
+ ********************************************************************************** */
+static void BleApp_SetupBeacon(void)
+{
+    uint32_t interval = mBeaconBurst ? mAppAdvInterval(FXLS8974_BROADCAST_FAST_MS) : mAppAdvInterval(FXLS8974_BROADCAST_SLOW_MS);
 
-        case (uint16_t)gNotifConnCreated_c:
-        {
-            Serial_Print("CONN Created with device ", gAllowToBlock_d);
-            Serial_PrintDec(pNotificationEvent->deviceId);
-            Serial_Print(" with timestamp ", gAllowToBlock_d);
-            Serial_PrintDec(pNotificationEvent->timestamp);
-            Serial_Print("\n\r", gAllowToBlock_d);
-            break;
-        }
-        
-        case (uint16_t)gNotifConnChannelMapUpdate_c:
-        {
-            Serial_Print("Map update with device ", gAllowToBlock_d);
-            Serial_PrintDec(pNotificationEvent->deviceId);
-            Serial_Print("\n\r", gAllowToBlock_d);
-            break;
-        }
+    mBeaconAdvParams.minInterval = interval;
+    mBeaconAdvParams.maxInterval = interval;
+    /* The duration counts 10 ms units */
+    mAppBeaconParams.duration = mBeaconBurst ? (uint16_t)(FXLS8974_BROADCAST_BURST_MS / 10U) : gBleExtAdvNoDuration_c;
 
-        default:
-        {
-            ; /* No action required */
-            break;
-        }
+    if (gBleSuccess_c != BluetoothLEHost_StartExtAdvertising(&mAppBeaconParams, BleApp_AdvertisingCallback,
+                                                               BleApp_ConnectionCallback))
+    {
+        mBeaconBusy = FALSE;
     }
 }
+#endif /* FXLS8974_BROADCAST_MODE */
 
-#if defined(gUseControllerNotificationsCallback_c) && (gUseControllerNotificationsCallback_c)
 /*! *********************************************************************************
- * \brief        Function handling the controller notifications.
+ * \brief        Handle the main application state machine
  *
- * \param[in]    pNotificationEvent Pointer to the notification event.
+ * \param[in]    peerDeviceId       The remote device ID.
+ * \param[in]    event              The application event.
  ********************************************************************************** */
-static void BleApp_ControllerNotificationCallback
+static void BleApp_StateMachineHandler
 (
-    bleCtrlNotificationEvent_t *pNotificationEvent
+    deviceId_t peerDeviceId,
+    appEvent_t event
 )
 {
-    switch(pNotificationEvent->event_type)
+    uint16_t tempMtu = 0;
+    union
     {
-        case gNotifConnEventOver_c:
-        {
-            Serial_Print("CONN Ev Over\n\r", gNoBlock_d);
-            break;
-        }
+        uint8_t     *pUuidArray;
+        bleUuid_t   *pUuidObj;
+    } temp; /* MISRA rule 11.3 */
 
-        case gNotifConnRxPdu_c:
-        {
-            Serial_Print("CONN Rx PDU\n\r", gNoBlock_d);
-            break;
-        }
+    temp.pUuidArray = uuid_service_wireless_uart;
 
-        case gNotifAdvEventOver_c:
+    /* invalid client information */
+    if (maPeerInformation[peerDeviceId].deviceId != gInvalidDeviceId_c)
+    {
+        switch (maPeerInformation[peerDeviceId].appState)
         {
-            Serial_Print("ADV Ev Over\n\r", gNoBlock_d);
-            break;
-        }
-
-        case gNotifAdvTx_c:
+        case mAppIdle_c:
         {
-            Serial_Print("ADV Tx\n\r", gNoBlock_d);
-            break;
-        }
+            if (event == mAppEvt_PeerConnected_c)
+            {
+                /* Let the central device initiate the Exchange MTU procedure*/
+                if (mGapRole == gGapCentral_c)
+                {
+                    /* Moving to Exchange MTU State */
+                    maPeerInformation[peerDeviceId].appState = mAppExchangeMtu_c;
+                    (void)GattClient_ExchangeMtu(peerDeviceId, gAttMaxMtu_c);
+                }
+                else
+                {
+                    /* Moving to Service Discovery State*/
+                    maPeerInformation[peerDeviceId].appState = mAppServiceDisc_c;
 
-        case gNotifAdvScanReqRx_c:
-        {
-            Serial_Print("ADV Rx Scan Req\n\r", gNoBlock_d);
-            break;
+                    /* Start Service Discovery*/
+                    (void)BleServDisc_FindService(peerDeviceId,
+                            gBleUuidType128_c,
+                            temp.pUuidObj);
+                }
+            }
         }
+        break;
 
-        case gNotifAdvConnReqRx_c:
+        case mAppExchangeMtu_c:
         {
-            Serial_Print("ADV Rx Conn Req\n\r", gNoBlock_d);
-            break;
+            if (event == mAppEvt_GattProcComplete_c)
+            {
+                /* update stream length with minimum of maximum MTU's of connected devices */
+                (void)Gatt_GetMtu(peerDeviceId, &tempMtu);
+                tempMtu = gAttMaxWriteDataSize_d(tempMtu);
+
+                mAppUartBufferSize = mAppUartBufferSize <= tempMtu ? mAppUartBufferSize : tempMtu;
+
+                /* Moving to Service Discovery State*/
+                maPeerInformation[peerDeviceId].appState = mAppServiceDisc_c;
+
+                /* Start Service Discovery*/
+                (void)BleServDisc_FindService(peerDeviceId,
+                        gBleUuidType128_c,
+                        temp.pUuidObj);
+            }
+            else
+            {
+                if (event == mAppEvt_GattProcError_c)
+                {
+                    (void)Gap_Disconnect(peerDeviceId);
+                }
+            }
         }
+        break;
 
-        case gNotifScanEventOver_c:
+        case mAppServiceDisc_c:
         {
-            Serial_Print("SCAN Ev Over\n\r", gNoBlock_d);
-            break;
+            if (event == mAppEvt_ServiceDiscoveryComplete_c)
+            {
+                /* Moving to Running State*/
+                maPeerInformation[peerDeviceId].appState = mAppRunning_c;
+
+
+                fxls89xx_int_BLE();
+                fxls89_xx_CallBack();
+
+
+#if gAppUseBonding_d
+                union
+                {
+                    uint32_t u32;
+                    uint16_t u16;
+                } tempCast;
+
+                tempCast.u32 = sizeof(wucConfig_t);
+                /* Write data in NVM */
+                (void)Gap_SaveCustomPeerInformation(maPeerInformation[peerDeviceId].deviceId,
+                        (uint8_t *) &maPeerInformation[peerDeviceId].clientInfo, 0,
+                        tempCast.u16);
+#endif
+            }
+            else if (event == mAppEvt_ServiceDiscoveryNotFound_c)
+            {
+                /* Moving to Service discovery Retry State*/
+                maPeerInformation[peerDeviceId].appState = mAppServiceDiscRetry_c;
+                /* Restart Service Discovery for all services */
+                (void)BleServDisc_Start(peerDeviceId);
+            }
+            else if (event == mAppEvt_ServiceDiscoveryFailed_c)
+            {
+                (void)Gap_Disconnect(peerDeviceId);
+            }
+            else if (event == mAppEvt_TamperNotifyEnabled_c)
+            {
+                /* No need to wait for the Wireless UART of the peer */
+                BleApp_StartTamperNotify(peerDeviceId);
+            }
+            else
+            {
+                /* ignore other event types */
+            }
         }
+        break;
 
-        case gNotifScanAdvPktRx_c:
+        case mAppServiceDiscRetry_c:
         {
-            Serial_Print("SCAN Rx Adv\n\r", gNoBlock_d);
-            break;
+            if (event == mAppEvt_ServiceDiscoveryComplete_c)
+            {
+                /* Moving to Running State*/
+                maPeerInformation[peerDeviceId].appState = mAppRunning_c;
+            }
+            else if ((event == mAppEvt_ServiceDiscoveryNotFound_c) ||
+                    (event == mAppEvt_ServiceDiscoveryFailed_c))
+            {
+                /* A bonded peer keeps its subscription to the Tamper service */
+                if (TRUE == BleApp_TamperNotifyEnabled(peerDeviceId))
+                {
+                    BleApp_StartTamperNotify(peerDeviceId);
+                }
+                else
+                {
+                    (void)Gap_Disconnect(peerDeviceId);
+                }
+            }
+            else if (event == mAppEvt_TamperNotifyEnabled_c)
+            {
+                BleApp_StartTamperNotify(peerDeviceId);
+            }
+            else
+            {
+                /* ignore other event types */
+            }
         }
+        break;
 
-        case gNotifScanRspRx_c:
-        {
-            Serial_Print("SCAN Rx Scan Rsp\n\r", gNoBlock_d);
+        case mAppRunning_c:
             break;
-        }
 
-        case gNotifScanReqTx_c:
+        default:
         {
-            Serial_Print("SCAN Tx Scan Req\n\r", gNoBlock_d);
-            break;
+            ; /* No action required */
+        }
+        break;
         }
+    }
+}
 
-        case gNotifConnCreated_c:
+#if gWuart_CentralRole_c == 1
+/*! *********************************************************************************
+ * \brief        Handles scanning timer callback.
+ *
+ * \param[in]    pParam             Callback parameters.
+ ********************************************************************************** */
+static void ScanningTimerCallback
+(
+    void *pParam
+)
+{
+    /* Stop scanning */
+    (void)Gap_StopScanning();
+}
+#endif /* gWuart_CentralRole_c == 1 */
+
+#if (defined(gAppButtonCnt_c) && (gAppButtonCnt_c == 1))
+/*! *********************************************************************************
+ * \brief        Handles the switch press timer callback.
+ *
+ * \param[in]    pParam             Callback parameters.
+ ********************************************************************************** */
+static void SwitchPressTimerCallback
+(
+    void *pParam
+)
+{
+  if(mSwitchPressCnt >= gSwitchPressThreshold_c)
+  {
+      /* Switch the current role */
+      if (mGapRole == gGapCentral_c)
+      {
+          Serial_Print("\n\rSwitched role to GAP Peripheral.\n\r", gAllowToBlock_d);
+          mAppUartNewLine = TRUE;
+          mGapRole = gGapPeripheral_c;
+      }
+      else
+      {
+          Serial_Print("\n\rSwitched role to GAP Central.\n\r", gAllowToBlock_d);
+          mAppUartNewLine = TRUE;
+          mGapRole = gGapCentral_c;
+      }
+  }
+  else
+  {
+      /* start the application using the selected role */
+      LedStopFlashingAllLeds();
+      Led1Flashing();
+      BleApp_Start(mGapRole);
+  }
+
+  /* reset the switch press counter */
+  mSwitchPressCnt = 0;
+}
+#endif
+
+/*! *********************************************************************************
+ * \brief        Get all bytes from the serial interface and send it over GATT.
+ *
+ * \param[in]    pParam             Callback parameters.
+ ********************************************************************************** */
+static void BleApp_FlushUartStream
+(
+    void *pParam
+)
+{
+    uint8_t *pMsg = NULL;
+    uint32_t bytesRead = 0;
+    uint8_t  mPeerId = 0;
+    bool_t   mValidDevices = FALSE;
+
+    /* Valid devices are in Running state */
+    for (mPeerId = 0; mPeerId < (uint8_t)gAppMaxConnections_c; mPeerId++)
+    {
+        if ((gInvalidDeviceId_c != maPeerInformation[mPeerId].deviceId) &&
+            (mAppRunning_c == maPeerInformation[mPeerId].appState))
         {
-            Serial_Print("CONN Created\n\r", gNoBlock_d);
+            mValidDevices = TRUE;
             break;
         }
+    }
 
-        default:
+    if (mValidDevices)
+    {
+        /* Allocate buffer for GATT Write */
+        pMsg = MEM_BufferAlloc(mAppUartBufferSize);
+
+        if (pMsg != NULL)
         {
-            ; /* No action required */
-            break;
+            /* Collect the data from the serial manager buffer */
+            if (SerialManager_TryRead((serial_read_handle_t)s_readHandle, pMsg, mAppUartBufferSize, &bytesRead) == kStatus_SerialManager_Success)
+            {
+                if (bytesRead != 0U)
+                {
+                    /* Send data over the air */
+                    (void)BleApp_QueueTx(pMsg, (uint32_t)bytesRead, mTxClass_Debug_c);
+                }
+            }
+
+
+            /* Free Buffer */
+            (void)MEM_BufferFree(pMsg);
         }
     }
-}
-#endif
 
-#endif
+    mAppDapaPending = FALSE;
+}
 
 /*! *********************************************************************************
- * \brief        Function used to setup the serial interface.
+ * \brief        Write bytes to serial.
  *
+ * \param[in]    peerDeviceId       The remote device ID.
+ * \param[in]    pStream            Pointer to the received stream.
+ * \param[in]    streamLength       Number of bytes in the strem.
  ********************************************************************************** */
-static void BleApp_SerialInit(void)
+static void BleApp_ReceivedUartStream
+(
+    deviceId_t peerDeviceId,
+    uint8_t *pStream,
+    uint16_t streamLength
+)
 {
-    serial_manager_status_t status;
-    /*wireless uart serial manager handle*/
-    static serial_handle_t appSerMgrIf;
+    static deviceId_t previousDeviceId = gInvalidDeviceId_c;
 
-    /* UI */
-    appSerMgrIf = (serial_handle_t)&gSerMgrIf[0];
+    char additionalInfoBuff[10] = { '\r', '\n', '[', '0', '0', '-', 'C', ']', ':', ' '};
+    uint8_t *pBuffer = NULL;
+    uint32_t messageHeaderSize = 0;
 
-    /*open wireless uart read/write handle*/
-    status = SerialManager_OpenWriteHandle((serial_handle_t)appSerMgrIf, (serial_write_handle_t)s_writeHandle);
-    assert(kStatus_SerialManager_Success == status);
-    (void)status;
+#if mAppBusReport_c
+    /* A peer asking for the bus statistics gets them instead of the request being printed. */
+    if ((streamLength >= 4U) && FLib_MemCmp(pStream, "?bus", 4U))
+    {
+        BleApp_SendBusProfile();
+        return;
+    }
+#endif
+
+    if (mAppUartNewLine || (previousDeviceId != peerDeviceId))
+    {
+        streamLength += (uint16_t)sizeof(additionalInfoBuff);
+    }
+
+    /* Allocate buffer for asynchronous write */
+    pBuffer = MEM_BufferAlloc(streamLength);
+
+    if (pBuffer != NULL)
+    {
+        /* if this is a message from a previous device, print device ID */
+        if (mAppUartNewLine || (previousDeviceId != peerDeviceId))
+        {
+            messageHeaderSize = sizeof(additionalInfoBuff);
+
+            if (mAppUartNewLine)
+            {
+                mAppUartNewLine = FALSE;
+            }
+
+            additionalInfoBuff[3] = '0' + (peerDeviceId / 10U);
+            additionalInfoBuff[4] = '0' + (peerDeviceId % 10U);
+
+            if (gGapCentral_c != maPeerInformation[peerDeviceId].gapRole)
+            {
+                additionalInfoBuff[6] = 'P';
+            }
+
+            FLib_MemCpy(pBuffer, additionalInfoBuff, sizeof(additionalInfoBuff));
+        }
+
+        FLib_MemCpy(&pBuffer[messageHeaderSize], pStream, (uint32_t)streamLength - messageHeaderSize);
+#if (defined(SERIAL_MANAGER_NON_BLOCKING_MODE) && (SERIAL_MANAGER_NON_BLOCKING_MODE > 0U))
+        serial_manager_status_t status = SerialManager_InstallTxCallback((serial_write_handle_t)s_writeHandle, Uart_TxCallBack, pBuffer);
+        (void)status;
+        assert(kStatus_SerialManager_Success == status);
+        if(SerialManager_WriteNonBlocking((serial_write_handle_t)s_writeHandle, pBuffer, streamLength) != kStatus_SerialManager_Success)
+        {
+            (void)MEM_BufferFree(pBuffer);
+        }
+#else
+        (void)MEM_BufferFree(pBuffer);
+#endif /*SERIAL_MANAGER_NON_BLOCKING_MODE > 0U*/
+    }
+
+    /* update the previous device ID */
+    previousDeviceId = peerDeviceId;
+}
+
+#if mAppBusReport_c
+/*! *********************************************************************************
+ * \brief        Prints the bus statistics on the debug UART and sends them to the peers.
+ ********************************************************************************** */
+static void BleApp_SendBusProfile(void)
+{
+    char text[160];
+    uint32_t length;
+    uint32_t sent;
+#if (REGISTER_I2C_PROFILE == 1) && (FXLS8974_SPI_MODE == 0)
+    registeri2cprofile_t profile;
+    uint8_t i;
+
+    for (i = 0U; Register_I2C_ProfileGet(i, &profile); i++)
+    {
+        length = Register_I2C_ProfileFormat(&profile, text, sizeof(text));
+        Serial_Print(text, gAllowToBlock_d);
+        for (sent = 0U; sent < length; sent += 64U)
+        {
+            (void)BleApp_QueueTx((uint8_t *)&text[sent], ((length - sent) < 64U) ? (length - sent) : 64U, mTxClass_Debug_c);
+        }
+    }
+#endif
+#if (FXLS8974_BUS_BENCH_MODE == 1)
+    length = BusBench_Format(&mFxls89xxBench, FXLS8974_TRANSPORT_NAME, SystemCoreClock, text, sizeof(text));
+    Serial_Print(text, gAllowToBlock_d);
+    for (sent = 0U; sent < length; sent += 64U)
+    {
+        (void)BleApp_QueueTx((uint8_t *)&text[sent], ((length - sent) < 64U) ? (length - sent) : 64U, mTxClass_Debug_c);
+    }
+#endif
+}
+#endif
+
+/*! *********************************************************************************
+ * \brief        Timer handler for flushing the UART.
+ *
+ * \param[in]    pData              Pointer to the parameters.
+ ********************************************************************************** */
+static void UartStreamFlushTimerCallback
+(
+    void *pData
+)
+{
+    if (!mAppDapaPending)
+    {
+        mAppDapaPending = TRUE;
+        (void)App_PostCallbackMessage(BleApp_FlushUartStream, NULL);
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Timer handler for sending the TX queues again.
+ *
+ * \param[in]    pParam             Callback parameters.
+ ********************************************************************************** */
+static void TxRetryTimerCallback
+(
+    void *pParam
+)
+{
+    if (!mTxRetryPending)
+    {
+        mTxRetryPending = TRUE;
+        if (gBleSuccess_c != App_PostCallbackMessage(BleApp_ServiceTxQueues, NULL))
+        {
+            /* The queue is full, try again after another interval */
+            mTxRetryPending = FALSE;
+            (void)TM_Start((timer_handle_t)mTxRetryTimerId,
+                        (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, mAppTxRetryIntervalInMs_c);
+        }
+    }
+}
+
+/*! *********************************************************************************
+* \brief        Handles UART Receive callback.
+*
+* \param[in]    pData        Unused pointer to data.
+* \param[in]    pMessage     Unused pointer to message.
+* \param[in]    status       Unused status.
+********************************************************************************** */
+static void Uart_RxCallBack
+(
+    void *pData,
+    serial_manager_callback_message_t *pMessage,
+    serial_manager_status_t status
+)
+{
+    uint16_t byteCount = 0;
+
+    if (byteCount < mAppUartBufferSize)
+    {
+        /* Restart flush timer */
+        (void)TM_InstallCallback((timer_handle_t)mUartStreamFlushTimerId, UartStreamFlushTimerCallback, NULL);
+        (void)TM_Start((timer_handle_t)mUartStreamFlushTimerId,
+                    (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, mAppUartFlushIntervalInMs_c);
+    }
+    else
+    {
+        /* Post App Msg only one at a time */
+        if (!mAppDapaPending)
+        {
+            mAppDapaPending = TRUE;
+            (void)App_PostCallbackMessage(BleApp_FlushUartStream, NULL);
+        }
+    }
+}
+
+/*! *********************************************************************************
+* \brief        Handles UART Transmit callback.
+*
+* \param[in]    pBuffer      Pointer to the sent data.
+* \param[in]    pMessage     Unused pointer to message.
+* \param[in]    status       Unused status.
+********************************************************************************** */
+static void Uart_TxCallBack
+(
+    void *pBuffer,
+    serial_manager_callback_message_t *pMessage,
+    serial_manager_status_t status
+)
+{
+    (void)MEM_BufferFree(pMessage->buffer);
+}
+
+
+/*! *********************************************************************************
+* \brief        Handles battery measurement timer callback.
+*
+* \param[in]    pParam        Callback parameters.
+********************************************************************************** */
+static void BatteryMeasurementTimerCallback
+(
+    void *pParam
+)
+{
+    mBasServiceConfig.batteryLevel = SENSORS_GetBatteryLevel();
+    (void)Bas_RecordBatteryMeasurement(&mBasServiceConfig);
+}
+
+#if defined(gUseControllerNotifications_c) && (gUseControllerNotifications_c)
+/*! *********************************************************************************
+ * \brief        Function handling the Bluetooth Controller notification events.
+ *
+ * \param[in]    pNotificationEvent Pointer to the notification event.
+ ********************************************************************************** */
+static void BleApp_HandleControllerNotification
+(
+    bleNotificationEvent_t *pNotificationEvent
+)
+{
+    switch(pNotificationEvent->eventType)
+    {
+        case (uint16_t)gNotifEventNone_c:
+        {
+            Serial_Print("Configured notification status ", gAllowToBlock_d);
+            Serial_PrintDec((uint32_t)pNotificationEvent->status);
+            Serial_Print("\n\r", gAllowToBlock_d);
+            break;
+        }
+
+        case (uint16_t)gNotifConnEventOver_c:
+        {
+            Serial_Print("CONN Event Over device ", gAllowToBlock_d);
+            Serial_PrintDec(pNotificationEvent->deviceId);
+            Serial_Print(" on channel ", gAllowToBlock_d);
+            Serial_PrintDec(pNotificationEvent->channel);
+            Serial_Print(" with RSSI ", gAllowToBlock_d);
+            Serial_PrintDec((uint8_t)pNotificationEvent->rssi);
+            Serial_Print(" and event counter ", gAllowToBlock_d);
+            Serial_PrintDec((uint16_t)pNotificationEvent->ce_counter);
+            Serial_Print("\n\r", gAllowToBlock_d);
+            break;
+        }
+
+        case (uint16_t)gNotifConnRxPdu_c:
+        {
+            Serial_Print("CONN Rx PDU from device ", gAllowToBlock_d);
+            Serial_PrintDec(pNotificationEvent->deviceId);
+            Serial_Print(" on channel ", gAllowToBlock_d);
+            Serial_PrintDec(pNotificationEvent->channel);
+            Serial_Print(" with RSSI ", gAllowToBlock_d);
+            Serial_PrintDec((uint8_t)pNotificationEvent->rssi);
+            Serial_Print(" with event counter ", gAllowToBlock_d);
+            Serial_PrintDec((uint16_t)pNotificationEvent->ce_counter);
+            Serial_Print(" and timestamp ", gAllowToBlock_d);
+            Serial_PrintDec(pNotificationEvent->timestamp);
+            Serial_Print("\n\r", gAllowToBlock_d);
+            break;
+        }
+
+        case (uint16_t)gNotifAdvEventOver_c:
+        {
+            Serial_Print("ADV Event Over.\n\r", gAllowToBlock_d);
+            break;
+        }
+
+        case (uint16_t)gNotifAdvTx_c:
+        {
+            Serial_Print("ADV Tx on channel ", gAllowToBlock_d);
+            Serial_PrintDec(pNotificationEvent->channel);
+            Serial_Print("\n\r", gAllowToBlock_d);
+            break;
+        }
+
+        case (uint16_t)gNotifAdvScanReqRx_c:
+        {
+            Serial_Print("ADV Rx Scan Req on channel ", gAllowToBlock_d);
+            Serial_PrintDec(pNotificationEvent->channel);
+            Serial_Print(" with RSSI ", gAllowToBlock_d);
+            Serial_PrintDec((uint8_t)pNotificationEvent->rssi);
+            Serial_Print("\n\r", gAllowToBlock_d);
+            break;
+        }
+
+        case (uint16_t)gNotifAdvConnReqRx_c:
+        {
+            Serial_Print("ADV Rx Conn Req on channel ", gAllowToBlock_d);
+            Serial_PrintDec(pNotificationEvent->channel);
+            Serial_Print(" with RSSI ", gAllowToBlock_d);
+            Serial_PrintDec((uint8_t)pNotificationEvent->rssi);
+            Serial_Print("\n\r", gAllowToBlock_d);
+            break;
+        }
+
+        case (uint16_t)gNotifScanEventOver_c:
+        {
+            Serial_Print("SCAN Event Over on channel ", gAllowToBlock_d);
+            Serial_PrintDec(pNotificationEvent->channel);
+            Serial_Print("\n\r", gAllowToBlock_d);
+            break;
+        }
+
+        case (uint16_t)gNotifScanAdvPktRx_c:
+        {
+            Serial_Print("SCAN Rx Adv Pkt on channel ", gAllowToBlock_d);
+            Serial_PrintDec(pNotificationEvent->channel);
+            Serial_Print(" with RSSI ", gAllowToBlock_d);
+            Serial_PrintDec((uint8_t)pNotificationEvent->rssi);
+            Serial_Print("\n\r", gAllowToBlock_d);
+            break;
+        }
+
+        case (uint16_t)gNotifScanRspRx_c:
+        {
+            Serial_Print("SCAN Rx Scan Rsp on channel ", gAllowToBlock_d);
+            Serial_PrintDec(pNotificationEvent->channel);
+            Serial_Print(" with RSSI ", gAllowToBlock_d);
+            Serial_PrintDec((uint8_t)pNotificationEvent->rssi);
+            Serial_Print("\n\r", gAllowToBlock_d);
+            break;
+        }
+
+        case (uint16_t)gNotifScanReqTx_c:
+        {
+            Serial_Print("SCAN Tx Scan Req on channel ", gAllowToBlock_d);
+            Serial_PrintDec(pNotificationEvent->channel);
+            Serial_Print("\n\r", gAllowToBlock_d);
+            break;
+        }
+
+        case (uint16_t)gNotifConnCreated_c:
+        {
+            Serial_Print("CONN Created with device ", gAllowToBlock_d);
+            Serial_PrintDec(pNotificationEvent->deviceId);
+            Serial_Print(" with timestamp ", gAllowToBlock_d);
+            Serial_PrintDec(pNotificationEvent->timestamp);
+            Serial_Print("\n\r", gAllowToBlock_d);
+            break;
+        }
+        
+        case (uint16_t)gNotifConnChannelMapUpdate_c:
+        {
+            Serial_Print("Map update with device ", gAllowToBlock_d);
+            Serial_PrintDec(pNotificationEvent->deviceId);
+            Serial_Print("\n\r", gAllowToBlock_d);
+            break;
+        }
+
+        default:
+        {
+            ; /* No action required */
+            break;
+        }
+    }
+}
+
+#if defined(gUseControllerNotificationsCallback_c) && (gUseControllerNotificationsCallback_c)
+/*! *********************************************************************************
+ * \brief        Function handling the controller notifications.
+ *
+ * \param[in]    pNotificationEvent Pointer to the notification event.
+ ********************************************************************************** */
+static void BleApp_ControllerNotificationCallback
+(
+    bleCtrlNotificationEvent_t *pNotificationEvent
+)
+{
+    switch(pNotificationEvent->event_type)
+    {
+        case gNotifConnEventOver_c:
+        {
+            Serial_Print("CONN Ev Over\n\r", gNoBlock_d);
+            break;
+        }
+
+        case gNotifConnRxPdu_c:
+        {
+            Serial_Print("CONN Rx PDU\n\r", gNoBlock_d);
+            break;
+        }
+
+        case gNotifAdvEventOver_c:
+        {
+            Serial_Print("ADV Ev Over\n\r", gNoBlock_d);
+            break;
+        }
+
+        case gNotifAdvTx_c:
+        {
+            Serial_Print("ADV Tx\n\r", gNoBlock_d);
+            break;
+        }
+
+        case gNotifAdvScanReqRx_c:
+        {
+            Serial_Print("ADV Rx Scan Req\n\r", gNoBlock_d);
+            break;
+        }
+
+        case gNotifAdvConnReqRx_c:
+        {
+            Serial_Print("ADV Rx Conn Req\n\r", gNoBlock_d);
+            break;
+        }
+
+        case gNotifScanEventOver_c:
+        {
+            Serial_Print("SCAN Ev Over\n\r", gNoBlock_d);
+            break;
+        }
+
+        case gNotifScanAdvPktRx_c:
+        {
+            Serial_Print("SCAN Rx Adv\n\r", gNoBlock_d);
+            break;
+        }
+
+        case gNotifScanRspRx_c:
+        {
+            Serial_Print("SCAN Rx Scan Rsp\n\r", gNoBlock_d);
+            break;
+        }
+
+        case gNotifScanReqTx_c:
+        {
+            Serial_Print("SCAN Tx Scan Req\n\r", gNoBlock_d);
+            break;
+        }
+
+        case gNotifConnCreated_c:
+        {
+            Serial_Print("CONN Created\n\r", gNoBlock_d);
+            break;
+        }
+
+        default:
+        {
+            ; /* No action required */
+            break;
+        }
+    }
+}
+#endif
+
+#endif
+
+/*! *********************************************************************************
+ * \brief        Function used to setup the serial interface.
+ *
+ ********************************************************************************** */
+static void BleApp_SerialInit(void)
+{
+    serial_manager_status_t status;
+    /*wireless uart serial manager handle*/
+    static serial_handle_t appSerMgrIf;
+
+    /* UI */
+    appSerMgrIf = (serial_handle_t)&gSerMgrIf[0];
+
+    /*open wireless uart read/write handle*/
+    status = SerialManager_OpenWriteHandle((serial_handle_t)appSerMgrIf, (serial_write_handle_t)s_writeHandle);
+    assert(kStatus_SerialManager_Success == status);
+    (void)status;
+
+    status = SerialManager_OpenReadHandle((serial_handle_t)appSerMgrIf, (serial_read_handle_t)s_readHandle);
+    assert(kStatus_SerialManager_Success == status);
+    status = SerialManager_InstallRxCallback((serial_read_handle_t)s_readHandle, Uart_RxCallBack, NULL);
+    assert(kStatus_SerialManager_Success == status);
+}
+
+/*! *********************************************************************************
+ * \brief        Function handling the initialization complete event of the Bluetooth LE Host stack.
+ *
+ ********************************************************************************** */
+static void BluetoothLEHost_Initialized(void)
+{
+    uint8_t peerId = 0;
+
+    /* Common GAP configuration */
+    BleConnManager_GapCommonConfig();
+
+    /* Register for callbacks */
+    (void)App_RegisterGattServerCallback(BleApp_GattServerCallback);
+    (void)App_RegisterGattClientProcedureCallback(BleApp_GattClientCallback);
+    (void)GattServer_RegisterHandlesForWriteNotifications(NumberOfElements(mCharMonitoredHandles), mCharMonitoredHandles);
+    BleServDisc_RegisterCallback(BleApp_ServiceDiscoveryCallback);
+    mcActiveConnNo = 0U;
+    for (peerId = 0; peerId < (uint8_t)gAppMaxConnections_c; peerId++)
+    {
+        maPeerInformation[peerId].deviceId = gInvalidDeviceId_c;
+        maPeerInformation[peerId].appState = mAppIdle_c;
+        maPeerInformation[peerId].clientInfo.hService = gGattDbInvalidHandleIndex_d;
+        maPeerInformation[peerId].clientInfo.hUartStream = gGattDbInvalidHandleIndex_d;
+    }
+
+#if (gWuart_AutoStart_c == 1)
+    mGapRole = gWuart_AutoStartGapRole_c;
+#else
+    /* By default, always start node as GAP central */
+#if gWuart_CentralRole_c == 1
+    mGapRole = gGapCentral_c;
+#else
+    mGapRole = gGapPeripheral_c;
+#endif /* gWuart_CentralRole_c */
+#endif /* gWuart_AutoStart_c */
+
+#if (defined(gAppButtonCnt_c) && (gAppButtonCnt_c == 1))
+    Serial_Print("\n\rWireless UART starting as GAP Central.\n\r", gAllowToBlock_d);
+    Serial_Print("\n\rWithin one second, either:\n\r", gAllowToBlock_d);
+    Serial_Print(" - double press the switch to change the role or\n\r", gAllowToBlock_d);
+    Serial_Print(" - single press to start the application with the selected role.\n\r", gAllowToBlock_d);
+#else
+    if (mGapRole == gGapCentral_c)
+    {
+        Serial_Print("\n\rWireless UART starting as GAP Central.\n\r", gAllowToBlock_d);
+    }
+    else
+    {
+        Serial_Print("\n\rWireless UART starting as GAP Peripheral.\n\r", gAllowToBlock_d);
+    }
+#endif
+#if gWuart_PeripheralRole_c == 1
+    mAdvState.advOn = FALSE;
+#endif /* gWuart_PeripheralRole_c */
+
+#if gWuart_CentralRole_c == 1
+    mScanningOn = FALSE;
+#endif /* gWuart_CentralRole_c */
+
+    /* Start services */
+    (void)Wus_Start(&mWuServiceConfig);
+
+    mBasServiceConfig.batteryLevel = SENSORS_GetBatteryLevel();
+    (void)Bas_Start(&mBasServiceConfig);
+
+    /* Allocate application timer */
+    (void)TM_Open(mAppTimerId);
+    (void)TM_Open(mUartStreamFlushTimerId);
+    (void)TM_Open(mTxRetryTimerId);
+#if (FXLS8974_ASCII_ALERT_MODE == 0) && (FXLS8974_EVENT_BATCH_MS > 0U)
+    (void)TM_Open(mTamperBatchTimerId);
+#endif
+    (void)TM_Open(mBatteryMeasurementTimerId);
+    (void)TM_Open(mFxls89xxId);
+
+#if (gAppButtonCnt_c == 1)
+    (void)TM_Open(mSwitchPressTimerId);
+#endif
+
+#if !(defined(cPWR_UsePowerDownMode) && (cPWR_UsePowerDownMode))
+    LedStartFlashingAllLeds();
+#endif
+#if (gWuart_AutoStart_c == 1)
+    BleApp_Start(mGapRole);
+#endif
+}
+
+/*! *********************************************************************************
+ * \brief        Function handling the geeneric events from the host stack.
+ *
+ ********************************************************************************** */
+static void BluetoothLEHost_GenericCallback(gapGenericEvent_t *pGenericEvent)
+{
+    /* Call BLE Conn Manager */
+    BleConnManager_GenericEvent(pGenericEvent);
+
+#if defined(gUseControllerNotifications_c) && (gUseControllerNotifications_c)
+    if (pGenericEvent->eventType == gControllerNotificationEvent_c)
+    {
+        BleApp_HandleControllerNotification(&pGenericEvent->eventData.notifEvent);
+    }
+#endif /* gUseControllerNotifications_c */
+    if(pGenericEvent->eventType == gInternalError_c)
+    {
+        if((pGenericEvent->eventData.internalError.errorCode == gBleOverflow_c) && (pGenericEvent->eventData.internalError.errorSource == gAddNewConnection_c))
+        {
+            Serial_Print("Connection failed ", gAllowToBlock_d);
+#if gWuart_PeripheralRole_c == 1
+            if(mAdvState.advOn)
+            {
+                mAdvState.advOn = FALSE;
+                Serial_Print(" as peripheral.\n\r", gAllowToBlock_d);
+            }
+            else
+#endif /* gWuart_PeripheralRole_c == 1 */
+            {
+#if gWuart_CentralRole_c == 1
+                Serial_Print(" as central.\n\r", gAllowToBlock_d);
+#endif /* gWuart_CentralRole_c == 1 */
+
+            }
+        }
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Applies the motion detection configuration of the FXLS89xx variant found at init.
+ *
+ * \param[in]    pDriver     FXLS8974 driver handle.
+ *
+ * \return       SENSOR_ERROR_NONE on success, SENSOR_ERROR_INIT if the variant lacks a feature of the build.
+ ********************************************************************************** */
+static int32_t fxls89xx_configure(fxls8974_sensorhandle_t *pDriver)
+{
+    int32_t status;
+
+    if (NULL == pFxls89xxVariant)
+    {
+        return SENSOR_ERROR_BAD_ADDRESS;
+    }
+    /* The configuration runs the part at a fixed Wake ODR, the time stamps and the windows count on it. */
+    if (FXLS8974_WAKE_ODR_HZ > pFxls89xxVariant->maxOdr)
+    {
+        return SENSOR_ERROR_INIT;
+    }
+#if (FXLS8974_FIFO_CAPTURE_MODE == 1)
+    if ((0U == (pFxls89xxVariant->caps & SENSOR_CAP_BUFFER)) || (FXLS8974_FIFO_WATERMARK > pFxls89xxVariant->bufDepth))
+    {
+        return SENSOR_ERROR_INIT;
+    }
+    /* A drain never asks for more samples than the buffer of the part holds. */
+    mFxls89xxBufDepth = (pFxls89xxVariant->bufDepth < FXLS8974_BUF_MAX_SAMPLES) ? pFxls89xxVariant->bufDepth :
+                                                                                  FXLS8974_BUF_MAX_SAMPLES;
+#endif
+#if (FXLS8974_ORIENT_MODE == 1)
+    if (0U == (pFxls89xxVariant->caps & SENSOR_CAP_ORIENT))
+    {
+        return SENSOR_ERROR_INIT;
+    }
+#endif
+
+    status = FXLS8974_Configure(pDriver, pFxls89xxVariant->pConfig);
+#if (FXLS8974_ORIENT_MODE == 1)
+    if (SENSOR_ERROR_NONE == status)
+    {
+        status = FXLS8974_Configure(pDriver, cFxls8974OrientConfig);
+    }
+#endif
+
+    return status;
+}
+
+/*! *********************************************************************************
+ * \brief        Sets what the CPU does while a transfer of the FXLS8974 is on the bus.
+ *
+ * \param[in]    pDriver     FXLS8974 driver handle.
+ ********************************************************************************** */
+static void fxls89xx_idle_init(fxls8974_sensorhandle_t *pDriver)
+{
+#if (FXLS8974_BUS_DMA_EN == 1)
+    /*! Sleep in WFI while eDMA moves the data instead of spinning on the completion flag. */
+#if (FXLS8974_BUS_BENCH_MODE == 1)
+    FXLS8974_SetIdleTask(pDriver, fxls89xx_bench_idle, &pDriver->deviceInfo);
+#else
+    FXLS8974_SetIdleTask(pDriver, FXLS8974_WaitForInterrupt, &pDriver->deviceInfo);
+#endif
+#else
+    /*! Interrupt per byte, the CPU spins on the completion flag. */
+    (void)pDriver;
+#endif
+}
+
+#if (FXLS8974_BUS_BENCH_MODE == 1) && (FXLS8974_BUS_DMA_EN == 1)
+/*! *********************************************************************************
+ * \brief        Idle task of the benchmark, sleeps like the transport does and counts the time asleep.
+ *
+ * \param[in]    pDevInfo    Device info of the FXLS8974.
+ ********************************************************************************** */
+static void fxls89xx_bench_idle(void *pDevInfo)
+{
+    uint32_t start = BUS_BENCH_NOW();
+
+    FXLS8974_WaitForInterrupt(pDevInfo);
+    BusBench_AddSleep(&mFxls89xxBench, BUS_BENCH_NOW() - start);
+}
+#endif
+
+#if (FXLS8974_SPI_MODE == 1)
+/*! *********************************************************************************
+ * \brief        Sets up the FXLS8974 on the SPI bus, it is the only device there so there is no engine to probe it.
+ *
+ * \param[out]   pWhoAmI     WHO_AM_I value read from the part.
+ *
+ * \return       SENSOR_ERROR_NONE on success.
+ ********************************************************************************** */
+static int32_t fxls89xx_spi_init(uint8_t *pWhoAmI)
+{
+    int32_t status;
+
+    *pWhoAmI = 0U;
+    status = FXLS8974_SPI_Initialize(&fxls8974Driver, SPIdrv, SPI_S_DEVICE_INDEX, &FXLS8974_SPI_CS, pWhoAmI);
+    if (SENSOR_ERROR_NONE != status)
+    {
+        return status;
+    }
+    fxls89xxWhoAmI = *pWhoAmI;
+    pFxls89xxVariant = SensorRegistry_Find(cFxls89xxVariants, SENSOR_REGISTRY_COUNT(cFxls89xxVariants), *pWhoAmI);
+    fxls89xx_idle_init(&fxls8974Driver);
+
+    return fxls89xx_configure(&fxls8974Driver);
+}
+#else
+/*! *********************************************************************************
+ * \brief        Sensor engine hook, looks up the variant and sets up the FXLS8974 driver once the probe found it.
+ *
+ * \param[in]    pSlot       Engine slot of the FXLS8974.
+ *
+ * \return       SENSOR_ERROR_NONE on success.
+ ********************************************************************************** */
+static int32_t fxls89xx_engine_init(sensorengineslot_t *pSlot)
+{
+    int32_t status;
+    uint8_t whoami;
+    fxls8974_i2c_sensorhandle_t *pDriver = (fxls8974_i2c_sensorhandle_t *)pSlot->pHandle;
+
+    fxls89xxWhoAmI = pSlot->whoAmI;
+    pFxls89xxVariant = SensorRegistry_Find(cFxls89xxVariants, SENSOR_REGISTRY_COUNT(cFxls89xxVariants), pSlot->whoAmI);
+    status = FXLS8974_I2C_Initialize(pDriver, I2Cdrv, pSlot->pEngine->deviceInstance, pSlot->pOps->slaveAddress,
+                                     &whoami);
+    if (SENSOR_ERROR_NONE != status)
+    {
+        return status;
+    }
+    Register_I2C_AttachCache(&pDriver->deviceInfo, &fxls8974RegCache);
+    fxls89xx_idle_init(pDriver);
+    pSlot->pDevInfo = &pDriver->deviceInfo;
+
+    return SENSOR_ERROR_NONE;
+}
+
+/*! *********************************************************************************
+ * \brief        Sensor engine hook, applies the motion detection configuration.
+ *
+ * \param[in]    pSlot       Engine slot of the FXLS8974.
+ *
+ * \return       SENSOR_ERROR_NONE on success.
+ ********************************************************************************** */
+static int32_t fxls89xx_engine_configure(sensorengineslot_t *pSlot)
+{
+    return fxls89xx_configure((fxls8974_sensorhandle_t *)pSlot->pHandle);
+}
+
+#if (FXLS8974_MULTI_SENSOR_MODE == 1)
+/*! *********************************************************************************
+ * \brief        Sensor engine hook, runs the SLEEP/WAKE state machine on the SYS_MODE value of the round.
+ *
+ * \param[in]    pSlot       Engine slot of the FXLS8974.
+ ********************************************************************************** */
+static void fxls89xx_engine_decode(sensorengineslot_t *pSlot)
+{
+    if (ARM_DRIVER_OK != pSlot->status)
+    {
+        return;
+    }
+
+    mFxls89xxSysMode = pSlot->pollData[0];
+    (void)fxls89xx_handle_mode(mFxls89xxSysMode);
+}
+
+/*! The engine polls SYS_MODE in the same round as the pressure and the field. */
+static const sensorengineops_t cFxls8974EngineOps = {
+    .slaveAddress = FXLS8974_I2C_ADDR,
+    .whoAmIReg = FXLS8974_WHO_AM_I,
+    .pWhoAmIValues = cFxls8974WhoAmI,
+    .numWhoAmIValues = sizeof(cFxls8974WhoAmI),
+    .init = fxls89xx_engine_init,
+    .configure = fxls89xx_engine_configure,
+    .pPollList = cFxls8974ReadSysMode,
+    .decode = fxls89xx_engine_decode,
+};
+#else
+/*! The FXLS8974 reports on its interrupt lines, the engine does not poll it. */
+static const sensorengineops_t cFxls8974EngineOps = {
+    .slaveAddress = FXLS8974_I2C_ADDR,
+    .whoAmIReg = FXLS8974_WHO_AM_I,
+    .pWhoAmIValues = cFxls8974WhoAmI,
+    .numWhoAmIValues = sizeof(cFxls8974WhoAmI),
+    .init = fxls89xx_engine_init,
+    .configure = fxls89xx_engine_configure,
+    .pPollList = NULL,
+    .decode = NULL,
+};
+#endif /* FXLS8974_MULTI_SENSOR_MODE */
+#endif /* FXLS8974_SPI_MODE */
+
+
+int fxls89xx_int_BLE(void)
+    {
+
+        int32_t status;
+#if (FXLS8974_SPI_MODE == 1)
+        uint8_t whoami;
+#endif
+        uint8_t descriptor[SENSOR_DESCRIPTOR_SIZE];
+        bool present;
+#if (FXLS8974_MULTI_SENSOR_MODE == 1)
+        const sensorvariant_t *pVariant;
+        uint8_t slot;
+#endif
+
+        BleApp_SendUartStream(&vec_init[0], 70U);
+        pFxls89xxVariant = NULL;
+        fxls89xxWhoAmI = 0U;
+
+#if (FXLS8974_BUS_DMA_EN == 1)
+        /*! The CMSIS driver moves the sensor data through eDMA, bring the controller up first. */
+        edma_config_t edmaConfig;
+        EDMA_GetDefaultConfig(&edmaConfig);
+        EDMA_Init(FXLS8974_BUS_DMA_BASE, &edmaConfig);
+#endif
+
+#if (FXLS8974_SPI_MODE == 1)
+        /*! Initialize the SPI driver. */
+        status = SPIdrv->Initialize(SPI_S_SIGNAL_EVENT);
+        if (ARM_DRIVER_OK != status)
+        {
+        	BleApp_SendUartStream(&vec_i2c_init[0], 70U);
+            return -1;
+        }
+
+        /*! Set the SPI Power mode. */
+        status = SPIdrv->PowerControl(ARM_POWER_FULL);
+        if (ARM_DRIVER_OK != status)
+        {
+        	BleApp_SendUartStream(&vec_power_cont[0], 70U);
+            return -1;
+        }
+
+        /*! Set the SPI Slave speed, mode 0, the chip select is a GPIO driven by the sensor driver. */
+        status = SPIdrv->Control(ARM_SPI_MODE_MASTER | ARM_SPI_CPOL0_CPHA0, FXLS8974_SPI_BAUDRATE);
+        if (ARM_DRIVER_OK != status)
+        {
+        	BleApp_SendUartStream(&vec_mode_cont[0], 70U);
+            return -1;
+        }
+#else
+        /*! Initialize the I2C driver. */
+        status = I2Cdrv->Initialize(I2C_S_SIGNAL_EVENT);
+        if (ARM_DRIVER_OK != status)
+        {
+
+        	BleApp_SendUartStream(&vec_i2c_init[0], 70U);
+
+            return -1;
+        }
+
+        /*! Set the I2C Power mode. */
+        status = I2Cdrv->PowerControl(ARM_POWER_FULL);
+        if (ARM_DRIVER_OK != status)
+        {
+
+        	BleApp_SendUartStream(&vec_power_cont[0], 70U);
+
+            return -1;
+        }
+
+        /*! Set the I2C bus speed. */
+        status = I2Cdrv->Control(ARM_I2C_BUS_SPEED, ARM_I2C_BUS_SPEED_FAST);
+        if (ARM_DRIVER_OK != status)
+        {
+        	BleApp_SendUartStream(&vec_mode_cont[0], 70U);
+
+            return -1;
+        }
+#if (REGISTER_I2C_PROFILE == 1)
+        /*! Count the bus cost of this session from here. */
+        Register_I2C_ProfileReset();
+#endif
+#endif /* FXLS8974_SPI_MODE */
+#if (FXLS8974_BUS_BENCH_MODE == 1)
+        BusBench_Reset(&mFxls89xxBench);
+#endif
+
+        /* Init output LED GPIO. */
+        GPIO_PinInit(BOARD_INITPINS_LED_GREEN_GPIO, BOARD_INITPINS_LED_GREEN_PIN, &led_config);
+        GPIO_PinInit(BOARD_INITPINS_LED_BLUE_GPIO, BOARD_INITPINS_LED_BLUE_PIN, &led_config);
+        GPIO_PinInit(BOARD_INITPINS_LED_RED_GPIO, BOARD_INITPINS_LED_RED_PIN, &led_config);
+
+#if (FXLS8974_SPI_MODE == 1)
+        present = (SENSOR_ERROR_NONE == fxls89xx_spi_init(&whoami));
+#else
+        /*! Probe the bus, the FXLS8974 driver is initialized and configured once its WHO_AM_I answers. */
+        fxls8974Slots[0].pOps = &cFxls8974EngineOps;
+        fxls8974Slots[0].pHandle = &fxls8974Driver;
+#if (FXLS8974_MULTI_SENSOR_MODE == 1)
+        /*! The pressure and magnet nodes share the bus, the same probe finds them. */
+        MultiSensor_Init(&fxls8974Multi, fxls8974Slots, fxls89xx_multi_event);
+#endif
+        SensorEngine_Init(&fxls8974Engine, I2Cdrv, I2C_S_DEVICE_INDEX, fxls8974Slots, FXLS8974_ENGINE_SLOTS);
+        (void)SensorEngine_Probe(&fxls8974Engine);
+        present = fxls8974Slots[0].present;
+#endif
+
+        if (NULL == pFxls89xxVariant)
+        {
+        	BleApp_SendUartStream(&vec_whoiam[0], 70U);
+
+            return -1;
+        }
+        /*! Tell the peers which part answered and what it can do. */
+        BleApp_SendUartStream(descriptor, SensorRegistry_Describe(pFxls89xxVariant, fxls89xxWhoAmI, descriptor));
+        Serial_Print("\n\rSensor ", gAllowToBlock_d);
+        Serial_Print(pFxls89xxVariant->pName, gAllowToBlock_d);
+        Serial_Print("\n\r", gAllowToBlock_d);
+
+        if (!present)
+        {
+        	BleApp_SendUartStream(&vec_sensor_err[0], 70U);
+            return -1;
+        }
+    	BleApp_SendUartStream(&vec_sensor_succ[0], 70U);
+#if (FXLS8974_MULTI_SENSOR_MODE == 1)
+        for (slot = MULTI_SENSOR_SLOT_PRESSURE; slot < MULTI_SENSOR_SLOTS; slot++)
+        {
+            pVariant = MultiSensor_Variant(&fxls8974Slots[slot]);
+            if (NULL != pVariant)
+            {
+                BleApp_SendUartStream(descriptor,
+                                      SensorRegistry_Describe(pVariant, fxls8974Slots[slot].whoAmI, descriptor));
+                Serial_Print("Sensor ", gAllowToBlock_d);
+                Serial_Print(pVariant->pName, gAllowToBlock_d);
+                Serial_Print("\n\r", gAllowToBlock_d);
+            }
+        }
+#endif
+
+#if (FXLS8974_WAKE_IRQ_MODE == 0)
+        PollSched_Init(&mFxls89xxPoll, &cFxls8974PollConfig);
+#endif
+#if (FXLS8974_WAKE_IRQ_MODE == 1)
+        /*! Route WAKE_OUT on INT1 to the MCU so mode changes are handled on the pin edge. */
+        if (0 != fxls89xx_irq_init())
+        {
+            return -1;
+        }
+#endif
+#if (FXLS8974_FIFO_CAPTURE_MODE == 1)
+        /*! Route the buffer watermark on INT2 to the MCU, it stays masked until the next WAKE. */
+        if (0 != fxls89xx_buf_init())
+        {
+            return -1;
+        }
+#endif
+#if (FXLS8974_SNAPSHOT_MODE == 1)
+        fxls89xx_snapshot_init();
+#endif
+#if (FXLS8974_TEMP_COMP_MODE == 1)
+        fxls89xx_temp_comp_init();
+#endif
+
+        return 0;
+    }
+
+
+void fxls89_xx_CallBack()
+{
+
+		(void)TM_InstallCallback((timer_handle_t)mFxls89xxId, fxls89_xx_TimerCallback, NULL);
+
+#if (FXLS8974_WAKE_IRQ_MODE == 1)
+        /* INT1 delivers the mode changes, the timer only guards against a missed edge. */
+        (void)TM_Start((timer_handle_t)mFxls89xxId,
+                    (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, mfxls89xxWatchdogIntervalInMs_c);
+#else
+        (void)TM_Start((timer_handle_t)mFxls89xxId,
+                    (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, PollSched_Interval(&mFxls89xxPoll));
+#endif
+        status_ble = 0;
+
+
+}
+
+void fxls89_xx_TimerCallback()
+	{
+	    (void)fxls89xx_event_BLE();
+	    fxls89_xx_CallBack();
+	}
+
+#if (FXLS8974_WAKE_IRQ_MODE == 1)
+/*! *********************************************************************************
+ * \brief        Configures the FXLS8974 INT1 pin as a wake-up capable interrupt source.
+ *
+ * \return       0 on success, -1 if the GPIO adapter rejected the pin.
+ ********************************************************************************** */
+static int fxls89xx_irq_init(void)
+{
+    hal_gpio_pin_config_t int1Config = {
+        kHAL_GpioDirectionIn,
+        0U,
+        (uint8_t)FXLS8974_INT1_PORT_NUM,
+        (uint8_t)FXLS8974_INT1_PIN,
+    };
+
+    /* The pin survives reconnections, only configure it once. */
+    if (TRUE == mFxls89xxIrqReady)
+    {
+        return 0;
+    }
+
+    PORT_SetPinMux(FXLS8974_INT1_PORT, FXLS8974_INT1_PIN, kPORT_MuxAsGpio);
+
+    if (kStatus_HAL_GpioSuccess != HAL_GpioInit((hal_gpio_handle_t)mFxls89xxInt1Handle, &int1Config))
+    {
+        return -1;
+    }
+    (void)HAL_GpioInstallCallback((hal_gpio_handle_t)mFxls89xxInt1Handle, fxls89xx_Int1Callback, NULL);
+
+    /* WAKE_OUT is active high: rising edge on SLEEP->WAKE, falling edge on WAKE->SLEEP. */
+    (void)HAL_GpioSetTriggerMode((hal_gpio_handle_t)mFxls89xxInt1Handle, kHAL_GpioInterruptEitherEdge);
+    (void)HAL_GpioWakeUpSetting((hal_gpio_handle_t)mFxls89xxInt1Handle, 1U);
+
+    mFxls89xxIrqReady = TRUE;
+
+    return 0;
+}
+
+/*! *********************************************************************************
+ * \brief        INT1 interrupt callback, runs in interrupt context.
+ *
+ * \param[in]    pParam      Unused.
+ ********************************************************************************** */
+static void fxls89xx_Int1Callback(void *pParam)
+{
+    (void)pParam;
+
+    /* Defer the bus traffic to the application task, one message per burst of edges. */
+    if (!mFxls89xxIrqPending)
+    {
+        mFxls89xxIrqPending = TRUE;
+        if (gBleSuccess_c != App_PostCallbackMessage(fxls89xx_Int1Handler, NULL))
+        {
+            /* The queue is full, let the next edge try again. */
+            mFxls89xxIrqPending = FALSE;
+        }
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Deferred INT1 handler, runs in the application task.
+ *
+ * \param[in]    pParam      Unused.
+ ********************************************************************************** */
+static void fxls89xx_Int1Handler(void *pParam)
+{
+    uint8_t pinLevel = 0U;
+
+    (void)pParam;
+
+    /* A SYS_MODE poll is still on the bus, its completion runs this handler again. */
+    if (fxls89xx_DeferIrq(mfxls89xxDeferInt1_c))
+    {
+        return;
+    }
+    mFxls89xxIrqPending = FALSE;
+
+    /* The WAKE_OUT level mirrors SYS_MODE, so no SYS_MODE read is needed here. */
+    (void)HAL_GpioGetInput((hal_gpio_handle_t)mFxls89xxInt1Handle, &pinLevel);
+    (void)fxls89xx_handle_mode((0U != pinLevel) ? FXLS8974_SYS_MODE_SYS_MODE_WAKE : FXLS8974_SYS_MODE_SYS_MODE_SLEEP);
+}
+#endif /* FXLS8974_WAKE_IRQ_MODE */
+
+#if (FXLS8974_FIFO_CAPTURE_MODE == 1)
+/*! *********************************************************************************
+ * \brief        Configures the FXLS8974 INT2 pin for the sample buffer watermark interrupt.
+ *
+ * \return       0 on success, -1 if the GPIO adapter rejected the pin.
+ ********************************************************************************** */
+static int fxls89xx_buf_init(void)
+{
+    hal_gpio_pin_config_t int2Config = {
+        kHAL_GpioDirectionIn,
+        0U,
+        (uint8_t)FXLS8974_INT2_PORT_NUM,
+        (uint8_t)FXLS8974_INT2_PIN,
+    };
+
+    if (TRUE == mFxls89xxBufReady)
+    {
+        return 0;
+    }
+
+    PORT_SetPinMux(FXLS8974_INT2_PORT, FXLS8974_INT2_PIN, kPORT_MuxAsGpio);
+
+    if (kStatus_HAL_GpioSuccess != HAL_GpioInit((hal_gpio_handle_t)mFxls89xxInt2Handle, &int2Config))
+    {
+        return -1;
+    }
+    (void)HAL_GpioInstallCallback((hal_gpio_handle_t)mFxls89xxInt2Handle, fxls89xx_Int2Callback, NULL);
+
+    /* Keep the watermark masked while the sensor sleeps, the 6.25Hz stream is of no interest. */
+    (void)HAL_GpioSetTriggerMode((hal_gpio_handle_t)mFxls89xxInt2Handle, kHAL_GpioInterruptDisable);
+    (void)HAL_GpioWakeUpSetting((hal_gpio_handle_t)mFxls89xxInt2Handle, 1U);
+
+    mFxls89xxBufReady = TRUE;
+
+    return 0;
+}
+
+/*! *********************************************************************************
+ * \brief        Starts a capture: flushes stale samples and unmasks the watermark interrupt.
+ ********************************************************************************** */
+static void fxls89xx_buf_start(void)
+{
+    uint32_t regPrimask;
+    bool_t stopping;
+#if (FXLS8974_SNAPSHOT_MODE == 1)
+    uint8_t bufStatus = 0U;
+    uint8_t i;
+#endif
+
+    /* The previous capture is still waiting for its tail, close it before the new one starts. */
+    regPrimask = DisableGlobalIRQ();
+    stopping = (0U != (mFxls89xxIrqDeferred & mfxls89xxDeferStop_c)) ? TRUE : FALSE;
+    mFxls89xxIrqDeferred &= (uint8_t)~mfxls89xxDeferStop_c;
+    EnableGlobalIRQ(regPrimask);
+    if (TRUE == stopping)
+    {
+        fxls89xx_BufStopHandler(NULL);
+    }
+
+#if (FXLS8974_SNAPSHOT_MODE == 1)
+
+    /* The buffer kept streaming at the Sleep ODR, what it holds is the history before the wake. */
+    if (SENSOR_ERROR_NONE == FXLS8974_ReadBuffer(&fxls8974Driver, mFxls89xxCapture, mFxls89xxBufDepth,
+                                                 (uint32_t)TM_GetTimestamp(), FXLS8974_SLEEP_SAMPLE_PERIOD_US,
+                                                 &mFxls89xxCaptureCount, &bufStatus))
+    {
+        for (i = 0U; i < mFxls89xxCaptureCount; i++)
+        {
+            fxls89xx_snapshot_push(mFxls89xxCapture[i].timestamp, mFxls89xxCapture[i].accel[0],
+                                   mFxls89xxCapture[i].accel[1], mFxls89xxCapture[i].accel[2]);
+        }
+    }
+#if (FXLS8974_CLASSIFY_MODE == 0)
+    /* The alert is out, freeze the samples around it. */
+    fxls89xx_snapshot_trigger();
+#endif
+#endif
+    mFxls89xxCaptureCount = 0U;
+    MotionFeatures_Compute(NULL, 0U, &mFxls89xxFeatures);
+
+    /* BUF_FLUSH is self clearing and allowed in ACTIVE mode. */
+#if (FXLS8974_SPI_MODE == 1)
+    (void)Register_SPI_Write(fxls8974Driver.pCommDrv, &fxls8974Driver.deviceInfo, &fxls8974Driver.slaveParams,
+                             FXLS8974_BUF_CONFIG2, FXLS8974_BUF_CONFIG2_BUF_FLUSH_EN,
+                             FXLS8974_BUF_CONFIG2_BUF_FLUSH_MASK);
+#else
+    (void)Register_I2C_Write(fxls8974Driver.pCommDrv, &fxls8974Driver.deviceInfo, fxls8974Driver.slaveAddress,
+                             FXLS8974_BUF_CONFIG2, FXLS8974_BUF_CONFIG2_BUF_FLUSH_EN,
+                             FXLS8974_BUF_CONFIG2_BUF_FLUSH_MASK, false);
+    Register_I2C_InvalidateCache(&fxls8974Driver.deviceInfo, FXLS8974_BUF_CONFIG2, 1);
+#endif
+
+    (void)HAL_GpioSetTriggerMode((hal_gpio_handle_t)mFxls89xxInt2Handle, kHAL_GpioInterruptRisingEdge);
+}
+
+/*! *********************************************************************************
+ * \brief        Ends a capture: masks the watermark interrupt and drains the tail of the motion.
+ ********************************************************************************** */
+static void fxls89xx_buf_stop(void)
+{
+    (void)HAL_GpioSetTriggerMode((hal_gpio_handle_t)mFxls89xxInt2Handle, kHAL_GpioInterruptDisable);
+
+    /* The tail is drained once the SYS_MODE read on the bus completes, its completion closes the capture. */
+    if (fxls89xx_DeferIrq(mfxls89xxDeferStop_c))
+    {
+        return;
+    }
+    fxls89xx_BufStopHandler(NULL);
+}
+
+/*! *********************************************************************************
+ * \brief        Drains the tail of the motion and closes the capture, the I2C bus has to be idle.
+ *
+ * \param[in]    pParam      Unused.
+ ********************************************************************************** */
+static void fxls89xx_BufStopHandler(void *pParam)
+{
+    uint32_t regPrimask;
+
+    (void)pParam;
+
+    regPrimask = DisableGlobalIRQ();
+    mFxls89xxIrqDeferred &= (uint8_t)~mfxls89xxDeferInt2_c;
+    EnableGlobalIRQ(regPrimask);
+    fxls89xx_buf_drain();
+#if (FXLS8974_CLASSIFY_MODE == 1)
+    /* The motion ended before the window was full. */
+    if (mFxls89xxClassifying)
+    {
+        fxls89xx_Classify();
+    }
+#endif
+    fxls89xx_SendFeatures();
+#if (FXLS8974_SNAPSHOT_MODE == 1)
+    /* The motion is over, send what the snapshot got and let the ring record again
+       once all of it went out. */
+    if (mFxls89xxSnapshot.triggered)
+    {
+        mFxls89xxSnapshotClosing = TRUE;
+        fxls89xx_SnapshotSendHandler(NULL);
+    }
+#endif
+}
+
+/*! *********************************************************************************
+ * \brief        Prints the features of the motion on the debug UART and sends them to the peers.
+ ********************************************************************************** */
+static void fxls89xx_SendFeatures(void)
+{
+    char text[96];
+    uint32_t length;
+    uint32_t sent;
+
+    if (mFxls89xxFeatures.numSamples == 0U)
+    {
+        return;
+    }
+
+    length = MotionFeatures_Format(&mFxls89xxFeatures, text, sizeof(text));
+    Serial_Print(text, gAllowToBlock_d);
+    for (sent = 0U; sent < length; sent += 64U)
+    {
+        (void)BleApp_QueueTx((uint8_t *)&text[sent], ((length - sent) < 64U) ? (length - sent) : 64U, mTxClass_Debug_c);
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        INT2 interrupt callback, runs in interrupt context.
+ *
+ * \param[in]    pParam      Unused.
+ ********************************************************************************** */
+static void fxls89xx_Int2Callback(void *pParam)
+{
+    (void)pParam;
+
+    if (!mFxls89xxBufPending)
+    {
+        mFxls89xxBufPending = TRUE;
+        if (gBleSuccess_c != App_PostCallbackMessage(fxls89xx_Int2Handler, NULL))
+        {
+            /* The queue is full, let the next edge try again. */
+            mFxls89xxBufPending = FALSE;
+        }
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Deferred INT2 handler, drains the sample buffer in one burst.
+ *
+ * \param[in]    pParam      Unused.
+ ********************************************************************************** */
+static void fxls89xx_Int2Handler(void *pParam)
+{
+    (void)pParam;
+
+    /* A SYS_MODE poll is still on the bus, its completion runs this handler again. */
+    if (fxls89xx_DeferIrq(mfxls89xxDeferInt2_c))
+    {
+        return;
+    }
+    mFxls89xxBufPending = FALSE;
+
+    fxls89xx_buf_drain();
+}
+
+/*! *********************************************************************************
+ * \brief        Drains the sample buffer in one burst, the I2C bus has to be idle.
+ ********************************************************************************** */
+static void fxls89xx_buf_drain(void)
+{
+    int32_t status;
+    uint8_t bufStatus = 0U;
+    motionfeatures_t features;
+
+#if (FXLS8974_BUS_BENCH_MODE == 1)
+    BusBench_Begin(&mFxls89xxBench);
+#endif
+    status = FXLS8974_ReadBuffer(&fxls8974Driver, mFxls89xxCapture, mFxls89xxBufDepth,
+                                 (uint32_t)TM_GetTimestamp(), FXLS8974_WAKE_SAMPLE_PERIOD_US,
+                                 &mFxls89xxCaptureCount, &bufStatus);
+#if (FXLS8974_BUS_BENCH_MODE == 1)
+    BusBench_End(&mFxls89xxBench, (SENSOR_ERROR_NONE == status) ? mFxls89xxCaptureCount : 0U);
+#endif
+    if (SENSOR_ERROR_NONE != status)
+    {
+        BleApp_SendUartStream(&vec_read_failed[0], 70U);
+        return;
+    }
+
+    /* Samples were lost between two drains, the capture has a gap. */
+    if (0U != (bufStatus & FXLS8974_BUF_STATUS_BUF_OVF_MASK))
+    {
+        mFxls89xxBufOverflows++;
+    }
+
+#if (FXLS8974_SNAPSHOT_MODE == 1)
+    for (uint8_t i = 0U; i < mFxls89xxCaptureCount; i++)
+    {
+        fxls89xx_snapshot_push(mFxls89xxCapture[i].timestamp, mFxls89xxCapture[i].accel[0],
+                               mFxls89xxCapture[i].accel[1], mFxls89xxCapture[i].accel[2]);
+    }
+#endif
+
+    /* Keep the burst with the most jerk, the tail of a motion is mostly settling. */
+    MotionFeatures_Compute(mFxls89xxCapture, mFxls89xxCaptureCount, &features);
+    if (features.jerkEnergy >= mFxls89xxFeatures.jerkEnergy)
+    {
+        mFxls89xxFeatures = features;
+    }
+
+#if (FXLS8974_CLASSIFY_MODE == 1)
+    if (mFxls89xxClassifying)
+    {
+        TamperClassifier_WindowAdd(&mFxls89xxWindow, &features);
+        if (mFxls89xxWindow.numSamples >= FXLS8974_CLASSIFY_WINDOW)
+        {
+            fxls89xx_Classify();
+        }
+    }
+#endif
+}
+
+#if (FXLS8974_CLASSIFY_MODE == 1)
+/*! *********************************************************************************
+ * \brief        Classifies the first samples of the motion and raises the alert for the confirmed classes.
+ ********************************************************************************** */
+static void fxls89xx_Classify(void)
+{
+    static const char label[] = "\r\n Motion class: ";
+    int32_t vector[mTamperFeature_Count_c];
+    tamperClass_t cls;
+    const char *pName;
+    char text[40];
+    uint32_t length;
+
+    mFxls89xxClassifying = FALSE;
+
+    TamperClassifier_Features(&cFxls8974TamperModel, &mFxls89xxWindow, vector);
+    cls = TamperClassifier_Run(&cFxls8974TamperModel, vector);
+    pName = TamperClassifier_Name(cls);
+
+    length = sizeof(label) - 1U;
+    FLib_MemCpy(text, label, length);
+    FLib_MemCpy(&text[length], pName, strlen(pName) + 1U);
+    length += strlen(pName);
+    Serial_Print(text, gAllowToBlock_d);
+
+    if ((0U == (FXLS8974_CLASSIFY_ALERT_MASK & TAMPER_CLASS_MASK(cls)))
+#if (FXLS8974_ORIENT_MODE == 1)
+        /* A change of orientation seen by the sensor always alerts. */
+        && (0U == (mFxls89xxEventSrc[0] & FXLS8974_ORIENT_STATUS_NEW_ORIENT_MASK))
+#endif
+       )
+    {
+        /* Not worth an alert, e.g. traffic passing by. */
+        mFxls89xxSuppressed++;
+        return;
+    }
+
+#if (FXLS8974_ASCII_ALERT_MODE == 1)
+    BleApp_SendUartStream(&vec_motion_start[0], 70U);
+#if (FXLS8974_ORIENT_MODE == 1)
+    fxls89xx_send_source();
+#else
+    BleApp_SendUartStream(&vec_motion_dec[0], 70U);
+#endif
+    BleApp_SendUartStream((uint8_t *)text, length);
+    BleApp_SendUartStream(&vec_motion_end[0], 70U);
+#else
+    fxls89xx_send_event(mTamperEvent_Motion_c, mTamperSeverity_Alert_c, (uint8_t)cls);
+#endif
+#if (FXLS8974_SNAPSHOT_MODE == 1)
+    fxls89xx_snapshot_trigger();
+#endif
+}
+#endif
+#endif /* FXLS8974_FIFO_CAPTURE_MODE */
+
+#if (FXLS8974_ORIENT_MODE == 1)
+/*! *********************************************************************************
+ * \brief        Reads ORIENT_STATUS and SDCD_INT_SRC1/2 in one burst, which also clears their flags.
+ ********************************************************************************** */
+static void fxls89xx_read_source(void)
+{
+    int32_t status;
+
+    status = FXLS8974_ReadData(&fxls8974Driver, cFxls8974ReadEventSrc, mFxls89xxEventSrc);
+    if (SENSOR_ERROR_NONE != status)
+    {
+        /* Unknown source, report it as a motion. */
+        FLib_MemSet(mFxls89xxEventSrc, 0U, sizeof(mFxls89xxEventSrc));
+    }
+}
+
+#if (FXLS8974_ASCII_ALERT_MODE == 1)
+/*! *********************************************************************************
+ * \brief        Sends the alert lines of the sources which woke the sensor, and the new orientation.
+ ********************************************************************************** */
+static void fxls89xx_send_source(void)
+{
+    static const char label[] = "\r\n Orientation: ";
+    static const char *const cLapo[] = {"portrait up", "portrait down", "landscape right", "landscape left"};
+    uint8_t orient = mFxls89xxEventSrc[0];
+    uint8_t sdcd = mFxls89xxEventSrc[FXLS8974_SDCD_INT_SRC1 - FXLS8974_ORIENT_STATUS];
+    const char *pLapo;
+    const char *pBafro;
+    char text[48];
+    uint32_t length;
+
+    if (0U == (orient & FXLS8974_ORIENT_STATUS_NEW_ORIENT_MASK))
+    {
+        /* Only two wake sources, without a new orientation it was a motion. */
+        BleApp_SendUartStream(&vec_motion_dec[0], 70U);
+        return;
+    }
+
+    BleApp_SendUartStream(&vec_tilt_dec[0], 70U);
+    if (0U != (sdcd & FXLS8974_SDCD_INT_SRC1_OT_EA_MASK))
+    {
+        BleApp_SendUartStream(&vec_motion_dec[0], 70U);
+    }
+
+    /* Past the Z-tilt lockout the asset lies flat, landscape/portrait is meaningless. */
+    pLapo = (0U != (orient & FXLS8974_ORIENT_STATUS_LO_MASK)) ?
+                "flat" :
+                cLapo[(orient & FXLS8974_ORIENT_STATUS_LAPO_MASK) >> FXLS8974_ORIENT_STATUS_LAPO_SHIFT];
+    pBafro = (FXLS8974_ORIENT_STATUS_BAFRO_BACK == (orient & FXLS8974_ORIENT_STATUS_BAFRO_MASK)) ? ", back" :
+                                                                                                     ", front";
+
+    length = sizeof(label) - 1U;
+    FLib_MemCpy(text, label, length);
+    FLib_MemCpy(&text[length], pLapo, strlen(pLapo));
+    length += strlen(pLapo);
+    FLib_MemCpy(&text[length], pBafro, strlen(pBafro) + 1U);
+    length += strlen(pBafro);
+    Serial_Print(text, gAllowToBlock_d);
+    BleApp_SendUartStream((uint8_t *)text, length);
+}
+#endif /* FXLS8974_ASCII_ALERT_MODE */
+#endif /* FXLS8974_ORIENT_MODE */
+
+#if (FXLS8974_ASCII_ALERT_MODE == 0)
+/*! *********************************************************************************
+ * \brief        Sends one binary event record to the peers, in a single write.
+ *
+ * \param[in]    type        tamperEventType_t, a motion which changed the orientation is sent as a tilt.
+ * \param[in]    severity    tamperSeverity_t.
+ * \param[in]    cls         tamperClass_t of the motion, mTamperClass_Count_c when it was not classified.
+ ********************************************************************************** */
+static void fxls89xx_send_event(uint8_t type, uint8_t severity, uint8_t cls)
+{
+    tamperevent_t event;
+#if (FXLS8974_ORIENT_MODE == 1)
+    uint8_t source[TAMPER_ITEM_LENGTH(TAMPER_ITEM_ORIENT)];
+
+    if ((mTamperEvent_Motion_c == type) && (0U != (mFxls89xxEventSrc[0] & FXLS8974_ORIENT_STATUS_NEW_ORIENT_MASK)))
+    {
+        type = mTamperEvent_Tilt_c;
+    }
+#endif
+
+    TamperEvent_Init(&event, type, severity, fxls89xxWhoAmI,
+                     mFxls89xxEventSeq++, (uint32_t)(TM_GetTimestamp() / 1000U));
+    if (cls < (uint8_t)mTamperClass_Count_c)
+    {
+        (void)TamperEvent_AddItem(&event, TAMPER_ITEM_CLASS, &cls);
+    }
+#if (FXLS8974_ORIENT_MODE == 1)
+    if (mTamperEvent_Safe_c != type)
+    {
+        source[0] = mFxls89xxEventSrc[0];
+        source[1] = mFxls89xxEventSrc[FXLS8974_SDCD_INT_SRC1 - FXLS8974_ORIENT_STATUS];
+        (void)TamperEvent_AddItem(&event, TAMPER_ITEM_ORIENT, source);
+    }
+#endif
+
+    fxls89xx_send_record(&event, severity);
+}
+
+/*! *********************************************************************************
+ * \brief        Encodes an event and hands the record to the beacon and to the peers.
+ *
+ * \param[in]    pEvent      The event to send.
+ * \param[in]    severity    tamperSeverity_t, an alert goes out at once.
+ ********************************************************************************** */
+static void fxls89xx_send_record(const tamperevent_t *pEvent, uint8_t severity)
+{
+    uint8_t record[TAMPER_EVENT_MAX_SIZE];
+    uint32_t recordSize;
+
+    recordSize = TamperEvent_Encode(pEvent, record, sizeof(record));
+#if (FXLS8974_BROADCAST_MODE == 1)
+    BleApp_UpdateBeacon(record, recordSize);
+    BleApp_RestartBeacon(TRUE);
+#endif
+#if (FXLS8974_EVENT_BATCH_MS > 0U)
+    BleApp_QueueTamperEvent(record, recordSize, (mTamperSeverity_Alert_c == severity) ? TRUE : FALSE);
+#else
+    BleApp_SendTamperEvent(record, recordSize);
+#endif
+}
+#endif /* FXLS8974_ASCII_ALERT_MODE */
+
+#if (FXLS8974_TEMP_COMP_MODE == 1)
+/*! *********************************************************************************
+ * \brief        Restores the per-unit offset coefficients, an uncalibrated unit is not corrected.
+ ********************************************************************************** */
+static void fxls89xx_temp_comp_init(void)
+{
+#if defined(gAppUseNvm_d) && (gAppUseNvm_d > 0)
+    if (gNVM_OK_c != NvRestoreDataSet(&mFxls89xxTempCoeffs, FALSE))
+    {
+        mFxls89xxTempCoeffs.magic = 0U;
+    }
+#endif
+    (void)TempComp_Init(&mFxls89xxTempComp, &mFxls89xxTempCoeffs, FXLS8974_TEMP_COMP_HYS);
+    /* The configuration holds the uncorrected band, a correction of 0. */
+    mFxls89xxTempComp.programmed = true;
+}
+
+/*! *********************************************************************************
+ * \brief        Centres the SDCD band on the offset error at the current temperature, once it has moved by more
+ *               than FXLS8974_TEMP_COMP_HYS since the band was last programmed.
+ *
+ * \param[in]    tempOut     TEMP_OUT value read with INT_STATUS.
+ ********************************************************************************** */
+static void fxls89xx_temp_comp(uint8_t tempOut)
+{
+    if (TempComp_Update(&mFxls89xxTempComp, TEMP_COMP_Q8((int8_t)tempOut + FXLS8974_TEMP_OUT_OFFSET_C)))
+    {
+        /* A write now would put the sensor in standby in the middle of the motion. */
+        mFxls89xxTempCompDue = TRUE;
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Writes the band computed by fxls89xx_temp_comp(), called while the sensor sleeps.
+ ********************************************************************************** */
+static void fxls89xx_temp_comp_apply(void)
+{
+    int32_t lower;
+    int32_t upper;
+    uint8_t sysMode = 0U;
+
+    if (FALSE == mFxls89xxTempCompDue)
+    {
+        return;
+    }
+
+    lower = mFxls89xxTempComp.applied - FXLS8974_SDCD_THS;
+    upper = mFxls89xxTempComp.applied + FXLS8974_SDCD_THS;
+
+    /*! The thresholds are written in standby, the sensor is active again afterwards. */
+    registerwritelist_t thresholds[] = {
+        {FXLS8974_SDCD_LTHS_LSB, (uint8_t)lower, 0},
+        {FXLS8974_SDCD_LTHS_MSB, (uint8_t)(lower >> 8), 0},
+        {FXLS8974_SDCD_UTHS_LSB, (uint8_t)upper, 0},
+        {FXLS8974_SDCD_UTHS_MSB, (uint8_t)(upper >> 8), 0},
+        __END_WRITE_DATA__};
+    if (SENSOR_ERROR_NONE != FXLS8974_Configure(&fxls8974Driver, thresholds))
+    {
+        /* Try again at the next sleep. */
+        BleApp_SendUartStream(&vec_sensor_err[0], 70U);
+        return;
+    }
+    mFxls89xxTempCompDue = FALSE;
+
+    /* Leaving standby may start the sensor in WAKE, that is no motion. */
+    if ((SENSOR_ERROR_NONE == FXLS8974_ReadData(&fxls8974Driver, cFxls8974ReadSysMode, &sysMode)) &&
+        (FXLS8974_SYS_MODE_SYS_MODE_WAKE == sysMode))
+    {
+        mFxls89xxTempCompRestart = TRUE;
+    }
+}
+#endif /* FXLS8974_TEMP_COMP_MODE */
+
+#if (FXLS8974_SNAPSHOT_MODE == 1)
+/*! *********************************************************************************
+ * \brief        Hands the snapshot ring its static storage and starts recording.
+ ********************************************************************************** */
+static void fxls89xx_snapshot_init(void)
+{
+    if (NULL != mFxls89xxSnapshot.pStorage)
+    {
+        return;
+    }
+
+    /* The size is checked at build time, the ring cannot refuse its storage. */
+    (void)CaptureRing_Init(&mFxls89xxSnapshot, mFxls89xxSnapshotStorage, FXLS8974_SNAPSHOT_SAMPLES);
+}
+
+/*! *********************************************************************************
+ * \brief        Records one sample from the acquisition path, never waits.
+ *
+ * \param[in]    timestamp   Time the sample was taken, us.
+ * \param[in]    v0          First sensor value.
+ * \param[in]    v1          Second sensor value.
+ * \param[in]    v2          Third sensor value.
+ ********************************************************************************** */
+static void fxls89xx_snapshot_push(uint32_t timestamp, int32_t v0, int32_t v1, int32_t v2)
+{
+    capturesample_t sample = {timestamp, {v0, v1, v2}};
+
+    if (NULL == mFxls89xxSnapshot.pStorage)
+    {
+        return;
+    }
+
+    (void)CaptureRing_Push(&mFxls89xxSnapshot, &sample);
+
+    /* Stream the snapshot out as its post trigger samples come in. */
+    if (mFxls89xxSnapshot.triggered && (FALSE == mFxls89xxSnapshotSendPending))
+    {
+        mFxls89xxSnapshotSendPending = TRUE;
+        if (gBleSuccess_c != App_PostCallbackMessage(fxls89xx_SnapshotSendHandler, NULL))
+        {
+            mFxls89xxSnapshotSendPending = FALSE;
+        }
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Freezes the samples around the alert and starts sending them to the peers.
+ ********************************************************************************** */
+static void fxls89xx_snapshot_trigger(void)
+{
+    if ((NULL == mFxls89xxSnapshot.pStorage) ||
+        !CaptureRing_Trigger(&mFxls89xxSnapshot, FXLS8974_SNAPSHOT_PRE, FXLS8974_SNAPSHOT_POST))
+    {
+        return;
+    }
 
-    status = SerialManager_OpenReadHandle((serial_handle_t)appSerMgrIf, (serial_read_handle_t)s_readHandle);
-    assert(kStatus_SerialManager_Success == status);
-    status = SerialManager_InstallRxCallback((serial_read_handle_t)s_readHandle, Uart_RxCallBack, NULL);
-    assert(kStatus_SerialManager_Success == status);
+    BleApp_SendUartStream(&vec_snapshot[0], 70U);
+    fxls89xx_SnapshotSendHandler(NULL);
 }
 
 /*! *********************************************************************************
- * \brief        Function handling the initialization complete event of the Bluetooth LE Host stack.
+ * \brief        Sends the snapshot samples recorded so far, releases the ring once all are out.
+ *
+ * \details      Samples are read from the ring only while every peer has room
+ *               for them and mAppTxAlertReserve_c more entries, so that an alert
+ *               takes a free entry rather than a chunk of the snapshot. The rest
+ *               waits in the ring until BleApp_TxDrained posts the handler again.
  *
+ * \param[in]    pParam      Unused.
  ********************************************************************************** */
-static void BluetoothLEHost_Initialized(void)
+static void fxls89xx_SnapshotSendHandler(void *pParam)
 {
-    uint8_t peerId = 0;
+    capturesample_t samples[4];
+    uint32_t count = 1U;
 
-    /* Common GAP configuration */
-    BleConnManager_GapCommonConfig();
-
-    /* Register for callbacks */
-    (void)App_RegisterGattServerCallback(BleApp_GattServerCallback);
-    (void)App_RegisterGattClientProcedureCallback(BleApp_GattClientCallback);
-    (void)GattServer_RegisterHandlesForWriteNotifications(NumberOfElements(mCharMonitoredHandles), mCharMonitoredHandles);
-    BleServDisc_RegisterCallback(BleApp_ServiceDiscoveryCallback);
-    mcActiveConnNo = 0U;
-    for (peerId = 0; peerId < (uint8_t)gAppMaxConnections_c; peerId++)
-    {
-        maPeerInformation[peerId].deviceId = gInvalidDeviceId_c;
-        maPeerInformation[peerId].appState = mAppIdle_c;
-        maPeerInformation[peerId].clientInfo.hService = gGattDbInvalidHandleIndex_d;
-        maPeerInformation[peerId].clientInfo.hUartStream = gGattDbInvalidHandleIndex_d;
-    }
+    (void)pParam;
 
-#if (gWuart_AutoStart_c == 1)
-    mGapRole = gWuart_AutoStartGapRole_c;
-#else
-    /* By default, always start node as GAP central */
-#if gWuart_CentralRole_c == 1
-    mGapRole = gGapCentral_c;
-#else
-    mGapRole = gGapPeripheral_c;
-#endif /* gWuart_CentralRole_c */
-#endif /* gWuart_AutoStart_c */
+    mFxls89xxSnapshotSendPending = FALSE;
 
-#if (defined(gAppButtonCnt_c) && (gAppButtonCnt_c == 1))
-    Serial_Print("\n\rWireless UART starting as GAP Central.\n\r", gAllowToBlock_d);
-    Serial_Print("\n\rWithin one second, either:\n\r", gAllowToBlock_d);
-    Serial_Print(" - double press the switch to change the role or\n\r", gAllowToBlock_d);
-    Serial_Print(" - single press to start the application with the selected role.\n\r", gAllowToBlock_d);
-#else
-    if (mGapRole == gGapCentral_c)
+    while ((0U != count) && (BleApp_TxRoom(mTxClass_Snapshot_c) > mAppTxAlertReserve_c))
     {
-        Serial_Print("\n\rWireless UART starting as GAP Central.\n\r", gAllowToBlock_d);
+        count = CaptureRing_Read(&mFxls89xxSnapshot, samples, 4U);
+        if (0U != count)
+        {
+            (void)BleApp_QueueTx((uint8_t *)samples, count * (uint32_t)sizeof(capturesample_t), mTxClass_Snapshot_c);
+        }
     }
-    else
+
+    if (CaptureRing_IsDone(&mFxls89xxSnapshot) || ((TRUE == mFxls89xxSnapshotClosing) && (0U == count)))
     {
-        Serial_Print("\n\rWireless UART starting as GAP Peripheral.\n\r", gAllowToBlock_d);
+        mFxls89xxSnapshotClosing = FALSE;
+        CaptureRing_Release(&mFxls89xxSnapshot);
     }
-#endif
-#if gWuart_PeripheralRole_c == 1
-    mAdvState.advOn = FALSE;
-#endif /* gWuart_PeripheralRole_c */
+}
+#endif /* FXLS8974_SNAPSHOT_MODE */
 
-#if gWuart_CentralRole_c == 1
-    mScanningOn = FALSE;
-#endif /* gWuart_CentralRole_c */
+int fxls89xx_event_BLE(void)
+{
 
-    /* Start services */
-    (void)Wus_Start(&mWuServiceConfig);
+    int32_t status;
 
-    mBasServiceConfig.batteryLevel = SENSORS_GetBatteryLevel();
-    (void)Bas_Start(&mBasServiceConfig);
+            /* The previous poll is still on the bus, nothing new to learn yet. */
+            if (mFxls89xxSysModeBusy)
+            {
+                return 0;
+            }
 
-    /* Allocate application timer */
-    (void)TM_Open(mAppTimerId);
-    (void)TM_Open(mUartStreamFlushTimerId);
-    (void)TM_Open(mBatteryMeasurementTimerId);
-    (void)TM_Open(mFxls89xxId);
+            /*! Queue the SYS_MODE read, the state machine runs once it completes. */
+            mFxls89xxSysModeBusy = TRUE;
+            mFxls89xxSysMode = 0;
+#if (FXLS8974_MULTI_SENSOR_MODE == 1)
+            /*! One round reads SYS_MODE, the pressure and the field back to back, the bus wakes up once. */
+            status = SensorEngine_Poll(&fxls8974Engine, fxls89xx_PollDone, NULL);
+            if (ARM_DRIVER_OK != status)
+            {
+                mFxls89xxSysModeBusy = FALSE;
+                return status;
+            }
+#elif (FXLS8974_SPI_MODE == 1)
+            /*! No queued reads on SPI, the 3 byte transfer is over in a few microseconds anyway. */
+            status = FXLS8974_SPI_ReadData(&fxls8974Driver, cFxls8974ReadSysMode, &mFxls89xxSysMode);
+            if (SENSOR_ERROR_NONE != status)
+            {
+                mFxls89xxSysModeBusy = FALSE;
+                return status;
+            }
+            fxls89xx_SysModeReadCallback(ARM_DRIVER_OK, NULL);
+#else
+            status = FXLS8974_I2C_ReadDataAsync(&fxls8974Driver, &mFxls89xxSysModeXfer, cFxls8974ReadSysMode,
+                                                &mFxls89xxSysMode, fxls89xx_SysModeReadCallback, NULL);
+            if (SENSOR_ERROR_NONE != status)
+            {
+                mFxls89xxSysModeBusy = FALSE;
+                return status;
+            }
+#endif
 
-#if (gAppButtonCnt_c == 1)
-    (void)TM_Open(mSwitchPressTimerId);
+            return 0;
+}
+
+/*! *********************************************************************************
+ * \brief        SYS_MODE read completion, runs in I2C interrupt context, or in the timer task on SPI.
+ *
+ * \param[in]    status      ARM_DRIVER_OK or the transfer error.
+ * \param[in]    pParam      Unused.
+ ********************************************************************************** */
+static void fxls89xx_SysModeReadCallback(int32_t status, void *pParam)
+{
+    (void)pParam;
+
+    if ((ARM_DRIVER_OK != status) ||
+        (gBleSuccess_c != App_PostCallbackMessage(fxls89xx_SysModeHandler, NULL)))
+    {
+        mFxls89xxSysModeBusy = FALSE;
+#if (FXLS8974_WAKE_IRQ_MODE == 1) || (FXLS8974_FIFO_CAPTURE_MODE == 1)
+        fxls89xx_ResumeIrq(TRUE);
 #endif
+    }
+}
 
-#if !(defined(cPWR_UsePowerDownMode) && (cPWR_UsePowerDownMode))
-    LedStartFlashingAllLeds();
+/*! *********************************************************************************
+ * \brief        Runs the SLEEP/WAKE state machine on the SYS_MODE value just read.
+ *
+ * \param[in]    pParam      Unused.
+ ********************************************************************************** */
+static void fxls89xx_SysModeHandler(void *pParam)
+{
+    (void)pParam;
+
+    mFxls89xxSysModeBusy = FALSE;
+#if (FXLS8974_MULTI_SENSOR_MODE == 1)
+    /*! Every sensor of the round gets its data, the FXLS8974 hook runs the state machine. */
+    SensorEngine_Decode(&fxls8974Engine);
+#else
+    (void)fxls89xx_handle_mode(mFxls89xxSysMode);
 #endif
-#if (gWuart_AutoStart_c == 1)
-    BleApp_Start(mGapRole);
+#if (FXLS8974_WAKE_IRQ_MODE == 1) || (FXLS8974_FIFO_CAPTURE_MODE == 1)
+    fxls89xx_ResumeIrq(FALSE);
 #endif
 }
 
+#if (FXLS8974_MULTI_SENSOR_MODE == 1)
 /*! *********************************************************************************
- * \brief        Function handling the geeneric events from the host stack.
+ * \brief        Poll round completion, runs in the I2C interrupt.
  *
+ * \param[in]    pParam      Unused.
  ********************************************************************************** */
-static void BluetoothLEHost_GenericCallback(gapGenericEvent_t *pGenericEvent)
+static void fxls89xx_PollDone(void *pParam)
 {
-    /* Call BLE Conn Manager */
-    BleConnManager_GenericEvent(pGenericEvent);
+    fxls89xx_SysModeReadCallback(ARM_DRIVER_OK, pParam);
+}
 
-#if defined(gUseControllerNotifications_c) && (gUseControllerNotifications_c)
-    if (pGenericEvent->eventType == gControllerNotificationEvent_c)
+/*! *********************************************************************************
+ * \brief        Sends the event of a pressure or magnet node, from SensorEngine_Decode().
+ *
+ * \param[in]    pSlot       Engine slot of the node.
+ * \param[in]    alert       TRUE when the sample left the band around the baseline, FALSE when it came back.
+ * \param[in]    sample      The sample, Pa or OUT_M counts.
+ * \param[in]    reference   The baseline, in the units of sample.
+ ********************************************************************************** */
+static void fxls89xx_multi_event(const sensorengineslot_t *pSlot, bool alert, int32_t sample, int32_t reference)
+{
+    tamperevent_t event;
+    uint8_t pressure[TAMPER_ITEM_LENGTH(TAMPER_ITEM_PRESSURE)];
+    uint8_t type = mTamperEvent_Safe_c;
+    uint8_t severity = mTamperSeverity_Info_c;
+
+    if (alert)
     {
-        BleApp_HandleControllerNotification(&pGenericEvent->eventData.notifEvent);
+        type = (pSlot == &fxls8974Slots[MULTI_SENSOR_SLOT_PRESSURE]) ? mTamperEvent_Pressure_c : mTamperEvent_Magnetic_c;
+        severity = mTamperSeverity_Alert_c;
+        /*! Keep the poll fast while any node of the bus is active. */
+        (void)PollSched_Update(&mFxls89xxPoll, true);
     }
-#endif /* gUseControllerNotifications_c */
-    if(pGenericEvent->eventType == gInternalError_c)
-    {
-        if((pGenericEvent->eventData.internalError.errorCode == gBleOverflow_c) && (pGenericEvent->eventData.internalError.errorSource == gAddNewConnection_c))
-        {
-            Serial_Print("Connection failed ", gAllowToBlock_d);
-#if gWuart_PeripheralRole_c == 1
-            if(mAdvState.advOn)
-            {
-                mAdvState.advOn = FALSE;
-                Serial_Print(" as peripheral.\n\r", gAllowToBlock_d);
-            }
-            else
-#endif /* gWuart_PeripheralRole_c == 1 */
-            {
-#if gWuart_CentralRole_c == 1
-                Serial_Print(" as central.\n\r", gAllowToBlock_d);
-#endif /* gWuart_CentralRole_c == 1 */
 
-            }
-        }
+    TamperEvent_Init(&event, type, severity, pSlot->whoAmI, mFxls89xxEventSeq++,
+                     (uint32_t)(TM_GetTimestamp() / 1000U));
+    if (pSlot == &fxls8974Slots[MULTI_SENSOR_SLOT_PRESSURE])
+    {
+        pressure[0] = (uint8_t)sample;
+        pressure[1] = (uint8_t)(sample >> 8);
+        pressure[2] = (uint8_t)(sample >> 16);
+        pressure[3] = (uint8_t)(sample >> 24);
+        pressure[4] = (uint8_t)reference;
+        pressure[5] = (uint8_t)(reference >> 8);
+        pressure[6] = (uint8_t)(reference >> 16);
+        pressure[7] = (uint8_t)(reference >> 24);
+        (void)TamperEvent_AddItem(&event, TAMPER_ITEM_PRESSURE, pressure);
     }
+    fxls89xx_send_record(&event, severity);
 }
+#endif /* FXLS8974_MULTI_SENSOR_MODE */
 
+#if (FXLS8974_WAKE_IRQ_MODE == 1) || (FXLS8974_FIFO_CAPTURE_MODE == 1)
+/*! *********************************************************************************
+ * \brief        Holds an INT handler or the end of a capture back while the SYS_MODE read is on the bus.
+ *
+ * \param[in]    irq         mfxls89xxDeferInt1_c, mfxls89xxDeferInt2_c or mfxls89xxDeferStop_c.
+ *
+ * \return       TRUE if the handler has to wait, the read completion runs it again.
+ ********************************************************************************** */
+static bool_t fxls89xx_DeferIrq(uint8_t irq)
+{
+    bool_t busy;
+    uint32_t regPrimask;
 
-int fxls89xx_int_BLE(void)
+    /* The read may complete in between, check and mark with the I2C interrupt held off. */
+    regPrimask = DisableGlobalIRQ();
+    busy = FXLS8974_IsAsyncBusy(&fxls8974Driver.deviceInfo) ? TRUE : FALSE;
+    if (TRUE == busy)
     {
+        mFxls89xxIrqDeferred |= irq;
+    }
+    EnableGlobalIRQ(regPrimask);
 
-        int32_t status;
-        uint8_t whoami;
-
-        BleApp_SendUartStream(&vec_init[0], 70U);
-
-        /*! Initialize the I2C driver. */
-        status = I2Cdrv->Initialize(I2C_S_SIGNAL_EVENT);
-        if (ARM_DRIVER_OK != status)
-        {
+    return busy;
+}
 
-        	BleApp_SendUartStream(&vec_i2c_init[0], 70U);
+/*! *********************************************************************************
+ * \brief        Runs the INT handlers held back by fxls89xx_DeferIrq().
+ *
+ * \param[in]    fromIsr     TRUE in the I2C interrupt, the handlers are posted to the
+ *                           application task instead of being called.
+ ********************************************************************************** */
+static void fxls89xx_ResumeIrq(bool_t fromIsr)
+{
+    uint8_t deferred;
+    uint32_t regPrimask;
 
-            return -1;
-        }
+    regPrimask = DisableGlobalIRQ();
+    deferred = mFxls89xxIrqDeferred;
+    mFxls89xxIrqDeferred = 0U;
+    EnableGlobalIRQ(regPrimask);
 
-        /*! Set the I2C Power mode. */
-        status = I2Cdrv->PowerControl(ARM_POWER_FULL);
-        if (ARM_DRIVER_OK != status)
+#if (FXLS8974_WAKE_IRQ_MODE == 1)
+    if (0U != (deferred & mfxls89xxDeferInt1_c))
+    {
+        if (FALSE == fromIsr)
         {
-
-        	BleApp_SendUartStream(&vec_power_cont[0], 70U);
-
-            return -1;
+            fxls89xx_Int1Handler(NULL);
         }
-
-        /*! Set the I2C bus speed. */
-        status = I2Cdrv->Control(ARM_I2C_BUS_SPEED, ARM_I2C_BUS_SPEED_FAST);
-        if (ARM_DRIVER_OK != status)
+        else if (gBleSuccess_c != App_PostCallbackMessage(fxls89xx_Int1Handler, NULL))
         {
-        	BleApp_SendUartStream(&vec_mode_cont[0], 70U);
-
-            return -1;
+            /* The queue is full, let the next edge try again. */
+            mFxls89xxIrqPending = FALSE;
         }
-
-        /* Init output LED GPIO. */
-        GPIO_PinInit(BOARD_INITPINS_LED_GREEN_GPIO, BOARD_INITPINS_LED_GREEN_PIN, &led_config);
-        GPIO_PinInit(BOARD_INITPINS_LED_BLUE_GPIO, BOARD_INITPINS_LED_BLUE_PIN, &led_config);
-        GPIO_PinInit(BOARD_INITPINS_LED_RED_GPIO, BOARD_INITPINS_LED_RED_PIN, &led_config);
-
-        /*! Initialize FXLS8974 sensor driver. */
-        status = FXLS8974_I2C_Initialize(&fxls8974Driver, &I2C_S_DRIVER, I2C_S_DEVICE_INDEX, FXLS8974_I2C_ADDR,
-                                         &whoami);
-        if (ARM_DRIVER_OK != status)
+        else
         {
-        	BleApp_SendUartStream(&vec_inint_sensor[0], 70U);
-
-            return -1;
+            ; /* Runs in the application task */
         }
-        if ((FXLS8964_WHOAMI_VALUE == whoami))// || (FXLS8967_WHOAMI_VALUE == whoami))
-
+    }
+#endif
+#if (FXLS8974_FIFO_CAPTURE_MODE == 1)
+    if (0U != (deferred & mfxls89xxDeferInt2_c))
+    {
+        if (FALSE == fromIsr)
         {
-        	BleApp_SendUartStream(&vec_gemini[0], 70U);
-
+            fxls89xx_Int2Handler(NULL);
         }
-        else if ((FXLS8967_WHOAMI_VALUE == whoami))
-         {
-             BleApp_SendUartStream(&vec_gemini_1[0], 70U);
-
-         }
-        else if ((FXLS8974_WHOAMI_VALUE == whoami))//  || (FXLS8968_WHOAMI_VALUE == whoami))
+        else if (gBleSuccess_c != App_PostCallbackMessage(fxls89xx_Int2Handler, NULL))
         {
-        	BleApp_SendUartStream(&vec_timandra[0], 70U);
+            /* The queue is full, let the next edge try again. */
+            mFxls89xxBufPending = FALSE;
         }
-        else if ((FXLS8968_WHOAMI_VALUE == whoami))
-         {
-             BleApp_SendUartStream(&vec_timandra_1[0], 70U);
-
-         }
-
-        else if ((FXLS8971_WHOAMI_VALUE == whoami))// || (FXLS8961_WHOAMI_VALUE == whoami))
+        else
         {
-        	BleApp_SendUartStream(&vec_chiron[0], 70U);
+            ; /* Runs in the application task */
         }
-        else if ((FXLS8961_WHOAMI_VALUE == whoami))
-         {
-             BleApp_SendUartStream(&vec_chiron_1[0], 70U);
-
-         }
-        else if (FXLS8962_WHOAMI_VALUE == whoami)
+    }
+    if (0U != (deferred & mfxls89xxDeferStop_c))
+    {
+        if (FALSE == fromIsr)
         {
-        	BleApp_SendUartStream(&vec_newstein[0], 70U);
-
+            fxls89xx_BufStopHandler(NULL);
         }
-        else
+        else if (gBleSuccess_c != App_PostCallbackMessage(fxls89xx_BufStopHandler, NULL))
         {
-        	BleApp_SendUartStream(&vec_whoiam[0], 70U);
-
-            return -1;
+            /* The queue is full, the next capture closes this one. */
+            regPrimask = DisableGlobalIRQ();
+            mFxls89xxIrqDeferred |= mfxls89xxDeferStop_c;
+            EnableGlobalIRQ(regPrimask);
         }
-
-        /*!  Set the task to be executed while waiting for I2C transactions to complete. */
-        //FXLS8974_I2C_SetIdleTask(&fxls8974Driver, (registeridlefunction_t)SMC_SetPowerModeVlpr, SMC);
-
-        /*! Configure the FXLS8974 sensor. */
-        status = FXLS8974_I2C_Configure(&fxls8974Driver, cFxls8974AwsConfig);
-        if (SENSOR_ERROR_NONE != status)
+        else
         {
-        	BleApp_SendUartStream(&vec_sensor_err[0], 70U);
-            return -1;
+            ; /* Runs in the application task */
         }
-    	BleApp_SendUartStream(&vec_sensor_succ[0], 70U);
-
-        return 0;
     }
-
-
-void fxls89_xx_CallBack()
-{
-
-		(void)TM_InstallCallback((timer_handle_t)mFxls89xxId, fxls89_xx_TimerCallback, NULL);
-
-        (void)TM_Start((timer_handle_t)mFxls89xxId,
-                    (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, mfxls89xxIntervalInMs_c);
-        status_ble = 0;
-
-
+#endif
 }
+#endif /* FXLS8974_WAKE_IRQ_MODE || FXLS8974_FIFO_CAPTURE_MODE */
 
-void fxls89_xx_TimerCallback()
-	{
-	    (void)fxls89xx_event_BLE();
-	    fxls89_xx_CallBack();
-	}
-
-int fxls89xx_event_BLE(void)
+/*! *********************************************************************************
+ * \brief        Runs the SLEEP/WAKE alert state machine for the given SYS_MODE value.
+ *
+ * \param[in]    sysMode     Current FXLS8974 SYS_MODE value.
+ ********************************************************************************** */
+static int fxls89xx_handle_mode(uint8_t sysMode)
 {
-
     int32_t status;
-    uint8_t intStatus, eventStatus = 0;
+    uint8_t intStatus;
     uint8_t int_en;
+#if (FXLS8974_TEMP_COMP_MODE == 1)
+    uint8_t intTemp[2] = {0U, 0U};
+#endif
 
+#if (FXLS8974_WAKE_IRQ_MODE == 0)
+            /* Poll fast while the sensor is awake, back off while it sleeps. */
+            (void)PollSched_Update(&mFxls89xxPoll, (sysMode == FXLS8974_SYS_MODE_SYS_MODE_WAKE));
+#endif
 
-        	eventStatus = 0;
-            /*! Read new raw sensor data from the FXLS8974. */
-            status = FXLS8974_I2C_ReadData(&fxls8974Driver, cFxls8974ReadSysMode, &eventStatus);
-            if (ARM_DRIVER_OK != status)
+            if (sysMode == FXLS8974_SYS_MODE_SYS_MODE_WAKE)
             {
-                return status;
-            }
+#if (FXLS8974_TEMP_COMP_MODE == 1)
+              /* The sensor is running out the ASLP_COUNT after the threshold write. */
+              if (TRUE == mFxls89xxTempCompRestart)
+              {
+                  return 0;
+              }
 
-            if (eventStatus == FXLS8974_SYS_MODE_SYS_MODE_WAKE)
-            {
+              /*! Read INT Status and the temperature from the FXLS8974. */
+              status = FXLS8974_ReadData(&fxls8974Driver, cFxls8974IntEnTemp, intTemp);
+              int_en = intTemp[0];
+#else
               /*! Read INT Status from the FXLS8974. */
-              status = FXLS8974_I2C_ReadData(&fxls8974Driver, cFxls8974IntEn, &int_en);
+              status = FXLS8974_ReadData(&fxls8974Driver, cFxls8974IntEn, &int_en);
+#endif
               if (ARM_DRIVER_OK != status)
               {
             	  BleApp_SendUartStream(&vec_read_failed[0], 70U);
@@ -2084,12 +4316,34 @@ int fxls89xx_event_BLE(void)
                 	GPIO_PortSet(BOARD_INITPINS_LED_GREEN_GPIO, 1u << BOARD_INITPINS_LED_GREEN_PIN);
                 	GPIO_PortSet(BOARD_INITPINS_LED_BLUE_GPIO, 1u << BOARD_INITPINS_LED_BLUE_PIN);
                     /*! Wake Mode Detected. */
+#if (FXLS8974_ORIENT_MODE == 1)
+                  /* Which source woke the sensor, read before the flags move on. */
+                  fxls89xx_read_source();
+#endif
+#if (FXLS8974_CLASSIFY_MODE == 1)
+                  /* The alert waits until the first samples of the motion are classified. */
+                  TamperClassifier_WindowInit(&mFxls89xxWindow);
+                  mFxls89xxClassifying = TRUE;
+#elif (FXLS8974_ASCII_ALERT_MODE == 1)
                   BleApp_SendUartStream(&vec_motion_start[0], 70U);
+#if (FXLS8974_ORIENT_MODE == 1)
+                  fxls89xx_send_source();
+#else
               	  BleApp_SendUartStream(&vec_motion_dec[0], 70U);
+#endif
             	  //BleApp_SendUartStream(&vec_SYSMODE[0], 70U);
                   BleApp_SendUartStream(&vec_motion_end[0], 70U);
             	  //BleApp_SendUartStream(&vec_MCU_wake[0], 70U);
             	  //BleApp_SendUartStream(&vec_enter_sleep[0], 70U);
+#else
+                  fxls89xx_send_event(mTamperEvent_Motion_c, mTamperSeverity_Alert_c, mTamperClass_Count_c);
+#endif
+#if (FXLS8974_FIFO_CAPTURE_MODE == 1)
+                  fxls89xx_buf_start();
+#endif
+#if (FXLS8974_TEMP_COMP_MODE == 1)
+                  fxls89xx_temp_comp(intTemp[1]);
+#endif
 
                     sleeptowake = 0;
                   }
@@ -2105,7 +4359,7 @@ int fxls89xx_event_BLE(void)
                    onetime_modetransition = 0;
                  }
 
-                 status = FXLS8974_I2C_ReadData(&fxls8974Driver, cFxls8974ReadIntStatus, &intStatus);
+                 status = FXLS8974_ReadData(&fxls8974Driver, cFxls8974ReadIntStatus, &intStatus);
                  if (ARM_DRIVER_OK != status)
                  {
                    return status;
@@ -2113,17 +4367,30 @@ int fxls89xx_event_BLE(void)
              	 GPIO_PortSet(BOARD_INITPINS_LED_RED_GPIO, 1u << BOARD_INITPINS_LED_RED_PIN);
              	 GPIO_PortSet(BOARD_INITPINS_LED_GREEN_GPIO, 1u << BOARD_INITPINS_LED_GREEN_PIN);
              	 GPIO_PortSet(BOARD_INITPINS_LED_BLUE_GPIO, 1u << BOARD_INITPINS_LED_BLUE_PIN);
+#if (FXLS8974_ASCII_ALERT_MODE == 1)
              	 BleApp_SendUartStream(&vec_ASLP[0], 70U);
+#else
+             	 fxls89xx_send_event(mTamperEvent_Safe_c, mTamperSeverity_Info_c, mTamperClass_Count_c);
+#endif
            	     //BleApp_SendUartStream(&vec_sleep_mode[0], 70U);
         	     //BleApp_SendUartStream(&vec_MCU_low_Power[0], 70U);
+#if (FXLS8974_FIFO_CAPTURE_MODE == 1)
+                 fxls89xx_buf_stop();
+#endif
                  waketosleep = 0;
                  firsttransition = 0;
                }
                sleeptowake = 1;
+#if (FXLS8974_TEMP_COMP_MODE == 1)
+               mFxls89xxTempCompRestart = FALSE;
+               fxls89xx_temp_comp_apply();
+#endif
 
                //SMC_SetPowerModeWait(SMC);
 
         }
+
+    return 0;
 }
 
 
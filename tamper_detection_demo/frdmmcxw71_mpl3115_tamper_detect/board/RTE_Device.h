@@ -20,7 +20,10 @@ extern void LPUART1_DeinitPins();
 /* User needs to provide the implementation of LPI2CX_GetFreq/LPI2CX_InitPins/LPI2CX_DeinitPins for the enabled LPI2C
  * instance. */
 #define RTE_I2C1        1
+/* Set to 1 (e.g. -DRTE_I2C1_DMA_EN=1) to move sensor transfers on I2C_S_DRIVER from interrupt-per-byte to eDMA. */
+#ifndef RTE_I2C1_DMA_EN
 #define RTE_I2C1_DMA_EN 0
+#endif
 
 /* User needs to provide the implementation of LPSPIX_GetFreq/LPSPIX_InitPins/LPSPIX_DeinitPins for the enabled LPSPI
  * instance. */
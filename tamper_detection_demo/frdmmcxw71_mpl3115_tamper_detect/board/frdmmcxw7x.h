@@ -25,6 +25,11 @@ extern gpioHandleKSDK_t D10;
 #define I2C_S2_DEVICE_INDEX I2C1_INDEX
 #define I2C_S2_SIGNAL_EVENT I2C1_SignalEvent_t
 
+// MPL3115 INT1: shield interrupt line (D5), routed to a WUU capable GPIO
+#define MPL3115_INT1_PORT      PORTC
+#define MPL3115_INT1_PORT_NUM  PORTC_NUM
+#define MPL3115_INT1_PIN       1U
+
 // SPI: Driver information default SPI brought to shield
 #define SPI_S_DRIVER       Driver_SPI1
 #define SPI_S_BAUDRATE     500000U ///< Transfer baudrate - 500k
@@ -25,8 +25,12 @@
 // By default, we use I2C_S1 defined in the frdmmcxw7x.h file.
 // Other options: I2C_S2.
 // S1 is on A5:4.  S2 is on D15:14.
+// All three can be defined by the build to run the sensor drivers on another ARM_DRIVER_I2C,
+// e.g. a register model of the sensors, without touching the application.
+#ifndef I2C_S_DRIVER
 #define I2C_S_DRIVER       I2C_S2_DRIVER
 #define I2C_S_SIGNAL_EVENT I2C_S2_SIGNAL_EVENT
 #define I2C_S_DEVICE_INDEX I2C_S2_DEVICE_INDEX
+#endif
 
 #endif // __ISSDK_HAL_H__
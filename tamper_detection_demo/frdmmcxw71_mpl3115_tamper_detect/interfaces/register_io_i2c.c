@@ -33,10 +33,48 @@ I2C_Type *const i2cBases[] = I2C_BASE_PTRS;
 #endif
 volatile bool b_I2C_CompletionFlag[I2C_COUNT] = {false};
 volatile uint32_t g_I2C_ErrorEvent[I2C_COUNT] = {ARM_I2C_EVENT_TRANSFER_DONE};
+/* Head of the asynchronous transfer queue of each bus, the head is the transfer in progress. */
+static registerasyncxfer_t *volatile s_asyncQueue[I2C_COUNT] = {NULL};
+#if (REGISTER_I2C_PROFILE == 1)
+/* Bus statistics, one entry per device in the order of their first bus operation. */
+static registeri2cprofile_t s_profile[REGISTER_I2C_PROFILE_DEVICES];
+#endif
+
+static void Register_I2C_AsyncEvent(uint8_t instance, uint32_t event);
 
 /*******************************************************************************
  * Code
  ******************************************************************************/
+/* Fetch a register from the shadow cache, returns false on a miss. */
+static bool Register_I2C_CacheLookup(registerDeviceInfo_t *devInfo, uint8_t offset, uint8_t *pValue)
+{
+    registercache_t *pCache = devInfo->pCache;
+
+    if ((pCache == NULL) || (offset >= SENSOR_MAX_REGISTER_COUNT) ||
+        !(pCache->valid[offset >> 3] & (1U << (offset & 0x07))))
+    {
+        return false;
+    }
+    *pValue = pCache->value[offset];
+    return true;
+}
+
+/* Record values known to be in the device registers. */
+static void Register_I2C_CacheUpdate(registerDeviceInfo_t *devInfo, uint8_t offset, const uint8_t *pValues, uint8_t length)
+{
+    registercache_t *pCache = devInfo->pCache;
+    uint16_t reg;
+
+    if (pCache == NULL)
+    {
+        return;
+    }
+    for (reg = offset; (reg < (uint16_t)offset + length) && (reg < SENSOR_MAX_REGISTER_COUNT); reg++)
+    {
+        pCache->value[reg] = *pValues++;
+        pCache->valid[reg >> 3] |= (uint8_t)(1U << (reg & 0x07));
+    }
+}
 
 #if defined(I2C0)
 /* The I2C0 Signal Event Handler function. */
@@ -47,6 +85,7 @@ void I2C0_SignalEvent_t(uint32_t event)
         g_I2C_ErrorEvent[0] = event;
     }
     b_I2C_CompletionFlag[0] = true;
+    Register_I2C_AsyncEvent(0, event);
 }
 #endif
 
@@ -59,6 +98,7 @@ void I2C1_SignalEvent_t(uint32_t event)
         g_I2C_ErrorEvent[1] = event;
     }
     b_I2C_CompletionFlag[1] = true;
+    Register_I2C_AsyncEvent(1, event);
 }
 #endif
 
@@ -71,6 +111,7 @@ void I2C2_SignalEvent_t(uint32_t event)
         g_I2C_ErrorEvent[2] = event;
     }
     b_I2C_CompletionFlag[2] = true;
+    Register_I2C_AsyncEvent(2, event);
 }
 #endif
 
@@ -83,6 +124,7 @@ void I2C3_SignalEvent_t(uint32_t event)
         g_I2C_ErrorEvent[3] = event;
     }
     b_I2C_CompletionFlag[3] = true;
+    Register_I2C_AsyncEvent(3, event);
 }
 #endif
 
@@ -95,6 +137,7 @@ void I2C4_SignalEvent_t(uint32_t event)
         g_I2C_ErrorEvent[4] = event;
     }
     b_I2C_CompletionFlag[4] = true;
+    Register_I2C_AsyncEvent(4, event);
 }
 #endif
 
@@ -107,6 +150,7 @@ void I2C5_SignalEvent_t(uint32_t event)
         g_I2C_ErrorEvent[5] = event;
     }
     b_I2C_CompletionFlag[5] = true;
+    Register_I2C_AsyncEvent(5, event);
 }
 #endif
 
@@ -119,6 +163,7 @@ void I2C6_SignalEvent_t(uint32_t event)
         g_I2C_ErrorEvent[6] = event;
     }
     b_I2C_CompletionFlag[6] = true;
+    Register_I2C_AsyncEvent(6, event);
 }
 #endif
 
@@ -131,6 +176,7 @@ void I2C7_SignalEvent_t(uint32_t event)
         g_I2C_ErrorEvent[7] = event;
     }
     b_I2C_CompletionFlag[7] = true;
+    Register_I2C_AsyncEvent(7, event);
 }
 #endif
 
@@ -144,10 +190,144 @@ void I2C11_SignalEvent_t(uint32_t event)
         g_I2C_ErrorEvent[11] = event;
     }
     b_I2C_CompletionFlag[11] = true;
+    Register_I2C_AsyncEvent(11, event);
 }
 #endif
 #endif
 
+#if (REGISTER_I2C_PROFILE == 1)
+/* Account one bus operation to its device, event 0 stands for an operation the driver refused to start. */
+static void Register_I2C_ProfileRecord(
+    uint8_t instance, uint16_t slaveAddress, uint32_t bytes, uint32_t startTime, uint32_t event)
+{
+    registeri2cprofile_t *pEntry = NULL;
+    uint32_t elapsed = REGISTER_I2C_PROFILE_NOW() - startTime;
+    uint32_t ticks;
+    uint8_t bucket = 0;
+    uint8_t i;
+    uint32_t primask;
+
+    /*! Blocking operations and the asynchronous queue interrupt update the same entries.*/
+    primask = DisableGlobalIRQ();
+    for (i = 0; i < REGISTER_I2C_PROFILE_DEVICES; i++)
+    {
+        if (!s_profile[i].used)
+        {
+            s_profile[i].used = true;
+            s_profile[i].deviceInstance = instance;
+            s_profile[i].slaveAddress = slaveAddress;
+        }
+        if ((s_profile[i].deviceInstance == instance) && (s_profile[i].slaveAddress == slaveAddress))
+        {
+            pEntry = &s_profile[i];
+            break;
+        }
+    }
+    if (pEntry == NULL)
+    {
+        /*! Table full, the device is not tracked.*/
+        EnableGlobalIRQ(primask);
+        return;
+    }
+    if (event == 0)
+    {
+        pEntry->refused++;
+    }
+    else
+    {
+        pEntry->transactions++;
+        if (event == ARM_I2C_EVENT_TRANSFER_DONE)
+        {
+            pEntry->bytes += bytes;
+        }
+        else if (event & ARM_I2C_EVENT_TRANSFER_INCOMPLETE)
+        {
+            pEntry->aborts++;
+        }
+        else
+        {
+            pEntry->errors++;
+        }
+        pEntry->cycles += elapsed;
+        for (ticks = elapsed >> REGISTER_I2C_PROFILE_FIRST_BUCKET;
+             (ticks != 0) && (bucket < REGISTER_I2C_PROFILE_BUCKETS - 1); ticks >>= 1)
+        {
+            bucket++;
+        }
+        pEntry->histogram[bucket]++;
+    }
+    EnableGlobalIRQ(primask);
+}
+#endif
+
+/* Run one blocking bus operation and wait for its Signal Event. */
+static int32_t Register_I2C_Transfer(ARM_DRIVER_I2C *pCommDrv,
+                                     registerDeviceInfo_t *devInfo,
+                                     uint16_t slaveAddress,
+                                     uint8_t *pData,
+                                     uint32_t length,
+                                     bool receive,
+                                     bool xferPending)
+{
+    int32_t status;
+#if (REGISTER_I2C_PROFILE == 1)
+    uint32_t startTime = REGISTER_I2C_PROFILE_NOW();
+#endif
+
+    /*! The queued transfers own the bus and its Signal Event until they complete.*/
+    if (s_asyncQueue[devInfo->deviceInstance] != NULL)
+    {
+        status = ARM_DRIVER_ERROR_BUSY;
+    }
+    else
+    {
+        b_I2C_CompletionFlag[devInfo->deviceInstance] = false;
+        g_I2C_ErrorEvent[devInfo->deviceInstance] = ARM_I2C_EVENT_TRANSFER_DONE;
+        if (receive)
+        {
+            status = pCommDrv->MasterReceive(slaveAddress, pData, length, xferPending);
+        }
+        else
+        {
+            status = pCommDrv->MasterTransmit(slaveAddress, pData, length, xferPending);
+        }
+    }
+    if (ARM_DRIVER_OK != status)
+    {
+#if (REGISTER_I2C_PROFILE == 1)
+        Register_I2C_ProfileRecord(devInfo->deviceInstance, slaveAddress, 0, startTime, 0);
+#endif
+        return status;
+    }
+
+    /* Wait for completion */
+    while (!b_I2C_CompletionFlag[devInfo->deviceInstance])
+    {
+        if (devInfo->idleFunction)
+        {
+            devInfo->idleFunction(devInfo->functionParam);
+        }
+        else
+        {
+            __NOP();
+        }
+    }
+#if (REGISTER_I2C_PROFILE == 1)
+    Register_I2C_ProfileRecord(devInfo->deviceInstance, slaveAddress, length, startTime,
+                               g_I2C_ErrorEvent[devInfo->deviceInstance]);
+#endif
+    if (g_I2C_ErrorEvent[devInfo->deviceInstance] == ARM_I2C_EVENT_TRANSFER_INCOMPLETE)
+    {
+        pCommDrv->Control(ARM_I2C_ABORT_TRANSFER, 0);
+    }
+    if (g_I2C_ErrorEvent[devInfo->deviceInstance] != ARM_I2C_EVENT_TRANSFER_DONE)
+    {
+        return ARM_DRIVER_ERROR;
+    }
+
+    return ARM_DRIVER_OK;
+}
+
 /*! The interface function to block write sensor registers. */
 int32_t Register_I2C_BlockWrite(ARM_DRIVER_I2C *pCommDrv,
                                 registerDeviceInfo_t *devInfo,
@@ -162,31 +342,16 @@ int32_t Register_I2C_BlockWrite(ARM_DRIVER_I2C *pCommDrv,
     buffer[0] = offset;
     memcpy(buffer + 1, pBuffer, bytesToWrite);
 
-    b_I2C_CompletionFlag[devInfo->deviceInstance] = false;
-    g_I2C_ErrorEvent[devInfo->deviceInstance] = ARM_I2C_EVENT_TRANSFER_DONE;
-    status = pCommDrv->MasterTransmit(slaveAddress, buffer, bytesToWrite + 1, false);
+    status = Register_I2C_Transfer(pCommDrv, devInfo, slaveAddress, buffer, bytesToWrite + 1, false, false);
+
+    /*! Keep the shadow registers in step, a failed write leaves them unknown.*/
     if (ARM_DRIVER_OK == status)
     {
-        /* Wait for completion */
-        while (!b_I2C_CompletionFlag[devInfo->deviceInstance])
-        {
-            if (devInfo->idleFunction)
-            {
-                devInfo->idleFunction(devInfo->functionParam);
-            }
-            else
-            {
-                __NOP();
-            }
-        }
-        if (g_I2C_ErrorEvent[devInfo->deviceInstance] == ARM_I2C_EVENT_TRANSFER_INCOMPLETE)
-        {
-            pCommDrv->Control(ARM_I2C_ABORT_TRANSFER, 0);
-        }
-        if (g_I2C_ErrorEvent[devInfo->deviceInstance] != ARM_I2C_EVENT_TRANSFER_DONE)
-        {
-            status = ARM_DRIVER_ERROR;
-        }
+        Register_I2C_CacheUpdate(devInfo, offset, pBuffer, bytesToWrite);
+    }
+    else
+    {
+        Register_I2C_InvalidateCache(devInfo, offset, bytesToWrite);
     }
 
     return status;
@@ -207,68 +372,22 @@ int32_t Register_I2C_Write(ARM_DRIVER_I2C *pCommDrv,
     /*! Set the register based on the values in the register value pair configuration.*/
     if (mask)
     {
-        b_I2C_CompletionFlag[devInfo->deviceInstance] = false;
-        g_I2C_ErrorEvent[devInfo->deviceInstance] = ARM_I2C_EVENT_TRANSFER_DONE;
-        /*! Send the register address to read from.*/
-        status = pCommDrv->MasterTransmit(slaveAddress, &config[0], 1, true);
-        if (ARM_DRIVER_OK == status)
+        /*! Use the cached register value if there is one, otherwise read it back.*/
+        if (!Register_I2C_CacheLookup(devInfo, offset, &config[1]))
         {
-            /* Wait for completion without calling idle function */
-            while (!b_I2C_CompletionFlag[devInfo->deviceInstance])
-            {
-                if (devInfo->idleFunction)
-                {
-                    devInfo->idleFunction(devInfo->functionParam);
-                }
-                else
-                {
-                    __NOP();
-                }
-            };
-            if (g_I2C_ErrorEvent[devInfo->deviceInstance] == ARM_I2C_EVENT_TRANSFER_INCOMPLETE)
+            /*! Send the register address to read from.*/
+            status = Register_I2C_Transfer(pCommDrv, devInfo, slaveAddress, &config[0], 1, false, true);
+            if (ARM_DRIVER_OK != status)
             {
-                pCommDrv->Control(ARM_I2C_ABORT_TRANSFER, 0);
+                return status;
             }
-            if (g_I2C_ErrorEvent[devInfo->deviceInstance] != ARM_I2C_EVENT_TRANSFER_DONE)
+            /*! Read the value.*/
+            status = Register_I2C_Transfer(pCommDrv, devInfo, slaveAddress, &config[1], 1, true, false);
+            if (ARM_DRIVER_OK != status)
             {
-                return ARM_DRIVER_ERROR;
+                return status;
             }
         }
-        else
-        {
-            return status;
-        }
-        b_I2C_CompletionFlag[devInfo->deviceInstance] = false;
-        g_I2C_ErrorEvent[devInfo->deviceInstance] = ARM_I2C_EVENT_TRANSFER_DONE;
-        /*! Read the value.*/
-        status = pCommDrv->MasterReceive(slaveAddress, &config[1], 1, false);
-        if (ARM_DRIVER_OK == status)
-        {
-            /* Wait for completion */
-            while (!b_I2C_CompletionFlag[devInfo->deviceInstance])
-            {
-                if (devInfo->idleFunction)
-                {
-                    devInfo->idleFunction(devInfo->functionParam);
-                }
-                else
-                {
-                    __NOP();
-                }
-            }
-            if (g_I2C_ErrorEvent[devInfo->deviceInstance] == ARM_I2C_EVENT_TRANSFER_INCOMPLETE)
-            {
-                pCommDrv->Control(ARM_I2C_ABORT_TRANSFER, 0);
-            }
-            if (g_I2C_ErrorEvent[devInfo->deviceInstance] != ARM_I2C_EVENT_TRANSFER_DONE)
-            {
-                return ARM_DRIVER_ERROR;
-            }
-        }
-        else
-        {
-            return status;
-        }
         /*! 'OR' in the requested values to the current contents of the register */
         config[1] = (config[1] & ~mask) | value;
     }
@@ -278,32 +397,17 @@ int32_t Register_I2C_Write(ARM_DRIVER_I2C *pCommDrv,
         config[1] = value;
     }
 
-    b_I2C_CompletionFlag[devInfo->deviceInstance] = false;
-    g_I2C_ErrorEvent[devInfo->deviceInstance] = ARM_I2C_EVENT_TRANSFER_DONE;
     /*!  Write the updated value. */
-    status = pCommDrv->MasterTransmit(slaveAddress, config, sizeof(config), repeatedStart);
+    status = Register_I2C_Transfer(pCommDrv, devInfo, slaveAddress, config, sizeof(config), false, repeatedStart);
+
+    /*! Keep the shadow register in step, a failed write leaves it unknown.*/
     if (ARM_DRIVER_OK == status)
     {
-        /* Wait for completion */
-        while (!b_I2C_CompletionFlag[devInfo->deviceInstance])
-        {
-            if (devInfo->idleFunction)
-            {
-                devInfo->idleFunction(devInfo->functionParam);
-            }
-            else
-            {
-                __NOP();
-            }
-        }
-        if (g_I2C_ErrorEvent[devInfo->deviceInstance] == ARM_I2C_EVENT_TRANSFER_INCOMPLETE)
-        {
-            pCommDrv->Control(ARM_I2C_ABORT_TRANSFER, 0);
-        }
-        if (g_I2C_ErrorEvent[devInfo->deviceInstance] != ARM_I2C_EVENT_TRANSFER_DONE)
-        {
-            status = ARM_DRIVER_ERROR;
-        }
+        Register_I2C_CacheUpdate(devInfo, offset, &config[1], 1);
+    }
+    else
+    {
+        Register_I2C_InvalidateCache(devInfo, offset, 1);
     }
 
     return status;
@@ -319,64 +423,437 @@ int32_t Register_I2C_Read(ARM_DRIVER_I2C *pCommDrv,
 {
     int32_t status;
 
-    b_I2C_CompletionFlag[devInfo->deviceInstance] = false;
-    g_I2C_ErrorEvent[devInfo->deviceInstance] = ARM_I2C_EVENT_TRANSFER_DONE;
-    status = pCommDrv->MasterTransmit(slaveAddress, &offset, 1, true);
+    status = Register_I2C_Transfer(pCommDrv, devInfo, slaveAddress, &offset, 1, false, true);
+    if (ARM_DRIVER_OK != status)
+    {
+        return status;
+    }
+
+    /*! Read and update the value.*/
+    status = Register_I2C_Transfer(pCommDrv, devInfo, slaveAddress, pOutBuffer, length, true, false);
+
+    return status;
+}
+
+/*! The interface function to read sensor registers through the shadow register cache. */
+int32_t Register_I2C_ReadCached(ARM_DRIVER_I2C *pCommDrv,
+                                registerDeviceInfo_t *devInfo,
+                                uint16_t slaveAddress,
+                                uint8_t offset,
+                                uint8_t length,
+                                uint8_t *pOutBuffer)
+{
+    int32_t status;
+    uint8_t i;
+
+    /*! Serve the request from the cache only if it holds every register in the range.*/
+    for (i = 0; i < length; i++)
+    {
+        if (!Register_I2C_CacheLookup(devInfo, offset + i, &pOutBuffer[i]))
+        {
+            break;
+        }
+    }
+    if (i == length)
+    {
+        return ARM_DRIVER_OK;
+    }
+
+    status = Register_I2C_Read(pCommDrv, devInfo, slaveAddress, offset, length, pOutBuffer);
     if (ARM_DRIVER_OK == status)
     {
-        /* Wait for completion without calling idle function. */
-        while (!b_I2C_CompletionFlag[devInfo->deviceInstance])
+        Register_I2C_CacheUpdate(devInfo, offset, pOutBuffer, length);
+    }
+
+    return status;
+}
+
+/*! The interface function to attach a shadow register cache to a device. */
+void Register_I2C_AttachCache(registerDeviceInfo_t *devInfo, registercache_t *pCache)
+{
+    devInfo->pCache = pCache;
+    Register_I2C_InvalidateCache(devInfo, 0, SENSOR_MAX_REGISTER_COUNT);
+}
+
+/*! The interface function to invalidate shadow register cache entries. */
+void Register_I2C_InvalidateCache(registerDeviceInfo_t *devInfo, uint8_t offset, uint8_t length)
+{
+    registercache_t *pCache = devInfo->pCache;
+    uint16_t reg;
+
+    if (pCache == NULL)
+    {
+        return;
+    }
+    for (reg = offset; (reg < (uint16_t)offset + length) && (reg < SENSOR_MAX_REGISTER_COUNT); reg++)
+    {
+        pCache->valid[reg >> 3] &= (uint8_t)~(1U << (reg & 0x07));
+    }
+}
+
+/*! The register idle function which puts the CPU in WFI until the I2C transfer completes. */
+void Register_I2C_WaitForInterrupt(void *pDevInfo)
+{
+    registerDeviceInfo_t *devInfo = (registerDeviceInfo_t *)pDevInfo;
+    uint32_t primask;
+
+    /*! A pending interrupt still ends the WFI while masked, it is taken once PRIMASK is restored.*/
+    primask = DisableGlobalIRQ();
+    if (!b_I2C_CompletionFlag[devInfo->deviceInstance])
+    {
+        __DSB();
+        __WFI();
+    }
+    EnableGlobalIRQ(primask);
+}
+
+/* Issue the next bus operation of a transfer. */
+static int32_t Register_I2C_AsyncIssue(registerasyncxfer_t *pXfer)
+{
+    int32_t status;
+
+#if (REGISTER_I2C_PROFILE == 1)
+    pXfer->startTime = REGISTER_I2C_PROFILE_NOW();
+#endif
+    if (pXfer->pReadList == NULL)
+    {
+        status = pXfer->pCommDrv->MasterTransmit(pXfer->slaveAddress, pXfer->writeBuffer, pXfer->writeLength + 1, false);
+    }
+    else if (!pXfer->addressSent)
+    {
+        pXfer->writeBuffer[0] = (uint8_t)pXfer->pEntry->readFrom;
+        status = pXfer->pCommDrv->MasterTransmit(pXfer->slaveAddress, pXfer->writeBuffer, 1, true);
+    }
+    else
+    {
+        status = pXfer->pCommDrv->MasterReceive(pXfer->slaveAddress, pXfer->pDest, pXfer->pEntry->numBytes, false);
+    }
+#if (REGISTER_I2C_PROFILE == 1)
+    if (ARM_DRIVER_OK != status)
+    {
+        Register_I2C_ProfileRecord(pXfer->devInfo->deviceInstance, pXfer->slaveAddress, 0, pXfer->startTime, 0);
+    }
+#endif
+
+    return status;
+}
+
+/* Retire the transfer at the head of the queue and start the next one. */
+static void Register_I2C_AsyncFinish(uint8_t instance, int32_t status)
+{
+    registerasyncxfer_t *pDone;
+    registerasyncxfer_t *pNext;
+    int32_t nextStatus;
+    uint32_t primask;
+
+    do
+    {
+        primask = DisableGlobalIRQ();
+        pDone = s_asyncQueue[instance];
+        if (pDone == NULL)
         {
-            if (devInfo->idleFunction)
-            {
-                devInfo->idleFunction(devInfo->functionParam);
-            }
-            else
-            {
-                __NOP();
-            }
-        };
-        if (g_I2C_ErrorEvent[devInfo->deviceInstance] == ARM_I2C_EVENT_TRANSFER_INCOMPLETE)
+            EnableGlobalIRQ(primask);
+            return;
+        }
+        pNext = pDone->pNext;
+        s_asyncQueue[instance] = pNext;
+        pDone->pNext = NULL;
+        EnableGlobalIRQ(primask);
+
+        /*! Keep the bus busy while the callback runs.*/
+        nextStatus = ARM_DRIVER_OK;
+        if (pNext != NULL)
         {
-            pCommDrv->Control(ARM_I2C_ABORT_TRANSFER, 0);
+            nextStatus = Register_I2C_AsyncIssue(pNext);
         }
-        if (g_I2C_ErrorEvent[devInfo->deviceInstance] != ARM_I2C_EVENT_TRANSFER_DONE)
+
+        if (pDone->callback != NULL)
         {
-            return ARM_DRIVER_ERROR;
+            pDone->callback(status, pDone->userParam);
         }
+
+        /*! A transfer the driver refused to start completes straight away.*/
+        status = nextStatus;
+    } while (ARM_DRIVER_OK != status);
+}
+
+/* Sequence the queued transfers of a bus from its Signal Event Handler. */
+static void Register_I2C_AsyncEvent(uint8_t instance, uint32_t event)
+{
+    registerasyncxfer_t *pXfer = s_asyncQueue[instance];
+    int32_t status;
+
+    if (pXfer == NULL)
+    {
+        return;
     }
-    else
+
+#if (REGISTER_I2C_PROFILE == 1)
+    Register_I2C_ProfileRecord(instance, pXfer->slaveAddress,
+                               (pXfer->pReadList == NULL) ? (uint32_t)pXfer->writeLength + 1 :
+                               (pXfer->addressSent ? pXfer->pEntry->numBytes : 1),
+                               pXfer->startTime, event);
+#endif
+
+    if (event != ARM_I2C_EVENT_TRANSFER_DONE)
     {
-        return status;
+        if (event & ARM_I2C_EVENT_TRANSFER_INCOMPLETE)
+        {
+            pXfer->pCommDrv->Control(ARM_I2C_ABORT_TRANSFER, 0);
+        }
+        if (pXfer->pReadList == NULL)
+        {
+            Register_I2C_InvalidateCache(pXfer->devInfo, pXfer->writeBuffer[0], pXfer->writeLength);
+        }
+        Register_I2C_AsyncFinish(instance, ARM_DRIVER_ERROR);
+        return;
     }
 
-    b_I2C_CompletionFlag[devInfo->deviceInstance] = false;
-    g_I2C_ErrorEvent[devInfo->deviceInstance] = ARM_I2C_EVENT_TRANSFER_DONE;
-    /*! Read and update the value.*/
-    status = pCommDrv->MasterReceive(slaveAddress, pOutBuffer, length, false);
-    if (ARM_DRIVER_OK == status)
+    if (pXfer->pReadList == NULL)
+    {
+        Register_I2C_CacheUpdate(pXfer->devInfo, pXfer->writeBuffer[0], &pXfer->writeBuffer[1], pXfer->writeLength);
+        Register_I2C_AsyncFinish(instance, ARM_DRIVER_OK);
+        return;
+    }
+
+    if (pXfer->addressSent)
     {
-        /* Wait for completion */
-        while (!b_I2C_CompletionFlag[devInfo->deviceInstance])
+        /*! Entry read, move on to the next one in the list.*/
+        pXfer->pDest += pXfer->pEntry->numBytes;
+        pXfer->pEntry++;
+        if (pXfer->pEntry->numBytes == 0)
         {
-            if (devInfo->idleFunction)
-            {
-                devInfo->idleFunction(devInfo->functionParam);
-            }
-            else
-            {
-                __NOP();
-            }
+            Register_I2C_AsyncFinish(instance, ARM_DRIVER_OK);
+            return;
+        }
+    }
+    pXfer->addressSent = !pXfer->addressSent;
+
+    status = Register_I2C_AsyncIssue(pXfer);
+    if (ARM_DRIVER_OK != status)
+    {
+        Register_I2C_AsyncFinish(instance, status);
+    }
+}
+
+/* Append a transfer to the queue of its bus, start it if the bus is idle. */
+static int32_t Register_I2C_AsyncSubmit(registerasyncxfer_t *pXfer)
+{
+    uint8_t instance = pXfer->devInfo->deviceInstance;
+    registerasyncxfer_t *volatile *ppTail;
+    bool idle;
+    int32_t status;
+    uint32_t primask;
+
+    pXfer->pNext = NULL;
+
+    primask = DisableGlobalIRQ();
+    idle = (s_asyncQueue[instance] == NULL);
+    for (ppTail = &s_asyncQueue[instance]; *ppTail != NULL; ppTail = &(*ppTail)->pNext)
+    {
+    }
+    *ppTail = pXfer;
+    EnableGlobalIRQ(primask);
+
+    if (idle)
+    {
+        status = Register_I2C_AsyncIssue(pXfer);
+        if (ARM_DRIVER_OK != status)
+        {
+            Register_I2C_AsyncFinish(instance, status);
         }
-        if (g_I2C_ErrorEvent[devInfo->deviceInstance] == ARM_I2C_EVENT_TRANSFER_INCOMPLETE)
+    }
+
+    return ARM_DRIVER_OK;
+}
+
+/*! The interface function to queue an asynchronous read of sensor registers. */
+int32_t Register_I2C_ReadAsync(ARM_DRIVER_I2C *pCommDrv,
+                               registerDeviceInfo_t *devInfo,
+                               uint16_t slaveAddress,
+                               registerasyncxfer_t *pXfer,
+                               const registerreadlist_t *pReadList,
+                               uint8_t *pOutBuffer,
+                               registerasynccallback_t callback,
+                               void *userParam)
+{
+    if ((pCommDrv == NULL) || (devInfo == NULL) || (pXfer == NULL) || (pReadList == NULL) || (pOutBuffer == NULL) ||
+        (pReadList->numBytes == 0) || (devInfo->deviceInstance >= I2C_COUNT))
+    {
+        return ARM_DRIVER_ERROR_PARAMETER;
+    }
+
+    pXfer->pCommDrv = pCommDrv;
+    pXfer->devInfo = devInfo;
+    pXfer->slaveAddress = slaveAddress;
+    pXfer->pReadList = pReadList;
+    pXfer->pOutBuffer = pOutBuffer;
+    pXfer->callback = callback;
+    pXfer->userParam = userParam;
+    pXfer->writeLength = 0;
+    pXfer->pEntry = pReadList;
+    pXfer->pDest = pOutBuffer;
+    pXfer->addressSent = false;
+
+    return Register_I2C_AsyncSubmit(pXfer);
+}
+
+/*! The interface function to queue an asynchronous write of sensor registers. */
+int32_t Register_I2C_WriteAsync(ARM_DRIVER_I2C *pCommDrv,
+                                registerDeviceInfo_t *devInfo,
+                                uint16_t slaveAddress,
+                                registerasyncxfer_t *pXfer,
+                                uint8_t offset,
+                                const uint8_t *pBuffer,
+                                uint8_t bytesToWrite,
+                                registerasynccallback_t callback,
+                                void *userParam)
+{
+    if ((pCommDrv == NULL) || (devInfo == NULL) || (pXfer == NULL) || (pBuffer == NULL) || (bytesToWrite == 0) ||
+        (bytesToWrite > REGISTER_I2C_ASYNC_MAX_WRITE) || (devInfo->deviceInstance >= I2C_COUNT))
+    {
+        return ARM_DRIVER_ERROR_PARAMETER;
+    }
+
+    pXfer->pCommDrv = pCommDrv;
+    pXfer->devInfo = devInfo;
+    pXfer->slaveAddress = slaveAddress;
+    pXfer->pReadList = NULL;
+    pXfer->pOutBuffer = NULL;
+    pXfer->callback = callback;
+    pXfer->userParam = userParam;
+    pXfer->writeBuffer[0] = offset;
+    memcpy(&pXfer->writeBuffer[1], pBuffer, bytesToWrite);
+    pXfer->writeLength = bytesToWrite;
+
+    return Register_I2C_AsyncSubmit(pXfer);
+}
+
+/*! The interface function to abort every asynchronous transfer queued on a bus. */
+void Register_I2C_AbortAsync(ARM_DRIVER_I2C *pCommDrv, registerDeviceInfo_t *devInfo)
+{
+    registerasyncxfer_t *pXfer;
+    registerasyncxfer_t *pNext;
+    uint32_t primask;
+
+    if ((pCommDrv == NULL) || (devInfo == NULL) || (devInfo->deviceInstance >= I2C_COUNT))
+    {
+        return;
+    }
+
+    primask = DisableGlobalIRQ();
+    pXfer = s_asyncQueue[devInfo->deviceInstance];
+    s_asyncQueue[devInfo->deviceInstance] = NULL;
+    EnableGlobalIRQ(primask);
+
+    if (pXfer != NULL)
+    {
+        pCommDrv->Control(ARM_I2C_ABORT_TRANSFER, 0);
+    }
+
+    /*! Report every dropped transfer, a write may have partly reached the device.*/
+    for (; pXfer != NULL; pXfer = pNext)
+    {
+        pNext = pXfer->pNext;
+        pXfer->pNext = NULL;
+        if (pXfer->pReadList == NULL)
         {
-            pCommDrv->Control(ARM_I2C_ABORT_TRANSFER, 0);
+            Register_I2C_InvalidateCache(pXfer->devInfo, pXfer->writeBuffer[0], pXfer->writeLength);
         }
-        if (g_I2C_ErrorEvent[devInfo->deviceInstance] != ARM_I2C_EVENT_TRANSFER_DONE)
+        if (pXfer->callback != NULL)
         {
-            status = ARM_DRIVER_ERROR;
+            pXfer->callback(REGISTER_I2C_ASYNC_ABORTED, pXfer->userParam);
         }
     }
+}
 
-    return status;
+/*! The interface function to check whether asynchronous transfers are pending on a bus. */
+bool Register_I2C_IsAsyncBusy(registerDeviceInfo_t *devInfo)
+{
+    return (devInfo->deviceInstance < I2C_COUNT) && (s_asyncQueue[devInfo->deviceInstance] != NULL);
+}
+
+#if (REGISTER_I2C_PROFILE == 1)
+/* Append the decimal text of a number, returns the new length. */
+static uint32_t Register_I2C_ProfilePrint(char *pBuffer, uint32_t size, uint32_t length, const char *pLabel, uint64_t value)
+{
+    char digits[20];
+    uint8_t count = 0;
+
+    for (; (*pLabel != '\0') && (length + 1 < size); pLabel++)
+    {
+        pBuffer[length++] = *pLabel;
+    }
+    do
+    {
+        digits[count++] = (char)('0' + (value % 10));
+        value /= 10;
+    } while (value != 0);
+    while ((count != 0) && (length + 1 < size))
+    {
+        pBuffer[length++] = digits[--count];
+    }
+    pBuffer[length] = '\0';
+
+    return length;
+}
+
+/*! The interface function to clear the bus statistics and start the profiler clock. */
+void Register_I2C_ProfileReset(void)
+{
+    uint32_t primask;
+
+#if (REGISTER_I2C_PROFILE_DWT == 1)
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    primask = DisableGlobalIRQ();
+    memset(s_profile, 0, sizeof(s_profile));
+    EnableGlobalIRQ(primask);
 }
+
+/*! The interface function to get the bus statistics of one device. */
+bool Register_I2C_ProfileGet(uint8_t index, registeri2cprofile_t *pProfile)
+{
+    uint32_t primask;
+
+    if ((index >= REGISTER_I2C_PROFILE_DEVICES) || (pProfile == NULL))
+    {
+        return false;
+    }
+
+    primask = DisableGlobalIRQ();
+    *pProfile = s_profile[index];
+    EnableGlobalIRQ(primask);
+
+    return pProfile->used;
+}
+
+/*! The interface function to print the bus statistics of one device as text. */
+uint32_t Register_I2C_ProfileFormat(const registeri2cprofile_t *pProfile, char *pBuffer, uint32_t size)
+{
+    uint32_t length = 0;
+    uint8_t i;
+
+    if ((pBuffer == NULL) || (size == 0))
+    {
+        return 0;
+    }
+
+    length = Register_I2C_ProfilePrint(pBuffer, size, length, "\r\nI2C", pProfile->deviceInstance);
+    length = Register_I2C_ProfilePrint(pBuffer, size, length, " @", pProfile->slaveAddress);
+    length = Register_I2C_ProfilePrint(pBuffer, size, length, " ops ", pProfile->transactions);
+    length = Register_I2C_ProfilePrint(pBuffer, size, length, " B ", pProfile->bytes);
+    length = Register_I2C_ProfilePrint(pBuffer, size, length, " wait ", pProfile->refused);
+    length = Register_I2C_ProfilePrint(pBuffer, size, length, " rty ", pProfile->retries);
+    length = Register_I2C_ProfilePrint(pBuffer, size, length, " abt ", pProfile->aborts);
+    length = Register_I2C_ProfilePrint(pBuffer, size, length, " err ", pProfile->errors);
+    length = Register_I2C_ProfilePrint(pBuffer, size, length, "\r\n cyc ", pProfile->cycles);
+    for (i = 0; i < REGISTER_I2C_PROFILE_BUCKETS; i++)
+    {
+        length = Register_I2C_ProfilePrint(pBuffer, size, length, (i == 0) ? " h " : ",", pProfile->histogram[i]);
+    }
+
+    return length;
+}
+#endif
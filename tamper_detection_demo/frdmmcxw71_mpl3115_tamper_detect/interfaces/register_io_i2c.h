@@ -17,6 +17,92 @@
 #include "sensor_drv.h"
 #include "Driver_I2C.h"
 
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief The maximum number of bytes carried by one asynchronous register write. */
+#define REGISTER_I2C_ASYNC_MAX_WRITE 16
+
+/*! @brief The status reported to transfers dropped by Register_I2C_AbortAsync(). */
+#define REGISTER_I2C_ASYNC_ABORTED (ARM_DRIVER_ERROR_SPECIFIC)
+
+/*! @brief Count the bus operations, bytes, failures and bus time of every device on the sensor buses.
+ *         When disabled, the profiler and its API are compiled out. */
+#ifndef REGISTER_I2C_PROFILE
+#define REGISTER_I2C_PROFILE 0
+#endif
+
+#if (REGISTER_I2C_PROFILE == 1)
+/*! @brief The number of devices, bus instance and slave address pairs, tracked by the profiler. */
+#ifndef REGISTER_I2C_PROFILE_DEVICES
+#define REGISTER_I2C_PROFILE_DEVICES 4
+#endif
+
+/*! @brief The number of latency histogram buckets. */
+#define REGISTER_I2C_PROFILE_BUCKETS 8
+
+/*! @brief Bucket 0 holds the operations shorter than 2^x clock ticks, every next bucket doubles the bound
+ *         and the last bucket holds the rest. 2^11 cycles is about 21us at 96MHz. */
+#ifndef REGISTER_I2C_PROFILE_FIRST_BUCKET
+#define REGISTER_I2C_PROFILE_FIRST_BUCKET 11
+#endif
+
+/*! @brief The free running clock read around every bus operation, the DWT cycle counter by default.
+ *         A host build defines it to its own monotonic clock. */
+#ifndef REGISTER_I2C_PROFILE_NOW
+#define REGISTER_I2C_PROFILE_NOW() (DWT->CYCCNT)
+#define REGISTER_I2C_PROFILE_DWT 1
+#endif
+
+/*!
+ * @brief This structure holds the bus statistics of one device.
+ */
+typedef struct
+{
+    bool used;                 /* The entry has been assigned to a device. */
+    uint8_t deviceInstance;    /* The I2C device number. */
+    uint16_t slaveAddress;     /* The sensor's I2C slave address. */
+    uint32_t transactions;     /* Bus operations, one MasterTransmit or MasterReceive each. */
+    uint32_t bytes;            /* Bytes moved by the operations which completed. */
+    uint32_t refused;          /* Operations refused to start, e.g. bus busy. The caller has to wait and retry. */
+    uint32_t retries;          /* Operations retried after a refusal. Always 0, the interface does not retry. */
+    uint32_t aborts;           /* Operations ended by ARM_I2C_EVENT_TRANSFER_INCOMPLETE. */
+    uint32_t errors;           /* Operations ended by any other error event, e.g. address NACK. */
+    uint64_t cycles;           /* Clock ticks from the start to the end of every operation. */
+    uint32_t histogram[REGISTER_I2C_PROFILE_BUCKETS]; /* Operations per latency bucket. */
+} registeri2cprofile_t;
+#endif
+
+/*!
+ * @brief This is the completion callback type of an asynchronous register transfer.
+ *        It is called from the I2C interrupt with ARM_DRIVER_OK or an ARM_DRIVER_ERROR code.
+ */
+typedef void (*registerasynccallback_t)(int32_t status, void *userParam);
+
+/*!
+ * @brief This structure defines an asynchronous register transfer descriptor.
+ *        The descriptor is owned by the caller and must stay valid until its callback has run.
+ */
+typedef struct _register_async_xfer
+{
+    struct _register_async_xfer *pNext;     /* Next transfer queued on the same bus. */
+    ARM_DRIVER_I2C *pCommDrv;               /* The I2C driver to use. */
+    registerDeviceInfo_t *devInfo;          /* The I2C device number and cache. */
+    uint16_t slaveAddress;                  /* The sensor's I2C slave address. */
+    const registerreadlist_t *pReadList;    /* Registers to read, NULL for a write transfer. */
+    uint8_t *pOutBuffer;                    /* Destination of the registers read. */
+    registerasynccallback_t callback;       /* Called once the transfer is complete. */
+    void *userParam;                        /* Passed back to the callback. */
+    uint8_t writeBuffer[REGISTER_I2C_ASYNC_MAX_WRITE + 1]; /* Register offset followed by the bytes to write. */
+    uint8_t writeLength;                    /* Number of bytes to write after the offset. */
+    const registerreadlist_t *pEntry;       /* Engine private: read list entry in progress. */
+    uint8_t *pDest;                         /* Engine private: destination of the entry in progress. */
+    bool addressSent;                       /* Engine private: the entry offset has been sent. */
+#if (REGISTER_I2C_PROFILE == 1)
+    uint32_t startTime;                     /* Engine private: profiler clock when the operation started. */
+#endif
+} registerasyncxfer_t;
+
 #if defined(I2C0)
 /*! @brief The I2C0 device index. */
 #define I2C0_INDEX 0
@@ -206,4 +292,166 @@ int32_t Register_I2C_Read(ARM_DRIVER_I2C *pCommDrv,
                           uint8_t length,
                           uint8_t *pOutBuffer);
 
+/*!
+ * @brief The interface function to read sensor registers through the shadow register cache.
+ *
+ * If every requested register is held in the cache the values are returned without bus traffic,
+ * otherwise the whole range is read in one burst and the cache is refreshed.
+ *
+ * @param ARM_DRIVER_I2C *pCommDrv - The I2C driver to use.
+ * @param registerDeviceInfo_t *devInfo - The I2C device number, idle function and cache.
+ * @param uint16_t slaveAddress - the sensor's I2C slave address.
+ * @param uint8_t offset - The register/offset to read from
+ * @param uint8_t length - The number of bytes to read
+ * @param uint8_t *pOutBuffer - The pointer to the buffer to store the register value read.
+ *
+ * @return ARM_DRIVER_OK if success or ARM_DRIVER_ERROR if error.
+ */
+int32_t Register_I2C_ReadCached(ARM_DRIVER_I2C *pCommDrv,
+                                registerDeviceInfo_t *devInfo,
+                                uint16_t slaveAddress,
+                                uint8_t offset,
+                                uint8_t length,
+                                uint8_t *pOutBuffer);
+
+/*!
+ * @brief The interface function to attach a shadow register cache to a device.
+ *
+ * Once attached, masked writes use the cached register value instead of reading it back, and
+ * Sensor_I2C_Write() merges list entries on consecutive addresses into one block write.
+ * Only attach a cache to devices which auto-increment the register address on writes.
+ *
+ * @param registerDeviceInfo_t *devInfo - The I2C device to attach the cache to.
+ * @param registercache_t *pCache - The cache storage, or NULL to detach.
+ */
+void Register_I2C_AttachCache(registerDeviceInfo_t *devInfo, registercache_t *pCache);
+
+/*!
+ * @brief The interface function to invalidate shadow register cache entries.
+ *
+ * Must be called for registers which the device changes on its own (self clearing bits, reset).
+ *
+ * @param registerDeviceInfo_t *devInfo - The I2C device whose cache is invalidated.
+ * @param uint8_t offset - The first register/offset to invalidate.
+ * @param uint8_t length - The number of registers to invalidate.
+ */
+void Register_I2C_InvalidateCache(registerDeviceInfo_t *devInfo, uint8_t offset, uint8_t length);
+
+/*!
+ * @brief The register idle function which puts the CPU in WFI until the I2C transfer completes.
+ *
+ * Pass it with the device info as parameter to the sensor SetIdleTask() API. The completion
+ * flag is checked with interrupts masked so an interrupt cannot slip in before the WFI.
+ *
+ * @param void *pDevInfo - The registerDeviceInfo_t of the device waiting on the bus.
+ */
+void Register_I2C_WaitForInterrupt(void *pDevInfo);
+
+/*!
+ * @brief The interface function to queue an asynchronous read of sensor registers.
+ *
+ * The entries of the read list are read one after the other, back to back into pOutBuffer,
+ * without blocking the caller. Transfers on the same bus complete in submission order.
+ *
+ * @param ARM_DRIVER_I2C *pCommDrv - The I2C driver to use.
+ * @param registerDeviceInfo_t *devInfo - The I2C device number.
+ * @param uint16_t slaveAddress - the sensor's I2C slave address.
+ * @param registerasyncxfer_t *pXfer - The transfer descriptor, must not be already queued.
+ * @param registerreadlist_t *pReadList - The list of registers to read.
+ * @param uint8_t *pOutBuffer - The pointer to the buffer to store the register values read.
+ * @param registerasynccallback_t callback - The completion callback, may be NULL.
+ * @param void *userParam - The parameter passed to the callback.
+ *
+ * @return ARM_DRIVER_OK if queued or ARM_DRIVER_ERROR_PARAMETER if the request is invalid.
+ */
+int32_t Register_I2C_ReadAsync(ARM_DRIVER_I2C *pCommDrv,
+                               registerDeviceInfo_t *devInfo,
+                               uint16_t slaveAddress,
+                               registerasyncxfer_t *pXfer,
+                               const registerreadlist_t *pReadList,
+                               uint8_t *pOutBuffer,
+                               registerasynccallback_t callback,
+                               void *userParam);
+
+/*!
+ * @brief The interface function to queue an asynchronous write of sensor registers.
+ *
+ * The bytes are copied into the descriptor, so pBuffer may be reused as soon as this returns.
+ *
+ * @param ARM_DRIVER_I2C *pCommDrv - The I2C driver to use.
+ * @param registerDeviceInfo_t *devInfo - The I2C device number and cache.
+ * @param uint16_t slaveAddress - the sensor's I2C slave address.
+ * @param registerasyncxfer_t *pXfer - The transfer descriptor, must not be already queued.
+ * @param uint8_t offset - The register/offset to write to.
+ * @param uint8_t *pBuffer - The buffer containing bytes to write.
+ * @param uint8_t bytesToWrite - A number of bytes to write, at most REGISTER_I2C_ASYNC_MAX_WRITE.
+ * @param registerasynccallback_t callback - The completion callback, may be NULL.
+ * @param void *userParam - The parameter passed to the callback.
+ *
+ * @return ARM_DRIVER_OK if queued or ARM_DRIVER_ERROR_PARAMETER if the request is invalid.
+ */
+int32_t Register_I2C_WriteAsync(ARM_DRIVER_I2C *pCommDrv,
+                                registerDeviceInfo_t *devInfo,
+                                uint16_t slaveAddress,
+                                registerasyncxfer_t *pXfer,
+                                uint8_t offset,
+                                const uint8_t *pBuffer,
+                                uint8_t bytesToWrite,
+                                registerasynccallback_t callback,
+                                void *userParam);
+
+/*!
+ * @brief The interface function to abort every asynchronous transfer queued on a bus.
+ *
+ * The transfer in progress is stopped and all queued transfers complete with REGISTER_I2C_ASYNC_ABORTED.
+ *
+ * @param ARM_DRIVER_I2C *pCommDrv - The I2C driver to use.
+ * @param registerDeviceInfo_t *devInfo - The I2C device number.
+ */
+void Register_I2C_AbortAsync(ARM_DRIVER_I2C *pCommDrv, registerDeviceInfo_t *devInfo);
+
+/*!
+ * @brief The interface function to check whether asynchronous transfers are pending on a bus.
+ *
+ * The blocking register functions refuse to start on a bus while this returns true, they fail
+ * with ARM_DRIVER_ERROR_BUSY without touching the bus.
+ *
+ * @param registerDeviceInfo_t *devInfo - The I2C device number.
+ *
+ * @return true if at least one asynchronous transfer is queued or in progress.
+ */
+bool Register_I2C_IsAsyncBusy(registerDeviceInfo_t *devInfo);
+
+#if (REGISTER_I2C_PROFILE == 1)
+/*!
+ * @brief The interface function to clear the bus statistics and start the profiler clock.
+ */
+void Register_I2C_ProfileReset(void);
+
+/*!
+ * @brief The interface function to get the bus statistics of one device.
+ *
+ * The devices are listed in the order of their first bus operation.
+ *
+ * @param uint8_t index - The entry to return, from 0 to REGISTER_I2C_PROFILE_DEVICES - 1.
+ * @param registeri2cprofile_t *pProfile - The buffer to copy the entry to.
+ *
+ * @return true if the entry holds a device, false past the last one.
+ */
+bool Register_I2C_ProfileGet(uint8_t index, registeri2cprofile_t *pProfile);
+
+/*!
+ * @brief The interface function to print the bus statistics of one device as text.
+ *
+ * The text fits in two lines of at most 64 characters each.
+ *
+ * @param registeri2cprofile_t *pProfile - The statistics to print.
+ * @param char *pBuffer - The buffer to print to, always nul terminated.
+ * @param uint32_t size - The size of the buffer.
+ *
+ * @return The number of characters printed, the terminator excluded.
+ */
+uint32_t Register_I2C_ProfileFormat(const registeri2cprofile_t *pProfile, char *pBuffer, uint32_t size);
+#endif
+
 #endif // __REGISTER_IO_I2C_H__
@@ -95,6 +95,15 @@ typedef struct
  */
 typedef void (*registeridlefunction_t)(void *userParam);
 
+/*!
+ * @brief This structure defines the shadow copy of a device's register map.
+ */
+typedef struct
+{
+    uint8_t value[SENSOR_MAX_REGISTER_COUNT];     /* Last value written to or read from each register. */
+    uint8_t valid[SENSOR_MAX_REGISTER_COUNT / 8]; /* One bit per register, set when value[] is up to date. */
+} registercache_t;
+
 /*!
  * @brief This structure defines the device specific info required by register I/O.
  */
@@ -103,6 +112,7 @@ typedef struct
     registeridlefunction_t idleFunction;
     void *functionParam;
     uint8_t deviceInstance;
+    registercache_t *pCache; /* Optional shadow register cache, NULL when not used. */
 } registerDeviceInfo_t;
 
 #endif //_SENSOR_DRV_H
@@ -19,6 +19,9 @@
 #include "Driver_I2C.h"
 #include "register_io_i2c.h"
 
+/*! @brief The maximum number of register write list entries merged into one block write. */
+#define SENSOR_I2C_MAX_COALESCE 16
+
 /*******************************************************************************
  * API
  ******************************************************************************/
@@ -33,6 +33,7 @@ int32_t MPL3115_I2C_Initialize(
     pSensorHandle->deviceInfo.deviceInstance = index;
     pSensorHandle->deviceInfo.functionParam = NULL;
     pSensorHandle->deviceInfo.idleFunction = NULL;
+    pSensorHandle->deviceInfo.pCache = NULL;
 
     /*!  Read and store the device's WHO_AM_I.*/
     status = Register_I2C_Read(pBus, &pSensorHandle->deviceInfo, sAddress, MPL3115_WHO_AM_I, 1, &reg);
@@ -136,6 +137,223 @@ int32_t MPL3115_I2C_ReadData(mpl3115_i2c_sensorhandle_t *pSensorHandle,
     return SENSOR_ERROR_NONE;
 }
 
+int32_t MPL3115_I2C_ReadDataAsync(mpl3115_i2c_sensorhandle_t *pSensorHandle,
+                                  registerasyncxfer_t *pXfer,
+                                  const registerreadlist_t *pReadList,
+                                  uint8_t *pBuffer,
+                                  registerasynccallback_t callback,
+                                  void *userParam)
+{
+    int32_t status;
+
+    /*! Validate for the correct handle and register read list.*/
+    if ((pSensorHandle == NULL) || (pXfer == NULL) || (pReadList == NULL) || (pBuffer == NULL))
+    {
+        return SENSOR_ERROR_INVALID_PARAM;
+    }
+
+    /*! Check whether sensor handle is initialized before reading sensor data.*/
+    if (pSensorHandle->isInitialized != true)
+    {
+        return SENSOR_ERROR_INIT;
+    }
+
+    /*! Queue the read list, the callback reports the outcome. */
+    status = Register_I2C_ReadAsync(pSensorHandle->pCommDrv, &pSensorHandle->deviceInfo, pSensorHandle->slaveAddress,
+                                    pXfer, pReadList, pBuffer, callback, userParam);
+    if (ARM_DRIVER_OK != status)
+    {
+        return SENSOR_ERROR_READ;
+    }
+
+    return SENSOR_ERROR_NONE;
+}
+
+int32_t MPL3115_I2C_ReadFifo(mpl3115_i2c_sensorhandle_t *pSensorHandle,
+                             mpl3115_pressuredata_t *pSamples,
+                             uint8_t maxSamples,
+                             uint32_t timestamp,
+                             uint32_t samplePeriod,
+                             uint8_t *pNumSamples,
+                             uint8_t *pFifoStatus)
+{
+    int32_t status;
+    uint8_t fifoStatus;
+    uint8_t count;
+    uint8_t i;
+    uint8_t *pRaw;
+    static uint8_t rawBuffer[MPL3115_FIFO_MAX_SAMPLES * MPL3115_FIFO_SAMPLE_SIZE];
+
+    /*! Validate for the correct handle and output buffers.*/
+    if ((pSensorHandle == NULL) || (pSamples == NULL) || (pNumSamples == NULL) || (maxSamples == 0) ||
+        (maxSamples > MPL3115_FIFO_MAX_SAMPLES))
+    {
+        return SENSOR_ERROR_INVALID_PARAM;
+    }
+
+    /*! Check whether sensor handle is initialized before reading sensor data.*/
+    if (pSensorHandle->isInitialized != true)
+    {
+        return SENSOR_ERROR_INIT;
+    }
+
+    *pNumSamples = 0;
+
+    /*! Read the number of queued samples and the overflow/watermark flags.*/
+    status = Register_I2C_Read(pSensorHandle->pCommDrv, &pSensorHandle->deviceInfo, pSensorHandle->slaveAddress,
+                               MPL3115_F_STATUS, 1, &fifoStatus);
+    if (ARM_DRIVER_OK != status)
+    {
+        return SENSOR_ERROR_READ;
+    }
+    if (pFifoStatus != NULL)
+    {
+        *pFifoStatus = fifoStatus;
+    }
+
+    count = (fifoStatus & MPL3115_F_STATUS_F_CNT_MASK) >> MPL3115_F_STATUS_F_CNT_SHIFT;
+    if (count > maxSamples)
+    {
+        count = maxSamples;
+    }
+    if (count == 0)
+    {
+        return SENSOR_ERROR_NONE;
+    }
+
+    /*! Drain all samples in one burst, the register pointer does not advance past F_DATA. */
+    status = Register_I2C_Read(pSensorHandle->pCommDrv, &pSensorHandle->deviceInfo, pSensorHandle->slaveAddress,
+                               MPL3115_F_DATA, count * MPL3115_FIFO_SAMPLE_SIZE, rawBuffer);
+    if (ARM_DRIVER_OK != status)
+    {
+        return SENSOR_ERROR_READ;
+    }
+
+    /*! Unpack the big-endian samples, the newest one is stamped with timestamp. */
+    pRaw = rawBuffer;
+    for (i = 0; i < count; i++)
+    {
+        pSamples[i].timestamp = timestamp - (uint32_t)(count - 1 - i) * samplePeriod;
+        pSamples[i].pressure = (uint32_t)pRaw[0] << 16 | (uint32_t)pRaw[1] << 8 | pRaw[2];
+        pSamples[i].temperature = (int16_t)((uint16_t)pRaw[3] << 8 | pRaw[4]);
+        pRaw += MPL3115_FIFO_SAMPLE_SIZE;
+    }
+    *pNumSamples = count;
+
+    return SENSOR_ERROR_NONE;
+}
+
+uint32_t MPL3115_AveragePressure(const mpl3115_pressuredata_t *pSamples, uint8_t numSamples)
+{
+    uint32_t sum = 0;
+    uint32_t divisor;
+    uint8_t i;
+
+    if ((pSamples == NULL) || (numSamples == 0))
+    {
+        return 0;
+    }
+
+    /*! Sum the raw 1/64 Pa words, 32 samples of 24 bits cannot overflow. */
+    for (i = 0; i < numSamples; i++)
+    {
+        sum += pSamples[i].pressure;
+    }
+
+    /*! One rounded division keeps the fractional Pa of every sample. */
+    divisor = (uint32_t)numSamples * MPL3115_PRESSURE_CONV_FACTOR;
+
+    return (sum + (divisor / 2)) / divisor;
+}
+
+int32_t MPL3115_I2C_SetPressureWindow(mpl3115_i2c_sensorhandle_t *pSensorHandle, uint32_t target, uint32_t window)
+{
+    int32_t status;
+    uint8_t regs[2];
+
+    /*! Validate for the correct handle.*/
+    if (pSensorHandle == NULL)
+    {
+        return SENSOR_ERROR_INVALID_PARAM;
+    }
+
+    /*! Check whether sensor handle is initialized before writing the target.*/
+    if (pSensorHandle->isInitialized != true)
+    {
+        return SENSOR_ERROR_INIT;
+    }
+
+    /*! Both registers count in 2 Pa steps and hold 16 bits. */
+    target = (target + MPL3115_TARGET_CONV_FACTOR / 2) / MPL3115_TARGET_CONV_FACTOR;
+    window = (window + MPL3115_TARGET_CONV_FACTOR / 2) / MPL3115_TARGET_CONV_FACTOR;
+    if ((target > UINT16_MAX) || (window > UINT16_MAX))
+    {
+        return SENSOR_ERROR_INVALID_PARAM;
+    }
+
+    regs[0] = (uint8_t)(target >> 8);
+    regs[1] = (uint8_t)target;
+    status = Register_I2C_BlockWrite(pSensorHandle->pCommDrv, &pSensorHandle->deviceInfo, pSensorHandle->slaveAddress,
+                                     MPL3115_P_TGT_MSB, regs, sizeof(regs));
+    if (ARM_DRIVER_OK != status)
+    {
+        return SENSOR_ERROR_WRITE;
+    }
+
+    regs[0] = (uint8_t)(window >> 8);
+    regs[1] = (uint8_t)window;
+    status = Register_I2C_BlockWrite(pSensorHandle->pCommDrv, &pSensorHandle->deviceInfo, pSensorHandle->slaveAddress,
+                                     MPL3115_P_WND_MSB, regs, sizeof(regs));
+    if (ARM_DRIVER_OK != status)
+    {
+        return SENSOR_ERROR_WRITE;
+    }
+
+    return SENSOR_ERROR_NONE;
+}
+
+int32_t MPL3115_I2C_SetWindows(
+    mpl3115_i2c_sensorhandle_t *pSensorHandle, uint32_t pTarget, uint32_t pWindow, int8_t tTarget, uint8_t tWindow)
+{
+    int32_t status;
+    uint8_t regs[MPL3115_T_WND - MPL3115_P_TGT_MSB + 1];
+
+    /*! Validate for the correct handle.*/
+    if (pSensorHandle == NULL)
+    {
+        return SENSOR_ERROR_INVALID_PARAM;
+    }
+
+    /*! Check whether sensor handle is initialized before writing the targets.*/
+    if (pSensorHandle->isInitialized != true)
+    {
+        return SENSOR_ERROR_INIT;
+    }
+
+    pTarget = (pTarget + MPL3115_TARGET_CONV_FACTOR / 2) / MPL3115_TARGET_CONV_FACTOR;
+    pWindow = (pWindow + MPL3115_TARGET_CONV_FACTOR / 2) / MPL3115_TARGET_CONV_FACTOR;
+    if ((pTarget > UINT16_MAX) || (pWindow > UINT16_MAX))
+    {
+        return SENSOR_ERROR_INVALID_PARAM;
+    }
+
+    /*! P_TGT, T_TGT, P_WND and T_WND are adjacent, one write covers them all. */
+    regs[MPL3115_P_TGT_MSB - MPL3115_P_TGT_MSB] = (uint8_t)(pTarget >> 8);
+    regs[MPL3115_P_TGT_LSB - MPL3115_P_TGT_MSB] = (uint8_t)pTarget;
+    regs[MPL3115_T_TGT - MPL3115_P_TGT_MSB] = (uint8_t)tTarget;
+    regs[MPL3115_P_WND_MSB - MPL3115_P_TGT_MSB] = (uint8_t)(pWindow >> 8);
+    regs[MPL3115_P_WND_LSB - MPL3115_P_TGT_MSB] = (uint8_t)pWindow;
+    regs[MPL3115_T_WND - MPL3115_P_TGT_MSB] = tWindow;
+    status = Register_I2C_BlockWrite(pSensorHandle->pCommDrv, &pSensorHandle->deviceInfo, pSensorHandle->slaveAddress,
+                                     MPL3115_P_TGT_MSB, regs, sizeof(regs));
+    if (ARM_DRIVER_OK != status)
+    {
+        return SENSOR_ERROR_WRITE;
+    }
+
+    return SENSOR_ERROR_NONE;
+}
+
 int32_t MPL3115_I2C_DeInit(mpl3115_i2c_sensorhandle_t *pSensorHandle)
 {
     int32_t status;
@@ -160,8 +378,9 @@ int32_t MPL3115_I2C_DeInit(mpl3115_i2c_sensorhandle_t *pSensorHandle)
     }
     else
     {
-        /*! De-initialize sensor handle. */
+        /*! De-initialize sensor handle, the reset returned every register to its default. */
         pSensorHandle->isInitialized = false;
+        Register_I2C_InvalidateCache(&pSensorHandle->deviceInfo, 0, SENSOR_MAX_REGISTER_COUNT);
     }
 
     return SENSOR_ERROR_NONE;
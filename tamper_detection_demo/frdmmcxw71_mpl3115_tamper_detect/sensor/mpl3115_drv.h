@@ -27,6 +27,9 @@
 #define MPL3115_PRESSURE_CONV_FACTOR (64)     /* Will give Pascals */
 #define MPL3115_ALTITUDE_CONV_FACTOR (65536)  /* Will give meters above MSL */
 #define MPL3115_TEMPERATURE_CONV_FACTOR (256) /* Will give �C */
+#define MPL3115_TARGET_CONV_FACTOR (2)       /* P_TGT/P_WND LSB in Pascals */
+#define MPL3115_FIFO_MAX_SAMPLES (32)         /* Depth of the on-chip FIFO */
+#define MPL3115_FIFO_SAMPLE_SIZE (5)          /* 3 byte Pressure/Altitude and 2 byte Temperature per FIFO entry */
 
 /*******************************************************************************
  * Definitions
@@ -116,6 +119,96 @@ int32_t MPL3115_I2C_ReadData(mpl3115_i2c_sensorhandle_t *pSensorHandle,
                              const registerreadlist_t *pReadList,
                              uint8_t *pBuffer);
 
+/*! @brief       The interface function to read the sensor data without blocking.
+ *  @details     This function queues the reads of the register list on the I2C bus and returns immediately.
+ *               The callback runs from the I2C interrupt once pBuffer holds the data or the read failed.
+ *  @param[in]   pSensorHandle  handle to the sensor.
+ *  @param[in]   pXfer          transfer descriptor, owned by the caller until the callback has run.
+ *  @param[in]   pReadList      pointer to the list of device registers and values to read.
+ *  @param[out]  pBuffer        buffer which holds raw sensor data.
+ *  @param[in]   callback       completion callback, receives ARM_DRIVER_OK or an ARM_DRIVER_ERROR code.
+ *  @param[in]   userParam      parameter passed to the callback.
+ *  @constraints This can be called only after MPL3115_I2C_Initialize().
+ *               The blocking APIs must not be used while the transfer is pending.
+ *  @reeentrant  Yes
+ *  @return      ::MPL3115_I2C_ReadDataAsync() returns the status .
+ */
+int32_t MPL3115_I2C_ReadDataAsync(mpl3115_i2c_sensorhandle_t *pSensorHandle,
+                                  registerasyncxfer_t *pXfer,
+                                  const registerreadlist_t *pReadList,
+                                  uint8_t *pBuffer,
+                                  registerasynccallback_t callback,
+                                  void *userParam);
+
+/*! @brief       The interface function to drain the sensor FIFO.
+ *  @details     This function reads F_STATUS and then empties every queued sample in one burst read of F_DATA,
+ *               the FIFO pops a new entry every MPL3115_FIFO_SAMPLE_SIZE bytes. Samples are returned oldest first
+ *               and time stamped backwards from timestamp, which is taken as the time of the newest sample.
+ *               Reading F_STATUS also clears the FIFO watermark and overflow interrupt.
+ *  @param[in]   pSensorHandle handle to the sensor.
+ *  @param[out]  pSamples      array of at least maxSamples entries which receives the samples.
+ *  @param[in]   maxSamples    size of pSamples, at most MPL3115_FIFO_MAX_SAMPLES.
+ *  @param[in]   timestamp     time of the newest sample.
+ *  @param[in]   samplePeriod  time between two samples at the current time step, in the same unit as timestamp.
+ *  @param[out]  pNumSamples   number of samples written to pSamples.
+ *  @param[out]  pFifoStatus   optional, the F_STATUS value read before the drain (F_OVF, F_WMRK_FLAG).
+ *  @constraints This can be called any number of times only after MPL3115_I2C_Initialize().
+ *               The FIFO must be enabled through F_SETUP.
+ *               Application has to ensure that previous instances of these APIs have exited before invocation.
+ *  @reeentrant  No
+ *  @return      ::MPL3115_I2C_ReadFifo() returns the status .
+ */
+int32_t MPL3115_I2C_ReadFifo(mpl3115_i2c_sensorhandle_t *pSensorHandle,
+                             mpl3115_pressuredata_t *pSamples,
+                             uint8_t maxSamples,
+                             uint32_t timestamp,
+                             uint32_t samplePeriod,
+                             uint8_t *pNumSamples,
+                             uint8_t *pFifoStatus);
+
+/*! @brief       The interface function to average a drained FIFO batch.
+ *  @details     This function averages the raw pressure of the samples read by MPL3115_I2C_ReadFifo() in fixed
+ *               point, with a single rounded division so the fraction of every sample counts.
+ *  @param[in]   pSamples      samples in barometer mode.
+ *  @param[in]   numSamples    number of samples, 1..MPL3115_FIFO_MAX_SAMPLES.
+ *  @constraints None.
+ *  @reeentrant  Yes
+ *  @return      ::MPL3115_AveragePressure() returns the mean pressure in Pascals rounded to nearest, 0 for no sample.
+ */
+uint32_t MPL3115_AveragePressure(const mpl3115_pressuredata_t *pSamples, uint8_t numSamples);
+
+/*! @brief       The interface function to program the pressure alarm window.
+ *  @details     This function writes P_TGT and P_WND, the sensor raises SRC_PW when the pressure crosses
+ *               target +/- window. The values are rounded to the 2 Pa resolution of the registers.
+ *  @param[in]   pSensorHandle handle to the sensor.
+ *  @param[in]   target        centre of the window in Pascals.
+ *  @param[in]   window        half width of the window in Pascals.
+ *  @constraints This can be called any number of times only after MPL3115_I2C_Initialize().
+ *               The sensor must be in barometer mode and CTRL_REG2 ALARM_SEL must select the target registers.
+ *               Application has to ensure that previous instances of these APIs have exited before invocation.
+ *  @reeentrant  No
+ *  @return      ::MPL3115_I2C_SetPressureWindow() returns the status .
+ */
+int32_t MPL3115_I2C_SetPressureWindow(mpl3115_i2c_sensorhandle_t *pSensorHandle, uint32_t target, uint32_t window);
+
+/*! @brief       The interface function to program the pressure and temperature alarm windows.
+ *  @details     This function writes P_TGT, T_TGT, P_WND and T_WND in one burst, the sensor raises SRC_PW when the
+ *               pressure crosses pTarget +/- pWindow and SRC_TW when the temperature crosses tTarget +/- tWindow.
+ *               The pressures are rounded to the 2 Pa resolution of the registers.
+ *  @param[in]   pSensorHandle handle to the sensor.
+ *  @param[in]   pTarget       centre of the pressure window in Pascals.
+ *  @param[in]   pWindow       half width of the pressure window in Pascals.
+ *  @param[in]   tTarget       centre of the temperature window in degrees Celsius.
+ *  @param[in]   tWindow       half width of the temperature window in degrees Celsius.
+ *  @constraints This can be called any number of times only after MPL3115_I2C_Initialize().
+ *               The sensor must be in barometer mode and CTRL_REG2 ALARM_SEL must select the target registers.
+ *               Application has to ensure that previous instances of these APIs have exited before invocation.
+ *  @reeentrant  No
+ *  @return      ::MPL3115_I2C_SetWindows() returns the status .
+ */
+int32_t MPL3115_I2C_SetWindows(
+    mpl3115_i2c_sensorhandle_t *pSensorHandle, uint32_t pTarget, uint32_t pWindow, int8_t tTarget, uint8_t tWindow);
+
 /*! @brief       The interface function to De Initialize sensor..
  *  @details     This function made sensor in a power safe state and de initialize its handle.
  *  @param[in]   pSensorHandle      handle to the sensor.
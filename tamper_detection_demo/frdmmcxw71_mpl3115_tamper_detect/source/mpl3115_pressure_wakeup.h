@@ -19,6 +19,15 @@
 #include "issdk_hal.h"
 #include "gpio_driver.h"
 #include "mpl3115_drv.h"
+#include "sensor_engine.h"
+#include "baseline_tracker.h"
+#include "poll_scheduler.h"
+#include "capture_ring.h"
+#include "temp_comp.h"
+#include "sensor_registry.h"
+#include "tamper_event.h"
+#include "tx_queue.h"
+#include "tamper_beacon.h"
 #include "systick_utils.h"
 
 //-----------------------------------------------------------------------
@@ -38,6 +47,149 @@
 #define MPL3115_SAMPLING_EXPONENT (2) /* 2 seconds */
 /*! @brief Avg number of samples to compute baseline pressure value. */
 #define NUM_AVG_SAMPLES 5
+
+/*! @brief Pressure threshold in Pa, the half width of the window in MPL3115_WINDOW_DETECT_MODE. */
+#ifndef PRESSURE_THS
+#define PRESSURE_THS 60
+#endif
+
+/*! @brief Collect the baseline samples in the on-chip FIFO and drain them in one burst on the watermark
+ *         interrupt (INT1) instead of polling STATUS/OUT for every sample. */
+#ifndef MPL3115_FIFO_BASELINE_MODE
+#define MPL3115_FIFO_BASELINE_MODE  1
+#endif
+
+/*! @brief Let the sensor compare the pressure against a window around the baseline and raise INT1 when it leaves,
+ *         instead of reading and comparing every sample in software. Shares INT1 with the FIFO baseline. */
+#ifndef MPL3115_WINDOW_DETECT_MODE
+#define MPL3115_WINDOW_DETECT_MODE  1
+#endif
+
+#if (MPL3115_WINDOW_DETECT_MODE == 1) && (MPL3115_FIFO_BASELINE_MODE != 1)
+#error "MPL3115_WINDOW_DETECT_MODE re-centres the window from the FIFO baseline, enable MPL3115_FIFO_BASELINE_MODE"
+#endif
+
+/*! @brief Time constant of the drift tracking baseline, 2^x samples (64 samples, about 4 minutes). */
+#define MPL3115_BASELINE_SHIFT  6U
+/*! @brief A deviation must also exceed this many standard deviations of the recent samples to raise an alert. */
+#define MPL3115_BASELINE_GATE   4U
+
+/*! @brief Time between two samples at the auto acquisition time step, used to time stamp drained samples. */
+#define MPL3115_SAMPLE_PERIOD_US  ((1UL << MPL3115_SAMPLING_EXPONENT) * 1000000UL)
+
+/*! @brief Pressure poll interval bounds and back-off, see poll_scheduler.h. The interval stretches by 1/2^GROW_SHIFT
+ *         per quiet poll once QUIET_POLLS quiet polls have been seen, and drops back to MIN_MS on any activity. */
+#ifndef MPL3115_POLL_MIN_MS
+#define MPL3115_POLL_MIN_MS       100U
+#endif
+#ifndef MPL3115_POLL_MAX_MS
+#define MPL3115_POLL_MAX_MS       2000U
+#endif
+#ifndef MPL3115_POLL_GROW_SHIFT
+#define MPL3115_POLL_GROW_SHIFT   1U
+#endif
+#ifndef MPL3115_POLL_QUIET_POLLS
+#define MPL3115_POLL_QUIET_POLLS  50U
+#endif
+
+/*! @brief Keep a ring of the latest pressure samples and send the samples around each alert to the peers.
+ *         The ring takes CAPTURE_RING_BUDGET(MPL3115_SNAPSHOT_SAMPLES) bytes of static RAM, reserved at build time.
+ *         The post trigger samples are the ones the re-baseline after the alert reads. */
+#ifndef MPL3115_SNAPSHOT_MODE
+#define MPL3115_SNAPSHOT_MODE     0
+#endif
+
+/*! @brief Ring size in samples (a power of two), and the samples sent before and after the alert. */
+#ifndef MPL3115_SNAPSHOT_SAMPLES
+#define MPL3115_SNAPSHOT_SAMPLES  32U
+#endif
+#if (MPL3115_SNAPSHOT_SAMPLES == 0U) || ((MPL3115_SNAPSHOT_SAMPLES & (MPL3115_SNAPSHOT_SAMPLES - 1U)) != 0U)
+#error "MPL3115_SNAPSHOT_SAMPLES must be a power of two"
+#endif
+#ifndef MPL3115_SNAPSHOT_PRE
+#define MPL3115_SNAPSHOT_PRE      16U
+#endif
+#ifndef MPL3115_SNAPSHOT_POST
+#define MPL3115_SNAPSHOT_POST     NUM_AVG_SAMPLES
+#endif
+
+/*! @brief Correct the pressure for the temperature read in the same burst, with the per-unit coefficients kept in
+ *         NVM. In window mode the sensor also watches a temperature window, the pressure window is only moved when
+ *         the correction has changed by more than MPL3115_TEMP_COMP_HYS. */
+#ifndef MPL3115_TEMP_COMP_MODE
+#define MPL3115_TEMP_COMP_MODE      0
+#endif
+
+/*! @brief Change of the correction which moves the pressure window, Pa. One P_TGT step is 2 Pa. */
+#ifndef MPL3115_TEMP_COMP_HYS
+#define MPL3115_TEMP_COMP_HYS       2
+#endif
+
+/*! @brief Half width of the temperature window which wakes the MCU to check the correction, degrees C. */
+#ifndef MPL3115_TEMP_COMP_STEP_C
+#define MPL3115_TEMP_COMP_STEP_C    2U
+#endif
+
+/*! @brief NVM data set of the coefficients, programmed per unit at production (e.g. with the FSCI NV commands). */
+#define MPL3115_TEMP_COMP_NVM_ID    0x4030
+
+/*! @brief Send the alerts as the text banners of a terminal instead of the binary event records, for debugging.
+ *         A text alert takes three 70 byte writes, a binary record one write of 9 to 20 bytes. */
+#ifndef MPL3115_ASCII_ALERT_MODE
+#define MPL3115_ASCII_ALERT_MODE    0
+#endif
+
+/*! @brief Batch window of the event records, ms. The records raised within the window go out back to back in one
+ *         write, an alert flushes the batch at once. 0 sends every record on its own. */
+#ifndef MPL3115_EVENT_BATCH_MS
+#define MPL3115_EVENT_BATCH_MS      20U
+#endif
+
+/*! @brief Broadcast the latest event record as a tamper beacon, in a non-connectable extended advertising set next
+ *         to the connectable one, so a gateway gets the alerts without connecting. The sensor starts with the
+ *         beacon instead of waiting for a peer. */
+#ifndef MPL3115_BROADCAST_MODE
+#define MPL3115_BROADCAST_MODE       0
+#endif
+
+/*! @brief Advertising interval of the beacon during the burst after an event, ms, 20 at least. */
+#ifndef MPL3115_BROADCAST_FAST_MS
+#define MPL3115_BROADCAST_FAST_MS    20U
+#endif
+
+/*! @brief Length of the burst after an event, ms. */
+#ifndef MPL3115_BROADCAST_BURST_MS
+#define MPL3115_BROADCAST_BURST_MS   3000U
+#endif
+
+/*! @brief Advertising interval of the beacon between the bursts, ms. */
+#ifndef MPL3115_BROADCAST_SLOW_MS
+#define MPL3115_BROADCAST_SLOW_MS    2000U
+#endif
+
+/*! @brief AES-128 key of the beacon MIC, shared with the gateways. There is no default, each deployment sets its
+ *         own, e.g. -DMPL3115_BROADCAST_KEY="{0x..U, ...}" with 16 bytes. */
+#if (MPL3115_BROADCAST_MODE == 1) && !defined(MPL3115_BROADCAST_KEY)
+#error "MPL3115_BROADCAST_MODE needs the key shared with the gateways, define MPL3115_BROADCAST_KEY"
+#endif
+
+/*! @brief Beacon counter values reserved in NVM at a time. After a reset the counter goes on from the end of the
+ *         reserved values, so a gateway never sees one twice, for one NVM write per window. */
+#ifndef MPL3115_BROADCAST_COUNTER_WINDOW
+#define MPL3115_BROADCAST_COUNTER_WINDOW 1024U
+#endif
+
+/*! @brief NVM data set of the beacon counter. */
+#define MPL3115_BROADCAST_NVM_ID     0x4031
+
+#if (MPL3115_BROADCAST_MODE == 1) && !(defined(gAppUseNvm_d) && (gAppUseNvm_d > 0))
+#error "MPL3115_BROADCAST_MODE keeps the beacon counter in NVM, enable gAppUseNvm_d"
+#endif
+
+#if (MPL3115_BROADCAST_MODE == 1) && (MPL3115_ASCII_ALERT_MODE == 1)
+#error "MPL3115_BROADCAST_MODE advertises the binary event records, disable MPL3115_ASCII_ALERT_MODE"
+#endif
+
 //-----------------------------------------------------------------------
 // Constants
 //-----------------------------------------------------------------------
@@ -53,6 +205,49 @@ const registerwritelist_t cMpl3115ConfigNormal[] = {
     {MPL3115_CTRL_REG2, MPL3115_SAMPLING_EXPONENT, MPL3115_CTRL_REG2_ST_MASK},
     __END_WRITE_DATA__};
 
+#if (MPL3115_FIFO_BASELINE_MODE == 1)
+/*! @brief Register settings to queue the baseline samples in the FIFO, the watermark raises INT1 (active high). */
+const registerwritelist_t cMpl3115FifoStart[] = {
+    /* Circular mode keeps the newest samples should the drain be late. */
+    {MPL3115_F_SETUP, MPL3115_F_SETUP_F_MODE_CIR_MODE | NUM_AVG_SAMPLES,
+     MPL3115_F_SETUP_F_MODE_MASK | MPL3115_F_SETUP_F_WMRK_MASK},
+    {MPL3115_CTRL_REG3, MPL3115_CTRL_REG3_IPOL1_HIGH | MPL3115_CTRL_REG3_PP_OD1_INTPULLUP,
+     MPL3115_CTRL_REG3_IPOL1_MASK | MPL3115_CTRL_REG3_PP_OD1_MASK},
+    {MPL3115_CTRL_REG4, MPL3115_CTRL_REG4_INT_EN_FIFO_INTENABLED, MPL3115_CTRL_REG4_INT_EN_FIFO_MASK},
+    {MPL3115_CTRL_REG5, MPL3115_CTRL_REG5_INT_CFG_FIFO_INT1, MPL3115_CTRL_REG5_INT_CFG_FIFO_MASK},
+    __END_WRITE_DATA__};
+
+/*! @brief Register settings to return to direct STATUS/OUT reads once the baseline is taken. */
+const registerwritelist_t cMpl3115FifoStop[] = {
+    {MPL3115_CTRL_REG4, MPL3115_CTRL_REG4_INT_EN_FIFO_INTDISABLED, MPL3115_CTRL_REG4_INT_EN_FIFO_MASK},
+    {MPL3115_F_SETUP, MPL3115_F_SETUP_F_MODE_FIFO_OFF, MPL3115_F_SETUP_F_MODE_MASK},
+    __END_WRITE_DATA__};
+#endif
+
+#if (MPL3115_WINDOW_DETECT_MODE == 1)
+/*! @brief Register settings to raise INT1 when the pressure leaves the P_TGT +/- P_WND window. */
+const registerwritelist_t cMpl3115WindowStart[] = {
+    {MPL3115_CTRL_REG2, MPL3115_CTRL_REG2_ALARM_SEL_USE_TGT, MPL3115_CTRL_REG2_ALARM_SEL_MASK},
+    {MPL3115_CTRL_REG3, MPL3115_CTRL_REG3_IPOL1_HIGH | MPL3115_CTRL_REG3_PP_OD1_INTPULLUP,
+     MPL3115_CTRL_REG3_IPOL1_MASK | MPL3115_CTRL_REG3_PP_OD1_MASK},
+    {MPL3115_CTRL_REG4, MPL3115_CTRL_REG4_INT_EN_PW_INTENABLED, MPL3115_CTRL_REG4_INT_EN_PW_MASK},
+    {MPL3115_CTRL_REG5, MPL3115_CTRL_REG5_INT_CFG_PW_INT1, MPL3115_CTRL_REG5_INT_CFG_PW_MASK},
+#if (MPL3115_TEMP_COMP_MODE == 1)
+    /* The temperature window shares INT1, it tells when the pressure window may need to move. */
+    {MPL3115_CTRL_REG4, MPL3115_CTRL_REG4_INT_EN_TW_INTENABLED, MPL3115_CTRL_REG4_INT_EN_TW_MASK},
+    {MPL3115_CTRL_REG5, MPL3115_CTRL_REG5_INT_CFG_TW_INT1, MPL3115_CTRL_REG5_INT_CFG_TW_MASK},
+#endif
+    __END_WRITE_DATA__};
+
+/*! @brief Register settings to mask the pressure window interrupt. */
+const registerwritelist_t cMpl3115WindowStop[] = {
+    {MPL3115_CTRL_REG4, MPL3115_CTRL_REG4_INT_EN_PW_INTDISABLED, MPL3115_CTRL_REG4_INT_EN_PW_MASK},
+#if (MPL3115_TEMP_COMP_MODE == 1)
+    {MPL3115_CTRL_REG4, MPL3115_CTRL_REG4_INT_EN_TW_INTDISABLED, MPL3115_CTRL_REG4_INT_EN_TW_MASK},
+#endif
+    __END_WRITE_DATA__};
+#endif
+
 /*! @brief Address of Status Register. */
 const registerreadlist_t cMpl3115Status[] = {{.readFrom = MPL3115_STATUS, .numBytes = 1}, __END_READ_DATA__};
 
@@ -60,6 +255,20 @@ const registerreadlist_t cMpl3115Status[] = {{.readFrom = MPL3115_STATUS, .numBy
 const registerreadlist_t cMpl3115OutputNormal[] = {{.readFrom = MPL3115_OUT_P_MSB, .numBytes = MPL3115_DATA_SIZE},
                                                    __END_READ_DATA__};
 
+/*! @brief WHO_AM_I values of the parts served by the MPL3115 driver, the keys of cMpl3115Variants. */
+const uint8_t cMpl3115WhoAmI[] = {MPL3115_WHOAMI_VALUE, FXPQ3115_WHOAMI_VALUE};
+
+/*! @brief Parts served by the MPL3115 driver, they share the register map and the configuration. */
+#define MPL3115_CAPS (SENSOR_CAP_BUFFER | SENSOR_CAP_TEMP | SENSOR_CAP_ALTIMETER | SENSOR_CAP_WINDOW)
+const sensorvariant_t cMpl3115Variants[] = {
+    {cMpl3115WhoAmI, sizeof(cMpl3115WhoAmI), SENSOR_FAMILY_PRESSURE, 3115U, MPL3115_CAPS, MPL3115_FIFO_MAX_SAMPLES, 0U,
+     1U, "MPL3115/FXPQ3115", cMpl3115ConfigNormal},
+};
+
+/*! @brief Back-off policy of the Pressure poll. */
+const pollschedconfig_t cMpl3115PollConfig = {MPL3115_POLL_MIN_MS, MPL3115_POLL_MAX_MS, MPL3115_POLL_GROW_SHIFT,
+                                              MPL3115_POLL_QUIET_POLLS};
+
 
 //-----------------------------------------------------------------------
 // Global Variables
@@ -67,6 +276,15 @@ const registerreadlist_t cMpl3115OutputNormal[] = {{.readFrom = MPL3115_OUT_P_MS
 
     ARM_DRIVER_I2C *I2Cdrv = &I2C_S_DRIVER;
     mpl3115_i2c_sensorhandle_t mpl3115Driver;
+    /* Variant found at init, NULL until a known part answered. */
+    const sensorvariant_t *pMpl3115Variant = NULL;
+    /* WHO_AM_I of the part that answered. */
+    uint8_t mpl3115WhoAmI = 0U;
+    /* Shadow copy of the MPL3115 registers, saves the read-back of masked writes. */
+    registercache_t mpl3115RegCache;
+    /* Sensors of the shared I2C bus, serviced by the sensor engine. */
+    sensorengine_t mpl3115Engine;
+    sensorengineslot_t mpl3115Slot;
     /* Define the init structure for the output LED pin*/
     gpio_pin_config_t led_config = {
         kGPIO_DigitalOutput,
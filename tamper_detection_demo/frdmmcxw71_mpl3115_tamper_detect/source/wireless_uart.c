@@ -26,6 +26,7 @@
 #include "fsl_component_button.h"
 #include "fsl_component_led.h"
 #include "fsl_component_timer_manager.h"
+#include "fsl_adapter_gpio.h"
 #include "fsl_component_panic.h"
 #include "fsl_component_serial_manager.h"
 #include "fsl_component_mem_manager.h"
@@ -75,6 +76,15 @@
 #include "app.h"
 
 #include "mpl3115_pressure_wakeup.h"
+#if (MPL3115_BROADCAST_MODE == 1)
+#include "SecLib.h"
+#endif
+#if ((MPL3115_TEMP_COMP_MODE == 1) || (MPL3115_BROADCAST_MODE == 1)) && defined(gAppUseNvm_d) && (gAppUseNvm_d > 0)
+#include "NVM_Interface.h"
+#endif
+#if (defined(RTE_I2C1_DMA_EN) && RTE_I2C1_DMA_EN)
+#include "fsl_edma.h"
+#endif
 
 /************************************************************************************
  *************************************************************************************
@@ -86,7 +96,15 @@
 
 #define mAppUartFlushIntervalInMs_c     (7)     /* Flush Timeout in Ms */
 
-#define mmpl3115IntervalInMs_c     (100)     /* Flush Timeout in Ms */
+#define mAppTxRetryIntervalInMs_c       (20)    /* TX queue retry interval in Ms */
+#define mAppTxAlertReserve_c            (1U)    /* TX queue entries a snapshot leaves free for an alert */
+#if (MPL3115_BROADCAST_MODE == 1)
+#if (gWuart_PeripheralRole_c == 0)
+#error "MPL3115_BROADCAST_MODE advertises the tamper beacon, enable gWuart_PeripheralRole_c"
+#endif
+#define mAppBeaconHandle_c              (1U)    /* Advertising set of the tamper beacon, set 0 is the connectable one */
+#define mAppAdvInterval(ms)             (((ms) * 8U) / 5U) /* ms to 0.625 ms */
+#endif
 
 #define mBatteryLevelReportInterval_c   (10)    /* battery level report interval in seconds  */
 
@@ -111,9 +129,6 @@
 #define Serial_PrintDec(a)              (void)SerialManager_WriteBlocking((serial_write_handle_t)s_writeHandle, FORMAT_Dec2Str(a), strlen((char const *)FORMAT_Dec2Str(a)))
 #define Serial_PrintHex(a)              (void)SerialManager_WriteBlocking((serial_write_handle_t)s_writeHandle, FORMAT_Hex2Ascii(a), strlen((const char*)FORMAT_Hex2Ascii(a)))
 
-/*! @brief Pressure threshold in Pa*/
-#define PRESSURE_THS 60                                                                           \
-
 /************************************************************************************
  *************************************************************************************
  * Private type definitions
@@ -127,7 +142,8 @@ typedef enum appEvent_tag
     mAppEvt_ServiceDiscoveryNotFound_c,
     mAppEvt_ServiceDiscoveryFailed_c,
     mAppEvt_GattProcComplete_c,
-    mAppEvt_GattProcError_c
+    mAppEvt_GattProcError_c,
+    mAppEvt_TamperNotifyEnabled_c
 } appEvent_t;
 
 typedef enum appState_tag
@@ -136,7 +152,8 @@ typedef enum appState_tag
     mAppExchangeMtu_c,
     mAppServiceDisc_c,
     mAppServiceDiscRetry_c,
-    mAppRunning_c
+    mAppRunning_c,
+    mAppTamperNotify_c
 } appState_t;
 
 typedef struct appPeerInfo_tag
@@ -177,12 +194,41 @@ static void BleApp_GattClientCallback(deviceId_t serverDeviceId, gattProcedureTy
 static void BleApp_ServiceDiscoveryCallback(deviceId_t peerDeviceId, servDiscEvent_t *pEvent);
 static void BleApp_StateMachineHandler(deviceId_t peerDeviceId, appEvent_t event);
 static void BleApp_StoreServiceHandles(deviceId_t peerDeviceId, gattService_t *pService);
+static bool_t BleApp_TamperNotifyEnabled(deviceId_t peerDeviceId);
+static void BleApp_StartTamperNotify(deviceId_t peerDeviceId);
+static bool_t BleApp_PeerTakesTx(uint8_t mPeerId, txClass_t cls);
+static bool_t BleApp_QueueTx(uint8_t *pData, uint32_t dataSize, txClass_t cls);
+#if (MPL3115_SNAPSHOT_MODE == 1)
+static uint8_t BleApp_TxRoom(txClass_t cls);
+#endif
+static bleResult_t BleApp_TransmitTxEntry(deviceId_t peerDeviceId, const txentry_t *pEntry, bool_t *pConfirm);
+static void BleApp_ServiceTxQueue(deviceId_t peerDeviceId);
+static void BleApp_ServiceTxQueues(void *pParam);
+static void BleApp_TxConfirmed(deviceId_t peerDeviceId, bool_t success);
+static void BleApp_TxDrained(void);
+#if (MPL3115_ASCII_ALERT_MODE == 0)
+static void BleApp_SendTamperEvent(uint8_t *pRecord, uint32_t recordSize);
+#if (MPL3115_EVENT_BATCH_MS > 0U)
+static uint16_t BleApp_TamperBatchLimit(void);
+static void BleApp_QueueTamperEvent(uint8_t *pRecord, uint32_t recordSize, bool_t urgent);
+static void BleApp_FlushTamperBatch(void *pParam);
+static void TamperBatchTimerCallback(void *pParam);
+#endif
+#endif
+#if (MPL3115_BROADCAST_MODE == 1)
+static void BleApp_StartBeacon(void);
+static void BleApp_UpdateBeacon(const uint8_t *pRecord, uint32_t recordSize);
+static bool_t BleApp_ReserveBeaconCounter(void);
+static void BleApp_RestartBeacon(bool_t burst);
+static void BleApp_SetupBeacon(void);
+#endif
 
 /* Timer Callbacks */
 #if gWuart_CentralRole_c == 1
 static void ScanningTimerCallback(void *pParam);
 #endif /* gWuart_CentralRole_c */
 static void UartStreamFlushTimerCallback(void *pData);
+static void TxRetryTimerCallback(void *pParam);
 static void BatteryMeasurementTimerCallback(void *pParam);
 #if (defined(gAppButtonCnt_c) && (gAppButtonCnt_c == 1))
 static void SwitchPressTimerCallback(void *pParam);
@@ -194,6 +240,9 @@ static void Uart_TxCallBack(void *pBuffer, serial_manager_callback_message_t *pM
 
 static void BleApp_FlushUartStream(void *pParam);
 static void BleApp_ReceivedUartStream(deviceId_t peerDeviceId, uint8_t *pStream, uint16_t streamLength);
+#if (REGISTER_I2C_PROFILE == 1)
+static void BleApp_SendBusProfile(void);
+#endif
 
 #if defined(gUseControllerNotifications_c) && (gUseControllerNotifications_c)
 static void BleApp_HandleControllerNotification(bleNotificationEvent_t *pNotificationEvent);
@@ -230,12 +279,71 @@ uint8_t dataReady;
 uint8_t data[MPL3115_DATA_SIZE];
 mpl3115_pressuredata_t rawData;
 static uint32_t refPressure = 0;
+/* Follows slow weather drift of the reference between two alerts */
+static baselinetracker_t mMpl3115Baseline;
+/* Pressure poll interval, stretched while the readings stay in the band */
+static pollsched_t mMpl3115Poll;
+#if (MPL3115_ASCII_ALERT_MODE == 0)
+/* Counter of the event records, a gap tells the peer an event was lost */
+static uint8_t mMpl3115EventSeq = 0U;
+#if (MPL3115_EVENT_BATCH_MS > 0U)
+/* Event records waiting for the end of the batch window */
+static tamperbatch_t mTamperBatch;
+static bool_t mTamperBatchPending = FALSE;
+#endif
+#endif
+#if (MPL3115_SNAPSHOT_MODE == 1)
+/* Samples around the last alert, the storage is reserved at build time so it shows in the map file */
+static capturering_t mMpl3115Snapshot;
+static capturesample_t mMpl3115SnapshotStorage[MPL3115_SNAPSHOT_SAMPLES];
+static bool_t mMpl3115SnapshotSendPending = FALSE;
+#endif
+#if (MPL3115_TEMP_COMP_MODE == 1)
+/* Per-unit temperature coefficients, restored from NVM, and the temperature of the latest sample in 1/256 C */
+static tempcompcoeffs_t mMpl3115TempCoeffs;
+static tempcomp_t mMpl3115TempComp;
+static int32_t mMpl3115Temperature = 0;
+#if defined(gAppUseNvm_d) && (gAppUseNvm_d > 0)
+NVM_RegisterDataSet(&mMpl3115TempCoeffs, 1, sizeof(tempcompcoeffs_t), MPL3115_TEMP_COMP_NVM_ID, gNVM_MirroredInRam_c);
+#endif
+#endif
 
 int mpl3115_int_BLE(void);
 int mpl3115_event_BLE(void);
 void mpl3115_CallBack();
 void mpl3115_TimerCallback();
+#if (MPL3115_FIFO_BASELINE_MODE == 1)
+static int mpl3115_fifo_init(void);
+static int mpl3115_fifo_start(void);
+static void mpl3115_fifo_stop(void);
+static void mpl3115_Int1Callback(void *pParam);
+static void mpl3115_Int1Handler(void *pParam);
+static void mpl3115_fifo_drain(void);
+#endif
+#if (MPL3115_WINDOW_DETECT_MODE == 1)
+static int mpl3115_window_start(void);
+static void mpl3115_window_stop(void);
+static void mpl3115_window_alert(void);
+#else
 void apply_autozero(void);
+#endif
+#if (MPL3115_TEMP_COMP_MODE == 1)
+static void mpl3115_temp_comp_init(void);
+static uint32_t mpl3115_compensate(uint32_t pressure, int16_t temperature);
+static int8_t mpl3115_temp_target(void);
+#if (MPL3115_WINDOW_DETECT_MODE == 1)
+static void mpl3115_window_follow(void);
+#endif
+#endif
+#if (MPL3115_ASCII_ALERT_MODE == 0)
+static void mpl3115_send_event(uint8_t type, uint8_t severity);
+#endif
+#if (MPL3115_SNAPSHOT_MODE == 1)
+static void mpl3115_snapshot_init(void);
+static void mpl3115_snapshot_push(uint32_t timestamp, int32_t v0, int32_t v1, int32_t v2);
+static void mpl3115_snapshot_trigger(void);
+static void mpl3115_SnapshotSendHandler(void *pParam);
+#endif
 
 /************************************************************************************
  *************************************************************************************
@@ -255,6 +363,10 @@ static bool_t mScanningOn = FALSE;
 
 static uint16_t mCharMonitoredHandles[1] = { (uint16_t)value_uart_stream };
 
+/* Transmit queue of each peer */
+static txqueue_t maTxQueue[gAppMaxConnections_c];
+static bool_t mTxRetryPending = FALSE;
+
 /* Service Data*/
 static wusConfig_t mWuServiceConfig;
 static bool_t      mBasValidClientList[gAppMaxConnections_c] = {FALSE};
@@ -262,8 +374,26 @@ static basConfig_t mBasServiceConfig = {(uint16_t)service_battery, 0, mBasValidC
 
 static TIMER_MANAGER_HANDLE_DEFINE(mAppTimerId);
 static TIMER_MANAGER_HANDLE_DEFINE(mUartStreamFlushTimerId);
+static TIMER_MANAGER_HANDLE_DEFINE(mTxRetryTimerId);
+#if (MPL3115_ASCII_ALERT_MODE == 0) && (MPL3115_EVENT_BATCH_MS > 0U)
+static TIMER_MANAGER_HANDLE_DEFINE(mTamperBatchTimerId);
+#endif
 static TIMER_MANAGER_HANDLE_DEFINE(mBatteryMeasurementTimerId);
 static TIMER_MANAGER_HANDLE_DEFINE(mpl3115Id);
+#if (MPL3115_FIFO_BASELINE_MODE == 1)
+static GPIO_HANDLE_DEFINE(mMpl3115Int1Handle);
+static bool_t mMpl3115IrqReady = FALSE;
+static volatile bool_t mMpl3115Int1Pending = FALSE;
+/* Baseline samples are queueing in the FIFO */
+static bool_t mMpl3115FifoArmed = FALSE;
+static uint64_t mMpl3115FifoDeadline = 0U;
+static mpl3115_pressuredata_t mMpl3115FifoSamples[MPL3115_FIFO_MAX_SAMPLES];
+static uint32_t mMpl3115FifoOverflows = 0U;
+#endif
+#if (MPL3115_WINDOW_DETECT_MODE == 1)
+/* The sensor watches the pressure window, the poll timer is stopped */
+static bool_t mMpl3115WindowArmed = FALSE;
+#endif
 
 /* If the board has only one button, multiplex the required functionalities on it using an application timer */
 #if (gAppButtonCnt_c == 1)
@@ -301,6 +431,63 @@ static appAdvertisingParams_t mAppAdvParams = {
 };
 #endif
 
+#if (MPL3115_BROADCAST_MODE == 1)
+/* Tamper beacon, non-connectable and non-scannable */
+static gapExtAdvertisingParameters_t mBeaconAdvParams = {
+    /* SID */                       mAppBeaconHandle_c,
+    /* handle */                    mAppBeaconHandle_c,
+    /* minInterval */               mAppAdvInterval(MPL3115_BROADCAST_SLOW_MS),
+    /* maxInterval */               mAppAdvInterval(MPL3115_BROADCAST_SLOW_MS),
+    /* ownAddressType */            gBleAddrTypePublic_c,
+    /* ownRandomAddr */             {0, 0, 0, 0, 0, 0},
+    /* peerAddressType */           gBleAddrTypePublic_c,
+    /* peerAddress */               {0, 0, 0, 0, 0, 0},
+    /* channelMap */                (gapAdvertisingChannelMapFlags_t)gGapAdvertisingChannelMapDefault_c,
+    /* filterPolicy */              gProcessAll_c,
+    /* extAdvProperties */          0U,
+    /* txPower */                   gBleAdvTxPowerNoPreference_c,
+    /* primaryPHY */                gLePhy1M_c,
+    /* secondaryPHY */              gLePhy1M_c,
+    /* secondaryAdvMaxSkip */       0U,
+    /* enableScanReqNotification */ FALSE
+};
+
+static uint8_t maBeaconData[TAMPER_BEACON_MAX_SIZE];
+
+static gapAdStructure_t maBeaconAdStruct[1] = {
+  {
+    .length = TAMPER_BEACON_HEADER_SIZE + TAMPER_BEACON_MIC_SIZE + 1U,
+    .adType = gAdManufacturerSpecificData_c,
+    .aData = maBeaconData
+  }
+};
+
+static gapAdvertisingData_t mBeaconAdvData = {
+    NumberOfElements(maBeaconAdStruct),
+    maBeaconAdStruct
+};
+
+static appExtAdvertisingParams_t mAppBeaconParams = {
+    .pGapExtAdvParams = &mBeaconAdvParams,
+    .pGapAdvData = &mBeaconAdvData,
+    .pScanResponseData = NULL,
+    .handle = mAppBeaconHandle_c,
+    .duration = gBleExtAdvNoDuration_c,
+    .maxExtAdvEvents = gBleExtAdvNoMaxEvents_c
+};
+
+static const uint8_t mBeaconKey[AES_128_KEY_BYTE_LEN] = MPL3115_BROADCAST_KEY;
+static uint32_t mBeaconCounter = 0U;
+/* End of the counter values reserved in NVM, a reset goes on from there */
+static uint32_t mBeaconCounterLimit = 0U;
+NVM_RegisterDataSet(&mBeaconCounterLimit, 1, sizeof(uint32_t), MPL3115_BROADCAST_NVM_ID, gNVM_MirroredInRam_c);
+static bool_t mBeaconStarted = FALSE;   /* The beacon and the sensor run */
+static bool_t mBeaconOn = FALSE;        /* The set is advertising */
+static bool_t mBeaconBusy = FALSE;      /* A start or a stop is in progress */
+static bool_t mBeaconPending = FALSE;   /* A restart waits for the one in progress */
+static bool_t mBeaconBurst = FALSE;     /* The next start is a burst */
+#endif
+
 char result1[20];
 char result2[20];
 
@@ -310,8 +497,6 @@ uint8_t vec_power_cont[70] =	"\r\n I2C Power Mode setting Failed\r\n";
 uint8_t vec_mode_cont[70] =		"\r\n I2C Control Mode setting Failed\r\n";
 uint8_t vec_inint_sensor[70] =	"\r\n Sensor Initialization Failed\r\n";
 
-uint8_t vec_mpl3115[70] =		"\r\n Successfully Initialized MPL3115 with WHO_AM_I = 0xC4\r\n";
-uint8_t vec_fxpq3115[70] =		"\r\n Successfully Initialized FXPQ3115 with WHO_AM_I = 0xC5\r\n";
 uint8_t vec_whoiam[70] =		"\r\n Bad WHO_AM_I = \r\n";
 
 uint8_t vec_sensor_err[70] =	"\r\n PL3115 Sensor Configuration Failed\r\n";
@@ -327,6 +512,7 @@ uint8_t pressure_alert1[70] =	"\r\n ===============!!ALERT!!==================";
 uint8_t pressure_tamper[70] =	"\r\n Pressure Tampering Detected on your Asset";
 uint8_t pressure_alert2[70] =	"\r\n ===============!!ALERT!!==================\r\n";
 uint8_t normal_pressure[70] =	"\r\n Your Asset is Safe\r\n";
+uint8_t vec_snapshot[70] =	"\r\n Snapshot: time us, 3 x int32, 16 bytes per sample\r\n";
 
 uint8_t status_ble = 1;
 
@@ -364,6 +550,7 @@ void BluetoothLEHost_AppInit(void)
 * Private functions
 *************************************************************************************
 ************************************************************************************/
+#if (MPL3115_FIFO_BASELINE_MODE == 0)
 void apply_autozero(void)
 {
 	while (i < NUM_AVG_SAMPLES)
@@ -378,7 +565,11 @@ void apply_autozero(void)
 
 			/*! Process the sample and convert the raw sensor data. */
 			rawData.pressure = (uint32_t)((data[0]) << 16) | ((data[1]) << 8) | ((data[2]));
+#if (MPL3115_TEMP_COMP_MODE == 1)
+			pressureInPascals = mpl3115_compensate(rawData.pressure, (int16_t)((data[3] << 8) | data[4]));
+#else
 			pressureInPascals = rawData.pressure / MPL3115_PRESSURE_CONV_FACTOR;
+#endif
 
 			refPressure += pressureInPascals;
 			i++;
@@ -391,6 +582,7 @@ void apply_autozero(void)
 	//inhalation_count = 0;
 	i = 0;
 }
+#endif
 
 #if (defined(gAppButtonCnt_c) && (gAppButtonCnt_c > 0))
 /*! *********************************************************************************
@@ -664,6 +856,9 @@ static void BleApp_AdvertisingCallback
 #endif /* gAppLedCnt_c == 1 */
             Led1Flashing();
             Serial_Print("\n\rAdvertising...\n\r", gAllowToBlock_d);
+#if (MPL3115_BROADCAST_MODE == 1)
+            BleApp_StartBeacon();
+#endif
             }
             else
             {
@@ -681,6 +876,43 @@ static void BleApp_AdvertisingCallback
         }
         break;
 
+#if (MPL3115_BROADCAST_MODE == 1)
+        case gExtAdvertisingStateChanged_c:
+        {
+            if (mAppBeaconHandle_c == pAdvertisingEvent->eventData.advHandle)
+            {
+                mBeaconOn = !mBeaconOn;
+                if (mBeaconOn)
+                {
+                    mBeaconBusy = FALSE;
+                    if (mBeaconPending)
+                    {
+                        mBeaconPending = FALSE;
+                        BleApp_RestartBeacon(mBeaconBurst);
+                    }
+                }
+                else
+                {
+                    /* Stopped to change the interval, the start takes the latest content */
+                    mBeaconPending = FALSE;
+                    BleApp_SetupBeacon();
+                }
+            }
+        }
+        break;
+
+        case gAdvertisingSetTerminated_c:
+        {
+            if (mAppBeaconHandle_c == pAdvertisingEvent->eventData.advSetTerminated.handle)
+            {
+                /* The burst is over, back to slow beaconing */
+                mBeaconOn = FALSE;
+                BleApp_RestartBeacon(FALSE);
+            }
+        }
+        break;
+#endif
+
         default:
         {
             ; /* No action required */
@@ -803,6 +1035,22 @@ static void BleApp_ConnectionCallback
             Serial_PrintDec(peerDeviceId);
             Serial_Print(".\n\r", gAllowToBlock_d);
 
+            /* Pending entries are lost with the link */
+            TxQueue_Reset(&maTxQueue[peerDeviceId]);
+            BleApp_TxDrained();
+            Serial_Print("TX drops alert/status/snapshot/debug ", gAllowToBlock_d);
+            Serial_PrintDec(maTxQueue[peerDeviceId].drops[mTxClass_Alert_c]);
+            Serial_Print("/", gAllowToBlock_d);
+            Serial_PrintDec(maTxQueue[peerDeviceId].drops[mTxClass_Status_c]);
+            Serial_Print("/", gAllowToBlock_d);
+            Serial_PrintDec(maTxQueue[peerDeviceId].drops[mTxClass_Snapshot_c]);
+            Serial_Print("/", gAllowToBlock_d);
+            Serial_PrintDec(maTxQueue[peerDeviceId].drops[mTxClass_Debug_c]);
+            Serial_Print(", retries ", gAllowToBlock_d);
+            Serial_PrintDec(maTxQueue[peerDeviceId].retries);
+            Serial_Print(".\n\r", gAllowToBlock_d);
+            TxQueue_Init(&maTxQueue[peerDeviceId]);
+
             maPeerInformation[peerDeviceId].appState = mAppIdle_c;
             maPeerInformation[peerDeviceId].clientInfo.hService = gGattDbInvalidHandleIndex_d;
             maPeerInformation[peerDeviceId].clientInfo.hUartStream = gGattDbInvalidHandleIndex_d;
@@ -973,6 +1221,12 @@ static void BleApp_GattClientCallback
     bleResult_t             error
 )
 {
+    /* A confirmed write of the TX queue completed */
+    if ((gGattProcWriteCharacteristicValue_c == procedureType) && (maTxQueue[serverDeviceId].busy))
+    {
+        BleApp_TxConfirmed(serverDeviceId, (gGattProcSuccess_c == procedureResult) ? TRUE : FALSE);
+    }
+
     switch (procedureResult)
     {
         case gGattProcError_c:
@@ -1040,6 +1294,35 @@ static void BleApp_GattServerCallback
 
     switch (pServerEvent->eventType)
     {
+        case gEvtAttributeWritten_c:
+        {
+            if (pServerEvent->eventData.attributeWrittenEvent.handle == (uint16_t)value_uart_stream)
+            {
+                BleApp_ReceivedUartStream(deviceId, pServerEvent->eventData.attributeWrittenEvent.aValue,
+                                          pServerEvent->eventData.attributeWrittenEvent.cValueLength);
+                (void)GattServer_SendAttributeWrittenStatus(deviceId, (uint16_t)value_uart_stream,
+                                                            (uint8_t)gAttErrCodeNoError_c);
+            }
+
+            break;
+        }
+
+        case gEvtHandleValueConfirmation_c:
+        {
+            BleApp_TxConfirmed(deviceId, TRUE);
+            break;
+        }
+
+        case gEvtError_c:
+        {
+            if (pServerEvent->eventData.procedureError.procedureType == gSendIndication_c)
+            {
+                BleApp_TxConfirmed(deviceId, FALSE);
+            }
+
+            break;
+        }
+
         case gEvtAttributeWrittenWithoutResponse_c:
         {
             if (pServerEvent->eventData.attributeWrittenEvent.handle == (uint16_t)value_uart_stream)
@@ -1051,6 +1334,18 @@ static void BleApp_GattServerCallback
             break;
         }
 
+        case gEvtCharacteristicCccdWritten_c:
+        {
+            if ((pServerEvent->eventData.charCccdWrittenEvent.handle == (uint16_t)cccd_tamper_event) &&
+                (0U != ((uint8_t)pServerEvent->eventData.charCccdWrittenEvent.newCccd &
+                        ((uint8_t)gCccdNotification_c | (uint8_t)gCccdIndication_c))))
+            {
+                BleApp_StateMachineHandler(deviceId, mAppEvt_TamperNotifyEnabled_c);
+            }
+
+            break;
+        }
+
         case gEvtMtuChanged_c:
         {
             /* update stream length with minimum of  new MTU */
@@ -1134,7 +1429,7 @@ static bool_t BleApp_CheckScanEvent
 #endif /* gWuart_CentralRole_c == 1 */
 
 /*! *********************************************************************************
- * \brief        Send the received uart stream over GATT
+ * \brief        Send the received uart stream over GATT, as a status message.
  *
  * \param[in]    pData              Pointer to the received stream.
  * \param[in]    streamSize         The number of bytes in the stream.
@@ -1145,123 +1440,711 @@ static void BleApp_SendUartStream
     uint32_t streamSize
 )
 {
-    gattCharacteristic_t characteristic = {(uint8_t)gGattCharPropNone_c, {0}, 0, 0};
-    uint8_t              mPeerId = 0;
+    (void)BleApp_QueueTx(pRecvStream, streamSize, mTxClass_Status_c);
+}
+
+/*! *********************************************************************************
+ * \brief        Checks if a peer takes the data of a TX class.
+ *
+ * \details      Alerts go to the peers subscribed to the Tamper service and the
+ *               running peers, the other classes to the running peers only.
+ *
+ * \param[in]    mPeerId            The peer index.
+ * \param[in]    cls                txClass_t of the data.
+ *
+ * \return       TRUE if the data is queued for the peer.
+ ********************************************************************************** */
+static bool_t BleApp_PeerTakesTx
+(
+    uint8_t mPeerId,
+    txClass_t cls
+)
+{
+    return ((gInvalidDeviceId_c != maPeerInformation[mPeerId].deviceId) &&
+            ((mAppRunning_c == maPeerInformation[mPeerId].appState) ||
+             ((mTxClass_Alert_c == cls) && (TRUE == BleApp_TamperNotifyEnabled(mPeerId))))) ? TRUE : FALSE;
+}
+
+/*! *********************************************************************************
+ * \brief        Queues data for all peers which can take it and starts sending.
+ *
+ * \details      Data longer than a queue entry takes several entries, a peer
+ *               without room for all of them gets none, see TxQueue_PushMessage.
+ *
+ * \param[in]    pData              Pointer to the data.
+ * \param[in]    dataSize           The number of bytes in the data.
+ * \param[in]    cls                txClass_t of the data.
+ *
+ * \return       FALSE if a peer dropped the data.
+ ********************************************************************************** */
+static bool_t BleApp_QueueTx
+(
+    uint8_t *pData,
+    uint32_t dataSize,
+    txClass_t cls
+)
+{
+    bool_t   queued = TRUE;
+    uint8_t  mPeerId = 0;
 
-    /* send UART stream to all peers */
     for (mPeerId = 0; mPeerId < (uint8_t)gAppMaxConnections_c; mPeerId++)
     {
-        if (gInvalidDeviceId_c != maPeerInformation[mPeerId].deviceId &&
-            mAppRunning_c == maPeerInformation[mPeerId].appState)
+        if (TRUE == BleApp_PeerTakesTx(mPeerId, cls))
         {
-            characteristic.value.handle = maPeerInformation[mPeerId].clientInfo.hUartStream;
-            (void)GattClient_WriteCharacteristicValue(mPeerId, &characteristic,
-                    streamSize, pRecvStream, TRUE,
-                    FALSE, FALSE, NULL);
+            if (!TxQueue_PushMessage(&maTxQueue[mPeerId], (uint8_t)cls, pData, dataSize))
+            {
+                queued = FALSE;
+            }
+
+            /* A queue the host stack refused waits for the retry timer, so that
+               each retry interval costs its alert one attempt only */
+            if (!maTxQueue[mPeerId].held)
+            {
+                BleApp_ServiceTxQueue(mPeerId);
+            }
         }
     }
+
+    return queued;
 }
 
+#if (MPL3115_SNAPSHOT_MODE == 1)
 /*! *********************************************************************************
- * \brief        Handle the main application state machine
+ * \brief        Gets the entries of a TX class every peer taking it can queue.
+ *
+ * \param[in]    cls                txClass_t of the data.
+ *
+ * \return       The smallest room of the peers, TX_QUEUE_DEPTH without peers.
+ ********************************************************************************** */
+static uint8_t BleApp_TxRoom
+(
+    txClass_t cls
+)
+{
+    uint8_t  room = TX_QUEUE_DEPTH;
+    uint8_t  peerRoom;
+    uint8_t  mPeerId = 0;
+
+    for (mPeerId = 0; mPeerId < (uint8_t)gAppMaxConnections_c; mPeerId++)
+    {
+        if (TRUE == BleApp_PeerTakesTx(mPeerId, cls))
+        {
+            peerRoom = TxQueue_Room(&maTxQueue[mPeerId], (uint8_t)cls);
+            room = (peerRoom < room) ? peerRoom : room;
+        }
+    }
+
+    return room;
+}
+#endif
+
+/*! *********************************************************************************
+ * \brief        Sends one queue entry to a peer.
+ *
+ * \details      An alert goes out as an indication, or as a notification if the
+ *               peer only enabled those, to a peer subscribed to the Tamper
+ *               service, else as a write with response on its Wireless UART.
+ *               The other classes are written without response.
  *
  * \param[in]    peerDeviceId       The remote device ID.
- * \param[in]    event              The application event.
+ * \param[in]    pEntry             Pointer to the entry.
+ * \param[out]   pConfirm           TRUE if the peer will confirm the entry.
+ *
+ * \return       The result of the host stack call.
  ********************************************************************************** */
-static void BleApp_StateMachineHandler
+static bleResult_t BleApp_TransmitTxEntry
 (
     deviceId_t peerDeviceId,
-    appEvent_t event
+    const txentry_t *pEntry,
+    bool_t *pConfirm
 )
 {
-    uint16_t tempMtu = 0;
-    union
-    {
-        uint8_t     *pUuidArray;
-        bleUuid_t   *pUuidObj;
-    } temp; /* MISRA rule 11.3 */
+    gattCharacteristic_t characteristic = {(uint8_t)gGattCharPropNone_c, {0}, 0, 0};
+    bool_t               isIndActive = FALSE;
+    bleResult_t          result = gBleSuccess_c;
 
-    temp.pUuidArray = uuid_service_wireless_uart;
+    *pConfirm = FALSE;
 
-    /* invalid client information */
-    if (maPeerInformation[peerDeviceId].deviceId != gInvalidDeviceId_c)
+    if (((uint8_t)mTxClass_Alert_c == pEntry->cls) && (TRUE == BleApp_TamperNotifyEnabled(peerDeviceId)))
     {
-        switch (maPeerInformation[peerDeviceId].appState)
+        if ((gBleSuccess_c == Gap_CheckIndicationStatus(peerDeviceId, (uint16_t)cccd_tamper_event, &isIndActive)) &&
+            (TRUE == isIndActive))
         {
-        case mAppIdle_c:
-        {
-            if (event == mAppEvt_PeerConnected_c)
-            {
-                /* Let the central device initiate the Exchange MTU procedure*/
-                if (mGapRole == gGapCentral_c)
-                {
-                    /* Moving to Exchange MTU State */
-                    maPeerInformation[peerDeviceId].appState = mAppExchangeMtu_c;
-                    (void)GattClient_ExchangeMtu(peerDeviceId, gAttMaxMtu_c);
-                }
-                else
-                {
-                    /* Moving to Service Discovery State*/
-                    maPeerInformation[peerDeviceId].appState = mAppServiceDisc_c;
-
-                    /* Start Service Discovery*/
-                    (void)BleServDisc_FindService(peerDeviceId,
-                            gBleUuidType128_c,
-                            temp.pUuidObj);
-                }
-            }
+            result = GattServer_SendInstantValueIndication(peerDeviceId, (uint16_t)value_tamper_event,
+                                                           pEntry->length, pEntry->data);
+            *pConfirm = TRUE;
         }
-        break;
-
-        case mAppExchangeMtu_c:
+        else
         {
-            if (event == mAppEvt_GattProcComplete_c)
-            {
-                /* update stream length with minimum of maximum MTU's of connected devices */
-                (void)Gatt_GetMtu(peerDeviceId, &tempMtu);
-                tempMtu = gAttMaxWriteDataSize_d(tempMtu);
+            result = GattServer_SendInstantValueNotification(peerDeviceId, (uint16_t)value_tamper_event,
+                                                             pEntry->length, pEntry->data);
+        }
+    }
+    else if (mAppRunning_c == maPeerInformation[peerDeviceId].appState)
+    {
+        characteristic.value.handle = maPeerInformation[peerDeviceId].clientInfo.hUartStream;
+        *pConfirm = ((uint8_t)mTxClass_Alert_c == pEntry->cls) ? TRUE : FALSE;
+        result = GattClient_WriteCharacteristicValue(peerDeviceId, &characteristic,
+                pEntry->length, pEntry->data, (TRUE == *pConfirm) ? FALSE : TRUE,
+                FALSE, FALSE, NULL);
+    }
+    else
+    {
+        ; /* The peer cannot take it any more, the entry is consumed */
+    }
 
-                mAppUartBufferSize = mAppUartBufferSize <= tempMtu ? mAppUartBufferSize : tempMtu;
+    return result;
+}
 
-                /* Moving to Service Discovery State*/
-                maPeerInformation[peerDeviceId].appState = mAppServiceDisc_c;
+/*! *********************************************************************************
+ * \brief        Sends the queued entries of a peer, in priority order.
+ *
+ * \details      Stops at an entry waiting for a confirmation. When the host stack
+ *               refuses an entry, e.g. with gBleOverflow_c, the queue is held and
+ *               serviced again after mAppTxRetryIntervalInMs_c.
+ *
+ * \param[in]    peerDeviceId       The remote device ID.
+ ********************************************************************************** */
+static void BleApp_ServiceTxQueue
+(
+    deviceId_t peerDeviceId
+)
+{
+    txqueue_t       *pQueue = &maTxQueue[peerDeviceId];
+    const txentry_t *pEntry = NULL;
+    bool_t           confirm = FALSE;
 
-                /* Start Service Discovery*/
-                (void)BleServDisc_FindService(peerDeviceId,
-                        gBleUuidType128_c,
-                        temp.pUuidObj);
+    while ((!pQueue->busy) && (NULL != (pEntry = TxQueue_Head(pQueue))))
+    {
+        if (gBleSuccess_c == BleApp_TransmitTxEntry(peerDeviceId, pEntry, &confirm))
+        {
+            if (TRUE == confirm)
+            {
+                TxQueue_Wait(pQueue);
             }
             else
             {
-                if (event == mAppEvt_GattProcError_c)
-                {
-                    (void)Gap_Disconnect(peerDeviceId);
-                }
+                TxQueue_Done(pQueue);
             }
         }
-        break;
-
-        case mAppServiceDisc_c:
+        else
         {
-            if (event == mAppEvt_ServiceDiscoveryComplete_c)
+            (void)TxQueue_Fail(pQueue);
+            if (NULL != TxQueue_Head(pQueue))
             {
-                /* Moving to Running State*/
-                maPeerInformation[peerDeviceId].appState = mAppRunning_c;
+                pQueue->held = true;
+                (void)TM_InstallCallback((timer_handle_t)mTxRetryTimerId, TxRetryTimerCallback, NULL);
+                (void)TM_Start((timer_handle_t)mTxRetryTimerId,
+                            (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, mAppTxRetryIntervalInMs_c);
+            }
+            break;
+        }
+    }
+}
 
+/*! *********************************************************************************
+ * \brief        Sends the queued entries of all peers.
+ *
+ * \param[in]    pParam             Callback parameters.
+ ********************************************************************************** */
+static void BleApp_ServiceTxQueues
+(
+    void *pParam
+)
+{
+    uint8_t mPeerId = 0;
 
-                mpl3115_int_BLE();
-                mpl3115_CallBack();
+    mTxRetryPending = FALSE;
 
+    for (mPeerId = 0; mPeerId < (uint8_t)gAppMaxConnections_c; mPeerId++)
+    {
+        if (gInvalidDeviceId_c != maPeerInformation[mPeerId].deviceId)
+        {
+            maTxQueue[mPeerId].held = false;
+            BleApp_ServiceTxQueue(mPeerId);
+        }
+    }
 
-#if gAppUseBonding_d
-                union
-                {
-                    uint32_t u32;
-                    uint16_t u16;
-                } tempCast;
+    BleApp_TxDrained();
+}
 
-                tempCast.u32 = sizeof(wucConfig_t);
-                /* Write data in NVM */
+/*! *********************************************************************************
+ * \brief        Handles the confirmation of the entry a peer was waiting for.
+ *
+ * \param[in]    peerDeviceId       The remote device ID.
+ * \param[in]    success            FALSE if the peer answered with an error.
+ ********************************************************************************** */
+static void BleApp_TxConfirmed
+(
+    deviceId_t peerDeviceId,
+    bool_t success
+)
+{
+    if (!maTxQueue[peerDeviceId].busy)
+    {
+        return;
+    }
+
+    if (TRUE == success)
+    {
+        TxQueue_Done(&maTxQueue[peerDeviceId]);
+    }
+    else
+    {
+        (void)TxQueue_Fail(&maTxQueue[peerDeviceId]);
+    }
+
+    BleApp_ServiceTxQueue(peerDeviceId);
+    BleApp_TxDrained();
+}
+
+/*! *********************************************************************************
+ * \brief        Lets the data waiting for room in the TX queues go on.
+ *
+ * \details      Called once queue entries went out or were dropped. The snapshot
+ *               is read from its ring only as fast as the queues drain, see
+ *               mpl3115_SnapshotSendHandler.
+ ********************************************************************************** */
+static void BleApp_TxDrained(void)
+{
+#if (MPL3115_SNAPSHOT_MODE == 1)
+    if (mMpl3115Snapshot.triggered && (FALSE == mMpl3115SnapshotSendPending))
+    {
+        mMpl3115SnapshotSendPending = TRUE;
+        if (gBleSuccess_c != App_PostCallbackMessage(mpl3115_SnapshotSendHandler, NULL))
+        {
+            mMpl3115SnapshotSendPending = FALSE;
+        }
+    }
+#endif
+}
+
+/*! *********************************************************************************
+ * \brief        Checks if a peer enabled the notifications or indications of the tamper events.
+ *
+ * \param[in]    peerDeviceId       The remote device ID.
+ *
+ * \return       TRUE if the CCCD of the tamper event is set for notifications or indications.
+ ********************************************************************************** */
+static bool_t BleApp_TamperNotifyEnabled
+(
+    deviceId_t peerDeviceId
+)
+{
+    bool_t isNotifActive = FALSE;
+    bool_t isIndActive = FALSE;
+
+    if (gBleSuccess_c != Gap_CheckNotificationStatus(peerDeviceId, (uint16_t)cccd_tamper_event, &isNotifActive))
+    {
+        isNotifActive = FALSE;
+    }
+    if (gBleSuccess_c != Gap_CheckIndicationStatus(peerDeviceId, (uint16_t)cccd_tamper_event, &isIndActive))
+    {
+        isIndActive = FALSE;
+    }
+
+    return ((TRUE == isNotifActive) || (TRUE == isIndActive)) ? TRUE : FALSE;
+}
+
+/*! *********************************************************************************
+ * \brief        Serves a peer which only subscribed to the Tamper service.
+ *
+ * \details      The events go out as notifications, the discovery of a Wireless
+ *               UART on the peer is not needed and is stopped.
+ *
+ * \param[in]    peerDeviceId       The remote device ID.
+ ********************************************************************************** */
+static void BleApp_StartTamperNotify
+(
+    deviceId_t peerDeviceId
+)
+{
+    BleServDisc_Stop(peerDeviceId);
+
+    /* Moving to Tamper Notify State*/
+    maPeerInformation[peerDeviceId].appState = mAppTamperNotify_c;
+
+    mpl3115_int_BLE();
+    mpl3115_CallBack();
+}
+
+#if (MPL3115_ASCII_ALERT_MODE == 0)
+/*! *********************************************************************************
+ * \brief        Sends tamper event records to all peers, in one write.
+ *
+ * \details      Peers subscribed to the Tamper service get an indication or a
+ *               notification, the other running peers get the records on their
+ *               Wireless UART. The peers confirm the records, see BleApp_QueueTx.
+ *
+ * \param[in]    pRecord            Pointer to the encoded records.
+ * \param[in]    recordSize         The number of bytes in the records.
+ ********************************************************************************** */
+static void BleApp_SendTamperEvent
+(
+    uint8_t *pRecord,
+    uint32_t recordSize
+)
+{
+    (void)BleApp_QueueTx(pRecord, recordSize, mTxClass_Alert_c);
+}
+
+#if (MPL3115_EVENT_BATCH_MS > 0U)
+/*! *********************************************************************************
+ * \brief        Gets the largest batch all peers take in one write or notification.
+ *
+ * \return       The size in bytes, from the smallest ATT MTU of the peers, at most
+ *               one TX queue entry.
+ ********************************************************************************** */
+static uint16_t BleApp_TamperBatchLimit(void)
+{
+    uint16_t limit = TX_QUEUE_ENTRY_SIZE;
+    uint16_t tempMtu = 0U;
+    uint8_t  mPeerId = 0;
+
+    for (mPeerId = 0; mPeerId < (uint8_t)gAppMaxConnections_c; mPeerId++)
+    {
+        if (gInvalidDeviceId_c != maPeerInformation[mPeerId].deviceId)
+        {
+            tempMtu = gAttDefaultMtu_c;
+            (void)Gatt_GetMtu(mPeerId, &tempMtu);
+            tempMtu = gAttMaxNotifIndDataSize_d(tempMtu);
+
+            limit = limit <= tempMtu ? limit : tempMtu;
+        }
+    }
+
+    return limit;
+}
+
+/*! *********************************************************************************
+ * \brief        Adds one tamper event record to the batch.
+ *
+ * \details      The batch goes out when the window ends, when it cannot take
+ *               another record or at once for an urgent record.
+ *
+ * \param[in]    pRecord            Pointer to the encoded record.
+ * \param[in]    recordSize         The number of bytes in the record.
+ * \param[in]    urgent             TRUE to send the batch without waiting.
+ ********************************************************************************** */
+static void BleApp_QueueTamperEvent
+(
+    uint8_t *pRecord,
+    uint32_t recordSize,
+    bool_t urgent
+)
+{
+    uint16_t limit = BleApp_TamperBatchLimit();
+
+    if (!TamperEvent_BatchAppend(&mTamperBatch, pRecord, recordSize, limit))
+    {
+        /* No room left for the record, send the batch first */
+        BleApp_FlushTamperBatch(NULL);
+        (void)TamperEvent_BatchAppend(&mTamperBatch, pRecord, recordSize, limit);
+    }
+
+    if ((TRUE == urgent) || ((mTamperBatch.length + TAMPER_EVENT_HEADER_SIZE) > limit))
+    {
+        BleApp_FlushTamperBatch(NULL);
+    }
+    else if (mTamperBatch.length == recordSize)
+    {
+        /* First record of the batch, it waits at most one window */
+        (void)TM_InstallCallback((timer_handle_t)mTamperBatchTimerId, TamperBatchTimerCallback, NULL);
+        (void)TM_Start((timer_handle_t)mTamperBatchTimerId,
+                    (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, MPL3115_EVENT_BATCH_MS);
+    }
+    else
+    {
+        ; /* Wait for the window to end */
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Sends the batch of tamper event records to all peers.
+ *
+ * \param[in]    pParam             Callback parameters.
+ ********************************************************************************** */
+static void BleApp_FlushTamperBatch
+(
+    void *pParam
+)
+{
+    (void)TM_Stop((timer_handle_t)mTamperBatchTimerId);
+    mTamperBatchPending = FALSE;
+
+    if (0U != mTamperBatch.length)
+    {
+        BleApp_SendTamperEvent(mTamperBatch.buffer, mTamperBatch.length);
+        TamperEvent_BatchReset(&mTamperBatch);
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Timer handler for the end of the batch window.
+ *
+ * \param[in]    pParam             Callback parameters.
+ ********************************************************************************** */
+static void TamperBatchTimerCallback
+(
+    void *pParam
+)
+{
+    if (!mTamperBatchPending)
+    {
+        mTamperBatchPending = TRUE;
+        if (gBleSuccess_c != App_PostCallbackMessage(BleApp_FlushTamperBatch, NULL))
+        {
+            /* The queue is full, try again at the end of another window */
+            mTamperBatchPending = FALSE;
+            (void)TM_Start((timer_handle_t)mTamperBatchTimerId,
+                        (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, MPL3115_EVENT_BATCH_MS);
+        }
+    }
+}
+#endif /* MPL3115_EVENT_BATCH_MS */
+#endif /* MPL3115_ASCII_ALERT_MODE */
+
+#if (MPL3115_BROADCAST_MODE == 1)
+/*! *********************************************************************************
+ * \brief        Starts the tamper beacon and the sensor, once the connectable
+ *               advertising runs.
+ *
+ * \details      The beacon first only tells the node is alive. The sensor
+ *               starts without waiting for a peer, the gateways get the alerts
+ *               from the beacon.
+ ********************************************************************************** */
+static void BleApp_StartBeacon(void)
+{
+    if (!mBeaconStarted)
+    {
+        mBeaconStarted = TRUE;
+        if (gNVM_OK_c != NvRestoreDataSet(&mBeaconCounterLimit, FALSE))
+        {
+            mBeaconCounterLimit = 0U;
+        }
+        /* The values below the limit may have been sent before the reset */
+        mBeaconCounter = mBeaconCounterLimit;
+        BleApp_UpdateBeacon(NULL, 0U);
+        BleApp_RestartBeacon(FALSE);
+
+        mpl3115_int_BLE();
+        mpl3115_CallBack();
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Puts new content in the tamper beacon, with the next counter
+ *               value and its MIC.
+ *
+ * \param[in]    pRecord            Pointer to the encoded record, NULL for none.
+ * \param[in]    recordSize         The number of bytes in the record.
+ ********************************************************************************** */
+static void BleApp_UpdateBeacon
+(
+    const uint8_t *pRecord,
+    uint32_t recordSize
+)
+{
+    uint8_t mac[AES_128_BLOCK_SIZE];
+    uint32_t length;
+
+    if ((mBeaconCounter == mBeaconCounterLimit) && (FALSE == BleApp_ReserveBeaconCounter()))
+    {
+        /* Keep the last beacon rather than send a value a reset could repeat */
+        return;
+    }
+
+    length = TamperBeacon_Encode(maBeaconData, mBeaconCounter, pRecord, recordSize);
+    if (0U != length)
+    {
+        mBeaconCounter++;
+        AES_128_CMAC(maBeaconData, length, mBeaconKey, mac);
+        maBeaconAdStruct[0].length = (uint8_t)(TamperBeacon_Seal(maBeaconData, length, mac) + 1U);
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Reserves the next MPL3115_BROADCAST_COUNTER_WINDOW beacon counter
+ *               values in NVM.
+ *
+ * \return       TRUE once the new limit is saved, FALSE if the counter has to stay
+ *               below the old one.
+ ********************************************************************************** */
+static bool_t BleApp_ReserveBeaconCounter(void)
+{
+    uint32_t limit = mBeaconCounterLimit;
+
+    mBeaconCounterLimit = mBeaconCounter + MPL3115_BROADCAST_COUNTER_WINDOW;
+    if (gNVM_OK_c != NvSyncSave(&mBeaconCounterLimit, FALSE))
+    {
+        mBeaconCounterLimit = limit;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*! *********************************************************************************
+ * \brief        Restarts the tamper beacon with its latest content.
+ *
+ * \details      A burst advertises at the fast interval, the set terminates
+ *               after MPL3115_BROADCAST_BURST_MS and goes on at the slow interval.
+ *               The interval only changes while the set is stopped, a running
+ *               set is stopped first and started again from
+ *               BleApp_AdvertisingCallback.
+ *
+ * \param[in]    burst              TRUE after an event, FALSE for slow beaconing.
+ ********************************************************************************** */
+static void BleApp_RestartBeacon
+(
+    bool_t burst
+)
+{
+    if (mBeaconBusy)
+    {
+        /* A burst wins over slow beaconing */
+        mBeaconPending = TRUE;
+        mBeaconBurst = (mBeaconBurst || burst) ? TRUE : FALSE;
+    }
+    else
+    {
+        mBeaconBurst = burst;
+        mBeaconBusy = TRUE;
+        if (!mBeaconOn)
+        {
+            BleApp_SetupBeacon();
+        }
+        else if (gBleSuccess_c != Gap_StopExtAdvertising(mAppBeaconHandle_c))
+        {
+            mBeaconBusy = FALSE;
+        }
+        else
+        {
+            ; /* Started again when the set is off */
+        }
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Sets the interval and the data of the tamper beacon and starts it.
+ ********************************************************************************** */
+static void BleApp_SetupBeacon(void)
+{
+    uint32_t interval = mBeaconBurst ? mAppAdvInterval(MPL3115_BROADCAST_FAST_MS) : mAppAdvInterval(MPL3115_BROADCAST_SLOW_MS);
+
+    mBeaconAdvParams.minInterval = interval;
+    mBeaconAdvParams.maxInterval = interval;
+    /* The duration counts 10 ms units */
+    mAppBeaconParams.duration = mBeaconBurst ? (uint16_t)(MPL3115_BROADCAST_BURST_MS / 10U) : gBleExtAdvNoDuration_c;
+
+    if (gBleSuccess_c != BluetoothLEHost_StartExtAdvertising(&mAppBeaconParams, BleApp_AdvertisingCallback,
+                                                               BleApp_ConnectionCallback))
+    {
+        mBeaconBusy = FALSE;
+    }
+}
+#endif /* MPL3115_BROADCAST_MODE */
+
+/*! *********************************************************************************
+ * \brief        Handle the main application state machine
+ *
+ * \param[in]    peerDeviceId       The remote device ID.
+ * \param[in]    event              The application event.
+ ********************************************************************************** */
+static void BleApp_StateMachineHandler
+(
+    deviceId_t peerDeviceId,
+    appEvent_t event
+)
+{
+    uint16_t tempMtu = 0;
+    union
+    {
+        uint8_t     *pUuidArray;
+        bleUuid_t   *pUuidObj;
+    } temp; /* MISRA rule 11.3 */
+
+    temp.pUuidArray = uuid_service_wireless_uart;
+
+    /* invalid client information */
+    if (maPeerInformation[peerDeviceId].deviceId != gInvalidDeviceId_c)
+    {
+        switch (maPeerInformation[peerDeviceId].appState)
+        {
+        case mAppIdle_c:
+        {
+            if (event == mAppEvt_PeerConnected_c)
+            {
+                /* Let the central device initiate the Exchange MTU procedure*/
+                if (mGapRole == gGapCentral_c)
+                {
+                    /* Moving to Exchange MTU State */
+                    maPeerInformation[peerDeviceId].appState = mAppExchangeMtu_c;
+                    (void)GattClient_ExchangeMtu(peerDeviceId, gAttMaxMtu_c);
+                }
+                else
+                {
+                    /* Moving to Service Discovery State*/
+                    maPeerInformation[peerDeviceId].appState = mAppServiceDisc_c;
+
+                    /* Start Service Discovery*/
+                    (void)BleServDisc_FindService(peerDeviceId,
+                            gBleUuidType128_c,
+                            temp.pUuidObj);
+                }
+            }
+        }
+        break;
+
+        case mAppExchangeMtu_c:
+        {
+            if (event == mAppEvt_GattProcComplete_c)
+            {
+                /* update stream length with minimum of maximum MTU's of connected devices */
+                (void)Gatt_GetMtu(peerDeviceId, &tempMtu);
+                tempMtu = gAttMaxWriteDataSize_d(tempMtu);
+
+                mAppUartBufferSize = mAppUartBufferSize <= tempMtu ? mAppUartBufferSize : tempMtu;
+
+                /* Moving to Service Discovery State*/
+                maPeerInformation[peerDeviceId].appState = mAppServiceDisc_c;
+
+                /* Start Service Discovery*/
+                (void)BleServDisc_FindService(peerDeviceId,
+                        gBleUuidType128_c,
+                        temp.pUuidObj);
+            }
+            else
+            {
+                if (event == mAppEvt_GattProcError_c)
+                {
+                    (void)Gap_Disconnect(peerDeviceId);
+                }
+            }
+        }
+        break;
+
+        case mAppServiceDisc_c:
+        {
+            if (event == mAppEvt_ServiceDiscoveryComplete_c)
+            {
+                /* Moving to Running State*/
+                maPeerInformation[peerDeviceId].appState = mAppRunning_c;
+
+
+                mpl3115_int_BLE();
+                mpl3115_CallBack();
+
+
+#if gAppUseBonding_d
+                union
+                {
+                    uint32_t u32;
+                    uint16_t u16;
+                } tempCast;
+
+                tempCast.u32 = sizeof(wucConfig_t);
+                /* Write data in NVM */
                 (void)Gap_SaveCustomPeerInformation(maPeerInformation[peerDeviceId].deviceId,
                         (uint8_t *) &maPeerInformation[peerDeviceId].clientInfo, 0,
                         tempCast.u16);
@@ -1278,6 +2161,11 @@ static void BleApp_StateMachineHandler
             {
                 (void)Gap_Disconnect(peerDeviceId);
             }
+            else if (event == mAppEvt_TamperNotifyEnabled_c)
+            {
+                /* No need to wait for the Wireless UART of the peer */
+                BleApp_StartTamperNotify(peerDeviceId);
+            }
             else
             {
                 /* ignore other event types */
@@ -1295,7 +2183,19 @@ static void BleApp_StateMachineHandler
             else if ((event == mAppEvt_ServiceDiscoveryNotFound_c) ||
                     (event == mAppEvt_ServiceDiscoveryFailed_c))
             {
-                (void)Gap_Disconnect(peerDeviceId);
+                /* A bonded peer keeps its subscription to the Tamper service */
+                if (TRUE == BleApp_TamperNotifyEnabled(peerDeviceId))
+                {
+                    BleApp_StartTamperNotify(peerDeviceId);
+                }
+                else
+                {
+                    (void)Gap_Disconnect(peerDeviceId);
+                }
+            }
+            else if (event == mAppEvt_TamperNotifyEnabled_c)
+            {
+                BleApp_StartTamperNotify(peerDeviceId);
             }
             else
             {
@@ -1411,7 +2311,7 @@ static void BleApp_FlushUartStream
                 if (bytesRead != 0U)
                 {
                     /* Send data over the air */
-                    BleApp_SendUartStream(pMsg, (uint32_t)bytesRead);
+                    (void)BleApp_QueueTx(pMsg, (uint32_t)bytesRead, mTxClass_Debug_c);
                 }
             }
 
@@ -1444,6 +2344,15 @@ static void BleApp_ReceivedUartStream
     uint8_t *pBuffer = NULL;
     uint32_t messageHeaderSize = 0;
 
+#if (REGISTER_I2C_PROFILE == 1)
+    /* A peer asking for the bus statistics gets them instead of the request being printed. */
+    if ((streamLength >= 4U) && FLib_MemCmp(pStream, "?bus", 4U))
+    {
+        BleApp_SendBusProfile();
+        return;
+    }
+#endif
+
     if (mAppUartNewLine || (previousDeviceId != peerDeviceId))
     {
         streamLength += (uint16_t)sizeof(additionalInfoBuff);
@@ -1493,6 +2402,30 @@ static void BleApp_ReceivedUartStream
     previousDeviceId = peerDeviceId;
 }
 
+#if (REGISTER_I2C_PROFILE == 1)
+/*! *********************************************************************************
+ * \brief        Prints the I2C bus statistics on the debug UART and sends them to the peers.
+ ********************************************************************************** */
+static void BleApp_SendBusProfile(void)
+{
+    registeri2cprofile_t profile;
+    char text[160];
+    uint32_t length;
+    uint32_t sent;
+    uint8_t i;
+
+    for (i = 0U; Register_I2C_ProfileGet(i, &profile); i++)
+    {
+        length = Register_I2C_ProfileFormat(&profile, text, sizeof(text));
+        Serial_Print(text, gAllowToBlock_d);
+        for (sent = 0U; sent < length; sent += 64U)
+        {
+            (void)BleApp_QueueTx((uint8_t *)&text[sent], ((length - sent) < 64U) ? (length - sent) : 64U, mTxClass_Debug_c);
+        }
+    }
+}
+#endif
+
 /*! *********************************************************************************
  * \brief        Timer handler for flushing the UART.
  *
@@ -1510,6 +2443,29 @@ static void UartStreamFlushTimerCallback
     }
 }
 
+/*! *********************************************************************************
+ * \brief        Timer handler for sending the TX queues again.
+ *
+ * \param[in]    pParam             Callback parameters.
+ ********************************************************************************** */
+static void TxRetryTimerCallback
+(
+    void *pParam
+)
+{
+    if (!mTxRetryPending)
+    {
+        mTxRetryPending = TRUE;
+        if (gBleSuccess_c != App_PostCallbackMessage(BleApp_ServiceTxQueues, NULL))
+        {
+            /* The queue is full, try again after another interval */
+            mTxRetryPending = FALSE;
+            (void)TM_Start((timer_handle_t)mTxRetryTimerId,
+                        (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, mAppTxRetryIntervalInMs_c);
+        }
+    }
+}
+
 /*! *********************************************************************************
 * \brief        Handles UART Receive callback.
 *
@@ -1873,185 +2829,790 @@ static void BluetoothLEHost_Initialized(void)
 #endif /* gWuart_CentralRole_c */
 #endif /* gWuart_AutoStart_c */
 
-#if (defined(gAppButtonCnt_c) && (gAppButtonCnt_c == 1))
-    Serial_Print("\n\rWireless UART starting as GAP Central.\n\r", gAllowToBlock_d);
-    Serial_Print("\n\rWithin one second, either:\n\r", gAllowToBlock_d);
-    Serial_Print(" - double press the switch to change the role or\n\r", gAllowToBlock_d);
-    Serial_Print(" - single press to start the application with the selected role.\n\r", gAllowToBlock_d);
-#else
-    if (mGapRole == gGapCentral_c)
+#if (defined(gAppButtonCnt_c) && (gAppButtonCnt_c == 1))
+    Serial_Print("\n\rWireless UART starting as GAP Central.\n\r", gAllowToBlock_d);
+    Serial_Print("\n\rWithin one second, either:\n\r", gAllowToBlock_d);
+    Serial_Print(" - double press the switch to change the role or\n\r", gAllowToBlock_d);
+    Serial_Print(" - single press to start the application with the selected role.\n\r", gAllowToBlock_d);
+#else
+    if (mGapRole == gGapCentral_c)
+    {
+        Serial_Print("\n\rWireless UART starting as GAP Central.\n\r", gAllowToBlock_d);
+    }
+    else
+    {
+        Serial_Print("\n\rWireless UART starting as GAP Peripheral.\n\r", gAllowToBlock_d);
+    }
+#endif
+#if gWuart_PeripheralRole_c == 1
+    mAdvState.advOn = FALSE;
+#endif /* gWuart_PeripheralRole_c */
+
+#if gWuart_CentralRole_c == 1
+    mScanningOn = FALSE;
+#endif /* gWuart_CentralRole_c */
+
+    /* Start services */
+    (void)Wus_Start(&mWuServiceConfig);
+
+    mBasServiceConfig.batteryLevel = SENSORS_GetBatteryLevel();
+    (void)Bas_Start(&mBasServiceConfig);
+
+    /* Allocate application timer */
+    (void)TM_Open(mAppTimerId);
+    (void)TM_Open(mUartStreamFlushTimerId);
+    (void)TM_Open(mTxRetryTimerId);
+#if (MPL3115_ASCII_ALERT_MODE == 0) && (MPL3115_EVENT_BATCH_MS > 0U)
+    (void)TM_Open(mTamperBatchTimerId);
+#endif
+    (void)TM_Open(mBatteryMeasurementTimerId);
+    (void)TM_Open(mpl3115Id);
+
+#if (gAppButtonCnt_c == 1)
+    (void)TM_Open(mSwitchPressTimerId);
+#endif
+
+#if !(defined(cPWR_UsePowerDownMode) && (cPWR_UsePowerDownMode))
+    LedStartFlashingAllLeds();
+#endif
+#if (gWuart_AutoStart_c == 1)
+    BleApp_Start(mGapRole);
+#endif
+}
+
+/*! *********************************************************************************
+ * \brief        Function handling the geeneric events from the host stack.
+ *
+ ********************************************************************************** */
+static void BluetoothLEHost_GenericCallback(gapGenericEvent_t *pGenericEvent)
+{
+    /* Call BLE Conn Manager */
+    BleConnManager_GenericEvent(pGenericEvent);
+
+#if defined(gUseControllerNotifications_c) && (gUseControllerNotifications_c)
+    if (pGenericEvent->eventType == gControllerNotificationEvent_c)
+    {
+        BleApp_HandleControllerNotification(&pGenericEvent->eventData.notifEvent);
+    }
+#endif /* gUseControllerNotifications_c */
+    if(pGenericEvent->eventType == gInternalError_c)
+    {
+        if((pGenericEvent->eventData.internalError.errorCode == gBleOverflow_c) && (pGenericEvent->eventData.internalError.errorSource == gAddNewConnection_c))
+        {
+            Serial_Print("Connection failed ", gAllowToBlock_d);
+#if gWuart_PeripheralRole_c == 1
+            if(mAdvState.advOn)
+            {
+                mAdvState.advOn = FALSE;
+                Serial_Print(" as peripheral.\n\r", gAllowToBlock_d);
+            }
+            else
+#endif /* gWuart_PeripheralRole_c == 1 */
+            {
+#if gWuart_CentralRole_c == 1
+                Serial_Print(" as central.\n\r", gAllowToBlock_d);
+#endif /* gWuart_CentralRole_c == 1 */
+
+            }
+        }
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Sensor engine hook, looks up the variant and sets up the MPL3115 driver once the probe found it.
+ *
+ * \param[in]    pSlot       Engine slot of the MPL3115.
+ *
+ * \return       SENSOR_ERROR_NONE on success.
+ ********************************************************************************** */
+static int32_t mpl3115_engine_init(sensorengineslot_t *pSlot)
+{
+    int32_t status;
+    uint8_t whoami;
+    mpl3115_i2c_sensorhandle_t *pDriver = (mpl3115_i2c_sensorhandle_t *)pSlot->pHandle;
+
+    mpl3115WhoAmI = pSlot->whoAmI;
+    pMpl3115Variant = SensorRegistry_Find(cMpl3115Variants, SENSOR_REGISTRY_COUNT(cMpl3115Variants), pSlot->whoAmI);
+    status = MPL3115_I2C_Initialize(pDriver, I2Cdrv, pSlot->pEngine->deviceInstance, pSlot->pOps->slaveAddress,
+                                    &whoami);
+    if (SENSOR_ERROR_NONE != status)
+    {
+        return status;
+    }
+    Register_I2C_AttachCache(&pDriver->deviceInfo, &mpl3115RegCache);
+#if (defined(RTE_I2C1_DMA_EN) && RTE_I2C1_DMA_EN)
+    /*! Sleep in WFI while eDMA moves the data instead of spinning on the completion flag. */
+    MPL3115_I2C_SetIdleTask(pDriver, Register_I2C_WaitForInterrupt, &pDriver->deviceInfo);
+#endif
+    pSlot->pDevInfo = &pDriver->deviceInfo;
+
+    return SENSOR_ERROR_NONE;
+}
+
+/*! *********************************************************************************
+ * \brief        Sensor engine hook, applies the normal mode configuration of the variant.
+ *
+ * \param[in]    pSlot       Engine slot of the MPL3115.
+ *
+ * \return       SENSOR_ERROR_NONE on success, SENSOR_ERROR_INIT if the variant lacks a feature of the build.
+ ********************************************************************************** */
+static int32_t mpl3115_engine_configure(sensorengineslot_t *pSlot)
+{
+    if (NULL == pMpl3115Variant)
+    {
+        return SENSOR_ERROR_BAD_ADDRESS;
+    }
+#if (MPL3115_FIFO_BASELINE_MODE == 1)
+    if ((0U == (pMpl3115Variant->caps & SENSOR_CAP_BUFFER)) || (NUM_AVG_SAMPLES > pMpl3115Variant->bufDepth))
+    {
+        return SENSOR_ERROR_INIT;
+    }
+#endif
+#if (MPL3115_WINDOW_DETECT_MODE == 1)
+    if (0U == (pMpl3115Variant->caps & SENSOR_CAP_WINDOW))
+    {
+        return SENSOR_ERROR_INIT;
+    }
+#endif
+
+    return MPL3115_I2C_Configure((mpl3115_i2c_sensorhandle_t *)pSlot->pHandle, pMpl3115Variant->pConfig);
+}
+
+/*! The pressure samples are taken by the baseline and window logic, the engine does not poll the MPL3115. */
+static const sensorengineops_t cMpl3115EngineOps = {
+    .slaveAddress = MPL3115_I2C_ADDR,
+    .whoAmIReg = MPL3115_WHO_AM_I,
+    .pWhoAmIValues = cMpl3115WhoAmI,
+    .numWhoAmIValues = sizeof(cMpl3115WhoAmI),
+    .init = mpl3115_engine_init,
+    .configure = mpl3115_engine_configure,
+    .pPollList = NULL,
+    .decode = NULL,
+};
+
+
+int mpl3115_int_BLE(void)
+    {
+
+        int32_t status;
+        uint8_t descriptor[SENSOR_DESCRIPTOR_SIZE];
+
+        BleApp_SendUartStream(&vec_init[0], 70U);
+        pMpl3115Variant = NULL;
+        mpl3115WhoAmI = 0U;
+
+#if (defined(RTE_I2C1_DMA_EN) && RTE_I2C1_DMA_EN)
+        /*! The CMSIS driver moves the I2C data through eDMA, bring the controller up first. */
+        edma_config_t edmaConfig;
+        EDMA_GetDefaultConfig(&edmaConfig);
+        EDMA_Init(RTE_I2C1_DMA_TX_DMA_BASE, &edmaConfig);
+#endif
+
+        /*! Initialize the I2C driver. */
+        status = I2Cdrv->Initialize(I2C_S_SIGNAL_EVENT);
+        if (ARM_DRIVER_OK != status)
+        {
+
+        	BleApp_SendUartStream(&vec_i2c_init[0], 70U);
+
+            return -1;
+        }
+
+        /*! Set the I2C Power mode. */
+        status = I2Cdrv->PowerControl(ARM_POWER_FULL);
+        if (ARM_DRIVER_OK != status)
+        {
+
+        	BleApp_SendUartStream(&vec_power_cont[0], 70U);
+
+            return -1;
+        }
+
+        /*! Set the I2C bus speed. */
+        status = I2Cdrv->Control(ARM_I2C_BUS_SPEED, ARM_I2C_BUS_SPEED_FAST);
+        if (ARM_DRIVER_OK != status)
+        {
+        	BleApp_SendUartStream(&vec_mode_cont[0], 70U);
+
+            return -1;
+        }
+#if (REGISTER_I2C_PROFILE == 1)
+        /*! Count the bus cost of this session from here. */
+        Register_I2C_ProfileReset();
+#endif
+
+        /* Init output LED GPIO. */
+        GPIO_PinInit(BOARD_INITPINS_LED_GREEN_GPIO, BOARD_INITPINS_LED_GREEN_PIN, &led_config);
+        GPIO_PinInit(BOARD_INITPINS_LED_BLUE_GPIO, BOARD_INITPINS_LED_BLUE_PIN, &led_config);
+        GPIO_PinInit(BOARD_INITPINS_LED_RED_GPIO, BOARD_INITPINS_LED_RED_PIN, &led_config);
+
+        Baseline_Init(&mMpl3115Baseline, MPL3115_BASELINE_SHIFT, MPL3115_BASELINE_GATE);
+        PollSched_Init(&mMpl3115Poll, &cMpl3115PollConfig);
+#if (MPL3115_SNAPSHOT_MODE == 1)
+        mpl3115_snapshot_init();
+#endif
+#if (MPL3115_TEMP_COMP_MODE == 1)
+        mpl3115_temp_comp_init();
+#endif
+
+        /*! Probe the bus, the MPL3115 driver is initialized and configured once its WHO_AM_I answers. */
+        mpl3115Slot.pOps = &cMpl3115EngineOps;
+        mpl3115Slot.pHandle = &mpl3115Driver;
+        SensorEngine_Init(&mpl3115Engine, I2Cdrv, I2C_S_DEVICE_INDEX, &mpl3115Slot, 1);
+        (void)SensorEngine_Probe(&mpl3115Engine);
+        if (SENSOR_ENGINE_NOT_PRESENT == mpl3115Slot.status)
+        {
+        	BleApp_SendUartStream(&vec_inint_sensor[0], 70U);
+
+            return -1;
+        }
+        if (NULL == pMpl3115Variant)
+        {
+        	BleApp_SendUartStream(&vec_whoiam[0], 70U);
+
+            return -1;
+        }
+        /*! Tell the peers which part answered and what it can do. */
+        BleApp_SendUartStream(descriptor, SensorRegistry_Describe(pMpl3115Variant, mpl3115WhoAmI, descriptor));
+        Serial_Print("\n\rSensor ", gAllowToBlock_d);
+        Serial_Print(pMpl3115Variant->pName, gAllowToBlock_d);
+        Serial_Print("\n\r", gAllowToBlock_d);
+
+        if (!mpl3115Slot.present)
+        {
+        	BleApp_SendUartStream(&vec_sensor_err[0], 70U);
+            return -1;
+        }
+    	BleApp_SendUartStream(&vec_sensor_succ[0], 70U);
+
+#if (MPL3115_FIFO_BASELINE_MODE == 1)
+        /*! Route the FIFO watermark on INT1 to the MCU, it stays masked until a baseline is requested. */
+        if (0 != mpl3115_fifo_init())
+        {
+            return -1;
+        }
+#endif
+#if (MPL3115_WINDOW_DETECT_MODE == 1)
+        /*! The window is centred on a baseline, take one before handing over to the sensor. */
+        compute_baseline_pr = true;
+#endif
+
+        return 0;
+    }
+
+
+void mpl3115_CallBack()
+{
+
+		(void)TM_InstallCallback((timer_handle_t)mpl3115Id, mpl3115_TimerCallback, NULL);
+
+        (void)TM_Start((timer_handle_t)mpl3115Id,
+                    (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, PollSched_Interval(&mMpl3115Poll));
+        status_ble = 0;
+
+
+}
+
+void mpl3115_TimerCallback()
+	{
+	    (void)mpl3115_event_BLE();
+#if (MPL3115_WINDOW_DETECT_MODE == 1)
+	    /* The window interrupt takes over, nothing to poll while the asset is undisturbed. */
+	    if (TRUE == mMpl3115WindowArmed)
+	    {
+	        return;
+	    }
+#endif
+	    mpl3115_CallBack();
+	}
+
+#if (MPL3115_FIFO_BASELINE_MODE == 1)
+/*! *********************************************************************************
+ * \brief        Configures the MPL3115 INT1 pin for the FIFO watermark interrupt.
+ *
+ * \return       0 on success, -1 if the GPIO adapter rejected the pin.
+ ********************************************************************************** */
+static int mpl3115_fifo_init(void)
+{
+    hal_gpio_pin_config_t int1Config = {
+        kHAL_GpioDirectionIn,
+        0U,
+        (uint8_t)MPL3115_INT1_PORT_NUM,
+        (uint8_t)MPL3115_INT1_PIN,
+    };
+
+    /* The pin survives reconnections, only configure it once. */
+    if (TRUE == mMpl3115IrqReady)
+    {
+        return 0;
+    }
+
+    PORT_SetPinMux(MPL3115_INT1_PORT, MPL3115_INT1_PIN, kPORT_MuxAsGpio);
+
+    if (kStatus_HAL_GpioSuccess != HAL_GpioInit((hal_gpio_handle_t)mMpl3115Int1Handle, &int1Config))
+    {
+        return -1;
+    }
+    (void)HAL_GpioInstallCallback((hal_gpio_handle_t)mMpl3115Int1Handle, mpl3115_Int1Callback, NULL);
+
+    /* Only a baseline capture needs the watermark. */
+    (void)HAL_GpioSetTriggerMode((hal_gpio_handle_t)mMpl3115Int1Handle, kHAL_GpioInterruptDisable);
+    (void)HAL_GpioWakeUpSetting((hal_gpio_handle_t)mMpl3115Int1Handle, 1U);
+
+    mMpl3115IrqReady = TRUE;
+
+    return 0;
+}
+
+/*! *********************************************************************************
+ * \brief        Starts a baseline capture: enables the FIFO and unmasks the watermark interrupt.
+ *
+ * \return       0 on success, -1 if the sensor could not be configured.
+ ********************************************************************************** */
+static int mpl3115_fifo_start(void)
+{
+    int32_t status;
+
+    /* Enabling F_MODE empties the FIFO, the batch only holds samples taken from now on. */
+    status = MPL3115_I2C_Configure(&mpl3115Driver, cMpl3115FifoStart);
+    if (SENSOR_ERROR_NONE != status)
+    {
+        return -1;
+    }
+
+    /* Drain whatever has queued should the watermark edge never come. */
+    mMpl3115FifoDeadline = TM_GetTimestamp() + (uint64_t)(NUM_AVG_SAMPLES + 1) * MPL3115_SAMPLE_PERIOD_US;
+    mMpl3115FifoArmed = TRUE;
+
+    (void)HAL_GpioSetTriggerMode((hal_gpio_handle_t)mMpl3115Int1Handle, kHAL_GpioInterruptRisingEdge);
+
+    return 0;
+}
+
+/*! *********************************************************************************
+ * \brief        Ends a baseline capture: masks the watermark and returns to direct OUT reads.
+ ********************************************************************************** */
+static void mpl3115_fifo_stop(void)
+{
+    (void)HAL_GpioSetTriggerMode((hal_gpio_handle_t)mMpl3115Int1Handle, kHAL_GpioInterruptDisable);
+    (void)MPL3115_I2C_Configure(&mpl3115Driver, cMpl3115FifoStop);
+    mMpl3115FifoArmed = FALSE;
+}
+
+/*! *********************************************************************************
+ * \brief        INT1 interrupt callback, runs in interrupt context.
+ *
+ * \param[in]    pParam      Unused.
+ ********************************************************************************** */
+static void mpl3115_Int1Callback(void *pParam)
+{
+    (void)pParam;
+
+    if (!mMpl3115Int1Pending)
+    {
+        mMpl3115Int1Pending = TRUE;
+        if (gBleSuccess_c != App_PostCallbackMessage(mpl3115_Int1Handler, NULL))
+        {
+            /* The queue is full, let the next edge try again. */
+            mMpl3115Int1Pending = FALSE;
+        }
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Deferred INT1 handler, runs in the application task.
+ *
+ * \param[in]    pParam      Unused.
+ ********************************************************************************** */
+static void mpl3115_Int1Handler(void *pParam)
+{
+    (void)pParam;
+
+    mMpl3115Int1Pending = FALSE;
+
+    /* Only one source is enabled on INT1 at a time, late edges find neither armed. */
+    if (TRUE == mMpl3115FifoArmed)
     {
-        Serial_Print("\n\rWireless UART starting as GAP Central.\n\r", gAllowToBlock_d);
+        mpl3115_fifo_drain();
     }
-    else
+#if (MPL3115_WINDOW_DETECT_MODE == 1)
+    else if (TRUE == mMpl3115WindowArmed)
     {
-        Serial_Print("\n\rWireless UART starting as GAP Peripheral.\n\r", gAllowToBlock_d);
+        mpl3115_window_alert();
     }
 #endif
-#if gWuart_PeripheralRole_c == 1
-    mAdvState.advOn = FALSE;
-#endif /* gWuart_PeripheralRole_c */
+}
 
-#if gWuart_CentralRole_c == 1
-    mScanningOn = FALSE;
-#endif /* gWuart_CentralRole_c */
+/*! *********************************************************************************
+ * \brief        Drains the FIFO in one I2C burst and sets the baseline.
+ ********************************************************************************** */
+static void mpl3115_fifo_drain(void)
+{
+    int32_t status;
+    uint8_t numSamples = 0U;
+    uint8_t fifoStatus = 0U;
 
-    /* Start services */
-    (void)Wus_Start(&mWuServiceConfig);
+    status = MPL3115_I2C_ReadFifo(&mpl3115Driver, mMpl3115FifoSamples, MPL3115_FIFO_MAX_SAMPLES,
+                                  (uint32_t)TM_GetTimestamp(), MPL3115_SAMPLE_PERIOD_US, &numSamples, &fifoStatus);
+    if (SENSOR_ERROR_NONE != status)
+    {
+        BleApp_SendUartStream(&vec_read_failed[0], 70U);
+        return;
+    }
 
-    mBasServiceConfig.batteryLevel = SENSORS_GetBatteryLevel();
-    (void)Bas_Start(&mBasServiceConfig);
+    /* The oldest samples were overwritten, the batch is still the most recent one. */
+    if (0U != (fifoStatus & MPL3115_F_STATUS_F_OVF_MASK))
+    {
+        mMpl3115FifoOverflows++;
+    }
 
-    /* Allocate application timer */
-    (void)TM_Open(mAppTimerId);
-    (void)TM_Open(mUartStreamFlushTimerId);
-    (void)TM_Open(mBatteryMeasurementTimerId);
-    (void)TM_Open(mpl3115Id);
+    /* Nothing queued yet, give the sensor another acquisition period. */
+    if (0U == numSamples)
+    {
+        mMpl3115FifoDeadline = TM_GetTimestamp() + MPL3115_SAMPLE_PERIOD_US;
+        return;
+    }
 
-#if (gAppButtonCnt_c == 1)
-    (void)TM_Open(mSwitchPressTimerId);
+#if (MPL3115_SNAPSHOT_MODE == 1)
+    for (uint8_t n = 0U; n < numSamples; n++)
+    {
+        mpl3115_snapshot_push(mMpl3115FifoSamples[n].timestamp, (int32_t)mMpl3115FifoSamples[n].pressure,
+                             mMpl3115FifoSamples[n].temperature, 0);
+    }
 #endif
 
-#if !(defined(cPWR_UsePowerDownMode) && (cPWR_UsePowerDownMode))
-    LedStartFlashingAllLeds();
+    /*! Get the baseline/reference pressure value, a partial batch is averaged as is. */
+    refPressure = MPL3115_AveragePressure(mMpl3115FifoSamples, numSamples);
+#if (MPL3115_TEMP_COMP_MODE == 1)
+    {
+        int32_t temperature = 0;
+
+        /*! The correction is linear, correcting the mean at the mean temperature corrects every sample. */
+        for (uint8_t n = 0U; n < numSamples; n++)
+        {
+            temperature += mMpl3115FifoSamples[n].temperature;
+        }
+        mMpl3115Temperature = temperature / numSamples;
+        refPressure = (uint32_t)((int32_t)refPressure - TempComp_Correction(&mMpl3115TempComp, mMpl3115Temperature));
+    }
+    pressureInPascals = mpl3115_compensate(mMpl3115FifoSamples[numSamples - 1U].pressure,
+                                           mMpl3115FifoSamples[numSamples - 1U].temperature);
+#else
+    pressureInPascals = mMpl3115FifoSamples[numSamples - 1U].pressure / MPL3115_PRESSURE_CONV_FACTOR;
 #endif
-#if (gWuart_AutoStart_c == 1)
-    BleApp_Start(mGapRole);
+    Baseline_Seed(&mMpl3115Baseline, (int32_t)refPressure);
+
+    mpl3115_fifo_stop();
+    compute_baseline_pr = false;
+#if (MPL3115_ASCII_ALERT_MODE == 1)
+    BleApp_SendUartStream(&normal_pressure[0], 70U);
+#else
+    mpl3115_send_event(mTamperEvent_Safe_c, mTamperSeverity_Info_c);
 #endif
 }
+#endif /* MPL3115_FIFO_BASELINE_MODE */
 
+#if (MPL3115_WINDOW_DETECT_MODE == 1)
 /*! *********************************************************************************
- * \brief        Function handling the geeneric events from the host stack.
+ * \brief        Centres the pressure window on the baseline and unmasks its interrupt.
  *
+ * \return       0 on success, -1 if the sensor could not be configured.
  ********************************************************************************** */
-static void BluetoothLEHost_GenericCallback(gapGenericEvent_t *pGenericEvent)
+static int mpl3115_window_start(void)
 {
-    /* Call BLE Conn Manager */
-    BleConnManager_GenericEvent(pGenericEvent);
+    int32_t status;
 
-#if defined(gUseControllerNotifications_c) && (gUseControllerNotifications_c)
-    if (pGenericEvent->eventType == gControllerNotificationEvent_c)
+#if (MPL3115_TEMP_COMP_MODE == 1)
+    /*! The sensor compares raw pressures, centre the window on the baseline plus the current error. */
+    (void)TempComp_Update(&mMpl3115TempComp, mMpl3115Temperature);
+    status = MPL3115_I2C_SetWindows(&mpl3115Driver, (uint32_t)((int32_t)refPressure + mMpl3115TempComp.applied),
+                                    PRESSURE_THS, mpl3115_temp_target(), MPL3115_TEMP_COMP_STEP_C);
+#else
+    status = MPL3115_I2C_SetPressureWindow(&mpl3115Driver, refPressure, PRESSURE_THS);
+#endif
+    if (SENSOR_ERROR_NONE != status)
     {
-        BleApp_HandleControllerNotification(&pGenericEvent->eventData.notifEvent);
+        return -1;
     }
-#endif /* gUseControllerNotifications_c */
-    if(pGenericEvent->eventType == gInternalError_c)
+
+    status = MPL3115_I2C_Configure(&mpl3115Driver, cMpl3115WindowStart);
+    if (SENSOR_ERROR_NONE != status)
     {
-        if((pGenericEvent->eventData.internalError.errorCode == gBleOverflow_c) && (pGenericEvent->eventData.internalError.errorSource == gAddNewConnection_c))
-        {
-            Serial_Print("Connection failed ", gAllowToBlock_d);
-#if gWuart_PeripheralRole_c == 1
-            if(mAdvState.advOn)
-            {
-                mAdvState.advOn = FALSE;
-                Serial_Print(" as peripheral.\n\r", gAllowToBlock_d);
-            }
-            else
-#endif /* gWuart_PeripheralRole_c == 1 */
-            {
-#if gWuart_CentralRole_c == 1
-                Serial_Print(" as central.\n\r", gAllowToBlock_d);
-#endif /* gWuart_CentralRole_c == 1 */
+        return -1;
+    }
 
-            }
-        }
+    mMpl3115WindowArmed = TRUE;
+    (void)HAL_GpioSetTriggerMode((hal_gpio_handle_t)mMpl3115Int1Handle, kHAL_GpioInterruptRisingEdge);
+
+    return 0;
+}
+
+/*! *********************************************************************************
+ * \brief        Masks the pressure window interrupt.
+ ********************************************************************************** */
+static void mpl3115_window_stop(void)
+{
+    if (FALSE == mMpl3115WindowArmed)
+    {
+        return;
     }
+
+    (void)HAL_GpioSetTriggerMode((hal_gpio_handle_t)mMpl3115Int1Handle, kHAL_GpioInterruptDisable);
+    (void)MPL3115_I2C_Configure(&mpl3115Driver, cMpl3115WindowStop);
+    mMpl3115WindowArmed = FALSE;
 }
 
+/*! *********************************************************************************
+ * \brief        The pressure left the window: raises the alert and re-baselines.
+ ********************************************************************************** */
+static void mpl3115_window_alert(void)
+{
+    int32_t status;
 
-int mpl3115_int_BLE(void)
+    /*! Read the pressure which left the window, this also clears SRC_PW and SRC_TW. */
+    status = MPL3115_I2C_ReadData(&mpl3115Driver, cMpl3115OutputNormal, data);
+    if (ARM_DRIVER_OK == status)
     {
+        rawData.pressure = (uint32_t)((data[0]) << 16) | ((data[1]) << 8) | ((data[2]));
+#if (MPL3115_TEMP_COMP_MODE == 1)
+        pressureInPascals = mpl3115_compensate(rawData.pressure, (int16_t)((data[3] << 8) | data[4]));
+        /*! Only the temperature left its window, follow it and keep watching. */
+        if ((pressureInPascals <= refPressure + PRESSURE_THS) && (pressureInPascals + PRESSURE_THS >= refPressure))
+        {
+            mpl3115_window_follow();
+            return;
+        }
+#else
+        pressureInPascals = rawData.pressure / MPL3115_PRESSURE_CONV_FACTOR;
+#endif
+#if (MPL3115_SNAPSHOT_MODE == 1)
+        mpl3115_snapshot_push((uint32_t)TM_GetTimestamp(), (int32_t)rawData.pressure,
+                             (int16_t)((data[3] << 8) | data[4]), 0);
+#endif
+    }
 
-        int32_t status;
-        uint8_t whoami;
+    mpl3115_window_stop();
 
-        BleApp_SendUartStream(&vec_init[0], 70U);
+#if (MPL3115_ASCII_ALERT_MODE == 1)
+    BleApp_SendUartStream(&pressure_alert1[0], 70U);
+    BleApp_SendUartStream(&pressure_tamper[0], 70U);
+    BleApp_SendUartStream(&pressure_alert2[0], 70U);
+#else
+    mpl3115_send_event(mTamperEvent_Pressure_c, mTamperSeverity_Alert_c);
+#endif
+#if (MPL3115_SNAPSHOT_MODE == 1)
+    mpl3115_snapshot_trigger();
+#endif
+    compute_baseline_pr = true;
 
-        /*! Initialize the I2C driver. */
-        status = I2Cdrv->Initialize(I2C_S_SIGNAL_EVENT);
-        if (ARM_DRIVER_OK != status)
-        {
+    /* The poll timer drives the re-baseline, the window is re-centred once it completes. */
+    mpl3115_CallBack();
+}
 
-        	BleApp_SendUartStream(&vec_i2c_init[0], 70U);
+#if (MPL3115_TEMP_COMP_MODE == 1)
+/*! *********************************************************************************
+ * \brief        The temperature left its window: re-centres it, and moves the pressure window only once the
+ *               correction has changed by more than MPL3115_TEMP_COMP_HYS.
+ ********************************************************************************** */
+static void mpl3115_window_follow(void)
+{
+    int32_t status;
 
-            return -1;
-        }
+    if (TempComp_Update(&mMpl3115TempComp, mMpl3115Temperature))
+    {
+        status = MPL3115_I2C_SetWindows(&mpl3115Driver, (uint32_t)((int32_t)refPressure + mMpl3115TempComp.applied),
+                                        PRESSURE_THS, mpl3115_temp_target(), MPL3115_TEMP_COMP_STEP_C);
+    }
+    else
+    {
+        /*! The pressure window stays, T_TGT is the only register to move. */
+        status = Register_I2C_Write(mpl3115Driver.pCommDrv, &mpl3115Driver.deviceInfo, mpl3115Driver.slaveAddress,
+                                    MPL3115_T_TGT, (uint8_t)mpl3115_temp_target(), 0, false);
+    }
 
-        /*! Set the I2C Power mode. */
-        status = I2Cdrv->PowerControl(ARM_POWER_FULL);
-        if (ARM_DRIVER_OK != status)
-        {
+    if (ARM_DRIVER_OK != status)
+    {
+        BleApp_SendUartStream(&vec_sensor_err[0], 70U);
+    }
+}
+#endif
+#endif /* MPL3115_WINDOW_DETECT_MODE */
 
-        	BleApp_SendUartStream(&vec_power_cont[0], 70U);
+#if (MPL3115_TEMP_COMP_MODE == 1)
+/*! *********************************************************************************
+ * \brief        Restores the per-unit temperature coefficients, an uncalibrated unit is not corrected.
+ ********************************************************************************** */
+static void mpl3115_temp_comp_init(void)
+{
+#if defined(gAppUseNvm_d) && (gAppUseNvm_d > 0)
+    if (gNVM_OK_c != NvRestoreDataSet(&mMpl3115TempCoeffs, FALSE))
+    {
+        mMpl3115TempCoeffs.magic = 0U;
+    }
+#endif
+    (void)TempComp_Init(&mMpl3115TempComp, &mMpl3115TempCoeffs, MPL3115_TEMP_COMP_HYS);
+}
 
-            return -1;
-        }
+/*! *********************************************************************************
+ * \brief        Converts a raw pressure and removes the error at the temperature of the same burst.
+ *
+ * \param[in]    pressure     Raw pressure, 1/64 Pa.
+ * \param[in]    temperature  Raw temperature, 1/256 degree C.
+ *
+ * \return       Corrected pressure in Pa.
+ ********************************************************************************** */
+static uint32_t mpl3115_compensate(uint32_t pressure, int16_t temperature)
+{
+    mMpl3115Temperature = temperature;
 
-        /*! Set the I2C bus speed. */
-        status = I2Cdrv->Control(ARM_I2C_BUS_SPEED, ARM_I2C_BUS_SPEED_FAST);
-        if (ARM_DRIVER_OK != status)
-        {
-        	BleApp_SendUartStream(&vec_mode_cont[0], 70U);
+    return (uint32_t)((int32_t)(pressure / MPL3115_PRESSURE_CONV_FACTOR) -
+                      TempComp_Correction(&mMpl3115TempComp, temperature));
+}
 
-            return -1;
-        }
+/*! *********************************************************************************
+ * \brief        Returns the latest temperature rounded to the 1 degree C of T_TGT.
+ ********************************************************************************** */
+static int8_t mpl3115_temp_target(void)
+{
+    return (int8_t)((mMpl3115Temperature >= 0) ? ((mMpl3115Temperature + 128) / 256) :
+                                                 -((128 - mMpl3115Temperature) / 256));
+}
+#endif /* MPL3115_TEMP_COMP_MODE */
 
-        /* Init output LED GPIO. */
-        GPIO_PinInit(BOARD_INITPINS_LED_GREEN_GPIO, BOARD_INITPINS_LED_GREEN_PIN, &led_config);
-        GPIO_PinInit(BOARD_INITPINS_LED_BLUE_GPIO, BOARD_INITPINS_LED_BLUE_PIN, &led_config);
-        GPIO_PinInit(BOARD_INITPINS_LED_RED_GPIO, BOARD_INITPINS_LED_RED_PIN, &led_config);
+#if (MPL3115_ASCII_ALERT_MODE == 0)
+/*! *********************************************************************************
+ * \brief        Sends one binary event record to the peers, in a single write, with the latest pressure and the
+ *               reference it is compared with.
+ *
+ * \param[in]    type        tamperEventType_t.
+ * \param[in]    severity    tamperSeverity_t.
+ ********************************************************************************** */
+static void mpl3115_send_event(uint8_t type, uint8_t severity)
+{
+    tamperevent_t event;
+    uint8_t record[TAMPER_EVENT_MAX_SIZE];
+    uint32_t recordSize;
+    uint8_t pressure[TAMPER_ITEM_LENGTH(TAMPER_ITEM_PRESSURE)];
+
+    TamperEvent_Init(&event, type, severity, mpl3115WhoAmI,
+                     mMpl3115EventSeq++, (uint32_t)(TM_GetTimestamp() / 1000U));
+    pressure[0] = (uint8_t)pressureInPascals;
+    pressure[1] = (uint8_t)(pressureInPascals >> 8);
+    pressure[2] = (uint8_t)(pressureInPascals >> 16);
+    pressure[3] = (uint8_t)(pressureInPascals >> 24);
+    pressure[4] = (uint8_t)refPressure;
+    pressure[5] = (uint8_t)(refPressure >> 8);
+    pressure[6] = (uint8_t)(refPressure >> 16);
+    pressure[7] = (uint8_t)(refPressure >> 24);
+    (void)TamperEvent_AddItem(&event, TAMPER_ITEM_PRESSURE, pressure);
+
+    recordSize = TamperEvent_Encode(&event, record, sizeof(record));
+#if (MPL3115_BROADCAST_MODE == 1)
+    BleApp_UpdateBeacon(record, recordSize);
+    BleApp_RestartBeacon(TRUE);
+#endif
+#if (MPL3115_EVENT_BATCH_MS > 0U)
+    BleApp_QueueTamperEvent(record, recordSize, (mTamperSeverity_Alert_c == severity) ? TRUE : FALSE);
+#else
+    BleApp_SendTamperEvent(record, recordSize);
+#endif
+}
+#endif /* MPL3115_ASCII_ALERT_MODE */
 
-        /*! Initialize MPL3115 sensor driver. */
-        status = MPL3115_I2C_Initialize(&mpl3115Driver, &I2C_S_DRIVER, I2C_S_DEVICE_INDEX, MPL3115_I2C_ADDR,
-                                        &whoami);
-        if (ARM_DRIVER_OK != status)
-        {
-        	BleApp_SendUartStream(&vec_inint_sensor[0], 70U);
+#if (MPL3115_SNAPSHOT_MODE == 1)
+/*! *********************************************************************************
+ * \brief        Hands the snapshot ring its static storage and starts recording.
+ ********************************************************************************** */
+static void mpl3115_snapshot_init(void)
+{
+    if (NULL != mMpl3115Snapshot.pStorage)
+    {
+        return;
+    }
 
-            return -1;
-        }
-        if ((MPL3115_WHOAMI_VALUE == whoami))
+    /* The size is checked at build time, the ring cannot refuse its storage. */
+    (void)CaptureRing_Init(&mMpl3115Snapshot, mMpl3115SnapshotStorage, MPL3115_SNAPSHOT_SAMPLES);
+}
 
-        {
-        	BleApp_SendUartStream(&vec_mpl3115[0], 70U);
+/*! *********************************************************************************
+ * \brief        Records one sample from the acquisition path, never waits.
+ *
+ * \param[in]    timestamp   Time the sample was taken, us.
+ * \param[in]    v0          First sensor value.
+ * \param[in]    v1          Second sensor value.
+ * \param[in]    v2          Third sensor value.
+ ********************************************************************************** */
+static void mpl3115_snapshot_push(uint32_t timestamp, int32_t v0, int32_t v1, int32_t v2)
+{
+    capturesample_t sample = {timestamp, {v0, v1, v2}};
 
-        }
-        else if ((FXPQ3115_WHOAMI_VALUE == whoami))
-        {
-             BleApp_SendUartStream(&vec_fxpq3115[0], 70U);
+    if (NULL == mMpl3115Snapshot.pStorage)
+    {
+        return;
+    }
 
-        }
+    (void)CaptureRing_Push(&mMpl3115Snapshot, &sample);
 
-        /*! Configure the MPL3115 sensor. */
-        status = MPL3115_I2C_Configure(&mpl3115Driver, cMpl3115ConfigNormal);
-        if (SENSOR_ERROR_NONE != status)
+    /* Stream the snapshot out as its post trigger samples come in. */
+    if (mMpl3115Snapshot.triggered && (FALSE == mMpl3115SnapshotSendPending))
+    {
+        mMpl3115SnapshotSendPending = TRUE;
+        if (gBleSuccess_c != App_PostCallbackMessage(mpl3115_SnapshotSendHandler, NULL))
         {
-        	BleApp_SendUartStream(&vec_sensor_err[0], 70U);
-            return -1;
+            mMpl3115SnapshotSendPending = FALSE;
         }
-    	BleApp_SendUartStream(&vec_sensor_succ[0], 70U);
+    }
+}
 
-        return 0;
+/*! *********************************************************************************
+ * \brief        Freezes the samples around the alert and starts sending them to the peers.
+ ********************************************************************************** */
+static void mpl3115_snapshot_trigger(void)
+{
+    if ((NULL == mMpl3115Snapshot.pStorage) ||
+        !CaptureRing_Trigger(&mMpl3115Snapshot, MPL3115_SNAPSHOT_PRE, MPL3115_SNAPSHOT_POST))
+    {
+        return;
     }
 
+    BleApp_SendUartStream(&vec_snapshot[0], 70U);
+    mpl3115_SnapshotSendHandler(NULL);
+}
 
-void mpl3115_CallBack()
+/*! *********************************************************************************
+ * \brief        Sends the snapshot samples recorded so far, releases the ring once all are out.
+ *
+ * \details      Samples are read from the ring only while every peer has room
+ *               for them and mAppTxAlertReserve_c more entries, so that an alert
+ *               takes a free entry rather than a chunk of the snapshot. The rest
+ *               waits in the ring until BleApp_TxDrained posts the handler again.
+ *
+ * \param[in]    pParam      Unused.
+ ********************************************************************************** */
+static void mpl3115_SnapshotSendHandler(void *pParam)
 {
+    capturesample_t samples[4];
+    uint32_t count = 1U;
 
-		(void)TM_InstallCallback((timer_handle_t)mpl3115Id, mpl3115_TimerCallback, NULL);
+    (void)pParam;
 
-        (void)TM_Start((timer_handle_t)mpl3115Id,
-                    (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, mmpl3115IntervalInMs_c);
-        status_ble = 0;
+    mMpl3115SnapshotSendPending = FALSE;
 
+    while ((0U != count) && (BleApp_TxRoom(mTxClass_Snapshot_c) > mAppTxAlertReserve_c))
+    {
+        count = CaptureRing_Read(&mMpl3115Snapshot, samples, 4U);
+        if (0U != count)
+        {
+            (void)BleApp_QueueTx((uint8_t *)samples, count * (uint32_t)sizeof(capturesample_t), mTxClass_Snapshot_c);
+        }
+    }
 
+    if (CaptureRing_IsDone(&mMpl3115Snapshot))
+    {
+        CaptureRing_Release(&mMpl3115Snapshot);
+    }
 }
-
-void mpl3115_TimerCallback()
-	{
-	    (void)mpl3115_event_BLE();
-	    mpl3115_CallBack();
-	}
+#endif /* MPL3115_SNAPSHOT_MODE */
 
 int mpl3115_event_BLE(void)
 {
@@ -2061,12 +3622,38 @@ int mpl3115_event_BLE(void)
 	/* Get the baseline pressure reference value */
 	if (true == compute_baseline_pr)
 	{
+		/*! Stay at the fast rate until the new baseline is in. */
+		(void)PollSched_Update(&mMpl3115Poll, true);
 		GPIO_PortToggle(BOARD_INITPINS_LED_RED_GPIO, 1u << BOARD_INITPINS_LED_RED_PIN);
 		GPIO_PortSet(BOARD_INITPINS_LED_GREEN_GPIO, 1u << BOARD_INITPINS_LED_GREEN_PIN);
     	GPIO_PortSet(BOARD_INITPINS_LED_BLUE_GPIO, 1u << BOARD_INITPINS_LED_BLUE_PIN);
+#if (MPL3115_FIFO_BASELINE_MODE == 1)
+		/*! OUT_P aliases F_DATA while the FIFO runs, the watermark handler takes the baseline. */
+		if (FALSE == mMpl3115FifoArmed)
+		{
+#if (MPL3115_WINDOW_DETECT_MODE == 1)
+			mpl3115_window_stop();
+#endif
+			if (0 != mpl3115_fifo_start())
+			{
+				BleApp_SendUartStream(&vec_sensor_err[0], 70U);
+				return -1;
+			}
+		}
+		else if (TM_GetTimestamp() > mMpl3115FifoDeadline)
+		{
+			mpl3115_Int1Callback(NULL);
+		}
+#else
 		refPressure = 0;
 		apply_autozero();
+		Baseline_Seed(&mMpl3115Baseline, (int32_t)refPressure);
+#if (MPL3115_ASCII_ALERT_MODE == 1)
 		BleApp_SendUartStream(&normal_pressure[0], 70U);
+#else
+		mpl3115_send_event(mTamperEvent_Safe_c, mTamperSeverity_Info_c);
+#endif
+#endif
 	}
 	else
 	{
@@ -2075,6 +3662,19 @@ int mpl3115_event_BLE(void)
 		GPIO_PortSet(BOARD_INITPINS_LED_GREEN_GPIO, 1u << BOARD_INITPINS_LED_GREEN_PIN);
 		GPIO_PortSet(BOARD_INITPINS_LED_BLUE_GPIO, 1u << BOARD_INITPINS_LED_BLUE_PIN);
 
+#if (MPL3115_WINDOW_DETECT_MODE == 1)
+		/*! Hand the comparison over to the sensor, centred on the fresh baseline. */
+		if (FALSE == mMpl3115WindowArmed)
+		{
+			if (0 != mpl3115_window_start())
+			{
+				BleApp_SendUartStream(&vec_sensor_err[0], 70U);
+				return -1;
+			}
+		}
+		return 0;
+#endif
+
 		/*! Read instantaneous pressure values and compare with baseline/reference */
 		/*! Wait for data ready from the MPL3115. */
 		status = MPL3115_I2C_ReadData(&mpl3115Driver, cMpl3115Status, &dataReady);
@@ -2091,23 +3691,50 @@ int mpl3115_event_BLE(void)
 
 			/*! Process the sample and convert the raw sensor data. */
 			rawData.pressure = (uint32_t)((data[0]) << 16) | ((data[1]) << 8) | ((data[2]));
+#if (MPL3115_TEMP_COMP_MODE == 1)
+			pressureInPascals = mpl3115_compensate(rawData.pressure, (int16_t)((data[3] << 8) | data[4]));
+#else
 			pressureInPascals = rawData.pressure / MPL3115_PRESSURE_CONV_FACTOR;
+#endif
+#if (MPL3115_SNAPSHOT_MODE == 1)
+			mpl3115_snapshot_push((uint32_t)TM_GetTimestamp(), (int32_t)rawData.pressure,
+			                     (int16_t)((data[3] << 8) | data[4]), 0);
+#endif
 
 			if(init_refpressure == 1)
 			{
-				refPressure = pressureInPascals;
+				Baseline_Seed(&mMpl3115Baseline, (int32_t)pressureInPascals);
 				init_refpressure = 0;
 			}
+
+			/*! Let the reference follow drift, samples outside the band are not learnt. */
+			if (!Baseline_IsEvent(&mMpl3115Baseline, (int32_t)pressureInPascals, PRESSURE_THS))
+			{
+				Baseline_Update(&mMpl3115Baseline, (int32_t)pressureInPascals);
+			}
+			refPressure = (uint32_t)Baseline_Mean(&mMpl3115Baseline);
 		}
 
 		/*! Check instantaneous pressure value against reference pressure */
-		if ((abs(refPressure - pressureInPascals)) > PRESSURE_THS)
+		if (Baseline_IsEvent(&mMpl3115Baseline, (int32_t)pressureInPascals, PRESSURE_THS))
 		{
+			(void)PollSched_Update(&mMpl3115Poll, true);
+#if (MPL3115_ASCII_ALERT_MODE == 1)
 			BleApp_SendUartStream(&pressure_alert1[0], 70U);
 			BleApp_SendUartStream(&pressure_tamper[0], 70U);
 			BleApp_SendUartStream(&pressure_alert2[0], 70U);
+#else
+			mpl3115_send_event(mTamperEvent_Pressure_c, mTamperSeverity_Alert_c);
+#endif
+#if (MPL3115_SNAPSHOT_MODE == 1)
+			mpl3115_snapshot_trigger();
+#endif
 			compute_baseline_pr = true;
 		}
+		else
+		{
+			(void)PollSched_Update(&mMpl3115Poll, false);
+		}
 	}
 }
 
@@ -26,6 +26,11 @@ extern gpioHandleKSDK_t D10;
 #define I2C_S2_DEVICE_INDEX I2C1_INDEX
 #define I2C_S2_SIGNAL_EVENT I2C1_SignalEvent_t
 
+// NMH1000 OUT: magnetic switch output line, routed to a WUU capable GPIO
+#define NMH1000_OUT_PORT      PORTC
+#define NMH1000_OUT_PORT_NUM  PORTC_NUM
+#define NMH1000_OUT_PIN       1U
+
 // SPI: Driver information default SPI brought to shield
 #define SPI_S_DRIVER       Driver_SPI1
 #define SPI_S_BAUDRATE     500000U ///< Transfer baudrate - 500k
@@ -75,6 +75,10 @@ int32_t Sensor_I2C_Write(ARM_DRIVER_I2C *pCommDrv,
 {
     int32_t status;
     bool repeatedStart;
+    bool readBack;
+    uint8_t runLength;
+    uint8_t i;
+    uint8_t buffer[SENSOR_I2C_MAX_COALESCE];
 
     /*! Validate for the correct handle.*/
     if ((pCommDrv == NULL) || (pRegWriteList == NULL))
@@ -87,15 +91,48 @@ int32_t Sensor_I2C_Write(ARM_DRIVER_I2C *pCommDrv,
     /*! Update register values based on register write list unless the next Cmd is the list terminator */
     do
     {
-        repeatedStart = (pCmd + 1)->writeTo != 0xFFFF;
-        /*! Set the register based on the values in the register value pair.*/
-        status =
-            Register_I2C_Write(pCommDrv, devInfo, slaveAddress, pCmd->writeTo, pCmd->value, pCmd->mask, repeatedStart);
+        /*! With a shadow cache attached, entries on consecutive addresses go out as one block write.*/
+        runLength = 1;
+        readBack = pCmd->mask != 0;
+        if (devInfo->pCache != NULL)
+        {
+            while ((runLength < SENSOR_I2C_MAX_COALESCE) && ((pCmd + runLength)->writeTo != 0xFFFF) &&
+                   ((pCmd + runLength)->writeTo == pCmd->writeTo + runLength))
+            {
+                readBack |= (pCmd + runLength)->mask != 0;
+                runLength++;
+            }
+        }
+        repeatedStart = (pCmd + runLength)->writeTo != 0xFFFF;
+
+        if (runLength == 1)
+        {
+            /*! Set the register based on the values in the register value pair.*/
+            status = Register_I2C_Write(pCommDrv, devInfo, slaveAddress, pCmd->writeTo, pCmd->value, pCmd->mask,
+                                        repeatedStart);
+        }
+        else
+        {
+            /*! Fetch the current contents once for all masked entries in the run, then merge.*/
+            status = ARM_DRIVER_OK;
+            if (readBack)
+            {
+                status = Register_I2C_ReadCached(pCommDrv, devInfo, slaveAddress, pCmd->writeTo, runLength, buffer);
+            }
+            if (ARM_DRIVER_OK == status)
+            {
+                for (i = 0; i < runLength; i++)
+                {
+                    buffer[i] = pCmd[i].mask ? ((buffer[i] & ~pCmd[i].mask) | pCmd[i].value) : pCmd[i].value;
+                }
+                status = Register_I2C_BlockWrite(pCommDrv, devInfo, slaveAddress, pCmd->writeTo, buffer, runLength);
+            }
+        }
         if (ARM_DRIVER_OK != status)
         {
             return SENSOR_ERROR_WRITE;
         }
-        ++pCmd;
+        pCmd += runLength;
     } while (repeatedStart);
 
     return SENSOR_ERROR_NONE;
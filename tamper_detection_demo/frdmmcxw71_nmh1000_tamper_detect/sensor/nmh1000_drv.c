@@ -39,6 +39,7 @@ int32_t NMH1000_I2C_Initialize(
     pSensorHandle->deviceInfo.deviceInstance = index;
     pSensorHandle->deviceInfo.functionParam = NULL;
     pSensorHandle->deviceInfo.idleFunction = NULL;
+    pSensorHandle->deviceInfo.pCache = NULL;
 
     /*!  Read and store the device's WHO_AM_I.*/
     status = Register_I2C_Read(pBus, &pSensorHandle->deviceInfo, sAddress, NMH1000_WHO_AM_I, 1, &reg);
@@ -118,6 +119,38 @@ int32_t NMH1000_I2C_ReadData(nmh1000_i2c_sensorhandle_t *pSensorHandle,
     return SENSOR_ERROR_NONE;
 }
 
+int32_t NMH1000_I2C_ReadDataAsync(nmh1000_i2c_sensorhandle_t *pSensorHandle,
+                                  registerasyncxfer_t *pXfer,
+                                  const registerreadlist_t *pReadList,
+                                  uint8_t *pBuffer,
+                                  registerasynccallback_t callback,
+                                  void *userParam)
+{
+    int32_t status;
+
+    /*! Validate for the correct handle and register read list.*/
+    if ((pSensorHandle == NULL) || (pXfer == NULL) || (pReadList == NULL) || (pBuffer == NULL))
+    {
+        return SENSOR_ERROR_INVALID_PARAM;
+    }
+
+    /*! Check whether sensor handle is initialized before reading sensor data.*/
+    if (pSensorHandle->isInitialized != true)
+    {
+        return SENSOR_ERROR_INIT;
+    }
+
+    /*! Queue the read list, the callback reports the outcome. */
+    status = Register_I2C_ReadAsync(pSensorHandle->pCommDrv, &pSensorHandle->deviceInfo, pSensorHandle->slaveAddress,
+                                    pXfer, pReadList, pBuffer, callback, userParam);
+    if (ARM_DRIVER_OK != status)
+    {
+        return SENSOR_ERROR_READ;
+    }
+
+    return SENSOR_ERROR_NONE;
+}
+
 int32_t NMH1000_I2C_DeInit(nmh1000_i2c_sensorhandle_t *pSensorHandle)
 {
     int32_t status;
@@ -142,8 +175,9 @@ int32_t NMH1000_I2C_DeInit(nmh1000_i2c_sensorhandle_t *pSensorHandle)
     }
     else
     {
-        /*! De-initialize sensor handle. */
+        /*! De-initialize sensor handle, the reset returned every register to its default. */
         pSensorHandle->isInitialized = false;
+        Register_I2C_InvalidateCache(&pSensorHandle->deviceInfo, 0, SENSOR_MAX_REGISTER_COUNT);
     }
 
     return SENSOR_ERROR_NONE;
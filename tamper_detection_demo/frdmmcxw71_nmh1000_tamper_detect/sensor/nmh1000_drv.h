@@ -98,6 +98,27 @@ int32_t NMH1000_I2C_ReadData(nmh1000_i2c_sensorhandle_t *pSensorHandle,
                             const registerreadlist_t *pReadList,
                             uint8_t *pBuffer);
 
+/*! @brief       The interface function to read the sensor data without blocking.
+ *  @details     This function queues the reads of the register list on the I2C bus and returns immediately.
+ *               The callback runs from the I2C interrupt once pBuffer holds the data or the read failed.
+ *  @param[in]   pSensorHandle  handle to the sensor.
+ *  @param[in]   pXfer          transfer descriptor, owned by the caller until the callback has run.
+ *  @param[in]   pReadList      pointer to the list of device registers and values to read.
+ *  @param[out]  pBuffer        buffer which holds raw sensor data.
+ *  @param[in]   callback       completion callback, receives ARM_DRIVER_OK or an ARM_DRIVER_ERROR code.
+ *  @param[in]   userParam      parameter passed to the callback.
+ *  @constraints This can be called only after NMH1000_I2C_Initialize().
+ *               The blocking APIs must not be used while the transfer is pending.
+ *  @reeentrant  Yes
+ *  @return      ::NMH1000_I2C_ReadDataAsync() returns the status .
+ */
+int32_t NMH1000_I2C_ReadDataAsync(nmh1000_i2c_sensorhandle_t *pSensorHandle,
+                                  registerasyncxfer_t *pXfer,
+                                  const registerreadlist_t *pReadList,
+                                  uint8_t *pBuffer,
+                                  registerasynccallback_t callback,
+                                  void *userParam);
+
 /*! @brief       The interface function to De Initialize sensor..
  *  @details     This function made sensor in a power safe state and de initialize its handle.
  *  @param[in]   pSensorHandle      handle to the sensor.
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file nmh1000_fsm.c
+ * @brief The nmh1000_fsm.c file implements the magnetic tamper state machine.
+ */
+
+#include "nmh1000_fsm.h"
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+void NMH1000_Fsm_Init(nmh1000fsm_t *pFsm)
+{
+    pFsm->state = mNmh1000State_Startup_c;
+}
+
+uint8_t NMH1000_Fsm_Dispatch(nmh1000fsm_t *pFsm, nmh1000Event_t event)
+{
+    uint8_t actions = NMH1000_FSM_ACTION_NONE;
+
+    switch (pFsm->state)
+    {
+        case mNmh1000State_Startup_c:
+            /*! A field at start up is not reported, the asset has not been declared safe yet. */
+            if (mNmh1000Evt_FieldPresent_c == event)
+            {
+                pFsm->state = mNmh1000State_Tamper_c;
+            }
+            else if (mNmh1000Evt_FieldAbsent_c == event)
+            {
+                pFsm->state = mNmh1000State_Settling_c;
+                actions = NMH1000_FSM_ACTION_CLEAR | NMH1000_FSM_ACTION_START_DEADLINE;
+            }
+            break;
+
+        case mNmh1000State_Safe_c:
+            if (mNmh1000Evt_FieldPresent_c == event)
+            {
+                pFsm->state = mNmh1000State_Tamper_c;
+                actions = NMH1000_FSM_ACTION_ALERT;
+            }
+            break;
+
+        case mNmh1000State_Tamper_c:
+            if (mNmh1000Evt_FieldAbsent_c == event)
+            {
+                pFsm->state = mNmh1000State_Settling_c;
+                actions = NMH1000_FSM_ACTION_CLEAR | NMH1000_FSM_ACTION_START_DEADLINE;
+            }
+            break;
+
+        case mNmh1000State_Settling_c:
+            /*! The field came back before the deadline, the tamper is still the same one. */
+            if (mNmh1000Evt_FieldPresent_c == event)
+            {
+                pFsm->state = mNmh1000State_Tamper_c;
+                actions = NMH1000_FSM_ACTION_STOP_DEADLINE;
+            }
+            else if (mNmh1000Evt_Deadline_c == event)
+            {
+                pFsm->state = mNmh1000State_Safe_c;
+                actions = NMH1000_FSM_ACTION_SAFE;
+            }
+            break;
+
+        default:
+            pFsm->state = mNmh1000State_Startup_c;
+            break;
+    }
+
+    return actions;
+}
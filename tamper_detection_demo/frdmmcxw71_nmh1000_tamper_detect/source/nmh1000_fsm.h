@@ -0,0 +1,72 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file nmh1000_fsm.h
+ * @brief The nmh1000_fsm.h file declares the magnetic tamper state machine. It has no platform dependency,
+ *        the caller feeds it field and deadline events and carries out the returned actions.
+ */
+
+#ifndef NMH1000_FSM_H_
+#define NMH1000_FSM_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/*! @brief Actions returned by NMH1000_Fsm_Dispatch(), any combination may be set. */
+#define NMH1000_FSM_ACTION_NONE           (0x00U)
+#define NMH1000_FSM_ACTION_ALERT          (0x01U) /*!< Report the magnetic tampering. */
+#define NMH1000_FSM_ACTION_CLEAR          (0x02U) /*!< The field is gone, turn the alert indication off. */
+#define NMH1000_FSM_ACTION_SAFE           (0x04U) /*!< Report that the asset is safe. */
+#define NMH1000_FSM_ACTION_START_DEADLINE (0x08U) /*!< (Re)start the settle deadline. */
+#define NMH1000_FSM_ACTION_STOP_DEADLINE  (0x10U) /*!< Cancel the settle deadline. */
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief States of the magnetic tamper detection. */
+typedef enum nmh1000State_tag
+{
+    mNmh1000State_Startup_c,  /*!< No quiet period seen yet. */
+    mNmh1000State_Safe_c,     /*!< Asset reported safe, the next field is a tamper. */
+    mNmh1000State_Tamper_c,   /*!< Field present. */
+    mNmh1000State_Settling_c, /*!< Field gone, waiting for the deadline before reporting safe. */
+} nmh1000State_t;
+
+/*! @brief Events fed to the state machine. */
+typedef enum nmh1000Event_tag
+{
+    mNmh1000Evt_FieldPresent_c, /*!< Sample or OUT pin above the threshold. */
+    mNmh1000Evt_FieldAbsent_c,  /*!< Sample or OUT pin below the threshold. */
+    mNmh1000Evt_Deadline_c,     /*!< The settle deadline expired. */
+} nmh1000Event_t;
+
+/*! @brief State machine instance. */
+typedef struct
+{
+    nmh1000State_t state; /*!< Current state. */
+} nmh1000fsm_t;
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+/*! @brief       Puts the state machine in its start up state.
+ *  @param[in]   pFsm  state machine to initialize.
+ */
+void NMH1000_Fsm_Init(nmh1000fsm_t *pFsm);
+
+/*! @brief       Runs one event through the state machine.
+ *  @details     Events which do not apply to the current state are ignored, so the caller may feed every
+ *               sample and a deadline which raced with a cancel.
+ *  @param[in]   pFsm   state machine.
+ *  @param[in]   event  event to process.
+ *  @return      NMH1000_FSM_ACTION_ flags the caller has to carry out, in the order listed.
+ */
+uint8_t NMH1000_Fsm_Dispatch(nmh1000fsm_t *pFsm, nmh1000Event_t event);
+
+#endif /* NMH1000_FSM_H_ */
@@ -20,6 +20,15 @@
 #include "issdk_hal.h"
 #include "gpio_driver.h"
 #include "nmh1000_drv.h"
+#include "sensor_engine.h"
+#include "baseline_tracker.h"
+#include "poll_scheduler.h"
+#include "capture_ring.h"
+#include "nmh1000_fsm.h"
+#include "sensor_registry.h"
+#include "tamper_event.h"
+#include "tx_queue.h"
+#include "tamper_beacon.h"
 #include "systick_utils.h"
 
 //-----------------------------------------------------------------------
@@ -33,6 +42,121 @@
 #define NMH1000_DATA_SIZE (1) /* 1 byte Mag Data. */
 #define NMH1000_NUM_REGISTERS (NMH1000_I2C_ADDR + 1)
 #define THRESHOLD 50
+/*! @brief Time constant of the drift tracking baseline, 2^x samples (256 samples, about 25 seconds). */
+#define NMH1000_BASELINE_SHIFT  8U
+/*! @brief A deviation must also exceed this many standard deviations of the recent samples to raise an alert. */
+#define NMH1000_BASELINE_GATE   4U
+
+/*! @brief Time the field must stay away before the asset is reported safe again. */
+#define NMH1000_SAFE_DELAY_MS   3000U
+
+/*! @brief OUT_M poll interval bounds and back-off, see poll_scheduler.h. The interval stretches by 1/2^GROW_SHIFT
+ *         per quiet poll once QUIET_POLLS quiet polls have been seen, and drops back to MIN_MS on any activity. */
+#ifndef NMH1000_POLL_MIN_MS
+#define NMH1000_POLL_MIN_MS       100U
+#endif
+#ifndef NMH1000_POLL_MAX_MS
+#define NMH1000_POLL_MAX_MS       2000U
+#endif
+#ifndef NMH1000_POLL_GROW_SHIFT
+#define NMH1000_POLL_GROW_SHIFT   1U
+#endif
+#ifndef NMH1000_POLL_QUIET_POLLS
+#define NMH1000_POLL_QUIET_POLLS  50U
+#endif
+
+/*! @brief Take the field events from the OUT pin, the sensor compares against THRESHOLD itself.
+ *         When enabled, the periodic timer only samples the pin level as a slow watchdog. */
+#ifndef NMH1000_OUT_IRQ_MODE
+#define NMH1000_OUT_IRQ_MODE    0
+#endif
+
+/*! @brief Assert and clear level of the OUT pin in NMH1000_OUT_IRQ_MODE. The threshold registers take $01 to $1F,
+ *         the top of the OUT_M range, a larger THRESHOLD is capped there. */
+#define NMH1000_OUT_THRESHOLD   ((THRESHOLD > 0x1F) ? 0x1F : THRESHOLD)
+
+/*! @brief Keep a ring of the latest OUT_M samples and send the samples around each alert to the peers.
+ *         The ring takes CAPTURE_RING_BUDGET(NMH1000_SNAPSHOT_SAMPLES) bytes of static RAM, reserved at build time.
+ *         The samples come from the OUT_M poll, the mode needs NMH1000_OUT_IRQ_MODE disabled. */
+#ifndef NMH1000_SNAPSHOT_MODE
+#define NMH1000_SNAPSHOT_MODE     0
+#endif
+
+/*! @brief Ring size in samples (a power of two), and the samples sent before and after the alert. */
+#ifndef NMH1000_SNAPSHOT_SAMPLES
+#define NMH1000_SNAPSHOT_SAMPLES  64U
+#endif
+#if (NMH1000_SNAPSHOT_SAMPLES == 0U) || ((NMH1000_SNAPSHOT_SAMPLES & (NMH1000_SNAPSHOT_SAMPLES - 1U)) != 0U)
+#error "NMH1000_SNAPSHOT_SAMPLES must be a power of two"
+#endif
+#ifndef NMH1000_SNAPSHOT_PRE
+#define NMH1000_SNAPSHOT_PRE      32U
+#endif
+#ifndef NMH1000_SNAPSHOT_POST
+#define NMH1000_SNAPSHOT_POST     16U
+#endif
+
+#if (NMH1000_SNAPSHOT_MODE == 1) && (NMH1000_OUT_IRQ_MODE != 0)
+#error "NMH1000_SNAPSHOT_MODE records the polled OUT_M samples, disable NMH1000_OUT_IRQ_MODE"
+#endif
+
+/*! @brief Send the alerts as the text banners of a terminal instead of the binary event records, for debugging.
+ *         A text alert takes three 70 byte writes, a binary record one write of 9 bytes. */
+#ifndef NMH1000_ASCII_ALERT_MODE
+#define NMH1000_ASCII_ALERT_MODE    0
+#endif
+
+/*! @brief Batch window of the event records, ms. The records raised within the window go out back to back in one
+ *         write, an alert flushes the batch at once. 0 sends every record on its own. */
+#ifndef NMH1000_EVENT_BATCH_MS
+#define NMH1000_EVENT_BATCH_MS      20U
+#endif
+
+/*! @brief Broadcast the latest event record as a tamper beacon, in a non-connectable extended advertising set next
+ *         to the connectable one, so a gateway gets the alerts without connecting. The sensor starts with the
+ *         beacon instead of waiting for a peer. */
+#ifndef NMH1000_BROADCAST_MODE
+#define NMH1000_BROADCAST_MODE       0
+#endif
+
+/*! @brief Advertising interval of the beacon during the burst after an event, ms, 20 at least. */
+#ifndef NMH1000_BROADCAST_FAST_MS
+#define NMH1000_BROADCAST_FAST_MS    20U
+#endif
+
+/*! @brief Length of the burst after an event, ms. */
+#ifndef NMH1000_BROADCAST_BURST_MS
+#define NMH1000_BROADCAST_BURST_MS   3000U
+#endif
+
+/*! @brief Advertising interval of the beacon between the bursts, ms. */
+#ifndef NMH1000_BROADCAST_SLOW_MS
+#define NMH1000_BROADCAST_SLOW_MS    2000U
+#endif
+
+/*! @brief AES-128 key of the beacon MIC, shared with the gateways. There is no default, each deployment sets its
+ *         own, e.g. -DNMH1000_BROADCAST_KEY="{0x..U, ...}" with 16 bytes. */
+#if (NMH1000_BROADCAST_MODE == 1) && !defined(NMH1000_BROADCAST_KEY)
+#error "NMH1000_BROADCAST_MODE needs the key shared with the gateways, define NMH1000_BROADCAST_KEY"
+#endif
+
+/*! @brief Beacon counter values reserved in NVM at a time. After a reset the counter goes on from the end of the
+ *         reserved values, so a gateway never sees one twice, for one NVM write per window. */
+#ifndef NMH1000_BROADCAST_COUNTER_WINDOW
+#define NMH1000_BROADCAST_COUNTER_WINDOW 1024U
+#endif
+
+/*! @brief NVM data set of the beacon counter. */
+#define NMH1000_BROADCAST_NVM_ID     0x4031
+
+#if (NMH1000_BROADCAST_MODE == 1) && !(defined(gAppUseNvm_d) && (gAppUseNvm_d > 0))
+#error "NMH1000_BROADCAST_MODE keeps the beacon counter in NVM, enable gAppUseNvm_d"
+#endif
+
+#if (NMH1000_BROADCAST_MODE == 1) && (NMH1000_ASCII_ALERT_MODE == 1)
+#error "NMH1000_BROADCAST_MODE advertises the binary event records, disable NMH1000_ASCII_ALERT_MODE"
+#endif
+
 //-----------------------------------------------------------------------
 // Constants
 //-----------------------------------------------------------------------
@@ -41,6 +165,12 @@
 /*! @brief Register settings for Normal Mode. */
 const registerwritelist_t cNmh1000ConfigNormal[] = {
     {NMH1000_ODR, NMH1000_USER_ODR_ODR_10X_HSP, NMH1000_USER_ODR_ODR_MASK},
+#if (NMH1000_OUT_IRQ_MODE == 1)
+    /* OUT is driven high while the field is above NMH1000_OUT_THRESHOLD. */
+    {NMH1000_USER_ASSERT_THRESH, NMH1000_OUT_THRESHOLD, 0},
+    {NMH1000_USER_CLEAR_THRESH, NMH1000_OUT_THRESHOLD, 0},
+    {NMH1000_CONTROL_REG1, NMH1000_CONTROL_REG1_V_POL_ASSERT_VOH_CLR_VOL, NMH1000_CONTROL_REG1_V_POL_MASK},
+#endif
     {NMH1000_CONTROL_REG1, NMH1000_CONTROL_REG1_AUTO_MODE_START, NMH1000_CONTROL_REG1_AUTO_MODE_MASK},
     __END_WRITE_DATA__};
 
@@ -48,6 +178,19 @@ const registerwritelist_t cNmh1000ConfigNormal[] = {
 const registerreadlist_t cNmh1000OutputNormal[] = {{.readFrom = NMH1000_OUT_M_REG, .numBytes = NMH1000_DATA_SIZE},
                                                  __END_READ_DATA__};
 
+/*! @brief WHO_AM_I values of the parts served by the NMH1000 driver, the keys of cNmh1000Variants. */
+const uint8_t cNmh1000WhoAmI[] = {NMH1000_WHO_AM_I_VALUE};
+
+/*! @brief Variants served by the NMH1000 driver. The output rate is set in USER_ODR classes, not in Hz. */
+const sensorvariant_t cNmh1000Variants[] = {
+    {cNmh1000WhoAmI, sizeof(cNmh1000WhoAmI), SENSOR_FAMILY_MAG, 1000U, SENSOR_CAP_WINDOW, 0U, 0U, 0U, "NMH1000",
+     cNmh1000ConfigNormal},
+};
+
+/*! @brief Back-off policy of the OUT_M poll. */
+const pollschedconfig_t cNmh1000PollConfig = {NMH1000_POLL_MIN_MS, NMH1000_POLL_MAX_MS, NMH1000_POLL_GROW_SHIFT,
+                                              NMH1000_POLL_QUIET_POLLS};
+
 
 //-----------------------------------------------------------------------
 // Global Variables
@@ -55,6 +198,15 @@ const registerreadlist_t cNmh1000OutputNormal[] = {{.readFrom = NMH1000_OUT_M_RE
 
     ARM_DRIVER_I2C *I2Cdrv = &I2C_S_DRIVER;
     nmh1000_i2c_sensorhandle_t nmh1000Driver;
+    /* Variant found at init, NULL until a known part answered. */
+    const sensorvariant_t *pNmh1000Variant = NULL;
+    /* WHO_AM_I of the part that answered. */
+    uint8_t nmh1000WhoAmI = 0U;
+    /* Shadow copy of the NMH1000 registers, saves the read-back of masked writes. */
+    registercache_t nmh1000RegCache;
+    /* Sensors of the shared I2C bus, serviced by the sensor engine. */
+    sensorengine_t nmh1000Engine;
+    sensorengineslot_t nmh1000Slot;
     /* Define the init structure for the output LED pin*/
     gpio_pin_config_t led_config = {
         kGPIO_DigitalOutput,
@@ -25,6 +25,7 @@
 #include "fsl_component_button.h"
 #include "fsl_component_led.h"
 #include "fsl_component_timer_manager.h"
+#include "fsl_adapter_gpio.h"
 #include "fsl_component_panic.h"
 #include "fsl_component_serial_manager.h"
 #include "fsl_component_mem_manager.h"
@@ -74,6 +75,13 @@
 #include "app.h"
 
 #include <nmh1000_mag_wakeup.h>
+#if (NMH1000_BROADCAST_MODE == 1)
+#include "SecLib.h"
+#include "NVM_Interface.h"
+#endif
+#if (defined(RTE_I2C1_DMA_EN) && RTE_I2C1_DMA_EN)
+#include "fsl_edma.h"
+#endif
 
 /************************************************************************************
  *************************************************************************************
@@ -85,7 +93,17 @@
 
 #define mAppUartFlushIntervalInMs_c     (7)     /* Flush Timeout in Ms */
 
-#define mnmh1000IntervalInMs_c     (100)     /* Flush Timeout in Ms */
+#define mAppTxRetryIntervalInMs_c       (20)    /* TX queue retry interval in Ms */
+#define mAppTxAlertReserve_c            (1U)    /* TX queue entries a snapshot leaves free for an alert */
+#if (NMH1000_BROADCAST_MODE == 1)
+#if (gWuart_PeripheralRole_c == 0)
+#error "NMH1000_BROADCAST_MODE advertises the tamper beacon, enable gWuart_PeripheralRole_c"
+#endif
+#define mAppBeaconHandle_c              (1U)    /* Advertising set of the tamper beacon, set 0 is the connectable one */
+#define mAppAdvInterval(ms)             (((ms) * 8U) / 5U) /* ms to 0.625 ms */
+#endif
+
+#define mnmh1000WatchdogIntervalInMs_c     (10000)     /* OUT pin level check in Ms */
 
 #define mBatteryLevelReportInterval_c   (10)    /* battery level report interval in seconds  */
 
@@ -123,7 +141,8 @@ typedef enum appEvent_tag
     mAppEvt_ServiceDiscoveryNotFound_c,
     mAppEvt_ServiceDiscoveryFailed_c,
     mAppEvt_GattProcComplete_c,
-    mAppEvt_GattProcError_c
+    mAppEvt_GattProcError_c,
+    mAppEvt_TamperNotifyEnabled_c
 } appEvent_t;
 
 typedef enum appState_tag
@@ -132,7 +151,8 @@ typedef enum appState_tag
     mAppExchangeMtu_c,
     mAppServiceDisc_c,
     mAppServiceDiscRetry_c,
-    mAppRunning_c
+    mAppRunning_c,
+    mAppTamperNotify_c
 } appState_t;
 
 typedef struct appPeerInfo_tag
@@ -171,12 +191,41 @@ static void BleApp_GattClientCallback(deviceId_t serverDeviceId, gattProcedureTy
 static void BleApp_ServiceDiscoveryCallback(deviceId_t peerDeviceId, servDiscEvent_t *pEvent);
 static void BleApp_StateMachineHandler(deviceId_t peerDeviceId, appEvent_t event);
 static void BleApp_StoreServiceHandles(deviceId_t peerDeviceId, gattService_t *pService);
+static bool_t BleApp_TamperNotifyEnabled(deviceId_t peerDeviceId);
+static void BleApp_StartTamperNotify(deviceId_t peerDeviceId);
+static bool_t BleApp_PeerTakesTx(uint8_t mPeerId, txClass_t cls);
+static bool_t BleApp_QueueTx(uint8_t *pData, uint32_t dataSize, txClass_t cls);
+#if (NMH1000_SNAPSHOT_MODE == 1)
+static uint8_t BleApp_TxRoom(txClass_t cls);
+#endif
+static bleResult_t BleApp_TransmitTxEntry(deviceId_t peerDeviceId, const txentry_t *pEntry, bool_t *pConfirm);
+static void BleApp_ServiceTxQueue(deviceId_t peerDeviceId);
+static void BleApp_ServiceTxQueues(void *pParam);
+static void BleApp_TxConfirmed(deviceId_t peerDeviceId, bool_t success);
+static void BleApp_TxDrained(void);
+#if (NMH1000_ASCII_ALERT_MODE == 0)
+static void BleApp_SendTamperEvent(uint8_t *pRecord, uint32_t recordSize);
+#if (NMH1000_EVENT_BATCH_MS > 0U)
+static uint16_t BleApp_TamperBatchLimit(void);
+static void BleApp_QueueTamperEvent(uint8_t *pRecord, uint32_t recordSize, bool_t urgent);
+static void BleApp_FlushTamperBatch(void *pParam);
+static void TamperBatchTimerCallback(void *pParam);
+#endif
+#endif
+#if (NMH1000_BROADCAST_MODE == 1)
+static void BleApp_StartBeacon(void);
+static void BleApp_UpdateBeacon(const uint8_t *pRecord, uint32_t recordSize);
+static bool_t BleApp_ReserveBeaconCounter(void);
+static void BleApp_RestartBeacon(bool_t burst);
+static void BleApp_SetupBeacon(void);
+#endif
 
 /* Timer Callbacks */
 #if gWuart_CentralRole_c == 1
 static void ScanningTimerCallback(void *pParam);
 #endif /* gWuart_CentralRole_c */
 static void UartStreamFlushTimerCallback(void *pData);
+static void TxRetryTimerCallback(void *pParam);
 static void BatteryMeasurementTimerCallback(void *pParam);
 #if (defined(gAppButtonCnt_c) && (gAppButtonCnt_c == 1))
 static void SwitchPressTimerCallback(void *pParam);
@@ -188,6 +237,9 @@ static void Uart_TxCallBack(void *pBuffer, serial_manager_callback_message_t *pM
 
 static void BleApp_FlushUartStream(void *pParam);
 static void BleApp_ReceivedUartStream(deviceId_t peerDeviceId, uint8_t *pStream, uint16_t streamLength);
+#if (REGISTER_I2C_PROFILE == 1)
+static void BleApp_SendBusProfile(void);
+#endif
 
 #if defined(gUseControllerNotifications_c) && (gUseControllerNotifications_c)
 static void BleApp_HandleControllerNotification(bleNotificationEvent_t *pNotificationEvent);
@@ -216,7 +268,30 @@ int nmh1000_int_BLE(void);
 int nmh1000_event_BLE(void);
 void nmh1000_CallBack();
 void nmh1000_TimerCallback();
-void insert_delay(void);
+static void nmh1000_set_field(bool_t present);
+static void nmh1000_fsm_post(nmh1000Event_t event);
+static void nmh1000_FsmHandler(void *pParam);
+static void nmh1000_DeadlineCallback(void *pParam);
+static int32_t nmh1000_engine_init(sensorengineslot_t *pSlot);
+static int32_t nmh1000_engine_configure(sensorengineslot_t *pSlot);
+#if (NMH1000_OUT_IRQ_MODE == 0)
+static void nmh1000_engine_decode(sensorengineslot_t *pSlot);
+static void nmh1000_PollDone(void *pParam);
+static void nmh1000_PollHandler(void *pParam);
+#endif
+#if (NMH1000_OUT_IRQ_MODE == 1)
+static int nmh1000_irq_init(void);
+static void nmh1000_OutCallback(void *pParam);
+#endif
+#if (NMH1000_ASCII_ALERT_MODE == 0)
+static void nmh1000_send_event(uint8_t type, uint8_t severity);
+#endif
+#if (NMH1000_SNAPSHOT_MODE == 1)
+static void nmh1000_snapshot_init(void);
+static void nmh1000_snapshot_push(uint32_t timestamp, int32_t v0, int32_t v1, int32_t v2);
+static void nmh1000_snapshot_trigger(void);
+static void nmh1000_SnapshotSendHandler(void *pParam);
+#endif
 
 /************************************************************************************
  *************************************************************************************
@@ -236,6 +311,10 @@ static bool_t mScanningOn = FALSE;
 
 static uint16_t mCharMonitoredHandles[1] = { (uint16_t)value_uart_stream };
 
+/* Transmit queue of each peer */
+static txqueue_t maTxQueue[gAppMaxConnections_c];
+static bool_t mTxRetryPending = FALSE;
+
 /* Service Data*/
 static wusConfig_t mWuServiceConfig;
 static bool_t      mBasValidClientList[gAppMaxConnections_c] = {FALSE};
@@ -243,8 +322,43 @@ static basConfig_t mBasServiceConfig = {(uint16_t)service_battery, 0, mBasValidC
 
 static TIMER_MANAGER_HANDLE_DEFINE(mAppTimerId);
 static TIMER_MANAGER_HANDLE_DEFINE(mUartStreamFlushTimerId);
+static TIMER_MANAGER_HANDLE_DEFINE(mTxRetryTimerId);
+#if (NMH1000_ASCII_ALERT_MODE == 0) && (NMH1000_EVENT_BATCH_MS > 0U)
+static TIMER_MANAGER_HANDLE_DEFINE(mTamperBatchTimerId);
+#endif
 static TIMER_MANAGER_HANDLE_DEFINE(mBatteryMeasurementTimerId);
 static TIMER_MANAGER_HANDLE_DEFINE(mNmh1000Id);
+/* Ambient field the samples are compared against, follows slow drift */
+static baselinetracker_t mNmh1000Baseline;
+#if (NMH1000_OUT_IRQ_MODE == 0)
+/* OUT_M poll interval, stretched while no field is around */
+static pollsched_t mNmh1000Poll;
+#endif
+#if (NMH1000_ASCII_ALERT_MODE == 0)
+/* Counter of the event records, a gap tells the peer an event was lost */
+static uint8_t mNmh1000EventSeq = 0U;
+#if (NMH1000_EVENT_BATCH_MS > 0U)
+/* Event records waiting for the end of the batch window */
+static tamperbatch_t mTamperBatch;
+static bool_t mTamperBatchPending = FALSE;
+#endif
+#endif
+#if (NMH1000_SNAPSHOT_MODE == 1)
+/* Samples around the last alert, the storage is reserved at build time so it shows in the map file */
+static capturering_t mNmh1000Snapshot;
+static capturesample_t mNmh1000SnapshotStorage[NMH1000_SNAPSHOT_SAMPLES];
+static bool_t mNmh1000SnapshotSendPending = FALSE;
+#endif
+/* Settle time before reporting safe, replaces the former busy loop */
+static TIMER_MANAGER_HANDLE_DEFINE(mNmh1000DeadlineId);
+static nmh1000fsm_t mNmh1000Fsm;
+/* Last field state handed to the state machine, only changes are posted */
+static bool_t mNmh1000Field = FALSE;
+static bool_t mNmh1000FieldValid = FALSE;
+#if (NMH1000_OUT_IRQ_MODE == 1)
+static GPIO_HANDLE_DEFINE(mNmh1000OutHandle);
+static bool_t mNmh1000IrqReady = FALSE;
+#endif
 
 /* If the board has only one button, multiplex the required functionalities on it using an application timer */
 #if (gAppButtonCnt_c == 1)
@@ -282,6 +396,63 @@ static appAdvertisingParams_t mAppAdvParams = {
 };
 #endif
 
+#if (NMH1000_BROADCAST_MODE == 1)
+/* Tamper beacon, non-connectable and non-scannable */
+static gapExtAdvertisingParameters_t mBeaconAdvParams = {
+    /* SID */                       mAppBeaconHandle_c,
+    /* handle */                    mAppBeaconHandle_c,
+    /* minInterval */               mAppAdvInterval(NMH1000_BROADCAST_SLOW_MS),
+    /* maxInterval */               mAppAdvInterval(NMH1000_BROADCAST_SLOW_MS),
+    /* ownAddressType */            gBleAddrTypePublic_c,
+    /* ownRandomAddr */             {0, 0, 0, 0, 0, 0},
+    /* peerAddressType */           gBleAddrTypePublic_c,
+    /* peerAddress */               {0, 0, 0, 0, 0, 0},
+    /* channelMap */                (gapAdvertisingChannelMapFlags_t)gGapAdvertisingChannelMapDefault_c,
+    /* filterPolicy */              gProcessAll_c,
+    /* extAdvProperties */          0U,
+    /* txPower */                   gBleAdvTxPowerNoPreference_c,
+    /* primaryPHY */                gLePhy1M_c,
+    /* secondaryPHY */              gLePhy1M_c,
+    /* secondaryAdvMaxSkip */       0U,
+    /* enableScanReqNotification */ FALSE
+};
+
+static uint8_t maBeaconData[TAMPER_BEACON_MAX_SIZE];
+
+static gapAdStructure_t maBeaconAdStruct[1] = {
+  {
+    .length = TAMPER_BEACON_HEADER_SIZE + TAMPER_BEACON_MIC_SIZE + 1U,
+    .adType = gAdManufacturerSpecificData_c,
+    .aData = maBeaconData
+  }
+};
+
+static gapAdvertisingData_t mBeaconAdvData = {
+    NumberOfElements(maBeaconAdStruct),
+    maBeaconAdStruct
+};
+
+static appExtAdvertisingParams_t mAppBeaconParams = {
+    .pGapExtAdvParams = &mBeaconAdvParams,
+    .pGapAdvData = &mBeaconAdvData,
+    .pScanResponseData = NULL,
+    .handle = mAppBeaconHandle_c,
+    .duration = gBleExtAdvNoDuration_c,
+    .maxExtAdvEvents = gBleExtAdvNoMaxEvents_c
+};
+
+static const uint8_t mBeaconKey[AES_128_KEY_BYTE_LEN] = NMH1000_BROADCAST_KEY;
+static uint32_t mBeaconCounter = 0U;
+/* End of the counter values reserved in NVM, a reset goes on from there */
+static uint32_t mBeaconCounterLimit = 0U;
+NVM_RegisterDataSet(&mBeaconCounterLimit, 1, sizeof(uint32_t), NMH1000_BROADCAST_NVM_ID, gNVM_MirroredInRam_c);
+static bool_t mBeaconStarted = FALSE;   /* The beacon and the sensor run */
+static bool_t mBeaconOn = FALSE;        /* The set is advertising */
+static bool_t mBeaconBusy = FALSE;      /* A start or a stop is in progress */
+static bool_t mBeaconPending = FALSE;   /* A restart waits for the one in progress */
+static bool_t mBeaconBurst = FALSE;     /* The next start is a burst */
+#endif
+
 uint8_t vec_init[70] = 			"\r\n ISSDK NMH1000 sensor example to detect magnetic wakeup event\r\n";
 uint8_t vec_i2c_init[70] = 		"\r\n I2C Initialization Failed\r\n";
 uint8_t vec_power_cont[70] =	"\r\n I2C Power Mode setting Failed\r\n";
@@ -289,7 +460,6 @@ uint8_t vec_mode_cont[70] =		"\r\n I2C Control Mode setting Failed\r\n";
 uint8_t vec_inint_sensor[70] =	"\r\n Sensor Initialization Failed\r\n";
 uint8_t vec_sensor_err[70] =	"\r\n Sensor Configuration Failed\r\n";
 
-uint8_t vec_init_success[70] =		"\r\n Successfully Initialized NMH1000 Mag Wake Sensor r\n";
 
 uint8_t vec_sensor_succ[70] =	"\r\n Successfully Applied NMH1000 Sensor Configuration\r\n";
 
@@ -300,11 +470,8 @@ uint8_t vec_mag_dec[70] =	"\r\n Magnetic Tampering Detected on your Asset";
 uint8_t vec_mag_end[70] =	"\r\n ===============!!ALERT!!==================\r\n";
 
 uint8_t vec_ASLP[70] =		"\r\n Your Asset is Safe\r\n";
-uint8_t sleeptowake = 0;
+uint8_t vec_snapshot[70] =	"\r\n Snapshot: time us, 3 x int32, 16 bytes per sample\r\n";
 uint8_t status_ble = 1;
-uint8_t waketosleep = 0;
-uint8_t firsttransition = 1;
-uint8_t onetime_modetransition = 1;
 /************************************************************************************
 *************************************************************************************
 * Public functions
@@ -339,14 +506,6 @@ void BluetoothLEHost_AppInit(void)
 * Private functions
 *************************************************************************************
 ************************************************************************************/
-void insert_delay(void)
-{
-	for (int i = 0; i < 100000; i++)
-	{
-		for (int j = 0; j <100000; j++);
-	}
-}
-
 #if (defined(gAppButtonCnt_c) && (gAppButtonCnt_c > 0))
 /*! *********************************************************************************
 * \brief        Handler for the first key.
@@ -619,6 +778,9 @@ static void BleApp_AdvertisingCallback
 #endif /* gAppLedCnt_c == 1 */
             Led1Flashing();
             Serial_Print("\n\rAdvertising...\n\r", gAllowToBlock_d);
+#if (NMH1000_BROADCAST_MODE == 1)
+            BleApp_StartBeacon();
+#endif
             }
             else
             {
@@ -636,6 +798,43 @@ static void BleApp_AdvertisingCallback
         }
         break;
 
+#if (NMH1000_BROADCAST_MODE == 1)
+        case gExtAdvertisingStateChanged_c:
+        {
+            if (mAppBeaconHandle_c == pAdvertisingEvent->eventData.advHandle)
+            {
+                mBeaconOn = !mBeaconOn;
+                if (mBeaconOn)
+                {
+                    mBeaconBusy = FALSE;
+                    if (mBeaconPending)
+                    {
+                        mBeaconPending = FALSE;
+                        BleApp_RestartBeacon(mBeaconBurst);
+                    }
+                }
+                else
+                {
+                    /* Stopped to change the interval, the start takes the latest content */
+                    mBeaconPending = FALSE;
+                    BleApp_SetupBeacon();
+                }
+            }
+        }
+        break;
+
+        case gAdvertisingSetTerminated_c:
+        {
+            if (mAppBeaconHandle_c == pAdvertisingEvent->eventData.advSetTerminated.handle)
+            {
+                /* The burst is over, back to slow beaconing */
+                mBeaconOn = FALSE;
+                BleApp_RestartBeacon(FALSE);
+            }
+        }
+        break;
+#endif
+
         default:
         {
             ; /* No action required */
@@ -758,6 +957,22 @@ static void BleApp_ConnectionCallback
             Serial_PrintDec(peerDeviceId);
             Serial_Print(".\n\r", gAllowToBlock_d);
 
+            /* Pending entries are lost with the link */
+            TxQueue_Reset(&maTxQueue[peerDeviceId]);
+            BleApp_TxDrained();
+            Serial_Print("TX drops alert/status/snapshot/debug ", gAllowToBlock_d);
+            Serial_PrintDec(maTxQueue[peerDeviceId].drops[mTxClass_Alert_c]);
+            Serial_Print("/", gAllowToBlock_d);
+            Serial_PrintDec(maTxQueue[peerDeviceId].drops[mTxClass_Status_c]);
+            Serial_Print("/", gAllowToBlock_d);
+            Serial_PrintDec(maTxQueue[peerDeviceId].drops[mTxClass_Snapshot_c]);
+            Serial_Print("/", gAllowToBlock_d);
+            Serial_PrintDec(maTxQueue[peerDeviceId].drops[mTxClass_Debug_c]);
+            Serial_Print(", retries ", gAllowToBlock_d);
+            Serial_PrintDec(maTxQueue[peerDeviceId].retries);
+            Serial_Print(".\n\r", gAllowToBlock_d);
+            TxQueue_Init(&maTxQueue[peerDeviceId]);
+
             maPeerInformation[peerDeviceId].appState = mAppIdle_c;
             maPeerInformation[peerDeviceId].clientInfo.hService = gGattDbInvalidHandleIndex_d;
             maPeerInformation[peerDeviceId].clientInfo.hUartStream = gGattDbInvalidHandleIndex_d;
@@ -928,6 +1143,12 @@ static void BleApp_GattClientCallback
     bleResult_t             error
 )
 {
+    /* A confirmed write of the TX queue completed */
+    if ((gGattProcWriteCharacteristicValue_c == procedureType) && (maTxQueue[serverDeviceId].busy))
+    {
+        BleApp_TxConfirmed(serverDeviceId, (gGattProcSuccess_c == procedureResult) ? TRUE : FALSE);
+    }
+
     switch (procedureResult)
     {
         case gGattProcError_c:
@@ -995,6 +1216,35 @@ static void BleApp_GattServerCallback
 
     switch (pServerEvent->eventType)
     {
+        case gEvtAttributeWritten_c:
+        {
+            if (pServerEvent->eventData.attributeWrittenEvent.handle == (uint16_t)value_uart_stream)
+            {
+                BleApp_ReceivedUartStream(deviceId, pServerEvent->eventData.attributeWrittenEvent.aValue,
+                                          pServerEvent->eventData.attributeWrittenEvent.cValueLength);
+                (void)GattServer_SendAttributeWrittenStatus(deviceId, (uint16_t)value_uart_stream,
+                                                            (uint8_t)gAttErrCodeNoError_c);
+            }
+
+            break;
+        }
+
+        case gEvtHandleValueConfirmation_c:
+        {
+            BleApp_TxConfirmed(deviceId, TRUE);
+            break;
+        }
+
+        case gEvtError_c:
+        {
+            if (pServerEvent->eventData.procedureError.procedureType == gSendIndication_c)
+            {
+                BleApp_TxConfirmed(deviceId, FALSE);
+            }
+
+            break;
+        }
+
         case gEvtAttributeWrittenWithoutResponse_c:
         {
             if (pServerEvent->eventData.attributeWrittenEvent.handle == (uint16_t)value_uart_stream)
@@ -1006,6 +1256,18 @@ static void BleApp_GattServerCallback
             break;
         }
 
+        case gEvtCharacteristicCccdWritten_c:
+        {
+            if ((pServerEvent->eventData.charCccdWrittenEvent.handle == (uint16_t)cccd_tamper_event) &&
+                (0U != ((uint8_t)pServerEvent->eventData.charCccdWrittenEvent.newCccd &
+                        ((uint8_t)gCccdNotification_c | (uint8_t)gCccdIndication_c))))
+            {
+                BleApp_StateMachineHandler(deviceId, mAppEvt_TamperNotifyEnabled_c);
+            }
+
+            break;
+        }
+
         case gEvtMtuChanged_c:
         {
             /* update stream length with minimum of  new MTU */
@@ -1089,7 +1351,7 @@ static bool_t BleApp_CheckScanEvent
 #endif /* gWuart_CentralRole_c == 1 */
 
 /*! *********************************************************************************
- * \brief        Send the received uart stream over GATT
+ * \brief        Send the received uart stream over GATT, as a status message.
  *
  * \param[in]    pData              Pointer to the received stream.
  * \param[in]    streamSize         The number of bytes in the stream.
@@ -1100,127 +1362,715 @@ static void BleApp_SendUartStream
     uint32_t streamSize
 )
 {
-    gattCharacteristic_t characteristic = {(uint8_t)gGattCharPropNone_c, {0}, 0, 0};
-    uint8_t              mPeerId = 0;
+    (void)BleApp_QueueTx(pRecvStream, streamSize, mTxClass_Status_c);
+}
+
+/*! *********************************************************************************
+ * \brief        Checks if a peer takes the data of a TX class.
+ *
+ * \details      Alerts go to the peers subscribed to the Tamper service and the
+ *               running peers, the other classes to the running peers only.
+ *
+ * \param[in]    mPeerId            The peer index.
+ * \param[in]    cls                txClass_t of the data.
+ *
+ * \return       TRUE if the data is queued for the peer.
+ ********************************************************************************** */
+static bool_t BleApp_PeerTakesTx
+(
+    uint8_t mPeerId,
+    txClass_t cls
+)
+{
+    return ((gInvalidDeviceId_c != maPeerInformation[mPeerId].deviceId) &&
+            ((mAppRunning_c == maPeerInformation[mPeerId].appState) ||
+             ((mTxClass_Alert_c == cls) && (TRUE == BleApp_TamperNotifyEnabled(mPeerId))))) ? TRUE : FALSE;
+}
+
+/*! *********************************************************************************
+ * \brief        Queues data for all peers which can take it and starts sending.
+ *
+ * \details      Data longer than a queue entry takes several entries, a peer
+ *               without room for all of them gets none, see TxQueue_PushMessage.
+ *
+ * \param[in]    pData              Pointer to the data.
+ * \param[in]    dataSize           The number of bytes in the data.
+ * \param[in]    cls                txClass_t of the data.
+ *
+ * \return       FALSE if a peer dropped the data.
+ ********************************************************************************** */
+static bool_t BleApp_QueueTx
+(
+    uint8_t *pData,
+    uint32_t dataSize,
+    txClass_t cls
+)
+{
+    bool_t   queued = TRUE;
+    uint8_t  mPeerId = 0;
 
-    /* send UART stream to all peers */
     for (mPeerId = 0; mPeerId < (uint8_t)gAppMaxConnections_c; mPeerId++)
     {
-        if (gInvalidDeviceId_c != maPeerInformation[mPeerId].deviceId &&
-            mAppRunning_c == maPeerInformation[mPeerId].appState)
+        if (TRUE == BleApp_PeerTakesTx(mPeerId, cls))
         {
-            characteristic.value.handle = maPeerInformation[mPeerId].clientInfo.hUartStream;
-            (void)GattClient_WriteCharacteristicValue(mPeerId, &characteristic,
-                    streamSize, pRecvStream, TRUE,
-                    FALSE, FALSE, NULL);
+            if (!TxQueue_PushMessage(&maTxQueue[mPeerId], (uint8_t)cls, pData, dataSize))
+            {
+                queued = FALSE;
+            }
+
+            /* A queue the host stack refused waits for the retry timer, so that
+               each retry interval costs its alert one attempt only */
+            if (!maTxQueue[mPeerId].held)
+            {
+                BleApp_ServiceTxQueue(mPeerId);
+            }
         }
     }
+
+    return queued;
 }
 
+#if (NMH1000_SNAPSHOT_MODE == 1)
 /*! *********************************************************************************
- * \brief        Handle the main application state machine
+ * \brief        Gets the entries of a TX class every peer taking it can queue.
+ *
+ * \param[in]    cls                txClass_t of the data.
+ *
+ * \return       The smallest room of the peers, TX_QUEUE_DEPTH without peers.
+ ********************************************************************************** */
+static uint8_t BleApp_TxRoom
+(
+    txClass_t cls
+)
+{
+    uint8_t  room = TX_QUEUE_DEPTH;
+    uint8_t  peerRoom;
+    uint8_t  mPeerId = 0;
+
+    for (mPeerId = 0; mPeerId < (uint8_t)gAppMaxConnections_c; mPeerId++)
+    {
+        if (TRUE == BleApp_PeerTakesTx(mPeerId, cls))
+        {
+            peerRoom = TxQueue_Room(&maTxQueue[mPeerId], (uint8_t)cls);
+            room = (peerRoom < room) ? peerRoom : room;
+        }
+    }
+
+    return room;
+}
+#endif
+
+/*! *********************************************************************************
+ * \brief        Sends one queue entry to a peer.
+ *
+ * \details      An alert goes out as an indication, or as a notification if the
+ *               peer only enabled those, to a peer subscribed to the Tamper
+ *               service, else as a write with response on its Wireless UART.
+ *               The other classes are written without response.
  *
  * \param[in]    peerDeviceId       The remote device ID.
- * \param[in]    event              The application event.
+ * \param[in]    pEntry             Pointer to the entry.
+ * \param[out]   pConfirm           TRUE if the peer will confirm the entry.
+ *
+ * \return       The result of the host stack call.
  ********************************************************************************** */
-static void BleApp_StateMachineHandler
+static bleResult_t BleApp_TransmitTxEntry
 (
     deviceId_t peerDeviceId,
-    appEvent_t event
+    const txentry_t *pEntry,
+    bool_t *pConfirm
 )
 {
-    uint16_t tempMtu = 0;
-    union
-    {
-        uint8_t     *pUuidArray;
-        bleUuid_t   *pUuidObj;
-    } temp; /* MISRA rule 11.3 */
+    gattCharacteristic_t characteristic = {(uint8_t)gGattCharPropNone_c, {0}, 0, 0};
+    bool_t               isIndActive = FALSE;
+    bleResult_t          result = gBleSuccess_c;
 
-    temp.pUuidArray = uuid_service_wireless_uart;
+    *pConfirm = FALSE;
 
-    /* invalid client information */
-    if (maPeerInformation[peerDeviceId].deviceId != gInvalidDeviceId_c)
+    if (((uint8_t)mTxClass_Alert_c == pEntry->cls) && (TRUE == BleApp_TamperNotifyEnabled(peerDeviceId)))
     {
-        switch (maPeerInformation[peerDeviceId].appState)
+        if ((gBleSuccess_c == Gap_CheckIndicationStatus(peerDeviceId, (uint16_t)cccd_tamper_event, &isIndActive)) &&
+            (TRUE == isIndActive))
         {
-        case mAppIdle_c:
-        {
-            if (event == mAppEvt_PeerConnected_c)
-            {
-                /* Let the central device initiate the Exchange MTU procedure*/
-                if (mGapRole == gGapCentral_c)
-                {
-                    /* Moving to Exchange MTU State */
-                    maPeerInformation[peerDeviceId].appState = mAppExchangeMtu_c;
-                    (void)GattClient_ExchangeMtu(peerDeviceId, gAttMaxMtu_c);
-                }
-                else
-                {
-                    /* Moving to Service Discovery State*/
-                    maPeerInformation[peerDeviceId].appState = mAppServiceDisc_c;
-
-                    /* Start Service Discovery*/
-                    (void)BleServDisc_FindService(peerDeviceId,
-                            gBleUuidType128_c,
-                            temp.pUuidObj);
-                }
-            }
+            result = GattServer_SendInstantValueIndication(peerDeviceId, (uint16_t)value_tamper_event,
+                                                           pEntry->length, pEntry->data);
+            *pConfirm = TRUE;
         }
-        break;
-
-        case mAppExchangeMtu_c:
+        else
         {
-            if (event == mAppEvt_GattProcComplete_c)
-            {
-                /* update stream length with minimum of maximum MTU's of connected devices */
-                (void)Gatt_GetMtu(peerDeviceId, &tempMtu);
-                tempMtu = gAttMaxWriteDataSize_d(tempMtu);
+            result = GattServer_SendInstantValueNotification(peerDeviceId, (uint16_t)value_tamper_event,
+                                                             pEntry->length, pEntry->data);
+        }
+    }
+    else if (mAppRunning_c == maPeerInformation[peerDeviceId].appState)
+    {
+        characteristic.value.handle = maPeerInformation[peerDeviceId].clientInfo.hUartStream;
+        *pConfirm = ((uint8_t)mTxClass_Alert_c == pEntry->cls) ? TRUE : FALSE;
+        result = GattClient_WriteCharacteristicValue(peerDeviceId, &characteristic,
+                pEntry->length, pEntry->data, (TRUE == *pConfirm) ? FALSE : TRUE,
+                FALSE, FALSE, NULL);
+    }
+    else
+    {
+        ; /* The peer cannot take it any more, the entry is consumed */
+    }
 
-                mAppUartBufferSize = mAppUartBufferSize <= tempMtu ? mAppUartBufferSize : tempMtu;
+    return result;
+}
 
-                /* Moving to Service Discovery State*/
-                maPeerInformation[peerDeviceId].appState = mAppServiceDisc_c;
+/*! *********************************************************************************
+ * \brief        Sends the queued entries of a peer, in priority order.
+ *
+ * \details      Stops at an entry waiting for a confirmation. When the host stack
+ *               refuses an entry, e.g. with gBleOverflow_c, the queue is held and
+ *               serviced again after mAppTxRetryIntervalInMs_c.
+ *
+ * \param[in]    peerDeviceId       The remote device ID.
+ ********************************************************************************** */
+static void BleApp_ServiceTxQueue
+(
+    deviceId_t peerDeviceId
+)
+{
+    txqueue_t       *pQueue = &maTxQueue[peerDeviceId];
+    const txentry_t *pEntry = NULL;
+    bool_t           confirm = FALSE;
 
-                /* Start Service Discovery*/
-                (void)BleServDisc_FindService(peerDeviceId,
-                        gBleUuidType128_c,
-                        temp.pUuidObj);
+    while ((!pQueue->busy) && (NULL != (pEntry = TxQueue_Head(pQueue))))
+    {
+        if (gBleSuccess_c == BleApp_TransmitTxEntry(peerDeviceId, pEntry, &confirm))
+        {
+            if (TRUE == confirm)
+            {
+                TxQueue_Wait(pQueue);
             }
             else
             {
-                if (event == mAppEvt_GattProcError_c)
-                {
-                    (void)Gap_Disconnect(peerDeviceId);
-                }
+                TxQueue_Done(pQueue);
             }
         }
-        break;
-
-        case mAppServiceDisc_c:
+        else
         {
-            if (event == mAppEvt_ServiceDiscoveryComplete_c)
+            (void)TxQueue_Fail(pQueue);
+            if (NULL != TxQueue_Head(pQueue))
             {
-                /* Moving to Running State*/
-                maPeerInformation[peerDeviceId].appState = mAppRunning_c;
+                pQueue->held = true;
+                (void)TM_InstallCallback((timer_handle_t)mTxRetryTimerId, TxRetryTimerCallback, NULL);
+                (void)TM_Start((timer_handle_t)mTxRetryTimerId,
+                            (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, mAppTxRetryIntervalInMs_c);
+            }
+            break;
+        }
+    }
+}
 
+/*! *********************************************************************************
+ * \brief        Sends the queued entries of all peers.
+ *
+ * \param[in]    pParam             Callback parameters.
+ ********************************************************************************** */
+static void BleApp_ServiceTxQueues
+(
+    void *pParam
+)
+{
+    uint8_t mPeerId = 0;
 
-                nmh1000_int_BLE();
-                nmh1000_CallBack();
+    mTxRetryPending = FALSE;
 
+    for (mPeerId = 0; mPeerId < (uint8_t)gAppMaxConnections_c; mPeerId++)
+    {
+        if (gInvalidDeviceId_c != maPeerInformation[mPeerId].deviceId)
+        {
+            maTxQueue[mPeerId].held = false;
+            BleApp_ServiceTxQueue(mPeerId);
+        }
+    }
 
-#if gAppUseBonding_d
-                union
-                {
-                    uint32_t u32;
-                    uint16_t u16;
-                } tempCast;
+    BleApp_TxDrained();
+}
 
-                tempCast.u32 = sizeof(wucConfig_t);
-                /* Write data in NVM */
-                (void)Gap_SaveCustomPeerInformation(maPeerInformation[peerDeviceId].deviceId,
-                        (uint8_t *) &maPeerInformation[peerDeviceId].clientInfo, 0,
-                        tempCast.u16);
-#endif
+/*! *********************************************************************************
+ * \brief        Handles the confirmation of the entry a peer was waiting for.
+ *
+ * \param[in]    peerDeviceId       The remote device ID.
+ * \param[in]    success            FALSE if the peer answered with an error.
+ ********************************************************************************** */
+static void BleApp_TxConfirmed
+(
+    deviceId_t peerDeviceId,
+    bool_t success
+)
+{
+    if (!maTxQueue[peerDeviceId].busy)
+    {
+        return;
+    }
+
+    if (TRUE == success)
+    {
+        TxQueue_Done(&maTxQueue[peerDeviceId]);
+    }
+    else
+    {
+        (void)TxQueue_Fail(&maTxQueue[peerDeviceId]);
+    }
+
+    BleApp_ServiceTxQueue(peerDeviceId);
+    BleApp_TxDrained();
+}
+
+/*! *********************************************************************************
+ * \brief        Lets the data waiting for room in the TX queues go on.
+ *
+ * \details      Called once queue entries went out or were dropped. The snapshot
+ *               is read from its ring only as fast as the queues drain, see
+ *               nmh1000_SnapshotSendHandler.
+ ********************************************************************************** */
+static void BleApp_TxDrained(void)
+{
+#if (NMH1000_SNAPSHOT_MODE == 1)
+    if (mNmh1000Snapshot.triggered && (FALSE == mNmh1000SnapshotSendPending))
+    {
+        mNmh1000SnapshotSendPending = TRUE;
+        if (gBleSuccess_c != App_PostCallbackMessage(nmh1000_SnapshotSendHandler, NULL))
+        {
+            mNmh1000SnapshotSendPending = FALSE;
+        }
+    }
+#endif
+}
+
+/*! *********************************************************************************
+ * \brief        Checks if a peer enabled the notifications or indications of the tamper events.
+ *
+ * \param[in]    peerDeviceId       The remote device ID.
+ *
+ * \return       TRUE if the CCCD of the tamper event is set for notifications or indications.
+ ********************************************************************************** */
+static bool_t BleApp_TamperNotifyEnabled
+(
+    deviceId_t peerDeviceId
+)
+{
+    bool_t isNotifActive = FALSE;
+    bool_t isIndActive = FALSE;
+
+    if (gBleSuccess_c != Gap_CheckNotificationStatus(peerDeviceId, (uint16_t)cccd_tamper_event, &isNotifActive))
+    {
+        isNotifActive = FALSE;
+    }
+    if (gBleSuccess_c != Gap_CheckIndicationStatus(peerDeviceId, (uint16_t)cccd_tamper_event, &isIndActive))
+    {
+        isIndActive = FALSE;
+    }
+
+    return ((TRUE == isNotifActive) || (TRUE == isIndActive)) ? TRUE : FALSE;
+}
+
+/*! *********************************************************************************
+ * \brief        Serves a peer which only subscribed to the Tamper service.
+ *
+ * \details      The events go out as notifications, the discovery of a Wireless
+ *               UART on the peer is not needed and is stopped.
+ *
+ * \param[in]    peerDeviceId       The remote device ID.
+ ********************************************************************************** */
+static void BleApp_StartTamperNotify
+(
+    deviceId_t peerDeviceId
+)
+{
+    BleServDisc_Stop(peerDeviceId);
+
+    /* Moving to Tamper Notify State*/
+    maPeerInformation[peerDeviceId].appState = mAppTamperNotify_c;
+
+    nmh1000_int_BLE();
+    nmh1000_CallBack();
+}
+
+#if (NMH1000_ASCII_ALERT_MODE == 0)
+/*! *********************************************************************************
+ * \brief        Sends tamper event records to all peers, in one write.
+ *
+ * \details      Peers subscribed to the Tamper service get an indication or a
+ *               notification, the other running peers get the records on their
+ *               Wireless UART. The peers confirm the records, see BleApp_QueueTx.
+ *
+ * \param[in]    pRecord            Pointer to the encoded records.
+ * \param[in]    recordSize         The number of bytes in the records.
+ ********************************************************************************** */
+static void BleApp_SendTamperEvent
+(
+    uint8_t *pRecord,
+    uint32_t recordSize
+)
+{
+    (void)BleApp_QueueTx(pRecord, recordSize, mTxClass_Alert_c);
+}
+
+#if (NMH1000_EVENT_BATCH_MS > 0U)
+/*! *********************************************************************************
+ * \brief        Gets the largest batch all peers take in one write or notification.
+ *
+ * \return       The size in bytes, from the smallest ATT MTU of the peers, at most
+ *               one TX queue entry.
+ ********************************************************************************** */
+static uint16_t BleApp_TamperBatchLimit(void)
+{
+    uint16_t limit = TX_QUEUE_ENTRY_SIZE;
+    uint16_t tempMtu = 0U;
+    uint8_t  mPeerId = 0;
+
+    for (mPeerId = 0; mPeerId < (uint8_t)gAppMaxConnections_c; mPeerId++)
+    {
+        if (gInvalidDeviceId_c != maPeerInformation[mPeerId].deviceId)
+        {
+            tempMtu = gAttDefaultMtu_c;
+            (void)Gatt_GetMtu(mPeerId, &tempMtu);
+            tempMtu = gAttMaxNotifIndDataSize_d(tempMtu);
+
+            limit = limit <= tempMtu ? limit : tempMtu;
+        }
+    }
+
+    return limit;
+}
+
+/*! *********************************************************************************
+ * \brief        Adds one tamper event record to the batch.
+ *
+ * \details      The batch goes out when the window ends, when it cannot take
+ *               another record or at once for an urgent record.
+ *
+ * \param[in]    pRecord            Pointer to the encoded record.
+ * \param[in]    recordSize         The number of bytes in the record.
+ * \param[in]    urgent             TRUE to send the batch without waiting.
+ ********************************************************************************** */
+static void BleApp_QueueTamperEvent
+(
+    uint8_t *pRecord,
+    uint32_t recordSize,
+    bool_t urgent
+)
+{
+    uint16_t limit = BleApp_TamperBatchLimit();
+
+    if (!TamperEvent_BatchAppend(&mTamperBatch, pRecord, recordSize, limit))
+    {
+        /* No room left for the record, send the batch first */
+        BleApp_FlushTamperBatch(NULL);
+        (void)TamperEvent_BatchAppend(&mTamperBatch, pRecord, recordSize, limit);
+    }
+
+    if ((TRUE == urgent) || ((mTamperBatch.length + TAMPER_EVENT_HEADER_SIZE) > limit))
+    {
+        BleApp_FlushTamperBatch(NULL);
+    }
+    else if (mTamperBatch.length == recordSize)
+    {
+        /* First record of the batch, it waits at most one window */
+        (void)TM_InstallCallback((timer_handle_t)mTamperBatchTimerId, TamperBatchTimerCallback, NULL);
+        (void)TM_Start((timer_handle_t)mTamperBatchTimerId,
+                    (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, NMH1000_EVENT_BATCH_MS);
+    }
+    else
+    {
+        ; /* Wait for the window to end */
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Sends the batch of tamper event records to all peers.
+ *
+ * \param[in]    pParam             Callback parameters.
+ ********************************************************************************** */
+static void BleApp_FlushTamperBatch
+(
+    void *pParam
+)
+{
+    (void)TM_Stop((timer_handle_t)mTamperBatchTimerId);
+    mTamperBatchPending = FALSE;
+
+    if (0U != mTamperBatch.length)
+    {
+        BleApp_SendTamperEvent(mTamperBatch.buffer, mTamperBatch.length);
+        TamperEvent_BatchReset(&mTamperBatch);
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Timer handler for the end of the batch window.
+ *
+ * \param[in]    pParam             Callback parameters.
+ ********************************************************************************** */
+static void TamperBatchTimerCallback
+(
+    void *pParam
+)
+{
+    if (!mTamperBatchPending)
+    {
+        mTamperBatchPending = TRUE;
+        if (gBleSuccess_c != App_PostCallbackMessage(BleApp_FlushTamperBatch, NULL))
+        {
+            /* The queue is full, try again at the end of another window */
+            mTamperBatchPending = FALSE;
+            (void)TM_Start((timer_handle_t)mTamperBatchTimerId,
+                        (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, NMH1000_EVENT_BATCH_MS);
+        }
+    }
+}
+#endif /* NMH1000_EVENT_BATCH_MS */
+#endif /* NMH1000_ASCII_ALERT_MODE */
+
+#if (NMH1000_BROADCAST_MODE == 1)
+/*! *********************************************************************************
+ * \brief        Starts the tamper beacon and the sensor, once the connectable
+ *               advertising runs.
+ *
+ * \details      The beacon first only tells the node is alive. The sensor
+ *               starts without waiting for a peer, the gateways get the alerts
+ *               from the beacon.
+ ********************************************************************************** */
+static void BleApp_StartBeacon(void)
+{
+    if (!mBeaconStarted)
+    {
+        mBeaconStarted = TRUE;
+        if (gNVM_OK_c != NvRestoreDataSet(&mBeaconCounterLimit, FALSE))
+        {
+            mBeaconCounterLimit = 0U;
+        }
+        /* The values below the limit may have been sent before the reset */
+        mBeaconCounter = mBeaconCounterLimit;
+        BleApp_UpdateBeacon(NULL, 0U);
+        BleApp_RestartBeacon(FALSE);
+
+        nmh1000_int_BLE();
+        nmh1000_CallBack();
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Puts new content in the tamper beacon, with the next counter
+ *               value and its MIC.
+ *
+ * \param[in]    pRecord            Pointer to the encoded record, NULL for none.
+ * \param[in]    recordSize         The number of bytes in the record.
+ ********************************************************************************** */
+static void BleApp_UpdateBeacon
+(
+    const uint8_t *pRecord,
+    uint32_t recordSize
+)
+{
+    uint8_t mac[AES_128_BLOCK_SIZE];
+    uint32_t length;
+
+    if ((mBeaconCounter == mBeaconCounterLimit) && (FALSE == BleApp_ReserveBeaconCounter()))
+    {
+        /* Keep the last beacon rather than send a value a reset could repeat */
+        return;
+    }
+
+    length = TamperBeacon_Encode(maBeaconData, mBeaconCounter, pRecord, recordSize);
+    if (0U != length)
+    {
+        mBeaconCounter++;
+        AES_128_CMAC(maBeaconData, length, mBeaconKey, mac);
+        maBeaconAdStruct[0].length = (uint8_t)(TamperBeacon_Seal(maBeaconData, length, mac) + 1U);
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Reserves the next NMH1000_BROADCAST_COUNTER_WINDOW beacon counter
+ *               values in NVM.
+ *
+ * \return       TRUE once the new limit is saved, FALSE if the counter has to stay
+ *               below the old one.
+ ********************************************************************************** */
+static bool_t BleApp_ReserveBeaconCounter(void)
+{
+    uint32_t limit = mBeaconCounterLimit;
+
+    mBeaconCounterLimit = mBeaconCounter + NMH1000_BROADCAST_COUNTER_WINDOW;
+    if (gNVM_OK_c != NvSyncSave(&mBeaconCounterLimit, FALSE))
+    {
+        mBeaconCounterLimit = limit;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*! *********************************************************************************
+ * \brief        Restarts the tamper beacon with its latest content.
+ *
+ * \details      A burst advertises at the fast interval, the set terminates
+ *               after NMH1000_BROADCAST_BURST_MS and goes on at the slow interval.
+ *               The interval only changes while the set is stopped, a running
+ *               set is stopped first and started again from
+ *               BleApp_AdvertisingCallback.
+ *
+ * \param[in]    burst              TRUE after an event, FALSE for slow beaconing.
+ ********************************************************************************** */
+static void BleApp_RestartBeacon
+(
+    bool_t burst
+)
+{
+    if (mBeaconBusy)
+    {
+        /* A burst wins over slow beaconing */
+        mBeaconPending = TRUE;
+        mBeaconBurst = (mBeaconBurst || burst) ? TRUE : FALSE;
+    }
+    else
+    {
+        mBeaconBurst = burst;
+        mBeaconBusy = TRUE;
+        if (!mBeaconOn)
+        {
+            BleApp_SetupBeacon();
+        }
+        else if (gBleSuccess_c != Gap_StopExtAdvertising(mAppBeaconHandle_c))
+        {
+            mBeaconBusy = FALSE;
+        }
+        else
+        {
+            ; /* Started again when the set is off */
+        }
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Sets the interval and the data of the tamper beacon and starts it.
+ ********************************************************************************** */
+static void BleApp_SetupBeacon(void)
+{
+    uint32_t interval = mBeaconBurst ? mAppAdvInterval(NMH1000_BROADCAST_FAST_MS) : mAppAdvInterval(NMH1000_BROADCAST_SLOW_MS);
+
+    mBeaconAdvParams.minInterval = interval;
+    mBeaconAdvParams.maxInterval = interval;
+    /* The duration counts 10 ms units */
+    mAppBeaconParams.duration = mBeaconBurst ? (uint16_t)(NMH1000_BROADCAST_BURST_MS / 10U) : gBleExtAdvNoDuration_c;
+
+    if (gBleSuccess_c != BluetoothLEHost_StartExtAdvertising(&mAppBeaconParams, BleApp_AdvertisingCallback,
+                                                               BleApp_ConnectionCallback))
+    {
+        mBeaconBusy = FALSE;
+    }
+}
+#endif /* NMH1000_BROADCAST_MODE */
+
+/*! *********************************************************************************
+ * \brief        Handle the main application state machine
+ *
+ * \param[in]    peerDeviceId       The remote device ID.
+ * \param[in]    event              The application event.
+ ********************************************************************************** */
+static void BleApp_StateMachineHandler
+(
+    deviceId_t peerDeviceId,
+    appEvent_t event
+)
+{
+    uint16_t tempMtu = 0;
+    union
+    {
+        uint8_t     *pUuidArray;
+        bleUuid_t   *pUuidObj;
+    } temp; /* MISRA rule 11.3 */
+
+    temp.pUuidArray = uuid_service_wireless_uart;
+
+    /* invalid client information */
+    if (maPeerInformation[peerDeviceId].deviceId != gInvalidDeviceId_c)
+    {
+        switch (maPeerInformation[peerDeviceId].appState)
+        {
+        case mAppIdle_c:
+        {
+            if (event == mAppEvt_PeerConnected_c)
+            {
+                /* Let the central device initiate the Exchange MTU procedure*/
+                if (mGapRole == gGapCentral_c)
+                {
+                    /* Moving to Exchange MTU State */
+                    maPeerInformation[peerDeviceId].appState = mAppExchangeMtu_c;
+                    (void)GattClient_ExchangeMtu(peerDeviceId, gAttMaxMtu_c);
+                }
+                else
+                {
+                    /* Moving to Service Discovery State*/
+                    maPeerInformation[peerDeviceId].appState = mAppServiceDisc_c;
+
+                    /* Start Service Discovery*/
+                    (void)BleServDisc_FindService(peerDeviceId,
+                            gBleUuidType128_c,
+                            temp.pUuidObj);
+                }
+            }
+        }
+        break;
+
+        case mAppExchangeMtu_c:
+        {
+            if (event == mAppEvt_GattProcComplete_c)
+            {
+                /* update stream length with minimum of maximum MTU's of connected devices */
+                (void)Gatt_GetMtu(peerDeviceId, &tempMtu);
+                tempMtu = gAttMaxWriteDataSize_d(tempMtu);
+
+                mAppUartBufferSize = mAppUartBufferSize <= tempMtu ? mAppUartBufferSize : tempMtu;
+
+                /* Moving to Service Discovery State*/
+                maPeerInformation[peerDeviceId].appState = mAppServiceDisc_c;
+
+                /* Start Service Discovery*/
+                (void)BleServDisc_FindService(peerDeviceId,
+                        gBleUuidType128_c,
+                        temp.pUuidObj);
+            }
+            else
+            {
+                if (event == mAppEvt_GattProcError_c)
+                {
+                    (void)Gap_Disconnect(peerDeviceId);
+                }
+            }
+        }
+        break;
+
+        case mAppServiceDisc_c:
+        {
+            if (event == mAppEvt_ServiceDiscoveryComplete_c)
+            {
+                /* Moving to Running State*/
+                maPeerInformation[peerDeviceId].appState = mAppRunning_c;
+
+
+                nmh1000_int_BLE();
+                nmh1000_CallBack();
+
+
+#if gAppUseBonding_d
+                union
+                {
+                    uint32_t u32;
+                    uint16_t u16;
+                } tempCast;
+
+                tempCast.u32 = sizeof(wucConfig_t);
+                /* Write data in NVM */
+                (void)Gap_SaveCustomPeerInformation(maPeerInformation[peerDeviceId].deviceId,
+                        (uint8_t *) &maPeerInformation[peerDeviceId].clientInfo, 0,
+                        tempCast.u16);
+#endif
             }
             else if (event == mAppEvt_ServiceDiscoveryNotFound_c)
             {
@@ -1233,6 +2083,11 @@ static void BleApp_StateMachineHandler
             {
                 (void)Gap_Disconnect(peerDeviceId);
             }
+            else if (event == mAppEvt_TamperNotifyEnabled_c)
+            {
+                /* No need to wait for the Wireless UART of the peer */
+                BleApp_StartTamperNotify(peerDeviceId);
+            }
             else
             {
                 /* ignore other event types */
@@ -1250,7 +2105,19 @@ static void BleApp_StateMachineHandler
             else if ((event == mAppEvt_ServiceDiscoveryNotFound_c) ||
                     (event == mAppEvt_ServiceDiscoveryFailed_c))
             {
-                (void)Gap_Disconnect(peerDeviceId);
+                /* A bonded peer keeps its subscription to the Tamper service */
+                if (TRUE == BleApp_TamperNotifyEnabled(peerDeviceId))
+                {
+                    BleApp_StartTamperNotify(peerDeviceId);
+                }
+                else
+                {
+                    (void)Gap_Disconnect(peerDeviceId);
+                }
+            }
+            else if (event == mAppEvt_TamperNotifyEnabled_c)
+            {
+                BleApp_StartTamperNotify(peerDeviceId);
             }
             else
             {
@@ -1366,7 +2233,7 @@ static void BleApp_FlushUartStream
                 if (bytesRead != 0U)
                 {
                     /* Send data over the air */
-                    BleApp_SendUartStream(pMsg, (uint32_t)bytesRead);
+                    (void)BleApp_QueueTx(pMsg, (uint32_t)bytesRead, mTxClass_Debug_c);
                 }
             }
 
@@ -1399,6 +2266,15 @@ static void BleApp_ReceivedUartStream
     uint8_t *pBuffer = NULL;
     uint32_t messageHeaderSize = 0;
 
+#if (REGISTER_I2C_PROFILE == 1)
+    /* A peer asking for the bus statistics gets them instead of the request being printed. */
+    if ((streamLength >= 4U) && FLib_MemCmp(pStream, "?bus", 4U))
+    {
+        BleApp_SendBusProfile();
+        return;
+    }
+#endif
+
     if (mAppUartNewLine || (previousDeviceId != peerDeviceId))
     {
         streamLength += (uint16_t)sizeof(additionalInfoBuff);
@@ -1448,6 +2324,30 @@ static void BleApp_ReceivedUartStream
     previousDeviceId = peerDeviceId;
 }
 
+#if (REGISTER_I2C_PROFILE == 1)
+/*! *********************************************************************************
+ * \brief        Prints the I2C bus statistics on the debug UART and sends them to the peers.
+ ********************************************************************************** */
+static void BleApp_SendBusProfile(void)
+{
+    registeri2cprofile_t profile;
+    char text[160];
+    uint32_t length;
+    uint32_t sent;
+    uint8_t i;
+
+    for (i = 0U; Register_I2C_ProfileGet(i, &profile); i++)
+    {
+        length = Register_I2C_ProfileFormat(&profile, text, sizeof(text));
+        Serial_Print(text, gAllowToBlock_d);
+        for (sent = 0U; sent < length; sent += 64U)
+        {
+            (void)BleApp_QueueTx((uint8_t *)&text[sent], ((length - sent) < 64U) ? (length - sent) : 64U, mTxClass_Debug_c);
+        }
+    }
+}
+#endif
+
 /*! *********************************************************************************
  * \brief        Timer handler for flushing the UART.
  *
@@ -1465,6 +2365,29 @@ static void UartStreamFlushTimerCallback
     }
 }
 
+/*! *********************************************************************************
+ * \brief        Timer handler for sending the TX queues again.
+ *
+ * \param[in]    pParam             Callback parameters.
+ ********************************************************************************** */
+static void TxRetryTimerCallback
+(
+    void *pParam
+)
+{
+    if (!mTxRetryPending)
+    {
+        mTxRetryPending = TRUE;
+        if (gBleSuccess_c != App_PostCallbackMessage(BleApp_ServiceTxQueues, NULL))
+        {
+            /* The queue is full, try again after another interval */
+            mTxRetryPending = FALSE;
+            (void)TM_Start((timer_handle_t)mTxRetryTimerId,
+                        (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, mAppTxRetryIntervalInMs_c);
+        }
+    }
+}
+
 /*! *********************************************************************************
 * \brief        Handles UART Receive callback.
 *
@@ -1860,8 +2783,13 @@ static void BluetoothLEHost_Initialized(void)
     /* Allocate application timer */
     (void)TM_Open(mAppTimerId);
     (void)TM_Open(mUartStreamFlushTimerId);
+    (void)TM_Open(mTxRetryTimerId);
+#if (NMH1000_ASCII_ALERT_MODE == 0) && (NMH1000_EVENT_BATCH_MS > 0U)
+    (void)TM_Open(mTamperBatchTimerId);
+#endif
     (void)TM_Open(mBatteryMeasurementTimerId);
     (void)TM_Open(mNmh1000Id);
+    (void)TM_Open(mNmh1000DeadlineId);
 
 #if (gAppButtonCnt_c == 1)
     (void)TM_Open(mSwitchPressTimerId);
@@ -1913,14 +2841,40 @@ static void BluetoothLEHost_GenericCallback(gapGenericEvent_t *pGenericEvent)
     }
 }
 
+/*! The OUT_M sample is read by the engine unless the OUT pin reports the field changes. */
+static const sensorengineops_t cNmh1000EngineOps = {
+    .slaveAddress = NMH1000_I2C_ADDR_VAL,
+    .whoAmIReg = NMH1000_WHO_AM_I,
+    .pWhoAmIValues = cNmh1000WhoAmI,
+    .numWhoAmIValues = sizeof(cNmh1000WhoAmI),
+    .init = nmh1000_engine_init,
+    .configure = nmh1000_engine_configure,
+#if (NMH1000_OUT_IRQ_MODE == 1)
+    .pPollList = NULL,
+    .decode = NULL,
+#else
+    .pPollList = cNmh1000OutputNormal,
+    .decode = nmh1000_engine_decode,
+#endif
+};
+
 
 int nmh1000_int_BLE(void)
     {
 
         int32_t status;
-        uint8_t whoami;
+        uint8_t descriptor[SENSOR_DESCRIPTOR_SIZE];
 
         BleApp_SendUartStream(&vec_init[0], 70U);
+        pNmh1000Variant = NULL;
+        nmh1000WhoAmI = 0U;
+
+#if (defined(RTE_I2C1_DMA_EN) && RTE_I2C1_DMA_EN)
+        /*! The CMSIS driver moves the I2C data through eDMA, bring the controller up first. */
+        edma_config_t edmaConfig;
+        EDMA_GetDefaultConfig(&edmaConfig);
+        EDMA_Init(RTE_I2C1_DMA_TX_DMA_BASE, &edmaConfig);
+#endif
 
         /*! Initialize the I2C driver. */
         status = I2Cdrv->Initialize(I2C_S_SIGNAL_EVENT);
@@ -1950,31 +2904,60 @@ int nmh1000_int_BLE(void)
 
             return -1;
         }
+#if (REGISTER_I2C_PROFILE == 1)
+        /*! Count the bus cost of this session from here. */
+        Register_I2C_ProfileReset();
+#endif
 
         /* Init output LED GPIO. */
         GPIO_PinInit(BOARD_INITPINS_LED_GREEN_GPIO, BOARD_INITPINS_LED_GREEN_PIN, &led_config);
         GPIO_PinInit(BOARD_INITPINS_LED_BLUE_GPIO, BOARD_INITPINS_LED_BLUE_PIN, &led_config);
         GPIO_PinInit(BOARD_INITPINS_LED_RED_GPIO, BOARD_INITPINS_LED_RED_PIN, &led_config);
 
-        /*! Initialize NMH1000 sensor . */
-    	status = NMH1000_I2C_Initialize(&nmh1000Driver, &I2C_S_DRIVER, I2C_S_DEVICE_INDEX, NMH1000_I2C_ADDR_VAL,
-    			NMH1000_WHO_AM_I_VALUE);
-        if (ARM_DRIVER_OK != status)
+        /*! Start from a field free reference, ambient field is learnt from the samples. */
+        Baseline_Init(&mNmh1000Baseline, NMH1000_BASELINE_SHIFT, NMH1000_BASELINE_GATE);
+        Baseline_Seed(&mNmh1000Baseline, 0);
+        NMH1000_Fsm_Init(&mNmh1000Fsm);
+        mNmh1000FieldValid = FALSE;
+#if (NMH1000_OUT_IRQ_MODE == 0)
+        PollSched_Init(&mNmh1000Poll, &cNmh1000PollConfig);
+#endif
+#if (NMH1000_SNAPSHOT_MODE == 1)
+        nmh1000_snapshot_init();
+#endif
+        (void)TM_Stop((timer_handle_t)mNmh1000DeadlineId);
+
+        /*! Probe the bus, the NMH1000 driver is initialized and configured once its WHO_AM_I answers. */
+        nmh1000Slot.pOps = &cNmh1000EngineOps;
+        nmh1000Slot.pHandle = &nmh1000Driver;
+        SensorEngine_Init(&nmh1000Engine, I2Cdrv, I2C_S_DEVICE_INDEX, &nmh1000Slot, 1);
+        (void)SensorEngine_Probe(&nmh1000Engine);
+        if ((SENSOR_ENGINE_NOT_PRESENT == nmh1000Slot.status) || (NULL == pNmh1000Variant))
         {
            	BleApp_SendUartStream(&vec_inint_sensor[0], 70U);
             return -1;
         }
-    	BleApp_SendUartStream(&vec_init_success[0], 70U);
+        /*! Tell the peers which part answered and what it can do. */
+        BleApp_SendUartStream(descriptor, SensorRegistry_Describe(pNmh1000Variant, nmh1000WhoAmI, descriptor));
+        Serial_Print("\n\rSensor ", gAllowToBlock_d);
+        Serial_Print(pNmh1000Variant->pName, gAllowToBlock_d);
+        Serial_Print("\n\r", gAllowToBlock_d);
 
-        /*! Configure the NMH1000 sensor. */
-        status = NMH1000_I2C_Configure(&nmh1000Driver, cNmh1000ConfigNormal);
-        if (SENSOR_ERROR_NONE != status)
+        if (!nmh1000Slot.present)
         {
         	BleApp_SendUartStream(&vec_sensor_err[0], 70U);
             return -1;
         }
     	BleApp_SendUartStream(&vec_sensor_succ[0], 70U);
 
+#if (NMH1000_OUT_IRQ_MODE == 1)
+        /*! Route the OUT pin to the MCU so field changes are handled on the pin edge. */
+        if (0 != nmh1000_irq_init())
+        {
+            return -1;
+        }
+#endif
+
         return 0;
     }
 
@@ -1984,8 +2967,14 @@ void nmh1000_CallBack()
 
 		(void)TM_InstallCallback((timer_handle_t)mNmh1000Id, nmh1000_TimerCallback, NULL);
 
+#if (NMH1000_OUT_IRQ_MODE == 1)
+        /* The OUT pin delivers the field changes, the timer only guards against a missed edge. */
         (void)TM_Start((timer_handle_t)mNmh1000Id,
-                    (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, mnmh1000IntervalInMs_c);
+                    (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, mnmh1000WatchdogIntervalInMs_c);
+#else
+        (void)TM_Start((timer_handle_t)mNmh1000Id,
+                    (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, PollSched_Interval(&mNmh1000Poll));
+#endif
         status_ble = 0;
 
 
@@ -1997,55 +2986,421 @@ void nmh1000_TimerCallback()
 	    nmh1000_CallBack();
 	}
 
+/*! *********************************************************************************
+ * \brief        Hands a field state to the state machine when it differs from the last one.
+ *
+ * \param[in]    present     TRUE if the field is above the threshold.
+ ********************************************************************************** */
+static void nmh1000_set_field(bool_t present)
+{
+    bool_t changed;
+    uint32_t regPrimask;
+
+    /* Called from the timer and from the OUT pin interrupt. */
+    regPrimask = DisableGlobalIRQ();
+    changed = (FALSE == mNmh1000FieldValid) || (present != mNmh1000Field);
+    mNmh1000Field = present;
+    mNmh1000FieldValid = TRUE;
+    EnableGlobalIRQ(regPrimask);
+
+    if (changed)
+    {
+        nmh1000_fsm_post((TRUE == present) ? mNmh1000Evt_FieldPresent_c : mNmh1000Evt_FieldAbsent_c);
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Queues an event for the state machine, which only runs in the application task.
+ *
+ * \param[in]    event       Event to process.
+ ********************************************************************************** */
+static void nmh1000_fsm_post(nmh1000Event_t event)
+{
+    if (gBleSuccess_c != App_PostCallbackMessage(nmh1000_FsmHandler, (void *)(uint32_t)event))
+    {
+        /* Out of messages, have the next sample post the field state again. */
+        mNmh1000FieldValid = FALSE;
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Runs one event through the state machine and carries out its actions.
+ *
+ * \param[in]    pParam      The nmh1000Event_t to process.
+ ********************************************************************************** */
+static void nmh1000_FsmHandler(void *pParam)
+{
+    uint8_t actions;
+
+    actions = NMH1000_Fsm_Dispatch(&mNmh1000Fsm, (nmh1000Event_t)(uint32_t)pParam);
+
+    if (0U != (actions & NMH1000_FSM_ACTION_ALERT))
+    {
+        GPIO_PortClear(BOARD_INITPINS_LED_RED_GPIO, 1u << BOARD_INITPINS_LED_RED_PIN);
+        GPIO_PortSet(BOARD_INITPINS_LED_GREEN_GPIO, 1u << BOARD_INITPINS_LED_GREEN_PIN);
+        GPIO_PortSet(BOARD_INITPINS_LED_BLUE_GPIO, 1u << BOARD_INITPINS_LED_BLUE_PIN);
+        /*! Wake Mode Detected. */
+#if (NMH1000_ASCII_ALERT_MODE == 1)
+        BleApp_SendUartStream(&vec_mag_start[0], 70U);
+        BleApp_SendUartStream(&vec_mag_dec[0], 70U);
+        BleApp_SendUartStream(&vec_mag_end[0], 70U);
+#else
+        nmh1000_send_event(mTamperEvent_Magnetic_c, mTamperSeverity_Alert_c);
+#endif
+#if (NMH1000_SNAPSHOT_MODE == 1)
+        nmh1000_snapshot_trigger();
+#endif
+    }
+    if (0U != (actions & NMH1000_FSM_ACTION_CLEAR))
+    {
+        GPIO_PortSet(BOARD_INITPINS_LED_RED_GPIO, 1u << BOARD_INITPINS_LED_RED_PIN);
+        GPIO_PortSet(BOARD_INITPINS_LED_GREEN_GPIO, 1u << BOARD_INITPINS_LED_GREEN_PIN);
+        GPIO_PortSet(BOARD_INITPINS_LED_BLUE_GPIO, 1u << BOARD_INITPINS_LED_BLUE_PIN);
+    }
+    if (0U != (actions & NMH1000_FSM_ACTION_SAFE))
+    {
+#if (NMH1000_ASCII_ALERT_MODE == 1)
+        BleApp_SendUartStream(&vec_ASLP[0], 70U);
+#else
+        nmh1000_send_event(mTamperEvent_Safe_c, mTamperSeverity_Info_c);
+#endif
+    }
+    if (0U != (actions & NMH1000_FSM_ACTION_START_DEADLINE))
+    {
+        (void)TM_InstallCallback((timer_handle_t)mNmh1000DeadlineId, nmh1000_DeadlineCallback, NULL);
+        (void)TM_Start((timer_handle_t)mNmh1000DeadlineId,
+                       (uint8_t)kTimerModeLowPowerTimer | (uint8_t)kTimerModeSingleShot, NMH1000_SAFE_DELAY_MS);
+    }
+    if (0U != (actions & NMH1000_FSM_ACTION_STOP_DEADLINE))
+    {
+        (void)TM_Stop((timer_handle_t)mNmh1000DeadlineId);
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Settle deadline expiry, runs in the timer context.
+ *
+ * \param[in]    pParam      Unused.
+ ********************************************************************************** */
+static void nmh1000_DeadlineCallback(void *pParam)
+{
+    (void)pParam;
+
+    nmh1000_fsm_post(mNmh1000Evt_Deadline_c);
+}
+
+#if (NMH1000_OUT_IRQ_MODE == 1)
+/*! *********************************************************************************
+ * \brief        Configures the NMH1000 OUT pin as a wake-up capable interrupt source.
+ *
+ * \return       0 on success, -1 if the GPIO adapter rejected the pin.
+ ********************************************************************************** */
+static int nmh1000_irq_init(void)
+{
+    hal_gpio_pin_config_t outConfig = {
+        kHAL_GpioDirectionIn,
+        0U,
+        (uint8_t)NMH1000_OUT_PORT_NUM,
+        (uint8_t)NMH1000_OUT_PIN,
+    };
+
+    /* The pin survives reconnections, only configure it once. */
+    if (TRUE == mNmh1000IrqReady)
+    {
+        return 0;
+    }
+
+    PORT_SetPinMux(NMH1000_OUT_PORT, NMH1000_OUT_PIN, kPORT_MuxAsGpio);
+
+    if (kStatus_HAL_GpioSuccess != HAL_GpioInit((hal_gpio_handle_t)mNmh1000OutHandle, &outConfig))
+    {
+        return -1;
+    }
+    (void)HAL_GpioInstallCallback((hal_gpio_handle_t)mNmh1000OutHandle, nmh1000_OutCallback, NULL);
+
+    /* OUT is active high: rising edge when the field appears, falling edge when it is gone. */
+    (void)HAL_GpioSetTriggerMode((hal_gpio_handle_t)mNmh1000OutHandle, kHAL_GpioInterruptEitherEdge);
+    (void)HAL_GpioWakeUpSetting((hal_gpio_handle_t)mNmh1000OutHandle, 1U);
+
+    mNmh1000IrqReady = TRUE;
+
+    return 0;
+}
+
+/*! *********************************************************************************
+ * \brief        OUT pin interrupt callback, runs in interrupt context.
+ *
+ * \param[in]    pParam      Unused.
+ ********************************************************************************** */
+static void nmh1000_OutCallback(void *pParam)
+{
+    uint8_t pinLevel = 0U;
+
+    (void)pParam;
+
+    (void)HAL_GpioGetInput((hal_gpio_handle_t)mNmh1000OutHandle, &pinLevel);
+    nmh1000_set_field((0U != pinLevel) ? TRUE : FALSE);
+}
+#endif /* NMH1000_OUT_IRQ_MODE */
+
+#if (NMH1000_ASCII_ALERT_MODE == 0)
+/*! *********************************************************************************
+ * \brief        Sends one binary event record to the peers, in a single write.
+ *
+ * \param[in]    type        tamperEventType_t.
+ * \param[in]    severity    tamperSeverity_t.
+ ********************************************************************************** */
+static void nmh1000_send_event(uint8_t type, uint8_t severity)
+{
+    tamperevent_t event;
+    uint8_t record[TAMPER_EVENT_MAX_SIZE];
+    uint32_t recordSize;
+
+    TamperEvent_Init(&event, type, severity, nmh1000WhoAmI,
+                     mNmh1000EventSeq++, (uint32_t)(TM_GetTimestamp() / 1000U));
+
+    recordSize = TamperEvent_Encode(&event, record, sizeof(record));
+#if (NMH1000_BROADCAST_MODE == 1)
+    BleApp_UpdateBeacon(record, recordSize);
+    BleApp_RestartBeacon(TRUE);
+#endif
+#if (NMH1000_EVENT_BATCH_MS > 0U)
+    BleApp_QueueTamperEvent(record, recordSize, (mTamperSeverity_Alert_c == severity) ? TRUE : FALSE);
+#else
+    BleApp_SendTamperEvent(record, recordSize);
+#endif
+}
+#endif /* NMH1000_ASCII_ALERT_MODE */
+
+#if (NMH1000_SNAPSHOT_MODE == 1)
+/*! *********************************************************************************
+ * \brief        Hands the snapshot ring its static storage and starts recording.
+ ********************************************************************************** */
+static void nmh1000_snapshot_init(void)
+{
+    if (NULL != mNmh1000Snapshot.pStorage)
+    {
+        return;
+    }
+
+    /* The size is checked at build time, the ring cannot refuse its storage. */
+    (void)CaptureRing_Init(&mNmh1000Snapshot, mNmh1000SnapshotStorage, NMH1000_SNAPSHOT_SAMPLES);
+}
+
+/*! *********************************************************************************
+ * \brief        Records one sample from the acquisition path, never waits.
+ *
+ * \param[in]    timestamp   Time the sample was taken, us.
+ * \param[in]    v0          First sensor value.
+ * \param[in]    v1          Second sensor value.
+ * \param[in]    v2          Third sensor value.
+ ********************************************************************************** */
+static void nmh1000_snapshot_push(uint32_t timestamp, int32_t v0, int32_t v1, int32_t v2)
+{
+    capturesample_t sample = {timestamp, {v0, v1, v2}};
+
+    if (NULL == mNmh1000Snapshot.pStorage)
+    {
+        return;
+    }
+
+    (void)CaptureRing_Push(&mNmh1000Snapshot, &sample);
+
+    /* Stream the snapshot out as its post trigger samples come in. */
+    if (mNmh1000Snapshot.triggered && (FALSE == mNmh1000SnapshotSendPending))
+    {
+        mNmh1000SnapshotSendPending = TRUE;
+        if (gBleSuccess_c != App_PostCallbackMessage(nmh1000_SnapshotSendHandler, NULL))
+        {
+            mNmh1000SnapshotSendPending = FALSE;
+        }
+    }
+}
+
+/*! *********************************************************************************
+ * \brief        Freezes the samples around the alert and starts sending them to the peers.
+ ********************************************************************************** */
+static void nmh1000_snapshot_trigger(void)
+{
+    if ((NULL == mNmh1000Snapshot.pStorage) ||
+        !CaptureRing_Trigger(&mNmh1000Snapshot, NMH1000_SNAPSHOT_PRE, NMH1000_SNAPSHOT_POST))
+    {
+        return;
+    }
+
+    BleApp_SendUartStream(&vec_snapshot[0], 70U);
+    nmh1000_SnapshotSendHandler(NULL);
+}
+
+/*! *********************************************************************************
+ * \brief        Sends the snapshot samples recorded so far, releases the ring once all are out.
+ *
+ * \details      Samples are read from the ring only while every peer has room
+ *               for them and mAppTxAlertReserve_c more entries, so that an alert
+ *               takes a free entry rather than a chunk of the snapshot. The rest
+ *               waits in the ring until BleApp_TxDrained posts the handler again.
+ *
+ * \param[in]    pParam      Unused.
+ ********************************************************************************** */
+static void nmh1000_SnapshotSendHandler(void *pParam)
+{
+    capturesample_t samples[4];
+    uint32_t count = 1U;
+
+    (void)pParam;
+
+    mNmh1000SnapshotSendPending = FALSE;
+
+    while ((0U != count) && (BleApp_TxRoom(mTxClass_Snapshot_c) > mAppTxAlertReserve_c))
+    {
+        count = CaptureRing_Read(&mNmh1000Snapshot, samples, 4U);
+        if (0U != count)
+        {
+            (void)BleApp_QueueTx((uint8_t *)samples, count * (uint32_t)sizeof(capturesample_t), mTxClass_Snapshot_c);
+        }
+    }
+
+    if (CaptureRing_IsDone(&mNmh1000Snapshot))
+    {
+        CaptureRing_Release(&mNmh1000Snapshot);
+    }
+}
+#endif /* NMH1000_SNAPSHOT_MODE */
+
 int nmh1000_event_BLE(void)
 {
+#if (NMH1000_OUT_IRQ_MODE == 1)
+    uint8_t pinLevel = 0U;
 
+    /* The OUT level mirrors the threshold comparison, no I2C traffic needed. */
+    (void)HAL_GpioGetInput((hal_gpio_handle_t)mNmh1000OutHandle, &pinLevel);
+    nmh1000_set_field((0U != pinLevel) ? TRUE : FALSE);
+
+    return 0;
+#else
     int32_t status;
-    uint8_t magData = 0;
 
-	/* get the mag output data */
-	status = NMH1000_I2C_ReadData(&nmh1000Driver, cNmh1000OutputNormal, &magData);
+	/* queue the mag output read, the sample is handled by nmh1000_engine_decode() */
+	status = SensorEngine_Poll(&nmh1000Engine, nmh1000_PollDone, NULL);
 	if (ARM_DRIVER_OK != status)
 	{
 		//PRINTF("\r\n Read Failed. \r\n");
 		return -1;
 	}
 
-	if (magData > THRESHOLD)
+	return 0;
+#endif
+}
+
+/*! *********************************************************************************
+ * \brief        Sensor engine hook, looks up the variant and sets up the NMH1000 driver once the probe found it.
+ *
+ * \param[in]    pSlot       Engine slot of the NMH1000.
+ *
+ * \return       SENSOR_ERROR_NONE on success.
+ ********************************************************************************** */
+static int32_t nmh1000_engine_init(sensorengineslot_t *pSlot)
+{
+    int32_t status;
+    nmh1000_i2c_sensorhandle_t *pDriver = (nmh1000_i2c_sensorhandle_t *)pSlot->pHandle;
+
+    nmh1000WhoAmI = pSlot->whoAmI;
+    pNmh1000Variant = SensorRegistry_Find(cNmh1000Variants, SENSOR_REGISTRY_COUNT(cNmh1000Variants), pSlot->whoAmI);
+    status = NMH1000_I2C_Initialize(pDriver, I2Cdrv, pSlot->pEngine->deviceInstance, pSlot->pOps->slaveAddress,
+                                    pSlot->whoAmI);
+    if (SENSOR_ERROR_NONE != status)
+    {
+        return status;
+    }
+    Register_I2C_AttachCache(&pDriver->deviceInfo, &nmh1000RegCache);
+#if (defined(RTE_I2C1_DMA_EN) && RTE_I2C1_DMA_EN)
+    /*! Sleep in WFI while eDMA moves the data instead of spinning on the completion flag. */
+    NMH1000_I2C_SetIdleTask(pDriver, Register_I2C_WaitForInterrupt, &pDriver->deviceInfo);
+#endif
+    pSlot->pDevInfo = &pDriver->deviceInfo;
+
+    return SENSOR_ERROR_NONE;
+}
+
+/*! *********************************************************************************
+ * \brief        Sensor engine hook, applies the normal mode configuration of the variant.
+ *
+ * \param[in]    pSlot       Engine slot of the NMH1000.
+ *
+ * \return       SENSOR_ERROR_NONE on success, SENSOR_ERROR_INIT if the variant lacks a feature of the build.
+ ********************************************************************************** */
+static int32_t nmh1000_engine_configure(sensorengineslot_t *pSlot)
+{
+    if (NULL == pNmh1000Variant)
+    {
+        return SENSOR_ERROR_BAD_ADDRESS;
+    }
+#if (NMH1000_OUT_IRQ_MODE == 1)
+    if (0U == (pNmh1000Variant->caps & SENSOR_CAP_WINDOW))
+    {
+        return SENSOR_ERROR_INIT;
+    }
+#endif
+
+    return NMH1000_I2C_Configure((nmh1000_i2c_sensorhandle_t *)pSlot->pHandle, pNmh1000Variant->pConfig);
+}
+
+#if (NMH1000_OUT_IRQ_MODE == 0)
+/*! *********************************************************************************
+ * \brief        Sensor engine hook, compares the polled OUT_M sample with the baseline.
+ *
+ * \param[in]    pSlot       Engine slot of the NMH1000.
+ ********************************************************************************** */
+static void nmh1000_engine_decode(sensorengineslot_t *pSlot)
+{
+    uint8_t magData = pSlot->pollData[0];
+
+    if (ARM_DRIVER_OK != pSlot->status)
+    {
+        return;
+    }
+
+#if (NMH1000_SNAPSHOT_MODE == 1)
+	nmh1000_snapshot_push((uint32_t)TM_GetTimestamp(), magData, Baseline_Mean(&mNmh1000Baseline), 0);
+#endif
+
+	if (Baseline_IsEvent(&mNmh1000Baseline, magData, THRESHOLD))
 	{
-        if (sleeptowake == 1)
-        {
-			GPIO_PortClear(BOARD_INITPINS_LED_RED_GPIO, 1u << BOARD_INITPINS_LED_RED_PIN);
-			GPIO_PortSet(BOARD_INITPINS_LED_GREEN_GPIO, 1u << BOARD_INITPINS_LED_GREEN_PIN);
-			GPIO_PortSet(BOARD_INITPINS_LED_BLUE_GPIO, 1u << BOARD_INITPINS_LED_BLUE_PIN);
-			/*! Wake Mode Detected. */
-			 BleApp_SendUartStream(&vec_mag_start[0], 70U);
-			 BleApp_SendUartStream(&vec_mag_dec[0], 70U);
-			 BleApp_SendUartStream(&vec_mag_end[0], 70U);
-			 sleeptowake = 0;
-        }
-        waketosleep = 1;
+		(void)PollSched_Update(&mNmh1000Poll, true);
+		nmh1000_set_field(TRUE);
 	}
 	else
 	{
-        if ((waketosleep == 1) || (firsttransition == 1))
-        {
-          if (1 == onetime_modetransition)
-          {
-            onetime_modetransition = 0;
-          }
-		 GPIO_PortSet(BOARD_INITPINS_LED_RED_GPIO, 1u << BOARD_INITPINS_LED_RED_PIN);
-		 GPIO_PortSet(BOARD_INITPINS_LED_GREEN_GPIO, 1u << BOARD_INITPINS_LED_GREEN_PIN);
-		 GPIO_PortSet(BOARD_INITPINS_LED_BLUE_GPIO, 1u << BOARD_INITPINS_LED_BLUE_PIN);
-         insert_delay();
-  		 BleApp_SendUartStream(&vec_ASLP[0], 70U);
-         waketosleep = 0;
-         firsttransition = 0;
-        }
-        sleeptowake = 1;
+		/*! Quiet sample, let the reference follow the ambient field. */
+		Baseline_Update(&mNmh1000Baseline, magData);
+		(void)PollSched_Update(&mNmh1000Poll, false);
+		nmh1000_set_field(FALSE);
 	}
 }
 
+/*! *********************************************************************************
+ * \brief        Poll round completion, runs in the I2C interrupt.
+ *
+ * \param[in]    pParam      Unused.
+ ********************************************************************************** */
+static void nmh1000_PollDone(void *pParam)
+{
+    (void)App_PostCallbackMessage(nmh1000_PollHandler, pParam);
+}
+
+/*! *********************************************************************************
+ * \brief        Hands the polled samples to the sensor drivers in the application task.
+ *
+ * \param[in]    pParam      Unused.
+ ********************************************************************************** */
+static void nmh1000_PollHandler(void *pParam)
+{
+    (void)pParam;
+
+    SensorEngine_Decode(&nmh1000Engine);
+}
+#endif /* NMH1000_OUT_IRQ_MODE */
+
 
 
 /*! *********************************************************************************
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file host_board.c
+ * @brief The host_board.c file implements the board services the sensor drivers call, the systick utilities
+ *        on the simulated clock and a GPIO driver whose pins only record their level.
+ */
+
+#include <stddef.h>
+#include "issdk_hal.h"
+#include "gpio_driver.h"
+#include "systick_utils.h"
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+SPI_Type g_hostSPI[2];
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+void BOARD_SystickEnable(void)
+{
+}
+
+void BOARD_SystickStart(int32_t *pStart)
+{
+    *pStart = (int32_t)HostCpu_Cycles();
+}
+
+int32_t BOARD_SystickElapsedTicks(int32_t *pStart)
+{
+    return (int32_t)(HostCpu_Cycles() - (uint32_t)*pStart);
+}
+
+uint32_t BOARD_SystickElapsedTime_us(int32_t *pStart)
+{
+    uint32_t now = HostCpu_Cycles();
+    uint32_t elapsed = now - (uint32_t)*pStart;
+
+    *pStart = (int32_t)now;
+    return elapsed / (HOST_CPU_CLOCK_HZ / 1000000U);
+}
+
+void BOARD_DELAY_ms(uint32_t delay_ms)
+{
+    /* A busy wait, the time counts as CPU time. */
+    HostCpu_Advance_ns((uint64_t)delay_ms * 1000000U);
+}
+
+static GENERIC_DRIVER_VERSION HostGpio_GetVersion(void)
+{
+    GENERIC_DRIVER_VERSION version = {GPIO_API_VERSION, ARM_DRIVER_VERSION_MAJOR_MINOR(1, 0)};
+
+    return version;
+}
+
+static void HostGpio_PinInit(
+    pinID_t aPinId, gpio_direction_t dir, void *apPinConfig, gpio_isr_handler_t aIsrHandler, void *apUserData)
+{
+    (void)aPinId;
+    (void)dir;
+    (void)apPinConfig;
+    (void)aIsrHandler;
+    (void)apUserData;
+}
+
+static void HostGpio_WritePin(pinID_t aPinId, uint8_t aValue)
+{
+    if (aPinId != NULL)
+    {
+        ((gpioHandleKSDK_t *)aPinId)->level = aValue;
+    }
+}
+
+static void HostGpio_SetPin(pinID_t aPinId)
+{
+    HostGpio_WritePin(aPinId, 1U);
+}
+
+static void HostGpio_ClrPin(pinID_t aPinId)
+{
+    HostGpio_WritePin(aPinId, 0U);
+}
+
+static uint32_t HostGpio_ReadPin(pinID_t aPinId)
+{
+    return (aPinId != NULL) ? ((gpioHandleKSDK_t *)aPinId)->level : 0U;
+}
+
+static void HostGpio_TogglePin(pinID_t aPinId)
+{
+    HostGpio_WritePin(aPinId, (uint8_t)(HostGpio_ReadPin(aPinId) ^ 1U));
+}
+
+GENERIC_DRIVER_GPIO Driver_GPIO_KSDK = {HostGpio_GetVersion, HostGpio_PinInit,   HostGpio_SetPin, HostGpio_ClrPin,
+                                        HostGpio_TogglePin,  HostGpio_WritePin, HostGpio_ReadPin};
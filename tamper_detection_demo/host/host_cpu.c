@@ -0,0 +1,216 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file host_cpu.c
+ * @brief The host_cpu.c file implements the simulated clock, PRIMASK and interrupts of the host build.
+ */
+
+#include <stddef.h>
+#include "fsl_device_registers.h"
+#include "host_cpu.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+typedef struct
+{
+    hostirqhandler_t handler;
+    uint32_t arg;
+    uint64_t due_ns;
+} hostirq_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+DWT_Type g_hostDwt;
+DCB_Type g_hostDcb;
+
+static uint64_t s_now_ns;
+static uint64_t s_sleep_ns;
+static uint64_t s_cycleRemainder;
+static uint32_t s_primask;
+static bool s_inIsr;
+static hostirq_t s_pending[HOST_CPU_MAX_PENDING];
+static uint32_t s_numPending;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void HostCpu_Tick(uint64_t ns)
+{
+    uint64_t scaled;
+
+    s_now_ns += ns;
+    /* Carry the fraction of a cycle so that many short steps add up to the right count. */
+    scaled = ns * (HOST_CPU_CLOCK_HZ / 1000000U) + s_cycleRemainder;
+    g_hostDwt.CYCCNT += (uint32_t)(scaled / 1000U);
+    s_cycleRemainder = scaled % 1000U;
+}
+
+/* Index of the interrupt which falls due first, the oldest one on a tie. */
+static uint32_t HostCpu_Next(void)
+{
+    uint32_t next = 0U;
+    uint32_t i;
+
+    for (i = 1U; i < s_numPending; i++)
+    {
+        if (s_pending[i].due_ns < s_pending[next].due_ns)
+        {
+            next = i;
+        }
+    }
+
+    return next;
+}
+
+void HostCpu_Reset(void)
+{
+    s_now_ns = 0U;
+    s_sleep_ns = 0U;
+    s_cycleRemainder = 0U;
+    s_primask = 0U;
+    s_inIsr = false;
+    s_numPending = 0U;
+    g_hostDwt.CYCCNT = 0U;
+    g_hostDwt.CTRL = 0U;
+    g_hostDcb.DEMCR = 0U;
+}
+
+uint64_t HostCpu_Now_ns(void)
+{
+    return s_now_ns;
+}
+
+uint64_t HostCpu_Sleep_ns(void)
+{
+    return s_sleep_ns;
+}
+
+uint32_t HostCpu_Cycles(void)
+{
+    return g_hostDwt.CYCCNT;
+}
+
+void HostCpu_Advance_ns(uint64_t ns)
+{
+    HostCpu_Tick(ns);
+    HostCpu_Service();
+}
+
+uint32_t HostCpu_DisableIrq(void)
+{
+    uint32_t primask = s_primask;
+
+    s_primask = 1U;
+    return primask;
+}
+
+void HostCpu_EnableIrq(uint32_t primask)
+{
+    s_primask = primask;
+    HostCpu_Service();
+}
+
+bool HostCpu_Pend(hostirqhandler_t handler, uint32_t arg, uint64_t delay_ns)
+{
+    if (s_numPending >= HOST_CPU_MAX_PENDING)
+    {
+        return false;
+    }
+    s_pending[s_numPending].handler = handler;
+    s_pending[s_numPending].arg = arg;
+    s_pending[s_numPending].due_ns = s_now_ns + delay_ns;
+    s_numPending++;
+
+    return true;
+}
+
+void HostCpu_Service(void)
+{
+    hostirq_t irq;
+    uint32_t next;
+    uint32_t i;
+
+    /* Handlers do not nest, the ones raised by a handler are taken after it returns. */
+    if ((0U != s_primask) || s_inIsr)
+    {
+        return;
+    }
+    while (0U != s_numPending)
+    {
+        next = HostCpu_Next();
+        if (s_pending[next].due_ns > s_now_ns)
+        {
+            break;
+        }
+        irq = s_pending[next];
+        for (i = next + 1U; i < s_numPending; i++)
+        {
+            s_pending[i - 1U] = s_pending[i];
+        }
+        s_numPending--;
+
+        s_inIsr = true;
+        irq.handler(irq.arg);
+        s_inIsr = false;
+    }
+}
+
+void HostCpu_Nop(void)
+{
+    uint64_t due_ns;
+
+    if ((0U != s_numPending) && (0U == s_primask) && !s_inIsr)
+    {
+        due_ns = s_pending[HostCpu_Next()].due_ns;
+        if (due_ns > s_now_ns)
+        {
+            HostCpu_Tick(due_ns - s_now_ns);
+        }
+    }
+    else
+    {
+        HostCpu_Tick(1000000000U / HOST_CPU_CLOCK_HZ);
+    }
+    HostCpu_Service();
+}
+
+void HostCpu_WaitForInterrupt(void)
+{
+    uint64_t due_ns;
+
+    if (0U == s_numPending)
+    {
+        return;
+    }
+    due_ns = s_pending[HostCpu_Next()].due_ns;
+    if (due_ns > s_now_ns)
+    {
+        s_sleep_ns += due_ns - s_now_ns;
+        HostCpu_Tick(due_ns - s_now_ns);
+    }
+    HostCpu_Service();
+}
+
+void HostCpu_SleepUntil_ns(uint64_t time_ns)
+{
+    while ((0U != s_numPending) && (0U == s_primask) && (s_pending[HostCpu_Next()].due_ns <= time_ns))
+    {
+        HostCpu_WaitForInterrupt();
+    }
+    if (time_ns > s_now_ns)
+    {
+        s_sleep_ns += time_ns - s_now_ns;
+        HostCpu_Tick(time_ns - s_now_ns);
+    }
+}
+
+bool HostCpu_InIsr(void)
+{
+    return s_inIsr;
+}
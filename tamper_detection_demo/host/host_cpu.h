@@ -0,0 +1,106 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file host_cpu.h
+ * @brief The host_cpu.h file declares the simulated core of the host build: a clock counting core cycles and
+ *        nanoseconds, PRIMASK, and the interrupts raised by the simulated peripherals. An interrupt falls due a
+ *        set time after it is raised and is taken at the same points as on the target: when PRIMASK is cleared,
+ *        on __WFI, which sleeps until the next one is due, and in the __NOP of a busy wait, which spins awake
+ *        until the next one is due.
+ */
+
+#ifndef HOST_CPU_H_
+#define HOST_CPU_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/*! @brief Core clock of the simulated MCU, the MCXW71 runs at 96 MHz. */
+#define HOST_CPU_CLOCK_HZ (96000000U)
+
+/*! @brief Interrupts which can be pending at the same time. */
+#define HOST_CPU_MAX_PENDING (8U)
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief Interrupt handler of a simulated peripheral, arg is the value given to HostCpu_Pend. */
+typedef void (*hostirqhandler_t)(uint32_t arg);
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+/*! @brief Resets the clock and the sleep time to 0, clears PRIMASK and drops the pending interrupts. */
+void HostCpu_Reset(void);
+
+/*! @brief       Returns the simulated time.
+ *  @return      nanoseconds since the last HostCpu_Reset.
+ */
+uint64_t HostCpu_Now_ns(void);
+
+/*! @brief       Returns the time spent asleep in __WFI, the rest of HostCpu_Now_ns is CPU time.
+ *  @return      nanoseconds since the last HostCpu_Reset.
+ */
+uint64_t HostCpu_Sleep_ns(void);
+
+/*! @brief       Returns the simulated time in core cycles, the value DWT->CYCCNT reads.
+ *  @return      core cycles since the last HostCpu_Reset, wrapping at 32 bits.
+ */
+uint32_t HostCpu_Cycles(void);
+
+/*! @brief       Lets simulated time pass with the CPU running, then takes the interrupts that fell due.
+ *  @param[in]   ns  nanoseconds to add.
+ */
+void HostCpu_Advance_ns(uint64_t ns);
+
+/*! @brief       Masks the interrupts, DisableGlobalIRQ() on the host.
+ *  @return      the previous PRIMASK, for HostCpu_EnableIrq.
+ */
+uint32_t HostCpu_DisableIrq(void);
+
+/*! @brief       Restores PRIMASK, EnableGlobalIRQ() on the host. Takes the interrupts due once unmasked.
+ *  @param[in]   primask  value returned by HostCpu_DisableIrq.
+ */
+void HostCpu_EnableIrq(uint32_t primask);
+
+/*! @brief       Raises an interrupt.
+ *  @param[in]   handler   interrupt handler.
+ *  @param[in]   arg       passed to the handler.
+ *  @param[in]   delay_ns  time from now until it falls due, e.g. the length of a bus transfer.
+ *  @return      true if raised, false if HOST_CPU_MAX_PENDING interrupts are already pending.
+ */
+bool HostCpu_Pend(hostirqhandler_t handler, uint32_t arg, uint64_t delay_ns);
+
+/*! @brief       Takes the interrupts due, unless masked or already in an interrupt.
+ */
+void HostCpu_Service(void);
+
+/*! @brief       __NOP() on the host. Every __NOP() of the code built for the host spins on a flag an interrupt
+ *               sets, so the spin runs in one step up to the next interrupt the core can take, awake. Without one it
+ *               is a single core cycle.
+ */
+void HostCpu_Nop(void);
+
+/*! @brief       __WFI() on the host. Sleeps until the next interrupt falls due, and takes it unless masked.
+ *  @details     Nothing but the simulated peripherals raises interrupts, so with none pending it returns at once.
+ */
+void HostCpu_WaitForInterrupt(void);
+
+/*! @brief       Sleeps until the given time, taking the interrupts that fall due on the way, the idle loop.
+ *  @param[in]   time_ns  time to wake up at, nothing happens if it has passed.
+ */
+void HostCpu_SleepUntil_ns(uint64_t time_ns);
+
+/*! @brief       Tells whether an interrupt handler is running, for code that behaves differently in ISR context.
+ *  @return      true inside a handler called by HostCpu_Service.
+ */
+bool HostCpu_InIsr(void);
+
+#endif /* HOST_CPU_H_ */
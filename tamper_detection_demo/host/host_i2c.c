@@ -0,0 +1,361 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file host_i2c.c
+ * @brief The host_i2c.c file implements Driver_I2C1 of the host build on the register models attached to it.
+ */
+
+#include <stddef.h>
+#include "issdk_hal.h"
+#include "host_cpu.h"
+#include "host_i2c.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Bus clocks of a START or repeated START, and of a STOP. */
+#define HOST_I2C_START_CLOCKS (1U)
+#define HOST_I2C_STOP_CLOCKS  (1U)
+/* Bus clocks of a byte and its ACK. */
+#define HOST_I2C_BYTE_CLOCKS (9U)
+
+/* Core cycles of the LPI2C interrupt handler for one byte, and of the eDMA set up of one transfer. Estimates for the
+ * SDK drivers at HOST_CPU_CLOCK_HZ, override them to match a measurement on the board. */
+#ifndef HOST_I2C_IRQ_CYCLES
+#define HOST_I2C_IRQ_CYCLES (150U)
+#endif
+#ifndef HOST_I2C_DMA_SETUP_CYCLES
+#define HOST_I2C_DMA_SETUP_CYCLES (400U)
+#endif
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+I2C_Type g_hostI2C[2];
+
+static ARM_I2C_SignalEvent_t s_signalEvent;
+static bool s_powered;
+static bool s_busy;
+static uint32_t s_speed_hz = 400000U;
+static int32_t s_dataCount;
+static hosti2ctarget_t *s_pTargets;
+static uint32_t s_failCount;
+static uint32_t s_failEvent;
+static hosti2cstats_t s_stats;
+static hosti2ctransport_t s_transport;
+static uint32_t s_bytesLeft;
+static uint32_t s_pendingEvent;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static uint64_t HostI2C_Clocks_ns(uint32_t clocks)
+{
+    return ((uint64_t)clocks * 1000000000U) / s_speed_hz;
+}
+
+/* The CPU time of one interrupt handler, taken from the code it interrupted. */
+static void HostI2C_Interrupt(void)
+{
+    s_stats.interrupts++;
+    HostCpu_Advance_ns(((uint64_t)HOST_I2C_IRQ_CYCLES * 1000000000U) / HOST_CPU_CLOCK_HZ);
+}
+
+static void HostI2C_Complete(uint32_t event)
+{
+    HostI2C_Interrupt();
+    s_busy = false;
+    if (s_signalEvent != NULL)
+    {
+        s_signalEvent(event);
+    }
+}
+
+/* Interrupt transport, one data byte has gone over the bus. The last one is followed by the completion interrupt
+ * once the STOP, if any, is out. */
+static void HostI2C_ByteDone(uint32_t lastDelay_ns)
+{
+    uint64_t byteTime_ns = HostI2C_Clocks_ns(HOST_I2C_BYTE_CLOCKS);
+
+    /* The bus goes on with the next byte while the handler runs. */
+    if (--s_bytesLeft != 0U)
+    {
+        (void)HostCpu_Pend(HostI2C_ByteDone, lastDelay_ns, byteTime_ns);
+    }
+    else
+    {
+        (void)HostCpu_Pend(HostI2C_Complete, s_pendingEvent, lastDelay_ns);
+    }
+    HostI2C_Interrupt();
+}
+
+static hosti2ctarget_t *HostI2C_Find(uint32_t addr)
+{
+    hosti2ctarget_t *pTarget;
+
+    for (pTarget = s_pTargets; pTarget != NULL; pTarget = pTarget->pNext)
+    {
+        if (pTarget->slaveAddress == (uint16_t)addr)
+        {
+            break;
+        }
+    }
+
+    return pTarget;
+}
+
+/* One MasterTransmit or MasterReceive: the model sees the bytes at once, the Signal Event comes once the bus time has
+ * passed. */
+static int32_t HostI2C_Operation(uint32_t addr, uint8_t *pData, uint32_t num, bool xferPending, bool receive)
+{
+    hosti2ctarget_t *pTarget;
+    uint32_t event = ARM_I2C_EVENT_TRANSFER_DONE;
+    uint64_t time_ns;
+
+    if ((pData == NULL) || (num == 0U))
+    {
+        return ARM_DRIVER_ERROR_PARAMETER;
+    }
+    if (!s_powered)
+    {
+        return ARM_DRIVER_ERROR;
+    }
+    if (s_busy)
+    {
+        s_stats.refused++;
+        return ARM_DRIVER_ERROR_BUSY;
+    }
+
+    pTarget = HostI2C_Find(addr);
+    if (s_failCount != 0U)
+    {
+        s_failCount--;
+        event = s_failEvent;
+    }
+    else if (pTarget == NULL)
+    {
+        event = ARM_I2C_EVENT_ADDRESS_NACK;
+    }
+
+    if (event & ARM_I2C_EVENT_ADDRESS_NACK)
+    {
+        /* Only the address byte goes out, the master sends STOP after the NACK. */
+        time_ns = HostI2C_OperationTime_ns(0U, false);
+        s_dataCount = 0;
+        s_stats.nacks++;
+    }
+    else
+    {
+        if (event == ARM_I2C_EVENT_TRANSFER_DONE)
+        {
+            if (receive)
+            {
+                pTarget->read(pTarget->pModel, pData, num);
+            }
+            else
+            {
+                pTarget->write(pTarget->pModel, pData, num);
+            }
+        }
+        time_ns = HostI2C_OperationTime_ns(num, xferPending);
+        s_dataCount = (int32_t)num;
+        s_stats.bytes += num;
+    }
+    s_stats.transfers++;
+    s_stats.busTime_ns += time_ns;
+
+    s_busy = true;
+    if ((s_transport == HOST_I2C_TRANSPORT_IRQ) && (event == ARM_I2C_EVENT_TRANSFER_DONE))
+    {
+        /* The handler moves every byte, the first interrupt comes after the START, the address and one byte. */
+        s_bytesLeft = num;
+        s_pendingEvent = event;
+        (void)HostCpu_Pend(HostI2C_ByteDone, xferPending ? 0U : (uint32_t)HostI2C_Clocks_ns(HOST_I2C_STOP_CLOCKS),
+                           HostI2C_Clocks_ns(HOST_I2C_START_CLOCKS + 2U * HOST_I2C_BYTE_CLOCKS));
+    }
+    else
+    {
+        if (s_transport == HOST_I2C_TRANSPORT_DMA)
+        {
+            /* The channel descriptors are set up before the transfer starts, then only the completion interrupts. */
+            HostCpu_Advance_ns(((uint64_t)HOST_I2C_DMA_SETUP_CYCLES * 1000000000U) / HOST_CPU_CLOCK_HZ);
+        }
+        (void)HostCpu_Pend(HostI2C_Complete, event, time_ns);
+    }
+
+    return ARM_DRIVER_OK;
+}
+
+static ARM_DRIVER_VERSION HostI2C_GetVersion(void)
+{
+    ARM_DRIVER_VERSION version = {ARM_I2C_API_VERSION, ARM_DRIVER_VERSION_MAJOR_MINOR(1, 0)};
+
+    return version;
+}
+
+static ARM_I2C_CAPABILITIES HostI2C_GetCapabilities(void)
+{
+    ARM_I2C_CAPABILITIES capabilities = {0};
+
+    return capabilities;
+}
+
+static int32_t HostI2C_Initialize(ARM_I2C_SignalEvent_t cb_event)
+{
+    s_signalEvent = cb_event;
+    s_busy = false;
+
+    return ARM_DRIVER_OK;
+}
+
+static int32_t HostI2C_Uninitialize(void)
+{
+    s_signalEvent = NULL;
+    s_powered = false;
+
+    return ARM_DRIVER_OK;
+}
+
+static int32_t HostI2C_PowerControl(ARM_POWER_STATE state)
+{
+    if (state == ARM_POWER_LOW)
+    {
+        return ARM_DRIVER_ERROR_UNSUPPORTED;
+    }
+    s_powered = (state == ARM_POWER_FULL);
+
+    return ARM_DRIVER_OK;
+}
+
+static int32_t HostI2C_MasterTransmit(uint32_t addr, const uint8_t *data, uint32_t num, bool xfer_pending)
+{
+    return HostI2C_Operation(addr, (uint8_t *)data, num, xfer_pending, false);
+}
+
+static int32_t HostI2C_MasterReceive(uint32_t addr, uint8_t *data, uint32_t num, bool xfer_pending)
+{
+    return HostI2C_Operation(addr, data, num, xfer_pending, true);
+}
+
+static int32_t HostI2C_SlaveTransmit(const uint8_t *data, uint32_t num)
+{
+    (void)data;
+    (void)num;
+
+    return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+static int32_t HostI2C_SlaveReceive(uint8_t *data, uint32_t num)
+{
+    (void)data;
+    (void)num;
+
+    return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+static int32_t HostI2C_GetDataCount(void)
+{
+    return s_dataCount;
+}
+
+static int32_t HostI2C_Control(uint32_t control, uint32_t arg)
+{
+    switch (control)
+    {
+        case ARM_I2C_OWN_ADDRESS:
+            break;
+        case ARM_I2C_BUS_SPEED:
+            switch (arg)
+            {
+                case ARM_I2C_BUS_SPEED_STANDARD:
+                    s_speed_hz = 100000U;
+                    break;
+                case ARM_I2C_BUS_SPEED_FAST:
+                    s_speed_hz = 400000U;
+                    break;
+                case ARM_I2C_BUS_SPEED_FAST_PLUS:
+                    s_speed_hz = 1000000U;
+                    break;
+                default:
+                    return ARM_DRIVER_ERROR_UNSUPPORTED;
+            }
+            break;
+        case ARM_I2C_BUS_CLEAR:
+            break;
+        case ARM_I2C_ABORT_TRANSFER:
+            /* The operation has ended by the time its Signal Event is raised, nothing is left to abort. */
+            break;
+        default:
+            return ARM_DRIVER_ERROR_UNSUPPORTED;
+    }
+
+    return ARM_DRIVER_OK;
+}
+
+static ARM_I2C_STATUS HostI2C_GetStatus(void)
+{
+    ARM_I2C_STATUS status = {0};
+
+    status.busy = s_busy ? 1U : 0U;
+    status.mode = 1U;
+
+    return status;
+}
+
+ARM_DRIVER_I2C Driver_I2C1 = {HostI2C_GetVersion,     HostI2C_GetCapabilities, HostI2C_Initialize,
+                              HostI2C_Uninitialize,   HostI2C_PowerControl,    HostI2C_MasterTransmit,
+                              HostI2C_MasterReceive,  HostI2C_SlaveTransmit,   HostI2C_SlaveReceive,
+                              HostI2C_GetDataCount,   HostI2C_Control,         HostI2C_GetStatus};
+
+void HostI2C_Reset(void)
+{
+    s_pTargets = NULL;
+    s_busy = false;
+    s_speed_hz = 400000U;
+    s_failCount = 0U;
+    s_transport = HOST_I2C_TRANSPORT_IRQ;
+    HostI2C_ClearStats();
+}
+
+void HostI2C_Attach(hosti2ctarget_t *pTarget)
+{
+    pTarget->pNext = s_pTargets;
+    s_pTargets = pTarget;
+}
+
+void HostI2C_SetTransport(hosti2ctransport_t transport)
+{
+    s_transport = transport;
+}
+
+void HostI2C_FailNext(uint32_t count, uint32_t event)
+{
+    s_failCount = count;
+    s_failEvent = event;
+}
+
+void HostI2C_GetStats(hosti2cstats_t *pStats)
+{
+    *pStats = s_stats;
+}
+
+void HostI2C_ClearStats(void)
+{
+    s_stats = (hosti2cstats_t){0};
+}
+
+uint64_t HostI2C_OperationTime_ns(uint32_t num, bool xferPending)
+{
+    uint32_t clocks = HOST_I2C_START_CLOCKS + HOST_I2C_BYTE_CLOCKS * (1U + num);
+
+    if (!xferPending)
+    {
+        clocks += HOST_I2C_STOP_CLOCKS;
+    }
+
+    return HostI2C_Clocks_ns(clocks);
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file host_i2c.h
+ * @brief The host_i2c.h file declares the simulated I2C bus of the host build, Driver_I2C1. Transfers go to the
+ *        register model attached at the slave address, their bus time is counted at the configured
+ *        ARM_I2C_BUS_SPEED and the Signal Event is raised as an interrupt of host_cpu.h once the time has passed.
+ */
+
+#ifndef HOST_I2C_H_
+#define HOST_I2C_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "Driver_I2C.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief A device on the simulated bus, embedded in its register model. */
+typedef struct _host_i2c_target
+{
+    struct _host_i2c_target *pNext; /*!< Next device on the bus. */
+    uint16_t slaveAddress;          /*!< 7-bit address the device acknowledges. */
+    void *pModel;                   /*!< Register model, passed back to write and read. */
+    /*! Master write, pData[0] is the register pointer, the bytes that follow are written from it. */
+    void (*write)(void *pModel, const uint8_t *pData, uint32_t num);
+    /*! Master read from the register pointer. */
+    void (*read)(void *pModel, uint8_t *pData, uint32_t num);
+} hosti2ctarget_t;
+
+/*! @brief How the driver moves the data, as selected by RTE_I2C1_DMA_EN on the board. */
+typedef enum
+{
+    HOST_I2C_TRANSPORT_IRQ = 0, /*!< fsl_lpi2c_cmsis interrupt path, one interrupt per data byte. */
+    HOST_I2C_TRANSPORT_DMA = 1, /*!< fsl_lpi2c_edma path, the channel set up then one completion interrupt. */
+} hosti2ctransport_t;
+
+/*! @brief Bus statistics. */
+typedef struct
+{
+    uint32_t transfers;  /*!< MasterTransmit and MasterReceive calls the bus accepted. */
+    uint32_t bytes;      /*!< Data bytes moved, the address bytes not included. */
+    uint32_t nacks;      /*!< Transfers ended by an address NACK, no device or an injected fault. */
+    uint32_t refused;    /*!< Calls refused because a transfer was in progress. */
+    uint32_t interrupts; /*!< Driver interrupts taken, per byte and completion. */
+    uint64_t busTime_ns; /*!< Time the bus was driven, START to STOP. */
+} hosti2cstats_t;
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+/*! @brief Detaches every device, clears the statistics and faults, sets the speed to ARM_I2C_BUS_SPEED_FAST and the
+ *         transport to HOST_I2C_TRANSPORT_IRQ. */
+void HostI2C_Reset(void);
+
+/*! @brief       Puts a device on the bus.
+ *  @param[in]   pTarget  device, kept until the next HostI2C_Reset.
+ */
+void HostI2C_Attach(hosti2ctarget_t *pTarget);
+
+/*! @brief       Selects the transport of the next transfers. The bus time is the same, the CPU time differs.
+ *  @param[in]   transport  interrupt per byte or eDMA.
+ */
+void HostI2C_SetTransport(hosti2ctransport_t transport);
+
+/*! @brief       Makes the next transfers end with an error event instead of reaching the device.
+ *  @param[in]   count  number of transfers to fail.
+ *  @param[in]   event  Signal Event they end with, e.g. ARM_I2C_EVENT_ADDRESS_NACK.
+ */
+void HostI2C_FailNext(uint32_t count, uint32_t event);
+
+/*! @brief       Reads the bus statistics.
+ *  @param[out]  pStats  statistics since the last HostI2C_Reset or HostI2C_ClearStats.
+ */
+void HostI2C_GetStats(hosti2cstats_t *pStats);
+
+/*! @brief Clears the bus statistics. */
+void HostI2C_ClearStats(void);
+
+/*! @brief       Bus time of one operation at the configured speed.
+ *  @param[in]   num           data bytes after the address byte.
+ *  @param[in]   xferPending   the operation ends without STOP, the next one starts with a repeated START.
+ *  @return      nanoseconds.
+ */
+uint64_t HostI2C_OperationTime_ns(uint32_t num, bool xferPending);
+
+#endif /* HOST_I2C_H_ */
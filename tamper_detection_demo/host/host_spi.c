@@ -0,0 +1,298 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file host_spi.c
+ * @brief The host_spi.c file implements Driver_SPI1 of the host build on the register models attached to it.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "issdk_hal.h"
+#include "host_cpu.h"
+#include "host_spi.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Bus clocks of a byte, 8 bit frames. */
+#define HOST_SPI_BYTE_CLOCKS (8U)
+/* Depth of the LPSPI transmit and receive FIFOs, in frames. */
+#define HOST_SPI_FIFO_SIZE (4U)
+
+/* Core cycles of the LPSPI interrupt handler for one FIFO, and of the eDMA set up of one transfer. Estimates for the
+ * SDK drivers at HOST_CPU_CLOCK_HZ, override them to match a measurement on the board. */
+#ifndef HOST_SPI_IRQ_CYCLES
+#define HOST_SPI_IRQ_CYCLES (250U)
+#endif
+#ifndef HOST_SPI_DMA_SETUP_CYCLES
+#define HOST_SPI_DMA_SETUP_CYCLES (600U)
+#endif
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static ARM_SPI_SignalEvent_t s_signalEvent;
+static bool s_powered;
+static bool s_busy;
+static uint32_t s_speed_hz = 1000000U;
+static uint32_t s_dataCount;
+static hostspitarget_t *s_pTargets;
+static hostspistats_t s_stats;
+static hostspitransport_t s_transport;
+static uint32_t s_bytesLeft;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/* The CPU time of one interrupt handler, taken from the code it interrupted. */
+static void HostSPI_Interrupt(void)
+{
+    s_stats.interrupts++;
+    HostCpu_Advance_ns(((uint64_t)HOST_SPI_IRQ_CYCLES * 1000000000U) / HOST_CPU_CLOCK_HZ);
+}
+
+static void HostSPI_Complete(uint32_t event)
+{
+    s_busy = false;
+    if (s_signalEvent != NULL)
+    {
+        s_signalEvent(event);
+    }
+}
+
+/* eDMA transport, the channel completion interrupt. */
+static void HostSPI_DmaDone(uint32_t event)
+{
+    HostSPI_Interrupt();
+    HostSPI_Complete(event);
+}
+
+/* Interrupt transport, a FIFO of frames has gone over the bus. The handler empties the receive FIFO and refills the
+ * transmit one, the last one ends the transfer. */
+static void HostSPI_FifoDone(uint32_t event)
+{
+    uint32_t chunk = (s_bytesLeft < HOST_SPI_FIFO_SIZE) ? s_bytesLeft : HOST_SPI_FIFO_SIZE;
+
+    s_bytesLeft -= chunk;
+    if (s_bytesLeft != 0U)
+    {
+        chunk = (s_bytesLeft < HOST_SPI_FIFO_SIZE) ? s_bytesLeft : HOST_SPI_FIFO_SIZE;
+        (void)HostCpu_Pend(HostSPI_FifoDone, event, HostSPI_TransferTime_ns(chunk));
+    }
+    HostSPI_Interrupt();
+    if (s_bytesLeft == 0U)
+    {
+        HostSPI_Complete(event);
+    }
+}
+
+static hostspitarget_t *HostSPI_Selected(void)
+{
+    hostspitarget_t *pTarget;
+
+    for (pTarget = s_pTargets; pTarget != NULL; pTarget = pTarget->pNext)
+    {
+        if (pTarget->pSelect->level == 0U)
+        {
+            break;
+        }
+    }
+
+    return pTarget;
+}
+
+static ARM_DRIVER_VERSION HostSPI_GetVersion(void)
+{
+    ARM_DRIVER_VERSION version = {ARM_SPI_API_VERSION, ARM_DRIVER_VERSION_MAJOR_MINOR(1, 0)};
+
+    return version;
+}
+
+static ARM_SPI_CAPABILITIES HostSPI_GetCapabilities(void)
+{
+    ARM_SPI_CAPABILITIES capabilities = {0};
+
+    return capabilities;
+}
+
+static int32_t HostSPI_Initialize(ARM_SPI_SignalEvent_t cb_event)
+{
+    s_signalEvent = cb_event;
+    s_busy = false;
+
+    return ARM_DRIVER_OK;
+}
+
+static int32_t HostSPI_Uninitialize(void)
+{
+    s_signalEvent = NULL;
+    s_powered = false;
+
+    return ARM_DRIVER_OK;
+}
+
+static int32_t HostSPI_PowerControl(ARM_POWER_STATE state)
+{
+    if (state == ARM_POWER_LOW)
+    {
+        return ARM_DRIVER_ERROR_UNSUPPORTED;
+    }
+    s_powered = (state == ARM_POWER_FULL);
+
+    return ARM_DRIVER_OK;
+}
+
+static int32_t HostSPI_Send(const void *data, uint32_t num)
+{
+    (void)data;
+    (void)num;
+
+    return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+static int32_t HostSPI_Receive(void *data, uint32_t num)
+{
+    (void)data;
+    (void)num;
+
+    return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+/* The model sees the frame at once, the Signal Event comes once the bus time has passed. */
+static int32_t HostSPI_Transfer(const void *data_out, void *data_in, uint32_t num)
+{
+    hostspitarget_t *pTarget;
+    uint32_t chunk;
+
+    if ((data_out == NULL) || (data_in == NULL) || (num == 0U))
+    {
+        return ARM_DRIVER_ERROR_PARAMETER;
+    }
+    if (!s_powered)
+    {
+        return ARM_DRIVER_ERROR;
+    }
+    if (s_busy)
+    {
+        s_stats.refused++;
+        return ARM_DRIVER_ERROR_BUSY;
+    }
+
+    pTarget = HostSPI_Selected();
+    if (pTarget != NULL)
+    {
+        pTarget->transfer(pTarget->pModel, (const uint8_t *)data_out, (uint8_t *)data_in, num);
+    }
+    else
+    {
+        /* Nobody drives MISO, the pull-up reads back. */
+        memset(data_in, 0xFF, num);
+        s_stats.unselected++;
+    }
+    s_dataCount = num;
+    s_stats.transfers++;
+    s_stats.bytes += num;
+    s_stats.busTime_ns += HostSPI_TransferTime_ns(num);
+
+    s_busy = true;
+    if (s_transport == HOST_SPI_TRANSPORT_IRQ)
+    {
+        s_bytesLeft = num;
+        chunk = (num < HOST_SPI_FIFO_SIZE) ? num : HOST_SPI_FIFO_SIZE;
+        (void)HostCpu_Pend(HostSPI_FifoDone, ARM_SPI_EVENT_TRANSFER_COMPLETE, HostSPI_TransferTime_ns(chunk));
+    }
+    else
+    {
+        /* The receive and transmit channels are set up before the transfer starts, then only the completion. */
+        HostCpu_Advance_ns(((uint64_t)HOST_SPI_DMA_SETUP_CYCLES * 1000000000U) / HOST_CPU_CLOCK_HZ);
+        (void)HostCpu_Pend(HostSPI_DmaDone, ARM_SPI_EVENT_TRANSFER_COMPLETE, HostSPI_TransferTime_ns(num));
+    }
+
+    return ARM_DRIVER_OK;
+}
+
+static uint32_t HostSPI_GetDataCount(void)
+{
+    return s_dataCount;
+}
+
+static int32_t HostSPI_Control(uint32_t control, uint32_t arg)
+{
+    switch (control & ARM_SPI_CONTROL_Msk)
+    {
+        case ARM_SPI_MODE_INACTIVE:
+            break;
+        case ARM_SPI_MODE_MASTER:
+        case ARM_SPI_SET_BUS_SPEED:
+            if (arg == 0U)
+            {
+                return ARM_DRIVER_ERROR_PARAMETER;
+            }
+            s_speed_hz = arg;
+            break;
+        case ARM_SPI_GET_BUS_SPEED:
+            return (int32_t)s_speed_hz;
+        case ARM_SPI_SET_DEFAULT_TX_VALUE:
+            break;
+        case ARM_SPI_ABORT_TRANSFER:
+            /* The transfer has ended by the time its Signal Event is raised, nothing is left to abort. */
+            break;
+        default:
+            /* ARM_SPI_CONTROL_SS included, the chip selects are GPIOs. */
+            return ARM_DRIVER_ERROR_UNSUPPORTED;
+    }
+
+    return ARM_DRIVER_OK;
+}
+
+static ARM_SPI_STATUS HostSPI_GetStatus(void)
+{
+    ARM_SPI_STATUS status = {0};
+
+    status.busy = s_busy ? 1U : 0U;
+
+    return status;
+}
+
+ARM_DRIVER_SPI Driver_SPI1 = {HostSPI_GetVersion, HostSPI_GetCapabilities, HostSPI_Initialize,   HostSPI_Uninitialize,
+                              HostSPI_PowerControl, HostSPI_Send,         HostSPI_Receive,      HostSPI_Transfer,
+                              HostSPI_GetDataCount, HostSPI_Control,      HostSPI_GetStatus};
+
+void HostSPI_Reset(void)
+{
+    s_pTargets = NULL;
+    s_busy = false;
+    s_speed_hz = 1000000U;
+    s_transport = HOST_SPI_TRANSPORT_IRQ;
+    HostSPI_ClearStats();
+}
+
+void HostSPI_Attach(hostspitarget_t *pTarget)
+{
+    pTarget->pNext = s_pTargets;
+    s_pTargets = pTarget;
+}
+
+void HostSPI_SetTransport(hostspitransport_t transport)
+{
+    s_transport = transport;
+}
+
+void HostSPI_GetStats(hostspistats_t *pStats)
+{
+    *pStats = s_stats;
+}
+
+void HostSPI_ClearStats(void)
+{
+    s_stats = (hostspistats_t){0};
+}
+
+uint64_t HostSPI_TransferTime_ns(uint32_t num)
+{
+    return ((uint64_t)num * HOST_SPI_BYTE_CLOCKS * 1000000000U) / s_speed_hz;
+}
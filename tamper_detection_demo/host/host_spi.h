@@ -0,0 +1,85 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file host_spi.h
+ * @brief The host_spi.h file declares the simulated SPI bus of the host build, Driver_SPI1. The chip selects are
+ *        GPIO pins of gpio_driver.h driven by register_io_spi.c, a transfer goes to the device whose chip select is
+ *        low. Its bus time is counted at the bus speed set by ARM_SPI_MODE_MASTER and the Signal Event is raised as
+ *        an interrupt of host_cpu.h once the time has passed.
+ */
+
+#ifndef HOST_SPI_H_
+#define HOST_SPI_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "Driver_SPI.h"
+#include "gpio_driver.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief A device on the simulated bus, embedded in its register model. */
+typedef struct _host_spi_target
+{
+    struct _host_spi_target *pNext; /*!< Next device on the bus. */
+    gpioHandleKSDK_t *pSelect;      /*!< Active low chip select of the device. */
+    void *pModel;                   /*!< Register model, passed back to transfer. */
+    /*! Full duplex frame, pOut is what the master shifts out, pIn what the device shifts back. */
+    void (*transfer)(void *pModel, const uint8_t *pOut, uint8_t *pIn, uint32_t num);
+} hostspitarget_t;
+
+/*! @brief How the driver moves the data, as selected by RTE_SPI1_DMA_EN on the board. */
+typedef enum
+{
+    HOST_SPI_TRANSPORT_IRQ = 0, /*!< fsl_lpspi_cmsis interrupt path, one interrupt per FIFO of data. */
+    HOST_SPI_TRANSPORT_DMA = 1, /*!< fsl_lpspi_edma path, the channels set up then one completion interrupt. */
+} hostspitransport_t;
+
+/*! @brief Bus statistics. */
+typedef struct
+{
+    uint32_t transfers;  /*!< Transfer calls the bus accepted. */
+    uint32_t bytes;      /*!< Bytes shifted, the command header of the device included. */
+    uint32_t unselected; /*!< Transfers no chip select was low for, they read 0xFF. */
+    uint32_t refused;    /*!< Calls refused because a transfer was in progress. */
+    uint32_t interrupts; /*!< Driver interrupts taken, per FIFO and completion. */
+    uint64_t busTime_ns; /*!< Time the clock was running. */
+} hostspistats_t;
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+/*! @brief Detaches every device, clears the statistics, sets the speed to 1 MHz and the transport to
+ *         HOST_SPI_TRANSPORT_IRQ. */
+void HostSPI_Reset(void);
+
+/*! @brief       Puts a device on the bus.
+ *  @param[in]   pTarget  device, kept until the next HostSPI_Reset.
+ */
+void HostSPI_Attach(hostspitarget_t *pTarget);
+
+/*! @brief       Selects the transport of the next transfers. The bus time is the same, the CPU time differs.
+ *  @param[in]   transport  interrupt per FIFO or eDMA.
+ */
+void HostSPI_SetTransport(hostspitransport_t transport);
+
+/*! @brief       Reads the bus statistics.
+ *  @param[out]  pStats  statistics since the last HostSPI_Reset or HostSPI_ClearStats.
+ */
+void HostSPI_GetStats(hostspistats_t *pStats);
+
+/*! @brief Clears the bus statistics. */
+void HostSPI_ClearStats(void);
+
+/*! @brief       Bus time of one transfer at the configured speed.
+ *  @param[in]   num  bytes shifted.
+ *  @return      nanoseconds.
+ */
+uint64_t HostSPI_TransferTime_ns(uint32_t num);
+
+#endif /* HOST_SPI_H_ */
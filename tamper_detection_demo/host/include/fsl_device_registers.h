@@ -0,0 +1,64 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file fsl_device_registers.h
+ * @brief Host build replacement of the device header: the core intrinsics, PRIMASK and the DWT cycle counter
+ *        used by the application modules, backed by the simulated core in host_cpu.h.
+ */
+
+#ifndef FSL_DEVICE_REGISTERS_H_
+#define FSL_DEVICE_REGISTERS_H_
+
+#include <stdint.h>
+#include <string.h> /* Pulled in by fsl_common.h on the target. */
+#include "host_cpu.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+typedef struct
+{
+    volatile uint32_t CTRL;   /*!< Control, CYCCNTENA is accepted and ignored. */
+    volatile uint32_t CYCCNT; /*!< Core cycles, advanced by the simulated clock. */
+} DWT_Type;
+
+typedef struct
+{
+    volatile uint32_t DEMCR; /*!< Debug Exception and Monitor Control, TRCENA is accepted and ignored. */
+} DCB_Type;
+
+extern DWT_Type g_hostDwt;
+extern DCB_Type g_hostDcb;
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define DWT (&g_hostDwt)
+#define DCB (&g_hostDcb)
+#define DWT_CTRL_CYCCNTENA_Msk (1UL)
+#define DCB_DEMCR_TRCENA_Msk   (1UL << 24)
+
+#define __NOP() HostCpu_Nop()
+#define __WFI() HostCpu_WaitForInterrupt()
+#define __DSB() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __DMB() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __ISB() __asm__ volatile("" ::: "memory")
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+static inline uint32_t DisableGlobalIRQ(void)
+{
+    return HostCpu_DisableIrq();
+}
+
+static inline void EnableGlobalIRQ(uint32_t primask)
+{
+    HostCpu_EnableIrq(primask);
+}
+
+#endif /* FSL_DEVICE_REGISTERS_H_ */
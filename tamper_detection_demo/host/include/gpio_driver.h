@@ -0,0 +1,41 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file gpio_driver.h
+ * @brief Host build replacement of the KSDK GPIO driver header. The pins only record their level.
+ */
+
+#ifndef __DRIVER_GPIO_H__
+#define __DRIVER_GPIO_H__
+
+/* The target header reaches the device header through fsl_common.h. */
+#include "fsl_device_registers.h"
+#include "Driver_Common.h"
+#include "Driver_GPIO.h"
+
+/*! @brief Pin configuration of fsl_gpio.h, the wakeup headers declare the LED configuration with it. */
+typedef enum _gpio_pin_direction
+{
+    kGPIO_DigitalInput = 0U,
+    kGPIO_DigitalOutput = 1U,
+} gpio_pin_direction_t;
+
+typedef struct _gpio_pin_config
+{
+    gpio_pin_direction_t pinDirection;
+    uint8_t outputLogic;
+} gpio_pin_config_t;
+
+/*! @brief A pin of the host build, pinID_t points to one. */
+typedef struct gpioHandleKSDK
+{
+    uint32_t level; /*!< Last level written. */
+} gpioHandleKSDK_t;
+
+extern GENERIC_DRIVER_GPIO Driver_GPIO_KSDK;
+
+#endif // __DRIVER_GPIO_H__
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*! \file issdk_hal.h
+    \brief Host build replacement of the board HAL wrapper.
+
+    The sensor buses are the simulated I2C1 of host_i2c.h and SPI1 of host_spi.h, under the same names as on the
+    FRDM-MCXW71 so the sensor drivers, register_io_i2c.c and register_io_spi.c build unchanged.
+*/
+
+#ifndef __ISSDK_HAL_H__
+#define __ISSDK_HAL_H__
+
+#include "fsl_device_registers.h"
+#include "Driver_I2C.h"
+#include "Driver_SPI.h"
+
+/* Peripheral instances, only their number and addresses matter to register_io_i2c.c and register_io_spi.c. */
+typedef struct
+{
+    uint32_t reserved;
+} I2C_Type;
+
+typedef struct
+{
+    uint32_t reserved;
+} SPI_Type;
+
+extern I2C_Type g_hostI2C[2];
+extern SPI_Type g_hostSPI[2];
+
+#define I2C0          (&g_hostI2C[0])
+#define I2C1          (&g_hostI2C[1])
+#define I2C_BASE_PTRS {I2C0, I2C1}
+#define SPI0          (&g_hostSPI[0])
+#define SPI1          (&g_hostSPI[1])
+#define SPI_BASE_PTRS {SPI0, SPI1}
+
+extern ARM_DRIVER_I2C Driver_I2C1;
+extern ARM_DRIVER_SPI Driver_SPI1;
+
+// I2C_S2 is the shield bus of frdmmcxw7x.h, here it runs the register models.
+#define I2C_S2_DRIVER       Driver_I2C1
+#define I2C_S2_DEVICE_INDEX I2C1_INDEX
+#define I2C_S2_SIGNAL_EVENT I2C1_SignalEvent_t
+
+#ifndef I2C_S_DRIVER
+#define I2C_S_DRIVER       I2C_S2_DRIVER
+#define I2C_S_SIGNAL_EVENT I2C_S2_SIGNAL_EVENT
+#define I2C_S_DEVICE_INDEX I2C_S2_DEVICE_INDEX
+#endif
+
+// SPI_S is the shield SPI of frdmmcxw7x.h, the FXLS8974 of FXLS8974_SPI_MODE.
+#define SPI_S_DRIVER       Driver_SPI1
+#define SPI_S_DEVICE_INDEX SPI1_INDEX
+#define SPI_S_SIGNAL_EVENT SPI1_SignalEvent_t
+
+// The register_io_i2c.c bus profiler counts simulated core cycles.
+#define REGISTER_I2C_PROFILE_NOW() HostCpu_Cycles()
+
+#endif // __ISSDK_HAL_H__
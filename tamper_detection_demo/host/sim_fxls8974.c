@@ -0,0 +1,381 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file sim_fxls8974.c
+ * @brief The sim_fxls8974.c file implements the FXLS8974 register model of the host build.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "sim_fxls8974.h"
+#include "fxls8974.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define SIM_FXLS8974_SAMPLE_BYTES (6U)
+/* R/W bit and address, then a don't care byte, ahead of the data of an SPI frame. */
+#define SIM_FXLS8974_SPI_HEADER (2U)
+#define SIM_FXLS8974_SPI_READ   (0x80U)
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static int16_t SimFxls8974_Threshold(const simfxls8974_t *pModel, uint8_t lsb)
+{
+    uint16_t raw = (uint16_t)(((uint16_t)(pModel->reg[lsb + 1U] & 0x0FU) << 8) | pModel->reg[lsb]);
+
+    /* 12-bit two's complement. */
+    return (int16_t)((int16_t)(raw << 4) >> 4);
+}
+
+static void SimFxls8974_Reset(simfxls8974_t *pModel)
+{
+    memset(pModel->reg, 0, sizeof(pModel->reg));
+    pModel->reg[FXLS8974_WHO_AM_I] = pModel->whoAmI;
+    pModel->reg[FXLS8974_INT_STATUS] = FXLS8974_INT_STATUS_SRC_BOOT_MASK;
+    pModel->pointer = 0U;
+    pModel->bufferHead = 0U;
+    pModel->bufferCount = 0U;
+    pModel->referenceValid = false;
+    pModel->debounce = 0U;
+    pModel->idleSamples = 0U;
+}
+
+static void SimFxls8974_SetMode(simfxls8974_t *pModel, uint8_t mode)
+{
+    pModel->reg[FXLS8974_SYS_MODE] = (uint8_t)((pModel->reg[FXLS8974_SYS_MODE] & ~0x03U) | mode);
+}
+
+static void SimFxls8974_UpdateBufStatus(simfxls8974_t *pModel)
+{
+    uint8_t watermark = pModel->reg[FXLS8974_BUF_CONFIG2] & FXLS8974_BUF_CONFIG2_BUF_WMRK_MASK;
+    uint8_t status = pModel->reg[FXLS8974_BUF_STATUS] & FXLS8974_BUF_STATUS_BUF_OVF_MASK;
+
+    status |= pModel->bufferCount;
+    if ((watermark != 0U) && (pModel->bufferCount >= watermark))
+    {
+        status |= FXLS8974_BUF_STATUS_BUF_WMRK_MASK;
+        pModel->reg[FXLS8974_INT_STATUS] |= FXLS8974_INT_STATUS_SRC_BUF_MASK;
+    }
+    pModel->reg[FXLS8974_BUF_STATUS] = status;
+}
+
+static void SimFxls8974_Buffer(simfxls8974_t *pModel, const int16_t *pSample)
+{
+    uint8_t mode = pModel->reg[FXLS8974_BUF_CONFIG1] & FXLS8974_BUF_CONFIG1_BUF_MODE_MASK;
+    uint8_t tail;
+
+    if (mode == FXLS8974_BUF_CONFIG1_BUF_MODE_DIS)
+    {
+        return;
+    }
+    if (pModel->bufferCount == SIM_FXLS8974_BUFFER_DEPTH)
+    {
+        pModel->reg[FXLS8974_BUF_STATUS] |= FXLS8974_BUF_STATUS_BUF_OVF_MASK;
+        pModel->reg[FXLS8974_INT_STATUS] |= FXLS8974_INT_STATUS_SRC_OVF_MASK;
+        if (mode != FXLS8974_BUF_CONFIG1_BUF_MODE_STREAM_MODE)
+        {
+            /* Stop and trigger mode keep the oldest samples. */
+            return;
+        }
+        pModel->bufferHead = (uint8_t)((pModel->bufferHead + 1U) % SIM_FXLS8974_BUFFER_DEPTH);
+        pModel->bufferCount--;
+    }
+    tail = (uint8_t)((pModel->bufferHead + pModel->bufferCount) % SIM_FXLS8974_BUFFER_DEPTH);
+    memcpy(pModel->buffer[tail], pSample, sizeof(pModel->buffer[tail]));
+    pModel->bufferCount++;
+    SimFxls8974_UpdateBufStatus(pModel);
+}
+
+/* SDCD outside-thresholds function, returns true on an event. */
+static bool SimFxls8974_Sdcd(simfxls8974_t *pModel, const int16_t *pSample)
+{
+    static const uint8_t axisEnable[3] = {FXLS8974_SDCD_CONFIG1_X_OT_EN_MASK, FXLS8974_SDCD_CONFIG1_Y_OT_EN_MASK,
+                                          FXLS8974_SDCD_CONFIG1_Z_OT_EN_MASK};
+    static const uint8_t axisFlag[3] = {FXLS8974_SDCD_INT_SRC1_X_OT_EF_MASK, FXLS8974_SDCD_INT_SRC1_Y_OT_EF_MASK,
+                                        FXLS8974_SDCD_INT_SRC1_Z_OT_EF_MASK};
+    static const uint8_t axisPolarity[3] = {FXLS8974_SDCD_INT_SRC1_X_OT_POL_MASK, FXLS8974_SDCD_INT_SRC1_Y_OT_POL_MASK,
+                                            FXLS8974_SDCD_INT_SRC1_Z_OT_POL_MASK};
+    uint8_t config1 = pModel->reg[FXLS8974_SDCD_CONFIG1];
+    uint8_t config2 = pModel->reg[FXLS8974_SDCD_CONFIG2];
+    uint8_t refMode = config2 & FXLS8974_SDCD_CONFIG2_REF_UPDM_MASK;
+    int16_t lower = SimFxls8974_Threshold(pModel, FXLS8974_SDCD_LTHS_LSB);
+    int16_t upper = SimFxls8974_Threshold(pModel, FXLS8974_SDCD_UTHS_LSB);
+    uint8_t source = 0U;
+    int32_t value;
+    uint8_t axis;
+
+    if (!(config2 & FXLS8974_SDCD_CONFIG2_SDCD_EN_MASK))
+    {
+        return false;
+    }
+    if (refMode == FXLS8974_SDCD_CONFIG2_REF_UPDM_FIXED_VAL)
+    {
+        memset(pModel->reference, 0, sizeof(pModel->reference));
+        pModel->referenceValid = true;
+    }
+    else if (!pModel->referenceValid)
+    {
+        /* The first sample after enabling is the reference, it cannot be outside the band itself. */
+        memcpy(pModel->reference, pSample, sizeof(pModel->reference));
+        pModel->referenceValid = true;
+        return false;
+    }
+
+    for (axis = 0U; axis < 3U; axis++)
+    {
+        if (!(config1 & axisEnable[axis]))
+        {
+            continue;
+        }
+        value = (int32_t)pSample[axis] - pModel->reference[axis];
+        if (value > upper)
+        {
+            source |= axisFlag[axis] | axisPolarity[axis];
+        }
+        else if (value < lower)
+        {
+            source |= axisFlag[axis];
+        }
+    }
+
+    if (source == 0U)
+    {
+        if (config2 & FXLS8974_SDCD_CONFIG2_OT_DBCTM_MASK)
+        {
+            pModel->debounce = 0U;
+        }
+        else if (pModel->debounce != 0U)
+        {
+            pModel->debounce--;
+        }
+        return false;
+    }
+    if (pModel->debounce < pModel->reg[FXLS8974_SDCD_OT_DBCNT])
+    {
+        pModel->debounce++;
+        return false;
+    }
+
+    pModel->reg[FXLS8974_SDCD_INT_SRC1] |= source | FXLS8974_SDCD_INT_SRC1_OT_EA_MASK;
+    pModel->reg[FXLS8974_INT_STATUS] |= FXLS8974_INT_STATUS_SRC_SDCD_OT_MASK;
+    if (refMode == FXLS8974_SDCD_CONFIG2_REF_UPDM_SDCD_REF)
+    {
+        memcpy(pModel->reference, pSample, sizeof(pModel->reference));
+    }
+
+    return true;
+}
+
+static void SimFxls8974_Write(void *pContext, const uint8_t *pData, uint32_t num)
+{
+    simfxls8974_t *pModel = (simfxls8974_t *)pContext;
+    uint8_t wasActive = pModel->reg[FXLS8974_SENS_CONFIG1] & FXLS8974_SENS_CONFIG1_ACTIVE_MASK;
+    uint8_t reg;
+    uint32_t i;
+
+    pModel->pointer = pData[0];
+    for (i = 1U; i < num; i++)
+    {
+        reg = pModel->pointer++;
+        if (reg >= SIM_FXLS8974_REGISTERS)
+        {
+            continue;
+        }
+        if ((reg == FXLS8974_SENS_CONFIG1) && (pData[i] & FXLS8974_SENS_CONFIG1_RST_MASK))
+        {
+            SimFxls8974_Reset(pModel);
+            return;
+        }
+        /* Status, output and identification registers are read only. */
+        if ((reg <= FXLS8974_SYS_MODE) || (reg == FXLS8974_SDCD_INT_SRC1) || (reg == FXLS8974_SDCD_INT_SRC2) ||
+            (reg == FXLS8974_ORIENT_STATUS))
+        {
+            continue;
+        }
+        pModel->reg[reg] = pData[i];
+        if (reg == FXLS8974_SDCD_CONFIG2)
+        {
+            pModel->referenceValid = false;
+        }
+    }
+
+    if (!wasActive && (pModel->reg[FXLS8974_SENS_CONFIG1] & FXLS8974_SENS_CONFIG1_ACTIVE_MASK))
+    {
+        SimFxls8974_SetMode(pModel, FXLS8974_SYS_MODE_SYS_MODE_WAKE);
+        pModel->idleSamples = 0U;
+        pModel->referenceValid = false;
+        pModel->debounce = 0U;
+    }
+    else if (wasActive && !(pModel->reg[FXLS8974_SENS_CONFIG1] & FXLS8974_SENS_CONFIG1_ACTIVE_MASK))
+    {
+        SimFxls8974_SetMode(pModel, FXLS8974_SYS_MODE_SYS_MODE_STANDBY);
+    }
+}
+
+static void SimFxls8974_Read(void *pContext, uint8_t *pData, uint32_t num)
+{
+    simfxls8974_t *pModel = (simfxls8974_t *)pContext;
+    uint8_t reg;
+    uint8_t byte;
+    uint32_t i;
+
+    for (i = 0U; i < num; i++)
+    {
+        reg = pModel->pointer;
+        if ((reg >= FXLS8974_BUF_X_LSB) && (reg <= FXLS8974_BUF_Z_MSB))
+        {
+            /* The buffer window streams the oldest sample, the pointer wraps back to BUF_X_LSB after each one. */
+            byte = reg - FXLS8974_BUF_X_LSB;
+            if (pModel->bufferCount != 0U)
+            {
+                pData[i] = (uint8_t)((uint16_t)pModel->buffer[pModel->bufferHead][byte >> 1] >> ((byte & 1U) * 8U));
+            }
+            else
+            {
+                pData[i] = 0U;
+            }
+            if (byte == SIM_FXLS8974_SAMPLE_BYTES - 1U)
+            {
+                if (pModel->bufferCount != 0U)
+                {
+                    pModel->bufferHead = (uint8_t)((pModel->bufferHead + 1U) % SIM_FXLS8974_BUFFER_DEPTH);
+                    pModel->bufferCount--;
+                    pModel->reg[FXLS8974_BUF_STATUS] &= (uint8_t)~FXLS8974_BUF_STATUS_BUF_OVF_MASK;
+                    SimFxls8974_UpdateBufStatus(pModel);
+                }
+                pModel->pointer = FXLS8974_BUF_X_LSB;
+            }
+            else
+            {
+                pModel->pointer++;
+            }
+            continue;
+        }
+
+        pData[i] = (reg < SIM_FXLS8974_REGISTERS) ? pModel->reg[reg] : 0U;
+        /* The event sources clear on read. */
+        if ((reg == FXLS8974_INT_STATUS) || (reg == FXLS8974_SDCD_INT_SRC1) || (reg == FXLS8974_SDCD_INT_SRC2))
+        {
+            pModel->reg[reg] = 0U;
+        }
+        pModel->pointer++;
+    }
+}
+
+/* One SPI frame, decoded into the same register accesses as an I2C write or read. */
+static void SimFxls8974_Transfer(void *pContext, const uint8_t *pOut, uint8_t *pIn, uint32_t num)
+{
+    simfxls8974_t *pModel = (simfxls8974_t *)pContext;
+    uint8_t write[1U + UINT8_MAX];
+    uint32_t length;
+
+    memset(pIn, 0, (num < SIM_FXLS8974_SPI_HEADER) ? num : SIM_FXLS8974_SPI_HEADER);
+    if (num <= SIM_FXLS8974_SPI_HEADER)
+    {
+        return;
+    }
+    length = num - SIM_FXLS8974_SPI_HEADER;
+    if (pOut[0] & SIM_FXLS8974_SPI_READ)
+    {
+        pModel->pointer = pOut[0] & (uint8_t)~SIM_FXLS8974_SPI_READ;
+        SimFxls8974_Read(pModel, &pIn[SIM_FXLS8974_SPI_HEADER], length);
+    }
+    else
+    {
+        if (length > UINT8_MAX)
+        {
+            length = UINT8_MAX;
+        }
+        write[0] = pOut[0];
+        memcpy(&write[1], &pOut[SIM_FXLS8974_SPI_HEADER], length);
+        SimFxls8974_Write(pModel, write, length + 1U);
+        memset(&pIn[SIM_FXLS8974_SPI_HEADER], 0, num - SIM_FXLS8974_SPI_HEADER);
+    }
+}
+
+void SimFxls8974_Init(simfxls8974_t *pModel, uint16_t slaveAddress, uint8_t whoAmI)
+{
+    memset(pModel, 0, sizeof(simfxls8974_t));
+    pModel->whoAmI = whoAmI;
+    SimFxls8974_Reset(pModel);
+
+    pModel->target.slaveAddress = slaveAddress;
+    pModel->target.pModel = pModel;
+    pModel->target.write = SimFxls8974_Write;
+    pModel->target.read = SimFxls8974_Read;
+    HostI2C_Attach(&pModel->target);
+}
+
+void SimFxls8974_AttachSpi(simfxls8974_t *pModel, gpioHandleKSDK_t *pSelect)
+{
+    pModel->spiTarget.pSelect = pSelect;
+    pModel->spiTarget.pModel = pModel;
+    pModel->spiTarget.transfer = SimFxls8974_Transfer;
+    HostSPI_Attach(&pModel->spiTarget);
+}
+
+void SimFxls8974_Sample(simfxls8974_t *pModel, int16_t x, int16_t y, int16_t z)
+{
+    const int16_t sample[3] = {x, y, z};
+    uint16_t aslpCount;
+    uint8_t mode = SimFxls8974_SysMode(pModel);
+    bool event;
+    uint8_t axis;
+
+    if (mode == FXLS8974_SYS_MODE_SYS_MODE_STANDBY)
+    {
+        return;
+    }
+    pModel->samples++;
+
+    for (axis = 0U; axis < 3U; axis++)
+    {
+        pModel->reg[FXLS8974_OUT_X_LSB + 2U * axis] = (uint8_t)sample[axis];
+        pModel->reg[FXLS8974_OUT_X_MSB + 2U * axis] = (uint8_t)((uint16_t)sample[axis] >> 8);
+    }
+    pModel->reg[FXLS8974_INT_STATUS] |= FXLS8974_INT_STATUS_SRC_DRDY_MASK;
+    SimFxls8974_Buffer(pModel, sample);
+
+    event = SimFxls8974_Sdcd(pModel, sample) &&
+            (pModel->reg[FXLS8974_SENS_CONFIG4] & FXLS8974_SENS_CONFIG4_WK_SDCD_OT_MASK);
+
+    /* Auto-wake/sleep, enabled by a non zero ASLP_COUNT. */
+    aslpCount = (uint16_t)((uint16_t)pModel->reg[FXLS8974_ASLP_COUNT_MSB] << 8 | pModel->reg[FXLS8974_ASLP_COUNT_LSB]);
+    if (event)
+    {
+        pModel->idleSamples = 0U;
+        if (mode == FXLS8974_SYS_MODE_SYS_MODE_SLEEP)
+        {
+            SimFxls8974_SetMode(pModel, FXLS8974_SYS_MODE_SYS_MODE_WAKE);
+            pModel->wakeEvents++;
+        }
+    }
+    else if ((aslpCount != 0U) && (mode == FXLS8974_SYS_MODE_SYS_MODE_WAKE))
+    {
+        if (++pModel->idleSamples >= aslpCount)
+        {
+            SimFxls8974_SetMode(pModel, FXLS8974_SYS_MODE_SYS_MODE_SLEEP);
+            pModel->reg[FXLS8974_INT_STATUS] |= FXLS8974_INT_STATUS_SRC_ASLP_MASK;
+        }
+    }
+}
+
+uint8_t SimFxls8974_SysMode(const simfxls8974_t *pModel)
+{
+    return pModel->reg[FXLS8974_SYS_MODE] & 0x03U;
+}
+
+bool SimFxls8974_WakeOut(const simfxls8974_t *pModel)
+{
+    bool asserted = (pModel->reg[FXLS8974_INT_EN] & FXLS8974_INT_EN_WAKE_OUT_EN_MASK) &&
+                    (SimFxls8974_SysMode(pModel) == FXLS8974_SYS_MODE_SYS_MODE_WAKE);
+    bool activeHigh = (pModel->reg[FXLS8974_SENS_CONFIG4] & FXLS8974_SENS_CONFIG4_INT_POL_MASK) != 0U;
+
+    return asserted == activeHigh;
+}
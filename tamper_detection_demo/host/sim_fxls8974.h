@@ -0,0 +1,94 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file sim_fxls8974.h
+ * @brief The sim_fxls8974.h file declares the register model of the FXLS8974 accelerometer on the host I2C bus,
+ *        and on the host SPI bus once attached there.
+ *        Modelled: the output and INT_STATUS registers, the SDCD outside-thresholds function with its
+ *        reference modes and debounce counter, the auto-wake/sleep state machine reported in SYS_MODE and on
+ *        WAKE_OUT, and the 32 sample output buffer in stream and stop mode. Not modelled: the vector magnitude
+ *        SDCD mode, the within-thresholds event, orientation, self test and the output data rate, the model
+ *        converts one sample per SimFxls8974_Sample call.
+ */
+
+#ifndef SIM_FXLS8974_H_
+#define SIM_FXLS8974_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "host_i2c.h"
+#include "host_spi.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/*! @brief Registers of the model, the last is SELF_TEST_CONFIG2. */
+#define SIM_FXLS8974_REGISTERS (0x39U)
+
+/*! @brief Depth of the output buffer. */
+#define SIM_FXLS8974_BUFFER_DEPTH (32U)
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief This structure holds the state of one FXLS8974. */
+typedef struct
+{
+    hosti2ctarget_t target;                          /*!< Bus attachment. */
+    hostspitarget_t spiTarget;                       /*!< SPI bus attachment. */
+    uint8_t reg[SIM_FXLS8974_REGISTERS];             /*!< Register file. */
+    uint8_t pointer;                                 /*!< Register pointer of the next read or write. */
+    uint8_t whoAmI;                                  /*!< WHO_AM_I after reset. */
+    int16_t buffer[SIM_FXLS8974_BUFFER_DEPTH][3];    /*!< Output buffer, X/Y/Z. */
+    uint8_t bufferHead;                              /*!< Oldest buffered sample. */
+    uint8_t bufferCount;                             /*!< Buffered samples. */
+    int16_t reference[3];                            /*!< SDCD reference. */
+    bool referenceValid;                             /*!< The reference has been captured. */
+    uint8_t debounce;                                /*!< SDCD outside-thresholds debounce counter. */
+    uint16_t idleSamples;                            /*!< WAKE samples without a wake event, for ASLP_COUNT. */
+    uint32_t samples;                                /*!< Samples converted while active. */
+    uint32_t wakeEvents;                             /*!< SLEEP to WAKE transitions. */
+} simfxls8974_t;
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+/*! @brief       Resets the model and puts it on the host I2C bus.
+ *  @param[in]   pModel        model to initialize.
+ *  @param[in]   slaveAddress  I2C address, e.g. FXLS8974_DEVICE_ADDRESS_SA0_1.
+ *  @param[in]   whoAmI        WHO_AM_I of the part, one of the FXLS89xx values.
+ */
+void SimFxls8974_Init(simfxls8974_t *pModel, uint16_t slaveAddress, uint8_t whoAmI);
+
+/*! @brief       Also puts the model on the host SPI bus. A frame is the R/W bit and the register address, a don't
+ *               care byte, then the data, the register pointer behaves as on I2C.
+ *  @param[in]   pModel   model initialized by SimFxls8974_Init.
+ *  @param[in]   pSelect  chip select pin, active low.
+ */
+void SimFxls8974_AttachSpi(simfxls8974_t *pModel, gpioHandleKSDK_t *pSelect);
+
+/*! @brief       Converts one sample, no effect in standby.
+ *  @param[in]   pModel  model.
+ *  @param[in]   x       X acceleration, 12-bit counts.
+ *  @param[in]   y       Y acceleration, 12-bit counts.
+ *  @param[in]   z       Z acceleration, 12-bit counts.
+ */
+void SimFxls8974_Sample(simfxls8974_t *pModel, int16_t x, int16_t y, int16_t z);
+
+/*! @brief       Returns the operating mode as SYS_MODE reports it.
+ *  @param[in]   pModel  model.
+ *  @return      FXLS8974_SYS_MODE_SYS_MODE_STANDBY, _WAKE or _SLEEP.
+ */
+uint8_t SimFxls8974_SysMode(const simfxls8974_t *pModel);
+
+/*! @brief       Returns the pin level of the WAKE_OUT signal, routed to INT1 unless INT_PIN_SEL moves it.
+ *  @param[in]   pModel  model.
+ *  @return      true for a high level. WAKE_OUT is asserted while enabled and in WAKE, INT_POL sets the level.
+ */
+bool SimFxls8974_WakeOut(const simfxls8974_t *pModel);
+
+#endif /* SIM_FXLS8974_H_ */
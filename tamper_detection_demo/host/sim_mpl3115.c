@@ -0,0 +1,251 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file sim_mpl3115.c
+ * @brief The sim_mpl3115.c file implements the MPL3115 register model of the host build.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "sim_mpl3115.h"
+#include "mpl3115.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* P_TGT and P_WND count in 2 Pa steps, the samples in 1/4 Pa. */
+#define SIM_MPL3115_TARGET_SCALE (8U)
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void SimMpl3115_Reset(simmpl3115_t *pModel)
+{
+    memset(pModel->reg, 0, sizeof(pModel->reg));
+    pModel->reg[MPL3115_WHO_AM_I] = pModel->whoAmI;
+    pModel->pointer = 0U;
+    pModel->fifoHead = 0U;
+    pModel->fifoCount = 0U;
+    pModel->fifoByte = 0U;
+    pModel->windowValid = false;
+}
+
+static bool SimMpl3115_Active(const simmpl3115_t *pModel)
+{
+    return (pModel->reg[MPL3115_CTRL_REG1] & MPL3115_CTRL_REG1_SBYB_MASK) != 0U;
+}
+
+static void SimMpl3115_UpdateFifoStatus(simmpl3115_t *pModel)
+{
+    uint8_t watermark = pModel->reg[MPL3115_F_SETUP] & MPL3115_F_SETUP_F_WMRK_MASK;
+    uint8_t status = pModel->reg[MPL3115_F_STATUS] & MPL3115_F_STATUS_F_OVF_MASK;
+
+    status |= pModel->fifoCount;
+    if ((watermark != 0U) && (pModel->fifoCount >= watermark))
+    {
+        status |= MPL3115_F_STATUS_F_WMKF_FLAG_MASK;
+    }
+    pModel->reg[MPL3115_F_STATUS] = status;
+    if (status & (MPL3115_F_STATUS_F_OVF_MASK | MPL3115_F_STATUS_F_WMKF_FLAG_MASK))
+    {
+        pModel->reg[MPL3115_INT_SOURCE] |= MPL3115_INT_SOURCE_SRC_FIFO_MASK;
+    }
+}
+
+static void SimMpl3115_Fifo(simmpl3115_t *pModel)
+{
+    uint8_t mode = pModel->reg[MPL3115_F_SETUP] & MPL3115_F_SETUP_F_MODE_MASK;
+    uint8_t tail;
+
+    if (mode == MPL3115_F_SETUP_F_MODE_FIFO_OFF)
+    {
+        return;
+    }
+    if (pModel->fifoCount == SIM_MPL3115_FIFO_DEPTH)
+    {
+        pModel->reg[MPL3115_F_STATUS] |= MPL3115_F_STATUS_F_OVF_MASK;
+        pModel->overflows++;
+        if (mode == MPL3115_F_SETUP_F_MODE_STOP_MODE)
+        {
+            SimMpl3115_UpdateFifoStatus(pModel);
+            return;
+        }
+        /* Circular mode drops the oldest entry, a partly read one included. */
+        pModel->fifoHead = (uint8_t)((pModel->fifoHead + 1U) % SIM_MPL3115_FIFO_DEPTH);
+        pModel->fifoCount--;
+        pModel->fifoByte = 0U;
+    }
+    tail = (uint8_t)((pModel->fifoHead + pModel->fifoCount) % SIM_MPL3115_FIFO_DEPTH);
+    memcpy(pModel->fifo[tail], &pModel->reg[MPL3115_OUT_P_MSB], SIM_MPL3115_SAMPLE_BYTES);
+    pModel->fifoCount++;
+    SimMpl3115_UpdateFifoStatus(pModel);
+}
+
+static void SimMpl3115_Window(simmpl3115_t *pModel, uint32_t pressure)
+{
+    uint32_t target =
+        ((uint32_t)pModel->reg[MPL3115_P_TGT_MSB] << 8 | pModel->reg[MPL3115_P_TGT_LSB]) * SIM_MPL3115_TARGET_SCALE;
+    uint32_t window =
+        ((uint32_t)pModel->reg[MPL3115_P_WND_MSB] << 8 | pModel->reg[MPL3115_P_WND_LSB]) * SIM_MPL3115_TARGET_SCALE;
+    uint32_t distance = (pressure > target) ? (pressure - target) : (target - pressure);
+    bool outside = distance > window;
+    bool above = pressure > target;
+
+    if (target == 0U)
+    {
+        pModel->windowValid = false;
+        return;
+    }
+    /* Both events fire on a crossing, not on the level. */
+    if (pModel->windowValid)
+    {
+        if ((window != 0U) && (outside != pModel->outsideWindow))
+        {
+            pModel->reg[MPL3115_INT_SOURCE] |= MPL3115_INT_SOURCE_SRC_PW_MASK;
+        }
+        if (above != pModel->aboveTarget)
+        {
+            pModel->reg[MPL3115_INT_SOURCE] |= MPL3115_INT_SOURCE_SRC_PTH_MASK;
+        }
+    }
+    pModel->outsideWindow = outside;
+    pModel->aboveTarget = above;
+    pModel->windowValid = true;
+}
+
+static void SimMpl3115_Write(void *pContext, const uint8_t *pData, uint32_t num)
+{
+    simmpl3115_t *pModel = (simmpl3115_t *)pContext;
+    uint8_t reg;
+    uint32_t i;
+
+    pModel->pointer = pData[0];
+    for (i = 1U; i < num; i++)
+    {
+        reg = pModel->pointer++;
+        if (reg >= SIM_MPL3115_REGISTERS)
+        {
+            continue;
+        }
+        if ((reg == MPL3115_CTRL_REG1) && (pData[i] & MPL3115_CTRL_REG1_RST_MASK))
+        {
+            SimMpl3115_Reset(pModel);
+            return;
+        }
+        /* Output, status and identification registers are read only. */
+        if ((reg <= MPL3115_F_STATUS) || (reg == MPL3115_SYSMOD) || (reg == MPL3115_INT_SOURCE) ||
+            ((reg >= MPL3115_P_MIN_MSB) && (reg <= MPL3115_T_MAX_LSB)))
+        {
+            continue;
+        }
+        pModel->reg[reg] = pData[i];
+        if ((reg >= MPL3115_P_TGT_MSB) && (reg <= MPL3115_P_WND_LSB))
+        {
+            pModel->windowValid = false;
+        }
+    }
+    pModel->reg[MPL3115_SYSMOD] = SimMpl3115_Active(pModel) ? MPL3115_SYSMOD_SYSMOD_MASK : 0U;
+}
+
+static void SimMpl3115_Read(void *pContext, uint8_t *pData, uint32_t num)
+{
+    simmpl3115_t *pModel = (simmpl3115_t *)pContext;
+    uint8_t reg;
+    uint32_t i;
+
+    for (i = 0U; i < num; i++)
+    {
+        reg = pModel->pointer;
+        if (reg == MPL3115_F_DATA)
+        {
+            /* The pointer stays on F_DATA, every SIM_MPL3115_SAMPLE_BYTES bytes pop an entry. */
+            if (pModel->fifoCount == 0U)
+            {
+                pData[i] = 0U;
+                continue;
+            }
+            pData[i] = pModel->fifo[pModel->fifoHead][pModel->fifoByte++];
+            if (pModel->fifoByte == SIM_MPL3115_SAMPLE_BYTES)
+            {
+                pModel->fifoByte = 0U;
+                pModel->fifoHead = (uint8_t)((pModel->fifoHead + 1U) % SIM_MPL3115_FIFO_DEPTH);
+                pModel->fifoCount--;
+                SimMpl3115_UpdateFifoStatus(pModel);
+            }
+            continue;
+        }
+
+        pData[i] = (reg < SIM_MPL3115_REGISTERS) ? pModel->reg[reg] : 0U;
+        if (reg == MPL3115_F_STATUS)
+        {
+            /* Reading F_STATUS clears the overflow flag and the FIFO interrupt. */
+            pModel->reg[MPL3115_F_STATUS] &= (uint8_t)~MPL3115_F_STATUS_F_OVF_MASK;
+            pModel->reg[MPL3115_INT_SOURCE] &= (uint8_t)~MPL3115_INT_SOURCE_SRC_FIFO_MASK;
+        }
+        else if (reg == MPL3115_OUT_P_MSB)
+        {
+            /* Reading the pressure clears the data ready flags and the pressure events. */
+            pModel->reg[MPL3115_STATUS] = 0U;
+            pModel->reg[MPL3115_DR_STATUS] = 0U;
+            pModel->reg[MPL3115_INT_SOURCE] &= (uint8_t)~(MPL3115_INT_SOURCE_SRC_DRDY_MASK |
+                                                          MPL3115_INT_SOURCE_SRC_PW_MASK |
+                                                          MPL3115_INT_SOURCE_SRC_PTH_MASK);
+        }
+        pModel->pointer = (uint8_t)(pModel->pointer + 1U);
+    }
+}
+
+void SimMpl3115_Init(simmpl3115_t *pModel, uint16_t slaveAddress, uint8_t whoAmI)
+{
+    memset(pModel, 0, sizeof(simmpl3115_t));
+    pModel->whoAmI = whoAmI;
+    SimMpl3115_Reset(pModel);
+
+    pModel->target.slaveAddress = slaveAddress;
+    pModel->target.pModel = pModel;
+    pModel->target.write = SimMpl3115_Write;
+    pModel->target.read = SimMpl3115_Read;
+    HostI2C_Attach(&pModel->target);
+}
+
+void SimMpl3115_Sample(simmpl3115_t *pModel, uint32_t pressure, int16_t temperature)
+{
+    uint32_t raw = (pressure & 0xFFFFFU) << 4;
+    uint8_t ready = MPL3115_DR_STATUS_TDR_MASK | MPL3115_DR_STATUS_PDR_MASK | MPL3115_DR_STATUS_PTDR_MASK;
+
+    if (!SimMpl3115_Active(pModel))
+    {
+        return;
+    }
+    pModel->samples++;
+
+    /* Data not read since the last sample is overwritten. */
+    if (pModel->reg[MPL3115_DR_STATUS] & MPL3115_DR_STATUS_PTDR_MASK)
+    {
+        ready |= MPL3115_DR_STATUS_TOW_MASK | MPL3115_DR_STATUS_POW_MASK | MPL3115_DR_STATUS_PTOW_MASK;
+    }
+    pModel->reg[MPL3115_OUT_P_MSB] = (uint8_t)(raw >> 16);
+    pModel->reg[MPL3115_OUT_P_CSB] = (uint8_t)(raw >> 8);
+    pModel->reg[MPL3115_OUT_P_LSB] = (uint8_t)raw;
+    pModel->reg[MPL3115_OUT_T_MSB] = (uint8_t)((uint16_t)temperature >> 8);
+    pModel->reg[MPL3115_OUT_T_LSB] = (uint8_t)temperature & 0xF0U;
+    pModel->reg[MPL3115_DR_STATUS] = ready;
+    pModel->reg[MPL3115_STATUS] = ready;
+    pModel->reg[MPL3115_INT_SOURCE] |= MPL3115_INT_SOURCE_SRC_DRDY_MASK;
+
+    SimMpl3115_Window(pModel, pressure);
+    SimMpl3115_Fifo(pModel);
+}
+
+bool SimMpl3115_Int1(const simmpl3115_t *pModel)
+{
+    bool asserted =
+        (pModel->reg[MPL3115_INT_SOURCE] & pModel->reg[MPL3115_CTRL_REG4] & pModel->reg[MPL3115_CTRL_REG5]) != 0U;
+    bool activeHigh = (pModel->reg[MPL3115_CTRL_REG3] & MPL3115_CTRL_REG3_IPOL1_MASK) != 0U;
+
+    return asserted == activeHigh;
+}
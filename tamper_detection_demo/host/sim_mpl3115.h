@@ -0,0 +1,79 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file sim_mpl3115.h
+ * @brief The sim_mpl3115.h file declares the register model of the MPL3115/FXPQ3115 pressure sensor on the host
+ *        I2C bus. Modelled: barometer mode output and data ready flags, the 32 sample FIFO in circular and stop
+ *        mode with its watermark and overflow flags, and the pressure target and window events. Not modelled:
+ *        altimeter mode, the temperature events, the min/max registers, offsets and oversampling timing, the
+ *        model converts one sample per SimMpl3115_Sample call.
+ */
+
+#ifndef SIM_MPL3115_H_
+#define SIM_MPL3115_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "host_i2c.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/*! @brief Registers of the model, the last is OFF_H. */
+#define SIM_MPL3115_REGISTERS (0x2EU)
+
+/*! @brief Depth of the FIFO. */
+#define SIM_MPL3115_FIFO_DEPTH (32U)
+
+/*! @brief Bytes of a FIFO entry, 3 of pressure and 2 of temperature. */
+#define SIM_MPL3115_SAMPLE_BYTES (5U)
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief This structure holds the state of one MPL3115. */
+typedef struct
+{
+    hosti2ctarget_t target;                                            /*!< Bus attachment. */
+    uint8_t reg[SIM_MPL3115_REGISTERS];                                /*!< Register file. */
+    uint8_t pointer;                                                   /*!< Register pointer of the next access. */
+    uint8_t whoAmI;                                                    /*!< WHO_AM_I after reset. */
+    uint8_t fifo[SIM_MPL3115_FIFO_DEPTH][SIM_MPL3115_SAMPLE_BYTES];    /*!< FIFO entries, register layout. */
+    uint8_t fifoHead;                                                  /*!< Oldest entry. */
+    uint8_t fifoCount;                                                 /*!< Entries queued. */
+    uint8_t fifoByte;                                                  /*!< Next byte of the oldest entry on F_DATA. */
+    bool outsideWindow;                                                /*!< Last sample was outside the window. */
+    bool aboveTarget;                                                  /*!< Last sample was above the target. */
+    bool windowValid;                                                  /*!< outsideWindow and aboveTarget are set. */
+    uint32_t samples;                                                  /*!< Samples converted while active. */
+    uint32_t overflows;                                                /*!< Samples the FIFO lost or dropped. */
+} simmpl3115_t;
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+/*! @brief       Resets the model and puts it on the host I2C bus.
+ *  @param[in]   pModel        model to initialize.
+ *  @param[in]   slaveAddress  I2C address, MPL3115_I2C_ADDRESS.
+ *  @param[in]   whoAmI        MPL3115_WHOAMI_VALUE or FXPQ3115_WHOAMI_VALUE.
+ */
+void SimMpl3115_Init(simmpl3115_t *pModel, uint16_t slaveAddress, uint8_t whoAmI);
+
+/*! @brief       Converts one sample, no effect in standby.
+ *  @param[in]   pModel       model.
+ *  @param[in]   pressure     pressure, 1/4 Pa, 20 bits.
+ *  @param[in]   temperature  temperature, 1/256 degC, the model keeps 1/16 degC.
+ */
+void SimMpl3115_Sample(simmpl3115_t *pModel, uint32_t pressure, int16_t temperature);
+
+/*! @brief       Returns the level of the INT1 pin, the sources routed to it by CTRL_REG5 and enabled by CTRL_REG4.
+ *  @param[in]   pModel  model.
+ *  @return      true for a high level, CTRL_REG3 IPOL1 sets the polarity.
+ */
+bool SimMpl3115_Int1(const simmpl3115_t *pModel);
+
+#endif /* SIM_MPL3115_H_ */
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file sim_nmh1000.c
+ * @brief The sim_nmh1000.c file implements the NMH1000 register model of the host build.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "sim_nmh1000.h"
+#include "nmh1000.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Largest in range OUT_M_REG value. */
+#define SIM_NMH1000_RANGE (0x1FU)
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void SimNmh1000_Reset(simnmh1000_t *pModel)
+{
+    uint8_t address = pModel->reg[NMH1000_I2C_ADDR];
+
+    memset(pModel->reg, 0, sizeof(pModel->reg));
+    pModel->reg[NMH1000_STATUS] = NMH1000_STATUS_OPMODE_USER_MODE | NMH1000_STATUS_MDR_DATA_NOT_AVAILABLE;
+    pModel->reg[NMH1000_WHO_AM_I] = NMH1000_WHO_AM_I_VALUE;
+    pModel->reg[NMH1000_I2C_ADDR] = address;
+    pModel->pointer = 0U;
+}
+
+/* STATUS.OUTPUT follows OUT_B through the V_POL polarity. */
+static void SimNmh1000_UpdateOutput(simnmh1000_t *pModel)
+{
+    bool asserted = (pModel->reg[NMH1000_STATUS] & NMH1000_STATUS_OUT_B_MASK) != 0U;
+    bool invert = (pModel->reg[NMH1000_CONTROL_REG1] & NMH1000_CONTROL_REG1_V_POL_MASK) != 0U;
+
+    if (asserted != invert)
+    {
+        pModel->reg[NMH1000_STATUS] |= NMH1000_STATUS_OUTPUT_MASK;
+    }
+    else
+    {
+        pModel->reg[NMH1000_STATUS] &= (uint8_t)~NMH1000_STATUS_OUTPUT_MASK;
+    }
+}
+
+static void SimNmh1000_Write(void *pContext, const uint8_t *pData, uint32_t num)
+{
+    simnmh1000_t *pModel = (simnmh1000_t *)pContext;
+    uint8_t reg;
+    uint32_t i;
+
+    pModel->pointer = pData[0];
+    for (i = 1U; i < num; i++)
+    {
+        reg = pModel->pointer++;
+        if (reg >= SIM_NMH1000_REGISTERS)
+        {
+            continue;
+        }
+        if ((reg == NMH1000_CONTROL_REG1) && (pData[i] & NMH1000_CONTROL_REG1_RST_MASK))
+        {
+            SimNmh1000_Reset(pModel);
+            return;
+        }
+        /* Status, output and identification registers are read only. */
+        if ((reg == NMH1000_STATUS) || (reg == NMH1000_OUT_M_REG) || (reg == NMH1000_WHO_AM_I) ||
+            (reg == NMH1000_RESERVED1) || (reg == NMH1000_RESERVED2) || (reg == NMH1000_I2C_ADDR))
+        {
+            continue;
+        }
+        pModel->reg[reg] = pData[i];
+    }
+    SimNmh1000_UpdateOutput(pModel);
+}
+
+static void SimNmh1000_Read(void *pContext, uint8_t *pData, uint32_t num)
+{
+    simnmh1000_t *pModel = (simnmh1000_t *)pContext;
+    uint8_t reg;
+    uint32_t i;
+
+    for (i = 0U; i < num; i++)
+    {
+        reg = pModel->pointer++;
+        pData[i] = (reg < SIM_NMH1000_REGISTERS) ? pModel->reg[reg] : 0U;
+        if (reg == NMH1000_OUT_M_REG)
+        {
+            pModel->reg[NMH1000_STATUS] |= NMH1000_STATUS_MDR_DATA_NOT_AVAILABLE;
+        }
+    }
+}
+
+void SimNmh1000_Init(simnmh1000_t *pModel, uint16_t slaveAddress)
+{
+    memset(pModel, 0, sizeof(simnmh1000_t));
+    pModel->reg[NMH1000_I2C_ADDR] = (uint8_t)slaveAddress;
+    SimNmh1000_Reset(pModel);
+
+    pModel->target.slaveAddress = slaveAddress;
+    pModel->target.pModel = pModel;
+    pModel->target.write = SimNmh1000_Write;
+    pModel->target.read = SimNmh1000_Read;
+    HostI2C_Attach(&pModel->target);
+}
+
+void SimNmh1000_Sample(simnmh1000_t *pModel, uint8_t magnitude)
+{
+    uint8_t control = pModel->reg[NMH1000_CONTROL_REG1];
+    uint8_t status = pModel->reg[NMH1000_STATUS];
+
+    if (!(control & (NMH1000_CONTROL_REG1_AUTO_MODE_MASK | NMH1000_CONTROL_REG1_ONE_SHORT_MASK)))
+    {
+        return;
+    }
+    pModel->reg[NMH1000_CONTROL_REG1] = control & (uint8_t)~NMH1000_CONTROL_REG1_ONE_SHORT_MASK;
+    pModel->samples++;
+
+    pModel->reg[NMH1000_OUT_M_REG] = magnitude;
+    status &= (uint8_t)~(NMH1000_STATUS_MDR_MASK | NMH1000_STATUS_MDO_MASK);
+    if (magnitude > SIM_NMH1000_RANGE)
+    {
+        status |= NMH1000_STATUS_MDO_VALIDITY_OUT_OF_RANGE;
+    }
+    /* OUT asserts at the assert threshold and holds until the field falls to the clear threshold. */
+    if (magnitude >= pModel->reg[NMH1000_USER_ASSERT_THRESH])
+    {
+        status |= NMH1000_STATUS_OUT_B_ASSERTED;
+    }
+    else if (magnitude <= pModel->reg[NMH1000_USER_CLEAR_THRESH])
+    {
+        status &= (uint8_t)~NMH1000_STATUS_OUT_B_MASK;
+    }
+    pModel->reg[NMH1000_STATUS] = status;
+    SimNmh1000_UpdateOutput(pModel);
+}
+
+bool SimNmh1000_Out(const simnmh1000_t *pModel)
+{
+    return (pModel->reg[NMH1000_STATUS] & NMH1000_STATUS_OUTPUT_MASK) != 0U;
+}
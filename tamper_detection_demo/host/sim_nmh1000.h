@@ -0,0 +1,61 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file sim_nmh1000.h
+ * @brief The sim_nmh1000.h file declares the register model of the NMH1000 magnetic switch on the host I2C bus.
+ *        Modelled: OUT_M_REG with the data ready and out of range flags, the OUT switch with its assert and
+ *        clear thresholds and polarity, autonomous and one shot conversions. Not modelled: the output data rate,
+ *        the model converts one sample per SimNmh1000_Sample call, and the I2C address change.
+ */
+
+#ifndef SIM_NMH1000_H_
+#define SIM_NMH1000_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "host_i2c.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/*! @brief Registers of the model, the last is I2C_ADDR. */
+#define SIM_NMH1000_REGISTERS (0x0AU)
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief This structure holds the state of one NMH1000. */
+typedef struct
+{
+    hosti2ctarget_t target;             /*!< Bus attachment. */
+    uint8_t reg[SIM_NMH1000_REGISTERS]; /*!< Register file. */
+    uint8_t pointer;                    /*!< Register pointer of the next access. */
+    uint32_t samples;                   /*!< Conversions done. */
+} simnmh1000_t;
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+/*! @brief       Resets the model and puts it on the host I2C bus.
+ *  @param[in]   pModel        model to initialize.
+ *  @param[in]   slaveAddress  I2C address, NMH1000_I2C_ADDR_VAL on the click board.
+ */
+void SimNmh1000_Init(simnmh1000_t *pModel, uint16_t slaveAddress);
+
+/*! @brief       Converts one sample, only in autonomous mode or with a one shot conversion requested.
+ *  @param[in]   pModel     model.
+ *  @param[in]   magnitude  field magnitude in OUT_M_REG counts, above 0x1F is out of range.
+ */
+void SimNmh1000_Sample(simnmh1000_t *pModel, uint8_t magnitude);
+
+/*! @brief       Returns the level of the OUT pin.
+ *  @param[in]   pModel  model.
+ *  @return      true for VOH. OUT is asserted between the assert and the clear threshold, V_POL sets the level.
+ */
+bool SimNmh1000_Out(const simnmh1000_t *pModel);
+
+#endif /* SIM_NMH1000_H_ */
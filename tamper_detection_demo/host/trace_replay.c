@@ -0,0 +1,128 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file trace_replay.c
+ * @brief The trace_replay.c file implements the replay of recorded sensor traces on the host build.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_cpu.h"
+#include "trace_replay.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TRACE_REPLAY_LINE_LENGTH (256U)
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static bool TraceReplay_Parse(tracereplay_t *pTrace, char *pLine, tracesample_t *pSample)
+{
+    char *pEnd;
+    long value;
+    unsigned long time;
+
+    memset(pSample, 0, sizeof(tracesample_t));
+    time = strtoul(pLine, &pEnd, 10);
+    if ((pEnd == pLine) || (time > UINT32_MAX) || ((uint32_t)time < pTrace->lastTime))
+    {
+        return false;
+    }
+    pSample->time_ms = (uint32_t)time;
+    while (*pEnd == ',')
+    {
+        if (pSample->numValues == TRACE_REPLAY_CHANNELS)
+        {
+            return false;
+        }
+        pLine = pEnd + 1;
+        value = strtol(pLine, &pEnd, 10);
+        if ((pEnd == pLine) || (value > INT32_MAX) || (value < INT32_MIN))
+        {
+            return false;
+        }
+        pSample->value[pSample->numValues++] = (int32_t)value;
+    }
+    while ((*pEnd == ' ') || (*pEnd == '\t') || (*pEnd == '\r') || (*pEnd == '\n'))
+    {
+        pEnd++;
+    }
+
+    return (*pEnd == '\0') && (pSample->numValues != 0U);
+}
+
+bool TraceReplay_Open(tracereplay_t *pTrace, const char *pPath)
+{
+    memset(pTrace, 0, sizeof(tracereplay_t));
+    pTrace->pFile = fopen(pPath, "r");
+
+    return pTrace->pFile != NULL;
+}
+
+bool TraceReplay_Next(tracereplay_t *pTrace, tracesample_t *pSample)
+{
+    char line[TRACE_REPLAY_LINE_LENGTH];
+    char *pStart;
+
+    if ((pTrace->pFile == NULL) || pTrace->error)
+    {
+        return false;
+    }
+    while (fgets(line, sizeof(line), pTrace->pFile) != NULL)
+    {
+        pTrace->line++;
+        pStart = line;
+        while ((*pStart == ' ') || (*pStart == '\t'))
+        {
+            pStart++;
+        }
+        if ((*pStart == '#') || (*pStart == '\r') || (*pStart == '\n') || (*pStart == '\0'))
+        {
+            continue;
+        }
+        if (!TraceReplay_Parse(pTrace, pStart, pSample))
+        {
+            pTrace->error = true;
+            return false;
+        }
+        pTrace->lastTime = pSample->time_ms;
+        pTrace->samples++;
+        return true;
+    }
+
+    return false;
+}
+
+uint32_t TraceReplay_Run(tracereplay_t *pTrace, tracereplayfn_t fn, void *pContext)
+{
+    tracesample_t sample;
+    uint32_t replayed = 0U;
+
+    while (TraceReplay_Next(pTrace, &sample))
+    {
+        HostCpu_SleepUntil_ns((uint64_t)sample.time_ms * 1000000U);
+        replayed++;
+        if (!fn(pContext, &sample))
+        {
+            break;
+        }
+    }
+
+    return replayed;
+}
+
+void TraceReplay_Close(tracereplay_t *pTrace)
+{
+    if (pTrace->pFile != NULL)
+    {
+        fclose(pTrace->pFile);
+        pTrace->pFile = NULL;
+    }
+}
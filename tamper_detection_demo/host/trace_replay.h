@@ -0,0 +1,82 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file trace_replay.h
+ * @brief The trace_replay.h file declares the replay of recorded sensor traces on the host build. A trace is a
+ *        text file, one sample per line: the time in ms followed by up to TRACE_REPLAY_CHANNELS values, comma
+ *        separated. Lines starting with # and blank lines are skipped. The replay sleeps the simulated core
+ *        until each sample is due, so the interrupts raised in between are taken in time order.
+ */
+
+#ifndef TRACE_REPLAY_H_
+#define TRACE_REPLAY_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/*! @brief Values of a sample: accel X/Y/Z, or pressure and temperature, or the field magnitude. */
+#define TRACE_REPLAY_CHANNELS (3U)
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief One trace sample. */
+typedef struct
+{
+    uint32_t time_ms;                        /*!< Time since the start of the trace. */
+    int32_t value[TRACE_REPLAY_CHANNELS];    /*!< Sample values, missing ones 0. */
+    uint8_t numValues;                       /*!< Values on the line. */
+} tracesample_t;
+
+/*! @brief This structure holds the state of one replay. */
+typedef struct
+{
+    FILE *pFile;       /*!< Trace being read. */
+    uint32_t line;     /*!< Line number of the last sample read, for error reports. */
+    uint32_t samples;  /*!< Samples read so far. */
+    uint32_t lastTime; /*!< Time of the last sample, samples must not go back in time. */
+    bool error;        /*!< A malformed line ended the replay. */
+} tracereplay_t;
+
+/*! @brief Called for every sample once it is due, returns false to stop the replay. */
+typedef bool (*tracereplayfn_t)(void *pContext, const tracesample_t *pSample);
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+/*! @brief       Opens a trace.
+ *  @param[in]   pTrace  replay to initialize.
+ *  @param[in]   pPath   trace file.
+ *  @return      true on success, false if the file cannot be read.
+ */
+bool TraceReplay_Open(tracereplay_t *pTrace, const char *pPath);
+
+/*! @brief       Reads the next sample without waiting for it to be due.
+ *  @param[in]   pTrace   replay.
+ *  @param[out]  pSample  sample read.
+ *  @return      true if a sample was read, false at the end of the trace or on a malformed line, see error.
+ */
+bool TraceReplay_Next(tracereplay_t *pTrace, tracesample_t *pSample);
+
+/*! @brief       Replays the rest of a trace, sleeping the simulated core until each sample is due.
+ *  @param[in]   pTrace    replay.
+ *  @param[in]   fn        called for every sample.
+ *  @param[in]   pContext  passed to fn.
+ *  @return      number of samples replayed.
+ */
+uint32_t TraceReplay_Run(tracereplay_t *pTrace, tracereplayfn_t fn, void *pContext);
+
+/*! @brief       Closes a trace.
+ *  @param[in]   pTrace  replay.
+ */
+void TraceReplay_Close(tracereplay_t *pTrace);
+
+#endif /* TRACE_REPLAY_H_ */
@@ -0,0 +1,261 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file test_async_queue.c
+ * @brief The test_async_queue.c file checks the asynchronous transfer queue of register_io_i2c.c on the FXLS8974
+ *        register model: Register_I2C_ReadAsync and Register_I2C_WriteAsync complete in submission order, a failed
+ *        transfer reports its error and lets the next one run, Register_I2C_AbortAsync completes every queued
+ *        transfer with REGISTER_I2C_ASYNC_ABORTED, and a blocking call made while the queue owns the bus is refused
+ *        before it reaches the driver.
+ */
+
+#include "test_util.h"
+#include "issdk_hal.h"
+#include "host_cpu.h"
+#include "host_i2c.h"
+#include "sim_fxls8974.h"
+#include "fxls8974_drv.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_XFERS (3U)
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+typedef struct
+{
+    simfxls8974_t model;
+    fxls8974_i2c_sensorhandle_t handle;
+    registercache_t cache;
+    registerasyncxfer_t xfer[TEST_XFERS];
+    uint8_t buffer[TEST_XFERS][4];
+    int32_t status[TEST_XFERS];
+    uint32_t order[TEST_XFERS]; /* Index of each transfer in the completion order. */
+    uint32_t done;
+    bool inIsr;
+} testqueue_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static testqueue_t s_test;
+static const uint8_t s_thresholds[] = {0x34U, 0x01U};
+/* WHO_AM_I, then the two upper threshold registers, one transfer. */
+static const registerreadlist_t cTestReadList[] = {{.readFrom = FXLS8974_WHO_AM_I, .numBytes = 1},
+                                                   {.readFrom = FXLS8974_SDCD_UTHS_LSB, .numBytes = 2},
+                                                   __END_READ_DATA__};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void Test_Callback(int32_t status, void *pParam)
+{
+    uint32_t index = (uint32_t)(uintptr_t)pParam;
+
+    s_test.status[index] = status;
+    s_test.order[s_test.done++] = index;
+    s_test.inIsr &= HostCpu_InIsr();
+}
+
+static void Test_Init(bool cached)
+{
+    uint8_t whoAmI = 0U;
+    uint32_t i;
+
+    memset(&s_test, 0, sizeof(s_test));
+    HostCpu_Reset();
+    HostI2C_Reset();
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.Initialize(I2C_S_SIGNAL_EVENT), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.PowerControl(ARM_POWER_FULL), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.Control(ARM_I2C_BUS_SPEED, ARM_I2C_BUS_SPEED_FAST), ARM_DRIVER_OK);
+    SimFxls8974_Init(&s_test.model, FXLS8974_DEVICE_ADDRESS_SA0_0, FXLS8974_WHOAMI_VALUE);
+    TEST_CHECK_EQUAL(FXLS8974_I2C_Initialize(&s_test.handle, &I2C_S_DRIVER, I2C_S_DEVICE_INDEX,
+                                             FXLS8974_DEVICE_ADDRESS_SA0_0, &whoAmI),
+                     SENSOR_ERROR_NONE);
+    if (cached)
+    {
+        Register_I2C_AttachCache(&s_test.handle.deviceInfo, &s_test.cache);
+    }
+    for (i = 0U; i < TEST_XFERS; i++)
+    {
+        s_test.status[i] = ARM_DRIVER_ERROR_SPECIFIC - 1;
+    }
+    s_test.inIsr = true;
+    HostI2C_ClearStats();
+}
+
+static int32_t Test_Read(uint32_t index)
+{
+    return Register_I2C_ReadAsync(&I2C_S_DRIVER, &s_test.handle.deviceInfo, FXLS8974_DEVICE_ADDRESS_SA0_0,
+                                  &s_test.xfer[index], cTestReadList, s_test.buffer[index], Test_Callback,
+                                  (void *)(uintptr_t)index);
+}
+
+static int32_t Test_Write(uint32_t index, const uint8_t *pValues)
+{
+    return Register_I2C_WriteAsync(&I2C_S_DRIVER, &s_test.handle.deviceInfo, FXLS8974_DEVICE_ADDRESS_SA0_0,
+                                   &s_test.xfer[index], FXLS8974_SDCD_UTHS_LSB, pValues, 2U, Test_Callback,
+                                   (void *)(uintptr_t)index);
+}
+
+/* The application idles in WFI until the queue is empty. */
+static void Test_Drain(void)
+{
+    while (Register_I2C_IsAsyncBusy(&s_test.handle.deviceInfo))
+    {
+        HostCpu_WaitForInterrupt();
+    }
+}
+
+/* A read, a write and a read back complete in order, each sees the bus as the previous one left it. */
+static void Test_Order(void)
+{
+    hosti2cstats_t stats;
+    uint32_t i;
+
+    Test_Init(false);
+    TEST_CHECK_EQUAL(Test_Read(0U), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(Test_Write(1U, s_thresholds), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(Test_Read(2U), ARM_DRIVER_OK);
+    TEST_CHECK(Register_I2C_IsAsyncBusy(&s_test.handle.deviceInfo));
+    TEST_CHECK_EQUAL(s_test.done, 0U);
+    Test_Drain();
+
+    TEST_CHECK_EQUAL(s_test.done, TEST_XFERS);
+    for (i = 0U; i < TEST_XFERS; i++)
+    {
+        TEST_CHECK_EQUAL(s_test.order[i], i);
+        TEST_CHECK_EQUAL(s_test.status[i], ARM_DRIVER_OK);
+    }
+    TEST_CHECK(s_test.inIsr);
+    TEST_CHECK_EQUAL(s_test.buffer[0][0], FXLS8974_WHOAMI_VALUE);
+    TEST_CHECK_EQUAL(s_test.buffer[0][1], 0U);
+    TEST_CHECK_EQUAL(s_test.buffer[2][0], FXLS8974_WHOAMI_VALUE);
+    TEST_CHECK_EQUAL(s_test.buffer[2][1], s_thresholds[0]);
+    TEST_CHECK_EQUAL(s_test.buffer[2][2], s_thresholds[1]);
+
+    /* Address and data of each read list entry, one transmit per write, all back to back. */
+    HostI2C_GetStats(&stats);
+    TEST_CHECK_EQUAL(stats.transfers, 4U + 1U + 4U);
+    TEST_CHECK_EQUAL(stats.refused, 0U);
+}
+
+/* A NACKed write reports ARM_DRIVER_ERROR and drops its cache entries, the transfers behind it still run. */
+static void Test_Error(void)
+{
+    hosti2cstats_t stats;
+    uint8_t value = 0U;
+
+    Test_Init(true);
+    TEST_CHECK_EQUAL(Register_I2C_Write(&I2C_S_DRIVER, &s_test.handle.deviceInfo, FXLS8974_DEVICE_ADDRESS_SA0_0,
+                                        FXLS8974_SDCD_UTHS_LSB, 0x12U, 0U, false),
+                     ARM_DRIVER_OK);
+    HostI2C_FailNext(1U, ARM_I2C_EVENT_ADDRESS_NACK);
+    TEST_CHECK_EQUAL(Test_Write(0U, s_thresholds), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(Test_Read(1U), ARM_DRIVER_OK);
+    Test_Drain();
+
+    TEST_CHECK_EQUAL(s_test.done, 2U);
+    TEST_CHECK_EQUAL(s_test.order[0], 0U);
+    TEST_CHECK_EQUAL(s_test.status[0], ARM_DRIVER_ERROR);
+    TEST_CHECK_EQUAL(s_test.order[1], 1U);
+    TEST_CHECK_EQUAL(s_test.status[1], ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(s_test.buffer[1][1], 0x12U);
+    TEST_CHECK_EQUAL(s_test.model.reg[FXLS8974_SDCD_UTHS_LSB], 0x12U);
+
+    /* The cached 0x12 is gone, the register is read from the device again. */
+    HostI2C_ClearStats();
+    TEST_CHECK_EQUAL(Register_I2C_ReadCached(&I2C_S_DRIVER, &s_test.handle.deviceInfo, FXLS8974_DEVICE_ADDRESS_SA0_0,
+                                             FXLS8974_SDCD_UTHS_LSB, 1U, &value),
+                     ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(value, 0x12U);
+    HostI2C_GetStats(&stats);
+    TEST_CHECK_EQUAL(stats.transfers, 2U);
+}
+
+/* An abort completes the transfer on the bus and the queued ones, in order, from the caller. */
+static void Test_Abort(void)
+{
+    uint32_t i;
+    uint8_t value = 0U;
+
+    Test_Init(false);
+    TEST_CHECK_EQUAL(Test_Read(0U), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(Test_Write(1U, s_thresholds), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(Test_Read(2U), ARM_DRIVER_OK);
+    Register_I2C_AbortAsync(&I2C_S_DRIVER, &s_test.handle.deviceInfo);
+
+    TEST_CHECK(!Register_I2C_IsAsyncBusy(&s_test.handle.deviceInfo));
+    TEST_CHECK_EQUAL(s_test.done, TEST_XFERS);
+    for (i = 0U; i < TEST_XFERS; i++)
+    {
+        TEST_CHECK_EQUAL(s_test.order[i], i);
+        TEST_CHECK_EQUAL(s_test.status[i], REGISTER_I2C_ASYNC_ABORTED);
+    }
+    TEST_CHECK(!s_test.inIsr);
+    TEST_CHECK(s_test.model.reg[FXLS8974_SDCD_UTHS_LSB] != s_thresholds[0]);
+
+    /* The host driver lets the operation on the bus end, its late Signal Event must not complete anything. */
+    while (I2C_S_DRIVER.GetStatus().busy != 0U)
+    {
+        HostCpu_WaitForInterrupt();
+    }
+    TEST_CHECK_EQUAL(s_test.done, TEST_XFERS);
+    TEST_CHECK_EQUAL(Register_I2C_Read(&I2C_S_DRIVER, &s_test.handle.deviceInfo, FXLS8974_DEVICE_ADDRESS_SA0_0,
+                                       FXLS8974_WHO_AM_I, 1U, &value),
+                     ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(value, FXLS8974_WHOAMI_VALUE);
+
+    /* The queue takes new transfers after an abort. */
+    s_test.done = 0U;
+    TEST_CHECK_EQUAL(Test_Read(0U), ARM_DRIVER_OK);
+    Test_Drain();
+    TEST_CHECK_EQUAL(s_test.done, 1U);
+    TEST_CHECK_EQUAL(s_test.status[0], ARM_DRIVER_OK);
+}
+
+/* A blocking read while the queue owns the bus fails at once without a bus operation, between two operations of
+ * a queued read as well as during one, and the queued read completes untouched. */
+static void Test_BlockingWhileBusy(void)
+{
+    hosti2cstats_t stats;
+    uint8_t pollData = 0U;
+    uint32_t refusals = 0U;
+
+    Test_Init(false);
+    TEST_CHECK_EQUAL(Test_Read(0U), ARM_DRIVER_OK);
+    while (Register_I2C_IsAsyncBusy(&s_test.handle.deviceInfo))
+    {
+        TEST_CHECK_EQUAL(FXLS8974_I2C_ReadData(&s_test.handle, cTestReadList, &pollData), SENSOR_ERROR_READ);
+        refusals++;
+        HostCpu_WaitForInterrupt();
+    }
+
+    TEST_CHECK(refusals >= 4U);
+    TEST_CHECK_EQUAL(s_test.done, 1U);
+    TEST_CHECK_EQUAL(s_test.status[0], ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(s_test.buffer[0][0], FXLS8974_WHOAMI_VALUE);
+    HostI2C_GetStats(&stats);
+    TEST_CHECK_EQUAL(stats.transfers, 4U);
+    TEST_CHECK_EQUAL(stats.refused, 0U);
+
+    /* Once the queue is empty the blocking read goes through. */
+    TEST_CHECK_EQUAL(FXLS8974_I2C_ReadData(&s_test.handle, cTestReadList, s_test.buffer[1]), SENSOR_ERROR_NONE);
+    TEST_CHECK_EQUAL(s_test.buffer[1][0], FXLS8974_WHOAMI_VALUE);
+}
+
+int main(void)
+{
+    Test_Order();
+    Test_Error();
+    Test_Abort();
+    Test_BlockingWhileBusy();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,422 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file test_baseline_tracker.c
+ * @brief The test_baseline_tracker.c file checks the baseline tracker and benchmarks it on a week of pressure and
+ *        magnetic samples at the 2 s quiet poll interval: the false alarms of the drift tracking reference against
+ *        the reference frozen until the next alert it replaces, the tamper events detected, and the host time per
+ *        sample. The week is synthetic (weather, a front and a daily ambient field cycle with injected tampering),
+ *        a recorded pressure trace given on the command line is replayed through both references as well.
+ */
+
+#include <math.h>
+#include <time.h>
+#include "test_util.h"
+#include "trace_replay.h"
+#include "baseline_tracker.h"
+#include "mpl3115_pressure_wakeup.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_PI           (3.14159265358979)
+#define TEST_PERIOD_S     (2U)                /* Quiet poll interval, MPL3115_POLL_MAX_MS and NMH1000_POLL_MAX_MS. */
+#define TEST_DAY_S        (86400U)
+#define TEST_DAYS         (7U)
+#define TEST_SAMPLES      (TEST_DAYS * TEST_DAY_S / TEST_PERIOD_S)
+#define TEST_EVENTS       (12U)
+#define TEST_EVENT_FIRST  (6U * 3600U)        /* First tamper event, s. */
+#define TEST_EVENT_EVERY  (14U * 3600U)       /* Time between tamper events, s. */
+#define TEST_PR_EVENT_S   (60U)               /* An enclosure vented for a minute. */
+#define TEST_PR_EVENT_PA  (-150)
+#define TEST_MAG_EVENT_S  (300U)              /* A magnet held against the door for five minutes. */
+#define TEST_MAG_EVENT    (120)
+#define TEST_BENCH_ROUNDS (8U)
+/* THRESHOLD, NMH1000_BASELINE_SHIFT and NMH1000_BASELINE_GATE of nmh1000_mag_wakeup.h, which defines the same globals
+ * as mpl3115_pressure_wakeup.h and cannot be included next to it. */
+#define TEST_MAG_THRESHOLD (50U)
+#define TEST_MAG_SHIFT     (8U)
+#define TEST_MAG_GATE      (4U)
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief The alerts of one reference over one trace. */
+typedef struct
+{
+    uint32_t alerts;
+    uint32_t falseAlarms;
+    uint32_t detected; /* Injected events with at least one alert. */
+    uint32_t lastEvent;
+} testscore_t;
+
+/*! @brief The pressure application: a 5 sample average after start up and after each alert, then either the average
+ *         kept as is, or the tracker seeded with it and following the quiet samples. */
+typedef struct
+{
+    bool tracking;
+    baselinetracker_t tracker;
+    uint32_t frozen;
+    uint32_t sum;
+    uint8_t pending; /* Samples still to average. */
+    testscore_t score;
+} testpressure_t;
+
+/*! @brief The magnetic application: a field level against the reference seeded at 0, false alarms count the rising
+ *         edges of the level away from the magnet. */
+typedef struct
+{
+    bool tracking;
+    baselinetracker_t tracker;
+    bool field;
+    testscore_t score;
+} testmag_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static uint32_t s_seed;
+static int32_t s_pressure[TEST_SAMPLES];
+static int32_t s_mag[TEST_SAMPLES];
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/* Uniform noise in [-amplitude, amplitude], the same every run. */
+static double Test_Noise(double amplitude)
+{
+    s_seed = s_seed * 1664525U + 1013904223U;
+
+    return amplitude * (((double)(s_seed >> 8) / (double)(1U << 24)) * 2.0 - 1.0);
+}
+
+/* Index of the injected event running at time_s, TEST_EVENTS for none. */
+static uint32_t Test_Event(uint32_t time_s, uint32_t length_s)
+{
+    uint32_t event;
+
+    if (time_s < TEST_EVENT_FIRST)
+    {
+        return TEST_EVENTS;
+    }
+    event = (time_s - TEST_EVENT_FIRST) / TEST_EVENT_EVERY;
+    if ((event >= TEST_EVENTS) || ((time_s - TEST_EVENT_FIRST) % TEST_EVENT_EVERY >= length_s))
+    {
+        return TEST_EVENTS;
+    }
+
+    return event;
+}
+
+/* Smooth 0 to 1 ramp between start_s and start_s + length_s. */
+static double Test_Ramp(uint32_t time_s, uint32_t start_s, uint32_t length_s)
+{
+    double x;
+
+    if (time_s <= start_s)
+    {
+        return 0.0;
+    }
+    if (time_s >= start_s + length_s)
+    {
+        return 1.0;
+    }
+    x = (double)(time_s - start_s) / (double)length_s;
+
+    return x * x * (3.0 - 2.0 * x);
+}
+
+/* A week of weather: the 12 h atmospheric tide, a front dropping 1500 Pa over a day and its recovery, 1.5 Pa of
+ * noise. A week of ambient field: a daily 0 to 60 count cycle (temperature, a nearby motor), 2 counts of noise. */
+static void Test_Generate(void)
+{
+    uint32_t i;
+    uint32_t time_s;
+    double pressure;
+    double mag;
+
+    s_seed = 1U;
+    for (i = 0U; i < TEST_SAMPLES; i++)
+    {
+        time_s = i * TEST_PERIOD_S;
+
+        pressure = 101325.0 + 100.0 * sin(2.0 * TEST_PI * time_s / (TEST_DAY_S / 2U)) -
+                   1500.0 * Test_Ramp(time_s, 2U * TEST_DAY_S, TEST_DAY_S) +
+                   800.0 * Test_Ramp(time_s, 4U * TEST_DAY_S, TEST_DAY_S) + Test_Noise(1.5);
+        if (Test_Event(time_s, TEST_PR_EVENT_S) < TEST_EVENTS)
+        {
+            pressure += TEST_PR_EVENT_PA;
+        }
+        s_pressure[i] = (int32_t)lround(pressure);
+
+        mag = 30.0 - 30.0 * cos(2.0 * TEST_PI * time_s / TEST_DAY_S) + Test_Noise(2.0);
+        if (Test_Event(time_s, TEST_MAG_EVENT_S) < TEST_EVENTS)
+        {
+            mag += TEST_MAG_EVENT;
+        }
+        s_mag[i] = (int32_t)lround((mag < 0.0) ? 0.0 : ((mag > 255.0) ? 255.0 : mag));
+    }
+}
+
+/* An alert during an event, or on the first sample after it when the level returns, is a detection. */
+static void Test_Score(testscore_t *pScore, uint32_t time_s, uint32_t length_s)
+{
+    uint32_t event = Test_Event(time_s, length_s + TEST_PERIOD_S);
+
+    pScore->alerts++;
+    if (event == TEST_EVENTS)
+    {
+        pScore->falseAlarms++;
+    }
+    else if (event + 1U != pScore->lastEvent)
+    {
+        pScore->lastEvent = event + 1U;
+        pScore->detected++;
+    }
+}
+
+static void Test_PressureInit(testpressure_t *pApp, bool tracking)
+{
+    memset(pApp, 0, sizeof(testpressure_t));
+    pApp->tracking = tracking;
+    pApp->pending = NUM_AVG_SAMPLES;
+    Baseline_Init(&pApp->tracker, MPL3115_BASELINE_SHIFT, MPL3115_BASELINE_GATE);
+}
+
+/* mpl3115_event_BLE() with and without the tracker, returns true on an alert. */
+static bool Test_PressureSample(testpressure_t *pApp, int32_t pressure)
+{
+    bool event;
+
+    if (pApp->pending != 0U)
+    {
+        pApp->sum += (uint32_t)pressure;
+        if (--pApp->pending == 0U)
+        {
+            pApp->frozen = (pApp->sum + NUM_AVG_SAMPLES / 2U) / NUM_AVG_SAMPLES;
+            pApp->sum = 0U;
+            Baseline_Seed(&pApp->tracker, (int32_t)pApp->frozen);
+        }
+        return false;
+    }
+
+    if (pApp->tracking)
+    {
+        if (!Baseline_IsEvent(&pApp->tracker, pressure, PRESSURE_THS))
+        {
+            Baseline_Update(&pApp->tracker, pressure);
+        }
+        event = Baseline_IsEvent(&pApp->tracker, pressure, PRESSURE_THS);
+    }
+    else
+    {
+        event = (uint32_t)abs(pressure - (int32_t)pApp->frozen) > PRESSURE_THS;
+    }
+    if (event)
+    {
+        pApp->pending = NUM_AVG_SAMPLES;
+    }
+
+    return event;
+}
+
+/* nmh1000_engine_decode() with and without the tracker, returns true on the rising edge of the field level. */
+static bool Test_MagSample(testmag_t *pApp, int32_t mag)
+{
+    bool field;
+    bool rising;
+
+    if (pApp->tracking)
+    {
+        field = Baseline_IsEvent(&pApp->tracker, mag, TEST_MAG_THRESHOLD);
+        if (!field)
+        {
+            Baseline_Update(&pApp->tracker, mag);
+        }
+    }
+    else
+    {
+        field = (uint32_t)mag > TEST_MAG_THRESHOLD;
+    }
+    rising = field && !pApp->field;
+    pApp->field = field;
+
+    return rising;
+}
+
+static void Test_PressureRun(testpressure_t *pApp, bool tracking)
+{
+    uint32_t i;
+
+    Test_PressureInit(pApp, tracking);
+    for (i = 0U; i < TEST_SAMPLES; i++)
+    {
+        if (Test_PressureSample(pApp, s_pressure[i]))
+        {
+            Test_Score(&pApp->score, i * TEST_PERIOD_S, TEST_PR_EVENT_S);
+        }
+    }
+}
+
+static void Test_MagRun(testmag_t *pApp, bool tracking)
+{
+    uint32_t i;
+
+    memset(pApp, 0, sizeof(testmag_t));
+    pApp->tracking = tracking;
+    Baseline_Init(&pApp->tracker, TEST_MAG_SHIFT, TEST_MAG_GATE);
+    Baseline_Seed(&pApp->tracker, 0);
+    for (i = 0U; i < TEST_SAMPLES; i++)
+    {
+        if (Test_MagSample(pApp, s_mag[i]))
+        {
+            Test_Score(&pApp->score, i * TEST_PERIOD_S, TEST_MAG_EVENT_S);
+        }
+    }
+}
+
+static void Test_Print(const char *pName, const testscore_t *pScore)
+{
+    printf("%-16s: %4u alerts, %4u false (%.1f per day), %2u of %u events\r\n", pName, pScore->alerts,
+           pScore->falseAlarms, (double)pScore->falseAlarms / TEST_DAYS, pScore->detected, TEST_EVENTS);
+}
+
+/* Seeding, rounding, the fixed threshold and the variance gate. */
+static void Test_Tracker(void)
+{
+    baselinetracker_t tracker;
+    uint32_t i;
+
+    Baseline_Init(&tracker, 4U, 4U);
+    TEST_CHECK_EQUAL(Baseline_Mean(&tracker), 0);
+    TEST_CHECK(!Baseline_IsEvent(&tracker, 100000, 0U));
+    Baseline_Update(&tracker, -500);
+    TEST_CHECK(tracker.seeded);
+    TEST_CHECK_EQUAL(Baseline_Mean(&tracker), -500);
+
+    /* Without a variance the threshold alone decides, a deviation equal to it is not an event. */
+    Baseline_Seed(&tracker, 101325);
+    TEST_CHECK(!Baseline_IsEvent(&tracker, 101325 + PRESSURE_THS, PRESSURE_THS));
+    TEST_CHECK(Baseline_IsEvent(&tracker, 101325 + PRESSURE_THS + 1, PRESSURE_THS));
+    TEST_CHECK(Baseline_IsEvent(&tracker, 101325 - PRESSURE_THS - 1, PRESSURE_THS));
+
+    /* +/-10 noise: sigma 10, a gate of 4 sigma keeps 30 away quiet and raises 50 away, over a threshold of 5. */
+    for (i = 0U; i < 512U; i++)
+    {
+        Baseline_Update(&tracker, 101325 + (((i & 1U) != 0U) ? 10 : -10));
+    }
+    TEST_CHECK(abs(Baseline_Mean(&tracker) - 101325) <= 1);
+    TEST_CHECK((tracker.variance >= (80U << BASELINE_FRAC_BITS)) && (tracker.variance <= (120U << BASELINE_FRAC_BITS)));
+    TEST_CHECK(!Baseline_IsEvent(&tracker, 101325 + 30, 5U));
+    TEST_CHECK(Baseline_IsEvent(&tracker, 101325 + 50, 5U));
+
+    /* A step is followed within a few time constants, to the sample. */
+    Baseline_Seed(&tracker, 0);
+    for (i = 0U; i < 16U * 8U; i++)
+    {
+        Baseline_Update(&tracker, 1000);
+    }
+    TEST_CHECK_EQUAL(Baseline_Mean(&tracker), 1000);
+}
+
+/* The week through both references: the tracker keeps every event and drops the drift alarms. */
+static void Test_Week(void)
+{
+    static testpressure_t frozenPr;
+    static testpressure_t trackedPr;
+    static testmag_t frozenMag;
+    static testmag_t trackedMag;
+
+    Test_Generate();
+
+    Test_PressureRun(&frozenPr, false);
+    Test_PressureRun(&trackedPr, true);
+    Test_Print("pressure frozen", &frozenPr.score);
+    Test_Print("pressure tracked", &trackedPr.score);
+    TEST_CHECK_EQUAL(trackedPr.score.falseAlarms, 0U);
+    TEST_CHECK_EQUAL(trackedPr.score.detected, TEST_EVENTS);
+    TEST_CHECK_EQUAL(frozenPr.score.detected, TEST_EVENTS);
+    TEST_CHECK(frozenPr.score.falseAlarms > TEST_DAYS);
+
+    Test_MagRun(&frozenMag, false);
+    Test_MagRun(&trackedMag, true);
+    Test_Print("mag frozen", &frozenMag.score);
+    Test_Print("mag tracked", &trackedMag.score);
+    TEST_CHECK_EQUAL(trackedMag.score.falseAlarms, 0U);
+    TEST_CHECK_EQUAL(trackedMag.score.detected, TEST_EVENTS);
+    TEST_CHECK(frozenMag.score.falseAlarms >= TEST_DAYS);
+}
+
+/* Host time of one Baseline_IsEvent/Baseline_Update pair, the per sample work of mpl3115_event_BLE(). The cost has
+ * no loop and does not depend on the data, on the target time it with DWT->CYCCNT the same way. */
+static void Test_Bench(void)
+{
+    baselinetracker_t tracker;
+    volatile uint32_t events = 0U;
+    clock_t start;
+    double seconds;
+    uint32_t round;
+    uint32_t i;
+
+    Baseline_Init(&tracker, MPL3115_BASELINE_SHIFT, MPL3115_BASELINE_GATE);
+    start = clock();
+    for (round = 0U; round < TEST_BENCH_ROUNDS; round++)
+    {
+        for (i = 0U; i < TEST_SAMPLES; i++)
+        {
+            if (!Baseline_IsEvent(&tracker, s_pressure[i], PRESSURE_THS))
+            {
+                Baseline_Update(&tracker, s_pressure[i]);
+            }
+            events += Baseline_IsEvent(&tracker, s_pressure[i], PRESSURE_THS) ? 1U : 0U;
+        }
+    }
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("tracker: %.1f ns per sample on the host, %u samples\r\n",
+           seconds * 1e9 / ((double)TEST_SAMPLES * TEST_BENCH_ROUNDS), TEST_SAMPLES * TEST_BENCH_ROUNDS);
+}
+
+/* A recorded pressure trace, time_ms,pressure in 1/4 Pa: no events are known, every alert is reported. */
+static void Test_Recording(const char *pPath)
+{
+    static testpressure_t frozenPr;
+    static testpressure_t trackedPr;
+    tracereplay_t trace;
+    tracesample_t sample;
+    int32_t pressure;
+
+    memset(&sample, 0, sizeof(sample));
+    TEST_CHECK(TraceReplay_Open(&trace, pPath));
+    Test_PressureInit(&frozenPr, false);
+    Test_PressureInit(&trackedPr, true);
+    while (TraceReplay_Next(&trace, &sample))
+    {
+        pressure = sample.value[0] / 4;
+        frozenPr.score.alerts += Test_PressureSample(&frozenPr, pressure) ? 1U : 0U;
+        trackedPr.score.alerts += Test_PressureSample(&trackedPr, pressure) ? 1U : 0U;
+    }
+    TEST_CHECK(!trace.error);
+    printf("%s: %u samples over %u s, %u alerts frozen, %u alerts tracked\r\n", pPath, trace.samples,
+           sample.time_ms / 1000U, frozenPr.score.alerts, trackedPr.score.alerts);
+    TraceReplay_Close(&trace);
+}
+
+int main(int argc, char *argv[])
+{
+    int i;
+
+    Test_Tracker();
+    Test_Week();
+    Test_Bench();
+    for (i = 1; i < argc; i++)
+    {
+        Test_Recording(argv[i]);
+    }
+
+    return TEST_RESULT();
+}
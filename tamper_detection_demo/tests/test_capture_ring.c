@@ -0,0 +1,246 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file test_capture_ring.c
+ * @brief The test_capture_ring.c file checks the window rules of the capture ring, then runs a producer thread
+ *        against a consumer thread which triggers, reads and releases snapshots without pause, and checks that
+ *        every snapshot comes out whole, in order and untorn, and that no sample is lost but the dropped ones.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include "test_util.h"
+#include "capture_ring.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_CAPACITY   (64U)
+#define TEST_SNAPSHOTS  (20000U) /* Snapshots the consumer takes in the stress run. */
+#define TEST_READ_CHUNK (4U)     /* As the *_SnapshotSendHandler() of the applications. */
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+typedef struct
+{
+    capturering_t ring;
+    volatile bool stop;
+    uint32_t attempts;  /* Producer side. */
+    uint32_t recorded;
+    volatile uint32_t snapshots; /* Consumer side, the rest too. */
+    uint32_t samples;
+    uint32_t torn;
+    uint32_t gaps;
+    uint32_t badSize;
+} teststress_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static capturesample_t s_storage[TEST_CAPACITY];
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/* Sample n: time stamp n, values derived from it so a sample copied halfway through a write shows. */
+static void Test_Sample(capturesample_t *pSample, uint32_t n)
+{
+    pSample->timestamp = n;
+    pSample->value[0] = (int32_t)(n * 3U);
+    pSample->value[1] = (int32_t)~n;
+    pSample->value[2] = (int32_t)(n ^ 0x5A5A5A5AU);
+}
+
+static bool Test_IsWhole(const capturesample_t *pSample)
+{
+    uint32_t n = pSample->timestamp;
+
+    return (pSample->value[0] == (int32_t)(n * 3U)) && (pSample->value[1] == (int32_t)~n) &&
+           (pSample->value[2] == (int32_t)(n ^ 0x5A5A5A5AU));
+}
+
+static uint32_t Test_Push(capturering_t *pRing, uint32_t from, uint32_t count)
+{
+    capturesample_t sample;
+    uint32_t pushed = 0U;
+    uint32_t i;
+
+    for (i = 0U; i < count; i++)
+    {
+        Test_Sample(&sample, from + i);
+        pushed += CaptureRing_Push(pRing, &sample) ? 1U : 0U;
+    }
+
+    return pushed;
+}
+
+static void Test_Window(void)
+{
+    capturering_t ring;
+    capturesample_t out[TEST_CAPACITY];
+    uint32_t count;
+    uint32_t i;
+
+    TEST_CHECK_EQUAL(sizeof(capturesample_t), 16U);
+    TEST_CHECK_EQUAL(CAPTURE_RING_BUDGET(TEST_CAPACITY), sizeof(s_storage));
+    TEST_CHECK(!CaptureRing_Init(&ring, NULL, TEST_CAPACITY));
+    TEST_CHECK(!CaptureRing_Init(&ring, s_storage, 0U));
+    TEST_CHECK(!CaptureRing_Init(&ring, s_storage, 48U));
+    TEST_CHECK(CaptureRing_Init(&ring, s_storage, TEST_CAPACITY));
+
+    /* Nothing to read without a trigger, and the window must fit. */
+    TEST_CHECK_EQUAL(CaptureRing_Read(&ring, out, TEST_CAPACITY), 0U);
+    TEST_CHECK(!CaptureRing_IsDone(&ring));
+    TEST_CHECK(!CaptureRing_Trigger(&ring, 1U, TEST_CAPACITY));
+    TEST_CHECK(!CaptureRing_Trigger(&ring, TEST_CAPACITY, 1U));
+
+    /* pre is cut to the 5 samples recorded, the window is frozen by the next push. */
+    TEST_CHECK_EQUAL(Test_Push(&ring, 0U, 5U), 5U);
+    TEST_CHECK(CaptureRing_Trigger(&ring, 16U, 8U));
+    TEST_CHECK(!CaptureRing_Trigger(&ring, 16U, 8U));
+    TEST_CHECK_EQUAL(CaptureRing_Read(&ring, out, TEST_CAPACITY), 0U);
+    TEST_CHECK_EQUAL(Test_Push(&ring, 5U, 1U), 1U);
+    TEST_CHECK_EQUAL(CaptureRing_Read(&ring, out, TEST_CAPACITY), 6U);
+    for (i = 0U; i < 6U; i++)
+    {
+        TEST_CHECK_EQUAL(out[i].timestamp, i);
+    }
+
+    /* The rest of post comes in, then the producer drops rather than overwrite the snapshot. */
+    TEST_CHECK_EQUAL(Test_Push(&ring, 6U, 100U), 7U);
+    TEST_CHECK_EQUAL(ring.dropped, 93U);
+    TEST_CHECK(!CaptureRing_IsDone(&ring));
+    TEST_CHECK_EQUAL(CaptureRing_Read(&ring, out, 4U), 4U);
+    TEST_CHECK_EQUAL(out[0].timestamp, 6U);
+    TEST_CHECK_EQUAL(CaptureRing_Read(&ring, out, TEST_CAPACITY), 3U);
+    TEST_CHECK_EQUAL(out[2].timestamp, 12U);
+    TEST_CHECK(CaptureRing_IsDone(&ring));
+
+    /* Released, the ring records again, wraps, and a full window reads the capacity back in order. */
+    CaptureRing_Release(&ring);
+    TEST_CHECK_EQUAL(Test_Push(&ring, 1000U, 100U), 100U);
+    TEST_CHECK(CaptureRing_Trigger(&ring, TEST_CAPACITY - 4U, 4U));
+    TEST_CHECK_EQUAL(Test_Push(&ring, 1100U, 10U), 4U);
+    count = CaptureRing_Read(&ring, out, TEST_CAPACITY);
+    TEST_CHECK_EQUAL(count, TEST_CAPACITY);
+    for (i = 0U; i < count; i++)
+    {
+        TEST_CHECK_EQUAL(out[i].timestamp, 1040U + i);
+        TEST_CHECK(Test_IsWhole(&out[i]));
+    }
+    TEST_CHECK(CaptureRing_IsDone(&ring));
+
+    /* Released before its window was frozen, a request is forgotten. */
+    CaptureRing_Release(&ring);
+    TEST_CHECK(CaptureRing_Trigger(&ring, 4U, 4U));
+    CaptureRing_Release(&ring);
+    TEST_CHECK_EQUAL(Test_Push(&ring, 2000U, 200U), 200U);
+    TEST_CHECK_EQUAL(CaptureRing_Read(&ring, out, TEST_CAPACITY), 0U);
+}
+
+/* Sample n is the n-th recorded, a dropped one is offered again, so a snapshot is a run of consecutive numbers. */
+static void *Test_Producer(void *pArg)
+{
+    teststress_t *pTest = (teststress_t *)pArg;
+    capturesample_t sample;
+
+    while (!pTest->stop)
+    {
+        Test_Sample(&sample, pTest->recorded);
+        pTest->attempts++;
+        if (CaptureRing_Push(&pTest->ring, &sample))
+        {
+            pTest->recorded++;
+        }
+        else
+        {
+            /* A single host core would otherwise spin out its time slice before the consumer runs. */
+            (void)sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+/* Triggers with windows of every shape, reads in small chunks as the samples come, releases once done. */
+static void *Test_Consumer(void *pArg)
+{
+    teststress_t *pTest = (teststress_t *)pArg;
+    capturesample_t out[TEST_READ_CHUNK];
+    uint32_t seed = 1U;
+    uint32_t pre;
+    uint32_t post;
+    uint32_t got;
+    uint32_t next;
+    uint32_t count;
+    uint32_t i;
+
+    while (pTest->snapshots < TEST_SNAPSHOTS)
+    {
+        seed = seed * 1103515245U + 12345U;
+        post = 1U + ((seed >> 16) % (TEST_CAPACITY - 1U));
+        pre = (seed >> 8) % (TEST_CAPACITY - post + 1U);
+        TEST_CHECK(CaptureRing_Trigger(&pTest->ring, pre, post));
+
+        got = 0U;
+        next = 0U;
+        while (!CaptureRing_IsDone(&pTest->ring))
+        {
+            count = CaptureRing_Read(&pTest->ring, out, TEST_READ_CHUNK);
+            if (count == 0U)
+            {
+                (void)sched_yield();
+            }
+            for (i = 0U; i < count; i++)
+            {
+                pTest->torn += Test_IsWhole(&out[i]) ? 0U : 1U;
+                pTest->gaps += ((got != 0U) && (out[i].timestamp != next)) ? 1U : 0U;
+                next = out[i].timestamp + 1U;
+                got++;
+            }
+        }
+        pTest->samples += got;
+        /* The recorded part of pre, always all of post. */
+        pTest->badSize += ((got < post) || (got > pre + post)) ? 1U : 0U;
+        CaptureRing_Release(&pTest->ring);
+        pTest->snapshots++;
+    }
+    pTest->stop = true;
+
+    return NULL;
+}
+
+static void Test_Stress(void)
+{
+    static teststress_t test;
+    pthread_t producer;
+    pthread_t consumer;
+
+    TEST_CHECK(CaptureRing_Init(&test.ring, s_storage, TEST_CAPACITY));
+    TEST_CHECK_EQUAL(pthread_create(&consumer, NULL, Test_Consumer, &test), 0);
+    TEST_CHECK_EQUAL(pthread_create(&producer, NULL, Test_Producer, &test), 0);
+    (void)pthread_join(producer, NULL);
+    (void)pthread_join(consumer, NULL);
+
+    printf("stress: %u pushed, %u dropped, %u snapshots of %u samples, %u torn, %u gaps, %u bad sizes\r\n",
+           test.recorded, test.ring.dropped, test.snapshots, test.samples, test.torn, test.gaps, test.badSize);
+
+    TEST_CHECK_EQUAL(test.recorded + test.ring.dropped, test.attempts);
+    TEST_CHECK_EQUAL(test.snapshots, TEST_SNAPSHOTS);
+    TEST_CHECK_EQUAL(test.torn, 0U);
+    TEST_CHECK_EQUAL(test.gaps, 0U);
+    TEST_CHECK_EQUAL(test.badSize, 0U);
+}
+
+int main(void)
+{
+    Test_Window();
+    Test_Stress();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file test_dma_transport.c
+ * @brief The test_dma_transport.c file compares the CPU cycles of a full sample buffer drain over the interrupt
+ *        per byte path of fsl_lpi2c_cmsis and over the eDMA path, with the idle task spinning or in
+ *        Register_I2C_WaitForInterrupt(). The host bus mocks the eDMA channel: one set up, one completion interrupt.
+ */
+
+#include "test_util.h"
+#include "issdk_hal.h"
+#include "host_cpu.h"
+#include "host_i2c.h"
+#include "sim_fxls8974.h"
+#include "sim_mpl3115.h"
+#include "fxls8974_drv.h"
+#include "mpl3115_drv.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+typedef enum
+{
+    TEST_IRQ_SPIN = 0, /* Stock build: interrupt per byte, __NOP() while waiting. */
+    TEST_IRQ_WFI,      /* Interrupt per byte, WFI while waiting. */
+    TEST_DMA_WFI,      /* RTE_I2C1_DMA_EN=1 build: eDMA, WFI while waiting. */
+    TEST_CASES
+} testcase_t;
+
+typedef struct
+{
+    uint64_t active_ns; /* CPU awake, from the first transfer to the end of the drain. */
+    uint64_t total_ns;  /* Duration of the drain. */
+    uint32_t interrupts;
+    uint32_t bytes;
+} testresult_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static const char *const s_caseName[TEST_CASES] = {"irq + spin", "irq + wfi", "dma + wfi"};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void Test_BusInit(testcase_t testCase)
+{
+    HostCpu_Reset();
+    HostI2C_Reset();
+    HostI2C_SetTransport((testCase == TEST_DMA_WFI) ? HOST_I2C_TRANSPORT_DMA : HOST_I2C_TRANSPORT_IRQ);
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.Initialize(I2C_S_SIGNAL_EVENT), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.PowerControl(ARM_POWER_FULL), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.Control(ARM_I2C_BUS_SPEED, ARM_I2C_BUS_SPEED_FAST), ARM_DRIVER_OK);
+}
+
+static void Test_Start(void)
+{
+    HostI2C_ClearStats();
+}
+
+static void Test_Stop(testresult_t *pResult, uint64_t start_ns, uint64_t startSleep_ns)
+{
+    hosti2cstats_t stats;
+
+    HostI2C_GetStats(&stats);
+    pResult->total_ns = HostCpu_Now_ns() - start_ns;
+    pResult->active_ns = pResult->total_ns - (HostCpu_Sleep_ns() - startSleep_ns);
+    pResult->interrupts = stats.interrupts;
+    pResult->bytes = stats.bytes;
+}
+
+static uint32_t Test_Cycles(uint64_t ns)
+{
+    return (uint32_t)((ns * (HOST_CPU_CLOCK_HZ / 1000000U)) / 1000U);
+}
+
+/* Fills the 32 sample buffer of the FXLS8974 and drains it in one burst. */
+static void Test_FxlsDrain(testcase_t testCase, testresult_t *pResult)
+{
+    static simfxls8974_t model;
+    static fxls8974_i2c_sensorhandle_t handle;
+    const registerwritelist_t config[] = {
+        {FXLS8974_BUF_CONFIG1, FXLS8974_BUF_CONFIG1_BUF_MODE_STREAM_MODE, FXLS8974_BUF_CONFIG1_BUF_MODE_MASK},
+        {FXLS8974_SENS_CONFIG1, FXLS8974_SENS_CONFIG1_ACTIVE_ACTIVE, FXLS8974_SENS_CONFIG1_ACTIVE_MASK},
+        __END_WRITE_DATA__};
+    fxls8974_acceldata_t samples[FXLS8974_BUF_MAX_SAMPLES];
+    uint8_t whoAmI = FXLS8974_WHOAMI_VALUE;
+    uint64_t start_ns;
+    uint64_t startSleep_ns;
+    uint8_t count = 0;
+    uint8_t i;
+
+    Test_BusInit(testCase);
+    SimFxls8974_Init(&model, FXLS8974_DEVICE_ADDRESS_SA0_0, FXLS8974_WHOAMI_VALUE);
+    TEST_CHECK_EQUAL(FXLS8974_I2C_Initialize(&handle, &I2C_S_DRIVER, I2C_S_DEVICE_INDEX,
+                                             FXLS8974_DEVICE_ADDRESS_SA0_0, &whoAmI),
+                     SENSOR_ERROR_NONE);
+    if (testCase != TEST_IRQ_SPIN)
+    {
+        FXLS8974_I2C_SetIdleTask(&handle, Register_I2C_WaitForInterrupt, &handle.deviceInfo);
+    }
+    TEST_CHECK_EQUAL(FXLS8974_I2C_Configure(&handle, config), SENSOR_ERROR_NONE);
+    for (i = 0; i < FXLS8974_BUF_MAX_SAMPLES; i++)
+    {
+        SimFxls8974_Sample(&model, (int16_t)i, (int16_t)-i, 1024);
+    }
+
+    Test_Start();
+    start_ns = HostCpu_Now_ns();
+    startSleep_ns = HostCpu_Sleep_ns();
+    TEST_CHECK_EQUAL(FXLS8974_I2C_ReadBuffer(&handle, samples, FXLS8974_BUF_MAX_SAMPLES, 0, 0, &count, NULL),
+                     SENSOR_ERROR_NONE);
+    Test_Stop(pResult, start_ns, startSleep_ns);
+
+    /* Same data whatever moves it. */
+    TEST_CHECK_EQUAL(count, FXLS8974_BUF_MAX_SAMPLES);
+    for (i = 0; i < count; i++)
+    {
+        TEST_CHECK_EQUAL(samples[i].accel[0], i);
+        TEST_CHECK_EQUAL(samples[i].accel[1], -i);
+        TEST_CHECK_EQUAL(samples[i].accel[2], 1024);
+    }
+}
+
+/* Fills the 32 entry FIFO of the MPL3115 and drains it in one burst. */
+static void Test_MplDrain(testcase_t testCase, testresult_t *pResult)
+{
+    static simmpl3115_t model;
+    static mpl3115_i2c_sensorhandle_t handle;
+    const registerwritelist_t config[] = {
+        {MPL3115_F_SETUP, MPL3115_F_SETUP_F_MODE_CIR_MODE, MPL3115_F_SETUP_F_MODE_MASK},
+        {MPL3115_CTRL_REG1, MPL3115_CTRL_REG1_SBYB_ACTIVE, MPL3115_CTRL_REG1_SBYB_MASK},
+        __END_WRITE_DATA__};
+    mpl3115_pressuredata_t samples[MPL3115_FIFO_MAX_SAMPLES];
+    uint8_t whoAmI = MPL3115_WHOAMI_VALUE;
+    uint64_t start_ns;
+    uint64_t startSleep_ns;
+    uint8_t count = 0;
+    uint8_t i;
+
+    Test_BusInit(testCase);
+    SimMpl3115_Init(&model, MPL3115_I2C_ADDRESS, MPL3115_WHOAMI_VALUE);
+    TEST_CHECK_EQUAL(MPL3115_I2C_Initialize(&handle, &I2C_S_DRIVER, I2C_S_DEVICE_INDEX, MPL3115_I2C_ADDRESS, &whoAmI),
+                     SENSOR_ERROR_NONE);
+    if (testCase != TEST_IRQ_SPIN)
+    {
+        MPL3115_I2C_SetIdleTask(&handle, Register_I2C_WaitForInterrupt, &handle.deviceInfo);
+    }
+    TEST_CHECK_EQUAL(MPL3115_I2C_Configure(&handle, config), SENSOR_ERROR_NONE);
+    for (i = 0; i < MPL3115_FIFO_MAX_SAMPLES; i++)
+    {
+        SimMpl3115_Sample(&model, 405300U + i, 0x1580);
+    }
+
+    Test_Start();
+    start_ns = HostCpu_Now_ns();
+    startSleep_ns = HostCpu_Sleep_ns();
+    TEST_CHECK_EQUAL(MPL3115_I2C_ReadFifo(&handle, samples, MPL3115_FIFO_MAX_SAMPLES, 0, 0, &count, NULL),
+                     SENSOR_ERROR_NONE);
+    Test_Stop(pResult, start_ns, startSleep_ns);
+
+    TEST_CHECK_EQUAL(count, MPL3115_FIFO_MAX_SAMPLES);
+    for (i = 0; i < count; i++)
+    {
+        TEST_CHECK_EQUAL(samples[i].pressure, (405300U + i) << 4);
+    }
+}
+
+static void Test_Compare(const char *pName, const testresult_t *pResults)
+{
+    testcase_t testCase;
+
+    for (testCase = TEST_IRQ_SPIN; testCase < TEST_CASES; testCase++)
+    {
+        printf("%s %-10s: %3u bytes, %3u interrupts, %6u of %6u cycles awake\r\n", pName, s_caseName[testCase],
+               pResults[testCase].bytes, pResults[testCase].interrupts, Test_Cycles(pResults[testCase].active_ns),
+               Test_Cycles(pResults[testCase].total_ns));
+    }
+
+    /* The bus sets the duration, the transport only the share of it the CPU is awake. */
+    TEST_CHECK_EQUAL(pResults[TEST_IRQ_WFI].bytes, pResults[TEST_IRQ_SPIN].bytes);
+    TEST_CHECK_EQUAL(pResults[TEST_DMA_WFI].bytes, pResults[TEST_IRQ_SPIN].bytes);
+    TEST_CHECK(pResults[TEST_IRQ_SPIN].active_ns >= pResults[TEST_IRQ_SPIN].total_ns * 99U / 100U);
+    TEST_CHECK(pResults[TEST_IRQ_WFI].active_ns < pResults[TEST_IRQ_SPIN].active_ns);
+    TEST_CHECK(pResults[TEST_DMA_WFI].active_ns < pResults[TEST_IRQ_WFI].active_ns);
+    TEST_CHECK(pResults[TEST_DMA_WFI].interrupts < pResults[TEST_IRQ_WFI].interrupts / 10U);
+    /* With eDMA the CPU is awake for a few percent of the drain at most. */
+    TEST_CHECK(pResults[TEST_DMA_WFI].active_ns < pResults[TEST_DMA_WFI].total_ns / 20U);
+}
+
+int main(void)
+{
+    testresult_t results[TEST_CASES];
+    testcase_t testCase;
+
+    for (testCase = TEST_IRQ_SPIN; testCase < TEST_CASES; testCase++)
+    {
+        Test_FxlsDrain(testCase, &results[testCase]);
+    }
+    Test_Compare("FXLS8974 drain", results);
+
+    for (testCase = TEST_IRQ_SPIN; testCase < TEST_CASES; testCase++)
+    {
+        Test_MplDrain(testCase, &results[testCase]);
+    }
+    Test_Compare("MPL3115 drain ", results);
+
+    return TEST_RESULT();
+}
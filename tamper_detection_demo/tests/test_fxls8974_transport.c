@@ -0,0 +1,397 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file test_fxls8974_transport.c
+ * @brief The test_fxls8974_transport.c file checks the SPI frames of the FXLS8974 driver, then runs the tamper
+ *        pipeline of FXLS8974_FIFO_CAPTURE_MODE over I2C and over SPI, each with the interrupt and the eDMA path:
+ *        cFxls8974AwsConfig, the SYS_MODE poll and the watermark drains timed by bus_bench.c as
+ *        FXLS8974_BUS_BENCH_MODE does. Every run must see the same samples and the same mode changes, and the
+ *        benchmark reports the bus time and the CPU time per sample of each.
+ */
+
+#include <string.h>
+#include "test_util.h"
+#include "host_cpu.h"
+#include "host_i2c.h"
+#include "host_spi.h"
+#include "sim_fxls8974.h"
+#include "trace_replay.h"
+#include "fxls89xx_motion_wakeup.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_SAMPLE_NS    (2500000U) /* The 400 Hz wake ODR. */
+#define TEST_POLL_SAMPLES (10U)      /* SYS_MODE poll every 25 ms, FXLS8974_POLL_MIN_MS. */
+#define TEST_REST_SAMPLES (2100U)    /* Longer than the 2000 samples of ASLP_COUNT, the part goes to sleep. */
+#define TEST_MAX_CHANGES  (8U)
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+typedef enum
+{
+    TEST_I2C_IRQ = 0, /* Stock build, interrupt per byte, the CPU spins. */
+    TEST_I2C_DMA,     /* RTE_I2C1_DMA_EN=1, WFI while eDMA moves the data. */
+    TEST_SPI_IRQ,     /* FXLS8974_SPI_MODE=1, interrupt per FIFO, the CPU spins. */
+    TEST_SPI_DMA,     /* FXLS8974_SPI_MODE=1 and RTE_SPI1_DMA_EN=1. */
+    TEST_CASES
+} testcase_t;
+
+typedef struct
+{
+    testcase_t testCase;
+    simfxls8974_t model;
+    fxls8974_i2c_sensorhandle_t i2c;
+    fxls8974_spi_sensorhandle_t spi;
+    gpioHandleKSDK_t select;
+    busbench_t bench;
+    uint64_t next_ns;
+    int16_t expected[SIM_FXLS8974_BUFFER_DEPTH][3];
+    uint32_t replayed;
+    uint32_t drained;
+    uint32_t checksum; /* Of the drained samples, in order. */
+    bool mismatch;
+    bool overflow;
+    uint32_t polls;
+    uint8_t mode;
+    uint8_t changes[TEST_MAX_CHANGES]; /* SYS_MODE values the polls saw, each time it changed. */
+    uint32_t numChanges;
+    uint64_t busTime_ns;
+} testrun_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static const char *const s_caseName[TEST_CASES] = {"I2C irq", "I2C dma", "SPI irq", "SPI dma"};
+static testrun_t *s_pRun;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static bool Test_IsSpi(const testrun_t *pRun)
+{
+    return (pRun->testCase == TEST_SPI_IRQ) || (pRun->testCase == TEST_SPI_DMA);
+}
+
+/* fxls89xx_bench_idle() */
+static void Test_BenchIdle(void *pDevInfo)
+{
+    uint32_t start = BUS_BENCH_NOW();
+
+    if (Test_IsSpi(s_pRun))
+    {
+        Register_SPI_WaitForInterrupt(pDevInfo);
+    }
+    else
+    {
+        Register_I2C_WaitForInterrupt(pDevInfo);
+    }
+    BusBench_AddSleep(&s_pRun->bench, BUS_BENCH_NOW() - start);
+}
+
+static void Test_SpiInit(void)
+{
+    HostSPI_Reset();
+    TEST_CHECK_EQUAL(SPI_S_DRIVER.Initialize(SPI_S_SIGNAL_EVENT), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(SPI_S_DRIVER.PowerControl(ARM_POWER_FULL), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(SPI_S_DRIVER.Control(ARM_SPI_MODE_MASTER | ARM_SPI_CPOL0_CPHA0, FXLS8974_SPI_BAUDRATE),
+                     ARM_DRIVER_OK);
+}
+
+/* The frames of register_io_spi.c reach the part behind its chip select only, and a part which does not answer
+ * reads as 0xFF, which no variant lists. */
+static void Test_Frames(void)
+{
+    static simfxls8974_t model;
+    static fxls8974_spi_sensorhandle_t handle;
+    static fxls8974_spi_sensorhandle_t missing;
+    gpioHandleKSDK_t select = {0};
+    gpioHandleKSDK_t otherSelect = {0};
+    hostspistats_t stats;
+    const sensorvariant_t *pVariant;
+    uint8_t whoAmI = 0U;
+    uint8_t value = 0U;
+    uint32_t i;
+
+    HostCpu_Reset();
+    HostI2C_Reset();
+    Test_SpiInit();
+    SimFxls8974_Init(&model, FXLS8974_DEVICE_ADDRESS_SA0_0, FXLS8964_WHOAMI_VALUE);
+    SimFxls8974_AttachSpi(&model, &select);
+
+    /* R/W and address, a don't care byte, one data byte. The chip select is released after each frame. */
+    TEST_CHECK_EQUAL(FXLS8974_SPI_Initialize(&handle, &SPI_S_DRIVER, SPI_S_DEVICE_INDEX, &select, &whoAmI),
+                     SENSOR_ERROR_NONE);
+    TEST_CHECK_EQUAL(whoAmI, FXLS8964_WHOAMI_VALUE);
+    TEST_CHECK_EQUAL(select.level, 1U);
+    pVariant = SensorRegistry_Find(cFxls89xxVariants, SENSOR_REGISTRY_COUNT(cFxls89xxVariants), whoAmI);
+    TEST_CHECK((pVariant != NULL) && (strcmp(pVariant->pName, "FXLS8964AF") == 0));
+    /* Each WHO_AM_I the engine accepts has an entry of its own. */
+    for (i = 0U; i < sizeof(cFxls8974WhoAmI); i++)
+    {
+        pVariant = SensorRegistry_Find(cFxls89xxVariants, SENSOR_REGISTRY_COUNT(cFxls89xxVariants), cFxls8974WhoAmI[i]);
+        TEST_CHECK(pVariant == &cFxls89xxVariants[i]);
+    }
+    HostSPI_GetStats(&stats);
+    TEST_CHECK_EQUAL(stats.transfers, 1U);
+    TEST_CHECK_EQUAL(stats.bytes, 1U + FXLS8974_SPI_CMD_LEN);
+    TEST_CHECK_EQUAL(stats.busTime_ns, HostSPI_TransferTime_ns(1U + FXLS8974_SPI_CMD_LEN));
+
+    /* A masked write reads the register back and only changes the masked bits. */
+    model.reg[FXLS8974_INT_EN] = FXLS8974_INT_EN_BUF_EN_MASK;
+    TEST_CHECK_EQUAL(Register_SPI_Write(&SPI_S_DRIVER, &handle.deviceInfo, &handle.slaveParams, FXLS8974_INT_EN,
+                                        FXLS8974_INT_EN_WAKE_OUT_EN_EN, FXLS8974_INT_EN_WAKE_OUT_EN_MASK),
+                     ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(model.reg[FXLS8974_INT_EN], FXLS8974_INT_EN_BUF_EN_MASK | FXLS8974_INT_EN_WAKE_OUT_EN_EN);
+    TEST_CHECK_EQUAL(Register_SPI_Read(&SPI_S_DRIVER, &handle.deviceInfo, &handle.slaveParams, FXLS8974_INT_EN, 1,
+                                       &value),
+                     ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(value, model.reg[FXLS8974_INT_EN]);
+    HostSPI_GetStats(&stats);
+    TEST_CHECK_EQUAL(stats.transfers, 4U);
+    TEST_CHECK_EQUAL(stats.unselected, 0U);
+
+    /* SPI has no acknowledge, the transfer succeeds and the WHO_AM_I check of fxls89xx_spi_init() rejects it. */
+    TEST_CHECK_EQUAL(FXLS8974_SPI_Initialize(&missing, &SPI_S_DRIVER, SPI_S_DEVICE_INDEX, &otherSelect, &whoAmI),
+                     SENSOR_ERROR_NONE);
+    TEST_CHECK_EQUAL(whoAmI, 0xFFU);
+    TEST_CHECK(SensorRegistry_Find(cFxls89xxVariants, SENSOR_REGISTRY_COUNT(cFxls89xxVariants), whoAmI) == NULL);
+    HostSPI_GetStats(&stats);
+    TEST_CHECK_EQUAL(stats.unselected, 1U);
+}
+
+static int32_t Test_ReadData(testrun_t *pRun, const registerreadlist_t *pReadList, uint8_t *pBuffer)
+{
+    return Test_IsSpi(pRun) ? FXLS8974_SPI_ReadData(&pRun->spi, pReadList, pBuffer)
+                            : FXLS8974_I2C_ReadData(&pRun->i2c, pReadList, pBuffer);
+}
+
+/* fxls89xx_buf_drain(), timed as with FXLS8974_BUS_BENCH_MODE. */
+static void Test_Drain(testrun_t *pRun)
+{
+    fxls8974_acceldata_t samples[FXLS8974_BUF_MAX_SAMPLES];
+    hosti2cstats_t i2cStats;
+    hostspistats_t spiStats;
+    uint64_t busTime_ns;
+    int32_t status;
+    uint8_t count = 0U;
+    uint8_t bufStatus = 0U;
+    uint8_t i;
+
+    HostI2C_GetStats(&i2cStats);
+    HostSPI_GetStats(&spiStats);
+    busTime_ns = i2cStats.busTime_ns + spiStats.busTime_ns;
+
+    BusBench_Begin(&pRun->bench);
+    if (Test_IsSpi(pRun))
+    {
+        status = FXLS8974_SPI_ReadBuffer(&pRun->spi, samples, FXLS8974_BUF_MAX_SAMPLES, 0U, 0U, &count, &bufStatus);
+    }
+    else
+    {
+        status = FXLS8974_I2C_ReadBuffer(&pRun->i2c, samples, FXLS8974_BUF_MAX_SAMPLES, 0U, 0U, &count, &bufStatus);
+    }
+    BusBench_End(&pRun->bench, (SENSOR_ERROR_NONE == status) ? count : 0U);
+    TEST_CHECK_EQUAL(status, SENSOR_ERROR_NONE);
+
+    HostI2C_GetStats(&i2cStats);
+    HostSPI_GetStats(&spiStats);
+    pRun->busTime_ns += i2cStats.busTime_ns + spiStats.busTime_ns - busTime_ns;
+
+    pRun->overflow |= (bufStatus & FXLS8974_BUF_STATUS_BUF_OVF_MASK) != 0U;
+    for (i = 0U; i < count; i++)
+    {
+        if ((samples[i].accel[0] != pRun->expected[i][0]) || (samples[i].accel[1] != pRun->expected[i][1]) ||
+            (samples[i].accel[2] != pRun->expected[i][2]))
+        {
+            pRun->mismatch = true;
+        }
+        pRun->checksum = pRun->checksum * 31U + (uint16_t)samples[i].accel[0];
+        pRun->checksum = pRun->checksum * 31U + (uint16_t)samples[i].accel[1];
+        pRun->checksum = pRun->checksum * 31U + (uint16_t)samples[i].accel[2];
+    }
+    pRun->drained += count;
+}
+
+/* One sample at the ODR: the watermark on INT2 drains the buffer, the SYS_MODE poll follows the wake state. */
+static void Test_Sample(testrun_t *pRun, int16_t x, int16_t y, int16_t z)
+{
+    uint8_t queued = pRun->model.bufferCount;
+    uint8_t sysMode = 0U;
+
+    pRun->next_ns += TEST_SAMPLE_NS;
+    HostCpu_SleepUntil_ns(pRun->next_ns);
+
+    pRun->expected[queued][0] = x;
+    pRun->expected[queued][1] = y;
+    pRun->expected[queued][2] = z;
+    SimFxls8974_Sample(&pRun->model, x, y, z);
+    pRun->replayed++;
+
+    if (pRun->model.reg[FXLS8974_BUF_STATUS] & FXLS8974_BUF_STATUS_BUF_WMRK_MASK)
+    {
+        Test_Drain(pRun);
+    }
+    if ((pRun->replayed % TEST_POLL_SAMPLES) == 0U)
+    {
+        /* Compared whole, as fxls89xx_handle_mode() does. */
+        TEST_CHECK_EQUAL(Test_ReadData(pRun, cFxls8974ReadSysMode, &sysMode), SENSOR_ERROR_NONE);
+        if ((sysMode != pRun->mode) && (pRun->numChanges < TEST_MAX_CHANGES))
+        {
+            pRun->changes[pRun->numChanges++] = sysMode;
+        }
+        pRun->mode = sysMode;
+        pRun->polls++;
+    }
+}
+
+static bool Test_TraceSample(void *pContext, const tracesample_t *pSample)
+{
+    Test_Sample((testrun_t *)pContext, (int16_t)pSample->value[0], (int16_t)pSample->value[1],
+                (int16_t)pSample->value[2]);
+
+    return true;
+}
+
+static void Test_Bump(testrun_t *pRun)
+{
+    tracereplay_t trace;
+
+    TEST_CHECK(TraceReplay_Open(&trace, TEST_TRACE("accel_bump.csv")));
+    TraceReplay_Run(&trace, Test_TraceSample, pRun);
+    TEST_CHECK(!trace.error);
+    TraceReplay_Close(&trace);
+}
+
+/* A knock, the part at rest until it goes to sleep, a second knock which wakes it. */
+static void Test_Run(testcase_t testCase, testrun_t *pRun)
+{
+    uint8_t whoAmI = 0U;
+    uint32_t i;
+
+    memset(pRun, 0, sizeof(testrun_t));
+    pRun->testCase = testCase;
+    s_pRun = pRun;
+    HostCpu_Reset();
+    HostI2C_Reset();
+    HostSPI_Reset();
+    SimFxls8974_Init(&pRun->model, FXLS8974_DEVICE_ADDRESS_SA0_0, FXLS8974_WHOAMI_VALUE);
+
+    if (Test_IsSpi(pRun))
+    {
+        Test_SpiInit();
+        HostSPI_SetTransport((testCase == TEST_SPI_DMA) ? HOST_SPI_TRANSPORT_DMA : HOST_SPI_TRANSPORT_IRQ);
+        SimFxls8974_AttachSpi(&pRun->model, &pRun->select);
+        TEST_CHECK_EQUAL(FXLS8974_SPI_Initialize(&pRun->spi, &SPI_S_DRIVER, SPI_S_DEVICE_INDEX, &pRun->select,
+                                                 &whoAmI),
+                         SENSOR_ERROR_NONE);
+        if (testCase == TEST_SPI_DMA)
+        {
+            FXLS8974_SPI_SetIdleTask(&pRun->spi, Test_BenchIdle, &pRun->spi.deviceInfo);
+        }
+        TEST_CHECK_EQUAL(FXLS8974_SPI_Configure(&pRun->spi, cFxls8974AwsConfig), SENSOR_ERROR_NONE);
+    }
+    else
+    {
+        TEST_CHECK_EQUAL(I2C_S_DRIVER.Initialize(I2C_S_SIGNAL_EVENT), ARM_DRIVER_OK);
+        TEST_CHECK_EQUAL(I2C_S_DRIVER.PowerControl(ARM_POWER_FULL), ARM_DRIVER_OK);
+        TEST_CHECK_EQUAL(I2C_S_DRIVER.Control(ARM_I2C_BUS_SPEED, ARM_I2C_BUS_SPEED_FAST), ARM_DRIVER_OK);
+        HostI2C_SetTransport((testCase == TEST_I2C_DMA) ? HOST_I2C_TRANSPORT_DMA : HOST_I2C_TRANSPORT_IRQ);
+        TEST_CHECK_EQUAL(FXLS8974_I2C_Initialize(&pRun->i2c, &I2C_S_DRIVER, I2C_S_DEVICE_INDEX,
+                                                 FXLS8974_DEVICE_ADDRESS_SA0_0, &whoAmI),
+                         SENSOR_ERROR_NONE);
+        if (testCase == TEST_I2C_DMA)
+        {
+            FXLS8974_I2C_SetIdleTask(&pRun->i2c, Test_BenchIdle, &pRun->i2c.deviceInfo);
+        }
+        TEST_CHECK_EQUAL(FXLS8974_I2C_Configure(&pRun->i2c, cFxls8974AwsConfig), SENSOR_ERROR_NONE);
+    }
+    TEST_CHECK_EQUAL(whoAmI, FXLS8974_WHOAMI_VALUE);
+    TEST_CHECK_EQUAL(SimFxls8974_SysMode(&pRun->model), FXLS8974_SYS_MODE_SYS_MODE_WAKE);
+    pRun->mode = FXLS8974_SYS_MODE_SYS_MODE_WAKE;
+
+    BusBench_Reset(&pRun->bench);
+    pRun->next_ns = HostCpu_Now_ns();
+    Test_Bump(pRun);
+    for (i = 0U; i < TEST_REST_SAMPLES; i++)
+    {
+        Test_Sample(pRun, 0, 0, FXLS8974_ONE_G_COUNTS);
+    }
+    Test_Bump(pRun);
+}
+
+/* Cycles per sample of the drains, the bus holds the app for busCycles, the CPU is awake for the rest of sleep. */
+static uint64_t Test_BusPerSample(const testrun_t *pRun)
+{
+    return pRun->bench.busCycles / pRun->bench.samples;
+}
+
+static uint64_t Test_CpuPerSample(const testrun_t *pRun)
+{
+    return (pRun->bench.busCycles - pRun->bench.sleepCycles) / pRun->bench.samples;
+}
+
+static void Test_Compare(void)
+{
+    static testrun_t runs[TEST_CASES];
+    char text[128];
+    testcase_t testCase;
+    testrun_t *pRun;
+    uint32_t i;
+
+    for (testCase = TEST_I2C_IRQ; testCase < TEST_CASES; testCase++)
+    {
+        pRun = &runs[testCase];
+        Test_Run(testCase, pRun);
+        (void)BusBench_Format(&pRun->bench, s_caseName[testCase], HOST_CPU_CLOCK_HZ, text, sizeof(text));
+        printf("%s\r\n %u samples, %u polls, %u mode changes, %u wake events\r\n", text, pRun->replayed, pRun->polls,
+               pRun->numChanges, pRun->model.wakeEvents);
+
+        /* Every sample comes out once, whole and in order, and the buffer never overflows. */
+        TEST_CHECK(!pRun->mismatch);
+        TEST_CHECK(!pRun->overflow);
+        TEST_CHECK_EQUAL(pRun->drained + pRun->model.bufferCount, pRun->replayed);
+        TEST_CHECK_EQUAL(pRun->bench.drains * FXLS8974_FIFO_WATERMARK, pRun->bench.samples);
+        TEST_CHECK_EQUAL(pRun->bench.samples, pRun->drained);
+        /* The benchmark spans at least the bus time of the drains. */
+        TEST_CHECK(pRun->bench.busCycles * 1000U >= pRun->busTime_ns * (HOST_CPU_CLOCK_HZ / 1000000U));
+        /* The part sleeps at rest and the second knock wakes it. */
+        TEST_CHECK_EQUAL(pRun->model.wakeEvents, 1U);
+        TEST_CHECK_EQUAL(pRun->numChanges, 2U);
+        TEST_CHECK_EQUAL(pRun->changes[0], FXLS8974_SYS_MODE_SYS_MODE_SLEEP);
+        TEST_CHECK_EQUAL(pRun->changes[1], FXLS8974_SYS_MODE_SYS_MODE_WAKE);
+
+        /* Same detection whatever the transport. */
+        TEST_CHECK_EQUAL(pRun->replayed, runs[TEST_I2C_IRQ].replayed);
+        TEST_CHECK_EQUAL(pRun->checksum, runs[TEST_I2C_IRQ].checksum);
+        TEST_CHECK_EQUAL(pRun->polls, runs[TEST_I2C_IRQ].polls);
+        for (i = 0U; i < pRun->numChanges; i++)
+        {
+            TEST_CHECK_EQUAL(pRun->changes[i], runs[TEST_I2C_IRQ].changes[i]);
+        }
+    }
+
+    /* Spinning, the CPU is held for the whole drain. */
+    TEST_CHECK_EQUAL(runs[TEST_I2C_IRQ].bench.sleepCycles, 0U);
+    TEST_CHECK_EQUAL(runs[TEST_SPI_IRQ].bench.sleepCycles, 0U);
+    /* 4 MHz SPI against 400 kHz I2C: the bus time per sample drops by far more than a factor 5. */
+    TEST_CHECK(Test_BusPerSample(&runs[TEST_SPI_IRQ]) * 5U < Test_BusPerSample(&runs[TEST_I2C_IRQ]));
+    TEST_CHECK(Test_BusPerSample(&runs[TEST_SPI_DMA]) * 5U < Test_BusPerSample(&runs[TEST_I2C_DMA]));
+    /* eDMA frees the CPU on both transports. */
+    TEST_CHECK(Test_CpuPerSample(&runs[TEST_I2C_DMA]) * 5U < Test_CpuPerSample(&runs[TEST_I2C_IRQ]));
+    TEST_CHECK(Test_CpuPerSample(&runs[TEST_SPI_DMA]) < Test_CpuPerSample(&runs[TEST_SPI_IRQ]));
+    TEST_CHECK(Test_CpuPerSample(&runs[TEST_SPI_IRQ]) < Test_CpuPerSample(&runs[TEST_I2C_IRQ]));
+}
+
+int main(void)
+{
+    Test_Frames();
+    Test_Compare();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,423 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file test_fxls8974_wake.c
+ * @brief The test_fxls8974_wake.c file replays an hour of knocks through the FXLS8974 register model and injects
+ *        the WAKE_OUT edges on INT1 as FXLS8974_WAKE_IRQ_MODE handles them: the pin interrupt posts the deferred
+ *        handler, which runs the SLEEP/WAKE state machine, and a 10 s watchdog reads SYS_MODE asynchronously. The
+ *        same hour through the 100 ms SYS_MODE poll it replaced gives the baseline. Each reports the edge to alert
+ *        latency and the I2C transactions per hour, and both are checked against fixed bounds so a regression of
+ *        the interrupt path fails the test. The task switch is not modelled, only the bus time is.
+ */
+
+#include "test_util.h"
+#include "host_cpu.h"
+#include "host_i2c.h"
+#include "sim_fxls8974.h"
+#include "fxls89xx_motion_wakeup.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_NS_PER_MS      (1000000ULL)
+#define TEST_HOUR_NS        (3600000ULL * TEST_NS_PER_MS)
+#define TEST_WAKE_STEP_NS   (FXLS8974_WAKE_SAMPLE_PERIOD_US * 1000ULL)
+#define TEST_SLEEP_STEP_NS  (FXLS8974_SLEEP_SAMPLE_PERIOD_US * 1000ULL)
+#define TEST_POLL_MS        (100U)   /* mfxls89xxIntervalInMs_c of the polling firmware. */
+#define TEST_WATCHDOG_MS    (10000U) /* mfxls89xxWatchdogIntervalInMs_c. */
+#define TEST_KNOCKS         (12U)    /* One every 5 minutes. */
+#define TEST_KNOCK_PERIOD_NS (300000ULL * TEST_NS_PER_MS)
+#define TEST_KNOCK_ON_POLL  (6U)     /* This knock lands on a watchdog read, its edge has to wait for the bus. */
+#define TEST_QUEUE_DEPTH    (4U)
+
+/* Regression bounds of the interrupt path: the alert goes out within a millisecond of the edge, and the bus is
+ * used for the watchdog reads and a few reads per knock only. */
+#define TEST_MAX_IRQ_LATENCY_NS  (1000000ULL)
+#define TEST_MAX_IRQ_XFERS_HOUR  (1000U)
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+typedef enum
+{
+    TEST_WAKE_IRQ = 0, /* FXLS8974_WAKE_IRQ_MODE, INT1 edges and the watchdog read. */
+    TEST_WAKE_POLL,    /* The SYS_MODE poll every 100 ms. */
+    TEST_WAKES
+} testwake_t;
+
+typedef void (*testhandler_t)(void *pParam);
+
+typedef struct
+{
+    testwake_t wake;
+    simfxls8974_t model;
+    fxls8974_i2c_sensorhandle_t handle;
+    registerasyncxfer_t sysModeXfer;
+    uint8_t sysMode;
+    volatile bool sysModeBusy;
+    volatile bool irqPending;
+    volatile bool irqDeferred;
+    bool pin;
+    uint64_t timer_ns;
+    uint64_t next_ns;
+    /* The state machine of fxls89xx_handle_mode(). */
+    uint8_t sleeptowake;
+    uint8_t waketosleep;
+    uint8_t firsttransition;
+    /* Results. */
+    bool edgePending;
+    uint64_t edge_ns;
+    uint64_t worstLatency_ns;
+    uint64_t totalLatency_ns;
+    uint32_t alerts;
+    uint32_t safes;
+    uint32_t edges;
+    uint32_t deferred;
+    uint32_t polls;
+} testrun_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static const char *const s_wakeName[TEST_WAKES] = {"INT1", "100 ms poll"};
+static testrun_t *s_pRun;
+static testhandler_t s_queue[TEST_QUEUE_DEPTH];
+static uint32_t s_queueCount;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void Test_Int1Handler(void *pParam);
+
+/* App_PostCallbackMessage(), the message runs in the application task. */
+static bool Test_Post(testhandler_t handler)
+{
+    if (s_queueCount >= TEST_QUEUE_DEPTH)
+    {
+        return false;
+    }
+    s_queue[s_queueCount++] = handler;
+
+    return true;
+}
+
+/* The application task, runs the posted messages in order. */
+static void Test_RunTask(void)
+{
+    testhandler_t handler;
+    uint32_t i;
+
+    while (s_queueCount != 0U)
+    {
+        handler = s_queue[0];
+        for (i = 1U; i < s_queueCount; i++)
+        {
+            s_queue[i - 1U] = s_queue[i];
+        }
+        s_queueCount--;
+        handler(NULL);
+    }
+}
+
+/* fxls89xx_handle_mode() with binary alerts and no FIFO capture. */
+static void Test_HandleMode(testrun_t *pRun, uint8_t sysMode)
+{
+    uint8_t intStatus = 0U;
+    uint64_t latency_ns;
+
+    if (sysMode == FXLS8974_SYS_MODE_SYS_MODE_WAKE)
+    {
+        TEST_CHECK_EQUAL(FXLS8974_I2C_ReadData(&pRun->handle, cFxls8974IntEn, &intStatus), SENSOR_ERROR_NONE);
+        if ((intStatus & FXLS8974_INT_STATUS_SRC_DRDY_MASK) == 0x80)
+        {
+            if (pRun->sleeptowake == 1U)
+            {
+                /* fxls89xx_send_event(), the alert is out. */
+                pRun->alerts++;
+                TEST_CHECK(pRun->edgePending);
+                if (pRun->edgePending)
+                {
+                    latency_ns = HostCpu_Now_ns() - pRun->edge_ns;
+                    pRun->totalLatency_ns += latency_ns;
+                    if (latency_ns > pRun->worstLatency_ns)
+                    {
+                        pRun->worstLatency_ns = latency_ns;
+                    }
+                    pRun->edgePending = false;
+                }
+                pRun->sleeptowake = 0U;
+            }
+            pRun->waketosleep = 1U;
+        }
+    }
+    else
+    {
+        if ((pRun->waketosleep == 1U) || (pRun->firsttransition == 1U))
+        {
+            TEST_CHECK_EQUAL(FXLS8974_I2C_ReadData(&pRun->handle, cFxls8974ReadIntStatus, &intStatus),
+                             SENSOR_ERROR_NONE);
+            pRun->safes++;
+            pRun->waketosleep = 0U;
+            pRun->firsttransition = 0U;
+        }
+        pRun->sleeptowake = 1U;
+    }
+}
+
+/* fxls89xx_DeferIrq() */
+static bool Test_DeferIrq(testrun_t *pRun)
+{
+    bool busy;
+    uint32_t primask;
+
+    primask = HostCpu_DisableIrq();
+    busy = Register_I2C_IsAsyncBusy(&pRun->handle.deviceInfo);
+    if (busy)
+    {
+        pRun->irqDeferred = true;
+        pRun->deferred++;
+    }
+    HostCpu_EnableIrq(primask);
+
+    return busy;
+}
+
+/* fxls89xx_SysModeHandler() with fxls89xx_ResumeIrq(FALSE). */
+static void Test_SysModeHandler(void *pParam)
+{
+    testrun_t *pRun = s_pRun;
+
+    (void)pParam;
+    pRun->sysModeBusy = false;
+    Test_HandleMode(pRun, pRun->sysMode);
+    if (pRun->irqDeferred)
+    {
+        pRun->irqDeferred = false;
+        Test_Int1Handler(NULL);
+    }
+}
+
+/* fxls89xx_SysModeReadCallback(), in the I2C interrupt. */
+static void Test_SysModeReadCallback(int32_t status, void *pParam)
+{
+    (void)pParam;
+
+    TEST_CHECK_EQUAL(status, ARM_DRIVER_OK);
+    if ((status != ARM_DRIVER_OK) || !Test_Post(Test_SysModeHandler))
+    {
+        s_pRun->sysModeBusy = false;
+    }
+}
+
+/* fxls89_xx_TimerCallback(): the watchdog queues the SYS_MODE read, the poll reads it and runs the state machine. */
+static void Test_TimerCallback(testrun_t *pRun)
+{
+    uint8_t sysMode = 0U;
+
+    pRun->polls++;
+    if (pRun->wake == TEST_WAKE_POLL)
+    {
+        TEST_CHECK_EQUAL(FXLS8974_I2C_ReadData(&pRun->handle, cFxls8974ReadSysMode, &sysMode), SENSOR_ERROR_NONE);
+        Test_HandleMode(pRun, sysMode);
+        return;
+    }
+    if (pRun->sysModeBusy)
+    {
+        return;
+    }
+    pRun->sysModeBusy = true;
+    TEST_CHECK_EQUAL(FXLS8974_I2C_ReadDataAsync(&pRun->handle, &pRun->sysModeXfer, cFxls8974ReadSysMode,
+                                                &pRun->sysMode, Test_SysModeReadCallback, NULL),
+                     SENSOR_ERROR_NONE);
+}
+
+/* fxls89xx_Int1Handler(): the pin level mirrors SYS_MODE. */
+static void Test_Int1Handler(void *pParam)
+{
+    testrun_t *pRun = s_pRun;
+
+    (void)pParam;
+    if (Test_DeferIrq(pRun))
+    {
+        return;
+    }
+    pRun->irqPending = false;
+    Test_HandleMode(pRun, SimFxls8974_WakeOut(&pRun->model) ? FXLS8974_SYS_MODE_SYS_MODE_WAKE :
+                                                               FXLS8974_SYS_MODE_SYS_MODE_SLEEP);
+}
+
+/* fxls89xx_Int1Callback(), the PORT interrupt of either edge. */
+static void Test_Int1Callback(uint32_t arg)
+{
+    testrun_t *pRun = s_pRun;
+
+    (void)arg;
+    if (!pRun->irqPending)
+    {
+        pRun->irqPending = true;
+        if (!Test_Post(Test_Int1Handler))
+        {
+            pRun->irqPending = false;
+        }
+    }
+}
+
+/* The application task until idle, it wakes up for the completion of the SYS_MODE read in flight. */
+static void Test_Idle(testrun_t *pRun)
+{
+    Test_RunTask();
+    while (Register_I2C_IsAsyncBusy(&pRun->handle.deviceInfo))
+    {
+        HostCpu_WaitForInterrupt();
+        Test_RunTask();
+    }
+}
+
+/* Sleeps until the given time, the periodic timer fires on the way as fxls89_xx_CallBack() does. */
+static void Test_SleepUntil(testrun_t *pRun, uint64_t time_ns)
+{
+    while (pRun->timer_ns <= time_ns)
+    {
+        HostCpu_SleepUntil_ns(pRun->timer_ns);
+        Test_TimerCallback(pRun);
+        pRun->timer_ns += (uint64_t)((pRun->wake == TEST_WAKE_POLL) ? TEST_POLL_MS : TEST_WATCHDOG_MS) * TEST_NS_PER_MS;
+        if (HostCpu_Now_ns() >= time_ns)
+        {
+            /* The sample is due while the read is on the bus, its edge comes before the completion. */
+            return;
+        }
+        Test_Idle(pRun);
+    }
+    HostCpu_SleepUntil_ns(time_ns);
+    Test_Idle(pRun);
+}
+
+/* One sample at the ODR of the current mode, WAKE_OUT edges raise the PORT interrupt. */
+static void Test_Sample(testrun_t *pRun, int16_t x, int16_t y, int16_t z)
+{
+    uint32_t wakeEvents = pRun->model.wakeEvents;
+    bool pin;
+
+    Test_SleepUntil(pRun, pRun->next_ns);
+    SimFxls8974_Sample(&pRun->model, x, y, z);
+    if (pRun->model.wakeEvents != wakeEvents)
+    {
+        pRun->edgePending = true;
+        pRun->edge_ns = HostCpu_Now_ns();
+    }
+
+    pin = SimFxls8974_WakeOut(&pRun->model);
+    if ((pRun->wake == TEST_WAKE_IRQ) && (pin != pRun->pin))
+    {
+        pRun->edges++;
+        TEST_CHECK(HostCpu_Pend(Test_Int1Callback, 0U, 0U));
+        HostCpu_Service();
+    }
+    Test_Idle(pRun);
+    pRun->pin = pin;
+
+    pRun->next_ns += (SimFxls8974_SysMode(&pRun->model) == FXLS8974_SYS_MODE_SYS_MODE_WAKE) ? TEST_WAKE_STEP_NS :
+                                                                                                TEST_SLEEP_STEP_NS;
+}
+
+static void Test_Run(testwake_t wake, testrun_t *pRun)
+{
+    uint64_t knock_ns = TEST_KNOCK_PERIOD_NS / 2U;
+    uint32_t knocks = 0U;
+    uint8_t whoAmI = 0U;
+
+    memset(pRun, 0, sizeof(testrun_t));
+    pRun->wake = wake;
+    pRun->firsttransition = 1U;
+    s_pRun = pRun;
+    s_queueCount = 0U;
+    HostCpu_Reset();
+    HostI2C_Reset();
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.Initialize(I2C_S_SIGNAL_EVENT), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.PowerControl(ARM_POWER_FULL), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.Control(ARM_I2C_BUS_SPEED, ARM_I2C_BUS_SPEED_FAST), ARM_DRIVER_OK);
+    SimFxls8974_Init(&pRun->model, FXLS8974_DEVICE_ADDRESS_SA0_0, FXLS8974_WHOAMI_VALUE);
+    TEST_CHECK_EQUAL(FXLS8974_I2C_Initialize(&pRun->handle, &I2C_S_DRIVER, I2C_S_DEVICE_INDEX,
+                                             FXLS8974_DEVICE_ADDRESS_SA0_0, &whoAmI),
+                     SENSOR_ERROR_NONE);
+    TEST_CHECK_EQUAL(FXLS8974_I2C_Configure(&pRun->handle, cFxls8974AwsConfig), SENSOR_ERROR_NONE);
+
+    /* The count starts once configured, WAKE_OUT is already high then and the first edge is the fall to SLEEP. */
+    HostI2C_ClearStats();
+    pRun->pin = SimFxls8974_WakeOut(&pRun->model);
+    pRun->next_ns = HostCpu_Now_ns();
+    pRun->timer_ns = HostCpu_Now_ns() +
+                     (uint64_t)((wake == TEST_WAKE_POLL) ? TEST_POLL_MS : TEST_WATCHDOG_MS) * TEST_NS_PER_MS;
+    while (pRun->next_ns < TEST_HOUR_NS)
+    {
+        if ((knocks < TEST_KNOCKS) && (pRun->next_ns >= knock_ns))
+        {
+            /* The part samples at its own ODR, the knock starts a fresh sample period. */
+            pRun->next_ns = (knocks == TEST_KNOCK_ON_POLL) ? pRun->timer_ns : knock_ns;
+            Test_Sample(pRun, 400, 0, FXLS8974_ONE_G_COUNTS);
+            Test_Sample(pRun, -300, 0, FXLS8974_ONE_G_COUNTS);
+            knocks++;
+            knock_ns += TEST_KNOCK_PERIOD_NS;
+        }
+        Test_Sample(pRun, 0, 0, FXLS8974_ONE_G_COUNTS);
+    }
+    Test_SleepUntil(pRun, TEST_HOUR_NS);
+    TEST_CHECK_EQUAL(knocks, TEST_KNOCKS);
+}
+
+static void Test_Hour(void)
+{
+    static testrun_t runs[TEST_WAKES];
+    hosti2cstats_t stats[TEST_WAKES];
+    testwake_t wake;
+    testrun_t *pRun;
+
+    for (wake = TEST_WAKE_IRQ; wake < TEST_WAKES; wake++)
+    {
+        pRun = &runs[wake];
+        Test_Run(wake, pRun);
+        HostI2C_GetStats(&stats[wake]);
+        printf("%-11s: %5u I2C transactions per hour, %u polls, %u edges, %u deferred, latency %llu us worst, "
+               "%llu us mean\r\n",
+               s_wakeName[wake], stats[wake].transfers, pRun->polls, pRun->edges, pRun->deferred,
+               (unsigned long long)(pRun->worstLatency_ns / 1000U),
+               (unsigned long long)(pRun->totalLatency_ns / 1000U / ((pRun->alerts != 0U) ? pRun->alerts : 1U)));
+
+        /* Every knock alerts once, and the part is declared safe after each and once after start up. */
+        TEST_CHECK_EQUAL(pRun->model.wakeEvents, TEST_KNOCKS);
+        TEST_CHECK_EQUAL(pRun->alerts, TEST_KNOCKS);
+        TEST_CHECK_EQUAL(pRun->safes, TEST_KNOCKS + 1U);
+        TEST_CHECK(!pRun->edgePending);
+        TEST_CHECK_EQUAL(stats[wake].nacks, 0U);
+        TEST_CHECK_EQUAL(stats[wake].refused, 0U);
+    }
+
+    /* Two edges per knock and the first fall to SLEEP, none lost, and the one on the watchdog read waited for it. */
+    pRun = &runs[TEST_WAKE_IRQ];
+    TEST_CHECK_EQUAL(pRun->edges, 2U * TEST_KNOCKS + 1U);
+    TEST_CHECK(pRun->deferred >= 1U);
+    TEST_CHECK(!pRun->irqPending);
+    TEST_CHECK(!pRun->irqDeferred);
+    /* The watchdog starts once configured, its last expiry falls just after the hour. */
+    TEST_CHECK_EQUAL(pRun->polls, (uint32_t)(TEST_HOUR_NS / (TEST_WATCHDOG_MS * TEST_NS_PER_MS)) - 1U);
+    TEST_CHECK(pRun->worstLatency_ns < TEST_MAX_IRQ_LATENCY_NS);
+    TEST_CHECK(stats[TEST_WAKE_IRQ].transfers < TEST_MAX_IRQ_XFERS_HOUR);
+
+    /* The poll reads SYS_MODE every 100 ms and sees a knock up to a poll period late. */
+    pRun = &runs[TEST_WAKE_POLL];
+    TEST_CHECK(stats[TEST_WAKE_POLL].transfers >= 2U * pRun->polls);
+    TEST_CHECK(pRun->worstLatency_ns <= (TEST_POLL_MS + 1U) * TEST_NS_PER_MS);
+    TEST_CHECK(stats[TEST_WAKE_IRQ].transfers * 50U < stats[TEST_WAKE_POLL].transfers);
+    TEST_CHECK(runs[TEST_WAKE_IRQ].worstLatency_ns * 50U < runs[TEST_WAKE_POLL].worstLatency_ns);
+}
+
+int main(void)
+{
+    Test_Hour();
+
+    return TEST_RESULT();
+}
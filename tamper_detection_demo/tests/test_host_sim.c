@@ -0,0 +1,283 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file test_host_sim.c
+ * @brief The test_host_sim.c file checks the host simulator end to end: the unchanged sensor drivers and
+ *        register_io_i2c.c talk to the three register models over the simulated I2C bus at
+ *        ARM_I2C_BUS_SPEED_FAST, and the bus time counter agrees with the bytes moved.
+ */
+
+#include "test_util.h"
+#include "issdk_hal.h"
+#include "host_cpu.h"
+#include "host_i2c.h"
+#include "sim_fxls8974.h"
+#include "sim_mpl3115.h"
+#include "sim_nmh1000.h"
+#include "trace_replay.h"
+#include "fxls8974_drv.h"
+#include "mpl3115_drv.h"
+#include "nmh1000_drv.h"
+#include "nmh1000_click.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_FXLS_WATERMARK (16U)
+#define TEST_MPL_SAMPLES    (10U)
+#define TEST_NMH_ASSERT     (16U)
+#define TEST_NMH_CLEAR      (8U)
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+typedef struct
+{
+    simfxls8974_t model;
+    fxls8974_i2c_sensorhandle_t handle;
+    uint32_t replayed;
+    uint32_t drained;
+    uint32_t drains;
+    bool mismatch;
+    int16_t expected[SIM_FXLS8974_BUFFER_DEPTH][3];
+} testfxls_t;
+
+typedef struct
+{
+    simnmh1000_t model;
+    nmh1000_i2c_sensorhandle_t handle;
+    bool open;
+    uint32_t changes;
+    bool pinMismatch;
+} testnmh_t;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void Test_BusInit(void)
+{
+    HostCpu_Reset();
+    HostI2C_Reset();
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.Initialize(I2C_S_SIGNAL_EVENT), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.PowerControl(ARM_POWER_FULL), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.Control(ARM_I2C_BUS_SPEED, ARM_I2C_BUS_SPEED_FAST), ARM_DRIVER_OK);
+}
+
+static void Test_FxlsDrain(testfxls_t *pTest)
+{
+    fxls8974_acceldata_t samples[FXLS8974_BUF_MAX_SAMPLES];
+    uint8_t count = 0;
+    uint8_t status = 0;
+    uint8_t i;
+
+    TEST_CHECK_EQUAL(FXLS8974_I2C_ReadBuffer(&pTest->handle, samples, FXLS8974_BUF_MAX_SAMPLES, 0, 0, &count,
+                                             &status),
+                     SENSOR_ERROR_NONE);
+    for (i = 0; i < count; i++)
+    {
+        if ((samples[i].accel[0] != pTest->expected[i][0]) || (samples[i].accel[1] != pTest->expected[i][1]) ||
+            (samples[i].accel[2] != pTest->expected[i][2]))
+        {
+            pTest->mismatch = true;
+        }
+    }
+    pTest->drained += count;
+    pTest->drains++;
+}
+
+static bool Test_FxlsSample(void *pContext, const tracesample_t *pSample)
+{
+    testfxls_t *pTest = (testfxls_t *)pContext;
+    uint8_t queued = pTest->model.bufferCount;
+
+    pTest->expected[queued][0] = (int16_t)pSample->value[0];
+    pTest->expected[queued][1] = (int16_t)pSample->value[1];
+    pTest->expected[queued][2] = (int16_t)pSample->value[2];
+    SimFxls8974_Sample(&pTest->model, (int16_t)pSample->value[0], (int16_t)pSample->value[1],
+                       (int16_t)pSample->value[2]);
+    pTest->replayed++;
+
+    if (pTest->model.reg[FXLS8974_BUF_STATUS] & FXLS8974_BUF_STATUS_BUF_WMRK_MASK)
+    {
+        Test_FxlsDrain(pTest);
+    }
+
+    return true;
+}
+
+/* Streams an accelerometer trace through the sample buffer and drains it at the watermark. */
+static void Test_Fxls8974(void)
+{
+    static testfxls_t test;
+    const registerwritelist_t config[] = {
+        {FXLS8974_BUF_CONFIG1, FXLS8974_BUF_CONFIG1_BUF_MODE_STREAM_MODE, FXLS8974_BUF_CONFIG1_BUF_MODE_MASK},
+        {FXLS8974_BUF_CONFIG2, TEST_FXLS_WATERMARK, FXLS8974_BUF_CONFIG2_BUF_WMRK_MASK},
+        {FXLS8974_SENS_CONFIG1, FXLS8974_SENS_CONFIG1_ACTIVE_ACTIVE, FXLS8974_SENS_CONFIG1_ACTIVE_MASK},
+        __END_WRITE_DATA__};
+    tracereplay_t trace;
+    hosti2cstats_t stats;
+    uint64_t drainTime;
+    uint8_t whoAmI = FXLS8974_WHOAMI_VALUE;
+
+    memset(&test, 0, sizeof(test));
+    Test_BusInit();
+    SimFxls8974_Init(&test.model, FXLS8974_DEVICE_ADDRESS_SA0_0, FXLS8974_WHOAMI_VALUE);
+
+    TEST_CHECK_EQUAL(FXLS8974_I2C_Initialize(&test.handle, &I2C_S_DRIVER, I2C_S_DEVICE_INDEX,
+                                             FXLS8974_DEVICE_ADDRESS_SA0_0, &whoAmI),
+                     SENSOR_ERROR_NONE);
+    TEST_CHECK_EQUAL(FXLS8974_I2C_Configure(&test.handle, config), SENSOR_ERROR_NONE);
+    TEST_CHECK_EQUAL(SimFxls8974_SysMode(&test.model), FXLS8974_SYS_MODE_SYS_MODE_WAKE);
+
+    TEST_CHECK(TraceReplay_Open(&trace, TEST_TRACE("accel_bump.csv")));
+    HostI2C_ClearStats();
+    TraceReplay_Run(&trace, Test_FxlsSample, &test);
+    TEST_CHECK(!trace.error);
+    TraceReplay_Close(&trace);
+
+    TEST_CHECK(test.replayed > 0U);
+    TEST_CHECK(!test.mismatch);
+    TEST_CHECK_EQUAL(test.drained + test.model.bufferCount, test.replayed);
+
+    /* Each drain is BUF_STATUS, then the watermark's worth of samples in one burst. */
+    HostI2C_GetStats(&stats);
+    drainTime = HostI2C_OperationTime_ns(1U, true) + HostI2C_OperationTime_ns(1U, false) +
+                HostI2C_OperationTime_ns(1U, true) +
+                HostI2C_OperationTime_ns(TEST_FXLS_WATERMARK * FXLS8974_BUF_SAMPLE_SIZE, false);
+    TEST_CHECK_EQUAL(stats.transfers, 4U * test.drains);
+    TEST_CHECK_EQUAL(stats.busTime_ns, drainTime * test.drains);
+    printf("FXLS8974: %u samples, %u drains of %u, %llu us bus time per drain at 400 kHz\r\n", test.replayed,
+           test.drains, TEST_FXLS_WATERMARK, (unsigned long long)(drainTime / 1000U));
+}
+
+/* Queues pressure samples in the FIFO and reads them back in one burst. */
+static void Test_Mpl3115(void)
+{
+    static simmpl3115_t model;
+    static mpl3115_i2c_sensorhandle_t handle;
+    const registerwritelist_t config[] = {
+        {MPL3115_F_SETUP, MPL3115_F_SETUP_F_MODE_CIR_MODE, MPL3115_F_SETUP_F_MODE_MASK},
+        {MPL3115_CTRL_REG1, MPL3115_CTRL_REG1_SBYB_ACTIVE, MPL3115_CTRL_REG1_SBYB_MASK},
+        __END_WRITE_DATA__};
+    mpl3115_pressuredata_t samples[MPL3115_FIFO_MAX_SAMPLES];
+    uint32_t expected[TEST_MPL_SAMPLES];
+    tracereplay_t trace;
+    tracesample_t sample;
+    uint8_t whoAmI = MPL3115_WHOAMI_VALUE;
+    uint8_t count = 0;
+    uint8_t status = 0;
+    uint8_t i;
+
+    Test_BusInit();
+    SimMpl3115_Init(&model, MPL3115_I2C_ADDRESS, MPL3115_WHOAMI_VALUE);
+
+    TEST_CHECK_EQUAL(MPL3115_I2C_Initialize(&handle, &I2C_S_DRIVER, I2C_S_DEVICE_INDEX, MPL3115_I2C_ADDRESS, &whoAmI),
+                     SENSOR_ERROR_NONE);
+    TEST_CHECK_EQUAL(MPL3115_I2C_Configure(&handle, config), SENSOR_ERROR_NONE);
+
+    TEST_CHECK(TraceReplay_Open(&trace, TEST_TRACE("pressure_door.csv")));
+    for (i = 0; (i < TEST_MPL_SAMPLES) && TraceReplay_Next(&trace, &sample); i++)
+    {
+        SimMpl3115_Sample(&model, (uint32_t)sample.value[0], (int16_t)sample.value[1]);
+        expected[i] = (uint32_t)sample.value[0] << 4;
+    }
+    TraceReplay_Close(&trace);
+    TEST_CHECK_EQUAL(i, TEST_MPL_SAMPLES);
+
+    TEST_CHECK_EQUAL(MPL3115_I2C_ReadFifo(&handle, samples, MPL3115_FIFO_MAX_SAMPLES, 0, 0, &count, &status),
+                     SENSOR_ERROR_NONE);
+    TEST_CHECK_EQUAL(count, TEST_MPL_SAMPLES);
+    TEST_CHECK_EQUAL(status & MPL3115_F_STATUS_F_OVF_MASK, 0U);
+    for (i = 0; i < count; i++)
+    {
+        TEST_CHECK_EQUAL(samples[i].pressure, expected[i]);
+    }
+    TEST_CHECK_EQUAL(model.fifoCount, 0U);
+}
+
+static bool Test_NmhSample(void *pContext, const tracesample_t *pSample)
+{
+    testnmh_t *pTest = (testnmh_t *)pContext;
+    const registerreadlist_t readList[] = {{NMH1000_STATUS, 1}, {NMH1000_OUT_M_REG, 1}, __END_READ_DATA__};
+    uint8_t data[2];
+    bool open;
+
+    SimNmh1000_Sample(&pTest->model, (uint8_t)pSample->value[0]);
+    TEST_CHECK_EQUAL(NMH1000_I2C_ReadData(&pTest->handle, readList, data), SENSOR_ERROR_NONE);
+    TEST_CHECK_EQUAL(data[1], pSample->value[0]);
+
+    /* The magnet holds OUT asserted while the door is closed. */
+    open = !(data[0] & NMH1000_STATUS_OUT_B_MASK);
+    if (open != pTest->open)
+    {
+        pTest->open = open;
+        pTest->changes++;
+    }
+    if (SimNmh1000_Out(&pTest->model) != !open)
+    {
+        pTest->pinMismatch = true;
+    }
+
+    return true;
+}
+
+/* Replays a door open and close through the switch thresholds. */
+static void Test_Nmh1000(void)
+{
+    static testnmh_t test;
+    const registerwritelist_t config[] = {
+        {NMH1000_USER_ASSERT_THRESH, TEST_NMH_ASSERT, 0xFF},
+        {NMH1000_USER_CLEAR_THRESH, TEST_NMH_CLEAR, 0xFF},
+        {NMH1000_CONTROL_REG1, NMH1000_CONTROL_REG1_AUTO_MODE_START, NMH1000_CONTROL_REG1_AUTO_MODE_MASK},
+        __END_WRITE_DATA__};
+    tracereplay_t trace;
+
+    memset(&test, 0, sizeof(test));
+    Test_BusInit();
+    SimNmh1000_Init(&test.model, NMH1000_I2C_ADDR_VAL);
+
+    TEST_CHECK_EQUAL(NMH1000_I2C_Initialize(&test.handle, &I2C_S_DRIVER, I2C_S_DEVICE_INDEX, NMH1000_I2C_ADDR_VAL,
+                                            NMH1000_WHO_AM_I_VALUE),
+                     SENSOR_ERROR_NONE);
+    TEST_CHECK_EQUAL(NMH1000_I2C_Configure(&test.handle, config), SENSOR_ERROR_NONE);
+
+    /* The door starts closed, opens once and closes once. */
+    test.open = true;
+    TEST_CHECK(TraceReplay_Open(&trace, TEST_TRACE("mag_door.csv")));
+    TraceReplay_Run(&trace, Test_NmhSample, &test);
+    TEST_CHECK(!trace.error);
+    TraceReplay_Close(&trace);
+
+    TEST_CHECK_EQUAL(test.changes, 3U);
+    TEST_CHECK(!test.open);
+    TEST_CHECK(!test.pinMismatch);
+}
+
+/* A device missing from the bus NACKs its address and the read fails. */
+static void Test_Nack(void)
+{
+    registerDeviceInfo_t deviceInfo = {0};
+    hosti2cstats_t stats;
+    uint8_t value;
+
+    Test_BusInit();
+    deviceInfo.deviceInstance = I2C_S_DEVICE_INDEX;
+    TEST_CHECK(Register_I2C_Read(&I2C_S_DRIVER, &deviceInfo, FXLS8974_DEVICE_ADDRESS_SA0_1, FXLS8974_WHO_AM_I, 1,
+                                 &value) != ARM_DRIVER_OK);
+    HostI2C_GetStats(&stats);
+    TEST_CHECK_EQUAL(stats.nacks, 1U);
+}
+
+int main(void)
+{
+    Test_Fxls8974();
+    Test_Mpl3115();
+    Test_Nmh1000();
+    Test_Nack();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,274 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file test_motion_features.c
+ * @brief The test_motion_features.c file checks the portable C kernel of MotionFeatures_Compute, the one built with
+ *        MOTION_FEATURES_DSP=0, against hand computed vectors, the edges of the 16-bit range and a wide reference
+ *        model on random windows, then times it per sample. The packed kernel gives bit-identical results by
+ *        design, the same vectors run on the target check it.
+ */
+
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include "test_util.h"
+#include "motion_features.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_MAX_SAMPLES   (255U) /* numSamples is 8 bits. */
+#define TEST_RANDOM_ROUNDS (2000U)
+#define TEST_BENCH_ROUNDS  (20000U)
+#define TEST_BENCH_SAMPLES (FXLS8974_BUF_MAX_SAMPLES)
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static fxls8974_acceldata_t s_samples[TEST_MAX_SAMPLES];
+static uint32_t s_seed = 0x2545F491UL;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static uint32_t Test_Random(void)
+{
+    s_seed = s_seed * 1664525UL + 1013904223UL;
+
+    return s_seed >> 8;
+}
+
+static void Test_Set(uint8_t index, int16_t x, int16_t y, int16_t z)
+{
+    s_samples[index].accel[0] = x;
+    s_samples[index].accel[1] = y;
+    s_samples[index].accel[2] = z;
+}
+
+/* The features computed in wide arithmetic straight from their definitions in motion_features.h. */
+static void Test_Reference(const fxls8974_acceldata_t *pSamples, uint8_t numSamples, motionfeatures_t *pFeatures)
+{
+    int64_t sum;
+    int64_t square;
+    int64_t delta;
+    int32_t min;
+    int32_t max;
+    uint64_t magnitude = 0U;
+    uint64_t value;
+    uint8_t axis;
+    uint8_t i;
+
+    memset(pFeatures, 0, sizeof(motionfeatures_t));
+    for (axis = 0U; axis < MOTION_FEATURES_AXES; axis++)
+    {
+        sum = 0;
+        square = 0;
+        min = INT16_MAX;
+        max = INT16_MIN;
+        for (i = 0U; i < numSamples; i++)
+        {
+            sum += pSamples[i].accel[axis];
+            square += (int64_t)pSamples[i].accel[axis] * pSamples[i].accel[axis];
+            min = (pSamples[i].accel[axis] < min) ? pSamples[i].accel[axis] : min;
+            max = (pSamples[i].accel[axis] > max) ? pSamples[i].accel[axis] : max;
+            if (i != 0U)
+            {
+                delta = (int64_t)pSamples[i].accel[axis] - pSamples[i - 1U].accel[axis];
+                delta = (delta > INT16_MAX) ? INT16_MAX : ((delta < INT16_MIN) ? INT16_MIN : delta);
+                pFeatures->jerkEnergy += (uint64_t)(delta * delta);
+            }
+        }
+        pFeatures->mean[axis] = (int16_t)llround((double)sum / numSamples);
+        pFeatures->variance[axis] = (uint32_t)((numSamples * square - sum * sum) / ((int64_t)numSamples * numSamples));
+        pFeatures->peakToPeak[axis] = (uint16_t)(max - min);
+    }
+    for (i = 0U; i < numSamples; i++)
+    {
+        value = 0U;
+        for (axis = 0U; axis < MOTION_FEATURES_AXES; axis++)
+        {
+            value += (uint64_t)((int64_t)pSamples[i].accel[axis] * pSamples[i].accel[axis]);
+        }
+        magnitude = (value > magnitude) ? value : magnitude;
+    }
+    value = (uint64_t)sqrt((double)magnitude);
+    while (value * value > magnitude)
+    {
+        value--;
+    }
+    while ((value + 1U) * (value + 1U) <= magnitude)
+    {
+        value++;
+    }
+    pFeatures->magnitude = (uint16_t)value;
+    pFeatures->numSamples = numSamples;
+}
+
+static bool Test_Equal(const motionfeatures_t *pActual, const motionfeatures_t *pExpected)
+{
+    bool equal = (pActual->jerkEnergy == pExpected->jerkEnergy) && (pActual->magnitude == pExpected->magnitude) &&
+                 (pActual->numSamples == pExpected->numSamples);
+    uint8_t axis;
+
+    for (axis = 0U; axis < MOTION_FEATURES_AXES; axis++)
+    {
+        equal = equal && (pActual->mean[axis] == pExpected->mean[axis]) &&
+                (pActual->variance[axis] == pExpected->variance[axis]) &&
+                (pActual->peakToPeak[axis] == pExpected->peakToPeak[axis]);
+    }
+
+    return equal;
+}
+
+static void Test_CheckWindow(uint8_t numSamples)
+{
+    motionfeatures_t actual;
+    motionfeatures_t expected;
+
+    MotionFeatures_Compute(s_samples, numSamples, &actual);
+    Test_Reference(s_samples, numSamples, &expected);
+    TEST_CHECK(Test_Equal(&actual, &expected));
+}
+
+/* Windows worked out by hand. */
+static void Test_Vectors(void)
+{
+    motionfeatures_t features;
+
+    /* Means 0, 0 and 5/3, variances 78/9, 24/9 and 224/9, changes (2,-4,-8) and (-7,2,12). */
+    Test_Set(0U, 1, 2, 3);
+    Test_Set(1U, 3, -2, -5);
+    Test_Set(2U, -4, 0, 7);
+    MotionFeatures_Compute(s_samples, 3U, &features);
+    TEST_CHECK_EQUAL(features.mean[0], 0);
+    TEST_CHECK_EQUAL(features.mean[1], 0);
+    TEST_CHECK_EQUAL(features.mean[2], 2);
+    TEST_CHECK_EQUAL(features.variance[0], 8U);
+    TEST_CHECK_EQUAL(features.variance[1], 2U);
+    TEST_CHECK_EQUAL(features.variance[2], 24U);
+    TEST_CHECK_EQUAL(features.peakToPeak[0], 7U);
+    TEST_CHECK_EQUAL(features.peakToPeak[1], 4U);
+    TEST_CHECK_EQUAL(features.peakToPeak[2], 12U);
+    TEST_CHECK_EQUAL(features.jerkEnergy, 84U + 197U);
+    TEST_CHECK_EQUAL(features.magnitude, 8U); /* sqrt(65) */
+    TEST_CHECK_EQUAL(features.numSamples, 3U);
+
+    /* A negative half rounds away from zero, -1.5 to -2. */
+    Test_Set(0U, -1, 0, 0);
+    Test_Set(1U, -2, 0, 0);
+    MotionFeatures_Compute(s_samples, 2U, &features);
+    TEST_CHECK_EQUAL(features.mean[0], -2);
+    TEST_CHECK_EQUAL(features.variance[0], 0U);
+    TEST_CHECK_EQUAL(features.jerkEnergy, 1U);
+    TEST_CHECK_EQUAL(features.magnitude, 2U);
+
+    /* One sample has no change, no samples clear the features. */
+    Test_Set(0U, 300, -400, 0);
+    MotionFeatures_Compute(s_samples, 1U, &features);
+    TEST_CHECK_EQUAL(features.mean[1], -400);
+    TEST_CHECK_EQUAL(features.jerkEnergy, 0U);
+    TEST_CHECK_EQUAL(features.magnitude, 500U);
+    MotionFeatures_Compute(s_samples, 0U, &features);
+    TEST_CHECK_EQUAL(features.numSamples, 0U);
+    TEST_CHECK_EQUAL(features.magnitude, 0U);
+}
+
+/* The edges of the 16-bit range: the squares, the sums and the saturated changes. */
+static void Test_Edges(void)
+{
+    motionfeatures_t features;
+    uint16_t i;
+
+    /* 255 samples of INT16_MIN: the largest sums and squares, 3 * 2^30 for the magnitude. */
+    for (i = 0U; i < TEST_MAX_SAMPLES; i++)
+    {
+        Test_Set((uint8_t)i, INT16_MIN, INT16_MIN, INT16_MIN);
+    }
+    MotionFeatures_Compute(s_samples, TEST_MAX_SAMPLES, &features);
+    TEST_CHECK_EQUAL(features.mean[0], INT16_MIN);
+    TEST_CHECK_EQUAL(features.variance[0], 0U);
+    TEST_CHECK_EQUAL(features.peakToPeak[0], 0U);
+    TEST_CHECK_EQUAL(features.jerkEnergy, 0U);
+    TEST_CHECK_EQUAL(features.magnitude, 56755U); /* floor(sqrt(3 * 2^30)) */
+    Test_CheckWindow(TEST_MAX_SAMPLES);
+
+    /* Full scale swings: +65535 saturates to INT16_MAX, -65535 to INT16_MIN. */
+    for (i = 0U; i < TEST_MAX_SAMPLES; i++)
+    {
+        Test_Set((uint8_t)i, ((i & 1U) == 0U) ? INT16_MIN : INT16_MAX, ((i & 1U) == 0U) ? INT16_MAX : INT16_MIN, 0);
+    }
+    MotionFeatures_Compute(s_samples, 2U, &features);
+    TEST_CHECK_EQUAL(features.jerkEnergy, 32767ULL * 32767U + 32768ULL * 32768U);
+    TEST_CHECK_EQUAL(features.peakToPeak[0], UINT16_MAX);
+    MotionFeatures_Compute(s_samples, 3U, &features);
+    TEST_CHECK_EQUAL(features.jerkEnergy, 2U * (32767ULL * 32767U + 32768ULL * 32768U));
+    Test_CheckWindow(2U);
+    Test_CheckWindow(3U);
+    Test_CheckWindow(TEST_MAX_SAMPLES);
+
+    /* The largest variance, half the samples at each end: (65535 / 2)^2 truncated, and a mean of -0.5 to -1. */
+    MotionFeatures_Compute(s_samples, 254U, &features);
+    TEST_CHECK_EQUAL(features.variance[0], 1073709056U);
+    TEST_CHECK_EQUAL(features.mean[0], -1);
+    Test_CheckWindow(254U);
+}
+
+/* Random windows of every length, full range and small motions. */
+static void Test_RandomWindows(void)
+{
+    uint32_t round;
+    uint8_t numSamples;
+    uint8_t i;
+    uint8_t axis;
+    int32_t value;
+
+    for (round = 0U; round < TEST_RANDOM_ROUNDS; round++)
+    {
+        numSamples = (uint8_t)(1U + (round % TEST_MAX_SAMPLES));
+        for (i = 0U; i < numSamples; i++)
+        {
+            for (axis = 0U; axis < MOTION_FEATURES_AXES; axis++)
+            {
+                value = (int32_t)(Test_Random() & 0xFFFFU) - 32768;
+                s_samples[i].accel[axis] = (int16_t)(((round & 1U) == 0U) ? value : (value >> 6));
+            }
+        }
+        Test_CheckWindow(numSamples);
+    }
+}
+
+/* Host time of one watermark drain of features, fxls89xx_buf_drain() runs it on every burst. */
+static void Test_Bench(void)
+{
+    motionfeatures_t features;
+    volatile uint32_t sink = 0U;
+    clock_t start;
+    double seconds;
+    uint32_t round;
+
+    start = clock();
+    for (round = 0U; round < TEST_BENCH_ROUNDS; round++)
+    {
+        s_samples[round % TEST_BENCH_SAMPLES].accel[0] = (int16_t)round;
+        MotionFeatures_Compute(s_samples, TEST_BENCH_SAMPLES, &features);
+        sink += features.magnitude;
+    }
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("MotionFeatures_Compute, C kernel: %.1f ns per sample on the host, %u samples per call\r\n",
+           seconds * 1e9 / ((double)TEST_BENCH_SAMPLES * TEST_BENCH_ROUNDS), TEST_BENCH_SAMPLES);
+}
+
+int main(void)
+{
+    Test_Vectors();
+    Test_Edges();
+    Test_RandomWindows();
+    Test_Bench();
+
+    return TEST_RESULT();
+}
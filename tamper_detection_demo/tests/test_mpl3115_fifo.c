@@ -0,0 +1,273 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file test_mpl3115_fifo.c
+ * @brief The test_mpl3115_fifo.c file checks the FIFO baseline of the MPL3115 application on the register model:
+ *        the watermark on INT1, a partial batch drained at the deadline, a late drain after the circular FIFO
+ *        overflowed, and the I2C and CPU cost against the STATUS/OUT polling of apply_autozero().
+ */
+
+#include "test_util.h"
+#include "host_cpu.h"
+#include "host_i2c.h"
+#include "sim_mpl3115.h"
+#include "mpl3115_pressure_wakeup.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_PRESSURE    (405300U) /* 101325 Pa in 1/4 Pa. */
+#define TEST_TEMPERATURE (0x1580)  /* 21.5 degC in 1/256 degC. */
+#define TEST_PERIOD_NS   ((uint64_t)MPL3115_SAMPLE_PERIOD_US * 1000U)
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t transfers;
+    uint64_t busTime_ns;
+    uint64_t active_ns;
+    uint32_t baseline;
+} testcost_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static simmpl3115_t s_model;
+static mpl3115_i2c_sensorhandle_t s_handle;
+static mpl3115_pressuredata_t s_samples[MPL3115_FIFO_MAX_SAMPLES];
+
+static const registerwritelist_t cTestActive[] = {
+    {MPL3115_CTRL_REG1, MPL3115_CTRL_REG1_SBYB_ACTIVE, MPL3115_CTRL_REG1_SBYB_MASK}, __END_WRITE_DATA__};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void Test_Init(void)
+{
+    uint8_t whoAmI = MPL3115_WHOAMI_VALUE;
+
+    HostCpu_Reset();
+    HostI2C_Reset();
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.Initialize(I2C_S_SIGNAL_EVENT), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.PowerControl(ARM_POWER_FULL), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.Control(ARM_I2C_BUS_SPEED, ARM_I2C_BUS_SPEED_FAST), ARM_DRIVER_OK);
+
+    SimMpl3115_Init(&s_model, MPL3115_I2C_ADDRESS, MPL3115_WHOAMI_VALUE);
+    TEST_CHECK_EQUAL(MPL3115_I2C_Initialize(&s_handle, &I2C_S_DRIVER, I2C_S_DEVICE_INDEX, MPL3115_I2C_ADDRESS, &whoAmI),
+                     SENSOR_ERROR_NONE);
+    TEST_CHECK_EQUAL(MPL3115_I2C_Configure(&s_handle, cMpl3115ConfigNormal), SENSOR_ERROR_NONE);
+    TEST_CHECK_EQUAL(MPL3115_I2C_Configure(&s_handle, cTestActive), SENSOR_ERROR_NONE);
+}
+
+/* The sensor converts one sample per acquisition period while the CPU sleeps. */
+static void Test_Acquire(uint32_t pressure)
+{
+    HostCpu_SleepUntil_ns(HostCpu_Now_ns() + TEST_PERIOD_NS);
+    SimMpl3115_Sample(&s_model, pressure, TEST_TEMPERATURE);
+}
+
+static uint8_t Test_Drain(uint8_t *pFifoStatus)
+{
+    uint8_t count = 0;
+
+    TEST_CHECK_EQUAL(MPL3115_I2C_ReadFifo(&s_handle, s_samples, MPL3115_FIFO_MAX_SAMPLES, 0, MPL3115_SAMPLE_PERIOD_US,
+                                          &count, pFifoStatus),
+                     SENSOR_ERROR_NONE);
+    return count;
+}
+
+/* A full batch raises INT1 at the watermark and averages in fixed point. */
+static void Test_Watermark(void)
+{
+    static const uint32_t pressure[NUM_AVG_SAMPLES] = {405300U, 405301U, 405303U, 405299U, 405302U};
+    uint8_t status = 0;
+    uint8_t count;
+    uint8_t i;
+
+    Test_Init();
+    TEST_CHECK_EQUAL(MPL3115_I2C_Configure(&s_handle, cMpl3115FifoStart), SENSOR_ERROR_NONE);
+    for (i = 0; i < NUM_AVG_SAMPLES; i++)
+    {
+        TEST_CHECK(!SimMpl3115_Int1(&s_model));
+        Test_Acquire(pressure[i]);
+    }
+    TEST_CHECK(SimMpl3115_Int1(&s_model));
+
+    count = Test_Drain(&status);
+    TEST_CHECK_EQUAL(count, NUM_AVG_SAMPLES);
+    TEST_CHECK(status & MPL3115_F_STATUS_F_WMKF_FLAG_MASK);
+    TEST_CHECK(!(status & MPL3115_F_STATUS_F_OVF_MASK));
+    TEST_CHECK(!SimMpl3115_Int1(&s_model));
+
+    /* 2026505 quarter Pa over 5 samples is 101325.25 Pa, rounded to 101325. */
+    TEST_CHECK_EQUAL(MPL3115_AveragePressure(s_samples, count), 101325U);
+    /* The fractions add up before the single division: 405302 and 405303 quarter Pa average 101325.625 Pa. */
+    s_samples[0].pressure = 405302U << 4;
+    s_samples[1].pressure = 405303U << 4;
+    TEST_CHECK_EQUAL(MPL3115_AveragePressure(s_samples, 2), 101326U);
+    TEST_CHECK_EQUAL(MPL3115_AveragePressure(s_samples, 0), 0U);
+
+    TEST_CHECK_EQUAL(MPL3115_I2C_Configure(&s_handle, cMpl3115FifoStop), SENSOR_ERROR_NONE);
+    TEST_CHECK_EQUAL(s_model.reg[MPL3115_F_SETUP] & MPL3115_F_SETUP_F_MODE_MASK, MPL3115_F_SETUP_F_MODE_FIFO_OFF);
+}
+
+/* A missed edge: the deadline drains a batch short of the watermark, an empty FIFO drains nothing. */
+static void Test_PartialBatch(void)
+{
+    uint8_t status = 0;
+    uint8_t count;
+    uint8_t i;
+
+    Test_Init();
+    TEST_CHECK_EQUAL(MPL3115_I2C_Configure(&s_handle, cMpl3115FifoStart), SENSOR_ERROR_NONE);
+    TEST_CHECK_EQUAL(Test_Drain(&status), 0U);
+
+    for (i = 0; i < NUM_AVG_SAMPLES - 2; i++)
+    {
+        Test_Acquire(TEST_PRESSURE + 4U * i);
+    }
+    TEST_CHECK(!SimMpl3115_Int1(&s_model));
+
+    count = Test_Drain(&status);
+    TEST_CHECK_EQUAL(count, NUM_AVG_SAMPLES - 2);
+    TEST_CHECK(!(status & MPL3115_F_STATUS_F_WMKF_FLAG_MASK));
+    /* 101325, 101326 and 101327 Pa. */
+    TEST_CHECK_EQUAL(MPL3115_AveragePressure(s_samples, count), 101326U);
+    /* Stamped backwards from the drain, one acquisition period apart. */
+    TEST_CHECK_EQUAL(s_samples[count - 1].timestamp, 0U);
+    TEST_CHECK_EQUAL(s_samples[0].timestamp, (uint32_t)(0U - (count - 1U) * MPL3115_SAMPLE_PERIOD_US));
+}
+
+/* A drain late by more than the FIFO depth: circular mode kept the newest samples and flagged the overflow. */
+static void Test_Overflow(void)
+{
+    const uint32_t total = MPL3115_FIFO_MAX_SAMPLES + 8U;
+    uint8_t status = 0;
+    uint8_t count;
+    uint32_t i;
+
+    Test_Init();
+    TEST_CHECK_EQUAL(MPL3115_I2C_Configure(&s_handle, cMpl3115FifoStart), SENSOR_ERROR_NONE);
+    for (i = 0; i < total; i++)
+    {
+        Test_Acquire(TEST_PRESSURE + i);
+    }
+    TEST_CHECK_EQUAL(s_model.overflows, total - MPL3115_FIFO_MAX_SAMPLES);
+
+    count = Test_Drain(&status);
+    TEST_CHECK_EQUAL(count, MPL3115_FIFO_MAX_SAMPLES);
+    TEST_CHECK(status & MPL3115_F_STATUS_F_OVF_MASK);
+    TEST_CHECK_EQUAL(s_samples[0].pressure, (TEST_PRESSURE + total - MPL3115_FIFO_MAX_SAMPLES) << 4);
+    TEST_CHECK_EQUAL(s_samples[count - 1].pressure, (TEST_PRESSURE + total - 1U) << 4);
+
+    /* Reading F_STATUS cleared the overflow, the next batch starts clean. */
+    Test_Acquire(TEST_PRESSURE);
+    TEST_CHECK_EQUAL(Test_Drain(&status), 1U);
+    TEST_CHECK(!(status & MPL3115_F_STATUS_F_OVF_MASK));
+}
+
+static void Test_CostStart(uint64_t *pStartSleep_ns, uint64_t *pStart_ns)
+{
+    HostI2C_ClearStats();
+    *pStart_ns = HostCpu_Now_ns();
+    *pStartSleep_ns = HostCpu_Sleep_ns();
+}
+
+static void Test_CostStop(testcost_t *pCost, uint64_t startSleep_ns, uint64_t start_ns)
+{
+    hosti2cstats_t stats;
+
+    HostI2C_GetStats(&stats);
+    pCost->transfers = stats.transfers;
+    pCost->busTime_ns = stats.busTime_ns;
+    pCost->active_ns = (HostCpu_Now_ns() - start_ns) - (HostCpu_Sleep_ns() - startSleep_ns);
+}
+
+/* apply_autozero(): STATUS is polled back to back until PTDR, then OUT_P/OUT_T is read, NUM_AVG_SAMPLES times. */
+static void Test_PollingBaseline(testcost_t *pCost)
+{
+    uint64_t nextSample_ns;
+    uint64_t startSleep_ns;
+    uint64_t start_ns;
+    uint32_t sum = 0;
+    uint8_t dataReady = 0;
+    uint8_t data[MPL3115_DATA_SIZE];
+    uint8_t i = 0;
+
+    Test_Init();
+    Test_CostStart(&startSleep_ns, &start_ns);
+    nextSample_ns = start_ns + TEST_PERIOD_NS;
+    while (i < NUM_AVG_SAMPLES)
+    {
+        if (HostCpu_Now_ns() >= nextSample_ns)
+        {
+            SimMpl3115_Sample(&s_model, TEST_PRESSURE, TEST_TEMPERATURE);
+            nextSample_ns += TEST_PERIOD_NS;
+        }
+        TEST_CHECK_EQUAL(MPL3115_I2C_ReadData(&s_handle, cMpl3115Status, &dataReady), SENSOR_ERROR_NONE);
+        if (dataReady & MPL3115_DR_STATUS_PTDR_MASK)
+        {
+            TEST_CHECK_EQUAL(MPL3115_I2C_ReadData(&s_handle, cMpl3115OutputNormal, data), SENSOR_ERROR_NONE);
+            sum += ((uint32_t)data[0] << 16 | (uint32_t)data[1] << 8 | data[2]) / MPL3115_PRESSURE_CONV_FACTOR;
+            i++;
+        }
+    }
+    Test_CostStop(pCost, startSleep_ns, start_ns);
+    pCost->baseline = sum / NUM_AVG_SAMPLES;
+}
+
+/* MPL3115_FIFO_BASELINE_MODE: the CPU sleeps until INT1, then one F_STATUS read and one F_DATA burst. */
+static void Test_FifoBaseline(testcost_t *pCost)
+{
+    uint64_t startSleep_ns;
+    uint64_t start_ns;
+    uint8_t count;
+
+    Test_Init();
+    Test_CostStart(&startSleep_ns, &start_ns);
+    TEST_CHECK_EQUAL(MPL3115_I2C_Configure(&s_handle, cMpl3115FifoStart), SENSOR_ERROR_NONE);
+    while (!SimMpl3115_Int1(&s_model))
+    {
+        Test_Acquire(TEST_PRESSURE);
+    }
+    count = Test_Drain(NULL);
+    TEST_CHECK_EQUAL(count, NUM_AVG_SAMPLES);
+    pCost->baseline = MPL3115_AveragePressure(s_samples, count);
+    TEST_CHECK_EQUAL(MPL3115_I2C_Configure(&s_handle, cMpl3115FifoStop), SENSOR_ERROR_NONE);
+    Test_CostStop(pCost, startSleep_ns, start_ns);
+}
+
+static void Test_Cost(void)
+{
+    testcost_t polling;
+    testcost_t fifo;
+
+    Test_PollingBaseline(&polling);
+    Test_FifoBaseline(&fifo);
+    printf("baseline polling: %u transfers, %llu us bus, %llu us CPU\r\n", polling.transfers,
+           (unsigned long long)(polling.busTime_ns / 1000U), (unsigned long long)(polling.active_ns / 1000U));
+    printf("baseline fifo   : %u transfers, %llu us bus, %llu us CPU\r\n", fifo.transfers,
+           (unsigned long long)(fifo.busTime_ns / 1000U), (unsigned long long)(fifo.active_ns / 1000U));
+
+    TEST_CHECK_EQUAL(fifo.baseline, polling.baseline);
+    /* An order of magnitude at least, on the bus and on the CPU. */
+    TEST_CHECK(fifo.transfers * 10U <= polling.transfers);
+    TEST_CHECK(fifo.busTime_ns * 10U <= polling.busTime_ns);
+    TEST_CHECK(fifo.active_ns * 10U <= polling.active_ns);
+}
+
+int main(void)
+{
+    Test_Watermark();
+    Test_PartialBatch();
+    Test_Overflow();
+    Test_Cost();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file test_mpl3115_window.c
+ * @brief The test_mpl3115_window.c file replays pressure traces through the window detection of the MPL3115
+ *        application on the register model: FIFO baseline, P_TGT/P_WND centred on it, the alert on the INT1 edge,
+ *        and the re-baseline which re-centres the window. The INT1 handler follows mpl3115_fifo_drain(),
+ *        mpl3115_window_start() and mpl3115_window_alert() of wireless_uart.c with the same configuration lists.
+ */
+
+#include "test_util.h"
+#include "host_cpu.h"
+#include "host_i2c.h"
+#include "sim_mpl3115.h"
+#include "trace_replay.h"
+#include "mpl3115_pressure_wakeup.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_MAX_ALERTS  (4U)
+#define TEST_POLL_MS     (100U) /* Poll interval of the software comparison the window replaces. */
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+typedef enum
+{
+    TEST_BASELINE = 0, /* FIFO armed, waiting for the watermark. */
+    TEST_ARMED,        /* Window armed, waiting for the pressure to leave it. */
+} teststate_t;
+
+typedef struct
+{
+    simmpl3115_t model;
+    mpl3115_i2c_sensorhandle_t handle;
+    teststate_t state;
+    bool int1;
+    uint32_t refPressure;
+    uint32_t baselines;
+    uint32_t wakeups;
+    uint32_t alerts;
+    uint32_t alertTime_ms[TEST_MAX_ALERTS];
+    uint32_t alertRef[TEST_MAX_ALERTS];
+    uint32_t lastTime_ms;
+} testwindow_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static const registerwritelist_t cTestActive[] = {
+    {MPL3115_CTRL_REG1, MPL3115_CTRL_REG1_SBYB_ACTIVE, MPL3115_CTRL_REG1_SBYB_MASK}, __END_WRITE_DATA__};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void Test_Init(testwindow_t *pTest)
+{
+    uint8_t whoAmI = MPL3115_WHOAMI_VALUE;
+
+    memset(pTest, 0, sizeof(testwindow_t));
+    HostCpu_Reset();
+    HostI2C_Reset();
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.Initialize(I2C_S_SIGNAL_EVENT), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.PowerControl(ARM_POWER_FULL), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.Control(ARM_I2C_BUS_SPEED, ARM_I2C_BUS_SPEED_FAST), ARM_DRIVER_OK);
+
+    SimMpl3115_Init(&pTest->model, MPL3115_I2C_ADDRESS, MPL3115_WHOAMI_VALUE);
+    TEST_CHECK_EQUAL(
+        MPL3115_I2C_Initialize(&pTest->handle, &I2C_S_DRIVER, I2C_S_DEVICE_INDEX, MPL3115_I2C_ADDRESS, &whoAmI),
+        SENSOR_ERROR_NONE);
+    TEST_CHECK_EQUAL(MPL3115_I2C_Configure(&pTest->handle, cMpl3115ConfigNormal), SENSOR_ERROR_NONE);
+    TEST_CHECK_EQUAL(MPL3115_I2C_Configure(&pTest->handle, cTestActive), SENSOR_ERROR_NONE);
+
+    /* The first baseline is taken at start up. */
+    TEST_CHECK_EQUAL(MPL3115_I2C_Configure(&pTest->handle, cMpl3115FifoStart), SENSOR_ERROR_NONE);
+    pTest->state = TEST_BASELINE;
+}
+
+/* mpl3115_fifo_drain() then mpl3115_window_start(). */
+static void Test_Rebaseline(testwindow_t *pTest, uint32_t time_ms)
+{
+    mpl3115_pressuredata_t samples[MPL3115_FIFO_MAX_SAMPLES];
+    uint8_t count = 0;
+    uint8_t fifoStatus = 0;
+
+    TEST_CHECK_EQUAL(MPL3115_I2C_ReadFifo(&pTest->handle, samples, MPL3115_FIFO_MAX_SAMPLES, time_ms * 1000U,
+                                          MPL3115_SAMPLE_PERIOD_US, &count, &fifoStatus),
+                     SENSOR_ERROR_NONE);
+    TEST_CHECK_EQUAL(count, NUM_AVG_SAMPLES);
+    TEST_CHECK_EQUAL(fifoStatus & MPL3115_F_STATUS_F_OVF_MASK, 0U);
+    TEST_CHECK_EQUAL(MPL3115_I2C_Configure(&pTest->handle, cMpl3115FifoStop), SENSOR_ERROR_NONE);
+    pTest->refPressure = MPL3115_AveragePressure(samples, count);
+    pTest->baselines++;
+
+    TEST_CHECK_EQUAL(MPL3115_I2C_SetPressureWindow(&pTest->handle, pTest->refPressure, PRESSURE_THS),
+                     SENSOR_ERROR_NONE);
+    TEST_CHECK_EQUAL(MPL3115_I2C_Configure(&pTest->handle, cMpl3115WindowStart), SENSOR_ERROR_NONE);
+    pTest->state = TEST_ARMED;
+}
+
+/* mpl3115_window_alert(): read the pressure which left, mask the window, alert and re-baseline. */
+static void Test_Alert(testwindow_t *pTest, uint32_t time_ms)
+{
+    uint8_t data[MPL3115_DATA_SIZE];
+    uint32_t pressure;
+
+    TEST_CHECK_EQUAL(MPL3115_I2C_ReadData(&pTest->handle, cMpl3115OutputNormal, data), SENSOR_ERROR_NONE);
+    pressure = (((uint32_t)data[0] << 16) | ((uint32_t)data[1] << 8) | data[2]) / MPL3115_PRESSURE_CONV_FACTOR;
+    /* The window is 2 Pa coarse, anything past it by more than a step is a real crossing. */
+    TEST_CHECK((pressure + PRESSURE_THS + MPL3115_TARGET_CONV_FACTOR < pTest->refPressure) ||
+               (pressure > pTest->refPressure + PRESSURE_THS - MPL3115_TARGET_CONV_FACTOR));
+    TEST_CHECK_EQUAL(MPL3115_I2C_Configure(&pTest->handle, cMpl3115WindowStop), SENSOR_ERROR_NONE);
+
+    if (pTest->alerts < TEST_MAX_ALERTS)
+    {
+        pTest->alertTime_ms[pTest->alerts] = time_ms;
+        pTest->alertRef[pTest->alerts] = pTest->refPressure;
+    }
+    pTest->alerts++;
+
+    TEST_CHECK_EQUAL(MPL3115_I2C_Configure(&pTest->handle, cMpl3115FifoStart), SENSOR_ERROR_NONE);
+    pTest->state = TEST_BASELINE;
+}
+
+/* The sensor converts a sample, a rising INT1 edge wakes the MCU. */
+static bool Test_Sample(void *pContext, const tracesample_t *pSample)
+{
+    testwindow_t *pTest = (testwindow_t *)pContext;
+    bool int1;
+
+    SimMpl3115_Sample(&pTest->model, (uint32_t)pSample->value[0], (int16_t)pSample->value[1]);
+    pTest->lastTime_ms = pSample->time_ms;
+
+    int1 = SimMpl3115_Int1(&pTest->model);
+    if (int1 && !pTest->int1)
+    {
+        pTest->wakeups++;
+        if (pTest->state == TEST_BASELINE)
+        {
+            Test_Rebaseline(pTest, pSample->time_ms);
+        }
+        else
+        {
+            Test_Alert(pTest, pSample->time_ms);
+        }
+    }
+    pTest->int1 = SimMpl3115_Int1(&pTest->model);
+
+    return true;
+}
+
+static void Test_Replay(testwindow_t *pTest, const char *pPath)
+{
+    tracereplay_t trace;
+
+    Test_Init(pTest);
+    TEST_CHECK(TraceReplay_Open(&trace, pPath));
+    TEST_CHECK(TraceReplay_Run(&trace, Test_Sample, pTest) > 0U);
+    TEST_CHECK(!trace.error);
+    TraceReplay_Close(&trace);
+}
+
+/* A vent and a squeeze, each alerts once on its first sample past the window and moves the window with it. */
+static void Test_Tamper(void)
+{
+    static testwindow_t test;
+    uint64_t active_ns;
+
+    Test_Replay(&test, TEST_TRACE("pressure_tamper.csv"));
+    active_ns = HostCpu_Now_ns() - HostCpu_Sleep_ns();
+
+    TEST_CHECK_EQUAL(test.alerts, 2U);
+    TEST_CHECK_EQUAL(test.alertTime_ms[0], 100000U);
+    TEST_CHECK_EQUAL(test.alertTime_ms[1], 200000U);
+    /* Start up, then one re-baseline per alert. */
+    TEST_CHECK_EQUAL(test.baselines, 3U);
+    /* INT1 woke the MCU for nothing else, the window watched the drift alone. */
+    TEST_CHECK_EQUAL(test.wakeups, test.baselines + test.alerts);
+    /* Centred on the closed enclosure, then on the vented one; the drift stays inside the window. */
+    TEST_CHECK((test.alertRef[0] >= 101324U) && (test.alertRef[0] <= 101327U));
+    TEST_CHECK((test.alertRef[1] >= 101176U) && (test.alertRef[1] <= 101180U));
+    TEST_CHECK((test.refPressure >= 101299U) && (test.refPressure <= 101303U));
+    TEST_CHECK_EQUAL(test.state, TEST_ARMED);
+
+    printf("window: %u s, %u wakeups, %u us CPU; a %u ms poll wakes %u times\r\n", test.lastTime_ms / 1000U,
+           test.wakeups, (uint32_t)(active_ns / 1000U), TEST_POLL_MS, test.lastTime_ms / TEST_POLL_MS);
+}
+
+/* The 30 Pa door step stays inside the 60 Pa window: one baseline, no alert, no further wakeup. */
+static void Test_Door(void)
+{
+    static testwindow_t test;
+
+    Test_Replay(&test, TEST_TRACE("pressure_door.csv"));
+
+    TEST_CHECK_EQUAL(test.alerts, 0U);
+    TEST_CHECK_EQUAL(test.baselines, 1U);
+    TEST_CHECK_EQUAL(test.wakeups, 1U);
+    TEST_CHECK((test.refPressure >= 101324U) && (test.refPressure <= 101326U));
+}
+
+int main(void)
+{
+    Test_Tamper();
+    Test_Door();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,338 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file test_multi_sensor.c
+ * @brief The test_multi_sensor.c file runs the combined application, FXLS8974_MULTI_SENSOR_MODE, on one host I2C bus
+ *        with the FXLS8974, MPL3115 and NMH1000 models. The boot probe must register every part which answers its
+ *        WHO_AM_I and skip the others, one poll round must read SYS_MODE, the pressure and the field back to back
+ *        with the bus never idle in between, and the decode must raise the pressure and magnet events once on the
+ *        way out of the band and once on the way back. The round is compared with the three reads queued one timer
+ *        wakeup apart, the way the three single sensor applications poll.
+ */
+
+#include "test_util.h"
+#include "host_cpu.h"
+#include "host_i2c.h"
+#include "sim_fxls8974.h"
+#include "sim_mpl3115.h"
+#include "sim_nmh1000.h"
+#include "fxls89xx_motion_wakeup.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_PRESSURE       (101325U * 4U) /* 1/4 Pa. */
+#define TEST_PRESSURE_STEP  (200U * 4U)    /* Above MULTI_SENSOR_PRESSURE_THS. */
+#define TEST_FIELD          (5U)
+#define TEST_FIELD_STEP     (60U)          /* Above MULTI_SENSOR_MAG_THS. */
+#define TEST_QUIET_ROUNDS   (32U)
+#define TEST_MAX_EVENTS     (8U)
+#define TEST_NS_PER_US      (1000ULL)
+#define TEST_POLL_GAP_NS    (1000000ULL)   /* Timer wakeups of the single sensor applications, 1 ms apart. */
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+typedef struct
+{
+    uint8_t slot;
+    bool alert;
+    int32_t sample;
+    int32_t reference;
+    uint8_t whoAmI;
+} testevent_t;
+
+typedef struct
+{
+    simfxls8974_t fxls8974;
+    simmpl3115_t mpl3115;
+    simnmh1000_t nmh1000;
+    uint32_t rounds;
+    uint64_t done_ns;
+    uint32_t sysModes;
+    testevent_t events[TEST_MAX_EVENTS];
+    uint32_t numEvents;
+} testbus_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static testbus_t s_bus;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/* fxls89xx_engine_init() */
+static int32_t Test_FxlsInit(sensorengineslot_t *pSlot)
+{
+    int32_t status;
+    uint8_t whoami;
+    fxls8974_i2c_sensorhandle_t *pDriver = (fxls8974_i2c_sensorhandle_t *)pSlot->pHandle;
+
+    status = FXLS8974_I2C_Initialize(pDriver, &I2C_S_DRIVER, pSlot->pEngine->deviceInstance, pSlot->pOps->slaveAddress,
+                                     &whoami);
+    if (SENSOR_ERROR_NONE != status)
+    {
+        return status;
+    }
+    Register_I2C_AttachCache(&pDriver->deviceInfo, &fxls8974RegCache);
+    pSlot->pDevInfo = &pDriver->deviceInfo;
+
+    return SENSOR_ERROR_NONE;
+}
+
+/* fxls89xx_engine_configure() */
+static int32_t Test_FxlsConfigure(sensorengineslot_t *pSlot)
+{
+    return FXLS8974_I2C_Configure((fxls8974_i2c_sensorhandle_t *)pSlot->pHandle, cFxls8974AwsConfig);
+}
+
+/* fxls89xx_engine_decode(), the state machine is left to test_fxls8974_wake. */
+static void Test_FxlsDecode(sensorengineslot_t *pSlot)
+{
+    if (ARM_DRIVER_OK != pSlot->status)
+    {
+        return;
+    }
+    s_bus.sysModes++;
+}
+
+/* cFxls8974EngineOps with FXLS8974_MULTI_SENSOR_MODE, at the address of the other host tests. */
+static const sensorengineops_t cTestFxlsOps = {
+    .slaveAddress = FXLS8974_DEVICE_ADDRESS_SA0_0,
+    .whoAmIReg = FXLS8974_WHO_AM_I,
+    .pWhoAmIValues = cFxls8974WhoAmI,
+    .numWhoAmIValues = sizeof(cFxls8974WhoAmI),
+    .init = Test_FxlsInit,
+    .configure = Test_FxlsConfigure,
+    .pPollList = cFxls8974ReadSysMode,
+    .decode = Test_FxlsDecode,
+};
+
+/* fxls89xx_multi_event() */
+static void Test_Event(const sensorengineslot_t *pSlot, bool alert, int32_t sample, int32_t reference)
+{
+    testevent_t *pEvent;
+
+    TEST_CHECK(s_bus.numEvents < TEST_MAX_EVENTS);
+    if (s_bus.numEvents >= TEST_MAX_EVENTS)
+    {
+        return;
+    }
+    pEvent = &s_bus.events[s_bus.numEvents++];
+    pEvent->slot = (uint8_t)(pSlot - fxls8974Slots);
+    pEvent->alert = alert;
+    pEvent->sample = sample;
+    pEvent->reference = reference;
+    pEvent->whoAmI = pSlot->whoAmI;
+}
+
+/* fxls89xx_PollDone(), in the I2C interrupt. */
+static void Test_PollDone(void *pParam)
+{
+    (void)pParam;
+    TEST_CHECK(HostCpu_InIsr());
+    s_bus.rounds++;
+    s_bus.done_ns = HostCpu_Now_ns();
+}
+
+/* fxls89xx_int_BLE(): the bus, the models present and the probe. Returns the sensors found. */
+static uint8_t Test_Boot(bool pressure, bool magnet)
+{
+    memset(&s_bus, 0, sizeof(s_bus));
+    memset(fxls8974Slots, 0, sizeof(fxls8974Slots));
+    HostCpu_Reset();
+    HostI2C_Reset();
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.Initialize(I2C_S_SIGNAL_EVENT), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.PowerControl(ARM_POWER_FULL), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.Control(ARM_I2C_BUS_SPEED, ARM_I2C_BUS_SPEED_FAST), ARM_DRIVER_OK);
+    SimFxls8974_Init(&s_bus.fxls8974, FXLS8974_DEVICE_ADDRESS_SA0_0, FXLS8974_WHOAMI_VALUE);
+    if (pressure)
+    {
+        SimMpl3115_Init(&s_bus.mpl3115, MPL3115_I2C_ADDRESS, MPL3115_WHOAMI_VALUE);
+    }
+    if (magnet)
+    {
+        SimNmh1000_Init(&s_bus.nmh1000, MULTI_SENSOR_NMH1000_ADDRESS);
+    }
+
+    fxls8974Slots[MULTI_SENSOR_SLOT_MOTION].pOps = &cTestFxlsOps;
+    fxls8974Slots[MULTI_SENSOR_SLOT_MOTION].pHandle = &fxls8974Driver;
+    MultiSensor_Init(&fxls8974Multi, fxls8974Slots, Test_Event);
+    SensorEngine_Init(&fxls8974Engine, &I2C_S_DRIVER, I2C_S_DEVICE_INDEX, fxls8974Slots, FXLS8974_ENGINE_SLOTS);
+
+    return SensorEngine_Probe(&fxls8974Engine);
+}
+
+/* One timer tick: new samples, the poll round, WFI until it is done, then the decode in the application task. */
+static void Test_Round(uint32_t pressure, uint8_t field)
+{
+    uint32_t rounds = s_bus.rounds;
+
+    SimMpl3115_Sample(&s_bus.mpl3115, pressure, 25 * 256);
+    SimNmh1000_Sample(&s_bus.nmh1000, field);
+    TEST_CHECK_EQUAL(SensorEngine_Poll(&fxls8974Engine, Test_PollDone, NULL), ARM_DRIVER_OK);
+    while (s_bus.rounds == rounds)
+    {
+        HostCpu_WaitForInterrupt();
+    }
+    SensorEngine_Decode(&fxls8974Engine);
+}
+
+/* Every combination of the shield parts, the FXLS8974 is always on the board. */
+static void Test_Probe(void)
+{
+    uint32_t parts;
+    bool pressure;
+    bool magnet;
+
+    for (parts = 0U; parts < 4U; parts++)
+    {
+        pressure = (parts & 1U) != 0U;
+        magnet = (parts & 2U) != 0U;
+        TEST_CHECK_EQUAL(Test_Boot(pressure, magnet), 1U + (pressure ? 1U : 0U) + (magnet ? 1U : 0U));
+        TEST_CHECK(fxls8974Slots[MULTI_SENSOR_SLOT_MOTION].present);
+        TEST_CHECK_EQUAL(fxls8974Slots[MULTI_SENSOR_SLOT_PRESSURE].present, pressure);
+        TEST_CHECK_EQUAL(fxls8974Slots[MULTI_SENSOR_SLOT_MAG].present, magnet);
+        TEST_CHECK_EQUAL(MultiSensor_Variant(&fxls8974Slots[MULTI_SENSOR_SLOT_PRESSURE]) != NULL, pressure);
+        TEST_CHECK_EQUAL(MultiSensor_Variant(&fxls8974Slots[MULTI_SENSOR_SLOT_MAG]) != NULL, magnet);
+    }
+
+    /* The FXPQ3115 answers with its own WHO_AM_I and is served by the same slot. */
+    Test_Boot(false, false);
+    SimMpl3115_Init(&s_bus.mpl3115, MPL3115_I2C_ADDRESS, FXPQ3115_WHOAMI_VALUE);
+    TEST_CHECK_EQUAL(SensorEngine_Probe(&fxls8974Engine), 2U);
+    TEST_CHECK_EQUAL(fxls8974Slots[MULTI_SENSOR_SLOT_PRESSURE].whoAmI, FXPQ3115_WHOAMI_VALUE);
+    TEST_CHECK(MultiSensor_Variant(&fxls8974Slots[MULTI_SENSOR_SLOT_PRESSURE]) != NULL);
+
+    /* The parts are configured to convert on their own. */
+    Test_Boot(true, true);
+    TEST_CHECK((s_bus.mpl3115.reg[MPL3115_CTRL_REG1] & MPL3115_CTRL_REG1_SBYB_MASK) == MPL3115_CTRL_REG1_SBYB_ACTIVE);
+    TEST_CHECK((s_bus.nmh1000.reg[NMH1000_CONTROL_REG1] & NMH1000_CONTROL_REG1_AUTO_MODE_MASK) ==
+               NMH1000_CONTROL_REG1_AUTO_MODE_START);
+}
+
+/* The three reads of a round go out back to back, against the same reads one timer wakeup apart. */
+static void Test_Batch(void)
+{
+    hosti2cstats_t round;
+    hosti2cstats_t apart;
+    uint64_t start_ns;
+    uint64_t roundSpan_ns;
+    uint64_t apartSpan_ns;
+    uint64_t awake_ns;
+    uint64_t apartAwake_ns;
+    uint8_t slot;
+
+    TEST_CHECK_EQUAL(Test_Boot(true, true), MULTI_SENSOR_SLOTS);
+    HostI2C_ClearStats();
+    start_ns = HostCpu_Now_ns();
+    awake_ns = start_ns - HostCpu_Sleep_ns();
+    Test_Round(TEST_PRESSURE, TEST_FIELD);
+    HostI2C_GetStats(&round);
+    roundSpan_ns = s_bus.done_ns - start_ns;
+    awake_ns = (HostCpu_Now_ns() - HostCpu_Sleep_ns()) - awake_ns;
+
+    /* One completion for the round, every slot read, and the bus driven for all but the driver overhead. */
+    TEST_CHECK_EQUAL(s_bus.rounds, 1U);
+    TEST_CHECK_EQUAL(s_bus.sysModes, 1U);
+    TEST_CHECK_EQUAL(round.nacks, 0U);
+    TEST_CHECK_EQUAL(round.refused, 0U);
+    TEST_CHECK_EQUAL(round.bytes, 3U + 1U + 3U + 1U); /* The register addresses, SYS_MODE, OUT_P and OUT_M. */
+    for (slot = 0U; slot < MULTI_SENSOR_SLOTS; slot++)
+    {
+        TEST_CHECK_EQUAL(fxls8974Slots[slot].status, ARM_DRIVER_OK);
+    }
+    TEST_CHECK(roundSpan_ns < round.busTime_ns + round.busTime_ns / 4U);
+
+    /* The single sensor applications: one read per timer wakeup. */
+    HostI2C_ClearStats();
+    start_ns = HostCpu_Now_ns();
+    apartAwake_ns = start_ns - HostCpu_Sleep_ns();
+    for (slot = 0U; slot < MULTI_SENSOR_SLOTS; slot++)
+    {
+        HostCpu_SleepUntil_ns(start_ns + slot * TEST_POLL_GAP_NS);
+        TEST_CHECK_EQUAL(Register_I2C_ReadAsync(&I2C_S_DRIVER, fxls8974Slots[slot].pDevInfo,
+                                                fxls8974Slots[slot].pOps->slaveAddress, &fxls8974Slots[slot].xfer,
+                                                fxls8974Slots[slot].pOps->pPollList, fxls8974Slots[slot].pollData,
+                                                NULL, NULL),
+                         ARM_DRIVER_OK);
+        while (Register_I2C_IsAsyncBusy(fxls8974Slots[slot].pDevInfo))
+        {
+            HostCpu_WaitForInterrupt();
+        }
+    }
+    HostI2C_GetStats(&apart);
+    apartSpan_ns = HostCpu_Now_ns() - start_ns;
+    apartAwake_ns = (HostCpu_Now_ns() - HostCpu_Sleep_ns()) - apartAwake_ns;
+    TEST_CHECK_EQUAL(apart.bytes, round.bytes);
+    TEST_CHECK_EQUAL(apart.transfers, round.transfers);
+
+    printf("one round: %u transfers %u bytes, bus %llu us, round %llu us, %llu us awake, 1 bus wakeup\r\n",
+           round.transfers, round.bytes, (unsigned long long)(round.busTime_ns / TEST_NS_PER_US),
+           (unsigned long long)(roundSpan_ns / TEST_NS_PER_US), (unsigned long long)(awake_ns / TEST_NS_PER_US));
+    printf("per sensor: %u transfers %u bytes, bus %llu us, spread over %llu us, %llu us awake, %u bus wakeups\r\n",
+           apart.transfers, apart.bytes, (unsigned long long)(apart.busTime_ns / TEST_NS_PER_US),
+           (unsigned long long)(apartSpan_ns / TEST_NS_PER_US), (unsigned long long)(apartAwake_ns / TEST_NS_PER_US),
+           MULTI_SENSOR_SLOTS);
+}
+
+/* A pressure step and a magnet removal raise one alert each, and one safe event each on the way back. */
+static void Test_Events(void)
+{
+    uint32_t i;
+
+    TEST_CHECK_EQUAL(Test_Boot(true, true), MULTI_SENSOR_SLOTS);
+    for (i = 0U; i < TEST_QUIET_ROUNDS; i++)
+    {
+        Test_Round(TEST_PRESSURE + (i & 3U), TEST_FIELD + (uint8_t)(i & 1U));
+    }
+    TEST_CHECK_EQUAL(s_bus.numEvents, 0U);
+    TEST_CHECK_EQUAL(s_bus.sysModes, TEST_QUIET_ROUNDS);
+
+    /* The enclosure is opened: the pressure steps, the alert holds while it stays out of the band. */
+    Test_Round(TEST_PRESSURE + TEST_PRESSURE_STEP, TEST_FIELD);
+    Test_Round(TEST_PRESSURE + TEST_PRESSURE_STEP, TEST_FIELD);
+    TEST_CHECK_EQUAL(s_bus.numEvents, 1U);
+    TEST_CHECK_EQUAL(s_bus.events[0].slot, MULTI_SENSOR_SLOT_PRESSURE);
+    TEST_CHECK(s_bus.events[0].alert);
+    TEST_CHECK_EQUAL(s_bus.events[0].whoAmI, MPL3115_WHOAMI_VALUE);
+    TEST_CHECK_EQUAL(s_bus.events[0].sample, (TEST_PRESSURE + TEST_PRESSURE_STEP) / 4U);
+    TEST_CHECK_EQUAL(s_bus.events[0].reference, TEST_PRESSURE / 4U);
+
+    /* The lid magnet moves while the pressure comes back. */
+    Test_Round(TEST_PRESSURE, TEST_FIELD + TEST_FIELD_STEP);
+    TEST_CHECK_EQUAL(s_bus.numEvents, 3U);
+    TEST_CHECK_EQUAL(s_bus.events[1].slot, MULTI_SENSOR_SLOT_PRESSURE);
+    TEST_CHECK(!s_bus.events[1].alert);
+    TEST_CHECK_EQUAL(s_bus.events[2].slot, MULTI_SENSOR_SLOT_MAG);
+    TEST_CHECK(s_bus.events[2].alert);
+    TEST_CHECK_EQUAL(s_bus.events[2].whoAmI, NMH1000_WHO_AM_I_VALUE);
+    TEST_CHECK_EQUAL(s_bus.events[2].sample, TEST_FIELD + TEST_FIELD_STEP);
+
+    Test_Round(TEST_PRESSURE, TEST_FIELD);
+    TEST_CHECK_EQUAL(s_bus.numEvents, 4U);
+    TEST_CHECK_EQUAL(s_bus.events[3].slot, MULTI_SENSOR_SLOT_MAG);
+    TEST_CHECK(!s_bus.events[3].alert);
+
+    /* A node which stops answering loses its round only, the others are still decoded. */
+    HostI2C_FailNext(1U, ARM_I2C_EVENT_ADDRESS_NACK);
+    Test_Round(TEST_PRESSURE, TEST_FIELD);
+    TEST_CHECK(fxls8974Slots[MULTI_SENSOR_SLOT_MOTION].status != ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(fxls8974Slots[MULTI_SENSOR_SLOT_PRESSURE].status, ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(fxls8974Slots[MULTI_SENSOR_SLOT_MAG].status, ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(s_bus.numEvents, 4U);
+}
+
+int main(void)
+{
+    Test_Probe();
+    Test_Batch();
+    Test_Events();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,292 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file test_nmh1000_fsm.c
+ * @brief The test_nmh1000_fsm.c file checks the magnetic tamper state machine: every transition of the table, then
+ *        the timing of its reports on a trace replayed through the NMH1000 register model with the OUT pin or the
+ *        OUT_M poll as the wake source, and the settle deadline on a sleeping timer. The same replay with the
+ *        deadline spun on the CPU, as insert_delay() did, gives the CPU occupancy the state machine removes.
+ */
+
+#include "test_util.h"
+#include "host_cpu.h"
+#include "host_i2c.h"
+#include "sim_nmh1000.h"
+#include "trace_replay.h"
+#include "nmh1000_click.h"
+#include "nmh1000_fsm.h"
+#include "nmh1000_mag_wakeup.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_MAX_REPORTS (8U)
+#define TEST_NS_PER_MS   (1000000U)
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+typedef enum
+{
+    TEST_WAKE_PIN = 0, /* NMH1000_OUT_IRQ_MODE: the OUT edges wake the MCU. */
+    TEST_WAKE_POLL,    /* The OUT_M poll against the baseline, nmh1000_engine_decode(). */
+    TEST_WAKE_SPIN,    /* The OUT_M poll with NMH1000_SAFE_DELAY_MS spun on the CPU, the insert_delay() flow. */
+    TEST_WAKES
+} testwake_t;
+
+typedef struct
+{
+    uint8_t actions;
+    uint32_t time_ms;
+} testreport_t;
+
+typedef struct
+{
+    testwake_t wake;
+    simnmh1000_t model;
+    nmh1000_i2c_sensorhandle_t handle;
+    nmh1000fsm_t fsm;
+    baselinetracker_t baseline;
+    bool pin;
+    bool field;
+    bool fieldValid;
+    bool deadlineArmed;
+    uint64_t deadline_ns;
+    uint32_t wakeups;
+    uint32_t reports;
+    testreport_t report[TEST_MAX_REPORTS];
+} testreplay_t;
+
+/*! @brief One row of the transition table. */
+typedef struct
+{
+    nmh1000State_t state;
+    nmh1000Event_t event;
+    nmh1000State_t next;
+    uint8_t actions;
+} testtransition_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static const char *const s_wakeName[TEST_WAKES] = {"OUT pin", "OUT_M poll", "poll + spin"};
+
+static const testtransition_t s_transitions[] = {
+    /* A field at start up is not reported, the asset was never declared safe. */
+    {mNmh1000State_Startup_c, mNmh1000Evt_FieldPresent_c, mNmh1000State_Tamper_c, NMH1000_FSM_ACTION_NONE},
+    {mNmh1000State_Startup_c, mNmh1000Evt_FieldAbsent_c, mNmh1000State_Settling_c,
+     NMH1000_FSM_ACTION_CLEAR | NMH1000_FSM_ACTION_START_DEADLINE},
+    {mNmh1000State_Startup_c, mNmh1000Evt_Deadline_c, mNmh1000State_Startup_c, NMH1000_FSM_ACTION_NONE},
+    {mNmh1000State_Safe_c, mNmh1000Evt_FieldPresent_c, mNmh1000State_Tamper_c, NMH1000_FSM_ACTION_ALERT},
+    {mNmh1000State_Safe_c, mNmh1000Evt_FieldAbsent_c, mNmh1000State_Safe_c, NMH1000_FSM_ACTION_NONE},
+    {mNmh1000State_Safe_c, mNmh1000Evt_Deadline_c, mNmh1000State_Safe_c, NMH1000_FSM_ACTION_NONE},
+    {mNmh1000State_Tamper_c, mNmh1000Evt_FieldPresent_c, mNmh1000State_Tamper_c, NMH1000_FSM_ACTION_NONE},
+    {mNmh1000State_Tamper_c, mNmh1000Evt_FieldAbsent_c, mNmh1000State_Settling_c,
+     NMH1000_FSM_ACTION_CLEAR | NMH1000_FSM_ACTION_START_DEADLINE},
+    /* A deadline which raced with its cancel is dropped. */
+    {mNmh1000State_Tamper_c, mNmh1000Evt_Deadline_c, mNmh1000State_Tamper_c, NMH1000_FSM_ACTION_NONE},
+    /* The field came back in time, still the same tamper. */
+    {mNmh1000State_Settling_c, mNmh1000Evt_FieldPresent_c, mNmh1000State_Tamper_c, NMH1000_FSM_ACTION_STOP_DEADLINE},
+    {mNmh1000State_Settling_c, mNmh1000Evt_FieldAbsent_c, mNmh1000State_Settling_c, NMH1000_FSM_ACTION_NONE},
+    {mNmh1000State_Settling_c, mNmh1000Evt_Deadline_c, mNmh1000State_Safe_c, NMH1000_FSM_ACTION_SAFE},
+};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void Test_Transitions(void)
+{
+    nmh1000fsm_t fsm;
+    uint32_t i;
+
+    for (i = 0U; i < sizeof(s_transitions) / sizeof(s_transitions[0]); i++)
+    {
+        fsm.state = s_transitions[i].state;
+        TEST_CHECK_EQUAL(NMH1000_Fsm_Dispatch(&fsm, s_transitions[i].event), s_transitions[i].actions);
+        TEST_CHECK_EQUAL(fsm.state, s_transitions[i].next);
+    }
+
+    /* An unknown state falls back to start up. */
+    fsm.state = (nmh1000State_t)0x7F;
+    TEST_CHECK_EQUAL(NMH1000_Fsm_Dispatch(&fsm, mNmh1000Evt_FieldPresent_c), NMH1000_FSM_ACTION_NONE);
+    TEST_CHECK_EQUAL(fsm.state, mNmh1000State_Startup_c);
+
+    NMH1000_Fsm_Init(&fsm);
+    TEST_CHECK_EQUAL(fsm.state, mNmh1000State_Startup_c);
+}
+
+/* nmh1000_FsmHandler(): the reports are logged with their time, the deadline goes to a timer or is spun. */
+static void Test_Dispatch(testreplay_t *pTest, nmh1000Event_t event)
+{
+    uint8_t actions = NMH1000_Fsm_Dispatch(&pTest->fsm, event);
+    uint8_t reported = actions & (NMH1000_FSM_ACTION_ALERT | NMH1000_FSM_ACTION_SAFE);
+
+    if ((reported != 0U) && (pTest->reports < TEST_MAX_REPORTS))
+    {
+        pTest->report[pTest->reports].actions = reported;
+        pTest->report[pTest->reports].time_ms = (uint32_t)(HostCpu_Now_ns() / TEST_NS_PER_MS);
+        pTest->reports++;
+    }
+    if (actions & NMH1000_FSM_ACTION_START_DEADLINE)
+    {
+        if (pTest->wake == TEST_WAKE_SPIN)
+        {
+            /* Nothing else runs until the delay is over. */
+            HostCpu_Advance_ns((uint64_t)NMH1000_SAFE_DELAY_MS * TEST_NS_PER_MS);
+            Test_Dispatch(pTest, mNmh1000Evt_Deadline_c);
+        }
+        else
+        {
+            pTest->deadlineArmed = true;
+            pTest->deadline_ns = HostCpu_Now_ns() + (uint64_t)NMH1000_SAFE_DELAY_MS * TEST_NS_PER_MS;
+        }
+    }
+    if (actions & NMH1000_FSM_ACTION_STOP_DEADLINE)
+    {
+        pTest->deadlineArmed = false;
+    }
+}
+
+/* nmh1000_set_field(): only a change of the field is an event. */
+static void Test_SetField(testreplay_t *pTest, bool present)
+{
+    bool changed = !pTest->fieldValid || (present != pTest->field);
+
+    pTest->field = present;
+    pTest->fieldValid = true;
+    if (changed)
+    {
+        Test_Dispatch(pTest, present ? mNmh1000Evt_FieldPresent_c : mNmh1000Evt_FieldAbsent_c);
+    }
+}
+
+static void Test_Sample(testreplay_t *pTest, const tracesample_t *pSample)
+{
+    uint64_t time_ns = (uint64_t)pSample->time_ms * TEST_NS_PER_MS;
+    uint8_t magData = 0U;
+    bool pin;
+
+    /* The timer fires in the sleep before the sample. */
+    if (pTest->deadlineArmed && (pTest->deadline_ns <= time_ns))
+    {
+        HostCpu_SleepUntil_ns(pTest->deadline_ns);
+        pTest->deadlineArmed = false;
+        pTest->wakeups++;
+        Test_Dispatch(pTest, mNmh1000Evt_Deadline_c);
+    }
+    /* After a spin the sample is handled late. */
+    HostCpu_SleepUntil_ns(time_ns);
+    SimNmh1000_Sample(&pTest->model, (uint8_t)pSample->value[0]);
+
+    if (pTest->wake == TEST_WAKE_PIN)
+    {
+        /* Either edge, the very first level as well: nmh1000_event_BLE() samples the pin once at start. */
+        pin = SimNmh1000_Out(&pTest->model);
+        if ((pin != pTest->pin) || !pTest->fieldValid)
+        {
+            pTest->pin = pin;
+            pTest->wakeups++;
+            Test_SetField(pTest, pin);
+        }
+        return;
+    }
+
+    pTest->wakeups++;
+    TEST_CHECK_EQUAL(NMH1000_I2C_ReadData(&pTest->handle, cNmh1000OutputNormal, &magData), SENSOR_ERROR_NONE);
+    TEST_CHECK_EQUAL(magData, pSample->value[0]);
+    if (Baseline_IsEvent(&pTest->baseline, magData, THRESHOLD))
+    {
+        Test_SetField(pTest, true);
+    }
+    else
+    {
+        Baseline_Update(&pTest->baseline, magData);
+        Test_SetField(pTest, false);
+    }
+}
+
+static void Test_Replay(testreplay_t *pTest, testwake_t wake, const char *pPath)
+{
+    tracereplay_t trace;
+    tracesample_t sample;
+
+    memset(pTest, 0, sizeof(testreplay_t));
+    pTest->wake = wake;
+    HostCpu_Reset();
+    HostI2C_Reset();
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.Initialize(I2C_S_SIGNAL_EVENT), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.PowerControl(ARM_POWER_FULL), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.Control(ARM_I2C_BUS_SPEED, ARM_I2C_BUS_SPEED_FAST), ARM_DRIVER_OK);
+
+    SimNmh1000_Init(&pTest->model, NMH1000_I2C_ADDR_VAL);
+    TEST_CHECK_EQUAL(NMH1000_I2C_Initialize(&pTest->handle, &I2C_S_DRIVER, I2C_S_DEVICE_INDEX, NMH1000_I2C_ADDR_VAL,
+                                            NMH1000_WHO_AM_I_VALUE),
+                     SENSOR_ERROR_NONE);
+    TEST_CHECK_EQUAL(NMH1000_I2C_Configure(&pTest->handle, cNmh1000ConfigNormal), SENSOR_ERROR_NONE);
+    NMH1000_Fsm_Init(&pTest->fsm);
+    Baseline_Init(&pTest->baseline, NMH1000_BASELINE_SHIFT, NMH1000_BASELINE_GATE);
+    Baseline_Seed(&pTest->baseline, 0);
+
+    TEST_CHECK(TraceReplay_Open(&trace, pPath));
+    while (TraceReplay_Next(&trace, &sample))
+    {
+        Test_Sample(pTest, &sample);
+    }
+    TEST_CHECK(!trace.error);
+    TraceReplay_Close(&trace);
+}
+
+static void Test_CheckReport(const testreplay_t *pTest, uint32_t index, uint8_t actions, uint32_t time_ms)
+{
+    TEST_CHECK(index < pTest->reports);
+    if (index < pTest->reports)
+    {
+        TEST_CHECK_EQUAL(pTest->report[index].actions, actions);
+        TEST_CHECK_EQUAL(pTest->report[index].time_ms, time_ms);
+    }
+}
+
+/* Safe once settled after start up, one alert for the magnet despite its slip, safe once it is gone for good. */
+static void Test_Timing(void)
+{
+    static testreplay_t test[TEST_WAKES];
+    uint64_t active_ns[TEST_WAKES];
+    testwake_t wake;
+
+    for (wake = TEST_WAKE_PIN; wake < TEST_WAKES; wake++)
+    {
+        Test_Replay(&test[wake], wake, TEST_TRACE("mag_tamper.csv"));
+        active_ns[wake] = HostCpu_Now_ns() - HostCpu_Sleep_ns();
+        printf("%-11s: %3u wakeups, %2u reports, %8u us CPU over %u ms, %.3f%% busy\r\n", s_wakeName[wake],
+               test[wake].wakeups, test[wake].reports, (uint32_t)(active_ns[wake] / 1000U),
+               (uint32_t)(HostCpu_Now_ns() / TEST_NS_PER_MS), 100.0 * (double)active_ns[wake] / (double)HostCpu_Now_ns());
+    }
+
+    for (wake = TEST_WAKE_PIN; wake <= TEST_WAKE_POLL; wake++)
+    {
+        TEST_CHECK_EQUAL(test[wake].reports, 3U);
+        Test_CheckReport(&test[wake], 0U, NMH1000_FSM_ACTION_SAFE, NMH1000_SAFE_DELAY_MS);
+        Test_CheckReport(&test[wake], 1U, NMH1000_FSM_ACTION_ALERT, 10000U);
+        Test_CheckReport(&test[wake], 2U, NMH1000_FSM_ACTION_SAFE, 20000U + NMH1000_SAFE_DELAY_MS);
+        TEST_CHECK_EQUAL(test[wake].fsm.state, mNmh1000State_Safe_c);
+    }
+    /* The pin wakes the MCU on the edges and the deadlines only: start, magnet, slip and back, gone, 2 deadlines. */
+    TEST_CHECK_EQUAL(test[TEST_WAKE_PIN].wakeups, 7U);
+    TEST_CHECK(active_ns[TEST_WAKE_PIN] < active_ns[TEST_WAKE_POLL]);
+
+    /* Spun, the slip is reported safe before the field returning is seen, and the magnet alerts twice. */
+    TEST_CHECK(test[TEST_WAKE_SPIN].reports > test[TEST_WAKE_POLL].reports);
+    TEST_CHECK(active_ns[TEST_WAKE_SPIN] >= 3U * (uint64_t)NMH1000_SAFE_DELAY_MS * TEST_NS_PER_MS);
+}
+
+int main(void)
+{
+    Test_Transitions();
+    Test_Timing();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,219 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file test_poll_scheduler.c
+ * @brief The test_poll_scheduler.c file checks the back-off curve of the poll scheduler, then replays a day of
+ *        activity through the fixed 100 ms poll it replaced and through the adaptive policies, and reports the
+ *        wakeups per hour, the worst detection latency and the bursts of activity no poll saw.
+ */
+
+#include "test_util.h"
+#include "trace_replay.h"
+#include "mpl3115_pressure_wakeup.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_MAX_CHANGES (64U)
+#define TEST_MS_PER_HOUR (3600000U)
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief A change of the activity level. */
+typedef struct
+{
+    uint32_t time_ms;
+    bool active;
+} testchange_t;
+
+typedef struct
+{
+    const char *pName;
+    const pollschedconfig_t *pConfig;
+} testpolicy_t;
+
+typedef struct
+{
+    uint32_t wakeups;
+    uint32_t bursts;
+    uint32_t detected;
+    uint32_t worstLatency_ms;
+    uint32_t longestMissed_ms; /* Longest burst no poll saw. */
+} testresult_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static testchange_t s_changes[TEST_MAX_CHANGES];
+static uint32_t s_numChanges;
+
+/* The hard-coded 100 ms poll of the original firmware. */
+static const pollschedconfig_t cTestFixed = {100U, 100U, 0U, 0U};
+/* Longer back-off, for an asset that may stay still for weeks. */
+static const pollschedconfig_t cTestSlow = {100U, 10000U, 1U, 50U};
+
+static const testpolicy_t s_policies[] = {
+    {"fixed 100 ms", &cTestFixed},
+    {"shipped", &cMpl3115PollConfig},
+    {"max 10 s", &cTestSlow},
+};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/* The quiet polls at the fast rate, the geometric stretch, the cap, and the snap back. */
+static void Test_Curve(void)
+{
+    static const pollschedconfig_t config = {100U, 2000U, 1U, 3U};
+    static const pollschedconfig_t fine = {4U, 50U, 4U, 0U};
+    pollsched_t sched;
+    uint32_t i;
+
+    PollSched_Init(&sched, &config);
+    TEST_CHECK_EQUAL(PollSched_Interval(&sched), 100U);
+    for (i = 0U; i < 3U; i++)
+    {
+        TEST_CHECK_EQUAL(PollSched_Update(&sched, false), 100U);
+    }
+    TEST_CHECK_EQUAL(PollSched_Update(&sched, false), 150U);
+    TEST_CHECK_EQUAL(PollSched_Update(&sched, false), 225U);
+    TEST_CHECK_EQUAL(PollSched_Update(&sched, false), 337U);
+    for (i = 0U; i < 16U; i++)
+    {
+        (void)PollSched_Update(&sched, false);
+    }
+    TEST_CHECK_EQUAL(PollSched_Interval(&sched), 2000U);
+
+    /* Activity snaps back at once and restarts the quiet count. */
+    TEST_CHECK_EQUAL(PollSched_Update(&sched, true), 100U);
+    TEST_CHECK_EQUAL(PollSched_Update(&sched, false), 100U);
+
+    /* 4 >> 4 is 0, the interval still grows by 1 ms. */
+    PollSched_Init(&sched, &fine);
+    TEST_CHECK_EQUAL(PollSched_Update(&sched, false), 5U);
+    TEST_CHECK_EQUAL(PollSched_Update(&sched, false), 6U);
+
+    /* Equal bounds, the fixed poll. */
+    PollSched_Init(&sched, &cTestFixed);
+    for (i = 0U; i < 100U; i++)
+    {
+        (void)PollSched_Update(&sched, false);
+    }
+    TEST_CHECK_EQUAL(PollSched_Interval(&sched), 100U);
+}
+
+/* An activity trace lists the changes of the level, time_ms,activity. */
+static void Test_Load(const char *pPath)
+{
+    tracereplay_t trace;
+    tracesample_t sample;
+
+    s_numChanges = 0U;
+    TEST_CHECK(TraceReplay_Open(&trace, pPath));
+    while ((s_numChanges < TEST_MAX_CHANGES) && TraceReplay_Next(&trace, &sample))
+    {
+        s_changes[s_numChanges].time_ms = sample.time_ms;
+        s_changes[s_numChanges].active = (sample.value[0] != 0);
+        s_numChanges++;
+    }
+    TEST_CHECK(!trace.error);
+    TraceReplay_Close(&trace);
+    TEST_CHECK(s_numChanges >= 2U);
+}
+
+/* Polls from the start to the last change, re-armed with the interval PollSched_Update() returns, as *_CallBack()
+ * does with TM_Start(). A burst is detected by the first poll which falls in it. */
+static void Test_Run(const pollschedconfig_t *pConfig, testresult_t *pResult)
+{
+    bool seen[TEST_MAX_CHANGES] = {false};
+    uint32_t end_ms = s_changes[s_numChanges - 1U].time_ms;
+    pollsched_t sched;
+    uint32_t change = 0U;
+    uint32_t length_ms;
+    uint32_t time_ms;
+    bool active;
+
+    memset(pResult, 0, sizeof(testresult_t));
+    PollSched_Init(&sched, pConfig);
+    for (time_ms = 0U; time_ms < end_ms; time_ms += PollSched_Update(&sched, active))
+    {
+        while ((change + 1U < s_numChanges) && (s_changes[change + 1U].time_ms <= time_ms))
+        {
+            change++;
+        }
+        active = s_changes[change].active;
+        if (active && !seen[change])
+        {
+            seen[change] = true;
+            if (time_ms - s_changes[change].time_ms > pResult->worstLatency_ms)
+            {
+                pResult->worstLatency_ms = time_ms - s_changes[change].time_ms;
+            }
+        }
+        pResult->wakeups++;
+    }
+
+    for (change = 0U; change + 1U < s_numChanges; change++)
+    {
+        if (!s_changes[change].active)
+        {
+            continue;
+        }
+        pResult->bursts++;
+        length_ms = s_changes[change + 1U].time_ms - s_changes[change].time_ms;
+        if (seen[change])
+        {
+            pResult->detected++;
+        }
+        else if (length_ms > pResult->longestMissed_ms)
+        {
+            pResult->longestMissed_ms = length_ms;
+        }
+    }
+}
+
+static uint32_t Test_PerHour(uint32_t wakeups)
+{
+    uint32_t end_ms = s_changes[s_numChanges - 1U].time_ms;
+
+    return (uint32_t)(((uint64_t)wakeups * TEST_MS_PER_HOUR + end_ms / 2U) / end_ms);
+}
+
+/* A day: the adaptive policies wake far less, and only miss bursts shorter than their longest interval. */
+static void Test_Day(void)
+{
+    testresult_t result[sizeof(s_policies) / sizeof(s_policies[0])];
+    uint32_t i;
+
+    Test_Load(TEST_TRACE("activity_day.csv"));
+    for (i = 0U; i < sizeof(s_policies) / sizeof(s_policies[0]); i++)
+    {
+        Test_Run(s_policies[i].pConfig, &result[i]);
+        printf("%-12s: %5u wakeups per hour, worst latency %5u ms, %u of %u bursts, longest missed %u ms\r\n",
+               s_policies[i].pName, Test_PerHour(result[i].wakeups), result[i].worstLatency_ms, result[i].detected,
+               result[i].bursts, result[i].longestMissed_ms);
+
+        TEST_CHECK(result[i].worstLatency_ms < s_policies[i].pConfig->maxIntervalMs);
+        TEST_CHECK(result[i].longestMissed_ms < s_policies[i].pConfig->maxIntervalMs);
+    }
+
+    /* The fixed poll sees everything, 36000 times an hour. */
+    TEST_CHECK_EQUAL(Test_PerHour(result[0].wakeups), TEST_MS_PER_HOUR / 100U);
+    TEST_CHECK_EQUAL(result[0].detected, result[0].bursts);
+    /* The shipped policy wakes more than ten times less. */
+    TEST_CHECK(Test_PerHour(result[1].wakeups) * 10U < Test_PerHour(result[0].wakeups));
+    TEST_CHECK(result[2].wakeups < result[1].wakeups);
+}
+
+int main(void)
+{
+    Test_Curve();
+    Test_Day();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file test_register_cache.c
+ * @brief The test_register_cache.c file counts the I2C transactions of the configuration list of a tamper detection
+ *        application with and without the shadow register cache of Register_I2C_AttachCache. The list is applied at
+ *        start up and once more as a mode change does: the cache drops the read back of the masked entries and
+ *        Sensor_I2C_Write() coalesces the entries on consecutive addresses. Both runs must leave the same register
+ *        file, and the cached one must need fewer transactions. The application headers define the same globals, so
+ *        the test is built once per sensor, TEST_SENSOR_FXLS8974, TEST_SENSOR_MPL3115 or TEST_SENSOR_NMH1000.
+ */
+
+#include "test_util.h"
+#include "host_cpu.h"
+#include "host_i2c.h"
+#if defined(TEST_SENSOR_MPL3115)
+#include "sim_mpl3115.h"
+#include "mpl3115_pressure_wakeup.h"
+#elif defined(TEST_SENSOR_NMH1000)
+#include "sim_nmh1000.h"
+#include "nmh1000_click.h"
+#include "nmh1000_mag_wakeup.h"
+#else
+#include "sim_fxls8974.h"
+#include "fxls89xx_motion_wakeup.h"
+#endif
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_PASSES (2U) /* Start up, then a mode change re-applying the list. */
+#if defined(TEST_SENSOR_MPL3115)
+#define TEST_SENSOR_NAME "cMpl3115ConfigNormal"
+#elif defined(TEST_SENSOR_NMH1000)
+#define TEST_SENSOR_NAME "cNmh1000ConfigNormal"
+#else
+#define TEST_SENSOR_NAME "cFxls8974AwsConfig"
+#endif
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+typedef struct
+{
+#if defined(TEST_SENSOR_MPL3115)
+    simmpl3115_t model;
+    mpl3115_i2c_sensorhandle_t handle;
+#elif defined(TEST_SENSOR_NMH1000)
+    simnmh1000_t model;
+    nmh1000_i2c_sensorhandle_t handle;
+#else
+    simfxls8974_t model;
+    fxls8974_i2c_sensorhandle_t handle;
+#endif
+    registercache_t cache;
+} testbus_t;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/* The engine init hook of the application, without the cache unless asked for. */
+static void Test_Init(testbus_t *pBus, bool cached)
+{
+    uint8_t whoAmI = 0U;
+
+    memset(pBus, 0, sizeof(testbus_t));
+    HostCpu_Reset();
+    HostI2C_Reset();
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.Initialize(I2C_S_SIGNAL_EVENT), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.PowerControl(ARM_POWER_FULL), ARM_DRIVER_OK);
+    TEST_CHECK_EQUAL(I2C_S_DRIVER.Control(ARM_I2C_BUS_SPEED, ARM_I2C_BUS_SPEED_FAST), ARM_DRIVER_OK);
+#if defined(TEST_SENSOR_MPL3115)
+    SimMpl3115_Init(&pBus->model, MPL3115_I2C_ADDRESS, MPL3115_WHOAMI_VALUE);
+    TEST_CHECK_EQUAL(MPL3115_I2C_Initialize(&pBus->handle, &I2C_S_DRIVER, I2C_S_DEVICE_INDEX, MPL3115_I2C_ADDRESS,
+                                            &whoAmI),
+                     SENSOR_ERROR_NONE);
+#elif defined(TEST_SENSOR_NMH1000)
+    (void)whoAmI;
+    SimNmh1000_Init(&pBus->model, NMH1000_I2C_ADDR_VAL);
+    TEST_CHECK_EQUAL(NMH1000_I2C_Initialize(&pBus->handle, &I2C_S_DRIVER, I2C_S_DEVICE_INDEX, NMH1000_I2C_ADDR_VAL,
+                                            NMH1000_WHO_AM_I_VALUE),
+                     SENSOR_ERROR_NONE);
+#else
+    SimFxls8974_Init(&pBus->model, FXLS8974_DEVICE_ADDRESS_SA0_0, FXLS8974_WHOAMI_VALUE);
+    TEST_CHECK_EQUAL(FXLS8974_I2C_Initialize(&pBus->handle, &I2C_S_DRIVER, I2C_S_DEVICE_INDEX,
+                                             FXLS8974_DEVICE_ADDRESS_SA0_0, &whoAmI),
+                     SENSOR_ERROR_NONE);
+#endif
+    if (cached)
+    {
+        Register_I2C_AttachCache(&pBus->handle.deviceInfo, &pBus->cache);
+    }
+}
+
+/* The engine configure hook of the application. */
+static int32_t Test_Configure(testbus_t *pBus)
+{
+#if defined(TEST_SENSOR_MPL3115)
+    return MPL3115_I2C_Configure(&pBus->handle, cMpl3115ConfigNormal);
+#elif defined(TEST_SENSOR_NMH1000)
+    return NMH1000_I2C_Configure(&pBus->handle, cNmh1000ConfigNormal);
+#else
+    return FXLS8974_I2C_Configure(&pBus->handle, cFxls8974AwsConfig);
+#endif
+}
+
+static void Test_Run(testbus_t *pBus, bool cached, hosti2cstats_t *pStats)
+{
+    uint32_t pass;
+
+    Test_Init(pBus, cached);
+    HostI2C_ClearStats();
+    for (pass = 0U; pass < TEST_PASSES; pass++)
+    {
+        TEST_CHECK_EQUAL(Test_Configure(pBus), SENSOR_ERROR_NONE);
+    }
+    HostI2C_GetStats(pStats);
+    TEST_CHECK_EQUAL(pStats->nacks, 0U);
+    TEST_CHECK_EQUAL(pStats->refused, 0U);
+}
+
+static void Test_Transactions(void)
+{
+    static testbus_t plainBus;
+    static testbus_t cachedBus;
+    hosti2cstats_t plain;
+    hosti2cstats_t cached;
+
+    Test_Run(&plainBus, false, &plain);
+    Test_Run(&cachedBus, true, &cached);
+    printf("%s x%u: %3u transactions %4u bytes %6llu us uncached, %3u transactions %4u bytes %6llu us cached\r\n",
+           TEST_SENSOR_NAME, TEST_PASSES, plain.transfers, plain.bytes, (unsigned long long)(plain.busTime_ns / 1000U),
+           cached.transfers, cached.bytes, (unsigned long long)(cached.busTime_ns / 1000U));
+
+    /* The same registers end up written, with fewer transactions and less bus time. */
+    TEST_CHECK(memcmp(plainBus.model.reg, cachedBus.model.reg, sizeof(plainBus.model.reg)) == 0);
+    TEST_CHECK(cached.transfers < plain.transfers);
+    TEST_CHECK(cached.busTime_ns < plain.busTime_ns);
+}
+
+int main(void)
+{
+    Test_Transactions();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,292 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file test_tamper_batch.c
+ * @brief The test_tamper_batch.c file runs a bursty stream of tamper event records through the batching of the
+ *        FXLS8974 application, BleApp_QueueTamperEvent() and BleApp_FlushTamperBatch(), for a range of batch
+ *        windows. It prints the ATT PDUs sent per second and the p50 and p99 latency of a record from the queue to
+ *        the write, and checks that no record waits longer than one window and that an alert never waits.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "test_util.h"
+#include "host_cpu.h"
+#include "tamper_event.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_ID_FXLS8974     (0x86U) /* FXLS8974_WHOAMI_VALUE */
+#define TEST_BATCH_LIMIT     (244U)  /* gAttMaxNotifIndDataSize_d(gAttMaxMtu_c), the Wireless UART peers exchange it. */
+#define TEST_RUN_MS          (60000U)
+#define TEST_BURST_GAP_MS    (250.0) /* Mean time between two bursts. */
+#define TEST_BURST_EVENTS    (6.0)   /* Mean records of a burst. */
+#define TEST_EVENT_GAP_MS    (4.0)   /* Mean time between two records of a burst. */
+#define TEST_ALERT_PERCENT   (10U)
+#define TEST_MAX_RECORDS     (4096U)
+#define TEST_NS_PER_MS       (1000000ULL)
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+typedef struct
+{
+    uint64_t time_ns;
+    uint8_t record[TAMPER_EVENT_MAX_SIZE];
+    uint8_t size;
+    bool urgent;
+} testrecord_t;
+
+typedef struct
+{
+    tamperbatch_t batch;
+    uint32_t window_ms;
+    uint32_t timerGeneration; /* Stands for TM_Stop(), a stale timer interrupt is ignored. */
+    bool timerRunning;
+    uint32_t queued;          /* Records in the batch, s_latency[] entries waiting for their write. */
+    uint64_t queuedAt[TEST_MAX_RECORDS];
+    uint32_t pdus;
+    uint32_t bytes;
+    uint32_t records;
+} testlink_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static testrecord_t s_stream[TEST_MAX_RECORDS];
+static uint32_t s_numRecords;
+static uint64_t s_latency[TEST_MAX_RECORDS];
+static uint32_t s_numLatency;
+static testlink_t s_link;
+static uint32_t s_seed = 0x1B873593UL;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static double Test_Uniform(void)
+{
+    s_seed = s_seed * 1664525UL + 1013904223UL;
+
+    return ((double)(s_seed >> 8) + 0.5) / 16777216.0;
+}
+
+static double Test_Exponential(double mean)
+{
+    return -mean * log(Test_Uniform());
+}
+
+/* Bursts at random times, the records of a burst a few ms apart. fxls89xx_send_event() builds them. */
+static void Test_BuildStream(void)
+{
+    static const uint8_t source[] = {0x80U, 0x02U};
+    tamperevent_t event;
+    double time_ms = 0.0;
+    double at_ms;
+    uint32_t events;
+    uint32_t i;
+    uint8_t sequence = 0U;
+    uint8_t cls;
+
+    s_numRecords = 0U;
+    while (s_numRecords < TEST_MAX_RECORDS)
+    {
+        time_ms += Test_Exponential(TEST_BURST_GAP_MS);
+        if (time_ms >= TEST_RUN_MS)
+        {
+            break;
+        }
+        events = 1U + (uint32_t)Test_Exponential(TEST_BURST_EVENTS - 1.0);
+        at_ms = time_ms;
+        for (i = 0U; (i < events) && (s_numRecords < TEST_MAX_RECORDS); i++)
+        {
+            testrecord_t *pRecord = &s_stream[s_numRecords];
+
+            pRecord->urgent = ((uint32_t)(Test_Uniform() * 100.0) < TEST_ALERT_PERCENT);
+            TamperEvent_Init(&event, pRecord->urgent ? mTamperEvent_Tilt_c : mTamperEvent_Motion_c,
+                             pRecord->urgent ? mTamperSeverity_Alert_c : mTamperSeverity_Warning_c, TEST_ID_FXLS8974,
+                             sequence++, (uint32_t)at_ms);
+            cls = (uint8_t)(Test_Uniform() * 4.0) + 1U;
+            TEST_CHECK(TamperEvent_AddItem(&event, TAMPER_ITEM_CLASS, &cls));
+            if (pRecord->urgent)
+            {
+                TEST_CHECK(TamperEvent_AddItem(&event, TAMPER_ITEM_ORIENT, source));
+            }
+            pRecord->size = (uint8_t)TamperEvent_Encode(&event, pRecord->record, sizeof(pRecord->record));
+            pRecord->time_ns = (uint64_t)(at_ms * (double)TEST_NS_PER_MS);
+            s_numRecords++;
+            at_ms += Test_Exponential(TEST_EVENT_GAP_MS);
+        }
+        time_ms = at_ms;
+    }
+}
+
+/* BleApp_SendTamperEvent(): one notification per write, the latency of every record of the batch is known now. */
+static void Test_Send(const uint8_t *pData, uint32_t length)
+{
+    uint64_t now = HostCpu_Now_ns();
+    uint32_t i;
+
+    (void)pData;
+    s_link.pdus++;
+    s_link.bytes += length;
+    for (i = 0U; i < s_link.queued; i++)
+    {
+        s_latency[s_numLatency++] = now - s_link.queuedAt[i];
+    }
+    s_link.queued = 0U;
+}
+
+/* BleApp_FlushTamperBatch() */
+static void Test_Flush(void)
+{
+    s_link.timerGeneration++;
+    s_link.timerRunning = false;
+    if (0U != s_link.batch.length)
+    {
+        Test_Send(s_link.batch.buffer, s_link.batch.length);
+        TamperEvent_BatchReset(&s_link.batch);
+    }
+}
+
+/* TamperBatchTimerCallback(), the application task runs the flush right after. */
+static void Test_TimerIrq(uint32_t generation)
+{
+    if (s_link.timerRunning && (generation == s_link.timerGeneration))
+    {
+        Test_Flush();
+    }
+}
+
+static bool Test_Append(const testrecord_t *pRecord)
+{
+    if (!TamperEvent_BatchAppend(&s_link.batch, pRecord->record, pRecord->size, TEST_BATCH_LIMIT))
+    {
+        return false;
+    }
+    s_link.queuedAt[s_link.queued++] = HostCpu_Now_ns();
+
+    return true;
+}
+
+/* BleApp_QueueTamperEvent(), or BleApp_SendTamperEvent() alone with a window of 0. */
+static void Test_Queue(const testrecord_t *pRecord)
+{
+    s_link.records++;
+    if (0U == s_link.window_ms)
+    {
+        s_link.queuedAt[s_link.queued++] = HostCpu_Now_ns();
+        Test_Send(pRecord->record, pRecord->size);
+        return;
+    }
+
+    if (!Test_Append(pRecord))
+    {
+        /* No room left for the record, send the batch first */
+        Test_Flush();
+        (void)Test_Append(pRecord);
+    }
+
+    if (pRecord->urgent || ((s_link.batch.length + TAMPER_EVENT_HEADER_SIZE) > TEST_BATCH_LIMIT))
+    {
+        Test_Flush();
+    }
+    else if (s_link.batch.length == pRecord->size)
+    {
+        /* First record of the batch, it waits at most one window */
+        s_link.timerGeneration++;
+        s_link.timerRunning = true;
+        TEST_CHECK(HostCpu_Pend(Test_TimerIrq, s_link.timerGeneration, s_link.window_ms * TEST_NS_PER_MS));
+    }
+    else
+    {
+        ; /* Wait for the window to end */
+    }
+}
+
+static int Test_Compare(const void *pA, const void *pB)
+{
+    uint64_t a = *(const uint64_t *)pA;
+    uint64_t b = *(const uint64_t *)pB;
+
+    return (a < b) ? -1 : ((a > b) ? 1 : 0);
+}
+
+static uint64_t Test_Percentile(uint32_t percent)
+{
+    uint32_t index = (s_numLatency * percent + 99U) / 100U;
+
+    return s_latency[(index == 0U) ? 0U : (index - 1U)];
+}
+
+static uint32_t Test_Run(uint32_t window_ms)
+{
+    bool alertWaited = false;
+    uint32_t i;
+
+    HostCpu_Reset();
+    memset(&s_link, 0, sizeof(s_link));
+    TamperEvent_BatchReset(&s_link.batch);
+    s_link.window_ms = window_ms;
+    s_numLatency = 0U;
+
+    for (i = 0U; i < s_numRecords; i++)
+    {
+        HostCpu_SleepUntil_ns(s_stream[i].time_ns);
+        Test_Queue(&s_stream[i]);
+        alertWaited = alertWaited || (s_stream[i].urgent && (s_link.queued != 0U));
+    }
+    HostCpu_SleepUntil_ns((uint64_t)(TEST_RUN_MS + window_ms) * TEST_NS_PER_MS);
+
+    /* Every record went out, none waited longer than one window, an alert never waits. */
+    TEST_CHECK_EQUAL(s_numLatency, s_numRecords);
+    TEST_CHECK_EQUAL(s_link.queued, 0U);
+    TEST_CHECK(!alertWaited);
+    qsort(s_latency, s_numLatency, sizeof(s_latency[0]), Test_Compare);
+    TEST_CHECK(s_latency[s_numLatency - 1U] <= window_ms * TEST_NS_PER_MS);
+
+    printf("window %3u ms: %5.1f PDUs/s, %4.1f records per PDU, latency p50 %6.2f ms p99 %6.2f ms max %6.2f ms\r\n",
+           window_ms, s_link.pdus * 1000.0 / TEST_RUN_MS, (double)s_link.records / s_link.pdus,
+           (double)Test_Percentile(50U) / TEST_NS_PER_MS, (double)Test_Percentile(99U) / TEST_NS_PER_MS,
+           (double)s_latency[s_numLatency - 1U] / TEST_NS_PER_MS);
+
+    return s_link.pdus;
+}
+
+static void Test_Windows(void)
+{
+    static const uint32_t windows[] = {0U, 5U, 10U, 20U, 50U, 100U};
+    uint32_t pdus[sizeof(windows) / sizeof(windows[0])];
+    uint32_t i;
+
+    Test_BuildStream();
+    printf("%u records in %u s, on average bursts of %.0f records %.0f ms apart every %.0f ms, %u%% alerts:\r\n", s_numRecords,
+           TEST_RUN_MS / 1000U, TEST_BURST_EVENTS, TEST_EVENT_GAP_MS, TEST_BURST_GAP_MS, TEST_ALERT_PERCENT);
+    TEST_CHECK(s_numRecords > 1000U);
+    TEST_CHECK(s_numRecords < TEST_MAX_RECORDS);
+
+    for (i = 0U; i < sizeof(windows) / sizeof(windows[0]); i++)
+    {
+        pdus[i] = Test_Run(windows[i]);
+    }
+
+    /* Without a window every record is a PDU, a longer window never sends more. The default window,
+     * FXLS8974_EVENT_BATCH_MS, at least halves the PDUs. */
+    TEST_CHECK_EQUAL(pdus[0], s_numRecords);
+    TEST_CHECK(2U * pdus[3] < pdus[0]);
+    for (i = 1U; i < sizeof(windows) / sizeof(windows[0]); i++)
+    {
+        TEST_CHECK(pdus[i] <= pdus[i - 1U]);
+    }
+}
+
+int main(void)
+{
+    Test_Windows();
+
+    return TEST_RESULT();
+}
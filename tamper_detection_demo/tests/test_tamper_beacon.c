@@ -0,0 +1,323 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file test_tamper_beacon.c
+ * @brief The test_tamper_beacon.c file plays both ends of the tamper beacon: the node seals beacons as
+ *        BleApp_UpdateBeacon() does, with the counter reserved in NVM by BleApp_ReserveBeaconCounter() and restored
+ *        by BleApp_StartBeacon(), and a gateway decodes them, checks the AES-CMAC MIC with OpenSSL and only takes a
+ *        counter above the last one. Through resets and NVM failures no counter is sent twice, every fresh beacon is
+ *        taken, and a replayed, altered or foreign beacon is not.
+ */
+
+#include <string.h>
+#include <openssl/evp.h>
+#include <openssl/params.h>
+#include "test_util.h"
+#include "tamper_beacon.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_KEY_SIZE     (16U)
+#define TEST_MAC_SIZE     (16U)
+#define TEST_WINDOW       (16U)  /* <P>_BROADCAST_COUNTER_WINDOW, small to reserve often. */
+#define TEST_UPDATES      (2000U)
+#define TEST_MAX_SENT     (TEST_UPDATES)
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief The node: the beacon, its counter, and the NVM data set of the counter limit. */
+typedef struct
+{
+    uint8_t beacon[TAMPER_BEACON_MAX_SIZE];
+    uint32_t length;
+    uint32_t counter;
+    uint32_t limit;
+    uint32_t nvmLimit;  /* What survives a reset. */
+    bool nvmFails;
+    uint32_t nvmWrites;
+} testnode_t;
+
+typedef struct
+{
+    bool seen;
+    uint32_t last;
+} testgateway_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static const uint8_t s_key[TEST_KEY_SIZE] = {0x2BU, 0x7EU, 0x15U, 0x16U, 0x28U, 0xAEU, 0xD2U, 0xA6U,
+                                             0xABU, 0xF7U, 0x15U, 0x88U, 0x09U, 0xCFU, 0x4FU, 0x3CU};
+static uint8_t s_sent[TEST_MAX_SENT][TAMPER_BEACON_MAX_SIZE];
+static uint32_t s_sentLength[TEST_MAX_SENT];
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/* AES_128_CMAC() of SecLib, on the gateway. */
+static void Test_Cmac(const uint8_t *pData, uint32_t length, const uint8_t *pKey, uint8_t *pMac)
+{
+    EVP_MAC *pMacAlg = EVP_MAC_fetch(NULL, "CMAC", NULL);
+    EVP_MAC_CTX *pCtx = EVP_MAC_CTX_new(pMacAlg);
+    OSSL_PARAM params[] = {OSSL_PARAM_construct_utf8_string("cipher", "AES-128-CBC", 0), OSSL_PARAM_construct_end()};
+    size_t macLength = 0U;
+
+    TEST_CHECK(EVP_MAC_init(pCtx, pKey, TEST_KEY_SIZE, params) == 1);
+    TEST_CHECK(EVP_MAC_update(pCtx, pData, length) == 1);
+    TEST_CHECK(EVP_MAC_final(pCtx, pMac, &macLength, TEST_MAC_SIZE) == 1);
+    TEST_CHECK_EQUAL(macLength, TEST_MAC_SIZE);
+    EVP_MAC_CTX_free(pCtx);
+    EVP_MAC_free(pMacAlg);
+}
+
+/* BleApp_ReserveBeaconCounter() */
+static bool Test_Reserve(testnode_t *pNode)
+{
+    if (pNode->nvmFails)
+    {
+        return false;
+    }
+    pNode->limit = pNode->counter + TEST_WINDOW;
+    pNode->nvmLimit = pNode->limit;
+    pNode->nvmWrites++;
+
+    return true;
+}
+
+/* BleApp_StartBeacon(), after a reset. */
+static void Test_Boot(testnode_t *pNode)
+{
+    pNode->limit = pNode->nvmLimit;
+    pNode->counter = pNode->limit;
+}
+
+/* BleApp_UpdateBeacon() */
+static bool Test_Update(testnode_t *pNode, const uint8_t *pRecord, uint32_t recordLength)
+{
+    uint8_t mac[TEST_MAC_SIZE];
+    uint32_t length;
+
+    if ((pNode->counter == pNode->limit) && !Test_Reserve(pNode))
+    {
+        return false;
+    }
+    length = TamperBeacon_Encode(pNode->beacon, pNode->counter, pRecord, recordLength);
+    if (0U == length)
+    {
+        return false;
+    }
+    pNode->counter++;
+    Test_Cmac(pNode->beacon, length, s_key, mac);
+    pNode->length = TamperBeacon_Seal(pNode->beacon, length, mac);
+
+    return true;
+}
+
+/* The gateway takes a beacon of a known format, with a valid MIC and a counter above the last one. */
+static bool Test_Accept(testgateway_t *pGateway, const uint8_t *pBeacon, uint32_t length, const uint8_t *pKey,
+                        tamperevent_t *pEvent)
+{
+    uint8_t mac[TEST_MAC_SIZE];
+    uint32_t covered;
+    uint32_t counter = 0U;
+    bool hasEvent = false;
+
+    covered = TamperBeacon_Decode(pBeacon, length, &counter, pEvent, &hasEvent);
+    if (0U == covered)
+    {
+        return false;
+    }
+    Test_Cmac(pBeacon, covered, pKey, mac);
+    if (!TamperBeacon_Verify(&pBeacon[covered], mac) || (pGateway->seen && (counter <= pGateway->last)))
+    {
+        return false;
+    }
+    pGateway->seen = true;
+    pGateway->last = counter;
+
+    return true;
+}
+
+static uint32_t Test_Record(uint8_t *pRecord, uint8_t sequence)
+{
+    tamperevent_t event;
+    uint8_t cls = 3U;
+
+    TamperEvent_Init(&event, mTamperEvent_Motion_c, mTamperSeverity_Alert_c, 0x86U, sequence, 1000U * sequence);
+    (void)TamperEvent_AddItem(&event, TAMPER_ITEM_CLASS, &cls);
+
+    return TamperEvent_Encode(&event, pRecord, TAMPER_EVENT_MAX_SIZE);
+}
+
+/* The gateway side computes the same MAC as SecLib, RFC 4493 example 2. */
+static void Test_CmacVector(void)
+{
+    static const uint8_t message[] = {0x6BU, 0xC1U, 0xBEU, 0xE2U, 0x2EU, 0x40U, 0x9FU, 0x96U,
+                                      0xE9U, 0x3DU, 0x7EU, 0x11U, 0x73U, 0x93U, 0x17U, 0x2AU};
+    static const uint8_t expected[] = {0x07U, 0x0AU, 0x16U, 0xB4U, 0x6BU, 0x4DU, 0x41U, 0x44U,
+                                       0xF7U, 0x9BU, 0xDDU, 0x9DU, 0xD0U, 0x4AU, 0x28U, 0x7CU};
+    uint8_t mac[TEST_MAC_SIZE];
+
+    Test_Cmac(message, sizeof(message), s_key, mac);
+    TEST_CHECK(0 == memcmp(mac, expected, sizeof(mac)));
+}
+
+static void Test_Format(void)
+{
+    testnode_t node;
+    testgateway_t gateway;
+    tamperevent_t event;
+    uint8_t record[TAMPER_EVENT_MAX_SIZE + 1U];
+    uint8_t beacon[TAMPER_BEACON_MAX_SIZE + 1U];
+    uint32_t recordLength = Test_Record(record, 1U);
+    uint32_t counter = 0U;
+    bool hasEvent = true;
+
+    memset(&node, 0, sizeof(node));
+    memset(&gateway, 0, sizeof(gateway));
+
+    /* Alive only. */
+    TEST_CHECK(Test_Update(&node, NULL, 0U));
+    TEST_CHECK_EQUAL(node.length, TAMPER_BEACON_HEADER_SIZE + TAMPER_BEACON_MIC_SIZE);
+    TEST_CHECK_EQUAL(node.beacon[0], 0x25U);
+    TEST_CHECK_EQUAL(node.beacon[2], TAMPER_BEACON_MAGIC | TAMPER_BEACON_VERSION);
+    TEST_CHECK_EQUAL(TamperBeacon_Decode(node.beacon, node.length, &counter, &event, &hasEvent),
+                     TAMPER_BEACON_HEADER_SIZE);
+    TEST_CHECK(!hasEvent);
+    TEST_CHECK_EQUAL(counter, 0U);
+    TEST_CHECK(Test_Accept(&gateway, node.beacon, node.length, s_key, &event));
+
+    /* With a record. Even the largest, with its AD header, fits one AUX_ADV_IND of the extended set. */
+    TEST_CHECK(Test_Update(&node, record, recordLength));
+    TEST_CHECK_EQUAL(node.length, TAMPER_BEACON_HEADER_SIZE + recordLength + TAMPER_BEACON_MIC_SIZE);
+    memset(&event, 0, sizeof(event));
+    TEST_CHECK(Test_Accept(&gateway, node.beacon, node.length, s_key, &event));
+    TEST_CHECK_EQUAL(gateway.last, 1U);
+    TEST_CHECK_EQUAL(event.type, mTamperEvent_Motion_c);
+    TEST_CHECK_EQUAL(event.sequence, 1U);
+    TEST_CHECK_EQUAL(*TamperEvent_FindItem(&event, TAMPER_ITEM_CLASS), 3U);
+    TEST_CHECK(TAMPER_BEACON_MAX_SIZE + 2U <= 254U);
+
+    /* A record too large, a short beacon, another company or format, version 0, a record which does not fill it. */
+    TEST_CHECK_EQUAL(TamperBeacon_Encode(beacon, 0U, record, TAMPER_EVENT_MAX_SIZE + 1U), 0U);
+    TEST_CHECK_EQUAL(TamperBeacon_Decode(node.beacon, TAMPER_BEACON_HEADER_SIZE + TAMPER_BEACON_MIC_SIZE - 1U,
+                                         &counter, &event, &hasEvent), 0U);
+    memcpy(beacon, node.beacon, node.length);
+    beacon[0] ^= 0x01U;
+    TEST_CHECK_EQUAL(TamperBeacon_Decode(beacon, node.length, &counter, &event, &hasEvent), 0U);
+    memcpy(beacon, node.beacon, node.length);
+    beacon[2] = 0xA1U;
+    TEST_CHECK_EQUAL(TamperBeacon_Decode(beacon, node.length, &counter, &event, &hasEvent), 0U);
+    beacon[2] = TAMPER_BEACON_MAGIC;
+    TEST_CHECK_EQUAL(TamperBeacon_Decode(beacon, node.length, &counter, &event, &hasEvent), 0U);
+    TEST_CHECK_EQUAL(TamperBeacon_Decode(node.beacon, node.length + 1U, &counter, &event, &hasEvent), 0U);
+}
+
+/* Any one bit flipped is refused, by the decoder or by the MIC, and so is a beacon sealed with another key. */
+static void Test_Forgery(void)
+{
+    static const uint8_t otherKey[TEST_KEY_SIZE] = {1U};
+    testnode_t node;
+    testgateway_t gateway;
+    tamperevent_t event;
+    uint8_t record[TAMPER_EVENT_MAX_SIZE];
+    uint8_t beacon[TAMPER_BEACON_MAX_SIZE];
+    uint32_t recordLength = Test_Record(record, 9U);
+    uint32_t accepted = 0U;
+    uint32_t bit;
+
+    memset(&node, 0, sizeof(node));
+    TEST_CHECK(Test_Update(&node, record, recordLength));
+    for (bit = 0U; bit < 8U * node.length; bit++)
+    {
+        memset(&gateway, 0, sizeof(gateway));
+        memcpy(beacon, node.beacon, node.length);
+        beacon[bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+        accepted += Test_Accept(&gateway, beacon, node.length, s_key, &event) ? 1U : 0U;
+    }
+    TEST_CHECK_EQUAL(accepted, 0U);
+
+    memset(&gateway, 0, sizeof(gateway));
+    TEST_CHECK(!Test_Accept(&gateway, node.beacon, node.length, otherKey, &event));
+    TEST_CHECK(Test_Accept(&gateway, node.beacon, node.length, s_key, &event));
+}
+
+/* Updates with resets and NVM failures in between: the counter never repeats, the gateway takes every beacon the
+ * node sent, and none of them again. */
+static void Test_Counter(void)
+{
+    static testnode_t node;
+    testgateway_t gateway;
+    tamperevent_t event;
+    uint8_t record[TAMPER_EVENT_MAX_SIZE];
+    uint32_t seed = 7U;
+    uint32_t sent = 0U;
+    uint32_t refused = 0U;
+    uint32_t resets = 0U;
+    uint32_t replays = 0U;
+    uint32_t counter;
+    bool hasEvent;
+    uint32_t i;
+
+    memset(&node, 0, sizeof(node));
+    memset(&gateway, 0, sizeof(gateway));
+    Test_Boot(&node);
+
+    for (i = 0U; i < TEST_UPDATES; i++)
+    {
+        seed = seed * 1103515245U + 12345U;
+        if (0U == ((seed >> 16) % 50U))
+        {
+            Test_Boot(&node);
+            resets++;
+        }
+        node.nvmFails = (0U == ((seed >> 8) % 40U));
+
+        if (!Test_Update(&node, record, Test_Record(record, (uint8_t)i)))
+        {
+            /* The beacon keeps its last content, which the gateway already has. */
+            refused++;
+            TEST_CHECK((0U == sent) || !Test_Accept(&gateway, node.beacon, node.length, s_key, &event));
+            continue;
+        }
+        TEST_CHECK(Test_Accept(&gateway, node.beacon, node.length, s_key, &event));
+        TEST_CHECK_EQUAL(event.sequence, (uint8_t)i);
+        memcpy(s_sent[sent], node.beacon, node.length);
+        s_sentLength[sent] = node.length;
+        sent++;
+    }
+
+    /* Every beacon ever sent, replayed after the last one. */
+    for (i = 0U; i < sent; i++)
+    {
+        replays += Test_Accept(&gateway, s_sent[i], s_sentLength[i], s_key, &event) ? 1U : 0U;
+    }
+    (void)TamperBeacon_Decode(node.beacon, node.length, &counter, &event, &hasEvent);
+
+    printf("%u beacons, %u resets, %u held by a failed NVM write, %u NVM writes, last counter %u, %u replays "
+           "taken\r\n",
+           sent, resets, refused, node.nvmWrites, counter, replays);
+
+    TEST_CHECK(resets > 0U);
+    TEST_CHECK(refused > 0U);
+    TEST_CHECK_EQUAL(replays, 0U);
+    /* Each reset skips at most what was left of the window, one NVM write per window otherwise. */
+    TEST_CHECK(counter < sent + (resets + 1U) * TEST_WINDOW);
+    TEST_CHECK(node.nvmWrites <= sent / TEST_WINDOW + resets + 1U);
+}
+
+int main(void)
+{
+    Test_CmacVector();
+    Test_Format();
+    Test_Forgery();
+    Test_Counter();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,335 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file test_tamper_classifier.c
+ * @brief The test_tamper_classifier.c file runs the motion classifier of the FXLS8974 application, the
+ *        cFxls8974TamperModel decision tree, on the labeled traces motion_<class>.csv and prints the confusion
+ *        matrix. Each trace is cut into windows the way the application does: a window opens when an axis leaves
+ *        the SDCD band around the resting value, takes the samples a watermark's worth at a time and is classified
+ *        once FXLS8974_CLASSIFY_WINDOW samples are in, or when the sensor goes back to sleep. The test also walks
+ *        every path of the tree to bound the nodes of one inference and times the slowest window.
+ */
+
+#include <string.h>
+#include <time.h>
+#include "test_util.h"
+#include "trace_replay.h"
+#include "fxls89xx_motion_wakeup.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* A gap in a trace longer than the ASLP count, 5 s, puts the sensor back to sleep. */
+#define TEST_SLEEP_GAP_MS   (5000U)
+#define TEST_BENCH_ROUNDS   (10000U)
+#define TEST_MAX_WINDOWS    (64U)
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+typedef struct
+{
+    const char *pPath;
+    tamperClass_t label;
+} testtrace_t;
+
+/* One classified window, kept for the timing. */
+typedef struct
+{
+    tamperwindow_t window;
+    tamperClass_t label;
+} testwindow_t;
+
+/* The state of the application between two drains. */
+typedef struct
+{
+    fxls8974_acceldata_t burst[FXLS8974_FIFO_WATERMARK];
+    tamperwindow_t window;
+    int32_t reference[MOTION_FEATURES_AXES];
+    uint32_t lastTime;
+    uint8_t numBurst;
+    bool awake;
+    bool classifying;
+} testsensor_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static const testtrace_t s_traces[] = {
+    {TEST_TRACE("motion_vibration.csv"), mTamperClass_Vibration_c},
+    {TEST_TRACE("motion_tilt.csv"), mTamperClass_Tilt_c},
+    {TEST_TRACE("motion_impact.csv"), mTamperClass_Impact_c},
+    {TEST_TRACE("motion_handling.csv"), mTamperClass_Handling_c},
+};
+
+static uint32_t s_confusion[mTamperClass_Count_c][mTamperClass_Count_c];
+static testwindow_t s_windows[TEST_MAX_WINDOWS];
+static uint32_t s_numWindows;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/* fxls89xx_Classify() */
+static void Test_Classify(testsensor_t *pSensor, tamperClass_t label)
+{
+    int32_t vector[mTamperFeature_Count_c];
+    tamperClass_t cls;
+
+    pSensor->classifying = false;
+    TEST_CHECK(s_numWindows < TEST_MAX_WINDOWS);
+    if (s_numWindows >= TEST_MAX_WINDOWS)
+    {
+        return;
+    }
+
+    TamperClassifier_Features(&cFxls8974TamperModel, &pSensor->window, vector);
+    cls = TamperClassifier_Run(&cFxls8974TamperModel, vector);
+    s_windows[s_numWindows].window = pSensor->window;
+    s_windows[s_numWindows].label = label;
+    s_numWindows++;
+    s_confusion[label][cls]++;
+}
+
+/* fxls89xx_buf_drain(), one watermark of samples. */
+static void Test_Drain(testsensor_t *pSensor, tamperClass_t label)
+{
+    motionfeatures_t features;
+
+    MotionFeatures_Compute(pSensor->burst, pSensor->numBurst, &features);
+    pSensor->numBurst = 0U;
+    if (pSensor->classifying)
+    {
+        TamperClassifier_WindowAdd(&pSensor->window, &features);
+        if (pSensor->window.numSamples >= FXLS8974_CLASSIFY_WINDOW)
+        {
+            Test_Classify(pSensor, label);
+        }
+    }
+}
+
+/* fxls89xx_BufStopHandler(), the sensor went back to sleep. */
+static void Test_Sleep(testsensor_t *pSensor, tamperClass_t label)
+{
+    if (pSensor->numBurst != 0U)
+    {
+        Test_Drain(pSensor, label);
+    }
+    if (pSensor->classifying)
+    {
+        Test_Classify(pSensor, label);
+    }
+    pSensor->awake = false;
+}
+
+/* SDCD in relative mode, SimFxls8974_Sdcd(): a sample outside the band around the reference wakes the sensor and
+ * becomes the reference. The first sample after a sleep is the reference. */
+static bool Test_Wakes(testsensor_t *pSensor, const tracesample_t *pSample, bool first)
+{
+    bool wake = false;
+    int32_t delta;
+    uint8_t axis;
+
+    for (axis = 0U; axis < MOTION_FEATURES_AXES; axis++)
+    {
+        delta = pSample->value[axis] - pSensor->reference[axis];
+        wake = wake || (delta > FXLS8974_SDCD_THS) || (delta < -FXLS8974_SDCD_THS);
+    }
+    if (first || wake)
+    {
+        for (axis = 0U; axis < MOTION_FEATURES_AXES; axis++)
+        {
+            pSensor->reference[axis] = pSample->value[axis];
+        }
+    }
+
+    return wake && !first;
+}
+
+static void Test_RunTrace(const testtrace_t *pTrace)
+{
+    testsensor_t sensor;
+    tracereplay_t trace;
+    tracesample_t sample;
+    bool first = true;
+    bool wake;
+    uint8_t axis;
+
+    memset(&sensor, 0, sizeof(sensor));
+    TEST_CHECK(TraceReplay_Open(&trace, pTrace->pPath));
+    while (TraceReplay_Next(&trace, &sample))
+    {
+        if (sensor.awake && ((sample.time_ms - sensor.lastTime) > TEST_SLEEP_GAP_MS))
+        {
+            Test_Sleep(&sensor, pTrace->label);
+            first = true;
+        }
+        sensor.lastTime = sample.time_ms;
+
+        if (!sensor.awake)
+        {
+            wake = Test_Wakes(&sensor, &sample, first);
+            first = false;
+            if (!wake)
+            {
+                continue;
+            }
+            /* Wake mode detected, the window opens with the sample which woke the sensor. */
+            sensor.awake = true;
+            sensor.classifying = true;
+            TamperClassifier_WindowInit(&sensor.window);
+        }
+
+        for (axis = 0U; axis < MOTION_FEATURES_AXES; axis++)
+        {
+            sensor.burst[sensor.numBurst].accel[axis] = (int16_t)sample.value[axis];
+        }
+        if (++sensor.numBurst == FXLS8974_FIFO_WATERMARK)
+        {
+            Test_Drain(&sensor, pTrace->label);
+        }
+    }
+    TEST_CHECK(!trace.error);
+    TraceReplay_Close(&trace);
+    if (sensor.awake)
+    {
+        Test_Sleep(&sensor, pTrace->label);
+    }
+}
+
+static void Test_Confusion(void)
+{
+    uint32_t correct = 0U;
+    uint32_t total = 0U;
+    uint32_t row;
+    uint32_t col;
+    uint32_t i;
+
+    for (i = 0U; i < sizeof(s_traces) / sizeof(s_traces[0]); i++)
+    {
+        Test_RunTrace(&s_traces[i]);
+    }
+
+    printf("cFxls8974TamperModel confusion matrix, rows labeled, columns classified:\r\n%10s", "");
+    for (col = 0U; col < (uint32_t)mTamperClass_Count_c; col++)
+    {
+        printf(" %9s", TamperClassifier_Name((tamperClass_t)col));
+    }
+    printf("\r\n");
+    for (row = 1U; row < (uint32_t)mTamperClass_Count_c; row++)
+    {
+        printf("%10s", TamperClassifier_Name((tamperClass_t)row));
+        for (col = 0U; col < (uint32_t)mTamperClass_Count_c; col++)
+        {
+            printf(" %9u", s_confusion[row][col]);
+            total += s_confusion[row][col];
+        }
+        correct += s_confusion[row][row];
+        printf("\r\n");
+    }
+    printf("%u of %u windows classified as labeled\r\n", correct, total);
+
+    /* Every motion of the traces opened one window, none of them fell out of the model. */
+    TEST_CHECK_EQUAL(total, 24U);
+    for (row = 0U; row < (uint32_t)mTamperClass_Count_c; row++)
+    {
+        TEST_CHECK_EQUAL(s_confusion[row][mTamperClass_Unknown_c], 0U);
+    }
+    /* What matters on the device is the alert: vibration never raises one, the other motions always do but for the
+     * knock of motion_impact.csv which stays below 2g and is taken for vibration. Handling is often taken for a tilt,
+     * it alerts all the same. */
+    for (col = 0U; col < (uint32_t)mTamperClass_Count_c; col++)
+    {
+        if (0U != (FXLS8974_CLASSIFY_ALERT_MASK & TAMPER_CLASS_MASK(col)))
+        {
+            TEST_CHECK_EQUAL(s_confusion[mTamperClass_Vibration_c][col], 0U);
+        }
+    }
+    TEST_CHECK_EQUAL(s_confusion[mTamperClass_Impact_c][mTamperClass_Vibration_c], 1U);
+    TEST_CHECK_EQUAL(s_confusion[mTamperClass_Tilt_c][mTamperClass_Vibration_c], 0U);
+    TEST_CHECK_EQUAL(s_confusion[mTamperClass_Handling_c][mTamperClass_Vibration_c], 0U);
+    TEST_CHECK_EQUAL(correct, 20U);
+}
+
+/* The longest root to leaf path, the nodes TamperClassifier_Run() visits at worst. */
+static uint32_t Test_Depth(uint8_t index)
+{
+    const tampernode_t *pNode = &cFxls8974TamperModel.pNodes[index];
+    uint32_t left;
+    uint32_t right;
+
+    if (pNode->feature == TAMPER_NODE_LEAF)
+    {
+        return 1U;
+    }
+    left = Test_Depth(pNode->left);
+    right = Test_Depth(pNode->right);
+
+    return 1U + ((left > right) ? left : right);
+}
+
+/* Host cycles where a time stamp counter is at hand, else host ns. */
+static uint64_t Test_Ticks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+#endif
+}
+
+/* fxls89xx_Classify() runs TamperClassifier_Features() then TamperClassifier_Run() once per motion. */
+static void Test_Bench(void)
+{
+    int32_t vector[mTamperFeature_Count_c];
+    volatile uint32_t sink = 0U;
+    uint64_t start;
+    uint64_t ticks;
+    uint64_t best;
+    uint64_t worst = 0U;
+    uint32_t depth;
+    uint32_t round;
+    uint32_t i;
+
+    depth = Test_Depth(0U);
+    TEST_CHECK(depth <= TAMPER_CLASSIFIER_MAX_DEPTH);
+
+    /* The cheapest of many runs is the cost of a window without the noise of the host, the dearest window the worst
+     * case. */
+    for (i = 0U; i < s_numWindows; i++)
+    {
+        best = UINT64_MAX;
+        for (round = 0U; round < TEST_BENCH_ROUNDS; round++)
+        {
+            start = Test_Ticks();
+            TamperClassifier_Features(&cFxls8974TamperModel, &s_windows[i].window, vector);
+            sink += (uint32_t)TamperClassifier_Run(&cFxls8974TamperModel, vector);
+            ticks = Test_Ticks() - start;
+            best = (ticks < best) ? ticks : best;
+        }
+        worst = (best > worst) ? best : worst;
+    }
+
+    printf("TamperClassifier_Run: %u nodes at worst, %llu %s per inference at worst on the host\r\n", depth,
+           (unsigned long long)worst,
+#if defined(__x86_64__) || defined(__i386__)
+           "cycles"
+#else
+           "ns"
+#endif
+    );
+}
+
+int main(void)
+{
+    Test_Confusion();
+    Test_Bench();
+
+    return TEST_RESULT();
+}
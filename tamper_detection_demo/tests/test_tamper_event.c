@@ -0,0 +1,285 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file test_tamper_event.c
+ * @brief The test_tamper_event.c file checks that tamper event records survive the round trip, that the decoder
+ *        rejects what is not a whole record, and counts the ATT PDUs, ATT bytes and airtime of each alert of the
+ *        applications as binary records against the 70 byte text banners they replaced.
+ */
+
+#include <string.h>
+#include "test_util.h"
+#include "tamper_event.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_BANNER_SIZE    (70U) /* Every text banner goes out as 70 bytes. */
+#define TEST_MTU_DEFAULT    (23U) /* gAttDefaultMtu_c */
+#define TEST_MTU_MAX        (247U) /* gAttMaxMtu_c, the Wireless UART peers exchange it. */
+#define TEST_ATT_HEADER     (3U) /* Opcode and handle of a write command, notification or indication. */
+#define TEST_ATT_CONFIRM    (1U) /* Handle value confirmation. */
+#define TEST_L2CAP_HEADER   (4U)
+#define TEST_LL_OVERHEAD    (10U) /* Preamble, access address, header and CRC of a link layer packet, 1M PHY. */
+#define TEST_LL_PAYLOAD     (27U) /* Without data length extension. */
+#define TEST_LL_PAYLOAD_DLE (251U) /* With it. */
+#define TEST_US_PER_BYTE    (8U)
+
+#define TEST_ID_FXLS8974    (0x86U) /* FXLS8974_WHOAMI_VALUE */
+#define TEST_ID_MPL3115     (0xC4U) /* MPL3115_WHOAMI_VALUE */
+#define TEST_ID_NMH1000     (0x01U) /* NMH1000_WHO_AM_I_VALUE */
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief One alert: the banners of the text mode, the record of the binary mode. */
+typedef struct
+{
+    const char *pName;
+    uint32_t banners;
+    uint32_t (*build)(uint8_t *pRecord);
+} testscenario_t;
+
+typedef struct
+{
+    uint32_t pdus;
+    uint32_t attBytes;
+    uint32_t air_us;
+} testair_t;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/* fxls89xx_send_event(): a classified motion with a new orientation, sent as a tilt. */
+static uint32_t Test_FxlsTilt(uint8_t *pRecord)
+{
+    static const uint8_t source[] = {0x80U, 0x02U};
+    uint8_t cls = 1U;
+    tamperevent_t event;
+
+    TamperEvent_Init(&event, mTamperEvent_Tilt_c, mTamperSeverity_Alert_c, TEST_ID_FXLS8974, 7U, 123456U);
+    TEST_CHECK(TamperEvent_AddItem(&event, TAMPER_ITEM_CLASS, &cls));
+    TEST_CHECK(TamperEvent_AddItem(&event, TAMPER_ITEM_ORIENT, source));
+
+    return TamperEvent_Encode(&event, pRecord, TAMPER_EVENT_MAX_SIZE);
+}
+
+/* fxls89xx_send_event(): back at rest. */
+static uint32_t Test_FxlsSafe(uint8_t *pRecord)
+{
+    tamperevent_t event;
+
+    TamperEvent_Init(&event, mTamperEvent_Safe_c, mTamperSeverity_Info_c, TEST_ID_FXLS8974, 8U, 124456U);
+
+    return TamperEvent_Encode(&event, pRecord, TAMPER_EVENT_MAX_SIZE);
+}
+
+/* mpl3115_send_event(): the pressure and the reference it left. */
+static uint32_t Test_MplPressure(uint8_t *pRecord)
+{
+    static const uint8_t pressure[] = {0x58U, 0x8BU, 0x01U, 0x00U, 0xCEU, 0x8BU, 0x01U, 0x00U};
+    tamperevent_t event;
+
+    TamperEvent_Init(&event, mTamperEvent_Pressure_c, mTamperSeverity_Alert_c, TEST_ID_MPL3115, 3U, 100000U);
+    TEST_CHECK(TamperEvent_AddItem(&event, TAMPER_ITEM_PRESSURE, pressure));
+
+    return TamperEvent_Encode(&event, pRecord, TAMPER_EVENT_MAX_SIZE);
+}
+
+/* nmh1000_send_event(): no payload. */
+static uint32_t Test_NmhMagnetic(uint8_t *pRecord)
+{
+    tamperevent_t event;
+
+    TamperEvent_Init(&event, mTamperEvent_Magnetic_c, mTamperSeverity_Alert_c, TEST_ID_NMH1000, 1U, 10000U);
+
+    return TamperEvent_Encode(&event, pRecord, TAMPER_EVENT_MAX_SIZE);
+}
+
+static const testscenario_t s_scenarios[] = {
+    {"FXLS8974 tilt", 3U, Test_FxlsTilt},       /* vec_motion_start, vec_motion_dec, vec_motion_end */
+    {"FXLS8974 at rest", 1U, Test_FxlsSafe},    /* vec_ASLP */
+    {"MPL3115 pressure", 3U, Test_MplPressure}, /* pressure_alert1, pressure_tamper, pressure_alert2 */
+    {"NMH1000 magnet", 3U, Test_NmhMagnetic},   /* vec_mag_start, vec_mag_dec, vec_mag_end */
+};
+
+/* One ATT PDU, cut into link layer packets. */
+static void Test_Pdu(testair_t *pAir, uint32_t attLength, uint32_t llPayload)
+{
+    uint32_t l2cap = TEST_L2CAP_HEADER + attLength;
+    uint32_t packets = (l2cap + llPayload - 1U) / llPayload;
+
+    pAir->pdus++;
+    pAir->attBytes += attLength;
+    pAir->air_us += (l2cap + packets * TEST_LL_OVERHEAD) * TEST_US_PER_BYTE;
+}
+
+static void Test_RoundTrip(void)
+{
+    static const uint8_t pressure[] = {1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U};
+    uint8_t record[TAMPER_EVENT_MAX_SIZE + 1U];
+    tamperevent_t event;
+    tamperevent_t decoded;
+    uint8_t cls = 2U;
+    uint32_t size;
+
+    TamperEvent_Init(&event, mTamperEvent_Pressure_c, mTamperSeverity_Warning_c, 0xC4U, 255U, 0xDEADBEEFU);
+    TEST_CHECK(TamperEvent_AddItem(&event, TAMPER_ITEM_PRESSURE, pressure));
+    TEST_CHECK(!TamperEvent_AddItem(&event, TAMPER_ITEM_PRESSURE, pressure));
+    TEST_CHECK(TamperEvent_AddItem(&event, TAMPER_ITEM_CLASS, &cls));
+    TEST_CHECK(!TamperEvent_AddItem(&event, TAMPER_ITEM_CLASS, &cls));
+    TEST_CHECK_EQUAL(event.payloadLength, TAMPER_EVENT_MAX_PAYLOAD);
+
+    TEST_CHECK_EQUAL(TamperEvent_Encode(&event, record, TAMPER_EVENT_MAX_SIZE - 1U), 0U);
+    size = TamperEvent_Encode(&event, record, sizeof(record));
+    TEST_CHECK_EQUAL(size, TAMPER_EVENT_MAX_SIZE);
+    TEST_CHECK_EQUAL(record[0], TAMPER_EVENT_MAGIC | TAMPER_EVENT_VERSION);
+    TEST_CHECK_EQUAL(record[4], 0xEFU);
+    TEST_CHECK_EQUAL(record[7], 0xDEU);
+
+    memset(&decoded, 0, sizeof(decoded));
+    TEST_CHECK_EQUAL(TamperEvent_Decode(record, size, &decoded), size);
+    TEST_CHECK_EQUAL(decoded.version, TAMPER_EVENT_VERSION);
+    TEST_CHECK_EQUAL(decoded.type, mTamperEvent_Pressure_c);
+    TEST_CHECK_EQUAL(decoded.severity, mTamperSeverity_Warning_c);
+    TEST_CHECK_EQUAL(decoded.sensorId, 0xC4U);
+    TEST_CHECK_EQUAL(decoded.sequence, 255U);
+    TEST_CHECK_EQUAL(decoded.timestamp, 0xDEADBEEFU);
+    TEST_CHECK(0 == memcmp(TamperEvent_FindItem(&decoded, TAMPER_ITEM_PRESSURE), pressure, sizeof(pressure)));
+    TEST_CHECK_EQUAL(*TamperEvent_FindItem(&decoded, TAMPER_ITEM_CLASS), cls);
+    TEST_CHECK(NULL == TamperEvent_FindItem(&decoded, TAMPER_ITEM_ORIENT));
+
+    /* A later version decodes as far as this one knows it. */
+    record[0] = TAMPER_EVENT_MAGIC | (TAMPER_EVENT_VERSION + 1U);
+    TEST_CHECK_EQUAL(TamperEvent_Decode(record, size, &decoded), size);
+    TEST_CHECK_EQUAL(decoded.version, TAMPER_EVENT_VERSION + 1U);
+}
+
+static void Test_Reject(void)
+{
+    uint8_t record[TAMPER_EVENT_MAX_SIZE];
+    uint8_t bad[TAMPER_EVENT_MAX_SIZE];
+    tamperevent_t event;
+    uint32_t size = Test_FxlsTilt(record);
+
+    TEST_CHECK_EQUAL(size, TAMPER_EVENT_HEADER_SIZE + 5U);
+    /* Truncated anywhere. */
+    TEST_CHECK_EQUAL(TamperEvent_Decode(record, size - 1U, &event), 0U);
+    TEST_CHECK_EQUAL(TamperEvent_Decode(record, TAMPER_EVENT_HEADER_SIZE - 1U, &event), 0U);
+    /* Text on the same stream, and version 0. */
+    TEST_CHECK_EQUAL(TamperEvent_Decode((const uint8_t *)"\r\n =============!!ALERT", 23U, &event), 0U);
+    memcpy(bad, record, size);
+    bad[0] = TAMPER_EVENT_MAGIC;
+    TEST_CHECK_EQUAL(TamperEvent_Decode(bad, size, &event), 0U);
+    /* A payload longer than allowed, and items which do not tile the payload. */
+    memcpy(bad, record, size);
+    bad[8] = TAMPER_EVENT_MAX_PAYLOAD + 1U;
+    TEST_CHECK_EQUAL(TamperEvent_Decode(bad, sizeof(bad), &event), 0U);
+    memcpy(bad, record, size);
+    bad[TAMPER_EVENT_HEADER_SIZE] = 0x13U;
+    TEST_CHECK_EQUAL(TamperEvent_Decode(bad, size, &event), 0U);
+}
+
+/* Records back to back in one write decode one by one, a batch never grows past its limit. */
+static void Test_Batch(void)
+{
+    uint8_t record[TAMPER_EVENT_MAX_SIZE];
+    tamperbatch_t batch;
+    tamperevent_t event;
+    uint32_t size = Test_FxlsTilt(record);
+    uint32_t offset;
+    uint32_t length;
+    uint32_t count = 0U;
+
+    TamperEvent_BatchReset(&batch);
+    TEST_CHECK(!TamperEvent_BatchAppend(&batch, record, 0U, TEST_MTU_MAX - TEST_ATT_HEADER));
+    while (TamperEvent_BatchAppend(&batch, record, size, TEST_MTU_MAX - TEST_ATT_HEADER))
+    {
+        count++;
+    }
+    TEST_CHECK_EQUAL(count, (TEST_MTU_MAX - TEST_ATT_HEADER) / size);
+    TEST_CHECK_EQUAL(batch.length, count * size);
+
+    for (offset = 0U; offset < batch.length; offset += length)
+    {
+        length = TamperEvent_Decode(&batch.buffer[offset], batch.length - offset, &event);
+        TEST_CHECK_EQUAL(length, size);
+        if (0U == length)
+        {
+            break;
+        }
+        count--;
+    }
+    TEST_CHECK_EQUAL(count, 0U);
+
+    /* At the default MTU a batch holds one record. */
+    TamperEvent_BatchReset(&batch);
+    TEST_CHECK(TamperEvent_BatchAppend(&batch, record, size, TEST_MTU_DEFAULT - TEST_ATT_HEADER));
+    TEST_CHECK(!TamperEvent_BatchAppend(&batch, record, size, TEST_MTU_DEFAULT - TEST_ATT_HEADER));
+    TEST_CHECK_EQUAL(batch.length, size);
+}
+
+/* Per alert and peer. Text: one write command per banner at the exchanged MTU, where a banner fits. Binary: one
+ * notification, unconfirmed as the banners were, or one indication and its confirmation, both at the default MTU. */
+static void Test_Airtime(uint32_t llPayload)
+{
+    uint8_t record[TAMPER_EVENT_MAX_SIZE];
+    testair_t text;
+    testair_t notify;
+    testair_t indicate;
+    uint32_t size;
+    uint32_t i;
+    uint32_t j;
+
+    printf("LL payload %u bytes:\r\n", llPayload);
+    for (i = 0U; i < sizeof(s_scenarios) / sizeof(s_scenarios[0]); i++)
+    {
+        memset(&text, 0, sizeof(text));
+        memset(&notify, 0, sizeof(notify));
+        for (j = 0U; j < s_scenarios[i].banners; j++)
+        {
+            Test_Pdu(&text, TEST_ATT_HEADER + TEST_BANNER_SIZE, llPayload);
+        }
+        size = s_scenarios[i].build(record);
+        TEST_CHECK((size != 0U) && (size <= (TEST_MTU_DEFAULT - TEST_ATT_HEADER)));
+        Test_Pdu(&notify, TEST_ATT_HEADER + size, llPayload);
+        indicate = notify;
+        Test_Pdu(&indicate, TEST_ATT_CONFIRM, llPayload);
+
+        printf("%-17s: text %u PDUs %3u bytes %4u us, notification %u PDU %2u bytes %3u us, indication %u PDUs "
+               "%2u bytes %3u us\r\n",
+               s_scenarios[i].pName, text.pdus, text.attBytes, text.air_us, notify.pdus, notify.attBytes,
+               notify.air_us, indicate.pdus, indicate.attBytes, indicate.air_us);
+
+        TEST_CHECK_EQUAL(text.pdus, s_scenarios[i].banners);
+        TEST_CHECK_EQUAL(notify.pdus, 1U);
+        TEST_CHECK_EQUAL(indicate.pdus, 2U);
+        /* The ATT bytes of an alert drop more than ten times. The header and CRC every packet carries keep the
+         * airtime from following, the binary alerts still take less than a seventh of it. */
+        if (s_scenarios[i].banners == 3U)
+        {
+            TEST_CHECK(notify.attBytes * 10U < text.attBytes);
+            TEST_CHECK(notify.air_us * 7U < text.air_us);
+            TEST_CHECK(indicate.air_us * 5U < text.air_us);
+        }
+        else
+        {
+            TEST_CHECK(notify.air_us * 3U < text.air_us);
+        }
+    }
+}
+
+int main(void)
+{
+    Test_RoundTrip();
+    Test_Reject();
+    Test_Batch();
+    Test_Airtime(TEST_LL_PAYLOAD);
+    Test_Airtime(TEST_LL_PAYLOAD_DLE);
+
+    return TEST_RESULT();
+}
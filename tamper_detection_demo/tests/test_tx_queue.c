@@ -0,0 +1,527 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file test_tx_queue.c
+ * @brief The test_tx_queue.c file checks the ordering, eviction and retry rules of the transmit queue, then runs
+ *        one peer's queue against a host stack model which refuses writes with gBleOverflow_c when its buffers
+ *        run out, stalls for whole procedures and answers some indications with an error. The service loop
+ *        follows BleApp_QueueTx(), BleApp_ServiceTxQueue(), BleApp_TxConfirmed() and BleApp_ServiceTxQueues() of
+ *        wireless_uart.c. A snapshot sent behind an alert in flight checks that the ring is read only as fast as
+ *        the queue drains, as fxls89xx_SnapshotSendHandler() does, and that none of its samples is lost.
+ */
+
+#include <string.h>
+#include "test_util.h"
+#include "tx_queue.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_RUN_MS         (10000U) /* Traffic, then as long again to drain. */
+#define TEST_CONN_MS        (8U)     /* Connection interval, the stack frees its buffers and the peer confirms. */
+#define TEST_RETRY_MS       (20U)    /* mAppTxRetryIntervalInMs_c */
+#define TEST_BUFFERS        (2U)     /* Writes the stack takes per connection event. */
+#define TEST_STALL_EVERY_MS (1000U)  /* The peer runs another procedure, every write overflows ... */
+#define TEST_STALL_MS       (120U)   /* ... for this long. */
+#define TEST_NACK_EVERY     (5U)     /* One indication in this many is answered with an error. */
+#define TEST_MAX_ALERTS     (256U)
+#define TEST_SNAPSHOT       (96U)    /* FXLS8974_SNAPSHOT_SAMPLES */
+#define TEST_SAMPLE_SIZE    (16U)    /* sizeof(capturesample_t) */
+#define TEST_CHUNK_SAMPLES  (4U)     /* Samples per entry. */
+#define TEST_ALERT_RESERVE  (1U)     /* mAppTxAlertReserve_c */
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief gBleSuccess_c and gBleOverflow_c of the host stack. */
+typedef enum
+{
+    TEST_SUCCESS = 0,
+    TEST_OVERFLOW,
+} testresult_t;
+
+typedef struct
+{
+    txqueue_t queue;
+    uint32_t now_ms;
+    uint32_t buffers;        /* Left until the next connection event. */
+    bool stalled;
+    bool confirmPending;     /* An indication is in flight. */
+    uint32_t inFlight;       /* Its alert number. */
+    uint32_t indications;
+    bool retryArmed;
+    uint32_t retryAt_ms;
+    uint32_t overflows;
+    uint32_t pushed[mTxClass_Count_c];
+    uint32_t delivered[mTxClass_Count_c];
+    uint32_t nextAlert;      /* Number of the next alert to raise. */
+    uint32_t expectedAlert;  /* Number of the next alert the peer should confirm. */
+    uint32_t outOfOrder;
+    uint32_t worstLatency_ms;
+    uint32_t raisedAt_ms[TEST_MAX_ALERTS];
+    uint32_t snapshotLeft;   /* Samples still in the ring. */
+    uint8_t snapshotClass;
+    bool throttled;          /* The ring is read only while the queue has room, else all at once. */
+} testlink_t;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void Test_Entry(uint8_t *pData, uint8_t cls, uint32_t number)
+{
+    pData[0] = cls;
+    pData[1] = (uint8_t)number;
+    pData[2] = (uint8_t)(number >> 8);
+}
+
+static uint32_t Test_Number(const txentry_t *pEntry)
+{
+    return (uint32_t)pEntry->data[1] | ((uint32_t)pEntry->data[2] << 8);
+}
+
+static void Test_Rules(void)
+{
+    static const uint8_t big[TX_QUEUE_ENTRY_SIZE + 1U] = {0};
+    static const uint8_t message[TX_QUEUE_DEPTH * TX_QUEUE_ENTRY_SIZE + 1U] = {0};
+    txqueue_t queue;
+    uint8_t data[3];
+    uint32_t i;
+
+    TxQueue_Init(&queue);
+    TEST_CHECK(NULL == TxQueue_Head(&queue));
+    TEST_CHECK(!TxQueue_Push(&queue, mTxClass_Count_c, big, 1U));
+    TEST_CHECK(!TxQueue_Push(&queue, mTxClass_Debug_c, big, 0U));
+    TEST_CHECK(!TxQueue_Push(&queue, mTxClass_Debug_c, big, sizeof(big)));
+    TEST_CHECK(TxQueue_Push(&queue, mTxClass_Debug_c, big, TX_QUEUE_ENTRY_SIZE));
+
+    /* By class, then by age. */
+    Test_Entry(data, mTxClass_Status_c, 1U);
+    TEST_CHECK(TxQueue_Push(&queue, mTxClass_Status_c, data, sizeof(data)));
+    Test_Entry(data, mTxClass_Alert_c, 2U);
+    TEST_CHECK(TxQueue_Push(&queue, mTxClass_Alert_c, data, sizeof(data)));
+    Test_Entry(data, mTxClass_Alert_c, 3U);
+    TEST_CHECK(TxQueue_Push(&queue, mTxClass_Alert_c, data, sizeof(data)));
+    TEST_CHECK_EQUAL(Test_Number(TxQueue_Head(&queue)), 2U);
+    TxQueue_Done(&queue);
+    TEST_CHECK_EQUAL(Test_Number(TxQueue_Head(&queue)), 3U);
+
+    /* The head in flight keeps its place, even behind a newer alert. */
+    TxQueue_Done(&queue);
+    TEST_CHECK_EQUAL(TxQueue_Head(&queue)->cls, mTxClass_Status_c);
+    TxQueue_Wait(&queue);
+    Test_Entry(data, mTxClass_Alert_c, 4U);
+    TEST_CHECK(TxQueue_Push(&queue, mTxClass_Alert_c, data, sizeof(data)));
+    TEST_CHECK_EQUAL(TxQueue_Head(&queue)->cls, mTxClass_Status_c);
+    TEST_CHECK_EQUAL(queue.entries[1].cls, mTxClass_Alert_c);
+    TxQueue_Done(&queue);
+    TxQueue_Done(&queue);
+    TEST_CHECK_EQUAL(TxQueue_Head(&queue)->cls, mTxClass_Debug_c);
+
+    /* Full of debug text, an alert evicts the newest debug entry, more debug text is refused. */
+    while (queue.count < TX_QUEUE_DEPTH)
+    {
+        TEST_CHECK(TxQueue_Push(&queue, mTxClass_Debug_c, big, 1U));
+    }
+    TEST_CHECK(!TxQueue_Push(&queue, mTxClass_Debug_c, big, 1U));
+    TEST_CHECK_EQUAL(queue.drops[mTxClass_Debug_c], 1U);
+    Test_Entry(data, mTxClass_Alert_c, 5U);
+    TEST_CHECK(TxQueue_Push(&queue, mTxClass_Alert_c, data, sizeof(data)));
+    TEST_CHECK_EQUAL(queue.drops[mTxClass_Debug_c], 2U);
+    TEST_CHECK_EQUAL(Test_Number(TxQueue_Head(&queue)), 5U);
+
+    /* Full of alerts, nothing evicts them. */
+    for (i = 1U; i < TX_QUEUE_DEPTH; i++)
+    {
+        TEST_CHECK(TxQueue_Push(&queue, mTxClass_Alert_c, data, sizeof(data)));
+    }
+    TEST_CHECK(!TxQueue_Push(&queue, mTxClass_Alert_c, data, sizeof(data)));
+    TEST_CHECK_EQUAL(queue.drops[mTxClass_Alert_c], 1U);
+
+    /* An alert is retried TX_QUEUE_MAX_RETRIES times then given up, status is given up at once. */
+    for (i = 0U; i < TX_QUEUE_MAX_RETRIES; i++)
+    {
+        TEST_CHECK(TxQueue_Fail(&queue));
+    }
+    TEST_CHECK(!TxQueue_Fail(&queue));
+    TEST_CHECK_EQUAL(queue.retries, TX_QUEUE_MAX_RETRIES);
+    TEST_CHECK_EQUAL(queue.drops[mTxClass_Alert_c], 2U);
+    TxQueue_Reset(&queue);
+    TEST_CHECK_EQUAL(queue.drops[mTxClass_Alert_c], 1U + TX_QUEUE_DEPTH);
+    TEST_CHECK(NULL == TxQueue_Head(&queue));
+    TEST_CHECK(TxQueue_Push(&queue, mTxClass_Status_c, data, sizeof(data)));
+    TEST_CHECK(!TxQueue_Fail(&queue));
+    TEST_CHECK_EQUAL(queue.drops[mTxClass_Status_c], 1U);
+
+    /* A message takes all its entries or none, the room counts the lower entries a push drops, not the head in
+     * flight. */
+    TxQueue_Init(&queue);
+    TEST_CHECK_EQUAL(TxQueue_Room(&queue, mTxClass_Debug_c), TX_QUEUE_DEPTH);
+    TEST_CHECK(!TxQueue_PushMessage(&queue, mTxClass_Count_c, message, 1U));
+    TEST_CHECK(!TxQueue_PushMessage(&queue, mTxClass_Debug_c, message, 0U));
+    TEST_CHECK(TxQueue_PushMessage(&queue, mTxClass_Debug_c, message, 2U * TX_QUEUE_ENTRY_SIZE + 1U));
+    TEST_CHECK_EQUAL(queue.count, 3U);
+    TEST_CHECK_EQUAL(queue.entries[2].length, 1U);
+    TEST_CHECK_EQUAL(TxQueue_Room(&queue, mTxClass_Debug_c), TX_QUEUE_DEPTH - 3U);
+    TEST_CHECK_EQUAL(TxQueue_Room(&queue, mTxClass_Snapshot_c), TX_QUEUE_DEPTH);
+    TxQueue_Wait(&queue);
+    TEST_CHECK_EQUAL(TxQueue_Room(&queue, mTxClass_Snapshot_c), TX_QUEUE_DEPTH - 1U);
+    TEST_CHECK(TxQueue_PushMessage(&queue, mTxClass_Snapshot_c, message, 4U * TX_QUEUE_ENTRY_SIZE));
+    TEST_CHECK_EQUAL(queue.drops[mTxClass_Debug_c], 1U);
+    TEST_CHECK_EQUAL(TxQueue_Room(&queue, mTxClass_Snapshot_c), 1U);
+    TEST_CHECK_EQUAL(TxQueue_Room(&queue, mTxClass_Alert_c), TX_QUEUE_DEPTH - 1U);
+    TEST_CHECK(!TxQueue_PushMessage(&queue, mTxClass_Snapshot_c, message, 2U * TX_QUEUE_ENTRY_SIZE));
+    TEST_CHECK_EQUAL(queue.drops[mTxClass_Snapshot_c], 1U);
+    TEST_CHECK_EQUAL(queue.count, TX_QUEUE_DEPTH);
+    TEST_CHECK(!TxQueue_PushMessage(&queue, mTxClass_Alert_c, message, sizeof(message)));
+    TEST_CHECK_EQUAL(queue.drops[mTxClass_Alert_c], 1U);
+
+    /* A snapshot entry the stack refused is kept, like an alert. */
+    TxQueue_Done(&queue);
+    TEST_CHECK_EQUAL(TxQueue_Head(&queue)->cls, mTxClass_Snapshot_c);
+    TEST_CHECK(TxQueue_Fail(&queue));
+    TEST_CHECK_EQUAL(queue.count, TX_QUEUE_DEPTH - 1U);
+    TEST_CHECK_EQUAL(queue.drops[mTxClass_Snapshot_c], 1U);
+}
+
+/* The host stack: an indication waits for the peer, the rest is delivered once the stack takes it. */
+static testresult_t Test_Transmit(testlink_t *pLink, const txentry_t *pEntry, bool *pConfirm)
+{
+    *pConfirm = false;
+    if (pLink->stalled || (0U == pLink->buffers))
+    {
+        pLink->overflows++;
+        return TEST_OVERFLOW;
+    }
+
+    pLink->buffers--;
+    if ((uint8_t)mTxClass_Alert_c == pEntry->cls)
+    {
+        *pConfirm = true;
+        pLink->confirmPending = true;
+        pLink->inFlight = Test_Number(pEntry);
+    }
+    else
+    {
+        pLink->delivered[pEntry->cls]++;
+    }
+
+    return TEST_SUCCESS;
+}
+
+/* BleApp_ServiceTxQueue() */
+static void Test_Service(testlink_t *pLink)
+{
+    const txentry_t *pEntry;
+    bool confirm;
+
+    while ((!pLink->queue.busy) && (NULL != (pEntry = TxQueue_Head(&pLink->queue))))
+    {
+        if (TEST_SUCCESS == Test_Transmit(pLink, pEntry, &confirm))
+        {
+            if (confirm)
+            {
+                TxQueue_Wait(&pLink->queue);
+            }
+            else
+            {
+                TxQueue_Done(&pLink->queue);
+            }
+        }
+        else
+        {
+            (void)TxQueue_Fail(&pLink->queue);
+            if (NULL != TxQueue_Head(&pLink->queue))
+            {
+                pLink->queue.held = true;
+                pLink->retryArmed = true;
+                pLink->retryAt_ms = pLink->now_ms + TEST_RETRY_MS;
+            }
+            break;
+        }
+    }
+}
+
+/* BleApp_QueueTx() for one peer. */
+static void Test_Queue(testlink_t *pLink, uint8_t cls)
+{
+    uint8_t data[TX_QUEUE_ENTRY_SIZE];
+    uint32_t length = TX_QUEUE_ENTRY_SIZE;
+
+    memset(data, 0, sizeof(data));
+    if ((uint8_t)mTxClass_Alert_c == cls)
+    {
+        Test_Entry(data, cls, pLink->nextAlert);
+        pLink->raisedAt_ms[pLink->nextAlert % TEST_MAX_ALERTS] = pLink->now_ms;
+        pLink->nextAlert++;
+        length = 14U;
+    }
+    pLink->pushed[cls]++;
+    (void)TxQueue_Push(&pLink->queue, cls, data, length);
+    if (!pLink->queue.held)
+    {
+        Test_Service(pLink);
+    }
+}
+
+/* fxls89xx_SnapshotSendHandler(), four samples per entry. Throttled, a chunk is read from the ring only while the
+ * queue has room for it and for an alert. */
+static void Test_SnapshotSend(testlink_t *pLink)
+{
+    uint8_t data[TEST_CHUNK_SAMPLES * TEST_SAMPLE_SIZE];
+    uint32_t count;
+
+    memset(data, 0, sizeof(data));
+    while ((0U != pLink->snapshotLeft) &&
+           (!pLink->throttled || (TxQueue_Room(&pLink->queue, pLink->snapshotClass) > TEST_ALERT_RESERVE)))
+    {
+        count = (pLink->snapshotLeft < TEST_CHUNK_SAMPLES) ? pLink->snapshotLeft : TEST_CHUNK_SAMPLES;
+        pLink->snapshotLeft -= count;
+        pLink->pushed[pLink->snapshotClass]++;
+        (void)TxQueue_PushMessage(&pLink->queue, pLink->snapshotClass, data, count * TEST_SAMPLE_SIZE);
+        if (!pLink->queue.held)
+        {
+            Test_Service(pLink);
+        }
+    }
+}
+
+/* BleApp_TxDrained() */
+static void Test_Drained(testlink_t *pLink)
+{
+    if (0U != pLink->snapshotLeft)
+    {
+        Test_SnapshotSend(pLink);
+    }
+}
+
+/* A connection event: the stack's buffers are free again, the peer answers the indication in flight. */
+static void Test_ConnectionEvent(testlink_t *pLink)
+{
+    uint32_t latency_ms;
+    bool success;
+
+    pLink->buffers = TEST_BUFFERS;
+    if (!pLink->confirmPending)
+    {
+        return;
+    }
+
+    pLink->confirmPending = false;
+    pLink->indications++;
+    success = ((pLink->indications % TEST_NACK_EVERY) != 0U);
+    if (success)
+    {
+        pLink->outOfOrder += (pLink->inFlight != pLink->expectedAlert) ? 1U : 0U;
+        pLink->expectedAlert = pLink->inFlight + 1U;
+        pLink->delivered[mTxClass_Alert_c]++;
+        latency_ms = pLink->now_ms - pLink->raisedAt_ms[pLink->inFlight % TEST_MAX_ALERTS];
+        if (latency_ms > pLink->worstLatency_ms)
+        {
+            pLink->worstLatency_ms = latency_ms;
+        }
+    }
+
+    /* BleApp_TxConfirmed() */
+    if (pLink->queue.busy)
+    {
+        if (success)
+        {
+            TxQueue_Done(&pLink->queue);
+        }
+        else
+        {
+            (void)TxQueue_Fail(&pLink->queue);
+        }
+        Test_Service(pLink);
+        Test_Drained(pLink);
+    }
+}
+
+/* BleApp_ServiceTxQueues(), on the retry timer. */
+static void Test_Retry(testlink_t *pLink)
+{
+    if (pLink->retryArmed && (pLink->now_ms == pLink->retryAt_ms))
+    {
+        pLink->retryArmed = false;
+        pLink->queue.held = false;
+        Test_Service(pLink);
+        Test_Drained(pLink);
+    }
+}
+
+/* Sample dumps every 10 ms, a status every 100 ms, an alert every 37 ms in bursts, all under stalls. */
+static void Test_Load(void)
+{
+    static testlink_t link;
+    uint32_t remaining[mTxClass_Count_c] = {0};
+    uint32_t cls;
+    uint32_t i;
+
+    memset(&link, 0, sizeof(link));
+    TxQueue_Init(&link.queue);
+    link.buffers = TEST_BUFFERS;
+
+    for (link.now_ms = 0U; link.now_ms < 2U * TEST_RUN_MS; link.now_ms++)
+    {
+        link.stalled = ((link.now_ms % TEST_STALL_EVERY_MS) < TEST_STALL_MS);
+        if (0U == (link.now_ms % TEST_CONN_MS))
+        {
+            Test_ConnectionEvent(&link);
+        }
+        Test_Retry(&link);
+        if (link.now_ms >= TEST_RUN_MS)
+        {
+            continue;
+        }
+
+        if (0U == (link.now_ms % 10U))
+        {
+            Test_Queue(&link, mTxClass_Debug_c);
+        }
+        if (0U == (link.now_ms % 100U))
+        {
+            Test_Queue(&link, mTxClass_Status_c);
+        }
+        if ((0U == (link.now_ms % 37U)) && ((link.now_ms % 500U) < 200U))
+        {
+            Test_Queue(&link, mTxClass_Alert_c);
+        }
+    }
+
+    for (i = 0U; i < link.queue.count; i++)
+    {
+        remaining[link.queue.entries[i].cls]++;
+    }
+    printf("%u overflows, %u retries; alerts %u of %u, worst latency %u ms; status %u of %u, %u dropped; "
+           "debug %u of %u, %u dropped\r\n",
+           link.overflows, link.queue.retries, link.delivered[mTxClass_Alert_c], link.pushed[mTxClass_Alert_c],
+           link.worstLatency_ms, link.delivered[mTxClass_Status_c], link.pushed[mTxClass_Status_c],
+           link.queue.drops[mTxClass_Status_c], link.delivered[mTxClass_Debug_c], link.pushed[mTxClass_Debug_c],
+           link.queue.drops[mTxClass_Debug_c]);
+
+    /* Every entry is delivered, dropped and counted, or still queued. */
+    for (cls = 0U; cls < mTxClass_Count_c; cls++)
+    {
+        TEST_CHECK_EQUAL(link.delivered[cls] + link.queue.drops[cls] + remaining[cls], link.pushed[cls]);
+    }
+    TEST_CHECK_EQUAL(link.queue.count, 0U);
+    TEST_CHECK(link.overflows > 0U);
+    TEST_CHECK(link.queue.retries > 0U);
+    /* No alert is lost or reordered, the load falls on the status and debug traffic. */
+    TEST_CHECK(link.pushed[mTxClass_Alert_c] > 0U);
+    TEST_CHECK_EQUAL(link.queue.drops[mTxClass_Alert_c], 0U);
+    TEST_CHECK_EQUAL(link.delivered[mTxClass_Alert_c], link.pushed[mTxClass_Alert_c]);
+    TEST_CHECK_EQUAL(link.outOfOrder, 0U);
+    TEST_CHECK(link.queue.drops[mTxClass_Debug_c] > 0U);
+    /* A stall delays an alert by its length and a retry interval at most, plus a few connection events. */
+    TEST_CHECK(link.worstLatency_ms < TEST_STALL_MS + TEST_RETRY_MS + 8U * TEST_CONN_MS);
+}
+
+/* A stack which never takes the write: the alert goes out TX_QUEUE_MAX_RETRIES more times, one per retry interval
+ * however much is queued meanwhile, then is dropped. */
+static void Test_GiveUp(void)
+{
+    static testlink_t link;
+    uint32_t droppedAt_ms = 0U;
+
+    memset(&link, 0, sizeof(link));
+    TxQueue_Init(&link.queue);
+    link.stalled = true;
+    Test_Queue(&link, mTxClass_Alert_c);
+    for (link.now_ms = 0U; link.now_ms < 1000U; link.now_ms++)
+    {
+        Test_Retry(&link);
+        if ((0U == droppedAt_ms) && (0U != link.queue.drops[mTxClass_Alert_c]))
+        {
+            droppedAt_ms = link.now_ms;
+        }
+        if (0U == (link.now_ms % 10U))
+        {
+            Test_Queue(&link, mTxClass_Debug_c);
+        }
+    }
+
+    TEST_CHECK_EQUAL(link.queue.retries, TX_QUEUE_MAX_RETRIES);
+    TEST_CHECK_EQUAL(link.queue.drops[mTxClass_Alert_c], 1U);
+    TEST_CHECK_EQUAL(droppedAt_ms, TX_QUEUE_MAX_RETRIES * TEST_RETRY_MS);
+    TEST_CHECK_EQUAL(link.delivered[mTxClass_Debug_c], 0U);
+    TEST_CHECK_EQUAL(link.queue.drops[mTxClass_Debug_c] + link.queue.count, link.pushed[mTxClass_Debug_c]);
+}
+
+/* An alert in flight, then a snapshot, a second alert while it streams and a stall which holds the queue. */
+static uint32_t Test_SnapshotRun(testlink_t *pLink, uint8_t cls, bool throttled)
+{
+    uint32_t doneAt_ms = 0U;
+
+    memset(pLink, 0, sizeof(testlink_t));
+    TxQueue_Init(&pLink->queue);
+    pLink->buffers = TEST_BUFFERS;
+    pLink->snapshotClass = cls;
+    pLink->throttled = throttled;
+
+    for (pLink->now_ms = 0U; pLink->now_ms < TEST_STALL_EVERY_MS; pLink->now_ms++)
+    {
+        pLink->stalled = (pLink->now_ms >= 40U) && (pLink->now_ms < (40U + TEST_STALL_MS));
+        if (0U == (pLink->now_ms % TEST_CONN_MS))
+        {
+            Test_ConnectionEvent(pLink);
+        }
+        Test_Retry(pLink);
+        if ((0U == pLink->now_ms) || (30U == pLink->now_ms))
+        {
+            Test_Queue(pLink, mTxClass_Alert_c);
+        }
+        if (0U == pLink->now_ms)
+        {
+            TEST_CHECK(pLink->queue.busy);
+            pLink->snapshotLeft = TEST_SNAPSHOT;
+            Test_SnapshotSend(pLink);
+        }
+        if ((0U == doneAt_ms) && (0U == pLink->snapshotLeft) && (0U == pLink->queue.count))
+        {
+            doneAt_ms = pLink->now_ms;
+        }
+    }
+
+    printf("snapshot of %u samples as %s: %u of %u entries delivered, %u dropped, sent in %u ms; alerts %u of %u\r\n",
+           TEST_SNAPSHOT, throttled ? "throttled snapshot class" : "debug, all at once", pLink->delivered[cls],
+           TEST_SNAPSHOT / TEST_CHUNK_SAMPLES, pLink->queue.drops[cls], doneAt_ms,
+           pLink->delivered[mTxClass_Alert_c], pLink->pushed[mTxClass_Alert_c]);
+
+    return pLink->delivered[cls];
+}
+
+static void Test_Snapshot(void)
+{
+    static testlink_t link;
+
+    /* Queued all at once behind the alert, most of the snapshot is dropped. */
+    TEST_CHECK(Test_SnapshotRun(&link, mTxClass_Debug_c, false) < TEST_SNAPSHOT / TEST_CHUNK_SAMPLES);
+    TEST_CHECK(link.queue.drops[mTxClass_Debug_c] > 0U);
+
+    /* Read as the queue drains, every sample gets through the stall and the alerts keep their place. */
+    TEST_CHECK_EQUAL(Test_SnapshotRun(&link, mTxClass_Snapshot_c, true), TEST_SNAPSHOT / TEST_CHUNK_SAMPLES);
+    TEST_CHECK_EQUAL(link.pushed[mTxClass_Snapshot_c], TEST_SNAPSHOT / TEST_CHUNK_SAMPLES);
+    TEST_CHECK_EQUAL(link.queue.drops[mTxClass_Snapshot_c], 0U);
+    TEST_CHECK_EQUAL(link.snapshotLeft, 0U);
+    TEST_CHECK(link.overflows > 0U);
+    TEST_CHECK_EQUAL(link.pushed[mTxClass_Alert_c], 2U);
+    TEST_CHECK_EQUAL(link.delivered[mTxClass_Alert_c], 2U);
+    TEST_CHECK_EQUAL(link.queue.drops[mTxClass_Alert_c], 0U);
+    TEST_CHECK_EQUAL(link.outOfOrder, 0U);
+    TEST_CHECK_EQUAL(link.queue.count, 0U);
+}
+
+int main(void)
+{
+    Test_Rules();
+    Test_Load();
+    Test_GiveUp();
+    Test_Snapshot();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file test_util.h
+ * @brief The test_util.h file defines the checks of the host tests. A failed check prints its location and
+ *        makes the test return a failure to ctest, the test goes on so one run reports every failure.
+ */
+
+#ifndef TEST_UTIL_H_
+#define TEST_UTIL_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static int s_testFailures;
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_CHECK(cond)                                                          \
+    do                                                                            \
+    {                                                                             \
+        if (!(cond))                                                              \
+        {                                                                         \
+            printf("%s:%d: check failed: %s\r\n", __FILE__, __LINE__, #cond);     \
+            s_testFailures++;                                                     \
+        }                                                                         \
+    } while (0)
+
+#define TEST_CHECK_EQUAL(actual, expected)                                                                 \
+    do                                                                                                     \
+    {                                                                                                      \
+        long long actual_ = (long long)(actual);                                                           \
+        long long expected_ = (long long)(expected);                                                       \
+        if (actual_ != expected_)                                                                          \
+        {                                                                                                  \
+            printf("%s:%d: %s is %lld, expected %lld\r\n", __FILE__, __LINE__, #actual, actual_, expected_); \
+            s_testFailures++;                                                                              \
+        }                                                                                                  \
+    } while (0)
+
+/* Traces are looked up in the directory passed by tests/CMakeLists.txt. */
+#define TEST_TRACE(name) TAMPER_HOST_TRACES "/" name
+
+#define TEST_RESULT() ((s_testFailures == 0) ? EXIT_SUCCESS : EXIT_FAILURE)
+
+#endif /* TEST_UTIL_H_ */